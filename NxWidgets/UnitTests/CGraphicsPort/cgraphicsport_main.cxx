@@ -0,0 +1,177 @@
+/////////////////////////////////////////////////////////////////////////////
+// NxWidgets/UnitTests/CGraphicsPort/cgraphicsport_main.cxx
+//
+//   Copyright (C) 2014 Gregory Nutt. All rights reserved.
+//   Author: Gregory Nutt <gnutt@nuttx.org>
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in
+//    the documentation and/or other materials provided with the
+//    distribution.
+// 3. Neither the name NuttX, NxWidgets, nor the names of its contributors
+//    me be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+// COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+// BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+// OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+// AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+// ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+
+/////////////////////////////////////////////////////////////////////////////
+// Included Files
+/////////////////////////////////////////////////////////////////////////////
+
+#include <nuttx/config.h>
+
+#include <nuttx/init.h>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+#include <debug.h>
+
+#include <nuttx/nx/nx.h>
+
+#include "cglyphcache.hxx"
+#include "singletons.hxx"
+#include "cgraphicsporttest.hxx"
+
+/////////////////////////////////////////////////////////////////////////////
+// Definitions
+/////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////
+// Private Classes
+/////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////
+// Private Data
+/////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////
+// Public Function Prototypes
+/////////////////////////////////////////////////////////////////////////////
+
+// Suppress name-mangling
+
+extern "C" int cgraphicsport_main(int argc, char *argv[]);
+
+/////////////////////////////////////////////////////////////////////////////
+// Private Functions
+/////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////
+// Name: showResults
+/////////////////////////////////////////////////////////////////////////////
+
+static void showResults(FAR const char *test, uint32_t msec, uint32_t nchars)
+{
+  printf("cgraphicsport_main: %-12s %6lu chars in %6lu msec",
+         test, (unsigned long)nchars, (unsigned long)msec);
+
+  if (msec > 0)
+    {
+      printf(" (%lu chars/sec)", (unsigned long)(((uint64_t)nchars * 1000) / msec));
+    }
+
+  printf("\n");
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Public Functions
+/////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////
+// cgraphicsport_main
+/////////////////////////////////////////////////////////////////////////////
+
+int cgraphicsport_main(int argc, char *argv[])
+{
+  int npasses = CONFIG_CGRAPHICSPORTTEST_NPASSES;
+  uint32_t nchars;
+  uint32_t msec;
+
+  if (argc > 1)
+    {
+      npasses = atoi(argv[1]);
+    }
+
+  // Create an instance of the text drawing test
+
+  printf("cgraphicsport_main: Create CGraphicsPortTest instance\n");
+  CGraphicsPortTest *test = new CGraphicsPortTest();
+
+  // Connect the NX server
+
+  printf("cgraphicsport_main: Connect the CGraphicsPortTest instance to the NX server\n");
+  if (!test->connect())
+    {
+      printf("cgraphicsport_main: Failed to connect the CGraphicsPortTest instance to the NX server\n");
+      delete test;
+      return 1;
+    }
+
+  // Create a window to draw into
+
+  printf("cgraphicsport_main: Create a Window\n");
+  if (!test->createWindow())
+    {
+      printf("cgraphicsport_main: Failed to create a window\n");
+      delete test;
+      return 1;
+    }
+
+  // Draw text on an opaque background.  The first pass populates the glyph
+  // cache; later passes should find all glyphs in the cache.
+
+  printf("cgraphicsport_main: Drawing %d passes of text\n", npasses);
+
+  msec = test->drawText(false, npasses, &nchars);
+  showResults("Opaque:", msec, nchars);
+
+  // Draw transparent text.  This requires reading back the display contents
+  // and does not use the glyph cache.
+
+#ifndef CONFIG_NX_WRITEONLY
+  msec = test->drawText(true, npasses, &nchars);
+  showResults("Transparent:", msec, nchars);
+#endif
+
+  // Show glyph cache statistics
+
+  if (g_glyphCache)
+    {
+      printf("cgraphicsport_main: Glyph cache hits=%lu misses=%lu evictions=%lu size=%lu\n",
+             (unsigned long)g_glyphCache->getHits(),
+             (unsigned long)g_glyphCache->getMisses(),
+             (unsigned long)g_glyphCache->getEvictions(),
+             (unsigned long)g_glyphCache->getSize());
+    }
+  else
+    {
+      printf("cgraphicsport_main: The glyph cache is disabled\n");
+    }
+
+  // Clean up and exit
+
+  sleep(2);
+  printf("cgraphicsport_main: Clean-up and exit\n");
+  delete test;
+  return 0;
+}
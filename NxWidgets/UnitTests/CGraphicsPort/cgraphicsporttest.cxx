@@ -0,0 +1,265 @@
+/////////////////////////////////////////////////////////////////////////////
+// NxWidgets/UnitTests/CGraphicsPort/cgraphicsporttest.cxx
+//
+//   Copyright (C) 2014 Gregory Nutt. All rights reserved.
+//   Author: Gregory Nutt <gnutt@nuttx.org>
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in
+//    the documentation and/or other materials provided with the
+//    distribution.
+// 3. Neither the name NuttX, NxWidgets, nor the names of its contributors
+//    me be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+// COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+// BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+// OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+// AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+// ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+
+/////////////////////////////////////////////////////////////////////////////
+// Included Files
+/////////////////////////////////////////////////////////////////////////////
+
+#include <nuttx/config.h>
+
+#include <nuttx/init.h>
+#include <cstdio>
+#include <cerrno>
+#include <ctime>
+#include <debug.h>
+
+#include <nuttx/nx/nx.h>
+#include <nuttx/nx/nxfonts.h>
+
+#include "nxconfig.hxx"
+#include "crect.hxx"
+#include "cgraphicsporttest.hxx"
+#include "cbgwindow.hxx"
+
+/////////////////////////////////////////////////////////////////////////////
+// Definitions
+/////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////
+// Private Classes
+/////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////
+// Private Data
+/////////////////////////////////////////////////////////////////////////////
+
+// Text that is drawn on each line of the window
+
+static FAR const char *g_lines[] =
+{
+  "The quick brown fox jumps over the lazy dog.",
+  "Pack my box with five dozen liquor jugs.",
+  "0123456789 !\"#$%&'()*+,-./:;<=>?@[\\]^_`{|}~",
+  "How vexingly quick daft zebras jump!",
+};
+
+#define NLINES (sizeof(g_lines) / sizeof(g_lines[0]))
+
+/////////////////////////////////////////////////////////////////////////////
+// Public Data
+/////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////
+// Public Function Prototypes
+/////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////
+// CGraphicsPortTest Method Implementations
+/////////////////////////////////////////////////////////////////////////////
+
+// CGraphicsPortTest Constructor
+
+CGraphicsPortTest::CGraphicsPortTest()
+{
+  m_widgetControl = (CWidgetControl *)NULL;
+  m_bgWindow      = (CBgWindow *)NULL;
+  m_nxFont        = (CNxFont *)NULL;
+}
+
+// CGraphicsPortTest Descriptor
+
+CGraphicsPortTest::~CGraphicsPortTest()
+{
+  disconnect();
+}
+
+// Connect to the NX server
+
+bool CGraphicsPortTest::connect(void)
+{
+  // Connect to the server
+
+  bool nxConnected = CNxServer::connect();
+  if (nxConnected)
+    {
+      // Create the default font instance
+
+      m_nxFont = new CNxFont(NXFONT_DEFAULT,
+                            CONFIG_CGRAPHICSPORTTEST_FONTCOLOR,
+                            CONFIG_NXWIDGETS_TRANSPARENT_COLOR);
+      if (!m_nxFont)
+        {
+          printf("CGraphicsPortTest::connect: Failed to create the default font\n");
+        }
+
+      // Set the background color
+
+      if (!setBackgroundColor(CONFIG_CGRAPHICSPORTTEST_BGCOLOR))
+        {
+          printf("CGraphicsPortTest::connect: setBackgroundColor failed\n");
+        }
+    }
+
+  return nxConnected;
+}
+
+// Disconnect from the NX server
+
+void CGraphicsPortTest::disconnect(void)
+{
+  // Close the window
+
+  if (m_bgWindow)
+    {
+      delete m_bgWindow;
+      m_bgWindow = (CBgWindow *)NULL;
+    }
+
+  // Free the default font
+
+  if (m_nxFont)
+    {
+      delete m_nxFont;
+      m_nxFont = (CNxFont *)NULL;
+    }
+
+  // And disconnect from the server
+
+  CNxServer::disconnect();
+}
+
+// Create the background window instance.
+
+bool CGraphicsPortTest::createWindow(void)
+{
+  // Initialize the widget control using the default style
+
+  m_widgetControl = new CWidgetControl((CWidgetStyle *)NULL);
+
+  // Get an (uninitialized) instance of the background window as a class
+  // that derives from INxWindow.
+
+  m_bgWindow = getBgWindow(m_widgetControl);
+  if (!m_bgWindow)
+    {
+      printf("CGraphicsPortTest::createWindow: Failed to create CBgWindow instance\n");
+      delete m_widgetControl;
+      return false;
+    }
+
+  // Open (and initialize) the window
+
+  bool success = m_bgWindow->open();
+  if (!success)
+    {
+      printf("CGraphicsPortTest::createWindow: Failed to open background window\n");
+      delete m_bgWindow;
+      m_bgWindow = (CBgWindow*)0;
+      return false;
+    }
+
+  return true;
+}
+
+// Fill the window with lines of text npasses times
+
+uint32_t CGraphicsPortTest::drawText(bool transparent, int npasses,
+                                     uint32_t *nchars)
+{
+  // Get the size of the window
+
+  struct nxgl_size_s windowSize;
+  if (!m_bgWindow->getSize(&windowSize))
+    {
+      printf("CGraphicsPortTest::drawText: Failed to get window size\n");
+      return 0;
+    }
+
+  CGraphicsPort *port = m_widgetControl->getGraphicsPort();
+  CRect bound(0, 0, windowSize.w, windowSize.h);
+
+  // Create the strings to be drawn
+
+  CNxString *strings[NLINES];
+  for (unsigned int i = 0; i < NLINES; i++)
+    {
+      strings[i] = new CNxString(g_lines[i]);
+    }
+
+  nxgl_coord_t lineHeight = (nxgl_coord_t)m_nxFont->getHeight();
+  uint32_t count = 0;
+
+  struct timespec start;
+  clock_gettime(CLOCK_REALTIME, &start);
+
+  for (int pass = 0; pass < npasses; pass++)
+    {
+      unsigned int line = pass;
+      for (nxgl_coord_t y = 0; y + lineHeight <= windowSize.h; y += lineHeight)
+        {
+          CNxString *string = strings[line++ % NLINES];
+          struct nxgl_point_s pos;
+          pos.x = 0;
+          pos.y = y;
+
+          if (transparent)
+            {
+              port->drawText(&pos, &bound, m_nxFont, *string);
+            }
+          else
+            {
+              port->drawText(&pos, &bound, m_nxFont, *string, 0,
+                             string->getLength(),
+                             CONFIG_CGRAPHICSPORTTEST_FONTCOLOR,
+                             CONFIG_CGRAPHICSPORTTEST_BGCOLOR);
+            }
+
+          count += string->getLength();
+        }
+    }
+
+  struct timespec end;
+  clock_gettime(CLOCK_REALTIME, &end);
+
+  for (unsigned int i = 0; i < NLINES; i++)
+    {
+      delete strings[i];
+    }
+
+  *nchars = count;
+  return (uint32_t)((end.tv_sec - start.tv_sec) * 1000 +
+                    (end.tv_nsec - start.tv_nsec) / 1000000);
+}
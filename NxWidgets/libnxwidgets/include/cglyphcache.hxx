@@ -0,0 +1,274 @@
+/****************************************************************************
+ * NxWidgets/libnxwidgets/include/cglyphcache.hxx
+ *
+ *   Copyright (C) 2014 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX, NxWidgets, nor the names of its contributors
+ *    me be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_CGLYPHCACHE_HXX
+#define __INCLUDE_CGLYPHCACHE_HXX
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <semaphore.h>
+
+#include <nuttx/nx/nxglib.h>
+
+#include "nxconfig.hxx"
+
+/****************************************************************************
+ * Pre-Processor Definitions
+ ****************************************************************************/
+
+/**
+ * Number of hash buckets.  Must be a power of two.
+ */
+
+#define GLYPHCACHE_NBUCKETS 32
+
+/****************************************************************************
+ * Implementation Classes
+ ****************************************************************************/
+
+#if defined(__cplusplus)
+
+namespace NXWidgets
+{
+  class CNxFont;
+
+  /**
+   * One rendered glyph.  The rendered image immediately follows this
+   * structure in memory.
+   */
+
+  struct SGlyphCacheEntry
+  {
+    struct SGlyphCacheEntry *hashNext;  /**< Next entry in the hash bucket */
+    struct SGlyphCacheEntry *lruPrev;   /**< Previous (more recently used) entry */
+    struct SGlyphCacheEntry *lruNext;   /**< Next (less recently used) entry */
+    nxgl_mxpixel_t   foreground;        /**< Font color */
+    nxgl_mxpixel_t   background;        /**< Background color */
+    uint16_t         fontId;            /**< Font ID */
+    nxwidget_char_t  letter;            /**< The character */
+    uint8_t          bpp;               /**< Bits per pixel */
+    nxgl_coord_t     width;             /**< Width of the glyph in pixels */
+    nxgl_coord_t     height;            /**< Height of the glyph in rows */
+    uint16_t         stride;            /**< Length of one row in bytes */
+    size_t           size;              /**< Allocated size (including this header) */
+    FAR uint8_t     *data;              /**< The rendered image */
+  };
+
+  /**
+   * CGlyphCache holds glyphs rendered onto an opaque background, keyed by
+   * font, character, foreground color, background color and pixel depth.
+   * A single instance is shared by all graphics ports (see singletons.hxx).
+   * When the total size of the cached glyphs would exceed the size budget,
+   * the least recently used glyphs are discarded.
+   *
+   * Glyphs drawn transparently depend on the contents of the display and
+   * are never cached.
+   */
+
+  class CGlyphCache
+  {
+  private:
+    struct SGlyphCacheEntry *m_buckets[GLYPHCACHE_NBUCKETS]; /**< Hash table */
+    struct SGlyphCacheEntry *m_lruHead;   /**< Most recently used entry */
+    struct SGlyphCacheEntry *m_lruTail;   /**< Least recently used entry */
+    sem_t    m_exclSem;                   /**< Mutually exclusive access */
+    size_t   m_budget;                    /**< Maximum size of all entries */
+    size_t   m_size;                      /**< Current size of all entries */
+    uint32_t m_hits;                      /**< Number of cache hits */
+    uint32_t m_misses;                    /**< Number of cache misses */
+    uint32_t m_evictions;                 /**< Number of discarded entries */
+
+    /**
+     * Get exclusive access to the cache.
+     */
+
+    void lock(void);
+
+    /**
+     * Relinquish exclusive access to the cache.
+     */
+
+    inline void unlock(void)
+    {
+      sem_post(&m_exclSem);
+    }
+
+    /**
+     * Select the hash bucket for a glyph.
+     */
+
+    static inline unsigned int hash(uint16_t fontId, nxwidget_char_t letter)
+    {
+      return (letter ^ (fontId << 3)) & (GLYPHCACHE_NBUCKETS - 1);
+    }
+
+    /**
+     * Find a glyph in the cache.
+     *
+     * @return The matching entry or NULL if the glyph is not cached.
+     */
+
+    struct SGlyphCacheEntry *find(unsigned int bucket, uint16_t fontId,
+                                  nxwidget_char_t letter,
+                                  nxgl_mxpixel_t foreground,
+                                  nxgl_mxpixel_t background);
+
+    /**
+     * Move an entry to the head of the LRU list.
+     */
+
+    void touch(struct SGlyphCacheEntry *entry);
+
+    /**
+     * Remove an entry from the hash table and the LRU list and free it.
+     */
+
+    void discard(struct SGlyphCacheEntry *entry);
+
+  public:
+    /**
+     * Constructor.
+     *
+     * @param budget The maximum number of bytes of memory to use for
+     *   cached glyphs.
+     */
+
+    CGlyphCache(size_t budget);
+
+    /**
+     * Destructor.
+     */
+
+    ~CGlyphCache(void);
+
+    /**
+     * Copy a glyph rendered onto an opaque background into a destination
+     * buffer.  The glyph is rendered and added to the cache if it is not
+     * already cached.
+     *
+     * @param font The font to draw with (in its current color).
+     * @param letter The character to draw.
+     * @param background The background color.
+     * @param width The width of the glyph in pixels (metrics width plus
+     *   x offset).
+     * @param height The height of the glyph in rows (the font height).
+     * @param dest The upper left corner of the glyph in the destination.
+     * @param stride The length of one destination row in bytes.
+     */
+
+    void drawGlyph(CNxFont *font, nxwidget_char_t letter,
+                   nxgl_mxpixel_t background, nxgl_coord_t width,
+                   nxgl_coord_t height, FAR uint8_t *dest,
+                   unsigned int stride);
+
+    /**
+     * Render one glyph onto a background without using the cache.
+     *
+     * @param font The font to draw with (in its current color).
+     * @param letter The character to render.
+     * @param background The background color.
+     * @param width The width of the glyph in pixels.
+     * @param height The height of the glyph in rows.
+     * @param dest The upper left corner of the glyph in the destination.
+     * @param stride The length of one destination row in bytes.
+     */
+
+    static void render(CNxFont *font, nxwidget_char_t letter,
+                       nxgl_mxpixel_t background, nxgl_coord_t width,
+                       nxgl_coord_t height, FAR uint8_t *dest,
+                       unsigned int stride);
+
+    /**
+     * Discard all cached glyphs.
+     */
+
+    void flush(void);
+
+    /**
+     * Get the number of cache hits.
+     *
+     * @return The number of glyphs that were found in the cache.
+     */
+
+    inline const uint32_t getHits(void) const
+    {
+      return m_hits;
+    }
+
+    /**
+     * Get the number of cache misses.
+     *
+     * @return The number of glyphs that had to be rendered.
+     */
+
+    inline const uint32_t getMisses(void) const
+    {
+      return m_misses;
+    }
+
+    /**
+     * Get the number of evictions.
+     *
+     * @return The number of glyphs discarded to stay within the budget.
+     */
+
+    inline const uint32_t getEvictions(void) const
+    {
+      return m_evictions;
+    }
+
+    /**
+     * Get the current size of the cache.
+     *
+     * @return The number of bytes used by cached glyphs.
+     */
+
+    inline const size_t getSize(void) const
+    {
+      return m_size;
+    }
+  };
+}
+
+#endif // __cplusplus
+
+#endif // __INCLUDE_CGLYPHCACHE_HXX
@@ -110,6 +110,29 @@ namespace NXWidgets
 #ifdef CONFIG_NX_WRITEONLY
     nxgl_mxpixel_t m_backColor;  /**< The background color to use */
 #endif
+    FAR uint8_t   *m_textRun;    /**< Off-screen memory used to compose text */
+    size_t         m_textRunSize; /**< Size of the text composition memory */
+    struct nxgl_rect_s m_clipRect; /**< All drawing is clipped to this region */
+    bool           m_clipping;   /**< True: m_clipRect is in effect */
+
+    /**
+     * Clip a rectangle to the clipping region.
+     *
+     * @param rect The rectangle to clip.  It is modified in place.
+     * @return True if any part of the rectangle remains to be drawn.
+     */
+
+    bool clip(FAR struct nxgl_rect_s *rect) const;
+
+    /**
+     * Get off-screen memory large enough to compose a run of text.
+     *
+     * @param size The number of bytes required.
+     * @return The text composition memory or NULL if it could not be
+     *   allocated.
+     */
+
+    FAR uint8_t *getTextRun(size_t size);
 
     /**
      * The underlying implementation for drawText functions
@@ -168,6 +191,25 @@ namespace NXWidgets
 
     const nxgl_coord_t getY(void) const;
 
+    /**
+     * Restrict all subsequent drawing to a region of the window.  This is
+     * used to redraw only the damaged parts of a window.  The clipping
+     * region remains in effect until clearClipRect() is called.
+     *
+     * @param rect The window-relative region to draw into.
+     */
+
+    void setClipRect(const CRect &rect);
+
+    /**
+     * Remove the clipping region set by setClipRect().
+     */
+
+    inline void clearClipRect(void)
+    {
+      m_clipping = false;
+    }
+
     /**
      * Get the background color that will be used to fill in the spaces
      * when rendering fonts.  This background color is ONLY used if the
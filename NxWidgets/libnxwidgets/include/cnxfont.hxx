@@ -106,6 +106,17 @@ namespace NXWidgets
 
     const bool isCharBlank(const nxwidget_char_t letter) const;
 
+    /**
+     * Gets the ID of the font.
+     *
+     * @return The font ID.
+     */
+
+    inline const enum nx_fontid_e getFontId() const
+    {
+      return m_fontId;
+    }
+
     /**
      * Gets the color currently being used as the drawing color.
      *
@@ -151,6 +162,8 @@ namespace NXWidgets
 
     /**
      * Draw an individual character of the font to the specified bitmap.
+     * The bitmap stride may be larger than the character so that the
+     * character can be drawn within a larger bitmap.
      *
      * @param bitmap The bitmap to draw to.
      * @param letter The character to output.
@@ -1023,6 +1023,16 @@ namespace NXWidgets
 
     void redraw(void);
 
+    /**
+     * Draws the parts of the widget and the widget's child widgets that lie
+     * within a damaged region of the window.  All drawing is clipped to the
+     * region.
+     *
+     * @param rect The window-relative region to redraw.
+     */
+
+    void redrawRect(const CRect &rect);
+
     /**
      * Enables the widget.
      *
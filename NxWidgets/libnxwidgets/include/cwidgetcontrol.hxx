@@ -207,6 +207,26 @@ namespace NXWidgets
     uint8_t                     m_controls[CONFIG_NXWIDGETS_CURSORCONTROL_SIZE];
     uint8_t                     m_nCc;            /**< Number of buffered
                                                        cursor controls */
+
+    /**
+     * Deferred redraw
+     */
+
+#if CONFIG_NXWIDGETS_DAMAGE_NRECTS > 0
+    CRect                       m_damage[CONFIG_NXWIDGETS_DAMAGE_NRECTS];
+    uint8_t                     m_nDamage;        /**< Number of dirty
+                                                       rectangles */
+    uint8_t                     m_deferRedraw;    /**< Widget redraws are
+                                                       deferred while non-zero */
+#endif
+    uint32_t                    m_nFrames;        /**< Number of deferred
+                                                       redraws performed */
+    uint32_t                    m_lastFrameTime;  /**< Duration of the last
+                                                       deferred redraw (usec) */
+    uint32_t                    m_maxFrameTime;   /**< Longest deferred
+                                                       redraw (usec) */
+    uint32_t                    m_totalFrameTime; /**< Total time spent in
+                                                       deferred redraws (usec) */
     /**
      * The following were picked off from the position callback.
      */
@@ -447,9 +467,11 @@ namespace NXWidgets
      * This method is just a wrapper simply calls the followi.
      *
      *   processDeleteQueue()
+     *   deferRedraw()
      *   pollMouseEvents(widget)
      *   pollKeyboardEvents()
      *   pollCursorControlEvents()
+     *   flushRedraw()
      *
      * @param widget.  Specific widget to poll.  Use NULL to run the
      *    all widgets in the window.
@@ -458,6 +480,107 @@ namespace NXWidgets
 
     bool pollEvents(CNxWidget *widget = (CNxWidget *)NULL);
 
+    /**
+     * Defer widget redraws.  Until the matching call to flushRedraw(),
+     * CNxWidget::redraw() only adds the area of the widget to the damage
+     * list of the window.  pollEvents() defers redraws while it handles
+     * events so that a widget that changes several times in response to
+     * the events is drawn only once.  Calls may be nested.
+     */
+
+#if CONFIG_NXWIDGETS_DAMAGE_NRECTS > 0
+    inline void deferRedraw(void)
+    {
+      m_deferRedraw++;
+    }
+#else
+    inline void deferRedraw(void) { }
+#endif
+
+    /**
+     * End a section started with deferRedraw().  When the outermost
+     * section ends, all widgets that intersect the damage list are
+     * redrawn, clipped to the damaged rectangles, and the damage list is
+     * emptied.
+     */
+
+#if CONFIG_NXWIDGETS_DAMAGE_NRECTS > 0
+    void flushRedraw(void);
+#else
+    inline void flushRedraw(void) { }
+#endif
+
+    /**
+     * Check if widget redraws are currently being deferred.
+     *
+     * @return True if redraws are being added to the damage list.
+     */
+
+    inline bool isRedrawDeferred(void) const
+    {
+#if CONFIG_NXWIDGETS_DAMAGE_NRECTS > 0
+      return m_deferRedraw > 0;
+#else
+      return false;
+#endif
+    }
+
+    /**
+     * Add a region of the window to the damage list.  Overlapping
+     * rectangles are merged.  If the list is full, the new rectangle is
+     * merged with the entry that grows the least.
+     *
+     * @param rect The window-relative region that must be redrawn.
+     */
+
+#if CONFIG_NXWIDGETS_DAMAGE_NRECTS > 0
+    void markRectDirty(const CRect &rect);
+#endif
+
+    /**
+     * Get the number of deferred redraws performed.
+     *
+     * @return The number of times that the damage list was redrawn.
+     */
+
+    inline const uint32_t getFrameCount(void) const
+    {
+      return m_nFrames;
+    }
+
+    /**
+     * Get the duration of the last deferred redraw.
+     *
+     * @return The time in microseconds.
+     */
+
+    inline const uint32_t getLastFrameTime(void) const
+    {
+      return m_lastFrameTime;
+    }
+
+    /**
+     * Get the duration of the longest deferred redraw.
+     *
+     * @return The time in microseconds.
+     */
+
+    inline const uint32_t getMaxFrameTime(void) const
+    {
+      return m_maxFrameTime;
+    }
+
+    /**
+     * Get the total time spent in deferred redraws.
+     *
+     * @return The time in microseconds.
+     */
+
+    inline const uint32_t getTotalFrameTime(void) const
+    {
+      return m_totalFrameTime;
+    }
+
     /**
      * Swaps the depth of the supplied widget.
      * This function presumes that all child widgets are screens.
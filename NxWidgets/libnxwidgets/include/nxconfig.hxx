@@ -100,6 +100,10 @@
  * NXWidget Default Values
  *
  * CONFIG_NXWIDGETS_DEFAULT_FONTID - Default font ID.  Default: NXFONT_DEFAULT
+ * CONFIG_NXWIDGETS_GLYPHCACHE_SIZE - Size (in bytes) of the shared cache of
+ *   rendered glyphs.  Zero disables the cache.  Default: 4096
+ * CONFIG_NXWIDGETS_DAMAGE_NRECTS - Maximum number of dirty rectangles in the
+ *   damage list of each window.  Zero disables deferred redraw.  Default: 8
  * CONFIG_NXWIDGETS_TNXARRAY_INITIALSIZE, CONFIG_NXWIDGETS_TNXARRAY_SIZEINCREMENT -
  *   Default dynamic array parameters.  Default: 16, 8
  *
@@ -345,6 +349,24 @@
 #  define CONFIG_NXWIDGETS_DEFAULT_FONTID NXFONT_DEFAULT
 #endif
 
+/**
+ * Size of the shared cache of rendered glyphs (in bytes).  Zero disables
+ * the cache.
+ */
+
+#ifndef CONFIG_NXWIDGETS_GLYPHCACHE_SIZE
+#  define CONFIG_NXWIDGETS_GLYPHCACHE_SIZE 4096
+#endif
+
+/**
+ * Maximum number of dirty rectangles in the damage list of each window.
+ * Zero disables deferred redraw.
+ */
+
+#ifndef CONFIG_NXWIDGETS_DAMAGE_NRECTS
+#  define CONFIG_NXWIDGETS_DAMAGE_NRECTS 8
+#endif
+
 /**
  * Default dynamic array parameters
  */
@@ -0,0 +1,398 @@
+/****************************************************************************
+ * NxWidgets/libnxwidgets/src/cglyphcache.cxx
+ *
+ *   Copyright (C) 2014 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX, NxWidgets, nor the names of its contributors
+ *    me be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <cstring>
+#include <cassert>
+#include <cerrno>
+#include <debug.h>
+
+#include "nxconfig.hxx"
+#include "cnxfont.hxx"
+#include "cbitmap.hxx"
+#include "cglyphcache.hxx"
+
+/****************************************************************************
+ * Pre-Processor Definitions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Method Implementations
+ ****************************************************************************/
+
+using namespace NXWidgets;
+
+/**
+ * Constructor.
+ *
+ * @param budget The maximum number of bytes of memory to use for
+ *   cached glyphs.
+ */
+
+CGlyphCache::CGlyphCache(size_t budget)
+{
+  for (int i = 0; i < GLYPHCACHE_NBUCKETS; i++)
+    {
+      m_buckets[i] = (struct SGlyphCacheEntry *)NULL;
+    }
+
+  m_lruHead   = (struct SGlyphCacheEntry *)NULL;
+  m_lruTail   = (struct SGlyphCacheEntry *)NULL;
+  m_budget    = budget;
+  m_size      = 0;
+  m_hits      = 0;
+  m_misses    = 0;
+  m_evictions = 0;
+
+  sem_init(&m_exclSem, 0, 1);
+}
+
+/**
+ * Destructor.
+ */
+
+CGlyphCache::~CGlyphCache(void)
+{
+  flush();
+  sem_destroy(&m_exclSem);
+}
+
+/**
+ * Get exclusive access to the cache.
+ */
+
+void CGlyphCache::lock(void)
+{
+  while (sem_wait(&m_exclSem) != 0)
+    {
+      // The only case that an error should occur here is if the wait
+      // was awakened by a signal.
+
+      DEBUGASSERT(errno == EINTR);
+    }
+}
+
+/**
+ * Find a glyph in the cache.
+ *
+ * @return The matching entry or NULL if the glyph is not cached.
+ */
+
+struct SGlyphCacheEntry *CGlyphCache::find(unsigned int bucket,
+                                           uint16_t fontId,
+                                           nxwidget_char_t letter,
+                                           nxgl_mxpixel_t foreground,
+                                           nxgl_mxpixel_t background)
+{
+  struct SGlyphCacheEntry *entry;
+
+  for (entry = m_buckets[bucket]; entry; entry = entry->hashNext)
+    {
+      if (entry->letter == letter && entry->fontId == fontId &&
+          entry->foreground == foreground && entry->background == background &&
+          entry->bpp == CONFIG_NXWIDGETS_BPP)
+        {
+          return entry;
+        }
+    }
+
+  return (struct SGlyphCacheEntry *)NULL;
+}
+
+/**
+ * Move an entry to the head of the LRU list.
+ */
+
+void CGlyphCache::touch(struct SGlyphCacheEntry *entry)
+{
+  if (entry == m_lruHead)
+    {
+      return;
+    }
+
+  // Remove the entry from its current position
+
+  entry->lruPrev->lruNext = entry->lruNext;
+  if (entry->lruNext)
+    {
+      entry->lruNext->lruPrev = entry->lruPrev;
+    }
+  else
+    {
+      m_lruTail = entry->lruPrev;
+    }
+
+  // And re-insert it at the head of the list
+
+  entry->lruPrev     = (struct SGlyphCacheEntry *)NULL;
+  entry->lruNext     = m_lruHead;
+  m_lruHead->lruPrev = entry;
+  m_lruHead          = entry;
+}
+
+/**
+ * Remove an entry from the hash table and the LRU list and free it.
+ */
+
+void CGlyphCache::discard(struct SGlyphCacheEntry *entry)
+{
+  // Remove the entry from its hash bucket
+
+  unsigned int bucket = hash(entry->fontId, entry->letter);
+  struct SGlyphCacheEntry **prev = &m_buckets[bucket];
+  while (*prev != entry)
+    {
+      prev = &(*prev)->hashNext;
+    }
+
+  *prev = entry->hashNext;
+
+  // Remove the entry from the LRU list
+
+  if (entry->lruPrev)
+    {
+      entry->lruPrev->lruNext = entry->lruNext;
+    }
+  else
+    {
+      m_lruHead = entry->lruNext;
+    }
+
+  if (entry->lruNext)
+    {
+      entry->lruNext->lruPrev = entry->lruPrev;
+    }
+  else
+    {
+      m_lruTail = entry->lruPrev;
+    }
+
+  m_size -= entry->size;
+  delete[] (FAR uint8_t *)entry;
+}
+
+/**
+ * Render one glyph onto a background.
+ *
+ * @param font The font to draw with (in its current color).
+ * @param letter The character to render.
+ * @param background The background color.
+ * @param width The width of the glyph in pixels.
+ * @param height The height of the glyph in rows.
+ * @param dest The upper left corner of the glyph in the destination.
+ * @param stride The length of one destination row in bytes.
+ */
+
+void CGlyphCache::render(CNxFont *font, nxwidget_char_t letter,
+                         nxgl_mxpixel_t background, nxgl_coord_t width,
+                         nxgl_coord_t height, FAR uint8_t *dest,
+                         unsigned int stride)
+{
+  // Fill the glyph with the background color
+
+  FAR uint8_t *row = dest;
+  for (nxgl_coord_t y = 0; y < height; y++, row += stride)
+    {
+#if CONFIG_NXWIDGETS_BPP == 8
+      memset(row, background, width);
+#elif CONFIG_NXWIDGETS_BPP == 24
+      FAR uint8_t *ptr = row;
+      for (nxgl_coord_t x = 0; x < width; x++)
+        {
+          *ptr++ = (uint8_t)background;
+          *ptr++ = (uint8_t)(background >> 8);
+          *ptr++ = (uint8_t)(background >> 16);
+        }
+#else
+      FAR nxwidget_pixel_t *ptr = (FAR nxwidget_pixel_t *)row;
+      for (nxgl_coord_t x = 0; x < width; x++)
+        {
+          *ptr++ = (nxwidget_pixel_t)background;
+        }
+#endif
+    }
+
+  // Then render the glyph on top of the background
+
+  struct SBitmap bitmap;
+  bitmap.bpp    = CONFIG_NXWIDGETS_BPP;
+  bitmap.fmt    = CONFIG_NXWIDGETS_FMT;
+  bitmap.width  = width;
+  bitmap.height = height;
+  bitmap.stride = stride;
+  bitmap.data   = (FAR const void *)dest;
+
+  font->drawChar(&bitmap, letter);
+}
+
+/**
+ * Copy a glyph rendered onto an opaque background into a destination
+ * buffer.  The glyph is rendered and added to the cache if it is not
+ * already cached.
+ *
+ * @param font The font to draw with (in its current color).
+ * @param letter The character to draw.
+ * @param background The background color.
+ * @param width The width of the glyph in pixels (metrics width plus
+ *   x offset).
+ * @param height The height of the glyph in rows (the font height).
+ * @param dest The upper left corner of the glyph in the destination.
+ * @param stride The length of one destination row in bytes.
+ */
+
+void CGlyphCache::drawGlyph(CNxFont *font, nxwidget_char_t letter,
+                            nxgl_mxpixel_t background, nxgl_coord_t width,
+                            nxgl_coord_t height, FAR uint8_t *dest,
+                            unsigned int stride)
+{
+  uint16_t       fontId     = (uint16_t)font->getFontId();
+  nxgl_mxpixel_t foreground = font->getColor();
+  unsigned int   bucket     = hash(fontId, letter);
+
+  lock();
+
+  struct SGlyphCacheEntry *entry = find(bucket, fontId, letter, foreground,
+                                        background);
+  if (entry)
+    {
+      m_hits++;
+      touch(entry);
+    }
+  else
+    {
+      m_misses++;
+
+      // Make room for the new glyph, discarding the least recently used
+      // glyphs as necessary.
+
+      unsigned int glyphStride = (width * CONFIG_NXWIDGETS_BPP + 7) >> 3;
+      size_t       size        = sizeof(struct SGlyphCacheEntry) +
+                                 glyphStride * height;
+
+      if (size <= m_budget)
+        {
+          while (m_size + size > m_budget && m_lruTail)
+            {
+              discard(m_lruTail);
+              m_evictions++;
+            }
+
+          FAR uint8_t *mem = new uint8_t[size];
+          if (mem)
+            {
+              entry             = (struct SGlyphCacheEntry *)mem;
+              entry->foreground = foreground;
+              entry->background = background;
+              entry->fontId     = fontId;
+              entry->letter     = letter;
+              entry->bpp        = CONFIG_NXWIDGETS_BPP;
+              entry->width      = width;
+              entry->height     = height;
+              entry->stride     = glyphStride;
+              entry->size       = size;
+              entry->data       = mem + sizeof(struct SGlyphCacheEntry);
+
+              render(font, letter, background, width, height, entry->data,
+                     glyphStride);
+
+              // Add the new entry to the hash table and at the head of the
+              // LRU list
+
+              entry->hashNext   = m_buckets[bucket];
+              m_buckets[bucket] = entry;
+
+              entry->lruPrev = (struct SGlyphCacheEntry *)NULL;
+              entry->lruNext = m_lruHead;
+              if (m_lruHead)
+                {
+                  m_lruHead->lruPrev = entry;
+                }
+              else
+                {
+                  m_lruTail = entry;
+                }
+
+              m_lruHead = entry;
+              m_size   += size;
+            }
+        }
+    }
+
+  if (entry)
+    {
+      // Copy the cached glyph into the destination
+
+      FAR const uint8_t *src = entry->data;
+      for (nxgl_coord_t y = 0; y < height; y++)
+        {
+          memcpy(dest, src, entry->stride);
+          dest += stride;
+          src  += entry->stride;
+        }
+
+      unlock();
+    }
+  else
+    {
+      // The glyph could not be cached.  Render it directly into the
+      // destination.
+
+      unlock();
+      render(font, letter, background, width, height, dest, stride);
+    }
+}
+
+/**
+ * Discard all cached glyphs.
+ */
+
+void CGlyphCache::flush(void)
+{
+  lock();
+  while (m_lruTail)
+    {
+      discard(m_lruTail);
+    }
+
+  unlock();
+}
@@ -90,6 +90,7 @@
 #include "cgraphicsport.hxx"
 #include "cwidgetstyle.hxx"
 #include "cbitmap.hxx"
+#include "cglyphcache.hxx"
 #include "singletons.hxx"
 
 /****************************************************************************
@@ -113,13 +114,19 @@ using namespace NXWidgets;
 #ifdef CONFIG_NX_WRITEONLY
 CGraphicsPort::CGraphicsPort(INxWindow *pNxWnd, nxgl_mxpixel_t backColor)
 {
-  m_pNxWnd    = pNxWnd;
-  m_backColor = backColor;
+  m_pNxWnd      = pNxWnd;
+  m_backColor   = backColor;
+  m_textRun     = (FAR uint8_t *)NULL;
+  m_textRunSize = 0;
+  m_clipping    = false;
 }
 #else
 CGraphicsPort::CGraphicsPort(INxWindow *pNxWnd)
 {
-  m_pNxWnd = pNxWnd;
+  m_pNxWnd      = pNxWnd;
+  m_textRun     = (FAR uint8_t *)NULL;
+  m_textRunSize = 0;
+  m_clipping    = false;
 }
 #endif
 
@@ -132,6 +139,11 @@ CGraphicsPort::~CGraphicsPort(void)
   // m_pNxWnd is not deleted.  This is an abstract base class and
   // the caller of the CGraphicsPort instance is responsible for
   // the window destruction.
+
+  if (m_textRun)
+    {
+      delete[] m_textRun;
+    }
 };
 
 /**
@@ -162,6 +174,20 @@ const nxgl_coord_t CGraphicsPort::getY(void) const
   return pos.y;
 };
 
+/**
+ * Restrict all subsequent drawing to a region of the window.  This is
+ * used to redraw only the damaged parts of a window.  The clipping
+ * region remains in effect until clearClipRect() is called.
+ *
+ * @param rect The window-relative region to draw into.
+ */
+
+void CGraphicsPort::setClipRect(const CRect &rect)
+{
+  rect.getNxRect(&m_clipRect);
+  m_clipping = true;
+}
+
 /**
  * Draw a pixel into the window.
  *
@@ -173,6 +199,13 @@ const nxgl_coord_t CGraphicsPort::getY(void) const
 void CGraphicsPort::drawPixel(nxgl_coord_t x, nxgl_coord_t y,
                               nxgl_mxpixel_t color)
 {
+  if (m_clipping &&
+      (x < m_clipRect.pt1.x || x > m_clipRect.pt2.x ||
+       y < m_clipRect.pt1.y || y > m_clipRect.pt2.y))
+    {
+      return;
+    }
+
   struct nxgl_point_s pos;
   pos.x = x;
   pos.y = y;
@@ -202,7 +235,7 @@ void CGraphicsPort::drawHorizLine(nxgl_coord_t x, nxgl_coord_t y,
 
   // Draw the line
 
-  if (!m_pNxWnd->fill(&dest, color))
+  if (clip(&dest) && !m_pNxWnd->fill(&dest, color))
     {
       gdbg("INxWindow::fill failed\n");
     }
@@ -232,7 +265,7 @@ void CGraphicsPort::drawVertLine(nxgl_coord_t x, nxgl_coord_t y,
 
   // Draw the line
 
-  if (!m_pNxWnd->fill(&dest, color))
+  if (clip(&dest) && !m_pNxWnd->fill(&dest, color))
     {
       gdbg("INxWindow::fill failed\n");
     }
@@ -259,6 +292,23 @@ void CGraphicsPort::drawLine(nxgl_coord_t x1, nxgl_coord_t y1,
   vector.pt2.x = x2;
   vector.pt2.y = y2;
 
+  // Lines are not clipped, but lines that lie entirely outside of the
+  // clipping region are not drawn.
+
+  if (m_clipping)
+    {
+      struct nxgl_rect_s bounds;
+      bounds.pt1.x = ngl_min(x1, x2);
+      bounds.pt1.y = ngl_min(y1, y2);
+      bounds.pt2.x = ngl_max(x1, x2);
+      bounds.pt2.y = ngl_max(y1, y2);
+
+      if (!clip(&bounds))
+        {
+          return;
+        }
+    }
+
   if (!m_pNxWnd->drawLine(&vector, 1, color))
     {
       gdbg("INxWindow::drawLine failed\n");
@@ -284,7 +334,11 @@ void CGraphicsPort::drawFilledRect(nxgl_coord_t x, nxgl_coord_t y,
   rect.pt1.y = y;
   rect.pt2.x = x + width - 1;
   rect.pt2.y = y + height - 1;
-  m_pNxWnd->fill(&rect, color);
+
+  if (clip(&rect))
+    {
+      m_pNxWnd->fill(&rect, color);
+    }
 }
 
 /**
@@ -367,7 +421,11 @@ void CGraphicsPort::drawBitmap(nxgl_coord_t x, nxgl_coord_t y,
 
   // Blit the bitmap
 
-  (void)m_pNxWnd->bitmap(&dest, (FAR const void *)bitmap->data, &origin, bitmap->stride);
+  if (clip(&dest))
+    {
+      (void)m_pNxWnd->bitmap(&dest, (FAR const void *)bitmap->data, &origin,
+                             bitmap->stride);
+    }
 }
 
 /**
@@ -505,7 +563,11 @@ void CGraphicsPort::drawBitmap(nxgl_coord_t x, nxgl_coord_t y,
 
       // Blit the bitmap
 
-      (void)m_pNxWnd->bitmap(&dest, (FAR const void *)runPtr, &origin, bitmap->stride);
+      if (clip(&dest))
+        {
+          (void)m_pNxWnd->bitmap(&dest, (FAR const void *)runPtr, &origin,
+                                 bitmap->stride);
+        }
     }
 }
 
@@ -580,7 +642,11 @@ void CGraphicsPort::drawBitmapGreyScale(nxgl_coord_t x, nxgl_coord_t y,
 
       // Now blit the single row
 
-      (void)m_pNxWnd->bitmap(&dest, run, &origin, bitmap->stride);
+      struct nxgl_rect_s clipped = dest;
+      if (clip(&clipped))
+        {
+          (void)m_pNxWnd->bitmap(&clipped, run, &origin, bitmap->stride);
+        }
 
        // Setup for the next source row
 
@@ -731,113 +797,188 @@ void CGraphicsPort::_drawText(struct nxgl_point_s *pos, CRect *bound,
     }
 #endif
 
-  // Allocate a bit of memory to hold the largest rendered font
-
-  unsigned int bmWidth   = ((unsigned int)font->getMaxWidth() * CONFIG_NXWIDGETS_BPP + 7) >> 3;
-  unsigned int bmHeight  = (unsigned int)font->getHeight();
-
-  unsigned int glyphSize =  bmWidth * bmHeight;
-  FAR uint8_t  *glyph    =  new uint8_t[glyphSize];
-
   // Get the bounding rectangle in NX form
 
   struct nxgl_rect_s boundingBox;
   bound->getNxRect(&boundingBox);
 
-  // Loop setup
+  if (!clip(&boundingBox))
+    {
+      return;
+    }
 
-  struct SBitmap bitmap;
-  bitmap.bpp    = CONFIG_NXWIDGETS_BPP;
-  bitmap.fmt    = CONFIG_NXWIDGETS_FMT;
-  bitmap.data   = (FAR const nxgl_mxpixel_t*)glyph;
+  // Find the run of characters that lie (at least partially) within the
+  // horizontal extent of the bounding box.  Only these characters need to
+  // be rendered.
 
-  // Loop for each letter in the sub-string
+  nxgl_coord_t x        = pos->x;
+  nxgl_coord_t runStart = x;
+  nxgl_coord_t runEnd   = x;
+  int          first    = -1;
+  int          last     = -1;
 
   for (int i = startIndex; i < endIndex; i++)
     {
-      // Get the next letter in the string
+      nxgl_coord_t fontWidth = font->getCharWidth(string.getCharAt(i));
+      if (x + fontWidth > boundingBox.pt1.x && x <= boundingBox.pt2.x)
+        {
+          if (first < 0)
+            {
+              first    = i;
+              runStart = x;
+            }
 
-      const nxwidget_char_t letter = string.getCharAt(i);
+          last   = i;
+          runEnd = x + fontWidth;
+        }
+
+      x += fontWidth;
+    }
 
-      // Get the font metrics for this letter
+  // Get the intersection of the run and the bounding box.
 
-      struct nx_fontmetric_s metrics;
-      font->getCharMetrics(letter, &metrics);
+  nxgl_coord_t height = (nxgl_coord_t)font->getHeight();
 
-      // Get the width of the font (in pixels)
+  struct nxgl_rect_s dest;
+  dest.pt1.x = runStart;
+  dest.pt1.y = pos->y;
+  dest.pt2.x = runEnd - 1;
+  dest.pt2.y = pos->y + height - 1;
 
-      nxgl_coord_t fontWidth  = (nxgl_coord_t)(metrics.width + metrics.xoffset);
+  struct nxgl_rect_s intersection;
+  nxgl_rectintersect(&intersection, &dest, &boundingBox);
 
-      // Does the letter have height?  Spaces have width, but no height
+  if (first >= 0 && !nxgl_nullrect(&intersection))
+    {
+      // Get off-screen memory to compose the whole run of characters
 
-      if (metrics.height > 0 || !transparent)
+      unsigned int stride = ((runEnd - runStart) * CONFIG_NXWIDGETS_BPP + 7) >> 3;
+      FAR uint8_t *run    = getTextRun(stride * height);
+      if (!run)
         {
-          // Set the current, effective size of the bitmap
+          gdbg("Failed to allocate text run memory\n");
+          pos->x = x;
+          return;
+        }
 
-          bitmap.width  = fontWidth;
-          bitmap.height = bmHeight;
-          bitmap.stride = (fontWidth * bitmap.bpp + 7) >> 3;
+      // The font renderer always renders the fonts on a transparent
+      // background.  If we are drawing transparently, initialize the
+      // visible part of the run by reading from the display.
 
-          // Describe the destination of the font as a bounding box
+      if (transparent)
+        {
+          struct SBitmap readback;
+          readback.bpp    = CONFIG_NXWIDGETS_BPP;
+          readback.fmt    = CONFIG_NXWIDGETS_FMT;
+          readback.width  = intersection.pt2.x - intersection.pt1.x + 1;
+          readback.height = intersection.pt2.y - intersection.pt1.y + 1;
+          readback.stride = stride;
+          readback.data   = (FAR const void *)
+            &run[(intersection.pt1.y - pos->y) * stride +
+                 (((intersection.pt1.x - runStart) * CONFIG_NXWIDGETS_BPP) >> 3)];
+
+          m_pNxWnd->getRectangle(&intersection, &readback);
+        }
 
-          struct nxgl_rect_s dest;
-          dest.pt1.x = pos->x;
-          dest.pt1.y = pos->y;
-          dest.pt2.x = pos->x + fontWidth - 1;
-          dest.pt2.y = pos->y + bmHeight - 1;
+      // Compose each character of the run into the off-screen memory
 
-          // Get the interection of the font box and the bounding box
+      struct SBitmap bitmap;
+      bitmap.bpp    = CONFIG_NXWIDGETS_BPP;
+      bitmap.fmt    = CONFIG_NXWIDGETS_FMT;
+      bitmap.height = height;
+      bitmap.stride = stride;
 
-          struct nxgl_rect_s intersection;
-          nxgl_rectintersect(&intersection, &dest, &boundingBox);
+      nxgl_coord_t offset = 0;
+      for (int i = first; i <= last; i++)
+        {
+          const nxwidget_char_t letter = string.getCharAt(i);
+          nxgl_coord_t fontWidth = font->getCharWidth(letter);
+          FAR uint8_t *glyph     = &run[(offset * CONFIG_NXWIDGETS_BPP) >> 3];
 
-          // Skip to the next character if this one is completely outside
-          // the bounding box.
+          if (transparent)
+            {
+              // Render the font on top of the display contents
 
-          if (!nxgl_nullrect(&intersection))
+              bitmap.width = fontWidth;
+              bitmap.data  = (FAR const void *)glyph;
+              font->drawChar(&bitmap, letter);
+            }
+          else if (g_glyphCache)
             {
-              // If we have been given a background color, use it to fill the array.
-              // Otherwise initialize the bitmap memory by reading from the display.
-              // The font renderer always renders the fonts on a transparent background.
+              // Get the glyph on its background from the glyph cache
 
-              if (!transparent)
-                {
-                  // Set the glyph memory to the background color
-
-                  nxwidget_pixel_t *bmPtr   = (nxwidget_pixel_t *)bitmap.data;
-                  unsigned int      npixels = fontWidth * bmHeight;
-                  for (unsigned int j = 0; j < npixels; j++)
-                    {
-                      *bmPtr++ = background;
-                    }
-                }
-              else
-                {
-                  // Read the current contents of the destination into the glyph memory
+              g_glyphCache->drawGlyph(font, letter, background, fontWidth,
+                                      height, glyph, stride);
+            }
+          else
+            {
+              // Render the glyph on its background
 
-                  m_pNxWnd->getRectangle(&dest, &bitmap);
-                }
+              CGlyphCache::render(font, letter, background, fontWidth,
+                                  height, glyph, stride);
+            }
 
-              // Render the font into the initialized bitmap
+          offset += fontWidth;
+        }
 
-              font->drawChar(&bitmap, letter);
+      // Then put the whole run on the display at once
 
-              // Then put the font on the display
+      struct nxgl_point_s origin;
+      origin.x = runStart;
+      origin.y = pos->y;
 
-              if (!m_pNxWnd->bitmap(&intersection, (FAR const void *)bitmap.data,
-                                   pos, bitmap.stride))
-                {
-                  gvdbg("nx_bitmapwindow failed: %d\n", errno);
-                }
-            }
+      if (!m_pNxWnd->bitmap(&intersection, (FAR const void *)run, &origin,
+                            stride))
+        {
+          gvdbg("nx_bitmapwindow failed: %d\n", errno);
         }
+    }
 
-      // Adjust the X position for the next character in the string
+  // Adjust the X position to follow the string
 
-      pos->x += fontWidth;
+  pos->x = x;
+}
+
+/**
+ * Clip a rectangle to the clipping region.
+ *
+ * @param rect The rectangle to clip.  It is modified in place.
+ * @return True if any part of the rectangle remains to be drawn.
+ */
+
+bool CGraphicsPort::clip(FAR struct nxgl_rect_s *rect) const
+{
+  if (m_clipping)
+    {
+      nxgl_rectintersect(rect, rect, &m_clipRect);
     }
 
-  delete glyph;
+  return !nxgl_nullrect(rect);
+}
+
+/**
+ * Get off-screen memory large enough to compose a run of text.  The memory
+ * is retained and reused by subsequent text drawing.
+ *
+ * @param size The number of bytes required.
+ * @return The text composition memory or NULL if it could not be
+ *   allocated.
+ */
+
+FAR uint8_t *CGraphicsPort::getTextRun(size_t size)
+{
+  if (size > m_textRunSize)
+    {
+      if (m_textRun)
+        {
+          delete[] m_textRun;
+        }
+
+      m_textRun     = new uint8_t[size];
+      m_textRunSize = m_textRun ? size : 0;
+    }
+
+  return m_textRun;
 }
 
 /**
@@ -910,6 +1051,24 @@ void CGraphicsPort::move(nxgl_coord_t x, nxgl_coord_t y,
 void CGraphicsPort::greyScale(nxgl_coord_t x, nxgl_coord_t y,
                               nxgl_coord_t width, nxgl_coord_t height)
 {
+  // Limit the region to the clipping region
+
+  struct nxgl_rect_s region;
+  region.pt1.x = x;
+  region.pt1.y = y;
+  region.pt2.x = x + width - 1;
+  region.pt2.y = y + height - 1;
+
+  if (!clip(&region))
+    {
+      return;
+    }
+
+  x      = region.pt1.x;
+  y      = region.pt1.y;
+  width  = region.pt2.x - region.pt1.x + 1;
+  height = region.pt2.y - region.pt1.y + 1;
+
   // Allocate memory to hold one row of graphics data
 
   unsigned int stride    = ((unsigned int)width * CONFIG_NXWIDGETS_BPP + 7) >> 3;
@@ -993,6 +1152,24 @@ void CGraphicsPort::greyScale(nxgl_coord_t x, nxgl_coord_t y,
 void CGraphicsPort::invert(nxgl_coord_t x, nxgl_coord_t y,
                            nxgl_coord_t width, nxgl_coord_t height)
 {
+  // Limit the region to the clipping region
+
+  struct nxgl_rect_s region;
+  region.pt1.x = x;
+  region.pt1.y = y;
+  region.pt2.x = x + width - 1;
+  region.pt2.y = y + height - 1;
+
+  if (!clip(&region))
+    {
+      return;
+    }
+
+  x      = region.pt1.x;
+  y      = region.pt1.y;
+  width  = region.pt2.x - region.pt1.x + 1;
+  height = region.pt2.y - region.pt1.y + 1;
+
   // Allocate memory to hold one row of graphics data
 
   unsigned int stride    = ((unsigned int)width * CONFIG_NXWIDGETS_BPP + 7) >> 3;
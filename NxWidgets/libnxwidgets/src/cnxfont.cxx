@@ -123,12 +123,13 @@ void CNxFont::drawChar(FAR SBitmap *bitmap, nxwidget_char_t letter)
 
       uint8_t fwidth  = fbm->metric.width + fbm->metric.xoffset;
       uint8_t fheight = fbm->metric.height + fbm->metric.yoffset;
-      uint8_t fstride = (fwidth * bitmap->bpp + 7) >> 3;
 
-      // Then render the glyph into the bitmap memory
+      // Then render the glyph into the bitmap memory.  The bitmap stride
+      // is used (rather than the character width) so that the character
+      // may be rendered into a wider bitmap.
 
       (void)FONT_RENDERER((FAR nxgl_mxpixel_t*)bitmap->data, fheight,
-                          fwidth, fstride, fbm, m_fontColor);
+                          fwidth, bitmap->stride, fbm, m_fontColor);
     }
 }
 
@@ -484,6 +484,18 @@ void CNxWidget::redraw(void)
 {
   if (isDrawingEnabled())
     {
+#if CONFIG_NXWIDGETS_DAMAGE_NRECTS > 0
+      // If redraws are being deferred, just add the widget to the damage
+      // list.  It will be redrawn when the damage list is flushed.
+
+      if (m_widgetControl->isRedrawDeferred())
+        {
+          CRect rect(getX(), getY(), getWidth(), getHeight());
+          m_widgetControl->markRectDirty(rect);
+          return;
+        }
+#endif
+
       // Get the graphics port needed to draw on this window
 
       CGraphicsPort *port = m_widgetControl->getGraphicsPort();
@@ -503,6 +515,47 @@ void CNxWidget::redraw(void)
     }
 }
 
+/**
+ * Draws the parts of the widget and the widget's child widgets that lie
+ * within a damaged region of the window.  All drawing is clipped to the
+ * region.
+ *
+ * @param rect The window-relative region to redraw.
+ */
+
+void CNxWidget::redrawRect(const CRect &rect)
+{
+  if (isDrawingEnabled())
+    {
+      // Get the part of the widget that lies within the damaged region
+
+      CRect bounds(getX(), getY(), getWidth(), getHeight());
+      if (!bounds.intersects(rect))
+        {
+          return;
+        }
+
+      CRect clipRect;
+      bounds.getIntersect(rect, clipRect);
+
+      // Draw the widget, clipped to the damaged region
+
+      CGraphicsPort *port = m_widgetControl->getGraphicsPort();
+
+      port->setClipRect(clipRect);
+      drawBorder(port);
+      drawContents(port);
+      port->clearClipRect();
+
+      // Draw the children of the widget that intersect the damaged region
+
+      for (int i = 0; i < m_children.size(); i++)
+        {
+          m_children[i]->redrawRect(clipRect);
+        }
+    }
+}
+
 /**
  * Enables the widget.
  *
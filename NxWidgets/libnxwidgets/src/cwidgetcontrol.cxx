@@ -107,6 +107,17 @@ CWidgetControl::CWidgetControl(FAR const CWidgetStyle *style)
   m_nCh                = 0;
   m_nCc                = 0;
 
+  // Initialize the damage list and redraw statistics
+
+#if CONFIG_NXWIDGETS_DAMAGE_NRECTS > 0
+  m_nDamage            = 0;
+  m_deferRedraw        = 0;
+#endif
+  m_nFrames            = 0;
+  m_lastFrameTime      = 0;
+  m_maxFrameTime       = 0;
+  m_totalFrameTime     = 0;
+
   // Intialize semaphores:
   //
   // m_waitSem. The semaphore that will wake up the external logic on mouse events,
@@ -229,9 +240,11 @@ void CWidgetControl::postWindowEvent(void)
  * It can easily be replace with custom, external logic.
  *
  *   processDeleteQueue()
+ *   deferRedraw()
  *   pollMouseEvents(widget)
  *   pollKeyboardEvents()
  *   pollCursorControlEvents()
+ *   flushRedraw()
  *
  * @param widget.  Specific widget to poll.  Use NULL to run the
  *    all widgets in the window.
@@ -244,6 +257,10 @@ bool CWidgetControl::pollEvents(CNxWidget *widget)
 
   processDeleteQueue();
 
+  // Collect the widget redraws caused by the events in the damage list
+
+  deferRedraw();
+
   // Handle mouse input
 
   bool mouseEvent = pollMouseEvents(widget);
@@ -255,9 +272,150 @@ bool CWidgetControl::pollEvents(CNxWidget *widget)
   // Handle cursor control input
 
   bool cursorControlEvent = pollCursorControlEvents();
+
+  // Then redraw the damaged areas of the window once
+
+  flushRedraw();
   return mouseEvent || keyboardEvent || cursorControlEvent;
 }
 
+/**
+ * End a section started with deferRedraw().  When the outermost
+ * section ends, all widgets that intersect the damage list are
+ * redrawn, clipped to the damaged rectangles, and the damage list is
+ * emptied.
+ */
+
+#if CONFIG_NXWIDGETS_DAMAGE_NRECTS > 0
+void CWidgetControl::flushRedraw(void)
+{
+  if (m_deferRedraw == 0 || --m_deferRedraw > 0 || m_nDamage == 0)
+    {
+      return;
+    }
+
+  struct timespec startTime;
+  (void)clock_gettime(CLOCK_REALTIME, &startTime);
+
+  // Take the damage list.  Redraws are no longer deferred, so nothing
+  // will be added to the list while it is being redrawn.
+
+  CRect damage[CONFIG_NXWIDGETS_DAMAGE_NRECTS];
+  int nDamage = m_nDamage;
+
+  for (int i = 0; i < nDamage; i++)
+    {
+      damage[i] = m_damage[i];
+    }
+
+  m_nDamage = 0;
+
+  // Redraw each damaged rectangle.  Each top-level widget redraws itself
+  // and then those of its children that intersect the rectangle.
+
+  for (int i = 0; i < nDamage; i++)
+    {
+      for (int j = 0; j < m_widgets.size(); j++)
+        {
+          if (m_widgets[j]->getParent() == (CNxWidget *)NULL)
+            {
+              m_widgets[j]->redrawRect(damage[i]);
+            }
+        }
+    }
+
+  // Update the redraw statistics
+
+  struct timespec endTime;
+  (void)clock_gettime(CLOCK_REALTIME, &endTime);
+
+  uint32_t usec = (uint32_t)((endTime.tv_sec - startTime.tv_sec) * 1000000 +
+                             (endTime.tv_nsec - startTime.tv_nsec) / 1000);
+
+  m_nFrames++;
+  m_lastFrameTime   = usec;
+  m_totalFrameTime += usec;
+
+  if (usec > m_maxFrameTime)
+    {
+      m_maxFrameTime = usec;
+    }
+}
+#endif
+
+/**
+ * Add a region of the window to the damage list.  Overlapping
+ * rectangles are merged.  If the list is full, the new rectangle is
+ * merged with the entry that grows the least.
+ *
+ * @param rect The window-relative region that must be redrawn.
+ */
+
+#if CONFIG_NXWIDGETS_DAMAGE_NRECTS > 0
+void CWidgetControl::markRectDirty(const CRect &rect)
+{
+  if (!rect.hasDimensions())
+    {
+      return;
+    }
+
+  // Merge the new rectangle with every rectangle that it overlaps.  The
+  // merged rectangle may then overlap entries that were already checked,
+  // so start over after each merge.
+
+  CRect dirty(rect);
+  int i = 0;
+
+  while (i < m_nDamage)
+    {
+      if (m_damage[i].intersects(dirty))
+        {
+          dirty.expandToInclude(m_damage[i]);
+          m_damage[i] = m_damage[--m_nDamage];
+          i = 0;
+        }
+      else
+        {
+          i++;
+        }
+    }
+
+  // If the list is full, merge with the entry whose area grows the least
+
+  if (m_nDamage >= CONFIG_NXWIDGETS_DAMAGE_NRECTS)
+    {
+      int      best       = 0;
+      uint32_t bestGrowth = UINT32_MAX;
+
+      for (i = 0; i < m_nDamage; i++)
+        {
+          CRect sum;
+          m_damage[i].getAddition(dirty, sum);
+
+          uint32_t growth =
+            (uint32_t)sum.getWidth() * sum.getHeight() -
+            (uint32_t)m_damage[i].getWidth() * m_damage[i].getHeight();
+
+          if (growth < bestGrowth)
+            {
+              best       = i;
+              bestGrowth = growth;
+            }
+        }
+
+      dirty.expandToInclude(m_damage[best]);
+      m_damage[best] = m_damage[--m_nDamage];
+
+      // The larger rectangle may now overlap other entries
+
+      markRectDirty(dirty);
+      return;
+    }
+
+  m_damage[m_nDamage++] = dirty;
+}
+#endif
+
 /**
  * Get the index of the specified controlled widget.
  *
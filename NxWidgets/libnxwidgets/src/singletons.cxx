@@ -84,6 +84,7 @@
 #include "cnxstring.hxx"
 #include "cwidgetstyle.hxx"
 #include "cnxfont.hxx"
+#include "cglyphcache.hxx"
 #include "singletons.hxx"
 
 /****************************************************************************
@@ -99,6 +100,7 @@ using namespace NXWidgets;
 CWidgetStyle        *NXWidgets::g_defaultWidgetStyle; /**< The default widget style */
 CNxString           *NXWidgets::g_nullString;         /**< The reusable empty string */
 TNxArray<CNxTimer*> *NXWidgets::g_nxTimers;           /**< An array of all timers */
+CGlyphCache         *NXWidgets::g_glyphCache;         /**< The rendered glyph cache */
 
 /****************************************************************************
  * Method Implementations
@@ -160,6 +162,15 @@ void NXWidgets::instantiateSingletons(void)
       g_nxTimers = new TNxArray<CNxTimer*>();
     }
 
+#if CONFIG_NXWIDGETS_GLYPHCACHE_SIZE > 0
+  // Create the cache of rendered glyphs shared by all text drawing
+
+  if (!g_glyphCache)
+    {
+      g_glyphCache = new CGlyphCache(CONFIG_NXWIDGETS_GLYPHCACHE_SIZE);
+    }
+#endif
+
   sched_unlock();
 }
 
@@ -198,5 +209,13 @@ void NXWidgets::freeSingletons(void)
       g_nxTimers = (TNxArray<CNxTimer*> *)NULL;
     }
 
+  // Free the glyph cache
+
+  if (g_glyphCache)
+    {
+      delete g_glyphCache;
+      g_glyphCache = (CGlyphCache *)NULL;
+    }
+
 }
 
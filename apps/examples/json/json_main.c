@@ -36,6 +36,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 
 #include <apps/netutils/cJSON.h>
@@ -88,6 +89,151 @@ static void doit(const char *text)
     }
 }
 
+/****************************************************************************
+ * Name: doarena
+ *
+ * Description:
+ *   Parse text in-situ into an arena, then stream it back to stdout.
+ *
+ ****************************************************************************/
+
+static void doarena(const char *text)
+{
+  static char storage[2048];
+  cJSON_Arena arena;
+  cJSON *json;
+  char *copy;
+
+  copy = strdup(text);
+  if (!copy)
+    {
+      return;
+    }
+
+  cJSON_InitArena(&arena, storage, sizeof(storage), 0);
+  json = cJSON_ParseInSitu(&arena, copy);
+  if (!json)
+    {
+      printf("Error before: [%s]\n", cJSON_GetErrorPtr());
+    }
+  else
+    {
+      cJSON_PrintFile(json, stdout, 0);
+      printf("\n");
+    }
+
+  cJSON_ResetArena(&arena);
+  free(copy);
+}
+
+/****************************************************************************
+ * Name: sax_handler and dosax
+ *
+ * Description:
+ *   Feed text to the streaming parser a few bytes at a time and show the
+ *   events.
+ *
+ ****************************************************************************/
+
+static int sax_handler(void *priv, int event, const char *name,
+                       const char *str, double number, int depth)
+{
+  static const char *names[] =
+  {
+    "BeginObject", "EndObject", "BeginArray", "EndArray",
+    "Null", "False", "True", "Number", "String"
+  };
+
+  printf("%*s%s", 2 * depth, "", names[event]);
+  if (name)
+    {
+      printf(" \"%s\"", name);
+    }
+
+  if (event == cJSON_SaxNumber)
+    {
+      printf(" %g", number);
+    }
+  else if (event == cJSON_SaxString)
+    {
+      printf(" \"%s\"", str);
+    }
+
+  printf("\n");
+  return 0;
+}
+
+static void dosax(const char *text)
+{
+  cJSON_SaxParser parser;
+  size_t len = strlen(text);
+  size_t offset;
+  size_t nbytes;
+  int ret = 0;
+
+  cJSON_SaxInit(&parser, sax_handler, NULL);
+  for (offset = 0; offset < len && ret == 0; offset += nbytes)
+    {
+      nbytes = len - offset < 16 ? len - offset : 16;
+      ret = cJSON_SaxFeed(&parser, text + offset, nbytes);
+    }
+
+  if (ret == 0)
+    {
+      ret = cJSON_SaxFinish(&parser);
+    }
+
+  if (ret != 0)
+    {
+      printf("Streaming parse failed at offset %lu: %d\n",
+             (unsigned long)parser.offset, ret);
+    }
+}
+
+/****************************************************************************
+ * Name: write_stdout and dowriter
+ *
+ * Description:
+ *   Generate JSON text directly, without building cJSON items.
+ *
+ ****************************************************************************/
+
+static int write_stdout(void *priv, const char *buf, size_t len)
+{
+  return fwrite(buf, 1, len, stdout) == len ? 0 : -1;
+}
+
+static void dowriter(void)
+{
+  static const int ids[4] = { 116, 943, 234, 38793 };
+  cJSON_Writer writer;
+  int i;
+
+  cJSON_WriterInit(&writer, write_stdout, NULL, 1);
+  cJSON_WriteBeginObject(&writer, NULL);
+  cJSON_WriteBeginObject(&writer, "Image");
+  cJSON_WriteNumber(&writer, "Width", 800);
+  cJSON_WriteNumber(&writer, "Height", 600);
+  cJSON_WriteString(&writer, "Title", "View from 15th Floor");
+  cJSON_WriteBeginArray(&writer, "IDs");
+
+  for (i = 0; i < 4; i++)
+    {
+      cJSON_WriteNumber(&writer, NULL, ids[i]);
+    }
+
+  cJSON_WriteEndArray(&writer);
+  cJSON_WriteEndObject(&writer);
+  cJSON_WriteEndObject(&writer);
+
+  if (cJSON_WriterFlush(&writer) != 0)
+    {
+      printf("Writer failed\n");
+    }
+
+  printf("\n");
+}
+
 /****************************************************************************
  * Name: dofile
  *
@@ -325,5 +471,11 @@ int json_main(int argc, const char *argv[])
   /* Now some samplecode for building objects concisely: */
 
   create_objects();
+
+  /* Arena/in-situ parsing, streaming parsing and streaming output */
+
+  doarena(text4);
+  dosax(text1);
+  dowriter();
   return 0;
 }
@@ -0,0 +1,465 @@
+/****************************************************************************
+ * examples/libctest/float_test.c
+ *
+ *   Copyright (C) 2014 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/compiler.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+#include "libctest.h"
+
+#ifdef CONFIG_HAVE_DOUBLE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define FLOAT_NROUNDTRIP  2000
+#define FLOAT_NBENCH      100
+#define FLOAT_BENCHLOOPS  CONFIG_EXAMPLES_LIBCTEST_NLOOPS
+#define FLOAT_BUFSIZE     400
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct strtod_case_s
+{
+  FAR const char *str;      /* Input string */
+  uint64_t        bits;     /* Expected result */
+  int             nused;    /* Expected number of characters used */
+};
+
+struct printf_case_s
+{
+  double          value;    /* Value to print */
+  FAR const char *fmt;      /* Format */
+  FAR const char *expect;   /* Expected output */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct strtod_case_s g_strtod_cases[] =
+{
+  { "0",                       0x0000000000000000ull,  1 },
+  { "-0",                      0x8000000000000000ull,  2 },
+  { "1",                       0x3ff0000000000000ull,  1 },
+  { "-1.5",                    0xbff8000000000000ull,  4 },
+  { "  +3.25e2xyz",            0x4074500000000000ull,  9 },
+  { "0.1",                     0x3fb999999999999aull,  3 },
+  { "0.3",                     0x3fd3333333333333ull,  3 },
+  { "3.14159",                 0x400921f9f01b866eull,  7 },
+  { "-273.15",                 0xc071126666666666ull,  7 },
+  { "1e22",                    0x4480f0cf064dd592ull,  4 },
+  { "1e23",                    0x44b52d02c7e14af6ull,  4 },
+  { "8.41e21",                 0x447c7e83209e90b2ull,  7 },
+  { "1e-22",                   0x3b5e392010175ee6ull,  5 },
+  { "9007199254740993",        0x4340000000000000ull, 16 },
+  { "123456789012345678901234567890",
+                               0x45f8ee90ff6c373eull, 30 },
+
+  /* 1 + 2^-53 is half-way between 1 and the next double */
+
+  { "1.00000000000000011102230246251565404236316680908203125",
+                               0x3ff0000000000000ull, 55 },
+  { "1.00000000000000011102230246251565404236316680908203126",
+                               0x3ff0000000000001ull, 55 },
+
+  /* Subnormal and largest values */
+
+  { "2.2250738585072011e-308", 0x000fffffffffffffull, 23 },
+  { "2.2250738585072012e-308", 0x0010000000000000ull, 23 },
+  { "4.9406564584124654e-324", 0x0000000000000001ull, 23 },
+  { "2.4703282292062327e-324", 0x0000000000000000ull, 23 },
+  { "2.4703282292062328e-324", 0x0000000000000001ull, 23 },
+  { "1.7976931348623157e308",  0x7fefffffffffffffull, 22 },
+  { "1.7976931348623159e308",  0x7ff0000000000000ull, 22 },
+  { "1e400",                   0x7ff0000000000000ull,  5 },
+  { "-1e-400",                 0x8000000000000000ull,  7 },
+  { "0.000000000000000000000000000000000000000001e42",
+                               0x3ff0000000000000ull, 47 },
+
+  /* Syntax */
+
+  { "5.",                      0x4014000000000000ull,  2 },
+  { "-.5e1",                   0xc014000000000000ull,  5 },
+  { "1e",                      0x3ff0000000000000ull,  1 },
+  { "1e+x",                    0x3ff0000000000000ull,  1 },
+  { "inf",                     0x7ff0000000000000ull,  3 },
+  { "-Infinity",               0xfff0000000000000ull,  9 },
+  { "nan",                     0x7ff8000000000000ull,  3 },
+  { ".",                       0x0000000000000000ull,  0 },
+  { "e5",                      0x0000000000000000ull,  0 },
+  { "-",                       0x0000000000000000ull,  0 },
+};
+
+#ifdef CONFIG_LIBC_FLOATINGPOINT
+static const struct printf_case_s g_printf_cases[] =
+{
+  /* Correct rounding of the binary value, ties to even */
+
+  { 0.125,               "%.2f",    "0.12" },
+  { 0.375,               "%.2f",    "0.38" },
+  { 2.675,               "%.2f",    "2.67" },
+  { 1.005,               "%.2f",    "1.00" },
+  { 0.5,                 "%.0f",    "0" },
+  { 1.5,                 "%.0f",    "2" },
+  { 2.5,                 "%.0f",    "2" },
+  { 9.995,               "%.2f",    "9.99" },
+  { 99.5,                "%.0f",    "100" },
+  { 999.9996,            "%.3f",    "1000.000" },
+  { 0.0004,              "%.3f",    "0.000" },
+  { 0.0005,              "%.3f",    "0.001" },
+  { 0.0006,              "%.3f",    "0.001" },
+  { -273.15,             "%.1f",    "-273.1" },
+  { 1e23,                "%.0f",    "99999999999999991611392" },
+  { 1e22,                "%.1f",    "10000000000000000000000.0" },
+  { 1e-7,                "%.10f",   "0.0000001000" },
+  { 0.1,                 "%.20f",   "0.10000000000000000555" },
+  { 4.9406564584124654e-324,
+                         "%.3f",    "0.000" },
+  { 0.3333333333333333,  "%.6f",    "0.333333" },
+  { 0.6666666666666666,  "%.16f",   "0.6666666666666666" },
+
+  /* Field widths */
+
+  { 123.456,             "%10.2f",  "    123.46" },
+  { -1.25,               "%-8.1f|", "-1.2    |" },
+  { 1.5,                 "%8f",     "     1.5" },
+
+  /* Shortest representation if there is no precision */
+
+  { 0.0,                 "%f",      "0" },
+  { 0.1,                 "%f",      "0.1" },
+  { 0.3,                 "%f",      "0.3" },
+  { 0.3333333333333333,  "%f",      "0.3333333333333333" },
+  { 100.0,               "%f",      "100" },
+  { -273.15,             "%f",      "-273.15" },
+  { 1e-7,                "%f",      "0.0000001" },
+  { 1e23,                "%f",      "100000000000000000000000" },
+  { 9007199254740993.0,  "%f",      "9007199254740992" },
+};
+#endif
+
+#ifdef CONFIG_LIBC_FLOATINGPOINT
+static uint32_t g_seed = 1;
+static char g_bench[FLOAT_NBENCH][32];
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_LIBC_FLOATINGPOINT
+/****************************************************************************
+ * Name: float_random
+ ****************************************************************************/
+
+static uint32_t float_random(void)
+{
+  g_seed = g_seed * 1103515245 + 12345;
+  return g_seed >> 8;
+}
+
+/****************************************************************************
+ * Name: float_value
+ ****************************************************************************/
+
+static double float_value(uint64_t bits)
+{
+  double value;
+
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+#endif
+
+/****************************************************************************
+ * Name: float_bits
+ ****************************************************************************/
+
+static uint64_t float_bits(double value)
+{
+  uint64_t bits;
+
+  memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+/****************************************************************************
+ * Name: float_strtodtests
+ ****************************************************************************/
+
+static int float_strtodtests(void)
+{
+  FAR const struct strtod_case_s *tc;
+  FAR char *endptr;
+  uint64_t bits;
+  int nerrors = 0;
+  unsigned int i;
+
+  for (i = 0; i < sizeof(g_strtod_cases) / sizeof(g_strtod_cases[0]); i++)
+    {
+      tc   = &g_strtod_cases[i];
+      bits = float_bits(strtod(tc->str, &endptr));
+
+      if (bits != tc->bits || endptr != tc->str + tc->nused)
+        {
+          printf("  ERROR: strtod(\"%s\") returned %08lx%08lx, used %d\n",
+                 tc->str, (unsigned long)(bits >> 32),
+                 (unsigned long)bits, (int)(endptr - tc->str));
+          nerrors++;
+        }
+    }
+
+  return nerrors;
+}
+
+#ifdef CONFIG_LIBC_FLOATINGPOINT
+/****************************************************************************
+ * Name: float_printftests
+ ****************************************************************************/
+
+static int float_printftests(void)
+{
+  FAR const struct printf_case_s *tc;
+  char buffer[64];
+  int nerrors = 0;
+  unsigned int i;
+
+  for (i = 0; i < sizeof(g_printf_cases) / sizeof(g_printf_cases[0]); i++)
+    {
+      tc = &g_printf_cases[i];
+      snprintf(buffer, sizeof(buffer), tc->fmt, tc->value);
+
+      if (strcmp(buffer, tc->expect) != 0)
+        {
+          printf("  ERROR: \"%s\" printed \"%s\", expected \"%s\"\n",
+                 tc->fmt, buffer, tc->expect);
+          nerrors++;
+        }
+    }
+
+  return nerrors;
+}
+
+/****************************************************************************
+ * Name: float_roundtrip
+ *
+ * Description:
+ *   Print random values with no precision and read them back.  The
+ *   result must be the same value.
+ *
+ ****************************************************************************/
+
+static int float_roundtrip(void)
+{
+  char buffer[FLOAT_BUFSIZE];
+  uint64_t bits;
+  uint64_t result;
+  int nerrors = 0;
+  int i;
+
+  for (i = 0; i < FLOAT_NROUNDTRIP; i++)
+    {
+      /* Random significand and sign, binary exponent in [-100, 100] and a
+       * few subnormals.
+       */
+
+      bits  = ((uint64_t)float_random() << 40) ^
+              ((uint64_t)float_random() << 20) ^ float_random();
+      bits &= 0x800fffffffffffffull;
+
+      if ((i & 63) != 0)
+        {
+          bits |= (uint64_t)(1023 - 100 + float_random() % 201) << 52;
+        }
+
+      snprintf(buffer, sizeof(buffer), "%f", float_value(bits));
+      result = float_bits(strtod(buffer, NULL));
+
+      if (result != bits && !(float_value(bits) == 0 && result == 0))
+        {
+          printf("  ERROR: %08lx%08lx printed as %s\n",
+                 (unsigned long)(bits >> 32), (unsigned long)bits, buffer);
+          if (++nerrors > 10)
+            {
+              break;
+            }
+        }
+    }
+
+  return nerrors;
+}
+
+/****************************************************************************
+ * Name: float_report
+ ****************************************************************************/
+
+static void float_report(FAR const char *name, unsigned long elapsed)
+{
+  printf("  %-24s %6lu ns/conversion\n", name,
+         elapsed * (1000000 / FLOAT_NBENCH) / FLOAT_BENCHLOOPS);
+}
+
+/****************************************************************************
+ * Name: float_benchmark
+ *
+ * Description:
+ *   Measure the conversion of sensor-like readings, and of values with
+ *   full 17 digit precision.
+ *
+ ****************************************************************************/
+
+static void float_benchmark(void)
+{
+  static double values[FLOAT_NBENCH];
+  volatile double sink = 0.0;
+  unsigned long start;
+  char buffer[32];
+  uint64_t bits;
+  int loop;
+  int i;
+
+  for (i = 0; i < FLOAT_NBENCH; i++)
+    {
+      values[i] = (double)(int)(float_random() % 200000) / 1000.0 - 100.0;
+    }
+
+  start = libctest_msec();
+  for (loop = 0; loop < FLOAT_BENCHLOOPS; loop++)
+    {
+      for (i = 0; i < FLOAT_NBENCH; i++)
+        {
+          snprintf(g_bench[i], sizeof(g_bench[i]), "%.3f", values[i]);
+        }
+    }
+
+  float_report("printf %.3f", libctest_msec() - start);
+
+  start = libctest_msec();
+  for (loop = 0; loop < FLOAT_BENCHLOOPS; loop++)
+    {
+      for (i = 0; i < FLOAT_NBENCH; i++)
+        {
+          snprintf(buffer, sizeof(buffer), "%f", values[i]);
+        }
+    }
+
+  float_report("printf %f (shortest)", libctest_msec() - start);
+
+  start = libctest_msec();
+  for (loop = 0; loop < FLOAT_BENCHLOOPS; loop++)
+    {
+      for (i = 0; i < FLOAT_NBENCH; i++)
+        {
+          sink += strtod(g_bench[i], NULL);
+        }
+    }
+
+  float_report("strtod 3 decimals", libctest_msec() - start);
+
+  /* Values in [1, 2) with 17 significant digits */
+
+  for (i = 0; i < FLOAT_NBENCH; i++)
+    {
+      bits = ((uint64_t)float_random() << 32) ^ float_random();
+      bits = (bits & 0x000fffffffffffffull) | 0x3ff0000000000000ull;
+      snprintf(g_bench[i], sizeof(g_bench[i]), "%f", float_value(bits));
+    }
+
+  start = libctest_msec();
+  for (loop = 0; loop < FLOAT_BENCHLOOPS; loop++)
+    {
+      for (i = 0; i < FLOAT_NBENCH; i++)
+        {
+          sink += strtod(g_bench[i], NULL);
+        }
+    }
+
+  float_report("strtod 17 digits", libctest_msec() - start);
+  UNUSED(sink);
+}
+#endif /* CONFIG_LIBC_FLOATINGPOINT */
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: float_test
+ ****************************************************************************/
+
+int float_test(void)
+{
+  int nerrors;
+
+  printf("float_test: strtod\n");
+  nerrors = float_strtodtests();
+
+#ifdef CONFIG_LIBC_FLOATINGPOINT
+  printf("float_test: printf\n");
+  nerrors += float_printftests();
+
+  printf("float_test: Round trip\n");
+  nerrors += float_roundtrip();
+
+  printf("float_test: Throughput (%d conversions)\n",
+         FLOAT_NBENCH * FLOAT_BENCHLOOPS);
+  float_benchmark();
+#endif
+
+  return nerrors;
+}
+
+#else /* CONFIG_HAVE_DOUBLE */
+
+int float_test(void)
+{
+  return 0;
+}
+
+#endif /* CONFIG_HAVE_DOUBLE */
@@ -0,0 +1,78 @@
+/****************************************************************************
+ * examples/libctest/libctest.h
+ *
+ *   Copyright (C) 2014 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __EXAMPLES_LIBCTEST_LIBCTEST_H
+#define __EXAMPLES_LIBCTEST_LIBCTEST_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+/****************************************************************************
+ * Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_EXAMPLES_LIBCTEST_NBYTES
+#  define CONFIG_EXAMPLES_LIBCTEST_NBYTES 4096
+#endif
+
+#ifndef CONFIG_EXAMPLES_LIBCTEST_NLOOPS
+#  define CONFIG_EXAMPLES_LIBCTEST_NLOOPS 1000
+#endif
+
+#ifndef CONFIG_EXAMPLES_LIBCTEST_STDIOPATH
+#  define CONFIG_EXAMPLES_LIBCTEST_STDIOPATH "/tmp/libctest.dat"
+#endif
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/* Common helpers (libctest_main.c) */
+
+unsigned long libctest_msec(void);
+void libctest_report(FAR const char *name, unsigned long nbytes,
+                     unsigned long elapsed);
+
+/* Individual tests.  Each returns the number of failures detected */
+
+int string_test(void);
+int sort_test(void);
+int float_test(void);
+int stdio_test(void);
+
+#endif /* __EXAMPLES_LIBCTEST_LIBCTEST_H */
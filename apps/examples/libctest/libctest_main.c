@@ -0,0 +1,118 @@
+/****************************************************************************
+ * examples/libctest/libctest_main.c
+ *
+ *   Copyright (C) 2014 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdio.h>
+#include <time.h>
+
+#include "libctest.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: libctest_msec
+ *
+ * Description:
+ *   Return the current time in milliseconds.
+ *
+ ****************************************************************************/
+
+unsigned long libctest_msec(void)
+{
+  struct timespec ts;
+
+  (void)clock_gettime(CLOCK_REALTIME, &ts);
+  return (unsigned long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/****************************************************************************
+ * Name: libctest_report
+ *
+ * Description:
+ *   Report the throughput of one measurement.
+ *
+ ****************************************************************************/
+
+void libctest_report(FAR const char *name, unsigned long nbytes,
+                     unsigned long elapsed)
+{
+  if (elapsed == 0)
+    {
+      elapsed = 1;
+    }
+
+  printf("  %-16s %8lu KB/s\n", name, (nbytes / 1024) * 1000 / elapsed);
+}
+
+/****************************************************************************
+ * Name: libctest_main
+ ****************************************************************************/
+
+#ifdef CONFIG_BUILD_KERNEL
+int main(int argc, FAR char *argv[])
+#else
+int libctest_main(int argc, char *argv[])
+#endif
+{
+  int nerrors = 0;
+
+  printf("\nlibctest: String and memory functions\n");
+  nerrors += string_test();
+
+  printf("\nlibctest: Sorting and searching\n");
+  nerrors += sort_test();
+
+  printf("\nlibctest: Floating point conversions\n");
+  nerrors += float_test();
+
+  printf("\nlibctest: Standard I/O\n");
+  nerrors += stdio_test();
+
+  if (nerrors > 0)
+    {
+      printf("libctest: FAILED, %d errors\n", nerrors);
+      return 1;
+    }
+
+  printf("libctest: PASSED\n");
+  return 0;
+}
@@ -0,0 +1,611 @@
+/****************************************************************************
+ * examples/libctest/sort_test.c
+ *
+ *   Copyright (C) 2014 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "libctest.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The largest array sorted and the largest member size tested */
+
+#define SORT_MAXMEMB     512
+#define SORT_MAXSIZE     16
+
+/* Generous bound on the number of comparisons for n members: introsort
+ * needs at most about 4 n log2(n) even for adversarial input.
+ */
+
+#define SORT_CMPLIMIT(n, log2n) (4 * (n) * ((log2n) + 1) + 16)
+
+#define SORT_BENCHLOOPS  100
+
+/* Input patterns */
+
+#define SORT_RANDOM      0
+#define SORT_SORTED      1
+#define SORT_REVERSED    2
+#define SORT_EQUAL       3
+#define SORT_FEWVALUES   4
+#define SORT_ORGANPIPE   5
+#define SORT_SAWTOOTH    6
+#define SORT_NPATTERNS   7
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const char *g_patterns[SORT_NPATTERNS] =
+{
+  "random", "sorted", "reversed", "equal", "few values", "organ pipe",
+  "sawtooth"
+};
+
+/* Member sizes: 3 (unaligned, byte swaps), 4, 8 and 16 (unrolled word
+ * swaps) and 12 (word swap loop).
+ */
+
+static const size_t g_sizes[] = { 3, 4, 8, 12, 16 };
+
+static uint32_t g_array[SORT_MAXMEMB * SORT_MAXSIZE / sizeof(uint32_t)];
+static uint8_t  g_seen[SORT_MAXMEMB];
+static uint32_t g_seed = 1;
+static unsigned long g_ncmp;
+
+/* State of the adversary comparison function */
+
+static int      g_advval[SORT_MAXMEMB];
+static int      g_advnsolid;
+static int      g_advcandidate;
+static int      g_advgas;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sort_random
+ ****************************************************************************/
+
+static uint32_t sort_random(void)
+{
+  g_seed = g_seed * 1103515245 + 12345;
+  return g_seed >> 8;
+}
+
+/****************************************************************************
+ * Name: sort_log2
+ ****************************************************************************/
+
+static int sort_log2(size_t n)
+{
+  int log2n = 0;
+
+  for (; n > 1; n >>= 1)
+    {
+      log2n++;
+    }
+
+  return log2n;
+}
+
+/****************************************************************************
+ * Name: sort_member, sort_getkey, sort_setmember
+ *
+ * Description:
+ *   Members hold a key in their first bytes: 24 bits for 3-byte members
+ *   and 32 bits otherwise.  Members of 8 bytes or more also hold an index
+ *   in their second word, used to check that the result is a permutation
+ *   of the input.
+ *
+ ****************************************************************************/
+
+static FAR uint8_t *sort_member(size_t size, int i)
+{
+  return (FAR uint8_t *)g_array + i * size;
+}
+
+static uint32_t sort_getkey(FAR const void *member, size_t size)
+{
+  FAR const uint8_t *p = (FAR const uint8_t *)member;
+
+  if (size == 3)
+    {
+      return ((uint32_t)p[0] << 16) | ((uint32_t)p[1] << 8) | p[2];
+    }
+
+  return *(FAR const uint32_t *)member;
+}
+
+static void sort_setmember(size_t size, int i, uint32_t key)
+{
+  FAR uint8_t *p = sort_member(size, i);
+
+  if (size == 3)
+    {
+      p[0] = (uint8_t)(key >> 16);
+      p[1] = (uint8_t)(key >> 8);
+      p[2] = (uint8_t)key;
+    }
+  else
+    {
+      memset(p, 0x5a, size);
+      ((FAR uint32_t *)p)[0] = key;
+      if (size >= 8)
+        {
+          ((FAR uint32_t *)p)[1] = i;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: sort_compare3 and sort_compare32
+ ****************************************************************************/
+
+static int sort_compare3(FAR const void *a, FAR const void *b)
+{
+  uint32_t ka = sort_getkey(a, 3);
+  uint32_t kb = sort_getkey(b, 3);
+
+  g_ncmp++;
+  return ka < kb ? -1 : ka > kb ? 1 : 0;
+}
+
+static int sort_compare32(FAR const void *a, FAR const void *b)
+{
+  uint32_t ka = *(FAR const uint32_t *)a;
+  uint32_t kb = *(FAR const uint32_t *)b;
+
+  g_ncmp++;
+  return ka < kb ? -1 : ka > kb ? 1 : 0;
+}
+
+/****************************************************************************
+ * Name: sort_fill
+ ****************************************************************************/
+
+static void sort_fill(size_t size, int nmemb, int pattern)
+{
+  uint32_t key;
+  int i;
+
+  for (i = 0; i < nmemb; i++)
+    {
+      switch (pattern)
+        {
+          case SORT_RANDOM:
+          default:
+            key = sort_random();
+            break;
+
+          case SORT_SORTED:
+            key = i;
+            break;
+
+          case SORT_REVERSED:
+            key = nmemb - i;
+            break;
+
+          case SORT_EQUAL:
+            key = 7;
+            break;
+
+          case SORT_FEWVALUES:
+            key = sort_random() % 4;
+            break;
+
+          case SORT_ORGANPIPE:
+            key = i < nmemb / 2 ? i : nmemb - i;
+            break;
+
+          case SORT_SAWTOOTH:
+            key = i % 16;
+            break;
+        }
+
+      if (size == 3)
+        {
+          key &= 0x00ffffff;
+        }
+
+      sort_setmember(size, i, key);
+    }
+}
+
+/****************************************************************************
+ * Name: sort_verify
+ *
+ * Description:
+ *   Check that the array is sorted and, for members with an index, that
+ *   each original member is present exactly once and unmodified.  For the
+ *   smaller members, sum and xor are compared instead.
+ *
+ ****************************************************************************/
+
+static int sort_verify(size_t size, int nmemb, uint32_t sum, uint32_t xor)
+{
+  FAR uint8_t *p;
+  uint32_t index;
+  uint32_t key;
+  uint32_t prev = 0;
+  size_t j;
+  int i;
+
+  memset(g_seen, 0, sizeof(g_seen));
+
+  for (i = 0; i < nmemb; i++)
+    {
+      p   = sort_member(size, i);
+      key = sort_getkey(p, size);
+
+      if (i > 0 && key < prev)
+        {
+          printf("  ERROR: member %d out of order\n", i);
+          return 1;
+        }
+
+      prev = key;
+      sum -= key;
+      xor ^= key;
+
+      if (size >= 8)
+        {
+          index = ((FAR uint32_t *)p)[1];
+          if (index >= (uint32_t)nmemb || g_seen[index])
+            {
+              printf("  ERROR: member %d has a bad index %lu\n",
+                     i, (unsigned long)index);
+              return 1;
+            }
+
+          g_seen[index] = 1;
+
+          for (j = 8; j < size; j++)
+            {
+              if (p[j] != 0x5a)
+                {
+                  printf("  ERROR: member %d was corrupted\n", i);
+                  return 1;
+                }
+            }
+        }
+    }
+
+  if (sum != 0 || xor != 0)
+    {
+      printf("  ERROR: the keys changed\n");
+      return 1;
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: sort_one
+ *
+ * Description:
+ *   Sort one array and verify the result and the number of comparisons.
+ *
+ ****************************************************************************/
+
+static int sort_one(size_t size, int nmemb, int pattern)
+{
+  uint32_t sum = 0;
+  uint32_t xor = 0;
+  uint32_t key;
+  unsigned long limit;
+  int i;
+
+  sort_fill(size, nmemb, pattern);
+
+  for (i = 0; i < nmemb; i++)
+    {
+      key  = sort_getkey(sort_member(size, i), size);
+      sum += key;
+      xor ^= key;
+    }
+
+  g_ncmp = 0;
+  qsort(g_array, nmemb, size, size == 3 ? sort_compare3 : sort_compare32);
+
+  if (sort_verify(size, nmemb, sum, xor) != 0)
+    {
+      printf("  ERROR: size %lu, %d members, %s\n",
+             (unsigned long)size, nmemb, g_patterns[pattern]);
+      return 1;
+    }
+
+  limit = SORT_CMPLIMIT((unsigned long)nmemb, sort_log2(nmemb));
+  if (g_ncmp > limit)
+    {
+      printf("  ERROR: size %lu, %d members, %s: %lu comparisons\n",
+             (unsigned long)size, nmemb, g_patterns[pattern], g_ncmp);
+      return 1;
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: sort_patterntests
+ ****************************************************************************/
+
+static int sort_patterntests(void)
+{
+  static const int counts[] =
+  {
+    0, 1, 2, 3, 5, 7, 11, 12, 13, 16, 31, 40, 41, 64, 100, 257, SORT_MAXMEMB
+  };
+
+  int nerrors = 0;
+  unsigned int s;
+  unsigned int c;
+  int pattern;
+
+  for (s = 0; s < sizeof(g_sizes) / sizeof(g_sizes[0]); s++)
+    {
+      for (c = 0; c < sizeof(counts) / sizeof(counts[0]); c++)
+        {
+          for (pattern = 0; pattern < SORT_NPATTERNS; pattern++)
+            {
+              nerrors += sort_one(g_sizes[s], counts[c], pattern);
+              if (nerrors > 10)
+                {
+                  return nerrors;
+                }
+            }
+        }
+    }
+
+  return nerrors;
+}
+
+/****************************************************************************
+ * Name: sort_adversary
+ *
+ * Description:
+ *   McIlroy's "A Killer Adversary for Quicksort".  The values of the
+ *   members are decided lazily during the sort so as to make every pivot
+ *   as bad as possible.  Unbounded quicksorts take quadratic time on the
+ *   resulting input.
+ *
+ ****************************************************************************/
+
+static int sort_adversary(FAR const void *a, FAR const void *b)
+{
+  int x = *(FAR const int *)a;
+  int y = *(FAR const int *)b;
+
+  g_ncmp++;
+
+  if (g_advval[x] == g_advgas && g_advval[y] == g_advgas)
+    {
+      if (x == g_advcandidate)
+        {
+          g_advval[x] = g_advnsolid++;
+        }
+      else
+        {
+          g_advval[y] = g_advnsolid++;
+        }
+    }
+
+  if (g_advval[x] == g_advgas)
+    {
+      g_advcandidate = x;
+    }
+  else if (g_advval[y] == g_advgas)
+    {
+      g_advcandidate = y;
+    }
+
+  return g_advval[x] - g_advval[y];
+}
+
+static int sort_adversarytest(void)
+{
+  FAR int *ptr = (FAR int *)g_array;
+  unsigned long limit;
+  int nmemb = SORT_MAXMEMB;
+  int i;
+
+  g_advgas       = nmemb;
+  g_advnsolid    = 0;
+  g_advcandidate = 0;
+
+  for (i = 0; i < nmemb; i++)
+    {
+      ptr[i]      = i;
+      g_advval[i] = g_advgas;
+    }
+
+  g_ncmp = 0;
+  qsort(ptr, nmemb, sizeof(int), sort_adversary);
+
+  limit = SORT_CMPLIMIT((unsigned long)nmemb, sort_log2(nmemb));
+  printf("  %d members: %lu comparisons (limit %lu)\n",
+         nmemb, g_ncmp, limit);
+
+  for (i = 1; i < nmemb; i++)
+    {
+      if (g_advval[ptr[i - 1]] > g_advval[ptr[i]])
+        {
+          printf("  ERROR: adversary input not sorted at %d\n", i);
+          return 1;
+        }
+    }
+
+  if (g_ncmp > limit)
+    {
+      printf("  ERROR: too many comparisons\n");
+      return 1;
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: sort_searchtests
+ *
+ * Description:
+ *   Verify bsearch() and bsearch_lower() for every key in and around a
+ *   sorted array with runs of equal members, against a linear search.
+ *
+ ****************************************************************************/
+
+static int sort_searchtests(void)
+{
+  FAR uint32_t *array = g_array;
+  FAR uint32_t *found;
+  uint32_t key;
+  int nerrors = 0;
+  int nmemb;
+  int lower;
+  int i;
+
+  for (nmemb = 0; nmemb <= 40; nmemb++)
+    {
+      /* 0 0 0 2 2 2 4 4 4 ... */
+
+      for (i = 0; i < nmemb; i++)
+        {
+          array[i] = (i / 3) * 2;
+        }
+
+      for (key = 0; key <= (uint32_t)(nmemb / 3) * 2 + 2; key++)
+        {
+          for (lower = 0; lower < nmemb && array[lower] < key; lower++);
+
+          found = (FAR uint32_t *)bsearch(&key, array, nmemb,
+                                          sizeof(uint32_t), sort_compare32);
+          if ((lower < nmemb && array[lower] == key) ?
+              (found == NULL || *found != key) : (found != NULL))
+            {
+              printf("  ERROR: bsearch %d members, key %lu\n",
+                     nmemb, (unsigned long)key);
+              nerrors++;
+            }
+
+          found = (FAR uint32_t *)bsearch_lower(&key, array, nmemb,
+                                                sizeof(uint32_t),
+                                                sort_compare32);
+          if (found != &array[lower])
+            {
+              printf("  ERROR: bsearch_lower %d members, key %lu\n",
+                     nmemb, (unsigned long)key);
+              nerrors++;
+            }
+        }
+    }
+
+  return nerrors;
+}
+
+/****************************************************************************
+ * Name: sort_benchmark
+ ****************************************************************************/
+
+static void sort_benchmark(size_t size, int pattern)
+{
+  unsigned long elapsed = 0;
+  unsigned long ncmp = 0;
+  unsigned long start;
+  int i;
+
+  for (i = 0; i < SORT_BENCHLOOPS; i++)
+    {
+      sort_fill(size, SORT_MAXMEMB, pattern);
+
+      g_ncmp = 0;
+      start  = libctest_msec();
+      qsort(g_array, SORT_MAXMEMB, size,
+            size == 3 ? sort_compare3 : sort_compare32);
+      elapsed += libctest_msec() - start;
+      ncmp    += g_ncmp;
+    }
+
+  printf("  %2lu bytes %-10s %6lu us/sort %6lu compares\n",
+         (unsigned long)size, g_patterns[pattern],
+         elapsed * 1000 / SORT_BENCHLOOPS, ncmp / SORT_BENCHLOOPS);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sort_test
+ ****************************************************************************/
+
+int sort_test(void)
+{
+  unsigned int s;
+  int nerrors;
+
+  printf("sort_test: qsort input patterns\n");
+  nerrors = sort_patterntests();
+
+  printf("sort_test: qsort adversary\n");
+  nerrors += sort_adversarytest();
+
+  printf("sort_test: bsearch and bsearch_lower\n");
+  nerrors += sort_searchtests();
+
+  printf("sort_test: Throughput (%d members x %d)\n",
+         SORT_MAXMEMB, SORT_BENCHLOOPS);
+
+  for (s = 0; s < sizeof(g_sizes) / sizeof(g_sizes[0]); s++)
+    {
+      sort_benchmark(g_sizes[s], SORT_RANDOM);
+    }
+
+  sort_benchmark(4, SORT_SORTED);
+  sort_benchmark(4, SORT_FEWVALUES);
+
+  return nerrors;
+}
@@ -0,0 +1,442 @@
+/****************************************************************************
+ * examples/libctest/stdio_test.c
+ *
+ *   Copyright (C) 2014 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "libctest.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The file tests write and read back STDIO_FILESIZE bytes.  This spans
+ * several stdio buffers so that both the buffered and the direct paths of
+ * fwrite() and fread() are used.
+ */
+
+#ifndef CONFIG_STDIO_BUFFER_SIZE
+#  define CONFIG_STDIO_BUFFER_SIZE 64
+#endif
+
+#ifndef MIN
+#  define MIN(a,b) ((a) < (b) ? (a) : (b))
+#endif
+
+#define STDIO_FILESIZE    (8 * CONFIG_STDIO_BUFFER_SIZE + 13)
+#define STDIO_SMALLCHUNK  16
+
+#define THROUGHPUT_NBYTES CONFIG_EXAMPLES_LIBCTEST_NBYTES
+#define THROUGHPUT_NLOOPS CONFIG_EXAMPLES_LIBCTEST_NLOOPS
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct stdio_printf_s
+{
+  FAR const char *expected;         /* Expected output */
+  int             ret;              /* Expected return value */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static unsigned char g_wrbuf[STDIO_FILESIZE];
+static unsigned char g_rdbuf[STDIO_FILESIZE];
+static char g_tpbuf[THROUGHPUT_NBYTES];
+
+/* The chunk sizes used to write and to read the test file */
+
+static const int g_chunks[] =
+{
+  1, 7, CONFIG_STDIO_BUFFER_SIZE - 1, CONFIG_STDIO_BUFFER_SIZE,
+  CONFIG_STDIO_BUFFER_SIZE + 1, 3 * CONFIG_STDIO_BUFFER_SIZE + 5, 2
+};
+
+#define STDIO_NCHUNKS (sizeof(g_chunks) / sizeof(g_chunks[0]))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: stdio_checkprintf
+ ****************************************************************************/
+
+static int stdio_checkprintf(int index, FAR const char *result, int ret,
+                             FAR const char *expected)
+{
+  if (strcmp(result, expected) != 0 || ret != (int)strlen(expected))
+    {
+      printf("  ERROR: printf %d: \"%s\" (%d), expected \"%s\" (%d)\n",
+             index, result, ret, expected, (int)strlen(expected));
+      return 1;
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: stdio_printftests
+ *
+ * Description:
+ *   Verify that runs of literal text, strings and numbers are output
+ *   correctly, alone and next to each other, and that snprintf() truncates
+ *   them correctly.
+ *
+ ****************************************************************************/
+
+static int stdio_printftests(void)
+{
+  static const char literal[] =
+    "A run of literal text that is longer than most format strings";
+  char buffer[128];
+  char small[10];
+  int nerrors = 0;
+  int ret;
+
+  ret = sprintf(buffer, "%s", literal);
+  nerrors += stdio_checkprintf(0, buffer, ret, literal);
+
+  ret = sprintf(buffer, "%s", "");
+  nerrors += stdio_checkprintf(1, buffer, ret, "");
+
+  ret = sprintf(buffer, "[%s][%8s][%-8s]", "abc", "right", "left");
+  nerrors += stdio_checkprintf(2, buffer, ret, "[abc][   right][left    ]");
+
+  ret = sprintf(buffer, "%d %5d %-5d| %05d %u",
+                -1234, 42, 42, 42, 4000000000u);
+  nerrors += stdio_checkprintf(3, buffer, ret,
+                               "-1234    42 42   | 00042 4000000000");
+
+  ret = sprintf(buffer, "%x%c%%%s", 0xbeef, '/', "end");
+  nerrors += stdio_checkprintf(4, buffer, ret, "beef/%end");
+
+  ret = sprintf(buffer, "line 1\nline %d\n%s\n", 2, "line 3");
+  nerrors += stdio_checkprintf(5, buffer, ret, "line 1\nline 2\nline 3\n");
+
+  /* snprintf() stops at the end of the buffer, also within a run */
+
+  (void)snprintf(small, sizeof(small), "%s: %d items", "inventory", 12345);
+  if (strcmp(small, "inventory") != 0)
+    {
+      printf("  ERROR: snprintf: \"%s\", expected \"inventory\"\n", small);
+      nerrors++;
+    }
+
+  (void)snprintf(small, sizeof(small), "abcdefghijklmnop");
+  if (strcmp(small, "abcdefghi") != 0)
+    {
+      printf("  ERROR: snprintf: \"%s\", expected \"abcdefghi\"\n", small);
+      nerrors++;
+    }
+
+  (void)snprintf(small, sizeof(small), "%d%s", 1234, "56789xyz");
+  if (strcmp(small, "123456789") != 0)
+    {
+      printf("  ERROR: snprintf: \"%s\", expected \"123456789\"\n", small);
+      nerrors++;
+    }
+
+  return nerrors;
+}
+
+/****************************************************************************
+ * Name: stdio_filetests
+ *
+ * Description:
+ *   Write a file with fwrite() and fprintf() using chunks of many sizes,
+ *   read it back with fread() using different chunk sizes, and compare.
+ *
+ ****************************************************************************/
+
+static int stdio_filetests(FAR const char *path)
+{
+  FAR FILE *stream;
+  char expected[64];
+  char line[64];
+  size_t pos;
+  size_t n;
+  int nerrors = 0;
+  int len;
+  int i;
+
+  for (pos = 0; pos < STDIO_FILESIZE; pos++)
+    {
+      g_wrbuf[pos] = (unsigned char)(pos * 7 + pos / 13);
+    }
+
+  stream = fopen(path, "w");
+  if (!stream)
+    {
+      printf("  Cannot create %s, file tests skipped\n", path);
+      return 0;
+    }
+
+  for (pos = 0, i = 0; pos < STDIO_FILESIZE; pos += n, i++)
+    {
+      n = g_chunks[i % STDIO_NCHUNKS];
+      if (n > STDIO_FILESIZE - pos)
+        {
+          n = STDIO_FILESIZE - pos;
+        }
+
+      if (fwrite(&g_wrbuf[pos], 1, n, stream) != n)
+        {
+          printf("  ERROR: fwrite of %lu bytes at %lu failed\n",
+                 (unsigned long)n, (unsigned long)pos);
+          nerrors++;
+          break;
+        }
+    }
+
+  len = fprintf(stream, "%s %d\n", "sensor", 1234);
+  fclose(stream);
+
+  stream = fopen(path, "r");
+  if (!stream)
+    {
+      printf("  ERROR: Cannot open %s\n", path);
+      return nerrors + 1;
+    }
+
+  memset(g_rdbuf, 0, sizeof(g_rdbuf));
+  for (pos = 0, i = 3; pos < STDIO_FILESIZE; pos += n, i++)
+    {
+      n = g_chunks[i % STDIO_NCHUNKS];
+      if (n > STDIO_FILESIZE - pos)
+        {
+          n = STDIO_FILESIZE - pos;
+        }
+
+      if (fread(&g_rdbuf[pos], 1, n, stream) != n)
+        {
+          printf("  ERROR: fread of %lu bytes at %lu failed\n",
+                 (unsigned long)n, (unsigned long)pos);
+          nerrors++;
+          break;
+        }
+    }
+
+  if (memcmp(g_wrbuf, g_rdbuf, STDIO_FILESIZE) != 0)
+    {
+      printf("  ERROR: Data read differs from data written\n");
+      nerrors++;
+    }
+
+  /* The fprintf() output follows the binary data */
+
+  sprintf(expected, "%s %d\n", "sensor", 1234);
+  memset(line, 0, sizeof(line));
+  n = fread(line, 1, sizeof(line) - 1, stream);
+  if (len != (int)strlen(expected) || strcmp(line, expected) != 0)
+    {
+      printf("  ERROR: fprintf wrote \"%s\" (%d), expected \"%s\"\n",
+             line, len, expected);
+      nerrors++;
+    }
+
+  fclose(stream);
+  return nerrors;
+}
+
+/****************************************************************************
+ * Name: stdio_throughput
+ *
+ * Description:
+ *   Measure fwrite() to /dev/null and fread() from the test file in small
+ *   and in large chunks, and the output of a typical log message with
+ *   fprintf() and sprintf().
+ *
+ ****************************************************************************/
+
+static void stdio_throughput(FAR const char *path)
+{
+  unsigned long nbytes = (unsigned long)THROUGHPUT_NBYTES * THROUGHPUT_NLOOPS;
+  unsigned long start;
+  FAR FILE *stream;
+  char line[64];
+  int chunk;
+  int len;
+  int n;
+  int i;
+  int j;
+
+  memset(g_tpbuf, 'x', sizeof(g_tpbuf));
+
+  stream = fopen("/dev/null", "w");
+  if (!stream)
+    {
+      printf("  Cannot open /dev/null, output measurements skipped\n");
+    }
+  else
+    {
+      for (chunk = STDIO_SMALLCHUNK; ; chunk = THROUGHPUT_NBYTES)
+        {
+          start = libctest_msec();
+          for (i = 0; i < THROUGHPUT_NLOOPS; i++)
+            {
+              for (j = 0; j < THROUGHPUT_NBYTES; j += n)
+                {
+                  n = MIN(chunk, THROUGHPUT_NBYTES - j);
+                  (void)fwrite(&g_tpbuf[j], 1, n, stream);
+                }
+            }
+
+          libctest_report(chunk == THROUGHPUT_NBYTES ? "fwrite bulk" :
+                          "fwrite 16", nbytes, libctest_msec() - start);
+
+          if (chunk == THROUGHPUT_NBYTES)
+            {
+              break;
+            }
+        }
+
+      /* fprintf() of a typical message:  Runs of text, a string and a
+       * number.
+       */
+
+      len   = 0;
+      start = libctest_msec();
+      for (i = 0; i < THROUGHPUT_NLOOPS; i++)
+        {
+          for (j = 0; j < 16; j++)
+            {
+              len += fprintf(stream, "Sensor %s reading %d mV, status %s\n",
+                             "temp0", 1000 + j, "nominal");
+            }
+        }
+
+      libctest_report("fprintf", len, libctest_msec() - start);
+      fclose(stream);
+    }
+
+  len   = 0;
+  start = libctest_msec();
+  for (i = 0; i < THROUGHPUT_NLOOPS; i++)
+    {
+      for (j = 0; j < 16; j++)
+        {
+          len += sprintf(line, "Sensor %s reading %d mV, status %s\n",
+                         "temp0", 1000 + j, "nominal");
+        }
+    }
+
+  libctest_report("sprintf", len, libctest_msec() - start);
+
+  /* Read the file in small and in large chunks */
+
+  stream = fopen(path, "w");
+  if (!stream)
+    {
+      printf("  Cannot create %s, input measurements skipped\n", path);
+      return;
+    }
+
+  (void)fwrite(g_tpbuf, 1, THROUGHPUT_NBYTES, stream);
+  fclose(stream);
+
+  stream = fopen(path, "r");
+  if (!stream)
+    {
+      printf("  Cannot open %s, input measurements skipped\n", path);
+      return;
+    }
+
+  for (chunk = STDIO_SMALLCHUNK; ; chunk = THROUGHPUT_NBYTES)
+    {
+      start = libctest_msec();
+      for (i = 0; i < THROUGHPUT_NLOOPS; i++)
+        {
+          rewind(stream);
+          for (j = 0; j < THROUGHPUT_NBYTES; j += n)
+            {
+              n = MIN(chunk, THROUGHPUT_NBYTES - j);
+              (void)fread(&g_tpbuf[j], 1, n, stream);
+            }
+        }
+
+      libctest_report(chunk == THROUGHPUT_NBYTES ? "fread bulk" :
+                      "fread 16", nbytes, libctest_msec() - start);
+
+      if (chunk == THROUGHPUT_NBYTES)
+        {
+          break;
+        }
+    }
+
+  fclose(stream);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: stdio_test
+ ****************************************************************************/
+
+int stdio_test(void)
+{
+  int nerrors;
+
+  printf("stdio_test: printf\n");
+  nerrors = stdio_printftests();
+
+#if CONFIG_NFILE_STREAMS > 0
+  printf("stdio_test: fwrite, fread and fprintf\n");
+  nerrors += stdio_filetests(CONFIG_EXAMPLES_LIBCTEST_STDIOPATH);
+
+  printf("stdio_test: Throughput (%d bytes x %d)\n",
+         THROUGHPUT_NBYTES, THROUGHPUT_NLOOPS);
+  stdio_throughput(CONFIG_EXAMPLES_LIBCTEST_STDIOPATH);
+
+  (void)unlink(CONFIG_EXAMPLES_LIBCTEST_STDIOPATH);
+#endif
+
+  return nerrors;
+}
@@ -0,0 +1,528 @@
+/****************************************************************************
+ * examples/libctest/string_test.c
+ *
+ *   Copyright (C) 2014 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "libctest.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The correctness tests use every combination of source and destination
+ * offset below STRING_MAXALIGN and every size below STRING_MAXSIZE.  Each
+ * buffer is surrounded by STRING_GUARD bytes that must not be modified.
+ */
+
+#define STRING_MAXALIGN  16
+#define STRING_MAXSIZE   80
+#define STRING_GUARD     16
+#define STRING_BUFSIZE   (STRING_GUARD + STRING_MAXALIGN + STRING_MAXSIZE + STRING_GUARD)
+#define STRING_FILL      0xa5
+
+#define THROUGHPUT_NBYTES CONFIG_EXAMPLES_LIBCTEST_NBYTES
+#define THROUGHPUT_NLOOPS CONFIG_EXAMPLES_LIBCTEST_NLOOPS
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static unsigned char g_src[STRING_BUFSIZE];
+static unsigned char g_dest[STRING_BUFSIZE];
+static unsigned char g_ref[STRING_BUFSIZE];
+static uint32_t g_seed = 1;
+
+static char g_tpsrc[THROUGHPUT_NBYTES + STRING_MAXALIGN];
+static char g_tpdest[THROUGHPUT_NBYTES + STRING_MAXALIGN];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: string_random
+ *
+ * Description:
+ *   Return a pseudo-random byte that is never zero.  A private generator is
+ *   used so that the test sequence is the same on every target.
+ *
+ ****************************************************************************/
+
+static unsigned char string_random(void)
+{
+  g_seed = g_seed * 1103515245 + 12345;
+  return (unsigned char)((g_seed >> 16) % 255 + 1);
+}
+
+/****************************************************************************
+ * Name: string_fill
+ ****************************************************************************/
+
+static void string_fill(void)
+{
+  int i;
+
+  for (i = 0; i < STRING_BUFSIZE; i++)
+    {
+      g_src[i]  = string_random();
+      g_dest[i] = STRING_FILL;
+      g_ref[i]  = STRING_FILL;
+    }
+}
+
+/****************************************************************************
+ * Name: string_check
+ *
+ * Description:
+ *   Compare the destination buffer, including its guard bytes, with the
+ *   reference buffer.
+ *
+ ****************************************************************************/
+
+static int string_check(FAR const char *name, int srcoff, int destoff,
+                        int size)
+{
+  int i;
+
+  for (i = 0; i < STRING_BUFSIZE; i++)
+    {
+      if (g_dest[i] != g_ref[i])
+        {
+          printf("  ERROR: %s src+%d dest+%d size %d: byte %d is %02x, "
+                 "expected %02x\n",
+                 name, srcoff, destoff, size, i, g_dest[i], g_ref[i]);
+          return 1;
+        }
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: string_sign
+ ****************************************************************************/
+
+static int string_sign(int value)
+{
+  return value < 0 ? -1 : value > 0 ? 1 : 0;
+}
+
+/****************************************************************************
+ * Name: string_copytests
+ *
+ * Description:
+ *   Verify memcpy(), memmove() and strncpy() against byte-by-byte
+ *   reference copies.
+ *
+ ****************************************************************************/
+
+static int string_copytests(void)
+{
+  FAR unsigned char *src;
+  FAR unsigned char *dest;
+  int srcoff;
+  int destoff;
+  int size;
+  int nerrors = 0;
+  int i;
+
+  for (srcoff = 0; srcoff < STRING_MAXALIGN; srcoff++)
+    {
+      for (destoff = 0; destoff < STRING_MAXALIGN; destoff++)
+        {
+          for (size = 0; size < STRING_MAXSIZE; size++)
+            {
+              /* memcpy() between distinct buffers */
+
+              string_fill();
+              src  = &g_src[STRING_GUARD + srcoff];
+              dest = &g_dest[STRING_GUARD + destoff];
+
+              for (i = 0; i < size; i++)
+                {
+                  g_ref[STRING_GUARD + destoff + i] = src[i];
+                }
+
+              if (memcpy(dest, src, size) != dest)
+                {
+                  printf("  ERROR: memcpy returned the wrong pointer\n");
+                  nerrors++;
+                }
+
+              nerrors += string_check("memcpy", srcoff, destoff, size);
+
+              /* memmove() within one buffer, in both directions */
+
+              memcpy(g_dest, g_src, STRING_BUFSIZE);
+              memcpy(g_ref, g_src, STRING_BUFSIZE);
+              src  = &g_dest[STRING_GUARD + srcoff];
+              dest = &g_dest[STRING_GUARD + destoff];
+
+              if (dest <= src)
+                {
+                  for (i = 0; i < size; i++)
+                    {
+                      g_ref[STRING_GUARD + destoff + i] =
+                        g_ref[STRING_GUARD + srcoff + i];
+                    }
+                }
+              else
+                {
+                  for (i = size - 1; i >= 0; i--)
+                    {
+                      g_ref[STRING_GUARD + destoff + i] =
+                        g_ref[STRING_GUARD + srcoff + i];
+                    }
+                }
+
+              if (memmove(dest, src, size) != dest)
+                {
+                  printf("  ERROR: memmove returned the wrong pointer\n");
+                  nerrors++;
+                }
+
+              nerrors += string_check("memmove", srcoff, destoff, size);
+
+              /* strncpy() of a string of 'size' characters into a buffer
+               * one larger, so that the terminator is copied too.
+               */
+
+              string_fill();
+              src  = &g_src[STRING_GUARD + srcoff];
+              dest = &g_dest[STRING_GUARD + destoff];
+              src[size] = '\0';
+
+              for (i = 0; i <= size; i++)
+                {
+                  g_ref[STRING_GUARD + destoff + i] = src[i];
+                }
+
+              (void)strncpy((FAR char *)dest, (FAR const char *)src, size + 1);
+              nerrors += string_check("strncpy", srcoff, destoff, size);
+
+              /* And into a buffer that is too small for the terminator */
+
+              if (size > 0)
+                {
+                  g_ref[STRING_GUARD + destoff + size] = STRING_FILL;
+                  g_dest[STRING_GUARD + destoff + size] = STRING_FILL;
+
+                  (void)strncpy((FAR char *)dest, (FAR const char *)src, size);
+                  nerrors += string_check("strncpy", srcoff, destoff, size);
+                }
+
+              if (nerrors > 10)
+                {
+                  return nerrors;
+                }
+            }
+        }
+    }
+
+  return nerrors;
+}
+
+/****************************************************************************
+ * Name: string_searchtests
+ *
+ * Description:
+ *   Verify memcmp(), memchr(), strlen(), strcmp() and strchr() for every
+ *   alignment and size and for every position of the byte of interest.
+ *
+ ****************************************************************************/
+
+static int string_searchtests(void)
+{
+  FAR unsigned char *s1;
+  FAR unsigned char *s2;
+  FAR void *result;
+  int off1;
+  int off2;
+  int size;
+  int pos;
+  int nerrors = 0;
+
+  for (off1 = 0; off1 < STRING_MAXALIGN; off1++)
+    {
+      for (size = 0; size < STRING_MAXSIZE; size++)
+        {
+          string_fill();
+          s1 = &g_src[STRING_GUARD + off1];
+          s1[size] = '\0';
+
+          /* strlen() */
+
+          if (strlen((FAR const char *)s1) != size)
+            {
+              printf("  ERROR: strlen +%d size %d returned %lu\n",
+                     off1, size, (unsigned long)strlen((FAR const char *)s1));
+              nerrors++;
+            }
+
+          /* memchr() and strchr() for a byte at each position.  The byte
+           * is made unique so that the first match is known.
+           */
+
+          for (pos = 0; pos < size; pos++)
+            {
+              unsigned char save = s1[pos];
+              int i;
+
+              for (i = 0; i < size; i++)
+                {
+                  if (s1[i] == 0x80)
+                    {
+                      s1[i] = 0x81;
+                    }
+                }
+
+              s1[pos] = 0x80;
+
+              result = memchr(s1, 0x80, size);
+              if (result != &s1[pos])
+                {
+                  printf("  ERROR: memchr +%d size %d pos %d\n",
+                         off1, size, pos);
+                  nerrors++;
+                }
+
+              result = memchr(s1, 0x80, pos);
+              if (result != NULL)
+                {
+                  printf("  ERROR: memchr +%d size %d found beyond end\n",
+                         off1, pos);
+                  nerrors++;
+                }
+
+              result = strchr((FAR const char *)s1, 0x80);
+              if (result != &s1[pos])
+                {
+                  printf("  ERROR: strchr +%d size %d pos %d\n",
+                         off1, size, pos);
+                  nerrors++;
+                }
+
+              s1[pos] = save;
+            }
+
+          if (strchr((FAR const char *)s1, '\0') != (FAR char *)&s1[size])
+            {
+              printf("  ERROR: strchr +%d size %d terminator\n", off1, size);
+              nerrors++;
+            }
+
+          /* memcmp() and strcmp() against a copy at every other alignment,
+           * with and without a difference at each position.
+           */
+
+          for (off2 = 0; off2 < STRING_MAXALIGN; off2++)
+            {
+              s2 = &g_dest[STRING_GUARD + off2];
+              memcpy(s2, s1, size + 1);
+
+              if (memcmp(s1, s2, size) != 0 ||
+                  strcmp((FAR const char *)s1, (FAR const char *)s2) != 0)
+                {
+                  printf("  ERROR: memcmp/strcmp +%d +%d size %d equal\n",
+                         off1, off2, size);
+                  nerrors++;
+                }
+
+              for (pos = 0; pos < size; pos++)
+                {
+                  unsigned char save = s2[pos];
+                  int expected;
+
+                  s2[pos] = (unsigned char)(save + 0x80);
+                  if (s2[pos] == '\0')
+                    {
+                      s2[pos] = 1;
+                    }
+
+                  expected = s1[pos] < s2[pos] ? -1 : 1;
+
+                  if (string_sign(memcmp(s1, s2, size)) != expected)
+                    {
+                      printf("  ERROR: memcmp +%d +%d size %d pos %d\n",
+                             off1, off2, size, pos);
+                      nerrors++;
+                    }
+
+                  if (string_sign(strcmp((FAR const char *)s1,
+                                         (FAR const char *)s2)) != expected)
+                    {
+                      printf("  ERROR: strcmp +%d +%d size %d pos %d\n",
+                             off1, off2, size, pos);
+                      nerrors++;
+                    }
+
+                  s2[pos] = save;
+                }
+
+              if (nerrors > 10)
+                {
+                  return nerrors;
+                }
+            }
+        }
+    }
+
+  return nerrors;
+}
+
+/****************************************************************************
+ * Name: string_throughput
+ *
+ * Description:
+ *   Measure the throughput of each function over THROUGHPUT_NBYTES with an
+ *   aligned and with a misaligned source.
+ *
+ ****************************************************************************/
+
+static void string_throughput(void)
+{
+  static const int offsets[2] = { 0, 1 };
+  static const char *const names[2][7] =
+  {
+    {
+      "memcpy", "memmove", "memcmp", "memchr", "strlen", "strcmp", "strchr"
+    },
+    {
+      "memcpy+1", "memmove+1", "memcmp+1", "memchr+1", "strlen+1",
+      "strcmp+1", "strchr+1"
+    }
+  };
+
+  unsigned long nbytes = (unsigned long)THROUGHPUT_NBYTES * THROUGHPUT_NLOOPS;
+  unsigned long start;
+  FAR char *src;
+  int sink = 0;
+  int fn;
+  int i;
+  int j;
+
+  memset(g_tpsrc, 'x', sizeof(g_tpsrc));
+  memset(g_tpdest, 'x', sizeof(g_tpdest));
+
+  for (i = 0; i < 2; i++)
+    {
+      src = &g_tpsrc[offsets[i]];
+      src[THROUGHPUT_NBYTES - 1] = '\0';
+      g_tpdest[THROUGHPUT_NBYTES - 1] = '\0';
+
+      for (fn = 0; fn < 7; fn++)
+        {
+          start = libctest_msec();
+          for (j = 0; j < THROUGHPUT_NLOOPS; j++)
+            {
+              switch (fn)
+                {
+                  case 0:
+                    memcpy(g_tpdest, src, THROUGHPUT_NBYTES);
+                    break;
+
+                  case 1:
+                    memmove(g_tpdest, src, THROUGHPUT_NBYTES);
+                    break;
+
+                  case 2:
+                    sink += memcmp(g_tpdest, src, THROUGHPUT_NBYTES);
+                    break;
+
+                  case 3:
+                    sink += memchr(src, 'y', THROUGHPUT_NBYTES) != NULL;
+                    break;
+
+                  case 4:
+                    sink += strlen(src);
+                    break;
+
+                  case 5:
+                    sink += strcmp(g_tpdest, src);
+                    break;
+
+                  case 6:
+                    sink += strchr(src, 'y') != NULL;
+                    break;
+                }
+            }
+
+          libctest_report(names[i][fn], nbytes, libctest_msec() - start);
+        }
+
+      src[THROUGHPUT_NBYTES - 1] = 'x';
+    }
+
+  /* Keep the compiler from discarding the calls */
+
+  if (sink == 0x7fffffff)
+    {
+      printf("\n");
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: string_test
+ ****************************************************************************/
+
+int string_test(void)
+{
+  int nerrors;
+
+  printf("string_test: Copy functions\n");
+  nerrors = string_copytests();
+
+  printf("string_test: Search and compare functions\n");
+  nerrors += string_searchtests();
+
+  printf("string_test: Throughput (%d bytes x %d)\n",
+         THROUGHPUT_NBYTES, THROUGHPUT_NLOOPS);
+  string_throughput();
+
+  return nerrors;
+}
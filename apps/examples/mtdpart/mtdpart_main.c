@@ -39,6 +39,8 @@
 
 #include <nuttx/config.h>
 
+#include <sys/mount.h>
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
@@ -155,7 +157,7 @@ int mtdpart_main(int argc, char *argv[])
 #endif
 {
   FAR struct mtd_dev_s *master;
-  FAR struct mtd_dev_s *part[CONFIG_EXAMPLES_MTDPART_NPARTITIONS];
+  FAR struct mtd_dev_s *part[CONFIG_EXAMPLES_MTDPART_NPARTITIONS + 1];
   FAR struct mtd_geometry_s geo;
   FAR uint32_t *buffer;
   char blockname[32];
@@ -560,6 +562,71 @@ int mtdpart_main(int argc, char *argv[])
 
   close(fd);
 
+  /* If the FLASH is memory mapped, then verify that each partition can be
+   * accessed in place (XIP) through both the MTD partition and the FTL
+   * block driver on top of it.
+   */
+
+  message("Checking XIP access:\n");
+
+  for (offset = 0, i = 1;
+       i <= CONFIG_EXAMPLES_MTDPART_NPARTITIONS;
+       offset += partsize, i++)
+    {
+      FAR struct inode *inode;
+      FAR uint32_t *xipbase;
+      FAR void *blkbase;
+
+      ret = part[i]->ioctl(part[i], MTDIOC_XIPBASE,
+                           (unsigned long)((uintptr_t)&xipbase));
+      if (ret < 0)
+        {
+          message("  Partition %d. XIP not supported: %d\n", i, ret);
+          continue;
+        }
+
+      message("  Partition %d. XIP base=%p\n", i, xipbase);
+
+      /* The block driver must report the same base address */
+
+      snprintf(blockname, 32, "/dev/mtdblock%d", i);
+      ret = open_blockdriver(blockname, MS_RDONLY, &inode);
+      if (ret < 0)
+        {
+          message("ERROR: open_blockdriver %s failed: %d\n", blockname, ret);
+          msgflush();
+          exit(28);
+        }
+
+      ret = inode->u.i_bops->ioctl(inode, BIOC_XIPBASE,
+                                   (unsigned long)((uintptr_t)&blkbase));
+      (void)close_blockdriver(inode);
+
+      if (ret < 0 || blkbase != (FAR void *)xipbase)
+        {
+          message("ERROR: BIOC_XIPBASE on %s failed: %d (%p)\n",
+                  blockname, ret, blkbase);
+          msgflush();
+          exit(29);
+        }
+
+      /* Verify the values seen directly in memory */
+
+      check = offset;
+      for (k = 0; k < partsize / sizeof(uint32_t); k++)
+        {
+          if (xipbase[k] != ~check)
+            {
+              message("ERROR: Bad XIP value %lu, expected %lu\n",
+                      (long)xipbase[k], (long)(~check));
+              msgflush();
+              exit(30);
+            }
+
+          check += sizeof(uint32_t);
+        }
+    }
+
   /* And exit without bothering to clean up */
 
   message("PASS: Everything looks good\n");
@@ -135,6 +135,10 @@ static inline void nxeg_fillwindow(NXEGWINDOW hwnd,
 {
   int ret;
 
+  /* Send the fill and the text to the server as one batch */
+
+  (void)nx_batchbegin(g_hnx);
+
 #ifdef CONFIG_EXAMPLES_NX_RAWWINDOWS
   ret = nx_fill(hwnd, rect, st->color);
   if (ret < 0)
@@ -151,6 +155,8 @@ static inline void nxeg_fillwindow(NXEGWINDOW hwnd,
 #ifdef CONFIG_NX_KBD
   nxeg_filltext(hwnd, rect, st);
 #endif
+
+  (void)nx_batchend(g_hnx);
 }
 
 /****************************************************************************
@@ -889,6 +889,21 @@ errout_with_hwnd1:
 
 errout_with_nx:
 #ifdef CONFIG_NX_MULTIUSER
+#ifdef CONFIG_NX_BATCH
+  /* Show how many messages were needed to send the drawing commands */
+
+  {
+    struct nx_batchstats_s stats;
+
+    if (nx_batchstats(g_hnx, &stats) == OK)
+      {
+        message("nx_main: %lu messages, %lu batched commands in %lu batches\n",
+                (unsigned long)stats.nmsgs, (unsigned long)stats.ncmds,
+                (unsigned long)stats.nbatches);
+      }
+  }
+
+#endif
   /* Disconnect from the server */
 
   message("nx_main: Disconnect from the server\n");
@@ -0,0 +1,495 @@
+/****************************************************************************
+ * examples/nxglbench/nxglbench_main.c
+ *
+ *   Copyright (C) 2014 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+
+#include <nuttx/video/fb.h>
+#include <nuttx/nx/nxglib.h>
+#include <nuttx/nx/nxfonts.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Configuration ************************************************************/
+
+#ifndef CONFIG_EXAMPLES_NXGLBENCH_WIDTH
+#  define CONFIG_EXAMPLES_NXGLBENCH_WIDTH 320
+#endif
+
+#ifndef CONFIG_EXAMPLES_NXGLBENCH_HEIGHT
+#  define CONFIG_EXAMPLES_NXGLBENCH_HEIGHT 240
+#endif
+
+#ifndef CONFIG_EXAMPLES_NXGLBENCH_NLOOPS
+#  define CONFIG_EXAMPLES_NXGLBENCH_NLOOPS 50
+#endif
+
+#define NXGLBENCH_WIDTH  CONFIG_EXAMPLES_NXGLBENCH_WIDTH
+#define NXGLBENCH_HEIGHT CONFIG_EXAMPLES_NXGLBENCH_HEIGHT
+#define NXGLBENCH_NLOOPS CONFIG_EXAMPLES_NXGLBENCH_NLOOPS
+
+/* The distance that rectangles are moved in the move test */
+
+#define NXGLBENCH_MOVE   8
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The pixel depths to benchmark */
+
+static const uint8_t g_bpp[] =
+{
+#ifndef CONFIG_NX_DISABLE_8BPP
+  8,
+#endif
+#ifndef CONFIG_NX_DISABLE_16BPP
+  16,
+#endif
+#ifndef CONFIG_NX_DISABLE_24BPP
+  24,
+#endif
+#ifndef CONFIG_NX_DISABLE_32BPP
+  32,
+#endif
+  0
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxglbench_msec
+ *
+ * Description:
+ *   Return the current time in milliseconds
+ *
+ ****************************************************************************/
+
+static unsigned long nxglbench_msec(void)
+{
+  struct timespec ts;
+
+  (void)clock_gettime(CLOCK_REALTIME, &ts);
+  return (unsigned long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/****************************************************************************
+ * Name: nxglbench_report
+ *
+ * Description:
+ *   Show the throughput of one test
+ *
+ ****************************************************************************/
+
+static void nxglbench_report(FAR const char *name, int bpp,
+                             unsigned long count, FAR const char *units,
+                             unsigned long start)
+{
+  unsigned long elapsed = nxglbench_msec() - start;
+
+  if (elapsed == 0)
+    {
+      elapsed = 1;
+    }
+
+  /* count / msec is thousands of units per second */
+
+  printf("%2dbpp %-8s %8lu ms %10lu K%s/sec\n",
+         bpp, name, elapsed, count / elapsed, units);
+}
+
+/****************************************************************************
+ * Name: nxglbench_fill
+ ****************************************************************************/
+
+static void nxglbench_fill(FAR struct fb_planeinfo_s *pinfo,
+                           FAR const struct nxgl_rect_s *rect,
+                           nxgl_mxpixel_t color)
+{
+  switch (pinfo->bpp)
+    {
+      case 8:
+        nxgl_fillrectangle_8bpp(pinfo, rect, (uint8_t)color);
+        break;
+
+      case 16:
+        nxgl_fillrectangle_16bpp(pinfo, rect, (uint16_t)color);
+        break;
+
+      case 24:
+        nxgl_fillrectangle_24bpp(pinfo, rect, (uint32_t)color);
+        break;
+
+      case 32:
+        nxgl_fillrectangle_32bpp(pinfo, rect, (uint32_t)color);
+        break;
+    }
+}
+
+/****************************************************************************
+ * Name: nxglbench_move
+ ****************************************************************************/
+
+static void nxglbench_move(FAR struct fb_planeinfo_s *pinfo,
+                           FAR const struct nxgl_rect_s *rect,
+                           FAR struct nxgl_point_s *offset)
+{
+  switch (pinfo->bpp)
+    {
+      case 8:
+        nxgl_moverectangle_8bpp(pinfo, rect, offset);
+        break;
+
+      case 16:
+        nxgl_moverectangle_16bpp(pinfo, rect, offset);
+        break;
+
+      case 24:
+        nxgl_moverectangle_24bpp(pinfo, rect, offset);
+        break;
+
+      case 32:
+        nxgl_moverectangle_32bpp(pinfo, rect, offset);
+        break;
+    }
+}
+
+/****************************************************************************
+ * Name: nxglbench_copy
+ ****************************************************************************/
+
+static void nxglbench_copy(FAR struct fb_planeinfo_s *pinfo,
+                           FAR const struct nxgl_rect_s *dest,
+                           FAR const void *src,
+                           FAR const struct nxgl_point_s *origin,
+                           unsigned int srcstride)
+{
+  switch (pinfo->bpp)
+    {
+      case 8:
+        nxgl_copyrectangle_8bpp(pinfo, dest, src, origin, srcstride);
+        break;
+
+      case 16:
+        nxgl_copyrectangle_16bpp(pinfo, dest, src, origin, srcstride);
+        break;
+
+      case 24:
+        nxgl_copyrectangle_24bpp(pinfo, dest, src, origin, srcstride);
+        break;
+
+      case 32:
+        nxgl_copyrectangle_32bpp(pinfo, dest, src, origin, srcstride);
+        break;
+    }
+}
+
+/****************************************************************************
+ * Name: nxglbench_convert
+ ****************************************************************************/
+
+static void nxglbench_convert(int bpp, FAR void *dest, uint16_t height,
+                              uint16_t width, uint16_t stride,
+                              FAR const struct nx_fontbitmap_s *bm,
+                              nxgl_mxpixel_t color)
+{
+  switch (bpp)
+    {
+      case 8:
+        (void)nxf_convert_8bpp((FAR uint8_t *)dest, height, width, stride,
+                               bm, color);
+        break;
+
+      case 16:
+        (void)nxf_convert_16bpp((FAR uint16_t *)dest, height, width,
+                                stride, bm, color);
+        break;
+
+      case 24:
+        (void)nxf_convert_24bpp((FAR uint32_t *)dest, height, width,
+                                stride, bm, color);
+        break;
+
+      case 32:
+        (void)nxf_convert_32bpp((FAR uint32_t *)dest, height, width,
+                                stride, bm, color);
+        break;
+    }
+}
+
+/****************************************************************************
+ * Name: nxglbench_glyphs
+ *
+ * Description:
+ *   Expand every printable glyph of the default font, NXGLBENCH_NLOOPS
+ *   times.
+ *
+ ****************************************************************************/
+
+static void nxglbench_glyphs(int bpp)
+{
+  FAR const struct nx_font_s *fontset;
+  FAR const struct nx_fontbitmap_s *bm;
+  FAR uint8_t *glyph;
+  unsigned long start;
+  unsigned long nglyphs;
+  NXHANDLE hfont;
+  unsigned int stride;
+  int loop;
+  int ch;
+
+  hfont = nxf_getfonthandle(FONTID_DEFAULT);
+  if (!hfont)
+    {
+      printf("nxglbench: Failed to get font handle: %d\n", errno);
+      return;
+    }
+
+  fontset = nxf_getfontset(hfont);
+  stride  = (fontset->mxwidth * bpp + 7) >> 3;
+
+  glyph = (FAR uint8_t *)malloc(stride * fontset->mxheight);
+  if (!glyph)
+    {
+      printf("nxglbench: Failed to allocate the glyph buffer\n");
+      return;
+    }
+
+  nglyphs = 0;
+  start   = nxglbench_msec();
+
+  for (loop = 0; loop < NXGLBENCH_NLOOPS; loop++)
+    {
+      for (ch = ' '; ch <= '~'; ch++)
+        {
+          bm = nxf_getbitmap(hfont, ch);
+          if (bm)
+            {
+              nxglbench_convert(bpp, glyph, fontset->mxheight,
+                                fontset->mxwidth, stride, bm, 0xff);
+              nglyphs++;
+            }
+        }
+    }
+
+  nxglbench_report("glyph", bpp, nglyphs, "glyphs", start);
+  free(glyph);
+}
+
+/****************************************************************************
+ * Name: nxglbench_run
+ *
+ * Description:
+ *   Run all of the raster tests at one pixel depth
+ *
+ ****************************************************************************/
+
+static int nxglbench_run(int bpp)
+{
+  struct fb_planeinfo_s pinfo;
+  struct nxgl_rect_s rect;
+  struct nxgl_point_s pos;
+  FAR uint8_t *image;
+  unsigned long start;
+  unsigned long npixels;
+  int loop;
+
+  /* Allocate a memory-resident framebuffer and an image of the same size
+   * to copy from.
+   */
+
+  pinfo.stride = (NXGLBENCH_WIDTH * bpp + 7) >> 3;
+  pinfo.fblen  = pinfo.stride * NXGLBENCH_HEIGHT;
+  pinfo.bpp    = bpp;
+  pinfo.fbmem  = malloc(pinfo.fblen);
+  image        = (FAR uint8_t *)malloc(pinfo.fblen);
+
+  if (!pinfo.fbmem || !image)
+    {
+      printf("nxglbench: Failed to allocate %lu bytes\n",
+             (unsigned long)pinfo.fblen * 2);
+      free(pinfo.fbmem);
+      free(image);
+      return -ENOMEM;
+    }
+
+  memset(image, 0x5a, pinfo.fblen);
+
+  /* Fill the whole framebuffer and a rectangle of odd width that starts
+   * at an odd pixel position.
+   */
+
+  rect.pt1.x = 0;
+  rect.pt1.y = 0;
+  rect.pt2.x = NXGLBENCH_WIDTH - 1;
+  rect.pt2.y = NXGLBENCH_HEIGHT - 1;
+
+  npixels = 0;
+  start   = nxglbench_msec();
+
+  for (loop = 0; loop < NXGLBENCH_NLOOPS; loop++)
+    {
+      nxglbench_fill(&pinfo, &rect, loop);
+      npixels += NXGLBENCH_WIDTH * NXGLBENCH_HEIGHT;
+    }
+
+  nxglbench_report("fill", bpp, npixels, "pixels", start);
+
+  rect.pt1.x = 1;
+  rect.pt2.x = NXGLBENCH_WIDTH - 3;
+
+  npixels = 0;
+  start   = nxglbench_msec();
+
+  for (loop = 0; loop < NXGLBENCH_NLOOPS; loop++)
+    {
+      nxglbench_fill(&pinfo, &rect, loop);
+      npixels += (NXGLBENCH_WIDTH - 3) * NXGLBENCH_HEIGHT;
+    }
+
+  nxglbench_report("fillodd", bpp, npixels, "pixels", start);
+
+  /* Move a rectangle down and right, then back again.  This exercises
+   * both the top-down and the bottom-up copy.
+   */
+
+  npixels = 0;
+  start   = nxglbench_msec();
+
+  for (loop = 0; loop < NXGLBENCH_NLOOPS; loop++)
+    {
+      rect.pt1.x = 0;
+      rect.pt1.y = 0;
+      rect.pt2.x = NXGLBENCH_WIDTH - NXGLBENCH_MOVE - 1;
+      rect.pt2.y = NXGLBENCH_HEIGHT - NXGLBENCH_MOVE - 1;
+      pos.x      = NXGLBENCH_MOVE;
+      pos.y      = NXGLBENCH_MOVE;
+      nxglbench_move(&pinfo, &rect, &pos);
+
+      rect.pt1.x = NXGLBENCH_MOVE;
+      rect.pt1.y = NXGLBENCH_MOVE;
+      rect.pt2.x = NXGLBENCH_WIDTH - 1;
+      rect.pt2.y = NXGLBENCH_HEIGHT - 1;
+      pos.x      = 0;
+      pos.y      = 0;
+      nxglbench_move(&pinfo, &rect, &pos);
+
+      npixels += 2 * (NXGLBENCH_WIDTH - NXGLBENCH_MOVE) *
+                 (NXGLBENCH_HEIGHT - NXGLBENCH_MOVE);
+    }
+
+  nxglbench_report("move", bpp, npixels, "pixels", start);
+
+  /* Copy the whole image into the framebuffer */
+
+  rect.pt1.x = 0;
+  rect.pt1.y = 0;
+  rect.pt2.x = NXGLBENCH_WIDTH - 1;
+  rect.pt2.y = NXGLBENCH_HEIGHT - 1;
+  pos.x      = 0;
+  pos.y      = 0;
+
+  npixels = 0;
+  start   = nxglbench_msec();
+
+  for (loop = 0; loop < NXGLBENCH_NLOOPS; loop++)
+    {
+      nxglbench_copy(&pinfo, &rect, image, &pos, pinfo.stride);
+      npixels += NXGLBENCH_WIDTH * NXGLBENCH_HEIGHT;
+    }
+
+  nxglbench_report("copy", bpp, npixels, "pixels", start);
+
+  free(pinfo.fbmem);
+  free(image);
+
+  /* And expand font glyphs */
+
+  nxglbench_glyphs(bpp);
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxglbench_main
+ ****************************************************************************/
+
+#ifdef CONFIG_BUILD_KERNEL
+int main(int argc, FAR char *argv[])
+#else
+int nxglbench_main(int argc, char *argv[])
+#endif
+{
+  int ret;
+  int i;
+
+  printf("nxglbench: %dx%d, %d loops, word-wide raster %s\n",
+         NXGLBENCH_WIDTH, NXGLBENCH_HEIGHT, NXGLBENCH_NLOOPS,
+#ifdef CONFIG_NX_WORDRASTER
+         "enabled"
+#else
+         "disabled"
+#endif
+         );
+
+  for (i = 0; g_bpp[i] != 0; i++)
+    {
+      ret = nxglbench_run(g_bpp[i]);
+      if (ret < 0)
+        {
+          return EXIT_FAILURE;
+        }
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,275 @@
+/****************************************************************************
+ * examples/pipe/throughput_test.c
+ *
+ *   Copyright (C) 2014 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <time.h>
+#include <errno.h>
+
+#include "pipe.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_EXAMPLES_PIPE_NBYTES
+#  define CONFIG_EXAMPLES_PIPE_NBYTES 65536
+#endif
+
+#define THROUGHPUT_NBYTES  CONFIG_EXAMPLES_PIPE_NBYTES
+#define THROUGHPUT_MAXIO   1024
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct throughput_s
+{
+  int fd;        /* The read end of the pipe */
+  int iosize;    /* The size of each read */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The sizes of the individual read and write transfers */
+
+static const int g_iosizes[] =
+{
+  1, 16, 128, THROUGHPUT_MAXIO
+};
+
+#define NIOSIZES (sizeof(g_iosizes) / sizeof(g_iosizes[0]))
+
+/* The pipe buffer sizes to test.  Zero means to keep the default size */
+
+static const int g_pipesizes[] =
+{
+  0, 4096
+};
+
+#define NPIPESIZES (sizeof(g_pipesizes) / sizeof(g_pipesizes[0]))
+
+static char g_wrbuffer[THROUGHPUT_MAXIO];
+static char g_rdbuffer[THROUGHPUT_MAXIO];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: throughput_msec
+ ****************************************************************************/
+
+static unsigned long throughput_msec(void)
+{
+  struct timespec ts;
+
+  (void)clock_gettime(CLOCK_REALTIME, &ts);
+  return (unsigned long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/****************************************************************************
+ * Name: throughput_reader
+ ****************************************************************************/
+
+static void *throughput_reader(pthread_addr_t pvarg)
+{
+  FAR struct throughput_s *parms = (FAR struct throughput_s *)pvarg;
+  int nbytes;
+  int ret;
+
+  for (nbytes = 0; nbytes < THROUGHPUT_NBYTES; nbytes += ret)
+    {
+      ret = read(parms->fd, g_rdbuffer, parms->iosize);
+      if (ret < 0)
+        {
+          fprintf(stderr, "throughput_reader: read failed, errno=%d\n", errno);
+          return (void*)1;
+        }
+      else if (ret == 0)
+        {
+          fprintf(stderr, "throughput_reader: Too few bytes read: %d\n", nbytes);
+          return (void*)2;
+        }
+    }
+
+  return (void*)0;
+}
+
+/****************************************************************************
+ * Name: throughput_run
+ *
+ * Description:
+ *   Transfer THROUGHPUT_NBYTES through a new pipe using reads and writes of
+ *   iosize bytes and report the throughput.
+ *
+ ****************************************************************************/
+
+static int throughput_run(int pipesize, int iosize)
+{
+  struct throughput_s parms;
+  pthread_t readerid;
+  unsigned long start;
+  unsigned long elapsed;
+  void *value;
+  int fd[2];
+  int nbytes;
+  int ret;
+
+  ret = pipe(fd);
+  if (ret < 0)
+    {
+      fprintf(stderr, "throughput_run: pipe failed, errno=%d\n", errno);
+      return 1;
+    }
+
+  if (pipesize > 0)
+    {
+      ret = fcntl(fd[1], F_SETPIPE_SZ, pipesize);
+      if (ret < 0)
+        {
+          fprintf(stderr, "throughput_run: F_SETPIPE_SZ failed, errno=%d\n",
+                  errno);
+          ret = 2;
+          goto errout_with_pipe;
+        }
+    }
+
+  pipesize = fcntl(fd[1], F_GETPIPE_SZ);
+  if (pipesize < 0)
+    {
+      fprintf(stderr, "throughput_run: F_GETPIPE_SZ failed, errno=%d\n",
+              errno);
+      ret = 3;
+      goto errout_with_pipe;
+    }
+
+  /* Start the reader thread and then write the data */
+
+  parms.fd     = fd[0];
+  parms.iosize = iosize;
+
+  start = throughput_msec();
+  ret = pthread_create(&readerid, NULL, throughput_reader, (pthread_addr_t)&parms);
+  if (ret != 0)
+    {
+      fprintf(stderr, "throughput_run: pthread_create failed, error=%d\n", ret);
+      ret = 4;
+      goto errout_with_pipe;
+    }
+
+  for (nbytes = 0; nbytes < THROUGHPUT_NBYTES; nbytes += ret)
+    {
+      ret = write(fd[1], g_wrbuffer, iosize);
+      if (ret <= 0)
+        {
+          fprintf(stderr, "throughput_run: write failed, errno=%d\n", errno);
+          break;
+        }
+    }
+
+  /* Wait for the reader to receive everything */
+
+  ret = pthread_join(readerid, &value);
+  if (ret != 0)
+    {
+      fprintf(stderr, "throughput_run: pthread_join failed, error=%d\n", ret);
+      ret = 5;
+      goto errout_with_pipe;
+    }
+
+  ret = (int)value;
+  if (ret == 0)
+    {
+      elapsed = throughput_msec() - start;
+      if (elapsed == 0)
+        {
+          elapsed = 1;
+        }
+
+      /* bytes / msec is KB/second */
+
+      printf("throughput_test: pipe %5d bytes, I/O %4d bytes: %5lu msec %6lu KB/s\n",
+             pipesize, iosize, elapsed, (unsigned long)THROUGHPUT_NBYTES / elapsed);
+    }
+
+errout_with_pipe:
+  close(fd[0]);
+  close(fd[1]);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: throughput_test
+ ****************************************************************************/
+
+int throughput_test(void)
+{
+  int i;
+  int j;
+  int ret;
+
+  memset(g_wrbuffer, 0x5a, THROUGHPUT_MAXIO);
+
+  for (i = 0; i < NPIPESIZES; i++)
+    {
+      for (j = 0; j < NIOSIZES; j++)
+        {
+          ret = throughput_run(g_pipesizes[i], g_iosizes[j]);
+          if (ret != 0)
+            {
+              return ret;
+            }
+        }
+    }
+
+  return 0;
+}
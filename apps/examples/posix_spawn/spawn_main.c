@@ -41,12 +41,14 @@
 #include <nuttx/compiler.h>
 
 #include <sys/mount.h>
+#include <sys/wait.h>
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
 #include <string.h>
 #include <fcntl.h>
+#include <time.h>
 #include <spawn.h>
 #include <debug.h>
 #include <errno.h>
@@ -103,6 +105,10 @@
 #  define CONFIG_EXAMPLES_ELF_DEVPATH "/dev/ram0"
 #endif
 
+#ifndef CONFIG_EXAMPLES_POSIXSPAWN_NLAUNCH
+#  define CONFIG_EXAMPLES_POSIXSPAWN_NLAUNCH 0
+#endif
+
 /* If CONFIG_DEBUG is enabled, use dbg instead of printf so that the
  * output will be synchronous with the debug output.
  */
@@ -214,6 +220,88 @@ static inline void testheader(FAR const char *progname)
   message("\n%s\n* Executing %s\n%s\n\n", delimiter, progname, delimiter);
 }
 
+/****************************************************************************
+ * Name: spawn_latency
+ *
+ * Description:
+ *   Spawn the same program CONFIG_EXAMPLES_POSIXSPAWN_NLAUNCH times and
+ *   report how long posix_spawn() takes to load and start it.  The first
+ *   launch always loads the program from the file system; later launches
+ *   show the benefit of the ELF module cache (CONFIG_ELF_MODCACHE), if
+ *   enabled.
+ *
+ ****************************************************************************/
+
+#if CONFIG_EXAMPLES_POSIXSPAWN_NLAUNCH > 0
+static void spawn_latency(FAR const char *filepath)
+{
+  struct timespec start;
+  struct timespec end;
+  unsigned long elapsed;
+  unsigned long first = 0;
+  unsigned long total = 0;
+  unsigned long minimum = ~0ul;
+  unsigned long maximum = 0;
+  pid_t pid;
+  int ret;
+  int i;
+
+  for (i = 0; i < CONFIG_EXAMPLES_POSIXSPAWN_NLAUNCH; i++)
+    {
+      (void)clock_gettime(CLOCK_REALTIME, &start);
+      ret = posix_spawn(&pid, filepath, NULL, NULL, NULL, NULL);
+      (void)clock_gettime(CLOCK_REALTIME, &end);
+
+      if (ret != 0)
+        {
+          err("ERROR: posix_spawn failed: %d\n", ret);
+          return;
+        }
+
+      elapsed = (end.tv_sec - start.tv_sec) * 1000000 +
+                (end.tv_nsec - start.tv_nsec) / 1000;
+
+      if (i == 0)
+        {
+          first = elapsed;
+        }
+      else
+        {
+          total += elapsed;
+          if (elapsed < minimum)
+            {
+              minimum = elapsed;
+            }
+
+          if (elapsed > maximum)
+            {
+              maximum = elapsed;
+            }
+        }
+
+      /* Wait for the program to exit and be unloaded before the next
+       * launch.
+       */
+
+#ifdef CONFIG_SCHED_WAITPID
+      (void)waitpid(pid, NULL, 0);
+      usleep(100*1000);
+#else
+      sleep(1);
+#endif
+    }
+
+  message("\nposix_spawn latency for %s:\n", filepath);
+  message("  First launch:   %lu usec\n", first);
+  if (CONFIG_EXAMPLES_POSIXSPAWN_NLAUNCH > 1)
+    {
+      message("  Next %d:        min %lu avg %lu max %lu usec\n",
+              CONFIG_EXAMPLES_POSIXSPAWN_NLAUNCH - 1, minimum,
+              total / (CONFIG_EXAMPLES_POSIXSPAWN_NLAUNCH - 1), maximum);
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -455,6 +543,24 @@ int spawn_main(int argc, char *argv[])
 
   mm_update(&g_mmstep, "after file_action/attr destruction");
 
+#if CONFIG_EXAMPLES_POSIXSPAWN_NLAUNCH > 0
+  /*************************************************************************
+   * Case 3: Spawn latency
+   *************************************************************************/
+
+  testheader("spawn latency");
+
+#ifdef CONFIG_BINFMT_EXEPATH
+  filepath = g_hello;
+#else
+  snprintf(fullpath, 128, "%s/%s", MOUNTPT, g_hello);
+  filepath = fullpath;
+#endif
+
+  spawn_latency(filepath);
+  mm_update(&g_mmstep, "after spawn latency test");
+#endif
+
   /* Clean-up */
 
   elf_uninitialize();
@@ -0,0 +1,491 @@
+/****************************************************************************
+ * examples/webserver/loadgen.c
+ * HTTP load generator.  This program is built for and runs on the host.
+ *
+ *   Copyright (C) 2014 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name Gregory Nutt nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <errno.h>
+
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define LOADGEN_BUFSIZE   8192
+#define LOADGEN_MAXDEPTH  16
+#define LOADGEN_MAXCONNS  64
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* State of one client connection (one thread) */
+
+struct loadgen_client_s
+{
+  pthread_t     thread;
+  unsigned long nok;          /* Successful responses (status 200) */
+  unsigned long nerrors;      /* Failed requests */
+  unsigned long nconnects;    /* Number of TCP connections opened */
+  unsigned long maxusec;      /* Longest batch time */
+  double        totalusec;    /* Sum of all batch times */
+  int           sd;           /* Socket descriptor (or -1) */
+  int           buflen;       /* Bytes in buffer[] */
+  char          buffer[LOADGEN_BUFSIZE];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct sockaddr_in g_addr;          /* Server address */
+static const char *g_path = "/index.html"; /* Path to request */
+static int  g_nconns     = 4;              /* Number of connections */
+static int  g_nrequests  = 100;            /* Requests per connection */
+static int  g_depth      = 1;              /* Pipelined requests */
+static bool g_keepalive  = false;          /* Use persistent connections */
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static unsigned long loadgen_usec(void)
+{
+  struct timeval tv;
+
+  gettimeofday(&tv, NULL);
+  return (unsigned long)tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+static int loadgen_connect(struct loadgen_client_s *client)
+{
+  client->sd = socket(AF_INET, SOCK_STREAM, 0);
+  if (client->sd < 0)
+    {
+      return -1;
+    }
+
+  if (connect(client->sd, (struct sockaddr *)&g_addr, sizeof(g_addr)) < 0)
+    {
+      close(client->sd);
+      client->sd = -1;
+      return -1;
+    }
+
+  client->buflen = 0;
+  client->nconnects++;
+  return 0;
+}
+
+static void loadgen_disconnect(struct loadgen_client_s *client)
+{
+  if (client->sd >= 0)
+    {
+      close(client->sd);
+      client->sd = -1;
+    }
+}
+
+/* Receive more data into the client buffer.  Returns the number of bytes
+ * received, zero if the server closed the connection, or -1 on failure.
+ */
+
+static int loadgen_recv(struct loadgen_client_s *client)
+{
+  int ret;
+
+  if (client->buflen >= LOADGEN_BUFSIZE)
+    {
+      return -1;
+    }
+
+  ret = recv(client->sd, client->buffer + client->buflen,
+             LOADGEN_BUFSIZE - client->buflen, 0);
+  if (ret > 0)
+    {
+      client->buflen += ret;
+    }
+
+  return ret;
+}
+
+/* Return a pointer to the blank line that terminates the response header
+ * in the client buffer, or NULL if the header is not yet complete.
+ */
+
+static char *loadgen_hdrend(struct loadgen_client_s *client)
+{
+  int i;
+
+  for (i = 0; i + 3 < client->buflen; i++)
+    {
+      if (memcmp(&client->buffer[i], "\r\n\r\n", 4) == 0)
+        {
+          return &client->buffer[i];
+        }
+    }
+
+  return NULL;
+}
+
+/* Receive one response.  Returns the HTTP status or -1 on failure.
+ * *closed is set if the server will close the connection after this
+ * response.
+ */
+
+static int loadgen_response(struct loadgen_client_s *client, bool *closed)
+{
+  char *hdrend;
+  char *ptr;
+  long remaining;
+  int hdrlen;
+  int status;
+  long clen = -1;
+  int ret;
+
+  /* Receive the complete header */
+
+  while ((hdrend = loadgen_hdrend(client)) == NULL)
+    {
+      if (loadgen_recv(client) <= 0)
+        {
+          return -1;
+        }
+    }
+
+  *hdrend = '\0';
+  hdrlen  = hdrend - client->buffer + 4;
+
+  if (sscanf(client->buffer, "HTTP/%*d.%*d %d", &status) != 1)
+    {
+      return -1;
+    }
+
+  *closed = true;
+  for (ptr = strstr(client->buffer, "\r\n"); ptr; ptr = strstr(ptr, "\r\n"))
+    {
+      ptr += 2;
+      if (strncasecmp(ptr, "Content-Length:", 15) == 0)
+        {
+          clen = strtol(ptr + 15, NULL, 10);
+        }
+      else if (strncasecmp(ptr, "Connection:", 11) == 0)
+        {
+          *closed = (strstr(ptr + 11, "keep-alive") == NULL &&
+                     strstr(ptr + 11, "Keep-Alive") == NULL);
+        }
+    }
+
+  /* Discard the header and receive the body.  Without a Content-Length,
+   * the body ends when the connection is closed.
+   */
+
+  client->buflen -= hdrlen;
+  memmove(client->buffer, client->buffer + hdrlen, client->buflen);
+
+  if (clen < 0)
+    {
+      *closed = true;
+      while ((ret = loadgen_recv(client)) > 0)
+        {
+          client->buflen = 0;
+        }
+
+      client->buflen = 0;
+      return ret < 0 ? -1 : status;
+    }
+
+  remaining = clen;
+  for (;;)
+    {
+      if (client->buflen >= remaining)
+        {
+          client->buflen -= remaining;
+          memmove(client->buffer, client->buffer + remaining, client->buflen);
+          break;
+        }
+
+      remaining      -= client->buflen;
+      client->buflen  = 0;
+
+      if (loadgen_recv(client) <= 0)
+        {
+          return -1;
+        }
+    }
+
+  return status;
+}
+
+static void *loadgen_thread(void *arg)
+{
+  struct loadgen_client_s *client = (struct loadgen_client_s *)arg;
+  char request[LOADGEN_MAXDEPTH * 128];
+  unsigned long start;
+  unsigned long elapsed;
+  bool closed = false;
+  int reqlen;
+  int batch;
+  int done;
+  int len;
+  int ret;
+  int i;
+
+  client->sd = -1;
+
+  for (done = 0; done < g_nrequests; done += batch)
+    {
+      if (client->sd < 0 && loadgen_connect(client) < 0)
+        {
+          client->nerrors += g_nrequests - done;
+          break;
+        }
+
+      /* Send a batch of (possibly pipelined) requests */
+
+      batch = g_keepalive ? g_depth : 1;
+      if (batch > g_nrequests - done)
+        {
+          batch = g_nrequests - done;
+        }
+
+      for (reqlen = 0, i = 0; i < batch; i++)
+        {
+          reqlen += snprintf(request + reqlen, sizeof(request) - reqlen,
+                             "GET %s HTTP/1.1\r\n"
+                             "Host: loadgen\r\n"
+                             "Connection: %s\r\n"
+                             "\r\n",
+                             g_path, g_keepalive ? "keep-alive" : "close");
+        }
+
+      start = loadgen_usec();
+      for (i = 0; i < reqlen; i += len)
+        {
+          len = send(client->sd, request + i, reqlen - i, 0);
+          if (len <= 0)
+            {
+              break;
+            }
+        }
+
+      /* Receive the responses */
+
+      for (i = 0; i < batch && i < reqlen; i++)
+        {
+          ret = loadgen_response(client, &closed);
+          if (ret == 200)
+            {
+              client->nok++;
+            }
+          else
+            {
+              client->nerrors++;
+            }
+
+          if (ret < 0 || closed)
+            {
+              client->nerrors += batch - i - 1;
+              closed = true;
+              break;
+            }
+        }
+
+      elapsed = loadgen_usec() - start;
+      client->totalusec += elapsed;
+      if (elapsed > client->maxusec)
+        {
+          client->maxusec = elapsed;
+        }
+
+      if (!g_keepalive || closed)
+        {
+          loadgen_disconnect(client);
+        }
+    }
+
+  loadgen_disconnect(client);
+  return NULL;
+}
+
+static void show_usage(const char *progname)
+{
+  fprintf(stderr, "USAGE: %s [-c <conns>] [-n <requests>] [-k] [-p <depth>] "
+          "<ip-address> [<port> [<path>]]\n", progname);
+  fprintf(stderr, "  -c <conns>    Number of concurrent connections (default 4)\n");
+  fprintf(stderr, "  -n <requests> Requests per connection (default 100)\n");
+  fprintf(stderr, "  -k            Use persistent (keep-alive) connections\n");
+  fprintf(stderr, "  -p <depth>    Pipeline <depth> requests (with -k, default 1)\n");
+  exit(1);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int main(int argc, char **argv)
+{
+  struct loadgen_client_s *clients;
+  unsigned long start;
+  unsigned long elapsed;
+  unsigned long nok = 0;
+  unsigned long nerrors = 0;
+  unsigned long nconnects = 0;
+  unsigned long maxusec = 0;
+  double totalusec = 0;
+  int port = 80;
+  int option;
+  int i;
+
+  while ((option = getopt(argc, argv, "c:n:kp:")) != -1)
+    {
+      switch (option)
+        {
+          case 'c':
+            g_nconns = atoi(optarg);
+            break;
+
+          case 'n':
+            g_nrequests = atoi(optarg);
+            break;
+
+          case 'k':
+            g_keepalive = true;
+            break;
+
+          case 'p':
+            g_depth = atoi(optarg);
+            break;
+
+          default:
+            show_usage(argv[0]);
+        }
+    }
+
+  if (optind >= argc || g_nconns < 1 || g_nconns > LOADGEN_MAXCONNS ||
+      g_nrequests < 1 || g_depth < 1 || g_depth > LOADGEN_MAXDEPTH)
+    {
+      show_usage(argv[0]);
+    }
+
+  memset(&g_addr, 0, sizeof(g_addr));
+  g_addr.sin_family = AF_INET;
+  if (inet_aton(argv[optind], &g_addr.sin_addr) == 0)
+    {
+      show_usage(argv[0]);
+    }
+
+  if (optind + 1 < argc)
+    {
+      port = atoi(argv[optind + 1]);
+    }
+
+  if (optind + 2 < argc)
+    {
+      g_path = argv[optind + 2];
+    }
+
+  g_addr.sin_port = htons(port);
+
+  clients = (struct loadgen_client_s *)calloc(g_nconns, sizeof(struct loadgen_client_s));
+  if (!clients)
+    {
+      fprintf(stderr, "Out of memory\n");
+      return 1;
+    }
+
+  /* Start all of the clients and wait for them to finish */
+
+  start = loadgen_usec();
+  for (i = 0; i < g_nconns; i++)
+    {
+      if (pthread_create(&clients[i].thread, NULL, loadgen_thread, &clients[i]) != 0)
+        {
+          fprintf(stderr, "pthread_create failed\n");
+          return 1;
+        }
+    }
+
+  for (i = 0; i < g_nconns; i++)
+    {
+      pthread_join(clients[i].thread, NULL);
+
+      nok       += clients[i].nok;
+      nerrors   += clients[i].nerrors;
+      nconnects += clients[i].nconnects;
+      totalusec += clients[i].totalusec;
+      if (clients[i].maxusec > maxusec)
+        {
+          maxusec = clients[i].maxusec;
+        }
+    }
+
+  elapsed = loadgen_usec() - start;
+  if (elapsed == 0)
+    {
+      elapsed = 1;
+    }
+
+  printf("%d connections x %d requests, %s, pipeline depth %d\n",
+         g_nconns, g_nrequests, g_keepalive ? "keep-alive" : "close",
+         g_keepalive ? g_depth : 1);
+  printf("  OK: %lu  Errors: %lu  TCP connections: %lu\n",
+         nok, nerrors, nconnects);
+  printf("  Elapsed: %lu msec  Requests/sec: %lu\n",
+         elapsed / 1000, (unsigned long)((double)nok * 1000000 / elapsed));
+  printf("  Average batch time: %lu usec  Max: %lu usec\n",
+         (unsigned long)(totalusec / ((double)(nok + nerrors) /
+                          (g_keepalive ? g_depth : 1) + 1e-9)),
+         maxusec);
+
+  free(clients);
+  return nerrors == 0 ? 0 : 1;
+}
@@ -42,10 +42,40 @@ extern "C"
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Configuration ************************************************************/
+
+/* Size of the output buffer in each cJSON_Writer */
+
+#ifndef CONFIG_NETUTILS_JSON_WRITER_BUFSIZE
+#  define CONFIG_NETUTILS_JSON_WRITER_BUFSIZE 128
+#endif
+
+/* Longest string (including the NUL terminator) that the streaming parser
+ * can deliver in one event.  Object member names have the same limit.
+ */
+
+#ifndef CONFIG_NETUTILS_JSON_SAX_BUFSIZE
+#  define CONFIG_NETUTILS_JSON_SAX_BUFSIZE 128
+#endif
+
+/* Maximum nesting of arrays and objects in the streaming parser and in the
+ * cJSON_Write*() API.
+ */
+
+#define cJSON_MAXNESTING 32
+
+/* cJSON types **************************************************************/
+
 #define cJSON_False  0
 #define cJSON_True   1
 #define cJSON_NULL   2
@@ -56,10 +86,22 @@ extern "C"
 
 #define cJSON_IsReference 256
 
+/* Streaming parser events */
+
+#define cJSON_SaxBeginObject 0
+#define cJSON_SaxEndObject   1
+#define cJSON_SaxBeginArray  2
+#define cJSON_SaxEndArray    3
+#define cJSON_SaxNull        4
+#define cJSON_SaxFalse       5
+#define cJSON_SaxTrue        6
+#define cJSON_SaxNumber      7
+#define cJSON_SaxString      8
+
 #define cJSON_AddNullToObject(object,name) \
   cJSON_AddItemToObject(object, name, cJSON_CreateNull())
 #define cJSON_AddTrueToObject(object,name) \
-  cJSON_AddItemToObject(object, name, cJSON_CreateTrue())cd
+  cJSON_AddItemToObject(object, name, cJSON_CreateTrue())
 #define cJSON_AddFalseToObject(object,name) \
   cJSON_AddItemToObject(object, name, cJSON_CreateFalse())
 #define cJSON_AddNumberToObject(object,name,n) \
@@ -105,6 +147,80 @@ typedef struct cJSON_Hooks
   void (*free_fn)(void *ptr);
 } cJSON_Hooks;
 
+/* An arena holds all of the items and strings of parsed documents so that
+ * they can be released all at once.  Allocations are carved first from the
+ * caller-provided buffer and then, if blocksize is non-zero, from
+ * additional blocks of (at least) blocksize bytes obtained from the malloc
+ * hook.  The fields are private; use cJSON_InitArena() and
+ * cJSON_ResetArena().
+ */
+
+struct cJSON_ArenaBlock;
+
+typedef struct cJSON_Arena
+{
+  struct cJSON_ArenaBlock *blocks; /* Blocks obtained from the malloc hook */
+  char *initbuf;                   /* Caller-provided buffer (may be NULL) */
+  size_t initsize;                 /* Size of initbuf */
+  char *region;                    /* Region being allocated from */
+  size_t size;                     /* Size of region */
+  size_t used;                     /* Bytes used in region */
+  size_t blocksize;                /* Minimum size of a new block (0: none) */
+} cJSON_Arena;
+
+/* Streaming output.  The write function is called with each chunk of
+ * rendered text and returns zero on success; any other value stops the
+ * output and is returned to the caller.  The fields of cJSON_Writer are
+ * private.
+ */
+
+typedef int (*cJSON_WriteFn)(void *priv, const char *buf, size_t len);
+
+typedef struct cJSON_Writer
+{
+  cJSON_WriteFn writefn;           /* Output function */
+  void *priv;                      /* Argument of writefn */
+  uint32_t object;                 /* Bit n: nesting level n+1 is an object */
+  uint32_t empty;                  /* Bit n: level n+1 has no members yet */
+  int depth;                       /* Current nesting level */
+  int fmt;                         /* Non-zero: formatted like cJSON_Print */
+  int error;                       /* First error, or zero */
+  size_t len;                      /* Bytes pending in buf[] */
+  char buf[CONFIG_NETUTILS_JSON_WRITER_BUFSIZE];
+} cJSON_Writer;
+
+/* Streaming (SAX style) parser.  The handler is called for each event as
+ * soon as it has been recognized.  For members of an object, name is the
+ * member name; otherwise it is NULL.  For cJSON_SaxString, str is the
+ * unescaped string; for cJSON_SaxNumber, number holds the value.  depth is
+ * the nesting level of the value (0 for a top-level value).  The handler
+ * returns zero to continue; any other value stops the parser and is
+ * returned by cJSON_SaxFeed().  The fields of cJSON_SaxParser are private,
+ * except for offset which counts the bytes consumed (and so locates a
+ * syntax error).
+ */
+
+typedef int (*cJSON_SaxHandler)(void *priv, int event, const char *name,
+                                const char *str, double number, int depth);
+
+typedef struct cJSON_SaxParser
+{
+  cJSON_SaxHandler handler;        /* Event callback */
+  void *priv;                      /* Argument of handler */
+  size_t offset;                   /* Bytes consumed so far */
+  uint32_t object;                 /* Bit n: nesting level n+1 is an object */
+  uint8_t state;                   /* Parser state */
+  uint8_t depth;                   /* Current nesting level */
+  uint8_t inname;                  /* The string being read is a name */
+  uint8_t ucount;                  /* Hex digits collected of a \u escape */
+  uint16_t uc;                     /* Value of the \u escape */
+  uint16_t hisurrogate;            /* Pending UTF-16 high surrogate */
+  uint16_t toklen;                 /* Characters in token[] */
+  uint16_t namelen;                /* Characters in name[] */
+  char token[CONFIG_NETUTILS_JSON_SAX_BUFSIZE];
+  char name[CONFIG_NETUTILS_JSON_SAX_BUFSIZE];
+} cJSON_SaxParser;
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -119,6 +235,40 @@ void cJSON_InitHooks(cJSON_Hooks* hooks);
 
 cJSON *cJSON_Parse(const char *value);
 
+/* Parse into an arena.  All items and strings of the result are allocated
+ * from the arena and are released together by cJSON_ResetArena(); never
+ * call cJSON_Delete() on them or mix them with heap-allocated items.
+ * cJSON_ParseInSitu() also decodes the strings in place in the (modified)
+ * input text, which must then outlive the result.  On failure, the arena
+ * is restored to its state before the call.
+ */
+
+cJSON *cJSON_ParseArena(cJSON_Arena *arena, const char *value);
+cJSON *cJSON_ParseInSitu(cJSON_Arena *arena, char *value);
+
+/* Prepare an arena.  buffer (optional) provides the first size bytes of
+ * storage; if blocksize is non-zero, the arena grows from the malloc hook
+ * in blocks of at least blocksize bytes.  cJSON_ResetArena() releases
+ * everything allocated from the arena and frees any added blocks.
+ */
+
+void cJSON_InitArena(cJSON_Arena *arena, void *buffer, size_t size,
+                     size_t blocksize);
+void cJSON_ResetArena(cJSON_Arena *arena);
+
+/* Streaming parser.  Text may be supplied in pieces of any size.
+ * cJSON_SaxFinish() must be called at the end of the input to complete a
+ * trailing number and to check that no value is left open.  Several
+ * top-level values may follow one another in the input.  These return zero
+ * on success, -EINVAL on a syntax error, -E2BIG if a string is too long
+ * for the parser buffers, or the non-zero value returned by the handler.
+ */
+
+void cJSON_SaxInit(cJSON_SaxParser *parser, cJSON_SaxHandler handler,
+                   void *priv);
+int cJSON_SaxFeed(cJSON_SaxParser *parser, const char *text, size_t len);
+int cJSON_SaxFinish(cJSON_SaxParser *parser);
+
 /* Render a cJSON entity to text for transfer/storage. Free the char* when
  * finished.
  */
@@ -131,6 +281,40 @@ char *cJSON_Print(cJSON *item);
 
 char *cJSON_PrintUnformatted(cJSON *item);
 
+/* Render a cJSON entity directly to an output function, a stdio stream or
+ * a file/socket descriptor, without building the text in memory.  fmt
+ * selects the formatting of cJSON_Print() (non-zero) or of
+ * cJSON_PrintUnformatted() (zero).  These return zero on success.
+ */
+
+int cJSON_PrintStream(cJSON *item, int fmt, cJSON_WriteFn writefn,
+                      void *priv);
+int cJSON_PrintFile(cJSON *item, FILE *stream, int fmt);
+int cJSON_PrintFd(cJSON *item, int fd, int fmt);
+
+/* Generate JSON text directly, without building cJSON items.  Each value
+ * is added to the innermost open array or object; name is required for
+ * members of an object and ignored otherwise.  cJSON_WriteItem() adds a
+ * complete cJSON entity.  cJSON_WriterFlush() passes any buffered text to
+ * the output function.  All return zero, or the first error: -EINVAL for
+ * misuse or nesting deeper than cJSON_MAXNESTING, or the value returned
+ * by the output function.
+ */
+
+void cJSON_WriterInit(cJSON_Writer *writer, cJSON_WriteFn writefn,
+                      void *priv, int fmt);
+int cJSON_WriteBeginObject(cJSON_Writer *writer, const char *name);
+int cJSON_WriteEndObject(cJSON_Writer *writer);
+int cJSON_WriteBeginArray(cJSON_Writer *writer, const char *name);
+int cJSON_WriteEndArray(cJSON_Writer *writer);
+int cJSON_WriteNull(cJSON_Writer *writer, const char *name);
+int cJSON_WriteBool(cJSON_Writer *writer, const char *name, int b);
+int cJSON_WriteNumber(cJSON_Writer *writer, const char *name, double num);
+int cJSON_WriteString(cJSON_Writer *writer, const char *name,
+                      const char *string);
+int cJSON_WriteItem(cJSON_Writer *writer, const char *name, cJSON *item);
+int cJSON_WriterFlush(cJSON_Writer *writer);
+
 /* Delete a cJSON entity and all subentities. */
 
 void cJSON_Delete(cJSON *c);
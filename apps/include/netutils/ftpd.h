@@ -66,6 +66,12 @@
  *     transfers.  Default: 512 bytes.
  *   CONFIG_FTPD_WORKERSTACKSIZE - The stacksize to allocate for each
  *     FTP daemon worker thread.  Default:  2048 bytes.
+ *   CONFIG_FTPD_POOL - Serve sessions with a pool of pre-created worker
+ *     threads instead of creating a thread for each connection.
+ *   CONFIG_FTPD_NWORKERS - The number of pooled worker threads.  This is
+ *     the maximum number of concurrent sessions.  Default: 2
+ *   CONFIG_FTPD_QUEUESIZE - The number of accepted connections that may
+ *     wait for a pooled worker.  Default: 2
  */
 
 #ifdef CONFIG_DISABLE_PTHREAD
@@ -96,6 +102,20 @@
 #  define CONFIG_FTPD_WORKERSTACKSIZE 2048
 #endif
 
+#ifdef CONFIG_FTPD_POOL
+#  ifndef CONFIG_FTPD_NWORKERS
+#    define CONFIG_FTPD_NWORKERS 2
+#  endif
+
+#  if CONFIG_FTPD_NWORKERS < 1
+#    error "CONFIG_FTPD_NWORKERS must be at least 1"
+#  endif
+
+#  ifndef CONFIG_FTPD_QUEUESIZE
+#    define CONFIG_FTPD_QUEUESIZE 2
+#  endif
+#endif
+
 /* Interface definitions ****************************************************/
 
 #define FTPD_ACCOUNTFLAG_NONE    (0)
@@ -111,6 +131,22 @@
 
 typedef FAR void *FTPD_SESSION;
 
+#ifdef CONFIG_FTPD_POOL
+/* Statistics of a pooled FTP server (see ftpd_getstats) */
+
+struct ftpd_stats_s
+{
+  uint32_t sessions;  /* Number of connections accepted */
+  uint32_t refused;   /* Number of connections refused (server busy) */
+  uint32_t rxbytes;   /* File data received by completed sessions */
+  uint32_t txbytes;   /* File data sent by completed sessions */
+  uint8_t  workers;   /* Number of worker threads running */
+  uint8_t  active;    /* Number of sessions in progress */
+  uint8_t  queued;    /* Number of connections waiting for a worker */
+  uint8_t  peak;      /* Maximum number of concurrent sessions */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -188,17 +224,42 @@ EXTERN int ftpd_adduser(FTPD_SESSION handle, uint8_t accountflags,
  *   Zero is returned if the FTP worker was started.  On failure, a negated
  *   errno value is returned to indicate why the servier terminated.
  *   -ETIMEDOUT indicates that the user-provided timeout elapsed with no
- *   connection.
+ *   connection.  If CONFIG_FTPD_POOL is selected, zero means that the
+ *   connection was queued for a pooled worker and -EBUSY indicates that
+ *   the connection was refused because all workers were busy and the
+ *   queue was full.
  *
  ****************************************************************************/
 
 EXTERN int ftpd_session(FTPD_SESSION handle, int timeout);
 
+/****************************************************************************
+ * Name: ftpd_getstats
+ *
+ * Description:
+ *   Return the session statistics of a pooled FTP server.
+ *
+ * Input Parameters:
+ *   handle - A handle previously returned by ftpd_open
+ *   stats - The location to return the statistics
+ *
+ * Returned Value:
+ *   Zero is returned on success.  A negated errno value is return on
+ *   failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTPD_POOL
+EXTERN int ftpd_getstats(FTPD_SESSION handle, FAR struct ftpd_stats_s *stats);
+#endif
+
 /****************************************************************************
  * Name: ftpd_close
  *
  * Description:
- *   Close and destroy the handle created by ftpd_open.
+ *   Close and destroy the handle created by ftpd_open.  If CONFIG_FTPD_POOL
+ *   is selected, idle workers exit immediately and the server is destroyed
+ *   when the last session in progress ends.
  *
  * Input Parameters:
  *   handle - A handle previously returned by ftpd_open
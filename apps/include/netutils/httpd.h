@@ -118,6 +118,7 @@ struct httpd_state
 #endif
   struct httpd_fs_file ht_file;             /* Fake file data to send */
   int      ht_sockfd;                       /* The socket descriptor from accept() */
+  uint16_t ht_buflen;                       /* Unprocessed bytes in ht_buffer[] */
   char    *ht_scriptptr;
   uint16_t ht_scriptlen;
   uint16_t ht_sndlen;
@@ -42,6 +42,10 @@
 
 #include <nuttx/config.h>
 
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -52,6 +56,11 @@
  * CONFIG_TELNETD_TXBUFFER_SIZE - The size of the telnet transmit buffer.
  *   Default: 256 bytes.
  * CONFIG_TELNETD_DUMPBUFFER - dumping of all input/output buffers.
+ * CONFIG_TELNETD_POOL - Serve sessions with pre-created worker tasks.
+ * CONFIG_TELNETD_NWORKERS - The number of worker tasks of each daemon.
+ *   Default: 2.
+ * CONFIG_TELNETD_QUEUESIZE - The number of connections that may wait for
+ *   a worker.  Default: 2.
  */
 
 #ifndef CONFIG_TELNETD_RXBUFFER_SIZE
@@ -62,6 +71,20 @@
 # define CONFIG_TELNETD_TXBUFFER_SIZE 256
 #endif
 
+#ifdef CONFIG_TELNETD_POOL
+#  ifndef CONFIG_TELNETD_NWORKERS
+#    define CONFIG_TELNETD_NWORKERS 2
+#  endif
+
+#  if CONFIG_TELNETD_NWORKERS < 1
+#    error CONFIG_TELNETD_NWORKERS must be at least 1
+#  endif
+
+#  ifndef CONFIG_TELNETD_QUEUESIZE
+#    define CONFIG_TELNETD_QUEUESIZE 2
+#  endif
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -88,6 +111,31 @@ struct telnetd_config_s
                        * connection is accepted. */
 };
 
+#ifdef CONFIG_TELNETD_POOL
+/* Statistics of one session worker (see telnetd_getstats) */
+
+struct telnetd_workerstats_s
+{
+  uint32_t sessions;  /* Number of sessions served by the worker */
+  uint32_t ticks;     /* Total session time (system ticks) */
+  bool     running;   /* The worker task is running */
+  bool     busy;      /* The worker is serving a session */
+};
+
+/* Statistics of a pooled Telnet daemon (see telnetd_getstats) */
+
+struct telnetd_stats_s
+{
+  uint32_t sessions;  /* Number of connections accepted */
+  uint32_t refused;   /* Number of connections refused (server busy) */
+  uint8_t  workers;   /* Number of worker tasks running */
+  uint8_t  active;    /* Number of sessions in progress */
+  uint8_t  queued;    /* Number of connections waiting for a worker */
+  uint8_t  peak;      /* Maximum number of concurrent sessions */
+  struct telnetd_workerstats_s worker[CONFIG_TELNETD_NWORKERS];
+};
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -120,6 +168,26 @@ extern "C" {
 
 EXTERN int telnetd_start(FAR struct telnetd_config_s *config);
 
+/****************************************************************************
+ * Name: telnetd_getstats
+ *
+ * Description:
+ *   Return the session statistics of a pooled Telnet daemon.
+ *
+ * Parameters:
+ *   pid       The process ID of the daemon, as returned by telnetd_start
+ *   stats     The location to return the statistics
+ *
+ * Return:
+ *   Zero is returned on success.  A negated errno value is returned on
+ *   failure:  -ESRCH if there is no pooled daemon with this process ID.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_TELNETD_POOL
+EXTERN int telnetd_getstats(pid_t pid, FAR struct telnetd_stats_s *stats);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -186,9 +186,20 @@ static int ftpd_command(FAR struct ftpd_session_s *session);
 
 static int  ftpd_startworker(pthread_startroutine_t handler, FAR void *arg,
               size_t stacksize);
+static FAR struct ftpd_session_s *
+ftpd_allocsession(FAR struct ftpd_server_s *server);
+static void ftpd_resetsession(FAR struct ftpd_session_s *session);
 static void ftpd_freesession(FAR struct ftpd_session_s *session);
 static void ftpd_workersetup(FAR struct ftpd_session_s *session);
+static void ftpd_serve(FAR struct ftpd_session_s *session);
+#ifdef CONFIG_FTPD_POOL
+static void ftpd_takesem(FAR sem_t *sem);
+static void ftpd_freeserver(FAR struct ftpd_server_s *server);
+static FAR void *ftpd_poolworker(FAR void *arg);
+static int  ftpd_startpool(FAR struct ftpd_server_s *server);
+#else
 static FAR void *ftpd_worker(FAR void *arg);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -1130,6 +1141,10 @@ static FAR struct ftpd_server_s *ftpd_openserver(int port)
     server->sd   = -1;
     server->head = NULL;
     server->tail = NULL;
+#ifdef CONFIG_FTPD_POOL
+    sem_init(&server->exclsem, 0, 1);
+    sem_init(&server->worksem, 0, 0);
+#endif
 
   /* Create the server listen socket */
 
@@ -1191,6 +1206,17 @@ static FAR struct ftpd_server_s *ftpd_openserver(int port)
       return NULL;
     }
 
+#ifdef CONFIG_FTPD_POOL
+  /* Create the pool of session workers */
+
+  ret = ftpd_startpool(server);
+  if (ret < 0)
+    {
+      ftpd_close((FTPD_SESSION)server);
+      return NULL;
+    }
+#endif
+
   return (FTPD_SESSION)server;
 }
 
@@ -1908,6 +1934,10 @@ static int ftpd_stream(FAR struct ftpd_session_s *session, int cmdtype)
             {
               errval = -rdbytes;
             }
+          else
+            {
+              session->rxbytes += (uint32_t)rdbytes;
+            }
         }
 
       /* A negative vaule of rdbytes indicates a read error.  errval has the
@@ -1973,6 +2003,10 @@ static int ftpd_stream(FAR struct ftpd_session_s *session, int cmdtype)
               errval = -wrbytes;
               ndbg("ftpd_send failed: %d\n", errval);
             }
+          else
+            {
+              session->txbytes += (uint32_t)wrbytes;
+            }
         }
       else
         {
@@ -3927,53 +3961,163 @@ errout:
 }
 
 /****************************************************************************
- * Name: ftpd_freesession
+ * Name: ftpd_allocsession
+ *
+ * Description:
+ *   Allocate and initialize a session structure with its command and data
+ *   buffers.
+ *
  ****************************************************************************/
 
-static void ftpd_freesession(FAR struct ftpd_session_s *session)
+static FAR struct ftpd_session_s *
+ftpd_allocsession(FAR struct ftpd_server_s *server)
+{
+  FAR struct ftpd_session_s *session;
+
+  session = (FAR struct ftpd_session_s *)zalloc(sizeof(struct ftpd_session_s));
+  if (!session)
+    {
+      ndbg("Failed to allocate session\n");
+      return NULL;
+    }
+
+  /* Initialize the session */
+
+  session->server       = server;
+  session->head         = server->head;
+  session->curr         = NULL;
+  session->flags        = 0;
+  session->txtimeout    = -1;
+  session->rxtimeout    = -1;
+  session->cmd.sd       = (int)(-1);
+  session->cmd.addrlen  = (socklen_t)sizeof(session->cmd.addr);
+  session->cmd.buflen   = (size_t)CONFIG_FTPD_CMDBUFFERSIZE;
+  session->cmd.buffer   = NULL;
+  session->command      = NULL;
+  session->param        = NULL;
+  session->data.sd      = -1;
+  session->data.addrlen = sizeof(session->data.addr);
+  session->data.buflen  = CONFIG_FTPD_DATABUFFERSIZE;
+  session->data.buffer  = NULL;
+  session->restartpos   = 0;
+  session->fd           = -1;
+  session->user         = NULL;
+  session->type         = FTPD_SESSIONTYPE_NONE;
+  session->home         = NULL;
+  session->work         = NULL;
+  session->renamefrom   = NULL;
+  session->rxbytes      = 0;
+  session->txbytes      = 0;
+
+  /* Allocate a command buffer */
+
+  session->cmd.buffer = (FAR char *)malloc(session->cmd.buflen);
+  if (!session->cmd.buffer)
+    {
+      ndbg("Failed to allocate command buffer\n");
+      goto errout_with_session;
+    }
+
+  /* Allocate a data buffer */
+
+  session->data.buffer = (FAR char *)malloc(session->data.buflen);
+  if (!session->data.buffer)
+    {
+      ndbg("Failed to allocate data buffer\n");
+      goto errout_with_session;
+    }
+
+  return session;
+
+errout_with_session:
+  ftpd_freesession(session);
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: ftpd_resetsession
+ *
+ * Description:
+ *   Release all resources held by a session except for its buffers and
+ *   return it to the state of a newly allocated session.
+ *
+ ****************************************************************************/
+
+static void ftpd_resetsession(FAR struct ftpd_session_s *session)
 {
   /* Free resources */
 
   if (session->renamefrom)
     {
       free(session->renamefrom);
+      session->renamefrom = NULL;
     }
 
   if (session->work)
     {
       free(session->work);
+      session->work = NULL;
     }
 
   if (session->home)
     {
       free(session->home);
+      session->home = NULL;
     }
 
   if (session->user)
     {
       free(session->user);
+      session->user = NULL;
     }
 
-  if (session->fd < 0)
+  if (session->fd >= 0)
     {
       close(session->fd);
+      session->fd = -1;
     }
 
-  if (session->data.buffer)
+  (void)ftpd_dataclose(session);
+
+  if (session->cmd.sd >= 0)
     {
-      free(session->data.buffer);
+      close(session->cmd.sd);
+      session->cmd.sd = -1;
     }
 
-  (void)ftpd_dataclose(session);
+  /* Re-initialize the session state */
 
-  if (session->cmd.buffer)
+  session->head         = session->server->head;
+  session->curr         = NULL;
+  session->flags        = 0;
+  session->txtimeout    = -1;
+  session->rxtimeout    = -1;
+  session->cmd.addrlen  = (socklen_t)sizeof(session->cmd.addr);
+  session->command      = NULL;
+  session->param        = NULL;
+  session->data.addrlen = sizeof(session->data.addr);
+  session->restartpos   = 0;
+  session->type         = FTPD_SESSIONTYPE_NONE;
+  session->rxbytes      = 0;
+  session->txbytes      = 0;
+}
+
+/****************************************************************************
+ * Name: ftpd_freesession
+ ****************************************************************************/
+
+static void ftpd_freesession(FAR struct ftpd_session_s *session)
+{
+  ftpd_resetsession(session);
+
+  if (session->data.buffer)
     {
-      free(session->cmd.buffer);
+      free(session->data.buffer);
     }
 
-  if (session->cmd.sd <0)
+  if (session->cmd.buffer)
     {
-      close(session->cmd.sd);
+      free(session->cmd.buffer);
     }
 
   free(session);
@@ -4011,18 +4155,22 @@ static void ftpd_workersetup(FAR struct ftpd_session_s *session)
 }
 
 /****************************************************************************
- * Name: ftpd_worker
+ * Name: ftpd_serve
+ *
+ * Description:
+ *   Serve one FTP session on the connected command socket until the peer
+ *   disconnects or a command handler terminates the session.  The caller
+ *   releases the session resources.
+ *
  ****************************************************************************/
 
-static FAR void *ftpd_worker(FAR void *arg)
+static void ftpd_serve(FAR struct ftpd_session_s *session)
 {
-  FAR struct ftpd_session_s *session = (FAR struct ftpd_session_s *)arg;
   ssize_t recvbytes;
   size_t offset;
   uint8_t ch;
   int ret;
 
-  nvdbg("Worker started\n");
   DEBUGASSERT(session);
 
   /* Configure the session sockets */
@@ -4036,8 +4184,7 @@ static FAR void *ftpd_worker(FAR void *arg)
   if (ret < 0)
     {
       ndbg("ftpd_response() failed: %d\n", ret);
-      ftpd_freesession(session);
-      return NULL;
+      return;
     }
 
   /* Then loop processing FTP commands */
@@ -4130,11 +4277,203 @@ static FAR void *ftpd_worker(FAR void *arg)
           break;
         }
     }
+}
 
+
+#ifndef CONFIG_FTPD_POOL
+/****************************************************************************
+ * Name: ftpd_worker
+ ****************************************************************************/
+
+static FAR void *ftpd_worker(FAR void *arg)
+{
+  FAR struct ftpd_session_s *session = (FAR struct ftpd_session_s *)arg;
+
+  nvdbg("Worker started\n");
+  ftpd_serve(session);
   ftpd_freesession(session);
   return NULL;
 }
 
+#else
+/****************************************************************************
+ * Name: ftpd_takesem
+ ****************************************************************************/
+
+static void ftpd_takesem(FAR sem_t *sem)
+{
+  while (sem_wait(sem) < 0)
+    {
+      /* The only case that an error should occur here is if the wait was
+       * awakened by a signal.
+       */
+
+      DEBUGASSERT(errno == EINTR);
+    }
+}
+
+/****************************************************************************
+ * Name: ftpd_freeserver
+ *
+ * Description:
+ *   Free a closed server after its last worker has exited, including any
+ *   connections still waiting for a worker.
+ *
+ ****************************************************************************/
+
+static void ftpd_freeserver(FAR struct ftpd_server_s *server)
+{
+  while (server->stats.queued > 0)
+    {
+      close(server->pending[server->qhead].sd);
+      server->stats.queued--;
+
+      if (++server->qhead >= FTPD_NPENDING)
+        {
+          server->qhead = 0;
+        }
+    }
+
+  if (server->head)
+    {
+      ftpd_account_free(server->head);
+    }
+
+  sem_destroy(&server->exclsem);
+  sem_destroy(&server->worksem);
+  free(server);
+}
+
+/****************************************************************************
+ * Name: ftpd_poolworker
+ *
+ * Description:
+ *   A pooled worker thread.  It waits for ftpd_session() to queue an
+ *   accepted connection, serves the session using its pre-allocated session
+ *   structure, then waits for the next connection.
+ *
+ ****************************************************************************/
+
+static FAR void *ftpd_poolworker(FAR void *arg)
+{
+  FAR struct ftpd_session_s *session = (FAR struct ftpd_session_s *)arg;
+  FAR struct ftpd_server_s *server = session->server;
+  FAR struct ftpd_pending_s *pending;
+  bool last;
+
+  nvdbg("Worker started\n");
+
+  for (;;)
+    {
+      /* Wait for a connection */
+
+      ftpd_takesem(&server->worksem);
+      ftpd_takesem(&server->exclsem);
+
+      if (server->stopping)
+        {
+          break;
+        }
+
+      pending = &server->pending[server->qhead];
+      session->cmd.sd      = pending->sd;
+      session->cmd.addrlen = pending->addrlen;
+      memcpy(&session->cmd.addr, &pending->addr, pending->addrlen);
+
+      /* Accounts may have been added since the session was reset */
+
+      session->head        = server->head;
+
+      if (++server->qhead >= FTPD_NPENDING)
+        {
+          server->qhead = 0;
+        }
+
+      server->stats.queued--;
+      server->stats.active++;
+      if (server->stats.active > server->stats.peak)
+        {
+          server->stats.peak = server->stats.active;
+        }
+
+      sem_post(&server->exclsem);
+
+      /* Serve the session */
+
+      ftpd_serve(session);
+
+      nvdbg("Session ended: rx=%lu tx=%lu\n",
+            (unsigned long)session->rxbytes, (unsigned long)session->txbytes);
+
+      ftpd_takesem(&server->exclsem);
+      server->stats.active--;
+      server->stats.rxbytes += session->rxbytes;
+      server->stats.txbytes += session->txbytes;
+      sem_post(&server->exclsem);
+
+      ftpd_resetsession(session);
+    }
+
+  /* ftpd_close() was called.  The last worker frees the server. */
+
+  server->stats.workers--;
+  last = (server->stats.workers == 0);
+  sem_post(&server->exclsem);
+
+  ftpd_freesession(session);
+  if (last)
+    {
+      ftpd_freeserver(server);
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: ftpd_startpool
+ *
+ * Description:
+ *   Create the pooled worker threads, each with a pre-allocated session.
+ *
+ ****************************************************************************/
+
+static int ftpd_startpool(FAR struct ftpd_server_s *server)
+{
+  FAR struct ftpd_session_s *session;
+  int ret;
+  int i;
+
+  for (i = 0; i < CONFIG_FTPD_NWORKERS; i++)
+    {
+      session = ftpd_allocsession(server);
+      if (!session)
+        {
+          return -ENOMEM;
+        }
+
+      ftpd_takesem(&server->exclsem);
+      server->stats.workers++;
+      sem_post(&server->exclsem);
+
+      ret = ftpd_startworker(ftpd_poolworker, (FAR void *)session,
+                             CONFIG_FTPD_WORKERSTACKSIZE);
+      if (ret < 0)
+        {
+          ndbg("ftpd_startworker() failed: %d\n", ret);
+
+          ftpd_takesem(&server->exclsem);
+          server->stats.workers--;
+          sem_post(&server->exclsem);
+
+          ftpd_freesession(session);
+          return ret;
+        }
+    }
+
+  return OK;
+}
+#endif /* CONFIG_FTPD_POOL */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -4264,67 +4603,93 @@ errout:
 int ftpd_session(FTPD_SESSION handle, int timeout)
 {
   FAR struct ftpd_server_s  *server;
+#ifdef CONFIG_FTPD_POOL
+  FAR struct ftpd_pending_s *pending;
+  union ftpd_sockaddr_u      addr;
+  socklen_t                  addrlen;
+  bool                       admit;
+  int                        ndx;
+  int                        sd;
+#else
   FAR struct ftpd_session_s *session;
   int ret;
+#endif
 
   DEBUGASSERT(handle);
 
   server = (FAR struct ftpd_server_s *)handle;
 
-  /* Allocate a session */
+#ifdef CONFIG_FTPD_POOL
+  /* Accept a connection */
 
-  session = (FAR struct ftpd_session_s *)zalloc(sizeof(struct ftpd_session_s));
-  if (!session)
+  addrlen = (socklen_t)sizeof(addr);
+  sd = ftpd_accept(server->sd, (FAR void *)&addr, &addrlen, timeout);
+  if (sd < 0)
     {
-      ndbg("Failed to allocate session\n");
-      ret = -ENOMEM;
-      goto errout;
+      /* Only report interesting, infrequent errors (not the common timeout) */
+
+#ifdef CONFIG_DEBUG_NET
+      if (sd != -ETIMEDOUT)
+        {
+          ndbg("ftpd_accept() failed: %d\n", sd);
+        }
+#endif
+      return sd;
     }
 
-  /* Initialize the session */
+  /* Queue the connection for the next available worker unless every
+   * worker is busy and the queue is full.
+   */
 
-  session->server       = server;
-  session->head         = server->head;
-  session->curr         = NULL;
-  session->flags        = 0;
-  session->txtimeout    = -1;
-  session->rxtimeout    = -1;
-  session->cmd.sd       = (int)(-1);
-  session->cmd.addrlen  = (socklen_t)sizeof(session->cmd.addr);
-  session->cmd.buflen   = (size_t)CONFIG_FTPD_CMDBUFFERSIZE;
-  session->cmd.buffer   = NULL;
-  session->command      = NULL;
-  session->param        = NULL;
-  session->data.sd      = -1;
-  session->data.addrlen = sizeof(session->data.addr);
-  session->data.buflen  = CONFIG_FTPD_DATABUFFERSIZE;
-  session->data.buffer  = NULL;
-  session->restartpos   = 0;
-  session->fd           = -1;
-  session->user         = NULL;
-  session->type         = FTPD_SESSIONTYPE_NONE;
-  session->home         = NULL;
-  session->work         = NULL;
-  session->renamefrom   = NULL;
+  ftpd_takesem(&server->exclsem);
+  admit = (server->stats.active + server->stats.queued <
+           server->stats.workers + CONFIG_FTPD_QUEUESIZE);
 
-  /* Allocate a command buffer */
+  if (admit)
+    {
+      ndx = server->qhead + server->stats.queued;
+      if (ndx >= FTPD_NPENDING)
+        {
+          ndx -= FTPD_NPENDING;
+        }
 
-  session->cmd.buffer = (FAR char *)malloc(session->cmd.buflen);
-  if (!session->cmd.buffer)
+      pending          = &server->pending[ndx];
+      pending->sd      = sd;
+      pending->addrlen = addrlen;
+      memcpy(&pending->addr, &addr, addrlen);
+
+      server->stats.queued++;
+      server->stats.sessions++;
+    }
+  else
     {
-      ndbg("Failed to allocate command buffer\n");
-      ret = -ENOMEM;
-      goto errout_with_session;
+      server->stats.refused++;
     }
 
-  /* Allocate a data buffer */
+  sem_post(&server->exclsem);
 
-  session->data.buffer = (FAR char *)malloc(session->data.buflen);
-  if (!session->data.buffer)
+  if (!admit)
+    {
+      nvdbg("Refusing connection: active=%d queued=%d\n",
+            server->stats.active, server->stats.queued);
+
+      (void)ftpd_response(sd, 1000, g_respfmt1, 421, ' ',
+                          "Too many users, try again later");
+      close(sd);
+      return -EBUSY;
+    }
+
+  sem_post(&server->worksem);
+  return 0;
+
+#else
+  /* Allocate a session */
+
+  session = ftpd_allocsession(server);
+  if (!session)
     {
-      ndbg("Failed to allocate data buffer\n");
       ret = -ENOMEM;
-      goto errout_with_session;
+      goto errout;
     }
 
   /* Accept a connection */
@@ -4363,8 +4728,42 @@ errout_with_session:
   ftpd_freesession(session);
 errout:
   return ret;
+#endif
 }
 
+/****************************************************************************
+ * Name: ftpd_getstats
+ *
+ * Description:
+ *   Return the session statistics of a pooled FTP server.
+ *
+ * Input Parameters:
+ *   handle - A handle previously returned by ftpd_open
+ *   stats - The location to return the statistics
+ *
+ * Returned Value:
+ *   Zero is returned on success.  A negated errno value is return on
+ *   failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTPD_POOL
+int ftpd_getstats(FTPD_SESSION handle, FAR struct ftpd_stats_s *stats)
+{
+  FAR struct ftpd_server_s *server = (FAR struct ftpd_server_s *)handle;
+
+  if (!server || !stats)
+    {
+      return -EINVAL;
+    }
+
+  ftpd_takesem(&server->exclsem);
+  *stats = server->stats;
+  sem_post(&server->exclsem);
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: ftpd_close
  *
@@ -4382,10 +4781,13 @@ errout:
 void ftpd_close(FTPD_SESSION handle)
 {
   struct ftpd_server_s *server;
+#ifdef CONFIG_FTPD_POOL
+  int nworkers;
+  int i;
+#endif
   DEBUGASSERT(handle);
 
   server = (struct ftpd_server_s *)handle;
-  ftpd_account_free(server->head);
 
   if (server->sd >= 0)
     {
@@ -4393,6 +4795,33 @@ void ftpd_close(FTPD_SESSION handle)
       server->sd = -1;
     }
 
+#ifdef CONFIG_FTPD_POOL
+  /* Stop the workers.  Idle workers exit now, busy workers exit when their
+   * session ends.  The last worker to exit frees the server.
+   */
+
+  ftpd_takesem(&server->exclsem);
+  server->stopping = true;
+  nworkers = server->stats.workers;
+  sem_post(&server->exclsem);
+
+  if (nworkers == 0)
+    {
+      ftpd_freeserver(server);
+      return;
+    }
+
+  for (i = 0; i < nworkers; i++)
+    {
+      sem_post(&server->worksem);
+    }
+#else
+  if (server->head)
+    {
+      ftpd_account_free(server->head);
+    }
+
   free(server);
+#endif
 }
 
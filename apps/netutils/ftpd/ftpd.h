@@ -44,9 +44,13 @@
 
 #include <sys/types.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <semaphore.h>
 
 #include <netinet/in.h>
 
+#include <apps/netutils/ftpd.h>
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -64,6 +68,14 @@
 
 #define FTPD_CMDFLAG_LOGIN          (1 << 0)  /* Command requires login */
 
+/* The number of accepted connections that may be pending:  One for each
+ * pooled worker plus the configured backlog.
+ */
+
+#ifdef CONFIG_FTPD_POOL
+#  define FTPD_NPENDING (CONFIG_FTPD_NWORKERS + CONFIG_FTPD_QUEUESIZE)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -111,12 +123,31 @@ struct ftpd_account_s
 
 /* This structures describes an FTP session a list of associated accounts */
 
+#ifdef CONFIG_FTPD_POOL
+/* An accepted connection waiting for a pooled worker */
+
+struct ftpd_pending_s
+{
+  int                        sd;      /* Socket descriptor */
+  union ftpd_sockaddr_u      addr;    /* Peer address */
+  socklen_t                  addrlen; /* Length of the address */
+};
+#endif
+
 struct ftpd_server_s
 {
   int                        sd;     /* Listen socket descriptor */
   union ftpd_sockaddr_u      addr;   /* Listen address */
   struct ftpd_account_s     *head;   /* Head of a list of accounts */
   struct ftpd_account_s     *tail;   /* Tail of a list of accounts */
+#ifdef CONFIG_FTPD_POOL
+  sem_t                      exclsem;  /* Exclusive access to the pool */
+  sem_t                      worksem;  /* Counts connections waiting */
+  bool                       stopping; /* True: ftpd_close() was called */
+  uint8_t                    qhead;    /* Index of the oldest pending */
+  struct ftpd_stats_s        stats;    /* Session statistics */
+  struct ftpd_pending_s      pending[FTPD_NPENDING];
+#endif
 };
 
 struct ftpd_stream_s
@@ -159,6 +190,11 @@ struct ftpd_session_s
   FAR char                  *home;
   FAR char                  *work;
   FAR char                  *renamefrom;
+
+  /* Accounting */
+
+  uint32_t                   rxbytes; /* File data received */
+  uint32_t                   txbytes; /* File data sent */
 };
 
 typedef int (*ftpd_cmdhandler_t)(struct ftpd_session_s *);
@@ -34,6 +34,7 @@
  * Included Files
  ****************************************************************************/
 
+#include <stdint.h>
 #include <string.h>
 #include <stdio.h>
 #include <math.h>
@@ -42,6 +43,7 @@
 #include <limits.h>
 #include <ctype.h>
 #include <unistd.h>
+#include <errno.h>
 
 #include <apps/netutils/cJSON.h>
 
@@ -49,6 +51,66 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Arena allocations are aligned for any cJSON member */
+
+#define ARENA_ALIGN      sizeof(union arena_align_u)
+#define ARENA_ROUNDUP(n) (((n) + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1))
+#define ARENA_HDRSIZE    ARENA_ROUNDUP(sizeof(struct cJSON_ArenaBlock))
+
+/* Initial size of the string allocated by cJSON_Print() */
+
+#define PRINT_INITSIZE   256
+
+/* Streaming parser states */
+
+#define SAX_VALUE        0  /* Expecting a value */
+#define SAX_VALUE_OR_END 1  /* After '[': a value or ']' */
+#define SAX_NAME_OR_END  2  /* After '{': a member name or '}' */
+#define SAX_NAME         3  /* After ',' in an object: a member name */
+#define SAX_COLON        4  /* After a member name */
+#define SAX_NEXT         5  /* After a value: ',' or the end of the container */
+#define SAX_STRING       6  /* In a string */
+#define SAX_ESCAPE       7  /* After '\' in a string */
+#define SAX_UNICODE      8  /* In the hex digits of a \u escape */
+#define SAX_NUMBER       9  /* In a number */
+#define SAX_LITERAL      10 /* In true, false or null */
+#define SAX_ERROR        11 /* After an error */
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+union arena_align_u
+{
+  double d;
+  void *p;
+  long l;
+};
+
+/* Header of each arena block obtained from the malloc hook */
+
+struct cJSON_ArenaBlock
+{
+  struct cJSON_ArenaBlock *next;
+};
+
+/* String being rendered by cJSON_Print() */
+
+struct print_buffer_s
+{
+  char *buf;           /* Allocated string */
+  size_t size;         /* Size of buf */
+  size_t len;          /* Characters in buf */
+};
+
+/* State of one parse */
+
+struct parse_context_s
+{
+  cJSON_Arena *arena;  /* Allocate from this arena (NULL: malloc hook) */
+  int insitu;          /* Decode strings in place in the input text */
+};
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -65,12 +127,15 @@ static void (*cJSON_free)(void *ptr)    = free;
  * Private Prototypes
  ****************************************************************************/
 
-static const char *parse_value(cJSON *item, const char *value);
-static char *print_value(cJSON *item, int depth, int fmt);
-static const char *parse_array(cJSON *item, const char *value);
-static char *print_array(cJSON *item, int depth, int fmt);
-static const char *parse_object(cJSON *item, const char *value);
-static char *print_object(cJSON *item, int depth, int fmt);
+static const char *parse_value(struct parse_context_s *ctx, cJSON *item,
+                               const char *value);
+static void print_value(cJSON_Writer *writer, cJSON *item, int depth);
+static const char *parse_array(struct parse_context_s *ctx, cJSON *item,
+                               const char *value);
+static void print_array(cJSON_Writer *writer, cJSON *item, int depth);
+static const char *parse_object(struct parse_context_s *ctx, cJSON *item,
+                                const char *value);
+static void print_object(cJSON_Writer *writer, cJSON *item, int depth);
 
 /****************************************************************************
  * Private Functions
@@ -104,6 +169,43 @@ static cJSON *cJSON_New_Item(void)
   return node;
 }
 
+/* Allocate from an arena, adding a new block if the current region is
+ * full and the arena is allowed to grow.
+ */
+
+static void *arena_alloc(cJSON_Arena *arena, size_t size)
+{
+  struct cJSON_ArenaBlock *block;
+  size_t offset;
+  size_t blksize;
+
+  offset = ARENA_ROUNDUP(arena->used);
+  if (arena->region && offset + size <= arena->size)
+    {
+      arena->used = offset + size;
+      return arena->region + offset;
+    }
+
+  if (arena->blocksize == 0)
+    {
+      return 0;
+    }
+
+  blksize = (size > arena->blocksize) ? size : arena->blocksize;
+  block = (struct cJSON_ArenaBlock *)cJSON_malloc(ARENA_HDRSIZE + blksize);
+  if (!block)
+    {
+      return 0;
+    }
+
+  block->next   = arena->blocks;
+  arena->blocks = block;
+  arena->region = (char *)block + ARENA_HDRSIZE;
+  arena->size   = blksize;
+  arena->used   = size;
+  return arena->region;
+}
+
 static int cJSON_strcasecmp(const char *s1, const char *s2)
 {
   if (!s1)
@@ -207,53 +309,60 @@ static const char *parse_number(cJSON *item, const char *num)
   return num;
 }
 
-/* Render the number nicely from the given item into a string. */
+/* Allocate memory for the parser, from the arena if there is one. */
 
-static char *print_number(cJSON *item)
+static void *parse_alloc(struct parse_context_s *ctx, size_t size)
 {
-  char *str;
-  double d = item->valuedouble;
-
-  if (fabs(((double)item->valueint) - d) <= DBL_EPSILON) /* && d<=INT_MAX && d>=INT_MIN) */
+  if (ctx->arena)
     {
-       /* 2^64+1 can be represented in 21 chars. */
-
-      str = (char *)cJSON_malloc(21);
-      if (str)
-        {
-          sprintf(str, "%d", item->valueint);
-        }
+      return arena_alloc(ctx->arena, size);
     }
-  else
+
+  return cJSON_malloc(size);
+}
+
+static cJSON *parse_new_item(struct parse_context_s *ctx)
+{
+  cJSON *node = (cJSON *)parse_alloc(ctx, sizeof(cJSON));
+  if (node)
     {
-      /* This is a nice tradeoff. */
+      memset(node, 0, sizeof(cJSON));
+    }
 
-      str = (char *)cJSON_malloc(64);
-      if (str)
+  return node;
+}
+
+/* Parse the four hex digits of a \u escape.  Returns zero, without
+ * reading past the first character that is not a hex digit, if there are
+ * fewer than four.
+ */
+
+static int parse_hex4(const char *str, unsigned *uc)
+{
+  int i;
+
+  for (i = 0; i < 4; i++)
+    {
+      if (!isxdigit((unsigned char)str[i]))
         {
-          if (fabs(floor(d) - d) <= DBL_EPSILON)
-            {
-              sprintf(str, "%d", item->valueint);
-            }
-          else if (fabs(d) < 1.0e-6 || fabs(d) > 1.0e9)
-            {
-              sprintf(str, "%e", d);
-            }
-          else
-            {
-              sprintf(str, " %f", d);
-            }
+          return 0;
         }
     }
 
-  return str;
+  sscanf(str, "%4x", uc);
+  return 1;
 }
 
-/* Parse the input text into an unescaped cstring, and populate item. */
+/* Parse the input text into an unescaped cstring, and populate item.  For
+ * in-situ parsing, the unescaped string replaces the quoted text in the
+ * input; it can never be longer.
+ */
 
-static const char *parse_string(cJSON *item, const char *str)
+static const char *parse_string(struct parse_context_s *ctx, cJSON *item,
+                                const char *str)
 {
   const char *ptr = str + 1;
+  const char *end;
   char *ptr2;
   char *out;
   int len = 0;
@@ -268,22 +377,29 @@ static const char *parse_string(cJSON *item, const char *str)
       return 0;
     }
 
-  while (*ptr != '\"' && *ptr && ++len)
+  if (ctx->insitu)
     {
-      /* Skip escaped quotes. */
-
-      if (*ptr++ == '\\')
+      out = (char *)ptr;
+    }
+  else
+    {
+      while (*ptr != '\"' && *ptr && ++len)
         {
-          ptr++;
+          /* Skip escaped quotes. */
+
+          if (*ptr++ == '\\' && *ptr)
+            {
+              ptr++;
+            }
         }
-    }
 
-  /* This is how long we need for the string, roughly. */
+      /* This is how long we need for the string, roughly. */
 
-  out = (char *)cJSON_malloc(len + 1);
-  if (!out)
-    {
-      return 0;
+      out = (char *)parse_alloc(ctx, len + 1);
+      if (!out)
+        {
+          return 0;
+        }
     }
 
   ptr = str + 1;
@@ -294,6 +410,10 @@ static const char *parse_string(cJSON *item, const char *str)
         {
           *ptr2++ = *ptr++;
         }
+      else if (ptr[1] == '\0')
+        {
+          ptr++;
+        }
       else
         {
           ptr++;
@@ -323,7 +443,11 @@ static const char *parse_string(cJSON *item, const char *str)
               /* Transcode utf16 to utf8. */
               /* Get the unicode char. */
 
-              sscanf(ptr + 1, "%4x", &uc);
+              if (!parse_hex4(ptr + 1, &uc))
+                {
+                  goto errout;
+                }
+
               ptr += 4;
 
               /* Check for invalid. */
@@ -342,7 +466,11 @@ static const char *parse_string(cJSON *item, const char *str)
                       break;
                     }
 
-                  sscanf(ptr + 3, "%4x", &uc2);
+                  if (!parse_hex4(ptr + 3, &uc2))
+                    {
+                      goto errout;
+                    }
+
                   ptr += 6;
                   if (uc2 < 0xdc00 || uc2 > 0xdfff)
                     {
@@ -397,114 +525,25 @@ static const char *parse_string(cJSON *item, const char *str)
         }
     }
 
+  /* Note the end of the string before terminating the output, which may
+   * overwrite the closing quote when parsing in-situ.
+   */
+
+  end = (*ptr == '\"') ? ptr + 1 : ptr;
   *ptr2 = 0;
-  if (*ptr == '\"')
-    {
-      ptr++;
-    }
 
   item->valuestring = out;
   item->type = cJSON_String;
-  return ptr;
-}
-
-/* Render the cstring provided to an escaped version that can be printed. */
-
-static char *print_string_ptr(const char *str)
-{
-  const char *ptr;
-  char *ptr2, *out;
-  int len = 0;
-  unsigned char token;
-
-  if (!str)
-    {
-      return cJSON_strdup("");
-    }
-
-  ptr = str;
-  while ((token = *ptr) && ++len)
-    {
-      if (strchr("\"\\\b\f\n\r\t", token))
-        {
-          len++;
-        }
-      else if (token < 32)
-        {
-          len += 5;
-        }
+  return end;
 
-      ptr++;
-    }
-
-  out = (char *)cJSON_malloc(len + 3);
-  if (!out)
-    {
-      return 0;
-    }
-
-  ptr2 = out;
-  ptr = str;
-  *ptr2++ = '\"';
-  while (*ptr)
+errout:
+  if (!ctx->insitu && !ctx->arena)
     {
-      if ((unsigned char)*ptr > 31 && *ptr != '\"' && *ptr != '\\')
-        {
-          *ptr2++ = *ptr++;
-        }
-      else
-        {
-          *ptr2++ = '\\';
-          switch (token = *ptr++)
-            {
-            case '\\':
-              *ptr2++ = '\\';
-              break;
-
-            case '\"':
-              *ptr2++ = '\"';
-              break;
-
-            case '\b':
-              *ptr2++ = 'b';
-              break;
-
-            case '\f':
-              *ptr2++ = 'f';
-              break;
-
-            case '\n':
-              *ptr2++ = 'n';
-              break;
-
-            case '\r':
-              *ptr2++ = 'r';
-              break;
-
-            case '\t':
-              *ptr2++ = 't';
-              break;
-
-            default:
-              /* Escape and print */
-
-              sprintf(ptr2, "u%04x", token);
-              ptr2 += 5;
-              break;
-            }
-        }
+      cJSON_free(out);
     }
 
-  *ptr2++ = '\"';
-  *ptr2++ = 0;
-  return out;
-}
-
-/* Invote print_string_ptr (which is useful) on an item. */
-
-static char *print_string(cJSON *item)
-{
-  return print_string_ptr(item->valuestring);
+  ep = ptr;
+  return 0;
 }
 
 /* Utility to jump whitespace and cr/lf */
@@ -521,7 +560,8 @@ static const char *skip(const char *in)
 
 /* Parser core - when encountering text, process appropriately. */
 
-static const char *parse_value(cJSON *item, const char *value)
+static const char *parse_value(struct parse_context_s *ctx, cJSON *item,
+                               const char *value)
 {
   if (!value)
     {
@@ -551,7 +591,7 @@ static const char *parse_value(cJSON *item, const char *value)
 
   if (*value == '\"')
     {
-      return parse_string(item, value);
+      return parse_string(ctx, item, value);
     }
 
   if (*value == '-' || (*value >= '0' && *value <= '9'))
@@ -561,12 +601,12 @@ static const char *parse_value(cJSON *item, const char *value)
 
   if (*value == '[')
     {
-      return parse_array(item, value);
+      return parse_array(ctx, item, value);
     }
 
   if (*value == '{')
     {
-      return parse_object(item, value);
+      return parse_object(ctx, item, value);
     }
 
   /* Failure. */
@@ -575,53 +615,10 @@ static const char *parse_value(cJSON *item, const char *value)
   return 0;
 }
 
-/* Render a value to text. */
-
-static char *print_value(cJSON *item, int depth, int fmt)
-{
-  char *out = 0;
-  if (!item)
-    {
-      return 0;
-    }
-
-  switch ((item->type) & 255)
-    {
-    case cJSON_NULL:
-      out = cJSON_strdup("null");
-      break;
-
-    case cJSON_False:
-      out = cJSON_strdup("false");
-      break;
-
-    case cJSON_True:
-      out = cJSON_strdup("true");
-      break;
-
-    case cJSON_Number:
-      out = print_number(item);
-      break;
-
-    case cJSON_String:
-      out = print_string(item);
-      break;
-
-    case cJSON_Array:
-      out = print_array(item, depth, fmt);
-      break;
-
-    case cJSON_Object:
-      out = print_object(item, depth, fmt);
-      break;
-    }
-
-  return out;
-}
-
 /* Build an array from input text. */
 
-static const char *parse_array(cJSON *item, const char *value)
+static const char *parse_array(struct parse_context_s *ctx, cJSON *item,
+                               const char *value)
 {
   cJSON *child;
 
@@ -642,7 +639,7 @@ static const char *parse_array(cJSON *item, const char *value)
       return value + 1;
     }
 
-  item->child = child = cJSON_New_Item();
+  item->child = child = parse_new_item(ctx);
   if (!item->child)
     {
       /* Memory fail */
@@ -652,7 +649,7 @@ static const char *parse_array(cJSON *item, const char *value)
 
   /* Skip any spacing, get the value. */
 
-  value = skip(parse_value(child, skip(value)));
+  value = skip(parse_value(ctx, child, skip(value)));
   if (!value)
     {
       return 0;
@@ -661,9 +658,9 @@ static const char *parse_array(cJSON *item, const char *value)
   while (*value == ',')
     {
       cJSON *new_item;
-      if (!(new_item = cJSON_New_Item()))
+      if (!(new_item = parse_new_item(ctx)))
         {
-          /* <emory fail */
+          /* Memory fail */
 
           return 0;
         }
@@ -671,7 +668,7 @@ static const char *parse_array(cJSON *item, const char *value)
       child->next = new_item;
       new_item->prev = child;
       child = new_item;
-      value = skip(parse_value(child, skip(value + 1)));
+      value = skip(parse_value(ctx, child, skip(value + 1)));
       if (!value)
         {
           /* Memory fail */
@@ -693,117 +690,10 @@ static const char *parse_array(cJSON *item, const char *value)
   return 0;
 }
 
-/* Render an array to text */
-
-static char *print_array(cJSON *item, int depth, int fmt)
-{
-  char **entries;
-  char *out = 0;
-  char *ptr;
-  char *ret;
-  int len = 5;
-  cJSON *child = item->child;
-  int numentries = 0;
-  int i = 0;
-  int fail = 0;
-
-  /* How many entries in the array? */
-
-  while (child)
-    {
-      numentries++, child = child->next;
-    }
-
-  /* Allocate an array to hold the values for each */
-
-  entries = (char **)cJSON_malloc(numentries * sizeof(char *));
-  if (!entries)
-    {
-      return 0;
-    }
-
-  memset(entries, 0, numentries * sizeof(char *));
-
-  /* Retrieve all the results: */
-
-  child = item->child;
-  while (child && !fail)
-    {
-      ret = print_value(child, depth + 1, fmt);
-      entries[i++] = ret;
-      if (ret)
-        {
-          len += strlen(ret) + 2 + (fmt ? 1 : 0);
-        }
-      else
-        {
-          fail = 1;
-        }
-
-      child = child->next;
-    }
-
-  /* If we didn't fail, try to malloc the output string */
-
-  if (!fail)
-    {
-      out = (char *)cJSON_malloc(len);
-    }
-
-  /* If that fails, we fail. */
-
-  if (!out)
-    {
-      fail = 1;
-    }
-
-  /* Handle failure. */
-
-  if (fail)
-    {
-      for (i = 0; i < numentries; i++)
-        {
-          if (entries[i])
-            {
-              cJSON_free(entries[i]);
-            }
-        }
-
-      cJSON_free(entries);
-      return 0;
-    }
-
-  /* Compose the output array. */
-
-  *out = '[';
-  ptr = out + 1;
-  *ptr = 0;
-  for (i = 0; i < numentries; i++)
-    {
-      strcpy(ptr, entries[i]);
-      ptr += strlen(entries[i]);
-      if (i != numentries - 1)
-        {
-          *ptr++ = ',';
-          if (fmt)
-            {
-              *ptr++ = ' ';
-            }
-
-          *ptr = 0;
-        }
-      cJSON_free(entries[i]);
-    }
-
-  cJSON_free(entries);
-  *ptr++ = ']';
-  *ptr++ = 0;
-  return out;
-}
-
 /* Build an object from the text. */
 
-static const char *parse_object(cJSON *item, const char *value)
+static const char *parse_object(struct parse_context_s *ctx, cJSON *item,
+                                const char *value)
 {
   cJSON *child;
   if (*value != '{')
@@ -823,13 +713,13 @@ static const char *parse_object(cJSON *item, const char *value)
       return value + 1;
     }
 
-  item->child = child = cJSON_New_Item();
+  item->child = child = parse_new_item(ctx);
   if (!item->child)
     {
       return 0;
     }
 
-  value = skip(parse_string(child, skip(value)));
+  value = skip(parse_string(ctx, child, skip(value)));
   if (!value)
     {
       return 0;
@@ -845,7 +735,7 @@ static const char *parse_object(cJSON *item, const char *value)
 
    /* Skip any spacing, get the value. */
 
-  value = skip(parse_value(child, skip(value + 1)));
+  value = skip(parse_value(ctx, child, skip(value + 1)));
   if (!value)
     {
       return 0;
@@ -854,7 +744,7 @@ static const char *parse_object(cJSON *item, const char *value)
   while (*value == ',')
     {
       cJSON *new_item;
-      if (!(new_item = cJSON_New_Item()))
+      if (!(new_item = parse_new_item(ctx)))
         {
           /* Memory fail */
 
@@ -864,7 +754,7 @@ static const char *parse_object(cJSON *item, const char *value)
       child->next = new_item;
       new_item->prev = child;
       child = new_item;
-      value = skip(parse_string(child, skip(value + 1)));
+      value = skip(parse_string(ctx, child, skip(value + 1)));
       if (!value)
         {
           return 0;
@@ -880,7 +770,7 @@ static const char *parse_object(cJSON *item, const char *value)
 
      /* Skip any spacing, get the value. */
 
-      value = skip(parse_value(child, skip(value + 1)));
+      value = skip(parse_value(ctx, child, skip(value + 1)));
       if (!value)
         {
           return 0;
@@ -900,165 +790,940 @@ static const char *parse_object(cJSON *item, const char *value)
   return 0;
 }
 
-/* Render an object to text. */
+/* Parse a document into an arena, rolling the arena back on failure. */
 
-static char *print_object(cJSON *item, int depth, int fmt)
+static cJSON *parse_arena(cJSON_Arena *arena, const char *value, int insitu)
 {
-  char **entries = 0;
-  char **names = 0;
-  char *out = 0;
-  char *ptr;
-  char *ret;
-  char *str;
-  int len = 7;
-  int i = 0;
-  int j;
-  cJSON *child = item->child;
-  int numentries = 0;
-  int fail = 0;
+  struct parse_context_s ctx;
+  struct cJSON_ArenaBlock *blocks = arena->blocks;
+  char *region = arena->region;
+  size_t size = arena->size;
+  size_t used = arena->used;
+  cJSON *c;
 
-  /* Count the number of entries. */
+  ctx.arena  = arena;
+  ctx.insitu = insitu;
 
-  while (child)
+  ep = 0;
+  c = parse_new_item(&ctx);
+  if (c && parse_value(&ctx, c, skip(value)))
     {
-      numentries++, child = child->next;
+      return c;
     }
 
-  /* Allocate space for the names and the objects */
+  /* Release any blocks added by this parse and restore the arena */
 
-  entries = (char **)cJSON_malloc(numentries * sizeof(char *));
-  if (!entries)
+  while (arena->blocks != blocks)
     {
-      return 0;
+      struct cJSON_ArenaBlock *next = arena->blocks->next;
+      cJSON_free(arena->blocks);
+      arena->blocks = next;
     }
 
-  names = (char **)cJSON_malloc(numentries * sizeof(char *));
-  if (!names)
-    {
-      cJSON_free(entries);
-      return 0;
-    }
+  arena->region = region;
+  arena->size   = size;
+  arena->used   = used;
+  return 0;
+}
 
-  memset(entries, 0, sizeof(char *) * numentries);
-  memset(names, 0, sizeof(char *) * numentries);
+/* Buffered output.  All output goes through buf[] and is passed to the
+ * write function whenever the buffer fills.  After an error, all further
+ * output is discarded.
+ */
 
-  /* Collect all the results into our arrays: */
+static void writer_flushbuf(cJSON_Writer *writer)
+{
+  int ret;
 
-  child = item->child;
-  depth++;
-  if (fmt)
+  if (writer->len > 0 && !writer->error)
     {
-      len += depth;
+      ret = writer->writefn(writer->priv, writer->buf, writer->len);
+      if (ret != 0)
+        {
+          writer->error = ret;
+        }
     }
 
-  while (child)
+  writer->len = 0;
+}
+
+static void writer_put(cJSON_Writer *writer, const char *str, size_t len)
+{
+  size_t nbytes;
+
+  while (len > 0 && !writer->error)
     {
-      names[i] = str = print_string_ptr(child->string);
-      entries[i++] = ret = print_value(child, depth, fmt);
-      if (str && ret)
+      nbytes = sizeof(writer->buf) - writer->len;
+      if (nbytes > len)
         {
-          len += strlen(ret) + strlen(str) + 2 + (fmt ? 2 + depth : 0);
+          nbytes = len;
         }
-      else
+
+      memcpy(&writer->buf[writer->len], str, nbytes);
+      writer->len += nbytes;
+      str         += nbytes;
+      len         -= nbytes;
+
+      if (writer->len >= sizeof(writer->buf))
         {
-          fail = 1;
+          writer_flushbuf(writer);
         }
+    }
+}
 
-      child = child->next;
+static void writer_putc(cJSON_Writer *writer, char ch)
+{
+  if (writer->len >= sizeof(writer->buf))
+    {
+      writer_flushbuf(writer);
     }
 
-  /* Try to allocate the output string */
+  writer->buf[writer->len++] = ch;
+}
 
-  if (!fail)
+static void writer_tabs(cJSON_Writer *writer, int ntabs)
+{
+  while (ntabs-- > 0)
     {
-      out = (char *)cJSON_malloc(len);
+      writer_putc(writer, '\t');
     }
+}
+
+/* Render the number nicely. */
+
+static void writer_number(cJSON_Writer *writer, double d, int valueint)
+{
+  char str[64];
+  int len;
 
-  if (!out)
+  if (fabs(((double)valueint) - d) <= DBL_EPSILON) /* && d<=INT_MAX && d>=INT_MIN) */
+    {
+      len = snprintf(str, sizeof(str), "%d", valueint);
+    }
+  else if (fabs(floor(d) - d) <= DBL_EPSILON)
+    {
+      len = snprintf(str, sizeof(str), "%d", valueint);
+    }
+  else if (fabs(d) < 1.0e-6 || fabs(d) > 1.0e9)
     {
-      fail = 1;
+      len = snprintf(str, sizeof(str), "%e", d);
     }
+  else
+    {
+      len = snprintf(str, sizeof(str), " %f", d);
+    }
+
+  writer_put(writer, str, len);
+}
+
+/* Render the cstring provided to an escaped version that can be printed.
+ * Runs of characters that need no escaping are copied in one piece.
+ */
 
-  /* Handle failure */
+static void writer_string(cJSON_Writer *writer, const char *str)
+{
+  static const char hexdigits[] = "0123456789abcdef";
+  const char *run;
+  unsigned char token;
+  char esc[6];
 
-  if (fail)
+  writer_putc(writer, '\"');
+  while (str && *str)
     {
-      for (i = 0; i < numentries; i++)
+      run = str;
+      while ((unsigned char)*run > 31 && *run != '\"' && *run != '\\')
         {
-          if (names[i])
+          run++;
+        }
+
+      writer_put(writer, str, run - str);
+      if (*run == '\0')
+        {
+          break;
+        }
+
+      token  = *run;
+      str    = run + 1;
+      esc[0] = '\\';
+
+      switch (token)
+        {
+        case '\\':
+        case '\"':
+          esc[1] = token;
+          break;
+
+        case '\b':
+          esc[1] = 'b';
+          break;
+
+        case '\f':
+          esc[1] = 'f';
+          break;
+
+        case '\n':
+          esc[1] = 'n';
+          break;
+
+        case '\r':
+          esc[1] = 'r';
+          break;
+
+        case '\t':
+          esc[1] = 't';
+          break;
+
+        default:
+          /* Escape and print */
+
+          esc[1] = 'u';
+          esc[2] = '0';
+          esc[3] = '0';
+          esc[4] = hexdigits[token >> 4];
+          esc[5] = hexdigits[token & 15];
+          writer_put(writer, esc, 6);
+          continue;
+        }
+
+      writer_put(writer, esc, 2);
+    }
+
+  writer_putc(writer, '\"');
+}
+
+/* Render a value to text. */
+
+static void print_value(cJSON_Writer *writer, cJSON *item, int depth)
+{
+  switch ((item->type) & 255)
+    {
+    case cJSON_NULL:
+      writer_put(writer, "null", 4);
+      break;
+
+    case cJSON_False:
+      writer_put(writer, "false", 5);
+      break;
+
+    case cJSON_True:
+      writer_put(writer, "true", 4);
+      break;
+
+    case cJSON_Number:
+      writer_number(writer, item->valuedouble, item->valueint);
+      break;
+
+    case cJSON_String:
+      writer_string(writer, item->valuestring);
+      break;
+
+    case cJSON_Array:
+      print_array(writer, item, depth);
+      break;
+
+    case cJSON_Object:
+      print_object(writer, item, depth);
+      break;
+
+    default:
+      writer->error = -EINVAL;
+      break;
+    }
+}
+
+/* Render an array to text */
+
+static void print_array(cJSON_Writer *writer, cJSON *item, int depth)
+{
+  cJSON *child;
+
+  writer_putc(writer, '[');
+  for (child = item->child; child && !writer->error; child = child->next)
+    {
+      print_value(writer, child, depth + 1);
+      if (child->next)
+        {
+          writer_putc(writer, ',');
+          if (writer->fmt)
             {
-              cJSON_free(names[i]);
+              writer_putc(writer, ' ');
             }
+        }
+    }
+
+  writer_putc(writer, ']');
+}
+
+/* Render an object to text. */
+
+static void print_object(cJSON_Writer *writer, cJSON *item, int depth)
+{
+  cJSON *child;
+
+  depth++;
+  writer_putc(writer, '{');
+  if (writer->fmt)
+    {
+      writer_putc(writer, '\n');
+    }
+
+  for (child = item->child; child && !writer->error; child = child->next)
+    {
+      if (writer->fmt)
+        {
+          writer_tabs(writer, depth);
+        }
+
+      writer_string(writer, child->string);
+      writer_putc(writer, ':');
+      if (writer->fmt)
+        {
+          writer_putc(writer, '\t');
+        }
+
+      print_value(writer, child, depth);
+      if (child->next)
+        {
+          writer_putc(writer, ',');
+        }
+
+      if (writer->fmt)
+        {
+          writer_putc(writer, '\n');
+        }
+    }
+
+  if (writer->fmt)
+    {
+      writer_tabs(writer, depth - 1);
+    }
+
+  writer_putc(writer, '}');
+}
+
+/* Output function used to render into an allocated string.  The string
+ * grows by doubling, so a document needs only a few allocations (there is
+ * no realloc hook).
+ */
+
+static int print_grow(void *priv, const char *buf, size_t len)
+{
+  struct print_buffer_s *pb = (struct print_buffer_s *)priv;
+  size_t newsize;
+  char *newbuf;
+
+  if (pb->len + len + 1 > pb->size)
+    {
+      newsize = pb->size ? 2 * pb->size : PRINT_INITSIZE;
+      if (newsize < pb->len + len + 1)
+        {
+          newsize = pb->len + len + 1;
+        }
+
+      newbuf = (char *)cJSON_malloc(newsize);
+      if (!newbuf)
+        {
+          return -ENOMEM;
+        }
 
-          if (entries[i])
+      if (pb->buf)
+        {
+          memcpy(newbuf, pb->buf, pb->len);
+          cJSON_free(pb->buf);
+        }
+
+      pb->buf  = newbuf;
+      pb->size = newsize;
+    }
+
+  memcpy(&pb->buf[pb->len], buf, len);
+  pb->len += len;
+  return 0;
+}
+
+static char *print_alloc(cJSON *item, int fmt)
+{
+  struct print_buffer_s pb;
+  cJSON_Writer writer;
+
+  pb.buf  = 0;
+  pb.size = 0;
+  pb.len  = 0;
+
+  cJSON_WriterInit(&writer, print_grow, &pb, fmt);
+  if (cJSON_WriteItem(&writer, NULL, item) != 0 ||
+      cJSON_WriterFlush(&writer) != 0)
+    {
+      if (pb.buf)
+        {
+          cJSON_free(pb.buf);
+        }
+
+      return 0;
+    }
+
+  pb.buf[pb.len] = 0;
+  return pb.buf;
+}
+
+/* Output functions for cJSON_PrintFile() and cJSON_PrintFd() */
+
+static int print_file(void *priv, const char *buf, size_t len)
+{
+  return fwrite(buf, 1, len, (FILE *)priv) == len ? 0 : -EIO;
+}
+
+static int print_fd(void *priv, const char *buf, size_t len)
+{
+  int fd = (int)(intptr_t)priv;
+  ssize_t nwritten;
+
+  while (len > 0)
+    {
+      nwritten = write(fd, buf, len);
+      if (nwritten < 0)
+        {
+          if (errno == EINTR)
             {
-              cJSON_free(entries[i]);
+              continue;
             }
+
+          return -errno;
         }
 
-      cJSON_free(names);
-      cJSON_free(entries);
-      return 0;
+      buf += nwritten;
+      len -= nwritten;
     }
 
-  /* Compose the output: */
+  return 0;
+}
+
+/* Start a new value in the writer: emit the separator from the previous
+ * value and, inside an object, the member name.
+ */
 
-  *out = '{';
-  ptr = out + 1;
-  if (fmt)
+static int writer_member(cJSON_Writer *writer, const char *name)
+{
+  uint32_t bit;
+
+  if (writer->error || writer->depth == 0)
     {
-      *ptr++ = '\n';
+      return writer->error;
     }
-  *ptr = 0;
 
-  for (i = 0; i < numentries; i++)
+  bit = (uint32_t)1 << (writer->depth - 1);
+  if (writer->object & bit)
     {
-      if (fmt)
+      if (!name)
+        {
+          writer->error = -EINVAL;
+          return writer->error;
+        }
+
+      if (!(writer->empty & bit))
         {
-          for (j = 0; j < depth; j++)
+          writer_putc(writer, ',');
+          if (writer->fmt)
             {
-            *ptr++ = '\t';
+              writer_putc(writer, '\n');
             }
         }
 
-      strcpy(ptr, names[i]);
-      ptr += strlen(names[i]);
-      *ptr++ = ':';
-      if (fmt)
+      if (writer->fmt)
+        {
+          writer_tabs(writer, writer->depth);
+        }
+
+      writer_string(writer, name);
+      writer_putc(writer, ':');
+      if (writer->fmt)
         {
-          *ptr++ = '\t';
+          writer_putc(writer, '\t');
         }
+    }
+  else if (!(writer->empty & bit))
+    {
+      writer_putc(writer, ',');
+      if (writer->fmt)
+        {
+          writer_putc(writer, ' ');
+        }
+    }
+
+  writer->empty &= ~bit;
+  return writer->error;
+}
 
-      strcpy(ptr, entries[i]);
-      ptr += strlen(entries[i]);
-      if (i != numentries - 1)
+static int writer_begin(cJSON_Writer *writer, const char *name, int object)
+{
+  uint32_t bit;
+
+  if (writer_member(writer, name) != 0)
+    {
+      return writer->error;
+    }
+
+  if (writer->depth >= cJSON_MAXNESTING)
+    {
+      writer->error = -EINVAL;
+      return writer->error;
+    }
+
+  bit = (uint32_t)1 << writer->depth;
+  writer->depth++;
+  writer->empty |= bit;
+
+  if (object)
+    {
+      writer->object |= bit;
+      writer_putc(writer, '{');
+      if (writer->fmt)
         {
-          *ptr++ = ',';
+          writer_putc(writer, '\n');
         }
+    }
+  else
+    {
+      writer->object &= ~bit;
+      writer_putc(writer, '[');
+    }
+
+  return writer->error;
+}
 
-      if (fmt)
+static int writer_end(cJSON_Writer *writer, int object)
+{
+  uint32_t bit;
+
+  if (writer->error)
+    {
+      return writer->error;
+    }
+
+  if (writer->depth == 0)
+    {
+      writer->error = -EINVAL;
+      return writer->error;
+    }
+
+  bit = (uint32_t)1 << (writer->depth - 1);
+  if (!(writer->object & bit) != !object)
+    {
+      writer->error = -EINVAL;
+      return writer->error;
+    }
+
+  if (object)
+    {
+      if (writer->fmt)
         {
-          *ptr++ = '\n';
+          if (!(writer->empty & bit))
+            {
+              writer_putc(writer, '\n');
+            }
+
+          writer_tabs(writer, writer->depth - 1);
         }
 
-      *ptr = 0;
-      cJSON_free(names[i]);
-      cJSON_free(entries[i]);
+      writer_putc(writer, '}');
     }
+  else
+    {
+      writer_putc(writer, ']');
+    }
+
+  writer->depth--;
+  return writer->error;
+}
+
+/* Streaming parser helpers */
+
+static int sax_event(cJSON_SaxParser *parser, int event, const char *str,
+                     double number)
+{
+  const char *name = NULL;
+  int ret;
+
+  if (parser->depth > 0 &&
+      (parser->object & ((uint32_t)1 << (parser->depth - 1))) != 0 &&
+      event != cJSON_SaxEndObject && event != cJSON_SaxEndArray)
+    {
+      name = parser->name;
+    }
+
+  ret = parser->handler(parser->priv, event, name, str, number,
+                        parser->depth);
+  parser->state = SAX_NEXT;
+  return ret;
+}
+
+static int sax_putc(cJSON_SaxParser *parser, char ch)
+{
+  if (parser->toklen >= sizeof(parser->token) - 1)
+    {
+      return -E2BIG;
+    }
+
+  parser->token[parser->toklen++] = ch;
+  return 0;
+}
+
+/* Append a code point from a \u escape to the string as UTF-8 */
+
+static int sax_putuc(cJSON_SaxParser *parser, uint32_t uc)
+{
+  int len;
+  int ret = 0;
+
+  len = (uc < 0x80) ? 1 : (uc < 0x800) ? 2 : (uc < 0x10000) ? 3 : 4;
+  if (len == 1)
+    {
+      return sax_putc(parser, uc);
+    }
+
+  ret = sax_putc(parser, (uc >> (6 * (len - 1))) | firstByteMark[len]);
+  while (--len > 0 && ret == 0)
+    {
+      ret = sax_putc(parser, ((uc >> (6 * (len - 1))) & 0x3f) | 0x80);
+    }
+
+  return ret;
+}
 
-  cJSON_free(names);
-  cJSON_free(entries);
-  if (fmt)
+/* Handle the four hex digits of a \u escape, pairing UTF-16 surrogates.
+ * Invalid code points are dropped, as by cJSON_Parse().
+ */
+
+static int sax_unicode(cJSON_SaxParser *parser)
+{
+  uint32_t uc = parser->uc;
+  uint32_t hi = parser->hisurrogate;
+
+  parser->hisurrogate = 0;
+  if (uc >= 0xd800 && uc <= 0xdbff)
+    {
+      parser->hisurrogate = uc;
+      return 0;
+    }
+
+  if (uc >= 0xdc00 && uc <= 0xdfff)
     {
-      for (i = 0; i < depth - 1; i++)
+      if (!hi)
         {
-          *ptr++ = '\t';
+          return 0;
         }
+
+      uc = 0x10000 | ((hi & 0x3ff) << 10) | (uc & 0x3ff);
+    }
+  else if (uc == 0)
+    {
+      return 0;
     }
 
-  *ptr++ = '}';
-  *ptr++ = 0;
-  return out;
+  return sax_putuc(parser, uc);
+}
+
+/* Complete the string, number or literal in token[] */
+
+static int sax_endtoken(cJSON_SaxParser *parser)
+{
+  const char *end;
+  cJSON item;
+
+  parser->token[parser->toklen] = '\0';
+  switch (parser->state)
+    {
+    case SAX_STRING:
+      if (parser->inname)
+        {
+          memcpy(parser->name, parser->token, parser->toklen + 1);
+          parser->namelen = parser->toklen;
+          parser->inname  = 0;
+          parser->state   = SAX_COLON;
+          return 0;
+        }
+
+      return sax_event(parser, cJSON_SaxString, parser->token, 0);
+
+    case SAX_NUMBER:
+      end = parse_number(&item, parser->token);
+      if (*end != '\0' || strpbrk(parser->token, "0123456789") == NULL)
+        {
+          return -EINVAL;
+        }
+
+      return sax_event(parser, cJSON_SaxNumber, NULL, item.valuedouble);
+
+    case SAX_LITERAL:
+      if (strcmp(parser->token, "null") == 0)
+        {
+          return sax_event(parser, cJSON_SaxNull, NULL, 0);
+        }
+      else if (strcmp(parser->token, "false") == 0)
+        {
+          return sax_event(parser, cJSON_SaxFalse, NULL, 0);
+        }
+      else if (strcmp(parser->token, "true") == 0)
+        {
+          return sax_event(parser, cJSON_SaxTrue, NULL, 1);
+        }
+
+      return -EINVAL;
+
+    default:
+      return -EINVAL;
+    }
+}
+
+/* Begin a new array or object */
+
+static int sax_begin(cJSON_SaxParser *parser, int object)
+{
+  uint32_t bit;
+  int ret;
+
+  if (parser->depth >= cJSON_MAXNESTING)
+    {
+      return -EINVAL;
+    }
+
+  ret = sax_event(parser, object ? cJSON_SaxBeginObject : cJSON_SaxBeginArray,
+                  NULL, 0);
+
+  bit = (uint32_t)1 << parser->depth;
+  if (object)
+    {
+      parser->object |= bit;
+      parser->state   = SAX_NAME_OR_END;
+    }
+  else
+    {
+      parser->object &= ~bit;
+      parser->state   = SAX_VALUE_OR_END;
+    }
+
+  parser->depth++;
+  return ret;
+}
+
+static int sax_end(cJSON_SaxParser *parser, int object)
+{
+  parser->depth--;
+  return sax_event(parser, object ? cJSON_SaxEndObject : cJSON_SaxEndArray,
+                   NULL, 0);
+}
+
+/* Process one character of input */
+
+static int sax_char(cJSON_SaxParser *parser, char ch)
+{
+  int object;
+  int ret;
+
+  object = parser->depth > 0 &&
+           (parser->object & ((uint32_t)1 << (parser->depth - 1))) != 0;
+
+  switch (parser->state)
+    {
+    case SAX_VALUE_OR_END:
+      if (ch == ']')
+        {
+          return sax_end(parser, 0);
+        }
+
+      /* Fall through */
+
+    case SAX_VALUE:
+      if ((unsigned char)ch <= 32)
+        {
+          return 0;
+        }
+
+      parser->toklen = 0;
+      if (ch == '{' || ch == '[')
+        {
+          return sax_begin(parser, ch == '{');
+        }
+      else if (ch == '\"')
+        {
+          parser->state = SAX_STRING;
+          return 0;
+        }
+      else if (ch == '-' || (ch >= '0' && ch <= '9'))
+        {
+          parser->state = SAX_NUMBER;
+          return sax_putc(parser, ch);
+        }
+      else if (ch >= 'a' && ch <= 'z')
+        {
+          parser->state = SAX_LITERAL;
+          return sax_putc(parser, ch);
+        }
+
+      return -EINVAL;
+
+    case SAX_NAME_OR_END:
+      if (ch == '}')
+        {
+          return sax_end(parser, 1);
+        }
+
+      /* Fall through */
+
+    case SAX_NAME:
+      if ((unsigned char)ch <= 32)
+        {
+          return 0;
+        }
+
+      if (ch != '\"')
+        {
+          return -EINVAL;
+        }
+
+      parser->toklen = 0;
+      parser->inname = 1;
+      parser->state  = SAX_STRING;
+      return 0;
+
+    case SAX_COLON:
+      if ((unsigned char)ch <= 32)
+        {
+          return 0;
+        }
+
+      if (ch != ':')
+        {
+          return -EINVAL;
+        }
+
+      parser->state = SAX_VALUE;
+      return 0;
+
+    case SAX_NEXT:
+      if ((unsigned char)ch <= 32)
+        {
+          return 0;
+        }
+
+      if (parser->depth == 0)
+        {
+          /* Another top-level value */
+
+          parser->state = SAX_VALUE;
+          return sax_char(parser, ch);
+        }
+
+      if (ch == ',')
+        {
+          parser->state = object ? SAX_NAME : SAX_VALUE;
+          return 0;
+        }
+      else if (ch == (object ? '}' : ']'))
+        {
+          return sax_end(parser, object);
+        }
+
+      return -EINVAL;
+
+    case SAX_STRING:
+      if (ch == '\"')
+        {
+          parser->hisurrogate = 0;
+          return sax_endtoken(parser);
+        }
+      else if (ch == '\\')
+        {
+          parser->state = SAX_ESCAPE;
+          return 0;
+        }
+
+      parser->hisurrogate = 0;
+      return sax_putc(parser, ch);
+
+    case SAX_ESCAPE:
+      parser->state = SAX_STRING;
+      switch (ch)
+        {
+        case 'b':
+          ch = '\b';
+          break;
+
+        case 'f':
+          ch = '\f';
+          break;
+
+        case 'n':
+          ch = '\n';
+          break;
+
+        case 'r':
+          ch = '\r';
+          break;
+
+        case 't':
+          ch = '\t';
+          break;
+
+        case 'u':
+          parser->uc     = 0;
+          parser->ucount = 0;
+          parser->state  = SAX_UNICODE;
+          return 0;
+
+        default:
+          break;
+        }
+
+      parser->hisurrogate = 0;
+      return sax_putc(parser, ch);
+
+    case SAX_UNICODE:
+      if (ch >= '0' && ch <= '9')
+        {
+          parser->uc = (parser->uc << 4) | (ch - '0');
+        }
+      else if ((ch | 0x20) >= 'a' && (ch | 0x20) <= 'f')
+        {
+          parser->uc = (parser->uc << 4) | ((ch | 0x20) - 'a' + 10);
+        }
+      else
+        {
+          return -EINVAL;
+        }
+
+      if (++parser->ucount < 4)
+        {
+          return 0;
+        }
+
+      parser->state = SAX_STRING;
+      return sax_unicode(parser);
+
+    case SAX_NUMBER:
+      if ((ch >= '0' && ch <= '9') || ch == '.' || ch == 'e' || ch == 'E' ||
+          ch == '-' || ch == '+')
+        {
+          return sax_putc(parser, ch);
+        }
+
+      /* The number ends here; process this character as what follows */
+
+      ret = sax_endtoken(parser);
+      return ret != 0 ? ret : sax_char(parser, ch);
+
+    case SAX_LITERAL:
+      if (ch >= 'a' && ch <= 'z')
+        {
+          return sax_putc(parser, ch);
+        }
+
+      ret = sax_endtoken(parser);
+      return ret != 0 ? ret : sax_char(parser, ch);
+
+    default:
+      return -EINVAL;
+    }
 }
 
 /* Utility for array list handling. */
@@ -1142,7 +1807,9 @@ void cJSON_Delete(cJSON *c)
 
 cJSON *cJSON_Parse(const char *value)
 {
+  struct parse_context_s ctx;
   cJSON *c = cJSON_New_Item();
+
   ep = 0;
   if (!c)
     {
@@ -1151,7 +1818,10 @@ cJSON *cJSON_Parse(const char *value)
       return 0;
     }
 
-  if (!parse_value(c, skip(value)))
+  ctx.arena  = 0;
+  ctx.insitu = 0;
+
+  if (!parse_value(&ctx, c, skip(value)))
     {
       cJSON_Delete(c);
       return 0;
@@ -1160,16 +1830,256 @@ cJSON *cJSON_Parse(const char *value)
   return c;
 }
 
+/* Parse into an arena, copying strings or decoding them in place. */
+
+cJSON *cJSON_ParseArena(cJSON_Arena *arena, const char *value)
+{
+  return parse_arena(arena, value, 0);
+}
+
+cJSON *cJSON_ParseInSitu(cJSON_Arena *arena, char *value)
+{
+  return parse_arena(arena, value, 1);
+}
+
+/* Arena management */
+
+void cJSON_InitArena(cJSON_Arena *arena, void *buffer, size_t size,
+                     size_t blocksize)
+{
+  uintptr_t addr = (uintptr_t)buffer;
+  size_t pad = 0;
+
+  /* Align the start of the caller's buffer */
+
+  if (buffer)
+    {
+      pad = ARENA_ROUNDUP(addr) - addr;
+    }
+
+  memset(arena, 0, sizeof(cJSON_Arena));
+  if (buffer && size > pad)
+    {
+      arena->initbuf  = (char *)buffer + pad;
+      arena->initsize = size - pad;
+    }
+
+  arena->region    = arena->initbuf;
+  arena->size      = arena->initsize;
+  arena->blocksize = blocksize;
+}
+
+void cJSON_ResetArena(cJSON_Arena *arena)
+{
+  struct cJSON_ArenaBlock *next;
+
+  while (arena->blocks)
+    {
+      next = arena->blocks->next;
+      cJSON_free(arena->blocks);
+      arena->blocks = next;
+    }
+
+  arena->region = arena->initbuf;
+  arena->size   = arena->initsize;
+  arena->used   = 0;
+}
+
+/* Streaming parser */
+
+void cJSON_SaxInit(cJSON_SaxParser *parser, cJSON_SaxHandler handler,
+                   void *priv)
+{
+  memset(parser, 0, sizeof(cJSON_SaxParser));
+  parser->handler = handler;
+  parser->priv    = priv;
+  parser->state   = SAX_VALUE;
+}
+
+int cJSON_SaxFeed(cJSON_SaxParser *parser, const char *text, size_t len)
+{
+  int ret;
+
+  for (; len > 0; len--, text++)
+    {
+      if (parser->state == SAX_ERROR)
+        {
+          return -EINVAL;
+        }
+
+      ret = sax_char(parser, *text);
+      if (ret != 0)
+        {
+          parser->state = SAX_ERROR;
+          return ret;
+        }
+
+      parser->offset++;
+    }
+
+  return 0;
+}
+
+int cJSON_SaxFinish(cJSON_SaxParser *parser)
+{
+  int ret;
+
+  /* A number or literal at the very end of the input is only complete
+   * now.
+   */
+
+  if (parser->state == SAX_NUMBER || parser->state == SAX_LITERAL)
+    {
+      ret = sax_endtoken(parser);
+      if (ret != 0)
+        {
+          parser->state = SAX_ERROR;
+          return ret;
+        }
+    }
+
+  if (parser->depth != 0 ||
+      (parser->state != SAX_NEXT && parser->state != SAX_VALUE))
+    {
+      parser->state = SAX_ERROR;
+      return -EINVAL;
+    }
+
+  return 0;
+}
+
 /* Render a cJSON item/entity/structure to text. */
 
 char *cJSON_Print(cJSON *item)
 {
-  return print_value(item, 0, 1);
+  return print_alloc(item, 1);
 }
 
 char *cJSON_PrintUnformatted(cJSON *item)
 {
-  return print_value(item, 0, 0);
+  return print_alloc(item, 0);
+}
+
+int cJSON_PrintStream(cJSON *item, int fmt, cJSON_WriteFn writefn,
+                      void *priv)
+{
+  cJSON_Writer writer;
+
+  cJSON_WriterInit(&writer, writefn, priv, fmt);
+  cJSON_WriteItem(&writer, NULL, item);
+  return cJSON_WriterFlush(&writer);
+}
+
+int cJSON_PrintFile(cJSON *item, FILE *stream, int fmt)
+{
+  return cJSON_PrintStream(item, fmt, print_file, stream);
+}
+
+int cJSON_PrintFd(cJSON *item, int fd, int fmt)
+{
+  return cJSON_PrintStream(item, fmt, print_fd, (void *)(intptr_t)fd);
+}
+
+/* Generate JSON text directly. */
+
+void cJSON_WriterInit(cJSON_Writer *writer, cJSON_WriteFn writefn,
+                      void *priv, int fmt)
+{
+  writer->writefn = writefn;
+  writer->priv    = priv;
+  writer->object  = 0;
+  writer->empty   = 0;
+  writer->depth   = 0;
+  writer->fmt     = fmt;
+  writer->error   = 0;
+  writer->len     = 0;
+}
+
+int cJSON_WriteBeginObject(cJSON_Writer *writer, const char *name)
+{
+  return writer_begin(writer, name, 1);
+}
+
+int cJSON_WriteEndObject(cJSON_Writer *writer)
+{
+  return writer_end(writer, 1);
+}
+
+int cJSON_WriteBeginArray(cJSON_Writer *writer, const char *name)
+{
+  return writer_begin(writer, name, 0);
+}
+
+int cJSON_WriteEndArray(cJSON_Writer *writer)
+{
+  return writer_end(writer, 0);
+}
+
+int cJSON_WriteNull(cJSON_Writer *writer, const char *name)
+{
+  if (writer_member(writer, name) == 0)
+    {
+      writer_put(writer, "null", 4);
+    }
+
+  return writer->error;
+}
+
+int cJSON_WriteBool(cJSON_Writer *writer, const char *name, int b)
+{
+  if (writer_member(writer, name) == 0)
+    {
+      writer_put(writer, b ? "true" : "false", b ? 4 : 5);
+    }
+
+  return writer->error;
+}
+
+int cJSON_WriteNumber(cJSON_Writer *writer, const char *name, double num)
+{
+  if (writer_member(writer, name) == 0)
+    {
+      writer_number(writer, num, (int)num);
+    }
+
+  return writer->error;
+}
+
+int cJSON_WriteString(cJSON_Writer *writer, const char *name,
+                      const char *string)
+{
+  if (writer_member(writer, name) == 0)
+    {
+      writer_string(writer, string);
+    }
+
+  return writer->error;
+}
+
+int cJSON_WriteItem(cJSON_Writer *writer, const char *name, cJSON *item)
+{
+  if (!item)
+    {
+      if (!writer->error)
+        {
+          writer->error = -EINVAL;
+        }
+
+      return writer->error;
+    }
+
+  if (writer_member(writer, name) == 0)
+    {
+      print_value(writer, item, writer->depth);
+    }
+
+  return writer->error;
+}
+
+int cJSON_WriterFlush(cJSON_Writer *writer)
+{
+  writer_flushbuf(writer);
+  return writer->error;
 }
 
 /* Get Array size/item / object item. */
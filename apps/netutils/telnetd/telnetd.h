@@ -42,14 +42,47 @@
 
 #include <nuttx/config.h>
 
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <semaphore.h>
+
+#include <apps/netutils/telnetd.h>
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
+/* Configuration ************************************************************/
+
+#ifdef CONFIG_TELNETD_POOL
+   /* CONFIG_TELNETD_NWORKERS and CONFIG_TELNETD_QUEUESIZE defaults are
+    * provided by apps/netutils/telnetd.h.
+    *
+    * The number of accepted connections that may be pending: one for each
+    * worker plus the configured backlog.
+    */
+
+#  define TELNETD_NPENDING (CONFIG_TELNETD_NWORKERS + CONFIG_TELNETD_QUEUESIZE)
+#endif
 
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
+#ifdef CONFIG_TELNETD_POOL
+/* This structure describes one pre-created session worker */
+
+struct telnetd_s;
+struct telnetd_worker_s
+{
+  FAR struct telnetd_s *daemon;    /* The daemon that owns this worker */
+  pid_t                 pid;       /* Task ID of the worker (0 if not running) */
+  bool                  busy;      /* True: The worker is serving a session */
+  uint32_t              nsessions; /* Number of sessions served by this worker */
+  uint32_t              ticks;     /* Total session time (system ticks) */
+};
+#endif
+
 /* This structure represents the overall state of one telnet daemon instance
  * (Yes, multiple telnet daemons are supported).
  */
@@ -61,6 +94,26 @@ struct telnetd_s
   int                   stacksize; /* The stack size needed by the spawned task */
   main_t                entry;     /* The entrypoint of the task to spawn when a new
                                     * connection is accepted. */
+#ifdef CONFIG_TELNETD_POOL
+  FAR struct telnetd_s *flink;     /* Supports a list of pooled daemons */
+  pid_t                 pid;       /* Task ID of the daemon */
+  sem_t                 exclsem;   /* Enforces exclusive access to the pool */
+  sem_t                 worksem;   /* Counts connections waiting for a worker */
+  sem_t                 startsem;  /* Worker start-up handshake */
+  bool                  stopping;  /* True: The daemon has terminated */
+  uint8_t               nworkers;  /* Number of worker tasks running */
+  uint8_t               nbusy;     /* Number of workers serving a session */
+  uint8_t               npending;  /* Number of connections in pending[] */
+  uint8_t               head;      /* Index of the oldest pending connection */
+  uint8_t               peak;      /* Maximum concurrent sessions observed */
+  uint32_t              nsessions; /* Total number of sessions accepted */
+  uint32_t              nrefused;  /* Total number of connections refused */
+
+  /* Session workers and the devpaths of connections waiting for them */
+
+  struct telnetd_worker_s workers[CONFIG_TELNETD_NWORKERS];
+  FAR char             *pending[TELNETD_NPENDING];
+#endif
 };
 
 /* This structure is used to passed information to telnet daemon when it
@@ -74,6 +127,10 @@ struct telnetd_common_s
   sem_t                 exclsem;   /* Enforces exclusive access to 'minor' */
   FAR struct telnetd_s *daemon;    /* Describes the new daemon */
   int                   minor;     /* The next minor number to use */
+#ifdef CONFIG_TELNETD_POOL
+  FAR struct telnetd_s *pools;     /* List of daemons with session workers */
+  FAR struct telnetd_worker_s *worker; /* Describes the new worker */
+#endif
 };
 
 /****************************************************************************
@@ -43,8 +43,10 @@
 #include <sys/socket.h>
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <semaphore.h>
@@ -53,6 +55,8 @@
 #include <debug.h>
 #include <netinet/in.h>
 
+#include <nuttx/clock.h>
+
 #include <apps/netutils/telnetd.h>
 #include <apps/netutils/netlib.h>
 
@@ -76,6 +80,476 @@
 
 struct telnetd_common_s g_telnetdcommon;
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_TELNETD_POOL
+/****************************************************************************
+ * Name: telnetd_takesem
+ ****************************************************************************/
+
+static void telnetd_takesem(FAR sem_t *sem)
+{
+  while (sem_wait(sem) < 0)
+    {
+      /* The only case that an error should occur here is if the wait was
+       * awakened by a signal.
+       */
+
+      DEBUGASSERT(errno == EINTR);
+    }
+}
+
+/****************************************************************************
+ * Name: telnetd_closefds
+ *
+ * Description:
+ *   Close every file and socket descriptor held by the calling worker:  The
+ *   descriptors inherited from the daemon when the worker is created and
+ *   anything that a session leaves open when it returns.
+ *
+ ****************************************************************************/
+
+static void telnetd_closefds(void)
+{
+  int fd;
+
+  (void)fflush(stdout);
+  (void)fflush(stderr);
+
+  for (fd = 0; fd < CONFIG_NFILE_DESCRIPTORS + CONFIG_NSOCKET_DESCRIPTORS; fd++)
+    {
+      (void)close(fd);
+    }
+}
+
+/****************************************************************************
+ * Name: telnetd_freedaemon
+ *
+ * Description:
+ *   Free a terminated daemon after its last worker has exited.  Telnet
+ *   drivers created for connections that were never served are released
+ *   too:  A driver is unregistered when its last reference is closed.
+ *
+ ****************************************************************************/
+
+static void telnetd_freedaemon(FAR struct telnetd_s *daemon)
+{
+  FAR struct telnetd_s *prev;
+  FAR struct telnetd_s *curr;
+  int fd;
+  int i;
+
+  /* Remove the daemon from the list of pooled daemons */
+
+  telnetd_takesem(&g_telnetdcommon.exclsem);
+  for (prev = NULL, curr = g_telnetdcommon.pools;
+       curr && curr != daemon;
+       prev = curr, curr = curr->flink);
+
+  if (curr)
+    {
+      if (prev)
+        {
+          prev->flink = curr->flink;
+        }
+      else
+        {
+          g_telnetdcommon.pools = curr->flink;
+        }
+    }
+
+  sem_post(&g_telnetdcommon.exclsem);
+
+  /* Release the drivers of any pending connections */
+
+  for (i = 0; i < TELNETD_NPENDING; i++)
+    {
+      if (daemon->pending[i])
+        {
+          fd = open(daemon->pending[i], O_RDWR);
+          if (fd >= 0)
+            {
+              close(fd);
+            }
+
+          free(daemon->pending[i]);
+        }
+    }
+
+  sem_destroy(&daemon->exclsem);
+  sem_destroy(&daemon->worksem);
+  sem_destroy(&daemon->startsem);
+  free(daemon);
+}
+
+/****************************************************************************
+ * Name: telnetd_workerexit
+ *
+ * Description:
+ *   atexit() handler of a session worker.  The worker is removed from its
+ *   pool whether it returned normally (because the daemon terminated) or a
+ *   session called exit().  The daemon replaces missing workers when the
+ *   next connection is accepted.
+ *
+ ****************************************************************************/
+
+static void telnetd_workerexit(void)
+{
+  FAR struct telnetd_worker_s *worker = NULL;
+  FAR struct telnetd_s *daemon;
+  pid_t pid = getpid();
+  bool last;
+  int i;
+
+  /* Find the worker structure of this task */
+
+  telnetd_takesem(&g_telnetdcommon.exclsem);
+  for (daemon = g_telnetdcommon.pools; daemon && !worker; daemon = daemon->flink)
+    {
+      for (i = 0; i < CONFIG_TELNETD_NWORKERS; i++)
+        {
+          if (daemon->workers[i].pid == pid)
+            {
+              worker = &daemon->workers[i];
+              break;
+            }
+        }
+    }
+
+  sem_post(&g_telnetdcommon.exclsem);
+  if (!worker)
+    {
+      return;
+    }
+
+  /* And remove it from the pool */
+
+  daemon = worker->daemon;
+  telnetd_takesem(&daemon->exclsem);
+
+  if (worker->busy)
+    {
+      daemon->nbusy--;
+      worker->busy = false;
+    }
+
+  worker->pid = 0;
+  daemon->nworkers--;
+  last = (daemon->stopping && daemon->nworkers == 0);
+  sem_post(&daemon->exclsem);
+
+  /* The last worker of a terminated daemon frees the daemon */
+
+  if (last)
+    {
+      telnetd_freedaemon(daemon);
+    }
+}
+
+/****************************************************************************
+ * Name: telnetd_worker
+ *
+ * Description:
+ *   A pre-created session worker.  It waits for a connection to be queued
+ *   by the daemon, runs the session entry point with the Telnet driver as
+ *   stdin, stdout, and stderr, then cleans up and waits for the next
+ *   connection.
+ *
+ ****************************************************************************/
+
+static int telnetd_worker(int argc, char *argv[])
+{
+  FAR struct telnetd_worker_s *worker;
+  FAR struct telnetd_s *daemon;
+  FAR char *sargv[2];
+  FAR char *devpath;
+  uint32_t start;
+  int drvrfd;
+  int ret;
+
+  /* Get worker startup info */
+
+  worker      = g_telnetdcommon.worker;
+  daemon      = worker->daemon;
+  worker->pid = getpid();
+  (void)atexit(telnetd_workerexit);
+  sem_post(&daemon->startsem);
+
+  /* Drop the descriptors and environment inherited from the daemon so that
+   * every session starts in the same state.
+   */
+
+  telnetd_closefds();
+#ifndef CONFIG_DISABLE_ENVIRON
+  (void)clearenv();
+#endif
+
+  sargv[0] = "Telnet session";
+  sargv[1] = NULL;
+
+  for (;;)
+    {
+      /* Wait for a connection */
+
+      telnetd_takesem(&daemon->worksem);
+      telnetd_takesem(&daemon->exclsem);
+
+      if (daemon->stopping)
+        {
+          sem_post(&daemon->exclsem);
+          break;
+        }
+
+      devpath = daemon->pending[daemon->head];
+      daemon->pending[daemon->head] = NULL;
+
+      if (++daemon->head >= TELNETD_NPENDING)
+        {
+          daemon->head = 0;
+        }
+
+      daemon->npending--;
+      daemon->nbusy++;
+      worker->busy = true;
+
+      if (daemon->nbusy > daemon->peak)
+        {
+          daemon->peak = daemon->nbusy;
+        }
+
+      sem_post(&daemon->exclsem);
+
+      /* Open the driver and use it as stdin, stdout, and stderror */
+
+      drvrfd = open(devpath, O_RDWR);
+      if (drvrfd < 0)
+        {
+          nlldbg("Failed to open %s: %d\n", devpath, errno);
+        }
+      else
+        {
+          (void)dup2(drvrfd, 0);
+          (void)dup2(drvrfd, 1);
+          (void)dup2(drvrfd, 2);
+
+          if (drvrfd > 2)
+            {
+              close(drvrfd);
+            }
+
+          clearerr(stdin);
+
+          /* Run the session */
+
+          nllvdbg("Starting the telnet session on %s\n", devpath);
+          start = clock_systimer();
+          ret   = daemon->entry(1, sargv);
+
+          /* Release everything that the session left behind.  Closing the
+           * last reference to the driver closes the connection.
+           */
+
+          telnetd_closefds();
+#ifndef CONFIG_DISABLE_ENVIRON
+          (void)clearenv();
+#endif
+
+          worker->nsessions++;
+          worker->ticks += clock_systimer() - start;
+
+          nllvdbg("Session ended: status=%d sessions=%lu ticks=%lu\n",
+                  ret, (unsigned long)worker->nsessions,
+                  (unsigned long)worker->ticks);
+          UNUSED(ret);
+        }
+
+      free(devpath);
+
+      telnetd_takesem(&daemon->exclsem);
+      daemon->nbusy--;
+      worker->busy = false;
+      sem_post(&daemon->exclsem);
+    }
+
+  /* telnetd_workerexit() will remove this worker from the pool */
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: telnetd_startworkers
+ *
+ * Description:
+ *   Start a worker in each unused worker slot.  This is called when the
+ *   daemon starts and again before each connection is admitted in order
+ *   to replace workers that exited.
+ *
+ * Return:
+ *   The number of workers running.
+ *
+ ****************************************************************************/
+
+static int telnetd_startworkers(FAR struct telnetd_s *daemon)
+{
+  FAR struct telnetd_worker_s *worker;
+  pid_t pid;
+  int i;
+
+  for (i = 0; i < CONFIG_TELNETD_NWORKERS; i++)
+    {
+      worker = &daemon->workers[i];
+      if (worker->pid != 0)
+        {
+          continue;
+        }
+
+      /* The worker is described to the new task through g_telnetdcommon.
+       * Hold exclsem until the new task has picked up the description.
+       */
+
+      telnetd_takesem(&g_telnetdcommon.exclsem);
+      worker->daemon         = daemon;
+      g_telnetdcommon.worker = worker;
+
+      pid = task_create("Telnet worker", daemon->priority,
+                        daemon->stacksize, telnetd_worker, NULL);
+      if (pid < 0)
+        {
+          nlldbg("Failed to start a telnet worker: %d\n", errno);
+        }
+      else
+        {
+          telnetd_takesem(&daemon->startsem);
+
+          telnetd_takesem(&daemon->exclsem);
+          daemon->nworkers++;
+          sem_post(&daemon->exclsem);
+        }
+
+      g_telnetdcommon.worker = NULL;
+      sem_post(&g_telnetdcommon.exclsem);
+    }
+
+  return daemon->nworkers;
+}
+
+/****************************************************************************
+ * Name: telnetd_admit
+ *
+ * Description:
+ *   Decide if a new connection can be served.  A connection is accepted if
+ *   a worker is idle or if there is space in the queue of connections
+ *   waiting for a worker.
+ *
+ ****************************************************************************/
+
+static bool telnetd_admit(FAR struct telnetd_s *daemon)
+{
+  bool admit;
+
+  (void)telnetd_startworkers(daemon);
+
+  telnetd_takesem(&daemon->exclsem);
+  admit = (daemon->nworkers > 0 &&
+           daemon->nbusy + daemon->npending <
+           daemon->nworkers + CONFIG_TELNETD_QUEUESIZE);
+
+  if (admit)
+    {
+      daemon->nsessions++;
+    }
+  else
+    {
+      daemon->nrefused++;
+    }
+
+  sem_post(&daemon->exclsem);
+  return admit;
+}
+
+/****************************************************************************
+ * Name: telnetd_enqueue
+ *
+ * Description:
+ *   Queue the path of the driver of an admitted connection and wake up a
+ *   worker.
+ *
+ ****************************************************************************/
+
+static void telnetd_enqueue(FAR struct telnetd_s *daemon, FAR char *devpath)
+{
+  int ndx;
+
+  telnetd_takesem(&daemon->exclsem);
+  DEBUGASSERT(daemon->npending < TELNETD_NPENDING);
+
+  ndx = daemon->head + daemon->npending;
+  if (ndx >= TELNETD_NPENDING)
+    {
+      ndx -= TELNETD_NPENDING;
+    }
+
+  daemon->pending[ndx] = devpath;
+  daemon->npending++;
+  sem_post(&daemon->exclsem);
+
+  sem_post(&daemon->worksem);
+}
+
+/****************************************************************************
+ * Name: telnetd_refuse
+ *
+ * Description:
+ *   Tell the peer that no session is available and close the connection.
+ *
+ ****************************************************************************/
+
+static void telnetd_refuse(FAR struct telnetd_s *daemon, int sd)
+{
+  static const char msg[] = "Too many telnet sessions, try again later\r\n";
+
+  nllvdbg("Refusing connection: busy=%d pending=%d refused=%lu\n",
+          daemon->nbusy, daemon->npending, (unsigned long)daemon->nrefused);
+
+  (void)send(sd, msg, sizeof(msg) - 1, 0);
+  close(sd);
+}
+
+/****************************************************************************
+ * Name: telnetd_stop
+ *
+ * Description:
+ *   Terminate the worker pool of a daemon that is exiting.  Idle workers
+ *   exit immediately; busy workers exit when their session ends.  The
+ *   daemon structure is freed when the last worker has exited.
+ *
+ ****************************************************************************/
+
+static void telnetd_stop(FAR struct telnetd_s *daemon)
+{
+  int nworkers;
+  int i;
+
+  telnetd_takesem(&daemon->exclsem);
+  daemon->stopping = true;
+  nworkers = daemon->nworkers;
+  sem_post(&daemon->exclsem);
+
+  if (nworkers == 0)
+    {
+      telnetd_freedaemon(daemon);
+      return;
+    }
+
+  for (i = 0; i < nworkers; i++)
+    {
+      sem_post(&daemon->worksem);
+    }
+}
+#endif /* CONFIG_TELNETD_POOL */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -104,10 +578,12 @@ static int telnetd_daemon(int argc, char *argv[])
 #endif
   socklen_t addrlen;
   FAR char *devpath;
+#ifndef CONFIG_TELNETD_POOL
   pid_t pid;
+  int drvrfd;
+#endif
   int listensd;
   int acceptsd;
-  int drvrfd;
 #ifdef CONFIG_NET_HAVE_REUSEADDR
   int optval;
 #endif
@@ -171,6 +647,22 @@ static int telnetd_daemon(int argc, char *argv[])
   close(2);
 #endif
 
+#ifdef CONFIG_TELNETD_POOL
+  /* Start the session workers */
+
+  telnetd_takesem(&g_telnetdcommon.exclsem);
+  daemon->pid           = getpid();
+  daemon->flink         = g_telnetdcommon.pools;
+  g_telnetdcommon.pools = daemon;
+  sem_post(&g_telnetdcommon.exclsem);
+
+  if (telnetd_startworkers(daemon) < 1)
+    {
+      nlldbg("No telnet workers\n");
+      goto errout_with_socket;
+    }
+#endif
+
   /* Begin accepting connections */
 
   for (;;)
@@ -197,6 +689,18 @@ static int telnetd_daemon(int argc, char *argv[])
         }
 #endif
 
+#ifdef CONFIG_TELNETD_POOL
+      /* Refuse the connection if every worker is busy and the queue of
+       * waiting connections is full.
+       */
+
+      if (!telnetd_admit(daemon))
+        {
+          telnetd_refuse(daemon, acceptsd);
+          continue;
+        }
+#endif
+
       /* Create a character device to "wrap" the accepted socket descriptor */
 
       nllvdbg("Creating the telnet driver\n");
@@ -207,6 +711,13 @@ static int telnetd_daemon(int argc, char *argv[])
           goto errout_with_acceptsd;
         }
 
+#ifdef CONFIG_TELNETD_POOL
+      /* Hand the connection to the next available worker.  The worker
+       * opens the driver and frees the driver string.
+       */
+
+      telnetd_enqueue(daemon, devpath);
+#else
       /* Open the driver */
 
       nllvdbg("Opening the telnet driver\n");
@@ -252,6 +763,7 @@ static int telnetd_daemon(int argc, char *argv[])
       close(0);
       close(1);
       close(2);
+#endif
     }
 
 errout_with_acceptsd:
@@ -259,7 +771,11 @@ errout_with_acceptsd:
 
 errout_with_socket:
   close(listensd);
+#ifdef CONFIG_TELNETD_POOL
+  telnetd_stop(daemon);
+#else
   free(daemon);
+#endif
   return 1;
 }
 
@@ -294,7 +810,7 @@ int telnetd_start(FAR struct telnetd_config_s *config)
 
   /* Allocate a state structure for the new daemon */
 
-  daemon = (FAR struct telnetd_s *)malloc(sizeof(struct telnetd_s));
+  daemon = (FAR struct telnetd_s *)zalloc(sizeof(struct telnetd_s));
   if (!daemon)
     {
       return -ENOMEM;
@@ -307,6 +823,12 @@ int telnetd_start(FAR struct telnetd_config_s *config)
   daemon->stacksize = config->t_stacksize;
   daemon->entry     = config->t_entry;
 
+#ifdef CONFIG_TELNETD_POOL
+  sem_init(&daemon->exclsem, 0, 1);
+  sem_init(&daemon->worksem, 0, 0);
+  sem_init(&daemon->startsem, 0, 0);
+#endif
+
   /* Initialize the common structure if this is the first daemon */
 
   if (g_telnetdcommon.ndaemons < 1)
@@ -324,6 +846,11 @@ int telnetd_start(FAR struct telnetd_config_s *config)
   if (pid < 0)
     {
       int errval = errno;
+#ifdef CONFIG_TELNETD_POOL
+      sem_destroy(&daemon->exclsem);
+      sem_destroy(&daemon->worksem);
+      sem_destroy(&daemon->startsem);
+#endif
       free(daemon);
       ndbg("Failed to start the telnet daemon: %d\n", errval);
       return -errval;
@@ -350,3 +877,67 @@ int telnetd_start(FAR struct telnetd_config_s *config)
 
   return pid;
 }
+
+/****************************************************************************
+ * Name: telnetd_getstats
+ *
+ * Description:
+ *   Return the session statistics of a pooled Telnet daemon.
+ *
+ * Parameters:
+ *   pid       The process ID of the daemon, as returned by telnetd_start
+ *   stats     The location to return the statistics
+ *
+ * Return:
+ *   Zero is returned on success.  A negated errno value is returned on
+ *   failure:  -ESRCH if there is no pooled daemon with this process ID.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_TELNETD_POOL
+int telnetd_getstats(pid_t pid, FAR struct telnetd_stats_s *stats)
+{
+  FAR struct telnetd_worker_s *worker;
+  FAR struct telnetd_s *daemon;
+  int i;
+
+  if (!stats)
+    {
+      return -EINVAL;
+    }
+
+  /* Find the daemon.  The daemon cannot be freed while exclsem is held. */
+
+  telnetd_takesem(&g_telnetdcommon.exclsem);
+  for (daemon = g_telnetdcommon.pools;
+       daemon && daemon->pid != pid;
+       daemon = daemon->flink);
+
+  if (!daemon)
+    {
+      sem_post(&g_telnetdcommon.exclsem);
+      return -ESRCH;
+    }
+
+  telnetd_takesem(&daemon->exclsem);
+  stats->sessions = daemon->nsessions;
+  stats->refused  = daemon->nrefused;
+  stats->workers  = daemon->nworkers;
+  stats->active   = daemon->nbusy;
+  stats->queued   = daemon->npending;
+  stats->peak     = daemon->peak;
+
+  for (i = 0; i < CONFIG_TELNETD_NWORKERS; i++)
+    {
+      worker = &daemon->workers[i];
+      stats->worker[i].sessions = worker->nsessions;
+      stats->worker[i].ticks    = worker->ticks;
+      stats->worker[i].running  = (worker->pid != 0);
+      stats->worker[i].busy     = worker->busy;
+    }
+
+  sem_post(&daemon->exclsem);
+  sem_post(&g_telnetdcommon.exclsem);
+  return OK;
+}
+#endif
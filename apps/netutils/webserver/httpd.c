@@ -50,6 +50,7 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
@@ -61,6 +62,12 @@
 #  include <pthread.h>
 #endif
 
+#ifdef CONFIG_NETUTILS_HTTPD_WORKERPOOL
+#  include <fcntl.h>
+#  include <poll.h>
+#  include <time.h>
+#endif
+
 #include <arpa/inet.h>
 
 #include <apps/netutils/netlib.h>
@@ -108,15 +115,50 @@
 #endif
 
 /* If timeouts are not enabled, then keep-alive is disabled.  This is to
- * prevent a rogue HTTP client from blocking the httpd indefinitely.
+ * prevent a rogue HTTP client from blocking the httpd indefinitely.  This
+ * does not apply to the worker pool:  Its sockets are non-blocking, so a
+ * worker never waits for request data.  A connection without a complete
+ * request is returned to the dispatcher with the bytes received so far and
+ * is closed if the request is not complete after
+ * CONFIG_NETUTILS_HTTPD_IDLETIMEOUT seconds.
  */
 
-#if !defined(CONFIG_NETUTILS_HTTPD_KEEPALIVE_DISABLE)
+#if !defined(CONFIG_NETUTILS_HTTPD_KEEPALIVE_DISABLE) && \
+    !defined(CONFIG_NETUTILS_HTTPD_WORKERPOOL)
 #  if CONFIG_NETUTILS_HTTPD_TIMEOUT == 0
 #    define CONFIG_NETUTILS_HTTPD_KEEPALIVE_DISABLE
 #  endif
 #endif
 
+#ifdef CONFIG_NETUTILS_HTTPD_WORKERPOOL
+#  ifdef CONFIG_NETUTILS_HTTPD_SINGLECONNECT
+#    error "CONFIG_NETUTILS_HTTPD_WORKERPOOL and CONFIG_NETUTILS_HTTPD_SINGLECONNECT are mutually exclusive"
+#  endif
+
+#  ifndef CONFIG_NET_TCP_READAHEAD
+#    error "CONFIG_NETUTILS_HTTPD_WORKERPOOL requires CONFIG_NET_TCP_READAHEAD"
+#  endif
+
+#  ifndef CONFIG_NETUTILS_HTTPD_NWORKERS
+#    define CONFIG_NETUTILS_HTTPD_NWORKERS 2
+#  endif
+
+#  ifndef CONFIG_NETUTILS_HTTPD_MAXCONNS
+#    define CONFIG_NETUTILS_HTTPD_MAXCONNS 8
+#  endif
+
+#  ifndef CONFIG_NETUTILS_HTTPD_IDLETIMEOUT
+#    define CONFIG_NETUTILS_HTTPD_IDLETIMEOUT 10
+#  endif
+
+/* States of a connection in the worker pool */
+
+#  define HTTPD_CONN_FREE    0  /* Connection slot is not in use */
+#  define HTTPD_CONN_IDLE    1  /* Waiting for a request (polled by the dispatcher) */
+#  define HTTPD_CONN_READY   2  /* Request data available, waiting for a worker */
+#  define HTTPD_CONN_BUSY    3  /* A worker is serving the connection */
+#endif
+
 #ifdef CONFIG_NETUTILS_HTTPD_CLASSIC
 #  ifndef CONFIG_NETUTILS_HTTPD_INDEX
 #    ifndef CONFIG_NETUTILS_HTTPD_SCRIPT_DISABLE
@@ -127,10 +169,47 @@
 #  endif
 #endif
 
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef CONFIG_NETUTILS_HTTPD_WORKERPOOL
+/* One connection managed by the worker pool */
+
+struct httpd_conn_s
+{
+  FAR struct httpd_state *pstate;   /* Per-connection state */
+  time_t   idle;                    /* Time of the last completed request */
+  uint8_t  state;                   /* See HTTPD_CONN_* definitions */
+};
+
+/* The worker pool.  The dispatcher polls the listening socket and all idle
+ * connections.  When a request arrives on a connection, the connection is
+ * marked ready and one of the workers serves it.  Kept-alive connections
+ * are then returned to the dispatcher.
+ */
+
+struct httpd_pool_s
+{
+  pthread_mutex_t lock;             /* Protects conns[].state and shutdown */
+  pthread_cond_t  ready;            /* Signaled when a connection is ready */
+  int             wakefd[2];        /* Pipe used to wake up the dispatcher */
+  int             next;             /* Next connection to check for work */
+  int             nworkers;         /* Number of workers started */
+  bool            shutdown;         /* Tells the workers to exit */
+  pthread_t       workers[CONFIG_NETUTILS_HTTPD_NWORKERS];
+  struct httpd_conn_s conns[CONFIG_NETUTILS_HTTPD_MAXCONNS];
+};
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
+#ifdef CONFIG_NETUTILS_HTTPD_WORKERPOOL
+static struct httpd_pool_s g_httpd_pool;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -557,6 +636,7 @@ done:
 
 static inline int httpd_parse(struct httpd_state *pstate)
 {
+  bool pending;
   char *o;
 
   enum
@@ -567,7 +647,14 @@ static inline int httpd_parse(struct httpd_state *pstate)
   } state;
 
   state = STATE_METHOD;
-  o = pstate->ht_buffer;
+
+  /* Bytes that followed the previous request on this connection (i.e., a
+   * pipelined request) are parsed before anything more is received.
+   */
+
+  o       = pstate->ht_buffer + pstate->ht_buflen;
+  pending = (pstate->ht_buflen > 0);
+  pstate->ht_buflen = 0;
 
   do
     {
@@ -580,6 +667,7 @@ static inline int httpd_parse(struct httpd_state *pstate)
           return 413;
         }
 
+      if (!pending)
       {
         ssize_t r;
 
@@ -607,12 +695,17 @@ static inline int httpd_parse(struct httpd_state *pstate)
         o += r;
       }
 
+      pending = false;
+
       /* Here o marks the end of the total block currently awaiting processing.
        * There may be multiple lines in a block; next we deal with each in turn.
+       * Stop at the end of the request headers:  Anything that follows is the
+       * next request.
        */
 
       for (start = pstate->ht_buffer;
-           (end = memchr(start, '\r', o - start)), end != NULL;
+           state != STATE_BODY && o - start > 1 &&
+           (end = memchr(start, '\r', o - start - 1)) != NULL;
            start = end)
         {
           *end = '\0';
@@ -650,6 +743,14 @@ static inline int httpd_parse(struct httpd_state *pstate)
                 return 505;
               }
 
+#ifndef CONFIG_NETUTILS_HTTPD_KEEPALIVE_DISABLE
+            /* HTTP/1.1 connections are persistent unless the client asks
+             * otherwise.
+             */
+
+            pstate->ht_keepalive = (0 == strcmp(v, " HTTP/1.1"));
+#endif
+
             /* TODO: url decoding */
 
             if (v - start >= sizeof pstate->ht_filename)
@@ -695,6 +796,10 @@ static inline int httpd_parse(struct httpd_state *pstate)
               {
                 pstate->ht_keepalive = true;
               }
+            else if (0 == strcasecmp(start, "Connection") && 0 == strcasecmp(v, "close"))
+              {
+                pstate->ht_keepalive = false;
+              }
 #endif
             break;
 
@@ -711,6 +816,10 @@ static inline int httpd_parse(struct httpd_state *pstate)
     }
   while (state != STATE_BODY);
 
+  /* Keep whatever follows this request for the next call */
+
+  pstate->ht_buflen = o - pstate->ht_buffer;
+
 #ifdef CONFIG_NETUTILS_HTTPD_CLASSIC
   if (0 == strcmp(pstate->ht_filename, "/"))
     {
@@ -723,6 +832,50 @@ static inline int httpd_parse(struct httpd_state *pstate)
   return 200;
 }
 
+/****************************************************************************
+ * Name: httpd_request
+ *
+ * Description:
+ *   Receive and respond to one HTTP request.
+ *
+ * Returned Value:
+ *   True if the connection should be kept open for another request.
+ *
+ ****************************************************************************/
+
+static bool httpd_request(struct httpd_state *pstate)
+{
+  int status;
+  int ret;
+
+#ifndef CONFIG_NETUTILS_HTTPD_KEEPALIVE_DISABLE
+  pstate->ht_keepalive = false;
+#endif
+
+  status = httpd_parse(pstate);
+  if (status < 0)
+    {
+      /* The connection was closed or lost */
+
+      return false;
+    }
+  else if (status >= 400)
+    {
+      ret = httpd_senderror(pstate, status);
+    }
+  else
+    {
+      ret = httpd_sendfile(pstate);
+    }
+
+#ifndef CONFIG_NETUTILS_HTTPD_KEEPALIVE_DISABLE
+  return ret == OK && pstate->ht_keepalive;
+#else
+  UNUSED(ret);
+  return false;
+#endif
+}
+
 /****************************************************************************
  * Name: httpd_handler
  *
@@ -733,11 +886,11 @@ static inline int httpd_parse(struct httpd_state *pstate)
  *
  ****************************************************************************/
 
+#ifndef CONFIG_NETUTILS_HTTPD_WORKERPOOL
 static void *httpd_handler(void *arg)
 {
   struct httpd_state *pstate = (struct httpd_state *)malloc(sizeof(struct httpd_state));
   int                 sockfd = (int)arg;
-  int                 ret    = ERROR;
 
   nvdbg("[%d] Started\n", sockfd);
 
@@ -745,34 +898,14 @@ static void *httpd_handler(void *arg)
 
   if (pstate)
     {
-      int status;
-
       /* Re-initialize the thread state structure */
 
       memset(pstate, 0, sizeof(struct httpd_state));
       pstate->ht_sockfd = sockfd;
 
-#ifndef CONFIG_NETUTILS_HTTPD_KEEPALIVE_DISABLE
-      do
-        {
-          pstate->ht_keepalive = false;
-#endif
-          /* Then handle the next httpd command */
+      /* Then handle httpd commands until the connection is closed */
 
-          status = httpd_parse(pstate);
-          if (status >= 400)
-            {
-              ret = httpd_senderror(pstate, status);
-            }
-          else
-            {
-              ret = httpd_sendfile(pstate);
-            }
-
-#ifndef CONFIG_NETUTILS_HTTPD_KEEPALIVE_DISABLE
-        }
-      while (pstate->ht_keepalive);
-#endif
+      while (httpd_request(pstate));
 
       /* End of command processing -- Clean up and exit */
 
@@ -785,6 +918,7 @@ static void *httpd_handler(void *arg)
   close(sockfd);
   return NULL;
 }
+#endif
 
 #ifdef CONFIG_NETUTILS_HTTPD_SINGLECONNECT
 static void single_server(uint16_t portno, pthread_startroutine_t handler, int stacksize)
@@ -859,6 +993,492 @@ static void single_server(uint16_t portno, pthread_startroutine_t handler, int s
 }
 #endif
 
+#ifdef CONFIG_NETUTILS_HTTPD_WORKERPOOL
+/****************************************************************************
+ * Name: httpd_pool_close
+ *
+ * Description:
+ *   Close a connection and release its slot.  The slot must be owned by the
+ *   caller (i.e., not FREE and not visible to the other threads as IDLE or
+ *   READY).
+ *
+ ****************************************************************************/
+
+static void httpd_pool_close(FAR struct httpd_conn_s *conn)
+{
+  FAR struct httpd_state *pstate = conn->pstate;
+
+  nvdbg("[%d] Closing\n", pstate->ht_sockfd);
+  close(pstate->ht_sockfd);
+
+  pthread_mutex_lock(&g_httpd_pool.lock);
+  conn->pstate = NULL;
+  conn->state  = HTTPD_CONN_FREE;
+  pthread_mutex_unlock(&g_httpd_pool.lock);
+
+  free(pstate);
+}
+
+/****************************************************************************
+ * Name: httpd_pool_recv
+ *
+ * Description:
+ *   Receive the rest of the request headers without blocking.  The bytes
+ *   received are kept in the connection state, so a request may be
+ *   received over several calls.
+ *
+ * Returned Value:
+ *   1 if a complete request header is buffered (or the buffer is full, in
+ *   which case httpd_parse() reports the error), 0 if more data must be
+ *   awaited, or -1 if the connection was closed or failed.
+ *
+ ****************************************************************************/
+
+static int httpd_pool_recv(FAR struct httpd_state *pstate)
+{
+  ssize_t r;
+  int i;
+
+  for (;;)
+    {
+      /* Is the end of the request headers buffered? */
+
+      for (i = 3; i < pstate->ht_buflen; i++)
+        {
+          if (0 == memcmp(&pstate->ht_buffer[i - 3], "\r\n\r\n", 4))
+            {
+              return 1;
+            }
+        }
+
+      if (pstate->ht_buflen == sizeof pstate->ht_buffer)
+        {
+          return 1;
+        }
+
+      r = recv(pstate->ht_sockfd, pstate->ht_buffer + pstate->ht_buflen,
+               sizeof pstate->ht_buffer - pstate->ht_buflen, 0);
+      if (r > 0)
+        {
+          pstate->ht_buflen += r;
+        }
+      else if (r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+          return 0;
+        }
+      else
+        {
+          nvdbg("[%d] connection lost: %d\n", pstate->ht_sockfd,
+                r < 0 ? errno : 0);
+          return -1;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: httpd_pool_worker
+ *
+ * Description:
+ *   Worker thread:  Serve requests on connections that the dispatcher has
+ *   marked ready.
+ *
+ ****************************************************************************/
+
+static void *httpd_pool_worker(void *arg)
+{
+  FAR struct httpd_conn_s *conn;
+  bool served;
+  bool keep;
+  int ret;
+  int i;
+
+  for (;;)
+    {
+      /* Wait for a connection with a request to serve */
+
+      pthread_mutex_lock(&g_httpd_pool.lock);
+      for (;;)
+        {
+          if (g_httpd_pool.shutdown)
+            {
+              pthread_mutex_unlock(&g_httpd_pool.lock);
+              return NULL;
+            }
+
+          for (conn = NULL, i = 0; i < CONFIG_NETUTILS_HTTPD_MAXCONNS; i++)
+            {
+              int ndx = (g_httpd_pool.next + i) % CONFIG_NETUTILS_HTTPD_MAXCONNS;
+              if (g_httpd_pool.conns[ndx].state == HTTPD_CONN_READY)
+                {
+                  conn = &g_httpd_pool.conns[ndx];
+                  g_httpd_pool.next = ndx + 1;
+                  break;
+                }
+            }
+
+          if (conn)
+            {
+              break;
+            }
+
+          pthread_cond_wait(&g_httpd_pool.ready, &g_httpd_pool.lock);
+        }
+
+      conn->state = HTTPD_CONN_BUSY;
+      pthread_mutex_unlock(&g_httpd_pool.lock);
+
+      /* Serve every complete request that has been received.  The socket
+       * is non-blocking, so the worker never waits for the rest of a
+       * request:  An incomplete request stays buffered and the connection
+       * is returned to the dispatcher.
+       */
+
+      served = false;
+      for (;;)
+        {
+          ret = httpd_pool_recv(conn->pstate);
+          if (ret <= 0)
+            {
+              keep = (ret == 0);
+              break;
+            }
+
+          served = true;
+          if (!httpd_request(conn->pstate))
+            {
+              keep = false;
+              break;
+            }
+        }
+
+      /* Return kept-alive connections to the dispatcher.  The idle time
+       * only restarts when a request was served, so a client that never
+       * completes its request is closed after the idle timeout even if it
+       * keeps trickling in bytes.
+       */
+
+      if (keep && !served &&
+          time(NULL) - conn->idle >= CONFIG_NETUTILS_HTTPD_IDLETIMEOUT)
+        {
+          nvdbg("[%d] Incomplete request timed out\n",
+                conn->pstate->ht_sockfd);
+          keep = false;
+        }
+
+      if (keep)
+        {
+          pthread_mutex_lock(&g_httpd_pool.lock);
+          if (served)
+            {
+              conn->idle = time(NULL);
+            }
+
+          conn->state = HTTPD_CONN_IDLE;
+          pthread_mutex_unlock(&g_httpd_pool.lock);
+        }
+      else
+        {
+          httpd_pool_close(conn);
+        }
+
+      /* Wake up the dispatcher so that it polls the connection again (or
+       * accepts a new connection in the free slot).
+       */
+
+      (void)write(g_httpd_pool.wakefd[1], "", 1);
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: httpd_pool_accept
+ *
+ * Description:
+ *   Accept a new connection and add it to the pool as an idle connection.
+ *
+ ****************************************************************************/
+
+static void httpd_pool_accept(int listensd)
+{
+  FAR struct httpd_state *pstate;
+  struct sockaddr_in myaddr;
+  socklen_t addrlen;
+  int acceptsd;
+  int i;
+#ifdef CONFIG_NET_SOLINGER
+  struct linger ling;
+#endif
+
+  addrlen  = sizeof(struct sockaddr_in);
+  acceptsd = accept(listensd, (struct sockaddr*)&myaddr, &addrlen);
+  if (acceptsd < 0)
+    {
+      ndbg("accept failure: %d\n", errno);
+      return;
+    }
+
+  nvdbg("Connection accepted -- sd=%d\n", acceptsd);
+
+  /* Configure to "linger" until all data is sent when the socket is closed */
+
+#ifdef CONFIG_NET_SOLINGER
+  ling.l_onoff  = 1;
+  ling.l_linger = 30;     /* timeout is seconds */
+  if (setsockopt(acceptsd, SOL_SOCKET, SO_LINGER, &ling, sizeof(struct linger)) < 0)
+    {
+      ndbg("setsockopt SO_LINGER failure: %d\n", errno);
+      goto errout_with_socket;
+    }
+#endif
+
+  /* Receive without blocking so that a slow or idle client cannot hold a
+   * worker.  Sends still block.
+   */
+
+  if (fcntl(acceptsd, F_SETFL, O_NONBLOCK) < 0)
+    {
+      ndbg("fcntl O_NONBLOCK failure: %d\n", errno);
+      goto errout_with_socket;
+    }
+
+  pstate = (struct httpd_state *)malloc(sizeof(struct httpd_state));
+  if (!pstate)
+    {
+      goto errout_with_socket;
+    }
+
+  memset(pstate, 0, sizeof(struct httpd_state));
+  pstate->ht_sockfd = acceptsd;
+
+  /* The dispatcher only accepts when there is a free slot */
+
+  pthread_mutex_lock(&g_httpd_pool.lock);
+  for (i = 0; i < CONFIG_NETUTILS_HTTPD_MAXCONNS; i++)
+    {
+      FAR struct httpd_conn_s *conn = &g_httpd_pool.conns[i];
+      if (conn->state == HTTPD_CONN_FREE)
+        {
+          conn->pstate = pstate;
+          conn->idle   = time(NULL);
+          conn->state  = HTTPD_CONN_IDLE;
+          pthread_mutex_unlock(&g_httpd_pool.lock);
+          return;
+        }
+    }
+
+  pthread_mutex_unlock(&g_httpd_pool.lock);
+  free(pstate);
+
+errout_with_socket:
+  close(acceptsd);
+}
+
+/****************************************************************************
+ * Name: pool_server
+ *
+ * Description:
+ *   Serve HTTP connections with a poll()-driven dispatcher and a fixed pool
+ *   of worker threads.  Does not return unless an error occurs.
+ *
+ ****************************************************************************/
+
+static void pool_server(uint16_t portno, int stacksize)
+{
+  struct pollfd fds[CONFIG_NETUTILS_HTTPD_MAXCONNS + 2];
+  uint8_t slot[CONFIG_NETUTILS_HTTPD_MAXCONNS + 2];
+  pthread_attr_t attr;
+  char dummy[16];
+  bool havefree;
+  bool haveidle;
+  time_t now;
+  int listensd;
+  int nready;
+  int nfds;
+  int ret;
+  int i;
+
+  listensd = netlib_listenon(portno);
+  if (listensd < 0)
+    {
+      return;
+    }
+
+  /* Initialize the pool and start the workers */
+
+  memset(&g_httpd_pool, 0, sizeof(struct httpd_pool_s));
+  pthread_mutex_init(&g_httpd_pool.lock, NULL);
+  pthread_cond_init(&g_httpd_pool.ready, NULL);
+
+  if (pipe(g_httpd_pool.wakefd) < 0)
+    {
+      ndbg("pipe failed: %d\n", errno);
+      goto errout_with_listensd;
+    }
+
+  (void)pthread_attr_init(&attr);
+  (void)pthread_attr_setstacksize(&attr, stacksize);
+
+  for (i = 0; i < CONFIG_NETUTILS_HTTPD_NWORKERS; i++)
+    {
+      ret = pthread_create(&g_httpd_pool.workers[i], &attr,
+                           httpd_pool_worker, NULL);
+      if (ret != 0)
+        {
+          ndbg("pthread_create failed: %d\n", ret);
+          if (i == 0)
+            {
+              goto errout_with_pipe;
+            }
+
+          break;
+        }
+
+      g_httpd_pool.nworkers++;
+    }
+
+  /* Begin serving connections */
+
+  for (;;)
+    {
+      /* Poll the wake-up pipe, the listening socket (if a connection slot
+       * is available), and every idle connection.
+       */
+
+      fds[0].fd     = g_httpd_pool.wakefd[0];
+      fds[0].events = POLLIN;
+      nfds          = 1;
+      havefree      = false;
+      haveidle      = false;
+
+      pthread_mutex_lock(&g_httpd_pool.lock);
+      for (i = 0; i < CONFIG_NETUTILS_HTTPD_MAXCONNS; i++)
+        {
+          FAR struct httpd_conn_s *conn = &g_httpd_pool.conns[i];
+          if (conn->state == HTTPD_CONN_FREE)
+            {
+              havefree = true;
+            }
+          else if (conn->state == HTTPD_CONN_IDLE)
+            {
+              fds[nfds].fd     = conn->pstate->ht_sockfd;
+              fds[nfds].events = POLLIN;
+              slot[nfds]       = i;
+              nfds++;
+              haveidle         = true;
+            }
+        }
+
+      pthread_mutex_unlock(&g_httpd_pool.lock);
+
+      if (havefree)
+        {
+          fds[nfds].fd     = listensd;
+          fds[nfds].events = POLLIN;
+          nfds++;
+        }
+
+      for (i = 0; i < nfds; i++)
+        {
+          fds[i].revents = 0;
+        }
+
+      ret = poll(fds, nfds, haveidle ? 1000 : -1);
+      if (ret < 0)
+        {
+          if (errno == EINTR)
+            {
+              continue;
+            }
+
+          ndbg("poll failed: %d\n", errno);
+          break;
+        }
+
+      /* Drain the wake-up pipe */
+
+      if ((fds[0].revents & POLLIN) != 0)
+        {
+          (void)read(g_httpd_pool.wakefd[0], dummy, sizeof(dummy));
+        }
+
+      /* Hand connections with incoming data to the workers and close
+       * connections that have been idle for too long.
+       */
+
+      now    = time(NULL);
+      nready = 0;
+
+      for (i = 1; i < nfds; i++)
+        {
+          FAR struct httpd_conn_s *conn;
+
+          if (fds[i].fd == listensd)
+            {
+              continue;
+            }
+
+          conn = &g_httpd_pool.conns[slot[i]];
+          if (fds[i].revents != 0)
+            {
+              pthread_mutex_lock(&g_httpd_pool.lock);
+              conn->state = HTTPD_CONN_READY;
+              pthread_mutex_unlock(&g_httpd_pool.lock);
+              nready++;
+            }
+          else if (now - conn->idle >= CONFIG_NETUTILS_HTTPD_IDLETIMEOUT)
+            {
+              httpd_pool_close(conn);
+            }
+        }
+
+      if (nready > 0)
+        {
+          pthread_mutex_lock(&g_httpd_pool.lock);
+          pthread_cond_broadcast(&g_httpd_pool.ready);
+          pthread_mutex_unlock(&g_httpd_pool.lock);
+        }
+
+      /* Accept a new connection */
+
+      if (havefree && (fds[nfds - 1].revents & POLLIN) != 0)
+        {
+          httpd_pool_accept(listensd);
+        }
+    }
+
+  /* Stop the workers.  A worker that is serving a connection exits when it
+   * is done with it.
+   */
+
+  pthread_mutex_lock(&g_httpd_pool.lock);
+  g_httpd_pool.shutdown = true;
+  pthread_cond_broadcast(&g_httpd_pool.ready);
+  pthread_mutex_unlock(&g_httpd_pool.lock);
+
+  for (i = 0; i < g_httpd_pool.nworkers; i++)
+    {
+      (void)pthread_join(g_httpd_pool.workers[i], NULL);
+    }
+
+  /* Close the connections that are left */
+
+  for (i = 0; i < CONFIG_NETUTILS_HTTPD_MAXCONNS; i++)
+    {
+      if (g_httpd_pool.conns[i].state != HTTPD_CONN_FREE)
+        {
+          httpd_pool_close(&g_httpd_pool.conns[i]);
+        }
+    }
+
+errout_with_pipe:
+  close(g_httpd_pool.wakefd[0]);
+  close(g_httpd_pool.wakefd[1]);
+errout_with_listensd:
+  close(listensd);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -875,8 +1495,10 @@ int httpd_listen(void)
 {
   /* Execute httpd_handler on each connection to port 80 */
 
-#ifdef CONFIG_NETUTILS_HTTPD_SINGLECONNECT
+#if defined(CONFIG_NETUTILS_HTTPD_SINGLECONNECT)
   single_server(HTONS(80), httpd_handler, CONFIG_NETUTILS_HTTPDSTACKSIZE);
+#elif defined(CONFIG_NETUTILS_HTTPD_WORKERPOOL)
+  pool_server(HTONS(80), CONFIG_NETUTILS_HTTPDSTACKSIZE);
 #else
   netlib_server(HTONS(80), httpd_handler, CONFIG_NETUTILS_HTTPDSTACKSIZE);
 #endif
@@ -195,8 +195,8 @@ int nsh_telnetmain(int argc, char *argv[])
 #ifdef CONFIG_NSH_TELNET_LOGIN
   if (nsh_telnetlogin(pstate) != OK)
     {
-      nsh_exit(&pstate->cn_vtbl, 1);
-      return -1; /* nsh_exit does not return */
+      nsh_release(&pstate->cn_vtbl);
+      return 1;
     }
 #endif /* CONFIG_NSH_TELNET_LOGIN */
 
@@ -247,17 +247,16 @@ int nsh_telnetmain(int argc, char *argv[])
         {
           fprintf(pstate->cn_outstream, g_fmtcmdfailed, "nsh_telnetmain",
                   "fgets", NSH_ERRNO);
-          nsh_exit(&pstate->cn_vtbl, 1);
+          break;
         }
     }
 
-  /* Clean up */
-
-  nsh_exit(&pstate->cn_vtbl, 0);
-
-  /* We do not get here, but this is necessary to keep some compilers happy */
+  /* Clean up.  Returning (rather than calling nsh_exit()) lets a pooled
+   * Telnet worker serve the next session.
+   */
 
-  return OK;
+  nsh_release(&pstate->cn_vtbl);
+  return 1;
 }
 
 /****************************************************************************
@@ -42,6 +42,7 @@
 #include <debug.h>
 
 #include <nuttx/arch.h>
+#include <nuttx/crypto/crypto.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/syslog/ramlog.h>
 
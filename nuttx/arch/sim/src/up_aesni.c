@@ -0,0 +1,481 @@
+/****************************************************************************
+ * arch/sim/src/up_aesni.c
+ *
+ *   Copyright (C) 2014 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <nuttx/crypto/crypto.h>
+#include <nuttx/crypto/aes.h>
+
+#ifdef CONFIG_SIM_AESNI
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define AESNI_TARGET   __attribute__ ((target("sse2,aes")))
+
+/* CPUID leaf 1 feature bits */
+
+#define CPUID_EDX_SSE2 (1 << 26)
+#define CPUID_ECX_AES  (1 << 25)
+
+/* Offset of the decryption key schedule in struct aes_ctx_s rk[] */
+
+#define AESNI_DKOFFSET (4 * (AES_MAXROUNDS + 1))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A 16-byte SSE register (see up_strlen.c).  aes_uv2di may be loaded from
+ * and stored to any address.
+ */
+
+typedef long long aes_v2di __attribute__ ((vector_size(16)));
+typedef long long aes_uv2di __attribute__ ((vector_size(16), aligned(1)));
+typedef int aes_v4si __attribute__ ((vector_size(16)));
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* 0: not yet checked, 1: AES-NI available, -1: not available */
+
+static int g_aesni;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: aesni_available
+ *
+ * Description:
+ *   Check with CPUID whether the host CPU supports AES-NI.  EBX is saved
+ *   by hand since it may be the PIC register.
+ *
+ ****************************************************************************/
+
+static bool aesni_available(void)
+{
+  uint32_t eax = 1;
+  uint32_t ecx = 0;
+  uint32_t edx;
+  unsigned long ebx;
+
+  if (g_aesni == 0)
+    {
+#ifdef __x86_64__
+      __asm__ __volatile__("mov %%rbx, %1\n\tcpuid\n\txchg %%rbx, %1"
+                           : "+a" (eax), "=&r" (ebx), "+c" (ecx), "=d" (edx));
+#else
+      __asm__ __volatile__("mov %%ebx, %1\n\tcpuid\n\txchg %%ebx, %1"
+                           : "+a" (eax), "=&r" (ebx), "+c" (ecx), "=d" (edx));
+#endif
+      UNUSED(ebx);
+
+      g_aesni = ((edx & CPUID_EDX_SSE2) != 0 && (ecx & CPUID_ECX_AES) != 0) ?
+                1 : -1;
+    }
+
+  return g_aesni > 0;
+}
+
+/****************************************************************************
+ * Name: aesni_subword
+ *
+ * Description:
+ *   SubWord() of the key schedule.  AESKEYGENASSIST returns SubWord() of
+ *   the second word in the first word.
+ *
+ ****************************************************************************/
+
+static inline uint32_t AESNI_TARGET aesni_subword(uint32_t x)
+{
+  aes_v4si v = { 0, (int)x, 0, 0 };
+
+  v = (aes_v4si)__builtin_ia32_aeskeygenassist128((aes_v2di)v, 0);
+  return (uint32_t)v[0];
+}
+
+/****************************************************************************
+ * Name: aesni_encrypt1 and aesni_decrypt1
+ ****************************************************************************/
+
+static inline aes_v2di AESNI_TARGET
+aesni_encrypt1(FAR const aes_uv2di *rk, int nr, aes_v2di b)
+{
+  int r;
+
+  b ^= rk[0];
+  for (r = 1; r < nr; r++)
+    {
+      b = __builtin_ia32_aesenc128(b, rk[r]);
+    }
+
+  return __builtin_ia32_aesenclast128(b, rk[nr]);
+}
+
+static inline aes_v2di AESNI_TARGET
+aesni_decrypt1(FAR const aes_uv2di *rk, int nr, aes_v2di b)
+{
+  int r;
+
+  b ^= rk[0];
+  for (r = 1; r < nr; r++)
+    {
+      b = __builtin_ia32_aesdec128(b, rk[r]);
+    }
+
+  return __builtin_ia32_aesdeclast128(b, rk[nr]);
+}
+
+/****************************************************************************
+ * Name: aesni_encrypt4 and aesni_decrypt4
+ *
+ * Description:
+ *   Process four independent blocks.  The AES instructions have a latency
+ *   of several cycles but can be issued every cycle, so interleaving four
+ *   blocks keeps the AES unit busy.
+ *
+ ****************************************************************************/
+
+static inline void AESNI_TARGET
+aesni_encrypt4(FAR const aes_uv2di *rk, int nr, FAR aes_v2di *b)
+{
+  aes_v2di k = rk[0];
+  int r;
+
+  b[0] ^= k;
+  b[1] ^= k;
+  b[2] ^= k;
+  b[3] ^= k;
+
+  for (r = 1; r < nr; r++)
+    {
+      k    = rk[r];
+      b[0] = __builtin_ia32_aesenc128(b[0], k);
+      b[1] = __builtin_ia32_aesenc128(b[1], k);
+      b[2] = __builtin_ia32_aesenc128(b[2], k);
+      b[3] = __builtin_ia32_aesenc128(b[3], k);
+    }
+
+  k    = rk[nr];
+  b[0] = __builtin_ia32_aesenclast128(b[0], k);
+  b[1] = __builtin_ia32_aesenclast128(b[1], k);
+  b[2] = __builtin_ia32_aesenclast128(b[2], k);
+  b[3] = __builtin_ia32_aesenclast128(b[3], k);
+}
+
+static inline void AESNI_TARGET
+aesni_decrypt4(FAR const aes_uv2di *rk, int nr, FAR aes_v2di *b)
+{
+  aes_v2di k = rk[0];
+  int r;
+
+  b[0] ^= k;
+  b[1] ^= k;
+  b[2] ^= k;
+  b[3] ^= k;
+
+  for (r = 1; r < nr; r++)
+    {
+      k    = rk[r];
+      b[0] = __builtin_ia32_aesdec128(b[0], k);
+      b[1] = __builtin_ia32_aesdec128(b[1], k);
+      b[2] = __builtin_ia32_aesdec128(b[2], k);
+      b[3] = __builtin_ia32_aesdec128(b[3], k);
+    }
+
+  k    = rk[nr];
+  b[0] = __builtin_ia32_aesdeclast128(b[0], k);
+  b[1] = __builtin_ia32_aesdeclast128(b[1], k);
+  b[2] = __builtin_ia32_aesdeclast128(b[2], k);
+  b[3] = __builtin_ia32_aesdeclast128(b[3], k);
+}
+
+/****************************************************************************
+ * Name: aesni_incctr
+ *
+ * Description:
+ *   Increment a 128-bit big-endian counter block.
+ *
+ ****************************************************************************/
+
+static inline void aesni_incctr(FAR uint8_t *ctr)
+{
+  int i;
+
+  for (i = AES_BLOCK_SIZE - 1; i >= 0; i--)
+    {
+      if (++ctr[i] != 0)
+        {
+          break;
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_aes_setkey
+ *
+ * Description:
+ *   Expand the key into the encryption schedule (rk[0..59]) and the
+ *   equivalent inverse cipher schedule (rk[60..119]) for AESDEC.  Returns
+ *   false if the host CPU does not support AES-NI.
+ *
+ ****************************************************************************/
+
+bool AESNI_TARGET up_aes_setkey(FAR struct aes_ctx_s *ctx,
+                                FAR const uint8_t *key, uint32_t keysize)
+{
+  static const uint8_t rcon[10] =
+  {
+    0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1b, 0x36
+  };
+
+  FAR uint32_t *w = ctx->rk;
+  FAR aes_uv2di *ek;
+  FAR aes_uv2di *dk;
+  uint32_t t;
+  int nk = keysize / 4;
+  int nr = ctx->nr;
+  int i;
+
+  if (!aesni_available())
+    {
+      return false;
+    }
+
+  for (i = 0; i < nk; i++)
+    {
+      w[i] = (uint32_t)key[4 * i] | ((uint32_t)key[4 * i + 1] << 8) |
+             ((uint32_t)key[4 * i + 2] << 16) |
+             ((uint32_t)key[4 * i + 3] << 24);
+    }
+
+  for (i = nk; i < 4 * (nr + 1); i++)
+    {
+      t = w[i - 1];
+      if (i % nk == 0)
+        {
+          t = aesni_subword((t >> 8) | (t << 24)) ^ rcon[i / nk - 1];
+        }
+      else if (nk > 6 && i % nk == 4)
+        {
+          t = aesni_subword(t);
+        }
+
+      w[i] = w[i - nk] ^ t;
+    }
+
+  ek = (FAR aes_uv2di *)ctx->rk;
+  dk = (FAR aes_uv2di *)(ctx->rk + AESNI_DKOFFSET);
+
+  dk[0]  = ek[nr];
+  for (i = 1; i < nr; i++)
+    {
+      dk[i] = __builtin_ia32_aesimc128(ek[nr - i]);
+    }
+
+  dk[nr] = ek[0];
+  return true;
+}
+
+/****************************************************************************
+ * Name: up_aes_ecb
+ ****************************************************************************/
+
+void AESNI_TARGET up_aes_ecb(FAR const struct aes_ctx_s *ctx,
+                             FAR uint8_t *out, FAR const uint8_t *in,
+                             size_t nblocks, int encrypt)
+{
+  FAR const aes_uv2di *rk = (FAR const aes_uv2di *)ctx->rk;
+  FAR const aes_uv2di *src = (FAR const aes_uv2di *)in;
+  FAR aes_uv2di *dest = (FAR aes_uv2di *)out;
+  aes_v2di b[4];
+  int nr = ctx->nr;
+
+  if (!encrypt)
+    {
+      rk = (FAR const aes_uv2di *)(ctx->rk + AESNI_DKOFFSET);
+    }
+
+  for (; nblocks >= 4; nblocks -= 4, src += 4, dest += 4)
+    {
+      b[0] = src[0];
+      b[1] = src[1];
+      b[2] = src[2];
+      b[3] = src[3];
+
+      if (encrypt)
+        {
+          aesni_encrypt4(rk, nr, b);
+        }
+      else
+        {
+          aesni_decrypt4(rk, nr, b);
+        }
+
+      dest[0] = b[0];
+      dest[1] = b[1];
+      dest[2] = b[2];
+      dest[3] = b[3];
+    }
+
+  for (; nblocks > 0; nblocks--, src++, dest++)
+    {
+      *dest = encrypt ? aesni_encrypt1(rk, nr, *src) :
+                        aesni_decrypt1(rk, nr, *src);
+    }
+}
+
+/****************************************************************************
+ * Name: up_aes_cbc
+ *
+ * Description:
+ *   CBC encryption is serial; decryption handles four blocks at a time.
+ *
+ ****************************************************************************/
+
+void AESNI_TARGET up_aes_cbc(FAR const struct aes_ctx_s *ctx,
+                             FAR uint8_t *out, FAR const uint8_t *in,
+                             size_t nblocks, FAR uint8_t *iv, int encrypt)
+{
+  FAR const aes_uv2di *src = (FAR const aes_uv2di *)in;
+  FAR aes_uv2di *dest = (FAR aes_uv2di *)out;
+  FAR aes_uv2di *piv = (FAR aes_uv2di *)iv;
+  FAR const aes_uv2di *rk;
+  aes_v2di chain = *piv;
+  aes_v2di c[4];
+  aes_v2di b[4];
+  int nr = ctx->nr;
+
+  if (encrypt)
+    {
+      rk = (FAR const aes_uv2di *)ctx->rk;
+      for (; nblocks > 0; nblocks--, src++, dest++)
+        {
+          chain = aesni_encrypt1(rk, nr, *src ^ chain);
+          *dest = chain;
+        }
+
+      *piv = chain;
+      return;
+    }
+
+  rk = (FAR const aes_uv2di *)(ctx->rk + AESNI_DKOFFSET);
+  for (; nblocks >= 4; nblocks -= 4, src += 4, dest += 4)
+    {
+      b[0] = c[0] = src[0];
+      b[1] = c[1] = src[1];
+      b[2] = c[2] = src[2];
+      b[3] = c[3] = src[3];
+
+      aesni_decrypt4(rk, nr, b);
+
+      dest[0] = b[0] ^ chain;
+      dest[1] = b[1] ^ c[0];
+      dest[2] = b[2] ^ c[1];
+      dest[3] = b[3] ^ c[2];
+      chain   = c[3];
+    }
+
+  for (; nblocks > 0; nblocks--, src++, dest++)
+    {
+      c[0]  = *src;
+      *dest = aesni_decrypt1(rk, nr, c[0]) ^ chain;
+      chain = c[0];
+    }
+
+  *piv = chain;
+}
+
+/****************************************************************************
+ * Name: up_aes_ctr
+ ****************************************************************************/
+
+void AESNI_TARGET up_aes_ctr(FAR const struct aes_ctx_s *ctx,
+                             FAR uint8_t *out, FAR const uint8_t *in,
+                             size_t nblocks, FAR uint8_t *ctr)
+{
+  FAR const aes_uv2di *rk = (FAR const aes_uv2di *)ctx->rk;
+  FAR const aes_uv2di *src = (FAR const aes_uv2di *)in;
+  FAR const aes_uv2di *pctr = (FAR const aes_uv2di *)ctr;
+  FAR aes_uv2di *dest = (FAR aes_uv2di *)out;
+  aes_v2di b[4];
+  int nr = ctx->nr;
+  int i;
+
+  while (nblocks >= 4)
+    {
+      for (i = 0; i < 4; i++)
+        {
+          b[i] = *pctr;
+          aesni_incctr(ctr);
+        }
+
+      aesni_encrypt4(rk, nr, b);
+
+      dest[0] = src[0] ^ b[0];
+      dest[1] = src[1] ^ b[1];
+      dest[2] = src[2] ^ b[2];
+      dest[3] = src[3] ^ b[3];
+
+      nblocks -= 4;
+      src     += 4;
+      dest    += 4;
+    }
+
+  for (; nblocks > 0; nblocks--, src++, dest++)
+    {
+      b[0] = *pctr;
+      aesni_incctr(ctr);
+      *dest = *src ^ aesni_encrypt1(rk, nr, b[0]);
+    }
+}
+
+#endif /* CONFIG_SIM_AESNI */
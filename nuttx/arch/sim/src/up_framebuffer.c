@@ -111,6 +111,13 @@ static int up_putcmap(FAR struct fb_vtable_s *vtable, FAR const struct fb_cmap_s
 #ifdef CONFIG_FB_HWCURSOR
 static int up_getcursor(FAR struct fb_vtable_s *vtable, FAR struct fb_cursorattrib_s *attrib);
 static int up_setcursor(FAR struct fb_vtable_s *vtable, FAR struct fb_setcursor_s *setttings);
+#endif
+
+  /* The following are provided only if the simulation has two display pages */
+
+#ifdef CONFIG_FB_PAGEFLIP
+static int up_getbackpage(FAR struct fb_vtable_s *vtable, int planeno, FAR void **fbmem);
+static int up_flip(FAR struct fb_vtable_s *vtable, int planeno);
 #endif
 
 /****************************************************************************
@@ -134,9 +141,11 @@ static const struct fb_videoinfo_s g_videoinfo =
 };
 
 #ifndef CONFIG_SIM_X11FB
-/* This structure describes the single, simulated color plane */
+/* This structure describes the single, simulated color plane (fbmem
+ * changes when pages are flipped).
+ */
 
-static const struct fb_planeinfo_s g_planeinfo =
+static struct fb_planeinfo_s g_planeinfo =
 {
   .fbmem    = (FAR void *)&g_fb,
   .fblen    = FB_SIZE,
@@ -149,6 +158,17 @@ static const struct fb_planeinfo_s g_planeinfo =
 static struct fb_planeinfo_s g_planeinfo;
 #endif
 
+/* The second display page.  With X11, each page is provided by
+ * up_x11framebuffer.c with its own image.
+ */
+
+#ifdef CONFIG_FB_PAGEFLIP
+#ifndef CONFIG_SIM_X11FB
+static uint8_t g_fbpage[FB_SIZE];
+#endif
+static FAR void *g_fbback;        /* The page that is not displayed */
+#endif
+
 /* Current cursor position */
 
 #ifdef CONFIG_FB_HWCURSOR
@@ -177,6 +197,10 @@ struct fb_vtable_s g_fbobject =
   .getcursor     = up_getcursor,
   .setcursor     = up_setcursor,
 #endif
+#ifdef CONFIG_FB_PAGEFLIP
+  .getbackpage   = up_getbackpage,
+  .flip          = up_flip,
+#endif
 };
 
 /****************************************************************************
@@ -340,6 +364,56 @@ static int up_setcursor(FAR struct fb_vtable_s *vtable,
 }
 #endif
 
+/****************************************************************************
+ * Name: up_getbackpage
+ ****************************************************************************/
+
+#ifdef CONFIG_FB_PAGEFLIP
+static int up_getbackpage(FAR struct fb_vtable_s *vtable, int planeno,
+                          FAR void **fbmem)
+{
+  dbg("vtable=%p planeno=%d fbmem=%p\n", vtable, planeno, fbmem);
+  if (vtable && planeno == 0 && fbmem && g_fbback)
+    {
+      *fbmem = g_fbback;
+      return OK;
+    }
+  dbg("Returning EINVAL\n");
+  return -EINVAL;
+}
+#endif
+
+/****************************************************************************
+ * Name: up_flip
+ ****************************************************************************/
+
+#ifdef CONFIG_FB_PAGEFLIP
+static int up_flip(FAR struct fb_vtable_s *vtable, int planeno)
+{
+  FAR void *fbfront;
+
+  if (vtable && planeno == 0 && g_fbback)
+    {
+      /* Display the back page.  The page that was displayed becomes the
+       * back page.
+       */
+
+      fbfront            = g_fbback;
+      g_fbback           = g_planeinfo.fbmem;
+      g_planeinfo.fbmem  = fbfront;
+
+#ifdef CONFIG_SIM_X11FB
+      /* Put the image of the new front page in the X11 window */
+
+      up_x11display(fbfront);
+#endif
+      return OK;
+    }
+  dbg("Returning EINVAL\n");
+  return -EINVAL;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -355,10 +429,27 @@ static int up_setcursor(FAR struct fb_vtable_s *vtable,
 int up_fbinitialize(void)
 {
 #ifdef CONFIG_SIM_X11FB
-  return up_x11initialize(CONFIG_SIM_FBWIDTH, CONFIG_SIM_FBHEIGHT,
-                          &g_planeinfo.fbmem, &g_planeinfo.fblen,
-                          &g_planeinfo.bpp, &g_planeinfo.stride);
+  int ret;
+
+  ret = up_x11initialize(CONFIG_SIM_FBWIDTH, CONFIG_SIM_FBHEIGHT,
+                         &g_planeinfo.fbmem, &g_planeinfo.fblen,
+                         &g_planeinfo.bpp, &g_planeinfo.stride);
+#ifdef CONFIG_FB_PAGEFLIP
+  /* Create the second page.  If that fails, getbackpage() fails and NX
+   * uses an allocated back buffer instead.
+   */
+
+  if (ret == OK)
+    {
+      g_fbback = up_x11backpage();
+    }
+#endif
+
+  return ret;
 #else
+#ifdef CONFIG_FB_PAGEFLIP
+  g_fbback = (FAR void *)g_fbpage;
+#endif
   return OK;
 #endif
 }
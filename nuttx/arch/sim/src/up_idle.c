@@ -106,6 +106,12 @@ void up_idle(void)
   sched_process_timer();
 #endif
 
+  /* Poll the host for console input */
+
+#ifdef USE_SIMUART
+  up_uartloop();
+#endif
+
   /* Run the network if enabled */
 
 #ifdef CONFIG_NET
@@ -42,6 +42,7 @@
 #include <debug.h>
 
 #include <nuttx/arch.h>
+#include <nuttx/crypto/crypto.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/mtd/mtd.h>
@@ -134,11 +135,21 @@ void up_initialize(void)
   devzero_register();   /* Standard /dev/zero */
 #endif
 
+#if defined(CONFIG_CRYPTO)
+  up_cryptoinitialize();
+#endif
+
+#if defined(CONFIG_CRYPTO_CRYPTODEV)
+  devcrypto_register(); /* /dev/crypto */
+#endif
+
 #endif /* CONFIG_NFILE_DESCRIPTORS */
 
   /* Register a console (or not) */
 
-#if defined(USE_DEVCONSOLE)
+#if defined(USE_SIMUART)
+  up_uartinit();            /* Serial driver /dev/console */
+#elif defined(USE_DEVCONSOLE)
   up_devconsole();          /* Our private /dev/console */
 #elif defined(CONFIG_RAMLOG_CONSOLE)
   ramlog_consoleinit();
@@ -72,6 +72,9 @@
 #else
 #  if defined(CONFIG_RAMLOG_CONSOLE)
 #    undef USE_DEVCONSOLE
+#  elif defined(CONFIG_SIM_UART)
+#    undef USE_DEVCONSOLE
+#    define USE_SIMUART 1
 #  else
 #    define USE_DEVCONSOLE 1
 #  endif
@@ -164,6 +167,13 @@ void up_timer_update(void);
 void up_devconsole(void);
 void up_registerblockdevice(void);
 
+/* up_uart.c **************************************************************/
+
+#ifdef USE_SIMUART
+void up_uartinit(void);
+void up_uartloop(void);
+#endif
+
 /* up_deviceimage.c *******************************************************/
 
 char *up_deviceimage(void);
@@ -172,6 +182,7 @@ char *up_deviceimage(void);
 
 size_t up_hostread(void *buffer, size_t len);
 size_t up_hostwrite(const void *buffer, size_t len);
+size_t up_hostrecv(void *buffer, size_t len);
 
 /* up_netdev.c ************************************************************/
 
@@ -190,6 +201,10 @@ int up_x11cmap(unsigned short first, unsigned short len,
                unsigned char *red, unsigned char *green,
                unsigned char *blue, unsigned char  *transp);
 #endif
+#ifdef CONFIG_FB_PAGEFLIP
+void *up_x11backpage(void);
+void up_x11display(void *fbmem);
+#endif
 #endif
 
 /* up_eventloop.c ***********************************************************/
@@ -0,0 +1,131 @@
+/****************************************************************************
+ * arch/sim/src/up_memchr.c
+ *
+ *   Copyright (C) 2014 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef CONFIG_ARCH_MEMCHR
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A 16-byte SSE2 register (see up_strlen.c) */
+
+typedef char sse_v16qi __attribute__ ((vector_size(16)));
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sse_matchmask
+ *
+ * Description:
+ *   Return a bit mask with bit n set if byte n of 'v' matches that of 'c'.
+ *
+ ****************************************************************************/
+
+static inline unsigned int __attribute__ ((target("sse2")))
+sse_matchmask(sse_v16qi v, sse_v16qi c)
+{
+  return (unsigned int)__builtin_ia32_pmovmskb128((sse_v16qi)(v == c));
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: memchr
+ *
+ * Description:
+ *   SSE2 implementation of memchr().  The object is examined 16 bytes at a
+ *   time using aligned loads, as in strlen().  A match found beyond the
+ *   initial 'n' bytes is discarded.
+ *
+ ****************************************************************************/
+
+FAR void * __attribute__ ((target("sse2")))
+memchr(FAR const void *s, int c, size_t n)
+{
+  FAR const unsigned char *p = (FAR const unsigned char *)s;
+  FAR const sse_v16qi *vp;
+  sse_v16qi vc;
+  unsigned int offset;
+  unsigned int mask;
+  size_t avail;
+
+  if (!s || n == 0)
+    {
+      return NULL;
+    }
+
+  vc     = (sse_v16qi){ 0 } + (char)c;
+  offset = (uintptr_t)p & 15;
+  vp     = (FAR const sse_v16qi *)(p - offset);
+  mask   = sse_matchmask(*vp, vc) >> offset;
+  avail  = 16 - offset;
+
+  for (; ; )
+    {
+      if (mask != 0)
+        {
+          unsigned int ndx = __builtin_ctz(mask);
+          return ndx < n ? (FAR void *)(p + ndx) : NULL;
+        }
+
+      if (n <= avail)
+        {
+          return NULL;
+        }
+
+      p    += avail;
+      n    -= avail;
+      avail = 16;
+
+      vp++;
+      mask  = sse_matchmask(*vp, vc);
+    }
+}
+
+#endif /* CONFIG_ARCH_MEMCHR */
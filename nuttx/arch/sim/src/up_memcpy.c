@@ -0,0 +1,122 @@
+/****************************************************************************
+ * arch/sim/src/up_memcpy.c
+ *
+ *   Copyright (C) 2014 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef CONFIG_ARCH_MEMCPY
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* 16-byte SSE2 registers (see up_strlen.c).  sse_uv16qi may be loaded from
+ * any address.
+ */
+
+typedef char sse_v16qi __attribute__ ((vector_size(16)));
+typedef char sse_uv16qi __attribute__ ((vector_size(16), aligned(1)));
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: memcpy
+ *
+ * Description:
+ *   SSE2 implementation of memcpy().  Once the destination is aligned, 64
+ *   bytes are moved per pass using unaligned loads and aligned stores.
+ *
+ ****************************************************************************/
+
+FAR void * __attribute__ ((target("sse2")))
+memcpy(FAR void *dest, FAR const void *src, size_t n)
+{
+  FAR unsigned char *pout = (FAR unsigned char *)dest;
+  FAR const unsigned char *pin = (FAR const unsigned char *)src;
+
+  if (n >= 64)
+    {
+      FAR sse_v16qi *vout;
+
+      while (((uintptr_t)pout & 15) != 0)
+        {
+          *pout++ = *pin++;
+          n--;
+        }
+
+      vout = (FAR sse_v16qi *)pout;
+      for (; n >= 64; n -= 64)
+        {
+          sse_v16qi v0 = ((FAR const sse_uv16qi *)pin)[0];
+          sse_v16qi v1 = ((FAR const sse_uv16qi *)pin)[1];
+          sse_v16qi v2 = ((FAR const sse_uv16qi *)pin)[2];
+          sse_v16qi v3 = ((FAR const sse_uv16qi *)pin)[3];
+
+          vout[0] = v0;
+          vout[1] = v1;
+          vout[2] = v2;
+          vout[3] = v3;
+
+          vout += 4;
+          pin  += 64;
+        }
+
+      for (; n >= 16; n -= 16)
+        {
+          *vout++ = *(FAR const sse_uv16qi *)pin;
+          pin    += 16;
+        }
+
+      pout = (FAR unsigned char *)vout;
+    }
+
+  while (n-- > 0)
+    {
+      *pout++ = *pin++;
+    }
+
+  return dest;
+}
+
+#endif /* CONFIG_ARCH_MEMCPY */
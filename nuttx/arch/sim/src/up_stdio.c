@@ -38,6 +38,8 @@
  ****************************************************************************/
 
 #include <stdio.h>
+#include <unistd.h>
+#include <poll.h>
 
 /****************************************************************************
  * Definitions
@@ -73,6 +75,26 @@ size_t up_hostwrite(const void *buffer, size_t len)
   return fwrite(buffer, 1, len, stdout);
 }
 
+size_t up_hostrecv(void *buffer, size_t len)
+{
+  struct pollfd fd;
+  ssize_t nread;
+
+  /* Read only what is already available from the host stdin */
+
+  fd.fd      = STDIN_FILENO;
+  fd.events  = POLLIN;
+  fd.revents = 0;
+
+  if (poll(&fd, 1, 0) <= 0 || (fd.revents & POLLIN) == 0)
+    {
+      return 0;
+    }
+
+  nread = read(STDIN_FILENO, buffer, len);
+  return nread > 0 ? (size_t)nread : 0;
+}
+
 int up_putc(int ch)
 {
   /* Just map to the host fputc routine */
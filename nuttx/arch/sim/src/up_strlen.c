@@ -0,0 +1,119 @@
+/****************************************************************************
+ * arch/sim/src/up_strlen.c
+ *
+ *   Copyright (C) 2014 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef CONFIG_ARCH_STRLEN
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A 16-byte SSE2 register.  No x86 intrinsic headers are available in the
+ * NuttX include path so the GCC vector extensions are used directly.
+ */
+
+typedef char sse_v16qi __attribute__ ((vector_size(16)));
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sse_zeromask
+ *
+ * Description:
+ *   Return a bit mask with bit n set if byte n of the vector is zero.
+ *
+ ****************************************************************************/
+
+static inline unsigned int __attribute__ ((target("sse2")))
+sse_zeromask(sse_v16qi v)
+{
+  sse_v16qi zero = { 0 };
+  return (unsigned int)__builtin_ia32_pmovmskb128((sse_v16qi)(v == zero));
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: strlen
+ *
+ * Description:
+ *   SSE2 implementation of strlen().  The string is examined 16 bytes at a
+ *   time using aligned loads only;  an aligned load never crosses a page
+ *   boundary so bytes beyond the terminator are never faulted in.  The
+ *   first load starts at the aligned address below 's' and the bytes that
+ *   precede the string are masked out.
+ *
+ ****************************************************************************/
+
+size_t __attribute__ ((target("sse2"))) strlen(FAR const char *s)
+{
+  FAR const sse_v16qi *vp;
+  unsigned int offset;
+  unsigned int mask;
+
+  offset = (uintptr_t)s & 15;
+  vp     = (FAR const sse_v16qi *)((uintptr_t)s - offset);
+  mask   = sse_zeromask(*vp) >> offset;
+
+  if (mask != 0)
+    {
+      return __builtin_ctz(mask);
+    }
+
+  for (; ; )
+    {
+      vp++;
+      mask = sse_zeromask(*vp);
+      if (mask != 0)
+        {
+          return (FAR const char *)vp + __builtin_ctz(mask) - s;
+        }
+    }
+}
+
+#endif /* CONFIG_ARCH_STRLEN */
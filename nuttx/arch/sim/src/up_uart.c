@@ -0,0 +1,300 @@
+/****************************************************************************
+ * arch/sim/src/up_uart.c
+ *
+ *   Copyright (C) 2014 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/serial/serial.h>
+
+#include "up_internal.h"
+
+#ifdef USE_SIMUART
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int  uart_simsetup(FAR struct uart_dev_s *dev);
+static void uart_simshutdown(FAR struct uart_dev_s *dev);
+static int  uart_simattach(FAR struct uart_dev_s *dev);
+static void uart_simdetach(FAR struct uart_dev_s *dev);
+static int  uart_simioctl(FAR struct file *filep, int cmd, unsigned long arg);
+static int  uart_simreceive(FAR struct uart_dev_s *dev,
+                            FAR unsigned int *status);
+static void uart_simrxint(FAR struct uart_dev_s *dev, bool enable);
+static bool uart_simrxavailable(FAR struct uart_dev_s *dev);
+static void uart_simsend(FAR struct uart_dev_s *dev, int ch);
+static void uart_simtxint(FAR struct uart_dev_s *dev, bool enable);
+static bool uart_simtxready(FAR struct uart_dev_s *dev);
+static void uart_simdmasend(FAR struct uart_dev_s *dev);
+static void uart_simdmarxfree(FAR struct uart_dev_s *dev);
+static void uart_simdmatxavail(FAR struct uart_dev_s *dev);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct uart_ops_s g_uart_simops =
+{
+  .setup          = uart_simsetup,
+  .shutdown       = uart_simshutdown,
+  .attach         = uart_simattach,
+  .detach         = uart_simdetach,
+  .ioctl          = uart_simioctl,
+  .receive        = uart_simreceive,
+  .rxint          = uart_simrxint,
+  .rxavailable    = uart_simrxavailable,
+#ifdef CONFIG_SERIAL_IFLOWCONTROL
+  .rxflowcontrol  = NULL,
+#endif
+  .send           = uart_simsend,
+  .txint          = uart_simtxint,
+  .txready        = uart_simtxready,
+  .txempty        = uart_simtxready,
+  .dmasend        = uart_simdmasend,
+  .dmareceive     = NULL,  /* Input is polled by up_uartloop() */
+  .dmarxfree      = uart_simdmarxfree,
+  .dmatxavail     = uart_simdmatxavail,
+};
+
+/* I/O buffers */
+
+static char g_uartrxbuffer[CONFIG_SIM_UART_RXBUFSIZE];
+static char g_uarttxbuffer[CONFIG_SIM_UART_TXBUFSIZE];
+
+/* The console port */
+
+static uart_dev_t g_uartport =
+{
+  .isconsole      = true,
+  .recv           =
+  {
+    .size         = CONFIG_SIM_UART_RXBUFSIZE,
+    .buffer       = g_uartrxbuffer,
+  },
+  .xmit           =
+  {
+    .size         = CONFIG_SIM_UART_TXBUFSIZE,
+    .buffer       = g_uarttxbuffer,
+  },
+  .ops            = &g_uart_simops,
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static int uart_simsetup(FAR struct uart_dev_s *dev)
+{
+  return OK;
+}
+
+static void uart_simshutdown(FAR struct uart_dev_s *dev)
+{
+}
+
+static int uart_simattach(FAR struct uart_dev_s *dev)
+{
+  return OK;
+}
+
+static void uart_simdetach(FAR struct uart_dev_s *dev)
+{
+}
+
+static int uart_simioctl(FAR struct file *filep, int cmd, unsigned long arg)
+{
+  return -ENOTTY;
+}
+
+static int uart_simreceive(FAR struct uart_dev_s *dev,
+                           FAR unsigned int *status)
+{
+  *status = 0;
+  return 0;
+}
+
+static void uart_simrxint(FAR struct uart_dev_s *dev, bool enable)
+{
+}
+
+static bool uart_simrxavailable(FAR struct uart_dev_s *dev)
+{
+  /* Input is only received through the DMA interface */
+
+  return false;
+}
+
+static void uart_simsend(FAR struct uart_dev_s *dev, int ch)
+{
+  (void)up_putc(ch);
+}
+
+static void uart_simtxint(FAR struct uart_dev_s *dev, bool enable)
+{
+}
+
+static bool uart_simtxready(FAR struct uart_dev_s *dev)
+{
+  return true;
+}
+
+/****************************************************************************
+ * Name: uart_simdmasend
+ *
+ * Description:
+ *   Send the segments described by dev->dmatx to the host.  The host write
+ *   is synchronous so the transfer completes immediately.
+ *
+ ****************************************************************************/
+
+static void uart_simdmasend(FAR struct uart_dev_s *dev)
+{
+  FAR struct uart_dmaxfer_s *xfer = &dev->dmatx;
+  size_t nsent;
+
+  nsent = up_hostwrite(xfer->buffer, xfer->length);
+  if (nsent == xfer->length && xfer->nlength > 0)
+    {
+      nsent += up_hostwrite(xfer->nbuffer, xfer->nlength);
+    }
+
+  xfer->nbytes = nsent;
+  uart_xmitchars_done(dev);
+}
+
+/****************************************************************************
+ * Name: uart_simdmarxfree
+ *
+ * Description:
+ *   Space was freed in the RX buffer.  Set up a new receive transfer if the
+ *   last one stalled because the buffer was full.
+ *
+ ****************************************************************************/
+
+static void uart_simdmarxfree(FAR struct uart_dev_s *dev)
+{
+  irqstate_t flags = irqsave();
+  uart_recvchars_dma(dev);
+  irqrestore(flags);
+}
+
+/****************************************************************************
+ * Name: uart_simdmatxavail
+ *
+ * Description:
+ *   Data was added to the TX buffer.  Start a transfer if none is in
+ *   progress.
+ *
+ ****************************************************************************/
+
+static void uart_simdmatxavail(FAR struct uart_dev_s *dev)
+{
+  irqstate_t flags = irqsave();
+  uart_xmitchars_dma(dev);
+  irqrestore(flags);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_uartinit
+ *
+ * Description:
+ *   Register the serial console.
+ *
+ ****************************************************************************/
+
+void up_uartinit(void)
+{
+  (void)uart_register("/dev/console", &g_uartport);
+}
+
+/****************************************************************************
+ * Name: up_uartloop
+ *
+ * Description:
+ *   Called from the IDLE loop to poll for console input.  Whatever the host
+ *   has available is read directly into the free segments of the RX buffer
+ *   and handed to the serial driver as one block.  A host read that returns
+ *   less than was requested marks the end of a burst and plays the role of
+ *   the idle-line timeout.
+ *
+ ****************************************************************************/
+
+void up_uartloop(void)
+{
+  FAR struct uart_dmaxfer_s *xfer = &g_uartport.dmarx;
+  size_t nread;
+
+  if (xfer->length == 0)
+    {
+      uart_recvchars_dma(&g_uartport);
+      if (xfer->length == 0)
+        {
+          /* The RX buffer is full */
+
+          return;
+        }
+    }
+
+  nread = up_hostrecv(xfer->buffer, xfer->length);
+  if (nread == xfer->length && xfer->nlength > 0)
+    {
+      nread += up_hostrecv(xfer->nbuffer, xfer->nlength);
+    }
+
+  if (nread > 0)
+    {
+      xfer->nbytes = nread;
+      uart_recvchars_done(&g_uartport);
+      uart_recvchars_dma(&g_uartport);
+    }
+}
+
+#endif /* USE_SIMUART */
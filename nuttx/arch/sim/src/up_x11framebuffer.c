@@ -55,10 +55,31 @@
  * Definitions
  ****************************************************************************/
 
+/* Up to two display pages may be created in order to simulate page
+ * flipping.
+ */
+
+#define X11_NPAGES 2
+
 /****************************************************************************
  * Private Type Declarations
  ***************************************************************************/
 
+/* This structure describes one display page and the X11 image that shows
+ * it in the window.
+ */
+
+struct up_x11page_s
+{
+  XImage *image;              /* The image that shows the page */
+  unsigned char *fbmem;       /* The page memory */
+#ifndef CONFIG_SIM_X11NOSHM
+  XShmSegmentInfo shminfo;    /* Shared memory segment that holds the page */
+#endif
+  int checkpoint;             /* Initialization progress (for clean-up) */
+  int useshm;                 /* True: The page is in shared memory */
+};
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -80,15 +101,15 @@ static int g_screen;
 static Window g_window;
 static GC g_gc;
 #ifndef CONFIG_SIM_X11NOSHM
-static XShmSegmentInfo g_xshminfo;
 static int g_xerror;
 #endif
-static XImage *g_image;
-static unsigned char *g_framebuffer;
+static struct up_x11page_s g_pages[X11_NPAGES];
+static int g_npages;
+static int g_curpage;         /* The page shown in the window */
+static int g_depth;
+static unsigned int g_fblen;
 static unsigned short g_fbpixelwidth;
 static unsigned short g_fbpixelheight;
-static int g_shmcheckpoint = 0;
-static int b_useshm;
 
 /****************************************************************************
  * Name: up_x11createframe
@@ -190,162 +211,161 @@ static int up_x11untraperrors(void)
 #endif
 
 /****************************************************************************
- * Name: up_x11uninitX
+ * Name: up_x11freepage
  ***************************************************************************/
 
-static void up_x11uninitX(void)
+static void up_x11freepage(struct up_x11page_s *page)
 {
-  fprintf(stderr, "Uninitalizing X\n");
-  if (g_x11initialized)
-    {
 #ifndef CONFIG_SIM_X11NOSHM
-      if (g_shmcheckpoint > 4)
+  if (page->useshm)
+    {
+      if (page->checkpoint > 3)
         {
-          XShmDetach(g_display, &g_xshminfo);
+          XShmDetach(g_display, &page->shminfo);
         }
 
-      if (g_shmcheckpoint > 3)
+      if (page->checkpoint > 2)
         {
-          shmdt(g_xshminfo.shmaddr);
+          shmdt(page->shminfo.shmaddr);
         }
 
-      if (g_shmcheckpoint > 2)
+      if (page->checkpoint > 1)
         {
-          shmctl(g_xshminfo.shmid, IPC_RMID, 0);
+          shmctl(page->shminfo.shmid, IPC_RMID, 0);
         }
-#endif
 
-      if (g_shmcheckpoint > 1)
+      if (page->checkpoint > 0)
         {
-          XDestroyImage(g_image);
+          XDestroyImage(page->image);
         }
-
-      /* Un-grab the mouse buttons */
-
-#ifdef CONFIG_SIM_TOUCHSCREEN
-      XUngrabButton(g_display, Button1, AnyModifier, g_window);
+    }
+  else
 #endif
-      g_x11initialized = 0;
+  if (page->checkpoint > 0)
+    {
+      /* XDestroyImage() also frees the page memory */
+
+      XDestroyImage(page->image);
     }
 
-  XCloseDisplay(g_display);
+  page->image      = NULL;
+  page->fbmem      = NULL;
+  page->checkpoint = 0;
 }
 
 /****************************************************************************
- * Name: up_x11uninitialize
+ * Name: up_x11uninitX
  ***************************************************************************/
 
-#ifndef CONFIG_SIM_X11NOSHM
-static void up_x11uninitialize(void)
+static void up_x11uninitX(void)
 {
-  fprintf(stderr, "Uninitalizing\n");
-  if (g_shmcheckpoint > 1)
+  int i;
+
+  fprintf(stderr, "Uninitalizing X\n");
+  if (g_x11initialized)
     {
-      if (!b_useshm && g_framebuffer)
+      for (i = 0; i < g_npages; i++)
         {
-          free(g_framebuffer);
-          g_framebuffer = 0;
+          up_x11freepage(&g_pages[i]);
         }
-    }
 
-  if (g_shmcheckpoint > 0)
-    {
-      g_shmcheckpoint = 1;
+      /* Un-grab the mouse buttons */
+
+#ifdef CONFIG_SIM_TOUCHSCREEN
+      XUngrabButton(g_display, Button1, AnyModifier, g_window);
+#endif
+      g_x11initialized = 0;
     }
+
+  XCloseDisplay(g_display);
 }
-#endif
 
 /****************************************************************************
- * Name: up_x11mapsharedmem
+ * Name: up_x11createpage
+ *
+ * Description:
+ *   Allocate the memory for one display page and the image that shows it.
+ *   Shared memory is used if the X server supports it.
+ *
  ***************************************************************************/
 
-static inline int up_x11mapsharedmem(int depth, unsigned int fblen)
+static int up_x11createpage(struct up_x11page_s *page)
 {
 #ifndef CONFIG_SIM_X11NOSHM
   Status result;
-#endif
-
-  atexit(up_x11uninitX);
-  g_shmcheckpoint = 1;
-  b_useshm = 0;
+  char *shmaddr;
 
-#ifndef CONFIG_SIM_X11NOSHM
   if (XShmQueryExtension(g_display))
     {
-      b_useshm = 1;
+      page->useshm = 1;
       printf("Using shared memory.\n");
 
       up_x11traperrors();
-      g_image = XShmCreateImage(g_display, DefaultVisual(g_display, g_screen),
-                                depth, ZPixmap, NULL, &g_xshminfo,
-                                g_fbpixelwidth, g_fbpixelheight);
-      if (up_x11untraperrors())
+      page->image = XShmCreateImage(g_display, DefaultVisual(g_display, g_screen),
+                                    g_depth, ZPixmap, NULL, &page->shminfo,
+                                    g_fbpixelwidth, g_fbpixelheight);
+      if (up_x11untraperrors() || !page->image)
         {
-          up_x11uninitialize();
           goto shmerror;
         }
-      if (!g_image)
-        {
-          fprintf(stderr,"Unable to create g_image.");
-          return -1;
-        }
-      g_shmcheckpoint++;
+      page->checkpoint++;
 
-      g_xshminfo.shmid = shmget(IPC_PRIVATE,
-                              g_image->bytes_per_line * g_image->height,
-                              IPC_CREAT | 0777);
-      if (g_xshminfo.shmid < 0)
+      page->shminfo.shmid = shmget(IPC_PRIVATE,
+                                   page->image->bytes_per_line * page->image->height,
+                                   IPC_CREAT | 0777);
+      if (page->shminfo.shmid < 0)
         {
-          up_x11uninitialize();
           goto shmerror;
         }
-      g_shmcheckpoint++;
+      page->checkpoint++;
 
-      g_image->data = (char *) shmat(g_xshminfo.shmid, 0, 0);
-      if (g_image->data == ((char *) -1))
+      shmaddr = (char *)shmat(page->shminfo.shmid, 0, 0);
+      if (shmaddr == ((char *) -1))
         {
-          up_x11uninitialize();
           goto shmerror;
         }
-      g_shmcheckpoint++;
+      page->checkpoint++;
 
-      g_xshminfo.shmaddr = g_image->data;
-      g_xshminfo.readOnly = 0;
+      page->image->data       = shmaddr;
+      page->shminfo.shmaddr   = shmaddr;
+      page->shminfo.readOnly  = 0;
 
       up_x11traperrors();
-      result = XShmAttach(g_display, &g_xshminfo);
+      result = XShmAttach(g_display, &page->shminfo);
       if (up_x11untraperrors() || !result)
         {
-          up_x11uninitialize();
           goto shmerror;
         }
+      page->checkpoint++;
 
-      g_shmcheckpoint++;
+      page->fbmem = (unsigned char *)shmaddr;
+      return 0;
 
-    }
-  else
-#endif
-  if (!b_useshm)
-    {
-#ifndef CONFIG_SIM_X11NOSHM
 shmerror:
+      up_x11freepage(page);
+    }
 #endif
-      b_useshm = 0;
-
-      g_framebuffer = (unsigned char*)malloc(fblen);
 
-      g_image = XCreateImage(g_display, DefaultVisual(g_display,g_screen), depth,
-                             ZPixmap, 0, (char*)g_framebuffer, g_fbpixelwidth, g_fbpixelheight,
-                             8, 0);
-
-      if (g_image == NULL)
-         {
-            fprintf(stderr, "Unable to create g_image\n");
-            return -1;
-         }
+  page->useshm = 0;
+  page->fbmem  = (unsigned char *)malloc(g_fblen);
+  if (page->fbmem == NULL)
+    {
+      fprintf(stderr, "Unable to allocate the frame buffer\n");
+      return -1;
+    }
 
-      g_shmcheckpoint++;
+  page->image = XCreateImage(g_display, DefaultVisual(g_display, g_screen),
+                             g_depth, ZPixmap, 0, (char *)page->fbmem,
+                             g_fbpixelwidth, g_fbpixelheight, 8, 0);
+  if (page->image == NULL)
+    {
+      fprintf(stderr, "Unable to create g_image\n");
+      free(page->fbmem);
+      page->fbmem = NULL;
+      return -1;
     }
+
+  page->checkpoint++;
   return 0;
 }
 
@@ -405,20 +425,31 @@ int up_x11initialize(unsigned short width, unsigned short height,
       *stride = (depth * width / 8);
       *fblen  = (*stride * height);
 
-      /* Map the window to shared memory */
+      g_depth = windowAttributes.depth;
+      g_fblen = *fblen;
+
+      /* Create the first display page (in shared memory, if possible) */
 
-      up_x11mapsharedmem(windowAttributes.depth, *fblen);
+      atexit(up_x11uninitX);
       g_x11initialized = 1;
+
+      ret = up_x11createpage(&g_pages[0]);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      g_npages  = 1;
+      g_curpage = 0;
     }
 
-  *fbmem  = (void*)g_framebuffer;
+  *fbmem  = (void*)g_pages[0].fbmem;
   return 0;
 }
 
 /****************************************************************************
  * Name: up_x11cmap
  ***************************************************************************/
-
 int up_x11cmap(unsigned short first, unsigned short len,
                unsigned char *red, unsigned char *green,
                unsigned char *blue, unsigned char  *transp)
@@ -455,23 +486,78 @@ int up_x11cmap(unsigned short first, unsigned short len,
   return 0;
 }
 
+/****************************************************************************
+ * Name: up_x11backpage
+ *
+ * Description:
+ *   Create a second display page with its own image and return its memory
+ *   (or NULL if it cannot be created).  Used to simulate page flipping.
+ *
+ ***************************************************************************/
+
+void *up_x11backpage(void)
+{
+  if (!g_x11initialized || g_npages < 1)
+    {
+      return NULL;
+    }
+
+  if (g_npages < 2)
+    {
+      if (up_x11createpage(&g_pages[1]) < 0)
+        {
+          return NULL;
+        }
+
+      g_npages = 2;
+    }
+
+  return (void *)g_pages[1].fbmem;
+}
+
 /****************************************************************************
  * Name: up_x11update
  ***************************************************************************/
 
 void up_x11update(void)
 {
+  struct up_x11page_s *page = &g_pages[g_curpage];
+
 #ifndef CONFIG_SIM_X11NOSHM
-  if (b_useshm)
+  if (page->useshm)
     {
-      XShmPutImage(g_display, g_window, g_gc, g_image, 0, 0, 0, 0,
+      XShmPutImage(g_display, g_window, g_gc, page->image, 0, 0, 0, 0,
                    g_fbpixelwidth, g_fbpixelheight, 0);
     }
   else
 #endif
     {
-      XPutImage(g_display, g_window, g_gc, g_image, 0, 0, 0, 0,
+      XPutImage(g_display, g_window, g_gc, page->image, 0, 0, 0, 0,
                 g_fbpixelwidth, g_fbpixelheight);
     }
   XSync(g_display, 0);
 }
+
+/****************************************************************************
+ * Name: up_x11display
+ *
+ * Description:
+ *   Show the page at 'fbmem' in the X11 window.  Each page has its own
+ *   image so flipping only selects the image; nothing is copied.
+ *
+ ***************************************************************************/
+
+void up_x11display(void *fbmem)
+{
+  int i;
+
+  for (i = 0; i < g_npages; i++)
+    {
+      if ((void *)g_pages[i].fbmem == fbmem)
+        {
+          g_curpage = i;
+          up_x11update();
+          return;
+        }
+    }
+}
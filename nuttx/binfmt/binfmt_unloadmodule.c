@@ -154,19 +154,6 @@ int unload_module(FAR struct binary_s *binp)
 
   if (binp)
     {
-      /* Perform any format-specific unload operations */
-
-      if (binp->unload)
-        {
-          ret = binp->unload(binp);
-          if (ret < 0)
-            {
-              bdbg("binp->unload() failed: %d\n", ret);
-              set_errno(-ret);
-              return ERROR;
-            }
-        }
-
 #ifdef CONFIG_BINFMT_CONSTRUCTORS
       /* Execute C++ destructors */
 
@@ -179,6 +166,22 @@ int unload_module(FAR struct binary_s *binp)
         }
 #endif
 
+      /* Perform any format-specific unload operations.  This is done
+       * after the destructors have run:  The format may release the
+       * memory that holds them (e.g., a module cache reference).
+       */
+
+      if (binp->unload)
+        {
+          ret = binp->unload(binp);
+          if (ret < 0)
+            {
+              bdbg("binp->unload() failed: %d\n", ret);
+              set_errno(-ret);
+              return ERROR;
+            }
+        }
+
       /* Free any allocated argv[] strings */
 
       binfmt_freeargv(binp);
@@ -43,12 +43,14 @@
 #include <stdint.h>
 #include <string.h>
 #include <elf32.h>
+#include <syslog.h>
 #include <debug.h>
 #include <errno.h>
 
 #include <arpa/inet.h>
 
 #include <nuttx/arch.h>
+#include <nuttx/clock.h>
 #include <nuttx/binfmt/binfmt.h>
 #include <nuttx/binfmt/elf.h>
 
@@ -87,6 +89,9 @@
  ****************************************************************************/
 
 static int elf_loadbinary(FAR struct binary_s *binp);
+#ifdef CONFIG_ELF_MODCACHE
+static int elf_unloadbinary(FAR struct binary_s *binp);
+#endif
 #if defined(CONFIG_DEBUG) && defined(CONFIG_DEBUG_BINFMT)
 static void elf_dumploadinfo(FAR struct elf_loadinfo_s *loadinfo);
 #endif
@@ -99,7 +104,11 @@ static struct binfmt_s g_elfbinfmt =
 {
   NULL,             /* next */
   elf_loadbinary,   /* load */
+#ifdef CONFIG_ELF_MODCACHE
+  elf_unloadbinary, /* unload */
+#else
   NULL,             /* unload */
+#endif
 };
 
 /****************************************************************************
@@ -227,12 +236,31 @@ static void elf_dumpentrypt(FAR struct binary_s *binp,
 static int elf_loadbinary(FAR struct binary_s *binp)
 {
   struct elf_loadinfo_s loadinfo;  /* Contains globals for libelf */
+#ifdef CONFIG_ELF_LOADSTATS
+  uint32_t              start;
+  uint32_t              tinit;
+  uint32_t              tload;
+  uint32_t              tbind;
+#endif
   int                   ret;
 
   bvdbg("Loading file: %s\n", binp->filename);
 
+#ifdef CONFIG_ELF_MODCACHE
+  /* Is an idle, relocated copy of this module already in memory? */
+
+  if (elf_cache_load(binp) == OK)
+    {
+      bvdbg("Using cached module: %s\n", binp->filename);
+      return OK;
+    }
+#endif
+
   /* Initialize the ELF library to load the program binary. */
 
+#ifdef CONFIG_ELF_LOADSTATS
+  start = clock_systimer();
+#endif
   ret = elf_init(binp->filename, &loadinfo);
   elf_dumploadinfo(&loadinfo);
   if (ret != 0)
@@ -243,6 +271,9 @@ static int elf_loadbinary(FAR struct binary_s *binp)
 
   /* Load the program binary */
 
+#ifdef CONFIG_ELF_LOADSTATS
+  tinit = clock_systimer();
+#endif
   ret = elf_load(&loadinfo);
   elf_dumploadinfo(&loadinfo);
   if (ret != 0)
@@ -253,6 +284,9 @@ static int elf_loadbinary(FAR struct binary_s *binp)
 
   /* Bind the program to the exported symbol table */
 
+#ifdef CONFIG_ELF_LOADSTATS
+  tload = clock_systimer();
+#endif
   ret = elf_bind(&loadinfo, binp->exports, binp->nexports);
   if (ret != 0)
     {
@@ -260,6 +294,23 @@ static int elf_loadbinary(FAR struct binary_s *binp)
       goto errout_with_load;
     }
 
+#ifdef CONFIG_ELF_LOADSTATS
+  /* Report where the time went and how much file I/O was needed */
+
+  tbind = clock_systimer();
+  syslog("ELF %s: init %lu load %lu bind %lu msec; "
+         "%lu reads %lu bytes, %lu cached, %lu relocs, %lu symbols cached\n",
+         binp->filename,
+         (unsigned long)TICK2MSEC(tinit - start),
+         (unsigned long)TICK2MSEC(tload - tinit),
+         (unsigned long)TICK2MSEC(tbind - tload),
+         (unsigned long)loadinfo.stats.nreads,
+         (unsigned long)loadinfo.stats.nbytes,
+         (unsigned long)loadinfo.stats.ncached,
+         (unsigned long)loadinfo.stats.nrelocs,
+         (unsigned long)loadinfo.stats.nsymcached);
+#endif
+
   /* Return the load information */
 
   binp->entrypt   = (main_t)(loadinfo.textalloc + loadinfo.ehdr.e_entry);
@@ -301,6 +352,12 @@ static int elf_loadbinary(FAR struct binary_s *binp)
   up_addrenv_clone(&loadinfo.addrenv, &binp->addrenv);
 #endif
 
+#ifdef CONFIG_ELF_MODCACHE
+  /* Keep the relocated module in memory for the next time */
+
+  elf_cache_add(binp, &loadinfo);
+#endif
+
   elf_dumpentrypt(binp, &loadinfo);
   elf_uninit(&loadinfo);
   return OK;
@@ -313,6 +370,22 @@ errout:
   return ret;
 }
 
+/****************************************************************************
+ * Name: elf_unloadbinary
+ *
+ * Description:
+ *   Called by unload_module() when a module exits.  If the module was run
+ *   from the module cache, the cached image becomes available again.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ELF_MODCACHE
+static int elf_unloadbinary(FAR struct binary_s *binp)
+{
+  return elf_cache_release(binp);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -363,6 +436,12 @@ int elf_initialize(void)
 void elf_uninitialize(void)
 {
   unregister_binfmt(&g_elfbinfmt);
+
+#ifdef CONFIG_ELF_MODCACHE
+  /* Free the cached modules that are not running */
+
+  elf_cache_flush();
+#endif
 }
 
 #endif /* CONFIG_ELF */
@@ -90,6 +90,16 @@ int elf_verifyheader(FAR const Elf32_Ehdr *header);
 int elf_read(FAR struct elf_loadinfo_s *loadinfo, FAR uint8_t *buffer,
              size_t readsize, off_t offset);
 
+/****************************************************************************
+ * Name: elf_freecache
+ *
+ * Description:
+ *   Release the file read cache used by elf_read().
+ *
+ ****************************************************************************/
+
+void elf_freecache(FAR struct elf_loadinfo_s *loadinfo);
+
 /****************************************************************************
  * Name: elf_loadshdrs
  *
@@ -350,4 +360,64 @@ int elf_addrenv_alloc(FAR struct elf_loadinfo_s *loadinfo, size_t textsize,
 
 void elf_addrenv_free(FAR struct elf_loadinfo_s *loadinfo);
 
+/****************************************************************************
+ * Name: elf_cache_load
+ *
+ * Description:
+ *   Instantiate the module binp->filename from the module cache.
+ *
+ * Returned Value:
+ *   0 (OK) is returned if the module was instantiated from the cache.  A
+ *   negated errno value is returned if the module must be loaded from the
+ *   file.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ELF_MODCACHE
+struct binary_s;
+int elf_cache_load(FAR struct binary_s *binp);
+#endif
+
+/****************************************************************************
+ * Name: elf_cache_add
+ *
+ * Description:
+ *   Add a module that was just loaded and bound to the module cache.  On
+ *   success, the cache takes ownership of the module memory in
+ *   binp->alloc[].
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ELF_MODCACHE
+void elf_cache_add(FAR struct binary_s *binp,
+                   FAR const struct elf_loadinfo_s *loadinfo);
+#endif
+
+/****************************************************************************
+ * Name: elf_cache_release
+ *
+ * Description:
+ *   Release the cached module image used by an instance that has exited.
+ *
+ * Returned Value:
+ *   Always returns 0 (OK).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ELF_MODCACHE
+int elf_cache_release(FAR struct binary_s *binp);
+#endif
+
+/****************************************************************************
+ * Name: elf_cache_flush
+ *
+ * Description:
+ *   Free every cached module that is not in use.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ELF_MODCACHE
+void elf_cache_flush(void);
+#endif
+
 #endif /* __BINFMT_LIBELF_LIBELF_H */
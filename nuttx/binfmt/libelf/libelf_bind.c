@@ -46,6 +46,7 @@
 #include <assert.h>
 #include <debug.h>
 
+#include <nuttx/kmalloc.h>
 #include <nuttx/binfmt/elf.h>
 #include <nuttx/binfmt/symtab.h>
 
@@ -73,6 +74,12 @@
 # define elf_dumpbuffer(m,b,n)
 #endif
 
+/* Values of loadinfo->symstate[] */
+
+#define ELF_SYMSTATE_UNKNOWN  0 /* The symbol has not yet been resolved */
+#define ELF_SYMSTATE_RESOLVED 1 /* symcache[] holds the resolved symbol */
+#define ELF_SYMSTATE_NONAME   2 /* An undefined symbol with no name */
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -85,42 +92,12 @@
  * Private Functions
  ****************************************************************************/
 
-/****************************************************************************
- * Name: elf_readrel
- *
- * Description:
- *   Read the ELF32_Rel structure into memory.
- *
- ****************************************************************************/
-
-static inline int elf_readrel(FAR struct elf_loadinfo_s *loadinfo,
-                              FAR const Elf32_Shdr *relsec,
-                              int index, FAR Elf32_Rel *rel)
-{
-  off_t offset;
-
-  /* Verify that the symbol table index lies within symbol table */
-
-  if (index < 0 || index > (relsec->sh_size / sizeof(Elf32_Rel)))
-    {
-      bdbg("Bad relocation symbol index: %d\n", index);
-      return -EINVAL;
-    }
-
-  /* Get the file offset to the symbol table entry */
-
-  offset = relsec->sh_offset + sizeof(Elf32_Rel) * index;
-
-  /* And, finally, read the symbol table entry into memory */
-
-  return elf_read(loadinfo, (FAR uint8_t*)rel, sizeof(Elf32_Rel), offset);
-}
-
 /****************************************************************************
  * Name: elf_relocate and elf_relocateadd
  *
  * Description:
- *   Perform all relocations associated with a section.
+ *   Perform all relocations associated with a section.  The relocation
+ *   entries are read CONFIG_ELF_RELOCBATCH at a time into 'rels'.
  *
  * Returned Value:
  *   0 (OK) is returned on success and a negated errno is returned on
@@ -129,15 +106,17 @@ static inline int elf_readrel(FAR struct elf_loadinfo_s *loadinfo,
  ****************************************************************************/
 
 static int elf_relocate(FAR struct elf_loadinfo_s *loadinfo, int relidx,
-                        FAR const struct symtab_s *exports, int nexports)
+                        FAR const struct symtab_s *exports, int nexports,
+                        FAR Elf32_Rel *rels)
 
 {
   FAR Elf32_Shdr *relsec = &loadinfo->shdr[relidx];
   FAR Elf32_Shdr *dstsec = &loadinfo->shdr[relsec->sh_info];
-  Elf32_Rel       rel;
+  FAR Elf32_Rel  *rel;
   Elf32_Sym       sym;
   FAR Elf32_Sym  *psym;
   uintptr_t       addr;
+  int             nrels;
   int             symidx;
   int             ret;
   int             i;
@@ -147,91 +126,168 @@ static int elf_relocate(FAR struct elf_loadinfo_s *loadinfo, int relidx,
    * to be relocated.
    */
 
-  for (i = 0; i < relsec->sh_size / sizeof(Elf32_Rel); i++)
+  nrels = relsec->sh_size / sizeof(Elf32_Rel);
+  for (i = 0; i < nrels; i++)
     {
       psym = &sym;
 
-      /* Read the relocation entry into memory */
+      /* Read the next batch of relocation entries into memory */
 
-      ret = elf_readrel(loadinfo, relsec, i, &rel);
-      if (ret < 0)
+      if ((i % CONFIG_ELF_RELOCBATCH) == 0)
         {
-          bdbg("Section %d reloc %d: Failed to read relocation entry: %d\n",
-               relidx, i, ret);
-          return ret;
+          int nbatch = nrels - i;
+          if (nbatch > CONFIG_ELF_RELOCBATCH)
+            {
+              nbatch = CONFIG_ELF_RELOCBATCH;
+            }
+
+          ret = elf_read(loadinfo, (FAR uint8_t *)rels,
+                         nbatch * sizeof(Elf32_Rel),
+                         relsec->sh_offset + i * sizeof(Elf32_Rel));
+          if (ret < 0)
+            {
+              bdbg("Section %d reloc %d: Failed to read relocation entry: %d\n",
+                   relidx, i, ret);
+              return ret;
+            }
         }
 
+      rel = &rels[i % CONFIG_ELF_RELOCBATCH];
+
       /* Get the symbol table index for the relocation.  This is contained
        * in a bit-field within the r_info element.
        */
 
-      symidx = ELF32_R_SYM(rel.r_info);
+      symidx = ELF32_R_SYM(rel->r_info);
 
-      /* Read the symbol table entry into memory */
+#ifdef CONFIG_ELF_SYMCACHE
+      /* Has this symbol already been resolved? */
 
-      ret = elf_readsym(loadinfo, symidx, &sym);
-      if (ret < 0)
+      if (loadinfo->symcache && symidx >= 0 && symidx < loadinfo->nsyms &&
+          loadinfo->symstate[symidx] != ELF_SYMSTATE_UNKNOWN)
         {
-          bdbg("Section %d reloc %d: Failed to read symbol[%d]: %d\n",
-               relidx, i, symidx, ret);
-          return ret;
+          sym = loadinfo->symcache[symidx];
+          if (loadinfo->symstate[symidx] == ELF_SYMSTATE_NONAME)
+            {
+              psym = NULL;
+            }
+
+#ifdef CONFIG_ELF_LOADSTATS
+          loadinfo->stats.nsymcached++;
+#endif
         }
+      else
+#endif
+        {
+          /* Read the symbol table entry into memory */
 
-      /* Get the value of the symbol (in sym.st_value) */
+          ret = elf_readsym(loadinfo, symidx, &sym);
+          if (ret < 0)
+            {
+              bdbg("Section %d reloc %d: Failed to read symbol[%d]: %d\n",
+                   relidx, i, symidx, ret);
+              return ret;
+            }
 
-      ret = elf_symvalue(loadinfo, &sym, exports, nexports);
-      if (ret < 0)
-        {
-          /* The special error -ESRCH is returned only in one condition:  The
-           * symbol has no name.
-           *
-           * There are a few relocations for a few architectures that do
-           * no depend upon a named symbol.  We don't know if that is the
-           * case here, but we will use a NULL symbol pointer to indicate
-           * that case to up_relocate().  That function can then do what
-           * is best.
-           */
+          /* Get the value of the symbol (in sym.st_value) */
 
-          if (ret == -ESRCH)
+          ret = elf_symvalue(loadinfo, &sym, exports, nexports);
+          if (ret < 0)
             {
-              bdbg("Section %d reloc %d: Undefined symbol[%d] has no name: %d\n",
-                  relidx, i, symidx, ret);
-              psym = NULL;
+              /* The special error -ESRCH is returned only in one condition:
+               * The symbol has no name.
+               *
+               * There are a few relocations for a few architectures that do
+               * no depend upon a named symbol.  We don't know if that is the
+               * case here, but we will use a NULL symbol pointer to indicate
+               * that case to up_relocate().  That function can then do what
+               * is best.
+               */
+
+              if (ret == -ESRCH)
+                {
+                  bdbg("Section %d reloc %d: Undefined symbol[%d] has no name: %d\n",
+                      relidx, i, symidx, ret);
+                  psym = NULL;
+                }
+              else
+                {
+                  bdbg("Section %d reloc %d: Failed to get value of symbol[%d]: %d\n",
+                      relidx, i, symidx, ret);
+                  return ret;
+                }
             }
-          else
+
+#ifdef CONFIG_ELF_SYMCACHE
+          /* Remember the resolved symbol for the next relocation that
+           * refers to it.
+           */
+
+          if (loadinfo->symcache && symidx >= 0 && symidx < loadinfo->nsyms)
             {
-              bdbg("Section %d reloc %d: Failed to get value of symbol[%d]: %d\n",
-                  relidx, i, symidx, ret);
-              return ret;
+              loadinfo->symcache[symidx] = sym;
+              loadinfo->symstate[symidx] =
+                psym ? ELF_SYMSTATE_RESOLVED : ELF_SYMSTATE_NONAME;
             }
+#endif
         }
 
       /* Calculate the relocation address. */
 
-      if (rel.r_offset < 0 || rel.r_offset > dstsec->sh_size - sizeof(uint32_t))
+      if (rel->r_offset < 0 || rel->r_offset > dstsec->sh_size - sizeof(uint32_t))
         {
           bdbg("Section %d reloc %d: Relocation address out of range, offset %d size %d\n",
-               relidx, i, rel.r_offset, dstsec->sh_size);
+               relidx, i, rel->r_offset, dstsec->sh_size);
           return -EINVAL;
         }
 
-      addr = dstsec->sh_addr + rel.r_offset;
+      addr = dstsec->sh_addr + rel->r_offset;
 
       /* Now perform the architecture-specific relocation */
 
-      ret = up_relocate(&rel, psym, addr);
+      ret = up_relocate(rel, psym, addr);
       if (ret < 0)
         {
           bdbg("ERROR: Section %d reloc %d: Relocation failed: %d\n", ret);
           return ret;
         }
+
+#ifdef CONFIG_ELF_LOADSTATS
+      loadinfo->stats.nrelocs++;
+#endif
     }
 
   return OK;
 }
 
+/****************************************************************************
+ * Name: elf_freesymcache
+ *
+ * Description:
+ *   Release the symbol cache.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ELF_SYMCACHE
+static void elf_freesymcache(FAR struct elf_loadinfo_s *loadinfo)
+{
+  if (loadinfo->symcache)
+    {
+      kmm_free(loadinfo->symcache);
+      loadinfo->symcache = NULL;
+    }
+
+  if (loadinfo->symstate)
+    {
+      kmm_free(loadinfo->symstate);
+      loadinfo->symstate = NULL;
+    }
+}
+#endif
+
 static int elf_relocateadd(FAR struct elf_loadinfo_s *loadinfo, int relidx,
-                           FAR const struct symtab_s *exports, int nexports)
+                           FAR const struct symtab_s *exports, int nexports,
+                           FAR Elf32_Rel *rels)
 {
   bdbg("Not implemented\n");
   return -ENOSYS;
@@ -257,6 +313,7 @@ static int elf_relocateadd(FAR struct elf_loadinfo_s *loadinfo, int relidx,
 int elf_bind(FAR struct elf_loadinfo_s *loadinfo,
              FAR const struct symtab_s *exports, int nexports)
 {
+  FAR Elf32_Rel *rels;
 #ifdef CONFIG_ARCH_ADDRENV
   int status;
 #endif
@@ -282,6 +339,35 @@ int elf_bind(FAR struct elf_loadinfo_s *loadinfo,
       return -ENOMEM;
     }
 
+  /* Allocate a buffer to hold a batch of relocation entries */
+
+  rels = (FAR Elf32_Rel *)
+    kmm_malloc(CONFIG_ELF_RELOCBATCH * sizeof(Elf32_Rel));
+  if (!rels)
+    {
+      bdbg("Failed to allocate relocation buffer\n");
+      return -ENOMEM;
+    }
+
+#ifdef CONFIG_ELF_SYMCACHE
+  /* Allocate the symbol cache.  This is only an optimization:  If the
+   * memory is not available, each symbol is simply resolved every time
+   * that it is referenced.
+   */
+
+  loadinfo->nsyms    = loadinfo->shdr[loadinfo->symtabidx].sh_size /
+                       sizeof(Elf32_Sym);
+  loadinfo->symcache = (FAR Elf32_Sym *)
+                       kmm_malloc(loadinfo->nsyms * sizeof(Elf32_Sym));
+  loadinfo->symstate = (FAR uint8_t *)kmm_zalloc(loadinfo->nsyms);
+
+  if (!loadinfo->symcache || !loadinfo->symstate)
+    {
+      bvdbg("No symbol cache for %d symbols\n", loadinfo->nsyms);
+      elf_freesymcache(loadinfo);
+    }
+#endif
+
 #ifdef CONFIG_ARCH_ADDRENV
   /* If CONFIG_ARCH_ADDRENV=y, then the loaded ELF lies in a virtual address
    * space that may not be in place now.  elf_addrenv_select() will
@@ -292,7 +378,7 @@ int elf_bind(FAR struct elf_loadinfo_s *loadinfo,
   if (ret < 0)
     {
       bdbg("ERROR: elf_addrenv_select() failed: %d\n", ret);
-      return ret;
+      goto errout_with_buffers;
     }
 #endif
 
@@ -321,11 +407,11 @@ int elf_bind(FAR struct elf_loadinfo_s *loadinfo,
 
       if (loadinfo->shdr[i].sh_type == SHT_REL)
         {
-          ret = elf_relocate(loadinfo, i, exports, nexports);
+          ret = elf_relocate(loadinfo, i, exports, nexports, rels);
         }
       else if (loadinfo->shdr[i].sh_type == SHT_RELA)
         {
-          ret = elf_relocateadd(loadinfo, i, exports, nexports);
+          ret = elf_relocateadd(loadinfo, i, exports, nexports, rels);
         }
 
       if (ret < 0)
@@ -370,5 +456,12 @@ int elf_bind(FAR struct elf_loadinfo_s *loadinfo,
 
 #endif
 
+#ifdef CONFIG_ARCH_ADDRENV
+errout_with_buffers:
+#endif
+  kmm_free(rels);
+#ifdef CONFIG_ELF_SYMCACHE
+  elf_freesymcache(loadinfo);
+#endif
   return ret;
 }
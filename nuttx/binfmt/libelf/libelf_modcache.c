@@ -0,0 +1,493 @@
+/****************************************************************************
+ * binfmt/libelf/libelf_modcache.c
+ *
+ *   Copyright (C) 2014 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <stdint.h>
+#include <string.h>
+#include <sched.h>
+#include <debug.h>
+#include <errno.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/binfmt/binfmt.h>
+#include <nuttx/binfmt/elf.h>
+
+#include "libelf.h"
+
+#ifdef CONFIG_ELF_MODCACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_ELF_MODCACHE_NENTRIES
+#  define CONFIG_ELF_MODCACHE_NENTRIES 4
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This describes one relocated module that is kept in memory.  An ELF
+ * relocatable module is bound to the absolute addresses of its own .data
+ * and .bss, so the relocated .text can be used by only one running
+ * instance at a time.  When that instance exits, the image is kept and
+ * the next launch only has to restore the initial content of .data/.bss.
+ */
+
+struct elf_modcache_s
+{
+  FAR struct elf_modcache_s *flink;  /* Supports a singly linked list */
+  FAR char          *filename;       /* Absolute path to the ELF file */
+  time_t             mtime;          /* Modification time of the file */
+  off_t              filelen;        /* Size of the file */
+  FAR uint8_t       *image;          /* Relocated .text + .data/.bss */
+  FAR uint8_t       *datainit;       /* Initial content of .data/.bss */
+  size_t             textsize;       /* Size of the .text region */
+  size_t             datasize;       /* Size of the .data/.bss region */
+  main_t             entrypt;        /* Entry point into the module */
+#ifdef CONFIG_BINFMT_CONSTRUCTORS
+  FAR void          *ctoralloc;      /* Memory allocated for ctors */
+  FAR void          *dtoralloc;      /* Memory allocated dtors */
+  FAR binfmt_ctor_t *ctors;          /* Pointer to a list of constructors */
+  FAR binfmt_dtor_t *dtors;          /* Pointer to a list of destructors */
+  uint16_t           nctors;         /* Number of constructors */
+  uint16_t           ndtors;         /* Number of destructors */
+#endif
+  uint32_t           lastuse;        /* For least-recently-used replacement */
+  uint8_t            crefs;          /* Number of running instances */
+  bool               stale;          /* The file has changed */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR struct elf_modcache_s *g_elfcache;  /* List of cached modules */
+static uint32_t g_elfcacheseq;                  /* Access sequence number */
+static int g_elfcachecount;                     /* Number of cached modules */
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: elf_cache_remove
+ *
+ * Description:
+ *   Remove an entry from the list of cached modules.  Must be called with
+ *   pre-emption disabled.
+ *
+ ****************************************************************************/
+
+static void elf_cache_remove(FAR struct elf_modcache_s *entry)
+{
+  FAR struct elf_modcache_s *prev;
+  FAR struct elf_modcache_s *curr;
+
+  for (prev = NULL, curr = g_elfcache;
+       curr && curr != entry;
+       prev = curr, curr = curr->flink);
+
+  if (curr)
+    {
+      if (prev)
+        {
+          prev->flink = curr->flink;
+        }
+      else
+        {
+          g_elfcache = curr->flink;
+        }
+
+      g_elfcachecount--;
+    }
+}
+
+/****************************************************************************
+ * Name: elf_cache_free
+ *
+ * Description:
+ *   Free a cache entry.  If 'binp' is non-NULL, the module image is handed
+ *   over to binp->alloc[] so that it is freed by unload_module() (after the
+ *   static destructors have been executed).  Otherwise, it is freed now.
+ *
+ ****************************************************************************/
+
+static void elf_cache_free(FAR struct elf_modcache_s *entry,
+                           FAR struct binary_s *binp)
+{
+  if (binp)
+    {
+      binp->alloc[0] = entry->image;
+#ifdef CONFIG_BINFMT_CONSTRUCTORS
+      binp->alloc[1] = entry->ctoralloc;
+      binp->alloc[2] = entry->dtoralloc;
+#endif
+    }
+  else
+    {
+      kumm_free(entry->image);
+#ifdef CONFIG_BINFMT_CONSTRUCTORS
+      if (entry->ctoralloc)
+        {
+          kumm_free(entry->ctoralloc);
+        }
+
+      if (entry->dtoralloc)
+        {
+          kumm_free(entry->dtoralloc);
+        }
+#endif
+    }
+
+  if (entry->datainit)
+    {
+      kmm_free(entry->datainit);
+    }
+
+  kmm_free(entry->filename);
+  kmm_free(entry);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: elf_cache_load
+ *
+ * Description:
+ *   Instantiate the module binp->filename from the module cache.  This
+ *   succeeds only if the module is cached, the file has not changed since
+ *   it was loaded, and no other instance of the module is running.
+ *
+ * Returned Value:
+ *   0 (OK) is returned if the module was instantiated from the cache.  A
+ *   negated errno value is returned if the module must be loaded from the
+ *   file:  -ENOENT if the module is not cached and -EBUSY if the cached
+ *   image is in use.
+ *
+ ****************************************************************************/
+
+int elf_cache_load(FAR struct binary_s *binp)
+{
+  FAR struct elf_modcache_s *entry;
+  struct stat buf;
+
+  if (!g_elfcache || stat(binp->filename, &buf) < 0)
+    {
+      return -ENOENT;
+    }
+
+  sched_lock();
+  for (entry = g_elfcache; entry; entry = entry->flink)
+    {
+      if (!entry->stale && strcmp(entry->filename, binp->filename) == 0)
+        {
+          break;
+        }
+    }
+
+  if (!entry)
+    {
+      sched_unlock();
+      return -ENOENT;
+    }
+
+  /* Discard the cached image if the file has been replaced */
+
+  if (entry->mtime != buf.st_mtime || entry->filelen != buf.st_size)
+    {
+      bvdbg("%s has changed\n", binp->filename);
+
+      if (entry->crefs > 0)
+        {
+          /* Free the image when the running instance exits */
+
+          entry->stale = true;
+        }
+      else
+        {
+          elf_cache_remove(entry);
+          elf_cache_free(entry, NULL);
+        }
+
+      sched_unlock();
+      return -ENOENT;
+    }
+
+  if (entry->crefs > 0)
+    {
+      sched_unlock();
+      return -EBUSY;
+    }
+
+  entry->crefs++;
+  entry->lastuse = ++g_elfcacheseq;
+  sched_unlock();
+
+  /* Restore the initial .data and .bss.  The .text and any constructor and
+   * destructor lists are unchanged since they were relocated.
+   */
+
+  if (entry->datasize > 0)
+    {
+      memcpy(entry->image + entry->textsize, entry->datainit,
+             entry->datasize);
+    }
+
+  binp->entrypt   = entry->entrypt;
+  binp->stacksize = CONFIG_ELF_STACKSIZE;
+
+#ifdef CONFIG_BINFMT_CONSTRUCTORS
+  binp->ctors     = entry->ctors;
+  binp->nctors    = entry->nctors;
+  binp->dtors     = entry->dtors;
+  binp->ndtors    = entry->ndtors;
+#endif
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: elf_cache_add
+ *
+ * Description:
+ *   Add a module that was just loaded and bound to the module cache.  On
+ *   success, ownership of the module memory passes from binp->alloc[] to
+ *   the cache.  If the module cannot be cached (no memory, or every cache
+ *   entry is in use), binp is not modified and the module is unloaded
+ *   normally.
+ *
+ ****************************************************************************/
+
+void elf_cache_add(FAR struct binary_s *binp,
+                   FAR const struct elf_loadinfo_s *loadinfo)
+{
+  FAR struct elf_modcache_s *entry;
+  FAR struct elf_modcache_s *curr;
+  FAR struct elf_modcache_s *victim;
+  struct stat buf;
+
+  if (stat(binp->filename, &buf) < 0)
+    {
+      return;
+    }
+
+  /* Allocate the cache entry and save the initial .data/.bss */
+
+  entry = (FAR struct elf_modcache_s *)
+    kmm_zalloc(sizeof(struct elf_modcache_s));
+  if (!entry)
+    {
+      return;
+    }
+
+  entry->filename = (FAR char *)kmm_malloc(strlen(binp->filename) + 1);
+  if (!entry->filename)
+    {
+      goto errout_with_entry;
+    }
+
+  strcpy(entry->filename, binp->filename);
+
+  if (loadinfo->datasize > 0)
+    {
+      entry->datainit = (FAR uint8_t *)kmm_malloc(loadinfo->datasize);
+      if (!entry->datainit)
+        {
+          goto errout_with_filename;
+        }
+
+      memcpy(entry->datainit, (FAR const void *)loadinfo->dataalloc,
+             loadinfo->datasize);
+    }
+
+  entry->mtime     = buf.st_mtime;
+  entry->filelen   = buf.st_size;
+  entry->image     = (FAR uint8_t *)loadinfo->textalloc;
+  entry->textsize  = loadinfo->textsize;
+  entry->datasize  = loadinfo->datasize;
+  entry->entrypt   = binp->entrypt;
+#ifdef CONFIG_BINFMT_CONSTRUCTORS
+  entry->ctoralloc = loadinfo->ctoralloc;
+  entry->dtoralloc = loadinfo->dtoralloc;
+  entry->ctors     = loadinfo->ctors;
+  entry->dtors     = loadinfo->dtors;
+  entry->nctors    = loadinfo->nctors;
+  entry->ndtors    = loadinfo->ndtors;
+#endif
+  entry->crefs     = 1;
+
+  sched_lock();
+
+  /* If another instance already owns the cache entry for this file, this
+   * one is a private copy.
+   */
+
+  for (curr = g_elfcache; curr; curr = curr->flink)
+    {
+      if (!curr->stale && strcmp(curr->filename, binp->filename) == 0)
+        {
+          goto errout_with_lock;
+        }
+    }
+
+  /* Make room by discarding the least recently used idle module */
+
+  if (g_elfcachecount >= CONFIG_ELF_MODCACHE_NENTRIES)
+    {
+      victim = NULL;
+      for (curr = g_elfcache; curr; curr = curr->flink)
+        {
+          if (curr->crefs == 0 &&
+              (!victim || curr->lastuse < victim->lastuse))
+            {
+              victim = curr;
+            }
+        }
+
+      if (!victim)
+        {
+          goto errout_with_lock;
+        }
+
+      bvdbg("Discarding %s\n", victim->filename);
+      elf_cache_remove(victim);
+      elf_cache_free(victim, NULL);
+    }
+
+  entry->lastuse = ++g_elfcacheseq;
+  entry->flink   = g_elfcache;
+  g_elfcache     = entry;
+  g_elfcachecount++;
+  sched_unlock();
+
+  /* The cache now owns the module memory */
+
+  binp->alloc[0] = NULL;
+#ifdef CONFIG_BINFMT_CONSTRUCTORS
+  binp->alloc[1] = NULL;
+  binp->alloc[2] = NULL;
+#endif
+  return;
+
+errout_with_lock:
+  sched_unlock();
+  if (entry->datainit)
+    {
+      kmm_free(entry->datainit);
+    }
+
+errout_with_filename:
+  kmm_free(entry->filename);
+errout_with_entry:
+  kmm_free(entry);
+}
+
+/****************************************************************************
+ * Name: elf_cache_release
+ *
+ * Description:
+ *   Called from unload_module() when an instance of a module exits, after
+ *   its destructors have run.  If the module came from the cache, the
+ *   cached image becomes available for the next launch (or, if the file
+ *   has changed in the meantime, is freed).
+ *
+ * Returned Value:
+ *   Always returns 0 (OK).
+ *
+ ****************************************************************************/
+
+int elf_cache_release(FAR struct binary_s *binp)
+{
+  FAR struct elf_modcache_s *entry;
+
+  sched_lock();
+  for (entry = g_elfcache; entry; entry = entry->flink)
+    {
+      if (entry->crefs > 0 && entry->entrypt == binp->entrypt)
+        {
+          entry->crefs--;
+          if (entry->stale && entry->crefs == 0)
+            {
+              elf_cache_remove(entry);
+              elf_cache_free(entry, binp);
+            }
+
+          break;
+        }
+    }
+
+  sched_unlock();
+  return OK;
+}
+
+/****************************************************************************
+ * Name: elf_cache_flush
+ *
+ * Description:
+ *   Free every cached module that is not in use.
+ *
+ ****************************************************************************/
+
+void elf_cache_flush(void)
+{
+  FAR struct elf_modcache_s *entry;
+  FAR struct elf_modcache_s *next;
+
+  sched_lock();
+  for (entry = g_elfcache; entry; entry = next)
+    {
+      next = entry->flink;
+      if (entry->crefs == 0)
+        {
+          elf_cache_remove(entry);
+          elf_cache_free(entry, NULL);
+        }
+    }
+
+  sched_unlock();
+}
+
+#endif /* CONFIG_ELF_MODCACHE */
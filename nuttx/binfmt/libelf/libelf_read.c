@@ -47,6 +47,7 @@
 #include <debug.h>
 #include <errno.h>
 
+#include <nuttx/kmalloc.h>
 #include <nuttx/binfmt/elf.h>
 
 /****************************************************************************
@@ -91,55 +92,56 @@ static inline void elf_dumpreaddata(char *buffer, int buflen)
 #endif
 
 /****************************************************************************
- * Public Functions
- ****************************************************************************/
-
-/****************************************************************************
- * Name: elf_read
+ * Name: elf_readfile
  *
  * Description:
- *   Read 'readsize' bytes from the object file at 'offset'.  The data is
- *   read into 'buffer.' If 'buffer' is part of the ELF address environment,
- *   then the caller is responsibile for assuring that that address
- *   environment is in place before calling this function (i.e., that
- *   elf_addrenv_select() has been called if CONFIG_ARCH_ADDRENV=y).
- *
- * Returned Value:
- *   0 (OK) is returned on success and a negated errno is returned on
- *   failure.
+ *   Read 'readsize' bytes from the object file at 'offset' using read().
+ *   The file is only repositioned if 'offset' is not the current file
+ *   position.
  *
  ****************************************************************************/
 
-int elf_read(FAR struct elf_loadinfo_s *loadinfo, FAR uint8_t *buffer,
-             size_t readsize, off_t offset)
+static int elf_readfile(FAR struct elf_loadinfo_s *loadinfo,
+                        FAR uint8_t *buffer, size_t readsize, off_t offset)
 {
   ssize_t nbytes;      /* Number of bytes read */
   off_t   rpos;        /* Position returned by lseek */
 
-  bvdbg("Read %ld bytes from offset %ld\n", (long)readsize, (long)offset);
-
   /* Loop until all of the requested data has been read. */
 
   while (readsize > 0)
     {
       /* Seek to the next read position */
 
-      rpos = lseek(loadinfo->filfd, offset, SEEK_SET);
-      if (rpos != offset)
+      if (offset != loadinfo->filepos)
         {
-          int errval = errno;
-          bdbg("Failed to seek to position %lu: %d\n",
-               (unsigned long)offset, errval);
-          return -errval;
+          rpos = lseek(loadinfo->filfd, offset, SEEK_SET);
+          if (rpos != offset)
+            {
+              int errval = errno;
+              bdbg("Failed to seek to position %lu: %d\n",
+                   (unsigned long)offset, errval);
+              loadinfo->filepos = -1;
+              return -errval;
+            }
+
+          loadinfo->filepos = offset;
         }
 
       /* Read the file data at offset into the user buffer */
 
        nbytes = read(loadinfo->filfd, buffer, readsize);
+#ifdef CONFIG_ELF_LOADSTATS
+       loadinfo->stats.nreads++;
+#endif
        if (nbytes < 0)
          {
            int errval = errno;
 
+           /* The file position is now unknown */
+
+           loadinfo->filepos = -1;
+
            /* EINTR just means that we received a signal */
 
            if (errval != EINTR)
@@ -159,9 +161,230 @@ int elf_read(FAR struct elf_loadinfo_s *loadinfo, FAR uint8_t *buffer,
            readsize -= nbytes;
            buffer   += nbytes;
            offset   += nbytes;
+           loadinfo->filepos = offset;
+#ifdef CONFIG_ELF_LOADSTATS
+           loadinfo->stats.nbytes += nbytes;
+#endif
          }
     }
 
-  elf_dumpreaddata(buffer, readsize);
   return OK;
 }
+
+/****************************************************************************
+ * Name: elf_fillcache
+ *
+ * Description:
+ *   Read the chunk of the file that contains 'offset' into the least
+ *   recently used cache chunk.
+ *
+ * Returned Value:
+ *   A reference to the cache chunk on success; NULL on failure with the
+ *   negated errno value in *errcode.
+ *
+ ****************************************************************************/
+
+#if CONFIG_ELF_CACHESIZE > 0
+static FAR struct elf_cache_s *elf_fillcache(FAR struct elf_loadinfo_s *loadinfo,
+                                             off_t offset, FAR int *errcode)
+{
+  FAR struct elf_cache_s *chunk;
+  int ret;
+  int i;
+
+  /* Select the least recently used chunk */
+
+  chunk = &loadinfo->cache[0];
+  for (i = 1; i < ELF_CACHE_NCHUNKS; i++)
+    {
+      if (loadinfo->cache[i].lastuse < chunk->lastuse)
+        {
+          chunk = &loadinfo->cache[i];
+        }
+    }
+
+  /* Allocate the chunk buffer on first use */
+
+  if (!chunk->buffer)
+    {
+      chunk->buffer = (FAR uint8_t *)kmm_malloc(CONFIG_ELF_CACHESIZE);
+      if (!chunk->buffer)
+        {
+          *errcode = -ENOMEM;
+          return NULL;
+        }
+    }
+
+  /* Read the entire chunk (or whatever remains of the file) */
+
+  chunk->nbytes = 0;
+  chunk->offset = offset - (offset % CONFIG_ELF_CACHESIZE);
+
+  if (chunk->offset >= loadinfo->filelen)
+    {
+      bdbg("Unexpected end of file\n");
+      *errcode = -ENODATA;
+      return NULL;
+    }
+
+  chunk->nbytes = loadinfo->filelen - chunk->offset;
+  if (chunk->nbytes > CONFIG_ELF_CACHESIZE)
+    {
+      chunk->nbytes = CONFIG_ELF_CACHESIZE;
+    }
+
+  ret = elf_readfile(loadinfo, chunk->buffer, chunk->nbytes, chunk->offset);
+  if (ret < 0)
+    {
+      chunk->nbytes = 0;
+      *errcode = ret;
+      return NULL;
+    }
+
+  return chunk;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: elf_read
+ *
+ * Description:
+ *   Read 'readsize' bytes from the object file at 'offset'.  The data is
+ *   read into 'buffer.' If 'buffer' is part of the ELF address environment,
+ *   then the caller is responsibile for assuring that that address
+ *   environment is in place before calling this function (i.e., that
+ *   elf_addrenv_select() has been called if CONFIG_ARCH_ADDRENV=y).
+ *
+ *   If the file is mapped in memory, the data is simply copied.  Otherwise,
+ *   reads smaller than CONFIG_ELF_CACHESIZE are satisfied from the file
+ *   read cache and larger reads go directly to the file.
+ *
+ * Returned Value:
+ *   0 (OK) is returned on success and a negated errno is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+int elf_read(FAR struct elf_loadinfo_s *loadinfo, FAR uint8_t *buffer,
+             size_t readsize, off_t offset)
+{
+  int ret;
+
+  bvdbg("Read %ld bytes from offset %ld\n", (long)readsize, (long)offset);
+
+  /* Reads beyond the end of the file can never be satisfied */
+
+  if (offset < 0 || offset > loadinfo->filelen ||
+      readsize > loadinfo->filelen - offset)
+    {
+      bdbg("Unexpected end of file\n");
+      return -ENODATA;
+    }
+
+  /* Execute-in-place:  The file is already in memory */
+
+  if (loadinfo->filemap)
+    {
+      memcpy(buffer, &loadinfo->filemap[offset], readsize);
+      elf_dumpreaddata(buffer, readsize);
+      return OK;
+    }
+
+#if CONFIG_ELF_CACHESIZE > 0
+  /* Small reads are copied from the cache, refilling it as necessary */
+
+  if (readsize < CONFIG_ELF_CACHESIZE)
+    {
+      FAR struct elf_cache_s *chunk;
+      FAR uint8_t *dest = buffer;
+      size_t remaining = readsize;
+      size_t ncopy;
+      int i;
+
+      while (remaining > 0)
+        {
+          /* Look for a chunk that holds the data at 'offset' */
+
+          chunk = NULL;
+          for (i = 0; i < ELF_CACHE_NCHUNKS; i++)
+            {
+              if (offset >= loadinfo->cache[i].offset &&
+                  offset <  loadinfo->cache[i].offset +
+                            (off_t)loadinfo->cache[i].nbytes)
+                {
+                  chunk = &loadinfo->cache[i];
+#ifdef CONFIG_ELF_LOADSTATS
+                  loadinfo->stats.ncached++;
+#endif
+                  break;
+                }
+            }
+
+          if (!chunk)
+            {
+              chunk = elf_fillcache(loadinfo, offset, &ret);
+              if (!chunk)
+                {
+                  return ret;
+                }
+            }
+
+          chunk->lastuse = ++loadinfo->cacheseq;
+
+          ncopy = chunk->offset + chunk->nbytes - offset;
+          if (ncopy > remaining)
+            {
+              ncopy = remaining;
+            }
+
+          memcpy(dest, &chunk->buffer[offset - chunk->offset], ncopy);
+          dest      += ncopy;
+          offset    += ncopy;
+          remaining -= ncopy;
+        }
+
+      elf_dumpreaddata(buffer, readsize);
+      return OK;
+    }
+#endif
+
+  /* Large reads go directly to the file */
+
+  ret = elf_readfile(loadinfo, buffer, readsize, offset);
+  if (ret == OK)
+    {
+      elf_dumpreaddata(buffer, readsize);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: elf_freecache
+ *
+ * Description:
+ *   Release the file read cache.
+ *
+ ****************************************************************************/
+
+void elf_freecache(FAR struct elf_loadinfo_s *loadinfo)
+{
+#if CONFIG_ELF_CACHESIZE > 0
+  int i;
+
+  for (i = 0; i < ELF_CACHE_NCHUNKS; i++)
+    {
+      if (loadinfo->cache[i].buffer)
+        {
+          kmm_free(loadinfo->cache[i].buffer);
+          loadinfo->cache[i].buffer = NULL;
+        }
+
+      loadinfo->cache[i].nbytes = 0;
+    }
+#endif
+}
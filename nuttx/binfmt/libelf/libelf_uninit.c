@@ -82,6 +82,7 @@ int elf_uninit(struct elf_loadinfo_s *loadinfo)
   /* Free all working buffers */
 
   elf_freebuffers(loadinfo);
+  elf_freecache(loadinfo);
 
   /* Close the ELF file */
 
@@ -90,9 +90,12 @@ symtab_findbyvalue(FAR const struct symtab_s *symtab,
   DEBUGASSERT(symtab != NULL);
   for (; nsyms > 0; symtab++, nsyms--)
     {
-      /* Look for symbols of lesser or equal value (probably address) to value */
+      /* Look for symbols of lesser or equal value (probably address) to
+       * value.  Unused slots in a hashed symbol table have no name.
+       */
 
-      if (symtab->sym_value <= value)
+      if (symtab->sym_name != NULL && symtab->sym_name[0] != '\0' &&
+          symtab->sym_value <= value)
         {
           /* Found one.  Is it the largest we have found so far? */
 
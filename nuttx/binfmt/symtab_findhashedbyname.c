@@ -0,0 +1,140 @@
+/****************************************************************************
+ * binfmt/symtab_findhashedbyname.c
+ *
+ *   Copyright (C) 2014 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <debug.h>
+#include <assert.h>
+
+#include <nuttx/binfmt/symtab.h>
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: symtab_hash
+ *
+ * Description:
+ *   Return the hash of a symbol name.  This is the System V ELF hash
+ *   function; tools/mksymtab.c uses the same function to lay out hashed
+ *   symbol tables and the two must always agree.
+ *
+ ****************************************************************************/
+
+uint32_t symtab_hash(FAR const char *name)
+{
+  uint32_t hash = 0;
+  uint32_t high;
+
+  while (*name)
+    {
+      hash = (hash << 4) + (uint8_t)*name++;
+      high = hash & 0xf0000000;
+      if (high)
+        {
+          hash ^= high >> 24;
+        }
+
+      hash &= ~high;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: symtab_findhashedbyname
+ *
+ * Description:
+ *   Find the symbol in the symbol table with the matching name.  This
+ *   version assumes that the table was generated by 'mksymtab -h':  Each
+ *   symbol lies at, or at the first free slot after, the slot selected by
+ *   its hash and unused slots have a NULL sym_name.  Access time is then
+ *   independent of nsyms on average.
+ *
+ *   The probe only ends at an unused slot or after all nsyms slots have
+ *   been examined so the lookup also succeeds, in linear time, in a table
+ *   that has no hashed layout.
+ *
+ * Returned Value:
+ *   A reference to the symbol table entry if an entry with the matching
+ *   name is found; NULL is returned if the entry is not found.
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *
+symtab_findhashedbyname(FAR const struct symtab_s *symtab,
+                        FAR const char *name, int nsyms)
+{
+  FAR const struct symtab_s *entry;
+  int ndx;
+  int i;
+
+  DEBUGASSERT(symtab != NULL && name != NULL);
+  if (nsyms <= 0)
+    {
+      return NULL;
+    }
+
+  ndx = (int)(symtab_hash(name) % (uint32_t)nsyms);
+  for (i = 0; i < nsyms; i++)
+    {
+      entry = &symtab[ndx];
+      if (entry->sym_name == NULL)
+        {
+          /* An unused slot ends the chain */
+
+          break;
+        }
+
+      if (strcmp(name, entry->sym_name) == 0)
+        {
+          return entry;
+        }
+
+      if (++ndx >= nsyms)
+        {
+          ndx = 0;
+        }
+    }
+
+  return NULL;
+}
@@ -0,0 +1,1633 @@
+/****************************************************************************
+ * crypto/aes.c
+ * Portable software AES with ECB, CBC, CTR and GCM modes
+ *
+ *   Copyright (C) 2014 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <semaphore.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/crypto/crypto.h>
+#include <nuttx/crypto/aes.h>
+
+#ifdef CONFIG_CRYPTO_SW_AES
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Number of blocks processed together by the chained modes.  This bounds
+ * the stack usage of the keystream and CBC buffers.
+ */
+
+#define AES_CHUNK      4
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* GCM state for one message */
+
+struct aes_gcm_s
+{
+  uint32_t h[4];                /* Hash subkey H as big-endian words */
+  uint32_t y[4];                /* Running GHASH value */
+  uint8_t  j0[AES_BLOCK_SIZE];  /* Pre-counter block */
+  uint8_t  cb[AES_BLOCK_SIZE];  /* Current counter block */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Round constants of the key schedule */
+
+static const uint8_t g_rcon[10] =
+{
+  0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1b, 0x36
+};
+
+#ifdef CONFIG_CRYPTO_SW_AES_TABLES
+/* S-box, inverse S-box and the combined SubBytes/MixColumns tables.  The
+ * tables are computed by aes_gentables() rather than stored in FLASH.
+ * g_te[x] holds the column {02,01,01,03}.S[x] and g_td[x] holds the column
+ * {0e,09,0d,0b}.InvS[x], row 0 in the least significant byte; the tables
+ * for the other rows are byte rotations of these.
+ */
+
+static uint8_t  g_sbox[256];
+static uint8_t  g_invsbox[256];
+static uint32_t g_te[256];
+static uint32_t g_td[256];
+static volatile bool g_tablesready;
+#endif
+
+/* Cached key schedule used by aes_cypher() */
+
+static struct aes_ctx_s g_cyphctx;
+static uint8_t g_cyphkey[32];
+static uint32_t g_cyphkeysize;
+static sem_t g_cyphsem;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: aes_getle32, aes_putle32, aes_getbe32, aes_putbe32
+ ****************************************************************************/
+
+static inline uint32_t aes_getle32(FAR const uint8_t *p)
+{
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+         ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline void aes_putle32(FAR uint8_t *p, uint32_t x)
+{
+  p[0] = (uint8_t)x;
+  p[1] = (uint8_t)(x >> 8);
+  p[2] = (uint8_t)(x >> 16);
+  p[3] = (uint8_t)(x >> 24);
+}
+
+static inline uint32_t aes_getbe32(FAR const uint8_t *p)
+{
+  return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+         ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+static inline void aes_putbe32(FAR uint8_t *p, uint32_t x)
+{
+  p[0] = (uint8_t)(x >> 24);
+  p[1] = (uint8_t)(x >> 16);
+  p[2] = (uint8_t)(x >> 8);
+  p[3] = (uint8_t)x;
+}
+
+/****************************************************************************
+ * Name: aes_xorblock
+ ****************************************************************************/
+
+static inline void aes_xorblock(FAR uint8_t *out, FAR const uint8_t *a,
+                                FAR const uint8_t *b, size_t len)
+{
+  size_t i;
+
+  for (i = 0; i < len; i++)
+    {
+      out[i] = a[i] ^ b[i];
+    }
+}
+
+#ifdef CONFIG_CRYPTO_SW_AES_TABLES
+/****************************************************************************
+ * Table-driven AES
+ *
+ * Each round is four table look-ups per column.  This is the fastest
+ * portable implementation, but the table indices depend on the key and
+ * data, so it is not safe against cache-timing attacks.
+ *
+ ****************************************************************************/
+
+#define ROL8(x)   (((x) << 8) | ((x) >> 24))
+#define ROL16(x)  (((x) << 16) | ((x) >> 16))
+#define ROL24(x)  (((x) << 24) | ((x) >> 8))
+
+/****************************************************************************
+ * Name: aes_gmul
+ *
+ * Description:
+ *   Multiplication in GF(2^8) with the AES polynomial.  Only used to build
+ *   the tables.
+ *
+ ****************************************************************************/
+
+static uint8_t aes_gmul(uint8_t a, uint8_t b)
+{
+  uint8_t p = 0;
+
+  while (b)
+    {
+      if (b & 1)
+        {
+          p ^= a;
+        }
+
+      a = (uint8_t)((a << 1) ^ ((a & 0x80) ? 0x1b : 0));
+      b >>= 1;
+    }
+
+  return p;
+}
+
+/****************************************************************************
+ * Name: aes_gentables
+ ****************************************************************************/
+
+static void aes_gentables(void)
+{
+  uint8_t inv;
+  uint8_t s;
+  uint8_t x;
+  int i;
+  int j;
+
+  for (i = 0; i < 256; i++)
+    {
+      /* The multiplicative inverse (0 maps to 0) */
+
+      inv = 0;
+      for (j = 1; i != 0 && j < 256; j++)
+        {
+          if (aes_gmul((uint8_t)i, (uint8_t)j) == 1)
+            {
+              inv = (uint8_t)j;
+              break;
+            }
+        }
+
+      /* The affine transformation */
+
+      x = inv;
+      s = inv;
+      for (j = 0; j < 4; j++)
+        {
+          x = (uint8_t)((x << 1) | (x >> 7));
+          s ^= x;
+        }
+
+      s ^= 0x63;
+      g_sbox[i]   = s;
+      g_invsbox[s] = (uint8_t)i;
+    }
+
+  for (i = 0; i < 256; i++)
+    {
+      s = g_sbox[i];
+      g_te[i] = (uint32_t)aes_gmul(s, 2) | ((uint32_t)s << 8) |
+                ((uint32_t)s << 16) | ((uint32_t)aes_gmul(s, 3) << 24);
+
+      s = g_invsbox[i];
+      g_td[i] = (uint32_t)aes_gmul(s, 14) |
+                ((uint32_t)aes_gmul(s, 9) << 8) |
+                ((uint32_t)aes_gmul(s, 13) << 16) |
+                ((uint32_t)aes_gmul(s, 11) << 24);
+    }
+
+  g_tablesready = true;
+}
+
+/****************************************************************************
+ * Name: aes_subword
+ ****************************************************************************/
+
+static uint32_t aes_subword(uint32_t x)
+{
+  return (uint32_t)g_sbox[x & 0xff] |
+         ((uint32_t)g_sbox[(x >> 8) & 0xff] << 8) |
+         ((uint32_t)g_sbox[(x >> 16) & 0xff] << 16) |
+         ((uint32_t)g_sbox[x >> 24] << 24);
+}
+
+/****************************************************************************
+ * Name: aes_invmixword
+ *
+ * Description:
+ *   InvMixColumns of one column.  g_td[] includes InvSubBytes, which is
+ *   cancelled by looking up S[x].
+ *
+ ****************************************************************************/
+
+static uint32_t aes_invmixword(uint32_t x)
+{
+  uint32_t t0 = g_td[g_sbox[x & 0xff]];
+  uint32_t t1 = g_td[g_sbox[(x >> 8) & 0xff]];
+  uint32_t t2 = g_td[g_sbox[(x >> 16) & 0xff]];
+  uint32_t t3 = g_td[g_sbox[x >> 24]];
+
+  return t0 ^ ROL8(t1) ^ ROL16(t2) ^ ROL24(t3);
+}
+
+/****************************************************************************
+ * Name: aes_keysched
+ *
+ * Description:
+ *   Convert the expanded key w[] into the encryption schedule (rk[0..59])
+ *   and the equivalent inverse cipher schedule (rk[60..119]).
+ *
+ ****************************************************************************/
+
+static void aes_keysched(FAR struct aes_ctx_s *ctx, FAR const uint32_t *w)
+{
+  FAR uint32_t *ek = ctx->rk;
+  FAR uint32_t *dk = ctx->rk + 4 * (AES_MAXROUNDS + 1);
+  int nr = ctx->nr;
+  int i;
+  int j;
+
+  memcpy(ek, w, 16 * (nr + 1));
+
+  for (i = 0; i <= nr; i++)
+    {
+      for (j = 0; j < 4; j++)
+        {
+          uint32_t x = w[4 * (nr - i) + j];
+          dk[4 * i + j] = (i == 0 || i == nr) ? x : aes_invmixword(x);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: aes_encblocks
+ ****************************************************************************/
+
+static void aes_encblocks(FAR const struct aes_ctx_s *ctx, FAR uint8_t *out,
+                          FAR const uint8_t *in, size_t nblocks)
+{
+  FAR const uint32_t *rk;
+  uint32_t s0, s1, s2, s3;
+  uint32_t t0, t1, t2, t3;
+  int r;
+
+  for (; nblocks > 0; nblocks--, in += AES_BLOCK_SIZE, out += AES_BLOCK_SIZE)
+    {
+      rk = ctx->rk;
+      s0 = aes_getle32(in)      ^ rk[0];
+      s1 = aes_getle32(in + 4)  ^ rk[1];
+      s2 = aes_getle32(in + 8)  ^ rk[2];
+      s3 = aes_getle32(in + 12) ^ rk[3];
+
+      for (r = 1; r < ctx->nr; r++)
+        {
+          rk += 4;
+          t0 = g_te[s0 & 0xff] ^ ROL8(g_te[(s1 >> 8) & 0xff]) ^
+               ROL16(g_te[(s2 >> 16) & 0xff]) ^ ROL24(g_te[s3 >> 24]) ^ rk[0];
+          t1 = g_te[s1 & 0xff] ^ ROL8(g_te[(s2 >> 8) & 0xff]) ^
+               ROL16(g_te[(s3 >> 16) & 0xff]) ^ ROL24(g_te[s0 >> 24]) ^ rk[1];
+          t2 = g_te[s2 & 0xff] ^ ROL8(g_te[(s3 >> 8) & 0xff]) ^
+               ROL16(g_te[(s0 >> 16) & 0xff]) ^ ROL24(g_te[s1 >> 24]) ^ rk[2];
+          t3 = g_te[s3 & 0xff] ^ ROL8(g_te[(s0 >> 8) & 0xff]) ^
+               ROL16(g_te[(s1 >> 16) & 0xff]) ^ ROL24(g_te[s2 >> 24]) ^ rk[3];
+          s0 = t0;
+          s1 = t1;
+          s2 = t2;
+          s3 = t3;
+        }
+
+      /* Final round: SubBytes and ShiftRows only */
+
+      rk += 4;
+      t0 = (uint32_t)g_sbox[s0 & 0xff] |
+           ((uint32_t)g_sbox[(s1 >> 8) & 0xff] << 8) |
+           ((uint32_t)g_sbox[(s2 >> 16) & 0xff] << 16) |
+           ((uint32_t)g_sbox[s3 >> 24] << 24);
+      t1 = (uint32_t)g_sbox[s1 & 0xff] |
+           ((uint32_t)g_sbox[(s2 >> 8) & 0xff] << 8) |
+           ((uint32_t)g_sbox[(s3 >> 16) & 0xff] << 16) |
+           ((uint32_t)g_sbox[s0 >> 24] << 24);
+      t2 = (uint32_t)g_sbox[s2 & 0xff] |
+           ((uint32_t)g_sbox[(s3 >> 8) & 0xff] << 8) |
+           ((uint32_t)g_sbox[(s0 >> 16) & 0xff] << 16) |
+           ((uint32_t)g_sbox[s1 >> 24] << 24);
+      t3 = (uint32_t)g_sbox[s3 & 0xff] |
+           ((uint32_t)g_sbox[(s0 >> 8) & 0xff] << 8) |
+           ((uint32_t)g_sbox[(s1 >> 16) & 0xff] << 16) |
+           ((uint32_t)g_sbox[s2 >> 24] << 24);
+
+      aes_putle32(out,      t0 ^ rk[0]);
+      aes_putle32(out + 4,  t1 ^ rk[1]);
+      aes_putle32(out + 8,  t2 ^ rk[2]);
+      aes_putle32(out + 12, t3 ^ rk[3]);
+    }
+}
+
+/****************************************************************************
+ * Name: aes_decblocks
+ ****************************************************************************/
+
+static void aes_decblocks(FAR const struct aes_ctx_s *ctx, FAR uint8_t *out,
+                          FAR const uint8_t *in, size_t nblocks)
+{
+  FAR const uint32_t *rk;
+  uint32_t s0, s1, s2, s3;
+  uint32_t t0, t1, t2, t3;
+  int r;
+
+  for (; nblocks > 0; nblocks--, in += AES_BLOCK_SIZE, out += AES_BLOCK_SIZE)
+    {
+      rk = ctx->rk + 4 * (AES_MAXROUNDS + 1);
+      s0 = aes_getle32(in)      ^ rk[0];
+      s1 = aes_getle32(in + 4)  ^ rk[1];
+      s2 = aes_getle32(in + 8)  ^ rk[2];
+      s3 = aes_getle32(in + 12) ^ rk[3];
+
+      for (r = 1; r < ctx->nr; r++)
+        {
+          rk += 4;
+          t0 = g_td[s0 & 0xff] ^ ROL8(g_td[(s3 >> 8) & 0xff]) ^
+               ROL16(g_td[(s2 >> 16) & 0xff]) ^ ROL24(g_td[s1 >> 24]) ^ rk[0];
+          t1 = g_td[s1 & 0xff] ^ ROL8(g_td[(s0 >> 8) & 0xff]) ^
+               ROL16(g_td[(s3 >> 16) & 0xff]) ^ ROL24(g_td[s2 >> 24]) ^ rk[1];
+          t2 = g_td[s2 & 0xff] ^ ROL8(g_td[(s1 >> 8) & 0xff]) ^
+               ROL16(g_td[(s0 >> 16) & 0xff]) ^ ROL24(g_td[s3 >> 24]) ^ rk[2];
+          t3 = g_td[s3 & 0xff] ^ ROL8(g_td[(s2 >> 8) & 0xff]) ^
+               ROL16(g_td[(s1 >> 16) & 0xff]) ^ ROL24(g_td[s0 >> 24]) ^ rk[3];
+          s0 = t0;
+          s1 = t1;
+          s2 = t2;
+          s3 = t3;
+        }
+
+      /* Final round: InvSubBytes and InvShiftRows only */
+
+      rk += 4;
+      t0 = (uint32_t)g_invsbox[s0 & 0xff] |
+           ((uint32_t)g_invsbox[(s3 >> 8) & 0xff] << 8) |
+           ((uint32_t)g_invsbox[(s2 >> 16) & 0xff] << 16) |
+           ((uint32_t)g_invsbox[s1 >> 24] << 24);
+      t1 = (uint32_t)g_invsbox[s1 & 0xff] |
+           ((uint32_t)g_invsbox[(s0 >> 8) & 0xff] << 8) |
+           ((uint32_t)g_invsbox[(s3 >> 16) & 0xff] << 16) |
+           ((uint32_t)g_invsbox[s2 >> 24] << 24);
+      t2 = (uint32_t)g_invsbox[s2 & 0xff] |
+           ((uint32_t)g_invsbox[(s1 >> 8) & 0xff] << 8) |
+           ((uint32_t)g_invsbox[(s0 >> 16) & 0xff] << 16) |
+           ((uint32_t)g_invsbox[s3 >> 24] << 24);
+      t3 = (uint32_t)g_invsbox[s3 & 0xff] |
+           ((uint32_t)g_invsbox[(s2 >> 8) & 0xff] << 8) |
+           ((uint32_t)g_invsbox[(s1 >> 16) & 0xff] << 16) |
+           ((uint32_t)g_invsbox[s0 >> 24] << 24);
+
+      aes_putle32(out,      t0 ^ rk[0]);
+      aes_putle32(out + 4,  t1 ^ rk[1]);
+      aes_putle32(out + 8,  t2 ^ rk[2]);
+      aes_putle32(out + 12, t3 ^ rk[3]);
+    }
+}
+
+#else /* CONFIG_CRYPTO_SW_AES_TABLES */
+/****************************************************************************
+ * Bitsliced AES
+ *
+ * Two blocks are processed in parallel in eight 32-bit words.  Word q[i]
+ * holds bit i of each of the 32 state bytes: row r of the state occupies
+ * bits 8r..8r+7, column c bits 8r+2c and 8r+2c+1 (one for each block).
+ * SubBytes is evaluated as a Boolean circuit (Boyar and Peralta) on the
+ * eight words, so that there are no data-dependent memory accesses or
+ * branches: the execution time does not depend on the key or the data.
+ *
+ ****************************************************************************/
+
+#define ROR8(x)   (((x) >> 8) | ((x) << 24))
+#define ROR16(x)  (((x) >> 16) | ((x) << 16))
+
+/* Exchange the bits selected by cl in x with the bits selected by ch in y */
+
+#define AES_SWAPN(cl, ch, s, x, y) \
+  do \
+    { \
+      uint32_t a_ = (x); \
+      uint32_t b_ = (y); \
+      (x) = (a_ & (uint32_t)(cl)) | ((b_ & (uint32_t)(cl)) << (s)); \
+      (y) = ((a_ & (uint32_t)(ch)) >> (s)) | (b_ & (uint32_t)(ch)); \
+    } \
+  while (0)
+
+/****************************************************************************
+ * Name: aes_ortho
+ *
+ * Description:
+ *   Transpose the 8x8 bit matrix formed by each byte lane of the eight
+ *   words.  The transformation is its own inverse.
+ *
+ ****************************************************************************/
+
+static void aes_ortho(FAR uint32_t *q)
+{
+  AES_SWAPN(0x55555555, 0xaaaaaaaa, 1, q[0], q[1]);
+  AES_SWAPN(0x55555555, 0xaaaaaaaa, 1, q[2], q[3]);
+  AES_SWAPN(0x55555555, 0xaaaaaaaa, 1, q[4], q[5]);
+  AES_SWAPN(0x55555555, 0xaaaaaaaa, 1, q[6], q[7]);
+
+  AES_SWAPN(0x33333333, 0xcccccccc, 2, q[0], q[2]);
+  AES_SWAPN(0x33333333, 0xcccccccc, 2, q[1], q[3]);
+  AES_SWAPN(0x33333333, 0xcccccccc, 2, q[4], q[6]);
+  AES_SWAPN(0x33333333, 0xcccccccc, 2, q[5], q[7]);
+
+  AES_SWAPN(0x0f0f0f0f, 0xf0f0f0f0, 4, q[0], q[4]);
+  AES_SWAPN(0x0f0f0f0f, 0xf0f0f0f0, 4, q[1], q[5]);
+  AES_SWAPN(0x0f0f0f0f, 0xf0f0f0f0, 4, q[2], q[6]);
+  AES_SWAPN(0x0f0f0f0f, 0xf0f0f0f0, 4, q[3], q[7]);
+}
+
+/****************************************************************************
+ * Name: aes_sbox
+ *
+ * Description:
+ *   Bitsliced SubBytes: the S-box circuit of Boyar and Peralta (a linear
+ *   input layer, a non-linear GF(2^4) inversion layer and a linear output
+ *   layer).  x0 is the most significant bit.
+ *
+ ****************************************************************************/
+
+static void aes_sbox(FAR uint32_t *q)
+{
+  uint32_t x0, x1, x2, x3, x4, x5, x6, x7;
+  uint32_t y1, y2, y3, y4, y5, y6, y7, y8, y9, y10, y11;
+  uint32_t y12, y13, y14, y15, y16, y17, y18, y19, y20, y21;
+  uint32_t z0, z1, z2, z3, z4, z5, z6, z7, z8;
+  uint32_t z9, z10, z11, z12, z13, z14, z15, z16, z17;
+  uint32_t t0, t1, t2, t3, t4, t5, t6, t7, t8, t9;
+  uint32_t t10, t11, t12, t13, t14, t15, t16, t17, t18, t19;
+  uint32_t t20, t21, t22, t23, t24, t25, t26, t27, t28, t29;
+  uint32_t t30, t31, t32, t33, t34, t35, t36, t37, t38, t39;
+  uint32_t t40, t41, t42, t43, t44, t45, t46, t47, t48, t49;
+  uint32_t t50, t51, t52, t53, t54, t55, t56, t57, t58, t59;
+  uint32_t t60, t61, t62, t63, t64, t65, t66, t67;
+  uint32_t s0, s1, s2, s3, s4, s5, s6, s7;
+
+  x0 = q[7];
+  x1 = q[6];
+  x2 = q[5];
+  x3 = q[4];
+  x4 = q[3];
+  x5 = q[2];
+  x6 = q[1];
+  x7 = q[0];
+
+  /* Top linear transformation */
+
+  y14 = x3 ^ x5;
+  y13 = x0 ^ x6;
+  y9  = x0 ^ x3;
+  y8  = x0 ^ x5;
+  t0  = x1 ^ x2;
+  y1  = t0 ^ x7;
+  y4  = y1 ^ x3;
+  y12 = y13 ^ y14;
+  y2  = y1 ^ x0;
+  y5  = y1 ^ x6;
+  y3  = y5 ^ y8;
+  t1  = x4 ^ y12;
+  y15 = t1 ^ x5;
+  y20 = t1 ^ x1;
+  y6  = y15 ^ x7;
+  y10 = y15 ^ t0;
+  y11 = y20 ^ y9;
+  y7  = x7 ^ y11;
+  y17 = y10 ^ y11;
+  y19 = y10 ^ y8;
+  y16 = t0 ^ y11;
+  y21 = y13 ^ y16;
+  y18 = x0 ^ y16;
+
+  /* Non-linear section */
+
+  t2  = y12 & y15;
+  t3  = y3 & y6;
+  t4  = t3 ^ t2;
+  t5  = y4 & x7;
+  t6  = t5 ^ t2;
+  t7  = y13 & y16;
+  t8  = y5 & y1;
+  t9  = t8 ^ t7;
+  t10 = y2 & y7;
+  t11 = t10 ^ t7;
+  t12 = y9 & y11;
+  t13 = y14 & y17;
+  t14 = t13 ^ t12;
+  t15 = y8 & y10;
+  t16 = t15 ^ t12;
+  t17 = t4 ^ t14;
+  t18 = t6 ^ t16;
+  t19 = t9 ^ t14;
+  t20 = t11 ^ t16;
+  t21 = t17 ^ y20;
+  t22 = t18 ^ y19;
+  t23 = t19 ^ y21;
+  t24 = t20 ^ y18;
+
+  t25 = t21 ^ t22;
+  t26 = t21 & t23;
+  t27 = t24 ^ t26;
+  t28 = t25 & t27;
+  t29 = t28 ^ t22;
+  t30 = t23 ^ t24;
+  t31 = t22 ^ t26;
+  t32 = t31 & t30;
+  t33 = t32 ^ t24;
+  t34 = t23 ^ t33;
+  t35 = t27 ^ t33;
+  t36 = t24 & t35;
+  t37 = t36 ^ t34;
+  t38 = t27 ^ t36;
+  t39 = t29 & t38;
+  t40 = t25 ^ t39;
+
+  t41 = t40 ^ t37;
+  t42 = t29 ^ t33;
+  t43 = t29 ^ t40;
+  t44 = t33 ^ t37;
+  t45 = t42 ^ t41;
+  z0  = t44 & y15;
+  z1  = t37 & y6;
+  z2  = t33 & x7;
+  z3  = t43 & y16;
+  z4  = t40 & y1;
+  z5  = t29 & y7;
+  z6  = t42 & y11;
+  z7  = t45 & y17;
+  z8  = t41 & y10;
+  z9  = t44 & y12;
+  z10 = t37 & y3;
+  z11 = t33 & y4;
+  z12 = t43 & y13;
+  z13 = t40 & y5;
+  z14 = t29 & y2;
+  z15 = t42 & y9;
+  z16 = t45 & y14;
+  z17 = t41 & y8;
+
+  /* Bottom linear transformation */
+
+  t46 = z15 ^ z16;
+  t47 = z10 ^ z11;
+  t48 = z5 ^ z13;
+  t49 = z9 ^ z10;
+  t50 = z2 ^ z12;
+  t51 = z2 ^ z5;
+  t52 = z7 ^ z8;
+  t53 = z0 ^ z3;
+  t54 = z6 ^ z7;
+  t55 = z16 ^ z17;
+  t56 = z12 ^ t48;
+  t57 = t50 ^ t53;
+  t58 = z4 ^ t46;
+  t59 = z3 ^ t54;
+  t60 = t46 ^ t57;
+  t61 = z14 ^ t57;
+  t62 = t52 ^ t58;
+  t63 = t49 ^ t58;
+  t64 = z4 ^ t59;
+  t65 = t61 ^ t62;
+  t66 = z1 ^ t63;
+  s0  = t59 ^ t63;
+  s6  = t56 ^ ~t62;
+  s7  = t48 ^ ~t60;
+  t67 = t64 ^ t65;
+  s3  = t53 ^ t66;
+  s4  = t51 ^ t66;
+  s5  = t47 ^ t65;
+  s1  = t64 ^ ~s3;
+  s2  = t55 ^ ~t67;
+
+  q[7] = s0;
+  q[6] = s1;
+  q[5] = s2;
+  q[4] = s3;
+  q[3] = s4;
+  q[2] = s5;
+  q[1] = s6;
+  q[0] = s7;
+}
+
+/****************************************************************************
+ * Name: aes_invaffine
+ *
+ * Description:
+ *   y -> B(y ^ 0x63) where B is the inverse of the linear part of the
+ *   S-box affine transformation.  The inverse S-box is computed from the
+ *   forward circuit as InvS(y) = B(S(B(y ^ 0x63)) ^ 0x63).
+ *
+ ****************************************************************************/
+
+static void aes_invaffine(FAR uint32_t *q)
+{
+  uint32_t q0 = ~q[0];
+  uint32_t q1 = ~q[1];
+  uint32_t q2 = q[2];
+  uint32_t q3 = q[3];
+  uint32_t q4 = q[4];
+  uint32_t q5 = ~q[5];
+  uint32_t q6 = ~q[6];
+  uint32_t q7 = q[7];
+
+  q[7] = q1 ^ q4 ^ q6;
+  q[6] = q0 ^ q3 ^ q5;
+  q[5] = q7 ^ q2 ^ q4;
+  q[4] = q6 ^ q1 ^ q3;
+  q[3] = q5 ^ q0 ^ q2;
+  q[2] = q4 ^ q7 ^ q1;
+  q[1] = q3 ^ q6 ^ q0;
+  q[0] = q2 ^ q5 ^ q7;
+}
+
+static void aes_invsbox(FAR uint32_t *q)
+{
+  aes_invaffine(q);
+  aes_sbox(q);
+  aes_invaffine(q);
+}
+
+/****************************************************************************
+ * Name: aes_shiftrows and aes_invshiftrows
+ ****************************************************************************/
+
+static void aes_shiftrows(FAR uint32_t *q)
+{
+  uint32_t x;
+  int i;
+
+  for (i = 0; i < 8; i++)
+    {
+      x    = q[i];
+      q[i] = (x & 0x000000ff) |
+             ((x & 0x0000fc00) >> 2) | ((x & 0x00000300) << 6) |
+             ((x & 0x00f00000) >> 4) | ((x & 0x000f0000) << 4) |
+             ((x & 0xc0000000) >> 6) | ((x & 0x3f000000) << 2);
+    }
+}
+
+static void aes_invshiftrows(FAR uint32_t *q)
+{
+  uint32_t x;
+  int i;
+
+  for (i = 0; i < 8; i++)
+    {
+      x    = q[i];
+      q[i] = (x & 0x000000ff) |
+             ((x & 0x00003f00) << 2) | ((x & 0x0000c000) >> 6) |
+             ((x & 0x00f00000) >> 4) | ((x & 0x000f0000) << 4) |
+             ((x & 0x03000000) << 6) | ((x & 0xfc000000) >> 2);
+    }
+}
+
+/****************************************************************************
+ * Name: aes_mixcolumns
+ *
+ * Description:
+ *   out[r] = 2.a[r] + 3.a[r+1] + a[r+2] + a[r+3]
+ *          = 2.(a[r] + a[r+1]) + a[r+1] + (a[r+2] + a[r+3])
+ *   Rotating a word by 8 bits moves row r+1 to row r.
+ *
+ ****************************************************************************/
+
+static void aes_mixcolumns(FAR uint32_t *q)
+{
+  uint32_t q0 = q[0], q1 = q[1], q2 = q[2], q3 = q[3];
+  uint32_t q4 = q[4], q5 = q[5], q6 = q[6], q7 = q[7];
+  uint32_t r0 = ROR8(q0), r1 = ROR8(q1), r2 = ROR8(q2), r3 = ROR8(q3);
+  uint32_t r4 = ROR8(q4), r5 = ROR8(q5), r6 = ROR8(q6), r7 = ROR8(q7);
+
+  q[0] = q7 ^ r7 ^ r0 ^ ROR16(q0 ^ r0);
+  q[1] = q0 ^ r0 ^ q7 ^ r7 ^ r1 ^ ROR16(q1 ^ r1);
+  q[2] = q1 ^ r1 ^ r2 ^ ROR16(q2 ^ r2);
+  q[3] = q2 ^ r2 ^ q7 ^ r7 ^ r3 ^ ROR16(q3 ^ r3);
+  q[4] = q3 ^ r3 ^ q7 ^ r7 ^ r4 ^ ROR16(q4 ^ r4);
+  q[5] = q4 ^ r4 ^ r5 ^ ROR16(q5 ^ r5);
+  q[6] = q5 ^ r5 ^ r6 ^ ROR16(q6 ^ r6);
+  q[7] = q6 ^ r6 ^ r7 ^ ROR16(q7 ^ r7);
+}
+
+/****************************************************************************
+ * Name: aes_invmixcolumns
+ *
+ * Description:
+ *   InvMixColumns is MixColumns preceded by multiplication with
+ *   {04}x^2 + {05}:  u[r] = a[r] + 4.(a[r] + a[r+2]).
+ *
+ ****************************************************************************/
+
+static void aes_invmixcolumns(FAR uint32_t *q)
+{
+  uint32_t t[8];
+  uint32_t x;
+  int i;
+  int n;
+
+  for (i = 0; i < 8; i++)
+    {
+      t[i] = q[i] ^ ROR16(q[i]);
+    }
+
+  /* Multiply by {02} twice */
+
+  for (n = 0; n < 2; n++)
+    {
+      x    = t[7];
+      t[7] = t[6];
+      t[6] = t[5];
+      t[5] = t[4];
+      t[4] = t[3] ^ x;
+      t[3] = t[2] ^ x;
+      t[2] = t[1];
+      t[1] = t[0] ^ x;
+      t[0] = x;
+    }
+
+  for (i = 0; i < 8; i++)
+    {
+      q[i] ^= t[i];
+    }
+
+  aes_mixcolumns(q);
+}
+
+/****************************************************************************
+ * Name: aes_addroundkey
+ ****************************************************************************/
+
+static inline void aes_addroundkey(FAR uint32_t *q, FAR const uint32_t *sk)
+{
+  int i;
+
+  for (i = 0; i < 8; i++)
+    {
+      q[i] ^= sk[i];
+    }
+}
+
+/****************************************************************************
+ * Name: aes_subword
+ ****************************************************************************/
+
+static uint32_t aes_subword(uint32_t x)
+{
+  uint32_t q[8];
+
+  memset(q, 0, sizeof(q));
+  q[0] = x;
+  aes_ortho(q);
+  aes_sbox(q);
+  aes_ortho(q);
+  return q[0];
+}
+
+/****************************************************************************
+ * Name: aes_keysched
+ *
+ * Description:
+ *   Convert the expanded key w[] into bitsliced round keys, the same key
+ *   for both blocks.
+ *
+ ****************************************************************************/
+
+static void aes_keysched(FAR struct aes_ctx_s *ctx, FAR const uint32_t *w)
+{
+  FAR uint32_t *sk = ctx->rk;
+  int i;
+
+  for (i = 0; i <= ctx->nr; i++, sk += 8, w += 4)
+    {
+      sk[0] = sk[1] = w[0];
+      sk[2] = sk[3] = w[1];
+      sk[4] = sk[5] = w[2];
+      sk[6] = sk[7] = w[3];
+      aes_ortho(sk);
+    }
+}
+
+/****************************************************************************
+ * Name: aes_load2 and aes_store2
+ *
+ * Description:
+ *   Load one or two blocks into bitsliced representation and back.  When
+ *   only one block is present, the second lane holds zeros.
+ *
+ ****************************************************************************/
+
+static void aes_load2(FAR uint32_t *q, FAR const uint8_t *in, size_t nblocks)
+{
+  int i;
+
+  for (i = 0; i < 4; i++)
+    {
+      q[2 * i]     = aes_getle32(in + 4 * i);
+      q[2 * i + 1] = nblocks > 1 ? aes_getle32(in + AES_BLOCK_SIZE + 4 * i) : 0;
+    }
+
+  aes_ortho(q);
+}
+
+static void aes_store2(FAR uint8_t *out, FAR uint32_t *q, size_t nblocks)
+{
+  int i;
+
+  aes_ortho(q);
+  for (i = 0; i < 4; i++)
+    {
+      aes_putle32(out + 4 * i, q[2 * i]);
+      if (nblocks > 1)
+        {
+          aes_putle32(out + AES_BLOCK_SIZE + 4 * i, q[2 * i + 1]);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: aes_encblocks
+ ****************************************************************************/
+
+static void aes_encblocks(FAR const struct aes_ctx_s *ctx, FAR uint8_t *out,
+                          FAR const uint8_t *in, size_t nblocks)
+{
+  uint32_t q[8];
+  size_t n;
+  int r;
+
+  for (; nblocks > 0; nblocks -= n)
+    {
+      n = nblocks > 1 ? 2 : 1;
+      aes_load2(q, in, n);
+
+      aes_addroundkey(q, ctx->rk);
+      for (r = 1; r < ctx->nr; r++)
+        {
+          aes_sbox(q);
+          aes_shiftrows(q);
+          aes_mixcolumns(q);
+          aes_addroundkey(q, ctx->rk + 8 * r);
+        }
+
+      aes_sbox(q);
+      aes_shiftrows(q);
+      aes_addroundkey(q, ctx->rk + 8 * ctx->nr);
+
+      aes_store2(out, q, n);
+      in  += n * AES_BLOCK_SIZE;
+      out += n * AES_BLOCK_SIZE;
+    }
+}
+
+/****************************************************************************
+ * Name: aes_decblocks
+ ****************************************************************************/
+
+static void aes_decblocks(FAR const struct aes_ctx_s *ctx, FAR uint8_t *out,
+                          FAR const uint8_t *in, size_t nblocks)
+{
+  uint32_t q[8];
+  size_t n;
+  int r;
+
+  for (; nblocks > 0; nblocks -= n)
+    {
+      n = nblocks > 1 ? 2 : 1;
+      aes_load2(q, in, n);
+
+      aes_addroundkey(q, ctx->rk + 8 * ctx->nr);
+      for (r = ctx->nr - 1; r > 0; r--)
+        {
+          aes_invshiftrows(q);
+          aes_invsbox(q);
+          aes_addroundkey(q, ctx->rk + 8 * r);
+          aes_invmixcolumns(q);
+        }
+
+      aes_invshiftrows(q);
+      aes_invsbox(q);
+      aes_addroundkey(q, ctx->rk);
+
+      aes_store2(out, q, n);
+      in  += n * AES_BLOCK_SIZE;
+      out += n * AES_BLOCK_SIZE;
+    }
+}
+#endif /* CONFIG_CRYPTO_SW_AES_TABLES */
+
+/****************************************************************************
+ * Name: aes_ecb
+ *
+ * Description:
+ *   Encrypt or decrypt whole blocks with the accelerator or the portable
+ *   implementation.
+ *
+ ****************************************************************************/
+
+static void aes_ecb(FAR const struct aes_ctx_s *ctx, FAR uint8_t *out,
+                    FAR const uint8_t *in, size_t nblocks, int encrypt)
+{
+#ifdef CONFIG_CRYPTO_AES_ARCHACCEL
+  if (ctx->accel)
+    {
+      up_aes_ecb(ctx, out, in, nblocks, encrypt);
+      return;
+    }
+#endif
+
+  if (encrypt)
+    {
+      aes_encblocks(ctx, out, in, nblocks);
+    }
+  else
+    {
+      aes_decblocks(ctx, out, in, nblocks);
+    }
+}
+
+/****************************************************************************
+ * Name: aes_cbc
+ ****************************************************************************/
+
+static void aes_cbc(FAR const struct aes_ctx_s *ctx, FAR uint8_t *out,
+                    FAR const uint8_t *in, size_t nblocks, FAR uint8_t *iv,
+                    int encrypt)
+{
+  uint8_t buf[AES_CHUNK * AES_BLOCK_SIZE];
+  size_t n;
+  size_t i;
+
+#ifdef CONFIG_CRYPTO_AES_ARCHACCEL
+  if (ctx->accel)
+    {
+      up_aes_cbc(ctx, out, in, nblocks, iv, encrypt);
+      return;
+    }
+#endif
+
+  if (encrypt)
+    {
+      /* Encryption is serial: each block depends on the previous one */
+
+      for (; nblocks > 0; nblocks--)
+        {
+          aes_xorblock(buf, in, iv, AES_BLOCK_SIZE);
+          aes_encblocks(ctx, out, buf, 1);
+          memcpy(iv, out, AES_BLOCK_SIZE);
+          in  += AES_BLOCK_SIZE;
+          out += AES_BLOCK_SIZE;
+        }
+
+      return;
+    }
+
+  /* Decryption of the blocks is independent.  Keep a copy of the input
+   * chunk, since the output may overwrite it.
+   */
+
+  for (; nblocks > 0; nblocks -= n)
+    {
+      n = nblocks < AES_CHUNK ? nblocks : AES_CHUNK;
+      memcpy(buf, in, n * AES_BLOCK_SIZE);
+      aes_decblocks(ctx, out, buf, n);
+
+      aes_xorblock(out, out, iv, AES_BLOCK_SIZE);
+      for (i = 1; i < n; i++)
+        {
+          aes_xorblock(out + i * AES_BLOCK_SIZE, out + i * AES_BLOCK_SIZE,
+                       buf + (i - 1) * AES_BLOCK_SIZE, AES_BLOCK_SIZE);
+        }
+
+      memcpy(iv, buf + (n - 1) * AES_BLOCK_SIZE, AES_BLOCK_SIZE);
+      in  += n * AES_BLOCK_SIZE;
+      out += n * AES_BLOCK_SIZE;
+    }
+}
+
+/****************************************************************************
+ * Name: aes_incctr
+ *
+ * Description:
+ *   Increment the last 'width' bytes of a counter block as a big-endian
+ *   integer.
+ *
+ ****************************************************************************/
+
+static inline void aes_incctr(FAR uint8_t *ctr, int width)
+{
+  int i;
+
+  for (i = AES_BLOCK_SIZE - 1; i >= AES_BLOCK_SIZE - width; i--)
+    {
+      if (++ctr[i] != 0)
+        {
+          break;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: aes_ctr
+ *
+ * Description:
+ *   XOR len bytes with the keystream starting at counter block ctr.  The
+ *   last 'width' bytes of the counter block are incremented for each block
+ *   (16 for CTR mode, 4 for GCM).  ctr is advanced past the blocks used.
+ *
+ ****************************************************************************/
+
+static void aes_ctr(FAR const struct aes_ctx_s *ctx, FAR uint8_t *out,
+                    FAR const uint8_t *in, size_t len, FAR uint8_t *ctr,
+                    int width)
+{
+  uint8_t ks[AES_CHUNK * AES_BLOCK_SIZE];
+  size_t nblocks;
+  size_t nbytes;
+  size_t i;
+
+#ifdef CONFIG_CRYPTO_AES_ARCHACCEL
+  /* The accelerator increments the whole block.  For GCM, that gives the
+   * same result as long as the low 32 bits do not wrap.
+   */
+
+  if (ctx->accel)
+    {
+      nblocks = len / AES_BLOCK_SIZE;
+      if (width == 4 &&
+          aes_getbe32(ctr + 12) + (uint32_t)nblocks < aes_getbe32(ctr + 12))
+        {
+          nblocks = 0;
+        }
+
+      if (nblocks > 0)
+        {
+          up_aes_ctr(ctx, out, in, nblocks, ctr);
+          in  += nblocks * AES_BLOCK_SIZE;
+          out += nblocks * AES_BLOCK_SIZE;
+          len -= nblocks * AES_BLOCK_SIZE;
+        }
+    }
+#endif
+
+  while (len > 0)
+    {
+      nblocks = (len + AES_BLOCK_SIZE - 1) / AES_BLOCK_SIZE;
+      if (nblocks > AES_CHUNK)
+        {
+          nblocks = AES_CHUNK;
+        }
+
+      for (i = 0; i < nblocks; i++)
+        {
+          memcpy(ks + i * AES_BLOCK_SIZE, ctr, AES_BLOCK_SIZE);
+          aes_incctr(ctr, width);
+        }
+
+      aes_ecb(ctx, ks, ks, nblocks, CYPHER_ENCRYPT);
+
+      nbytes = nblocks * AES_BLOCK_SIZE;
+      if (nbytes > len)
+        {
+          nbytes = len;
+        }
+
+      aes_xorblock(out, in, ks, nbytes);
+      in  += nbytes;
+      out += nbytes;
+      len -= nbytes;
+    }
+}
+
+/****************************************************************************
+ * Name: aes_ghash_mult
+ *
+ * Description:
+ *   y = y . h in GF(2^128) (NIST SP 800-38D, algorithm 1).  The loop always
+ *   does the same operations, selecting with masks rather than branches, so
+ *   that the execution time does not depend on the data.
+ *
+ ****************************************************************************/
+
+static void aes_ghash_mult(FAR uint32_t *y, FAR const uint32_t *h)
+{
+  uint32_t z0 = 0, z1 = 0, z2 = 0, z3 = 0;
+  uint32_t v0 = h[0], v1 = h[1], v2 = h[2], v3 = h[3];
+  uint32_t mask;
+  int i;
+
+  for (i = 0; i < 128; i++)
+    {
+      mask = (uint32_t)0 - ((y[i >> 5] >> (31 - (i & 31))) & 1);
+      z0  ^= v0 & mask;
+      z1  ^= v1 & mask;
+      z2  ^= v2 & mask;
+      z3  ^= v3 & mask;
+
+      mask = (uint32_t)0 - (v3 & 1);
+      v3   = (v3 >> 1) | (v2 << 31);
+      v2   = (v2 >> 1) | (v1 << 31);
+      v1   = (v1 >> 1) | (v0 << 31);
+      v0   = (v0 >> 1) ^ (0xe1000000 & mask);
+    }
+
+  y[0] = z0;
+  y[1] = z1;
+  y[2] = z2;
+  y[3] = z3;
+}
+
+/****************************************************************************
+ * Name: aes_ghash
+ *
+ * Description:
+ *   Absorb len bytes into the GHASH state.  A partial last block is padded
+ *   with zeros.
+ *
+ ****************************************************************************/
+
+static void aes_ghash(FAR struct aes_gcm_s *gcm, FAR const uint8_t *data,
+                      size_t len)
+{
+  uint8_t block[AES_BLOCK_SIZE];
+  size_t n;
+
+  while (len > 0)
+    {
+      n = len < AES_BLOCK_SIZE ? len : AES_BLOCK_SIZE;
+      if (n < AES_BLOCK_SIZE)
+        {
+          memset(block, 0, AES_BLOCK_SIZE);
+          memcpy(block, data, n);
+          data = block;
+        }
+
+      gcm->y[0] ^= aes_getbe32(data);
+      gcm->y[1] ^= aes_getbe32(data + 4);
+      gcm->y[2] ^= aes_getbe32(data + 8);
+      gcm->y[3] ^= aes_getbe32(data + 12);
+      aes_ghash_mult(gcm->y, gcm->h);
+
+      data += n;
+      len  -= n;
+    }
+}
+
+/****************************************************************************
+ * Name: aes_ghash_lengths
+ ****************************************************************************/
+
+static void aes_ghash_lengths(FAR struct aes_gcm_s *gcm, uint64_t alen,
+                              uint64_t clen)
+{
+  uint8_t block[AES_BLOCK_SIZE];
+
+  alen <<= 3;
+  clen <<= 3;
+  aes_putbe32(block,      (uint32_t)(alen >> 32));
+  aes_putbe32(block + 4,  (uint32_t)alen);
+  aes_putbe32(block + 8,  (uint32_t)(clen >> 32));
+  aes_putbe32(block + 12, (uint32_t)clen);
+  aes_ghash(gcm, block, AES_BLOCK_SIZE);
+}
+
+/****************************************************************************
+ * Name: aes_gcm_start
+ *
+ * Description:
+ *   Derive the hash subkey and the pre-counter block, then absorb the
+ *   additional authenticated data.
+ *
+ ****************************************************************************/
+
+static int aes_gcm_start(FAR const struct aes_ctx_s *ctx,
+                         FAR struct aes_gcm_s *gcm, FAR const uint8_t *iv,
+                         size_t ivlen, FAR const uint8_t *aad, size_t aadlen)
+{
+  uint8_t block[AES_BLOCK_SIZE];
+
+  if (iv == NULL || ivlen == 0 || (aad == NULL && aadlen > 0))
+    {
+      return -EINVAL;
+    }
+
+  /* H = E(K, 0^128) */
+
+  memset(block, 0, AES_BLOCK_SIZE);
+  aes_ecb(ctx, block, block, 1, CYPHER_ENCRYPT);
+  gcm->h[0] = aes_getbe32(block);
+  gcm->h[1] = aes_getbe32(block + 4);
+  gcm->h[2] = aes_getbe32(block + 8);
+  gcm->h[3] = aes_getbe32(block + 12);
+  memset(gcm->y, 0, sizeof(gcm->y));
+
+  /* J0 = IV || 0^31 || 1 for a 96-bit IV, otherwise GHASH(IV) */
+
+  if (ivlen == AES_GCM_IVSIZE)
+    {
+      memcpy(gcm->j0, iv, AES_GCM_IVSIZE);
+      aes_putbe32(gcm->j0 + 12, 1);
+    }
+  else
+    {
+      aes_ghash(gcm, iv, ivlen);
+      aes_ghash_lengths(gcm, 0, ivlen);
+      aes_putbe32(gcm->j0,      gcm->y[0]);
+      aes_putbe32(gcm->j0 + 4,  gcm->y[1]);
+      aes_putbe32(gcm->j0 + 8,  gcm->y[2]);
+      aes_putbe32(gcm->j0 + 12, gcm->y[3]);
+      memset(gcm->y, 0, sizeof(gcm->y));
+    }
+
+  memcpy(gcm->cb, gcm->j0, AES_BLOCK_SIZE);
+  aes_incctr(gcm->cb, 4);
+
+  aes_ghash(gcm, aad, aadlen);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: aes_gcm_finish
+ *
+ * Description:
+ *   Compute the full tag: E(K, J0) ^ GHASH(A, C).
+ *
+ ****************************************************************************/
+
+static void aes_gcm_finish(FAR const struct aes_ctx_s *ctx,
+                           FAR struct aes_gcm_s *gcm, size_t aadlen,
+                           size_t size, FAR uint8_t *tag)
+{
+  uint8_t s[AES_BLOCK_SIZE];
+
+  aes_ghash_lengths(gcm, aadlen, size);
+  aes_putbe32(s,      gcm->y[0]);
+  aes_putbe32(s + 4,  gcm->y[1]);
+  aes_putbe32(s + 8,  gcm->y[2]);
+  aes_putbe32(s + 12, gcm->y[3]);
+
+  aes_ecb(ctx, tag, gcm->j0, 1, CYPHER_ENCRYPT);
+  aes_xorblock(tag, tag, s, AES_BLOCK_SIZE);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: aes_setkey
+ *
+ * Description:
+ *   Expand an AES key.  See include/nuttx/crypto/aes.h.
+ *
+ ****************************************************************************/
+
+int aes_setkey(FAR struct aes_ctx_s *ctx, FAR const void *key,
+               uint32_t keysize)
+{
+  FAR const uint8_t *k = (FAR const uint8_t *)key;
+  uint32_t w[4 * (AES_MAXROUNDS + 1)];
+  uint32_t t;
+  int nk;
+  int i;
+
+  if (keysize != 16 && keysize != 24 && keysize != 32)
+    {
+      return -EINVAL;
+    }
+
+  nk      = keysize / 4;
+  ctx->nr = nk + 6;
+
+#ifdef CONFIG_CRYPTO_AES_ARCHACCEL
+  ctx->accel = up_aes_setkey(ctx, k, keysize);
+  if (ctx->accel)
+    {
+      return OK;
+    }
+#else
+  ctx->accel = false;
+#endif
+
+#ifdef CONFIG_CRYPTO_SW_AES_TABLES
+  if (!g_tablesready)
+    {
+      aes_gentables();
+    }
+#endif
+
+  /* FIPS-197 key expansion, with the bytes of each word in little-endian
+   * order (RotWord is then a right rotation).
+   */
+
+  for (i = 0; i < nk; i++)
+    {
+      w[i] = aes_getle32(k + 4 * i);
+    }
+
+  for (i = nk; i < 4 * (ctx->nr + 1); i++)
+    {
+      t = w[i - 1];
+      if (i % nk == 0)
+        {
+          t = aes_subword((t >> 8) | (t << 24)) ^ g_rcon[i / nk - 1];
+        }
+      else if (nk > 6 && i % nk == 4)
+        {
+          t = aes_subword(t);
+        }
+
+      w[i] = w[i - nk] ^ t;
+    }
+
+  aes_keysched(ctx, w);
+  memset(w, 0, sizeof(w));
+  return OK;
+}
+
+/****************************************************************************
+ * Name: aes_crypt
+ *
+ * Description:
+ *   ECB, CBC or CTR encryption or decryption of whole blocks.  See
+ *   include/nuttx/crypto/aes.h.
+ *
+ ****************************************************************************/
+
+int aes_crypt(FAR const struct aes_ctx_s *ctx, FAR void *out,
+              FAR const void *in, uint32_t size, FAR uint8_t *iv, int mode,
+              int encrypt)
+{
+  size_t nblocks = size / AES_BLOCK_SIZE;
+
+  if ((size % AES_BLOCK_SIZE) != 0 || (mode != AES_MODE_ECB && iv == NULL))
+    {
+      return -EINVAL;
+    }
+
+  switch (mode)
+    {
+      case AES_MODE_ECB:
+        aes_ecb(ctx, out, in, nblocks, encrypt);
+        break;
+
+      case AES_MODE_CBC:
+        aes_cbc(ctx, out, in, nblocks, iv, encrypt);
+        break;
+
+      case AES_MODE_CTR:
+        aes_ctr(ctx, out, in, size, iv, AES_BLOCK_SIZE);
+        break;
+
+      default:
+        return -EINVAL;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: aes_gcm_encrypt
+ *
+ * Description:
+ *   AES-GCM authenticated encryption.  See include/nuttx/crypto/aes.h.
+ *
+ ****************************************************************************/
+
+int aes_gcm_encrypt(FAR const struct aes_ctx_s *ctx, FAR void *out,
+                    FAR const void *in, size_t size, FAR const void *iv,
+                    size_t ivlen, FAR const void *aad, size_t aadlen,
+                    FAR void *tag, size_t taglen)
+{
+  struct aes_gcm_s gcm;
+  uint8_t fulltag[AES_BLOCK_SIZE];
+  int ret;
+
+  if (taglen < 4 || taglen > AES_GCM_TAGSIZE || tag == NULL)
+    {
+      return -EINVAL;
+    }
+
+  ret = aes_gcm_start(ctx, &gcm, iv, ivlen, aad, aadlen);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  aes_ctr(ctx, out, in, size, gcm.cb, 4);
+  aes_ghash(&gcm, out, size);
+
+  aes_gcm_finish(ctx, &gcm, aadlen, size, fulltag);
+  memcpy(tag, fulltag, taglen);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: aes_gcm_decrypt
+ *
+ * Description:
+ *   AES-GCM authenticated decryption.  See include/nuttx/crypto/aes.h.
+ *
+ ****************************************************************************/
+
+int aes_gcm_decrypt(FAR const struct aes_ctx_s *ctx, FAR void *out,
+                    FAR const void *in, size_t size, FAR const void *iv,
+                    size_t ivlen, FAR const void *aad, size_t aadlen,
+                    FAR const void *tag, size_t taglen)
+{
+  FAR const uint8_t *expected = (FAR const uint8_t *)tag;
+  struct aes_gcm_s gcm;
+  uint8_t fulltag[AES_BLOCK_SIZE];
+  uint8_t diff;
+  size_t i;
+  int ret;
+
+  if (taglen < 4 || taglen > AES_GCM_TAGSIZE || tag == NULL)
+    {
+      return -EINVAL;
+    }
+
+  ret = aes_gcm_start(ctx, &gcm, iv, ivlen, aad, aadlen);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Hash the ciphertext before decrypting it, in case out == in */
+
+  aes_ghash(&gcm, in, size);
+  aes_ctr(ctx, out, in, size, gcm.cb, 4);
+  aes_gcm_finish(ctx, &gcm, aadlen, size, fulltag);
+
+  /* Compare in constant time */
+
+  for (diff = 0, i = 0; i < taglen; i++)
+    {
+      diff |= fulltag[i] ^ expected[i];
+    }
+
+  return diff == 0 ? OK : -EBADMSG;
+}
+
+/****************************************************************************
+ * Name: aes_cypher
+ *
+ * Description:
+ *   The crypto.h AES interface, implemented in software.  The expanded key
+ *   of the last call is cached, so that callers that use the same key for
+ *   many short requests (like the BCH driver, one block at a time) do not
+ *   pay for a key expansion on every call.
+ *
+ ****************************************************************************/
+
+int aes_cypher(FAR void *out, FAR const void *in, uint32_t size,
+               FAR const void *iv, FAR const void *key, uint32_t keysize,
+               int mode, int encrypt)
+{
+  uint8_t ivbuf[AES_BLOCK_SIZE];
+  uint8_t diff;
+  uint32_t i;
+  int ret;
+
+  if (keysize > sizeof(g_cyphkey))
+    {
+      return -EINVAL;
+    }
+
+  if (iv)
+    {
+      memcpy(ivbuf, iv, AES_BLOCK_SIZE);
+    }
+  else
+    {
+      memset(ivbuf, 0, AES_BLOCK_SIZE);
+    }
+
+  while (sem_wait(&g_cyphsem) < 0)
+    {
+      DEBUGASSERT(get_errno() == EINTR);
+    }
+
+  /* Re-use the cached key schedule if the key is unchanged.  The key is
+   * compared in constant time.
+   */
+
+  diff = (keysize != g_cyphkeysize);
+  for (i = 0; i < keysize; i++)
+    {
+      diff |= ((FAR const uint8_t *)key)[i] ^ g_cyphkey[i];
+    }
+
+  ret = OK;
+  if (diff != 0)
+    {
+      ret = aes_setkey(&g_cyphctx, key, keysize);
+      if (ret == OK)
+        {
+          memcpy(g_cyphkey, key, keysize);
+          g_cyphkeysize = keysize;
+        }
+      else
+        {
+          g_cyphkeysize = 0;
+        }
+    }
+
+  if (ret == OK)
+    {
+      ret = aes_crypt(&g_cyphctx, out, in, size, ivbuf, mode, encrypt);
+    }
+
+  sem_post(&g_cyphsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: up_aesinitialize
+ *
+ * Description:
+ *   Initialize the software AES implementation.  This replaces the
+ *   hardware initialization provided by architectures with an AES
+ *   peripheral.
+ *
+ ****************************************************************************/
+
+int up_aesinitialize(void)
+{
+  sem_init(&g_cyphsem, 0, 1);
+  g_cyphkeysize = 0;
+
+#ifdef CONFIG_CRYPTO_SW_AES_TABLES
+  if (!g_tablesready)
+    {
+      aes_gentables();
+    }
+#endif
+
+  return OK;
+}
+
+#endif /* CONFIG_CRYPTO_SW_AES */
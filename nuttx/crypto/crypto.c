@@ -64,7 +64,16 @@
  * Public Functions
  ****************************************************************************/
 
-void up_cryptoinitialize(void)
+/****************************************************************************
+ * Name: up_cryptoinitialize
+ *
+ * Description:
+ *   Initialize the crypto algorithms and, if so configured, run the
+ *   algorithm self-tests.
+ *
+ ****************************************************************************/
+
+int up_cryptoinitialize(void)
 {
   int res = OK;
 
@@ -83,4 +92,4 @@ void up_cryptoinitialize(void)
 #endif
 
   return res;
-}
\ No newline at end of file
+}
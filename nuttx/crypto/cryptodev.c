@@ -46,9 +46,12 @@
 #include <errno.h>
 
 #include <nuttx/fs/fs.h>
+#include <nuttx/kmalloc.h>
 
 #include <nuttx/crypto/crypto.h>
 #include <nuttx/crypto/cryptodev.h>
+#include <nuttx/crypto/aes.h>
+#include <nuttx/crypto/sha256.h>
 
 /****************************************************************************
  * Private Function Prototypes
@@ -94,6 +97,51 @@ static ssize_t cryptodev_write(FAR struct file *filep, FAR const char *buffer,
   return -EACCES;
 }
 
+#if defined(CONFIG_CRYPTO_SW_AES)
+/* AES-GCM with a 12-byte IV and a 16-byte tag in op->mac.  Decryption
+ * fails with -EBADMSG if the tag does not match.
+ */
+
+static int cryptodev_gcm(FAR struct crypt_op *op, FAR struct session_op *ses,
+                         int encrypt)
+{
+  FAR struct aes_ctx_s *ctx;
+  int ret;
+
+  if (op->iv == NULL || op->mac == NULL)
+    {
+      return -EINVAL;
+    }
+
+  ctx = (FAR struct aes_ctx_s *)kmm_malloc(sizeof(struct aes_ctx_s));
+  if (ctx == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ret = aes_setkey(ctx, ses->key, ses->keylen);
+  if (ret == OK)
+    {
+      if (encrypt)
+        {
+          ret = aes_gcm_encrypt(ctx, op->dst, op->src, op->len, op->iv,
+                                AES_GCM_IVSIZE, NULL, 0, op->mac,
+                                AES_GCM_TAGSIZE);
+        }
+      else
+        {
+          ret = aes_gcm_decrypt(ctx, op->dst, op->src, op->len, op->iv,
+                                AES_GCM_IVSIZE, NULL, 0, op->mac,
+                                AES_GCM_TAGSIZE);
+        }
+    }
+
+  memset(ctx, 0, sizeof(struct aes_ctx_s));
+  kmm_free(ctx);
+  return ret;
+}
+#endif
+
 static int cryptodev_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 {
   switch(cmd)
@@ -130,6 +178,21 @@ static int cryptodev_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         return -EINVAL;
       }
 
+#if defined(CONFIG_CRYPTO_SHA256)
+      /* A digest-only session */
+
+      if (ses->cipher == 0 && ses->mac == CRYPTO_SHA2_256)
+        {
+          if (op->mac == NULL)
+            {
+              return -EINVAL;
+            }
+
+          sha256_hash(op->src, op->len, (FAR uint8_t *)op->mac);
+          return OK;
+        }
+#endif
+
       switch (ses->cipher)
       {
 
@@ -148,6 +211,11 @@ static int cryptodev_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 #  undef AES_CYPHER
 #endif
 
+#if defined(CONFIG_CRYPTO_SW_AES)
+      case CRYPTO_AES_GCM:
+        return cryptodev_gcm(op, ses, encrypt);
+#endif
+
       default:
         return -EINVAL;
       }
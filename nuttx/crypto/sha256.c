@@ -0,0 +1,268 @@
+/****************************************************************************
+ * crypto/sha256.c
+ * SHA-256 message digest
+ *
+ *   Copyright (C) 2014 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <nuttx/crypto/sha256.h>
+
+#ifdef CONFIG_CRYPTO_SHA256
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define ROR(x, n)  (((x) >> (n)) | ((x) << (32 - (n))))
+
+#define CH(x, y, z)   (((x) & (y)) ^ (~(x) & (z)))
+#define MAJ(x, y, z)  (((x) & (y)) ^ ((x) & (z)) ^ ((y) & (z)))
+#define SIGMA0(x)     (ROR(x, 2) ^ ROR(x, 13) ^ ROR(x, 22))
+#define SIGMA1(x)     (ROR(x, 6) ^ ROR(x, 11) ^ ROR(x, 25))
+#define GAMMA0(x)     (ROR(x, 7) ^ ROR(x, 18) ^ ((x) >> 3))
+#define GAMMA1(x)     (ROR(x, 17) ^ ROR(x, 19) ^ ((x) >> 10))
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const uint32_t g_sha256k[64] =
+{
+  0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+  0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+  0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+  0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+  0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+  0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+  0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+  0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+  0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+  0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+  0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+  0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+  0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+  0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+  0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+  0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sha256_transform
+ *
+ * Description:
+ *   Process one 64-byte block.  The message schedule is kept in a 16-word
+ *   circular buffer.
+ *
+ ****************************************************************************/
+
+static void sha256_transform(FAR uint32_t *state, FAR const uint8_t *block)
+{
+  uint32_t w[16];
+  uint32_t a, b, c, d, e, f, g, h;
+  uint32_t t1;
+  uint32_t t2;
+  int i;
+
+  for (i = 0; i < 16; i++, block += 4)
+    {
+      w[i] = ((uint32_t)block[0] << 24) | ((uint32_t)block[1] << 16) |
+             ((uint32_t)block[2] << 8) | (uint32_t)block[3];
+    }
+
+  a = state[0];
+  b = state[1];
+  c = state[2];
+  d = state[3];
+  e = state[4];
+  f = state[5];
+  g = state[6];
+  h = state[7];
+
+  for (i = 0; i < 64; i++)
+    {
+      if (i >= 16)
+        {
+          w[i & 15] += GAMMA1(w[(i - 2) & 15]) + w[(i - 7) & 15] +
+                       GAMMA0(w[(i - 15) & 15]);
+        }
+
+      t1 = h + SIGMA1(e) + CH(e, f, g) + g_sha256k[i] + w[i & 15];
+      t2 = SIGMA0(a) + MAJ(a, b, c);
+      h  = g;
+      g  = f;
+      f  = e;
+      e  = d + t1;
+      d  = c;
+      c  = b;
+      b  = a;
+      a  = t1 + t2;
+    }
+
+  state[0] += a;
+  state[1] += b;
+  state[2] += c;
+  state[3] += d;
+  state[4] += e;
+  state[5] += f;
+  state[6] += g;
+  state[7] += h;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sha256_init
+ ****************************************************************************/
+
+void sha256_init(FAR struct sha256_ctx_s *ctx)
+{
+  ctx->state[0] = 0x6a09e667;
+  ctx->state[1] = 0xbb67ae85;
+  ctx->state[2] = 0x3c6ef372;
+  ctx->state[3] = 0xa54ff53a;
+  ctx->state[4] = 0x510e527f;
+  ctx->state[5] = 0x9b05688c;
+  ctx->state[6] = 0x1f83d9ab;
+  ctx->state[7] = 0x5be0cd19;
+  ctx->count    = 0;
+}
+
+/****************************************************************************
+ * Name: sha256_update
+ ****************************************************************************/
+
+void sha256_update(FAR struct sha256_ctx_s *ctx, FAR const void *data,
+                   size_t len)
+{
+  FAR const uint8_t *src = (FAR const uint8_t *)data;
+  size_t used = (size_t)(ctx->count & (SHA256_BLOCK_SIZE - 1));
+  size_t n;
+
+  ctx->count += len;
+
+  /* Complete a buffered partial block first */
+
+  if (used > 0)
+    {
+      n = SHA256_BLOCK_SIZE - used;
+      if (n > len)
+        {
+          memcpy(ctx->buffer + used, src, len);
+          return;
+        }
+
+      memcpy(ctx->buffer + used, src, n);
+      sha256_transform(ctx->state, ctx->buffer);
+      src += n;
+      len -= n;
+    }
+
+  /* Whole blocks are hashed directly from the caller's buffer */
+
+  for (; len >= SHA256_BLOCK_SIZE; len -= SHA256_BLOCK_SIZE)
+    {
+      sha256_transform(ctx->state, src);
+      src += SHA256_BLOCK_SIZE;
+    }
+
+  memcpy(ctx->buffer, src, len);
+}
+
+/****************************************************************************
+ * Name: sha256_final
+ ****************************************************************************/
+
+void sha256_final(FAR struct sha256_ctx_s *ctx, FAR uint8_t *digest)
+{
+  uint64_t bits = ctx->count << 3;
+  size_t used = (size_t)(ctx->count & (SHA256_BLOCK_SIZE - 1));
+  int i;
+
+  /* Pad with 0x80, zeros and the 64-bit big-endian message length */
+
+  ctx->buffer[used++] = 0x80;
+  if (used > SHA256_BLOCK_SIZE - 8)
+    {
+      memset(ctx->buffer + used, 0, SHA256_BLOCK_SIZE - used);
+      sha256_transform(ctx->state, ctx->buffer);
+      used = 0;
+    }
+
+  memset(ctx->buffer + used, 0, SHA256_BLOCK_SIZE - 8 - used);
+  for (i = 0; i < 8; i++)
+    {
+      ctx->buffer[SHA256_BLOCK_SIZE - 1 - i] = (uint8_t)(bits >> (8 * i));
+    }
+
+  sha256_transform(ctx->state, ctx->buffer);
+
+  for (i = 0; i < 8; i++)
+    {
+      digest[4 * i]     = (uint8_t)(ctx->state[i] >> 24);
+      digest[4 * i + 1] = (uint8_t)(ctx->state[i] >> 16);
+      digest[4 * i + 2] = (uint8_t)(ctx->state[i] >> 8);
+      digest[4 * i + 3] = (uint8_t)ctx->state[i];
+    }
+
+  memset(ctx, 0, sizeof(struct sha256_ctx_s));
+}
+
+/****************************************************************************
+ * Name: sha256_hash
+ ****************************************************************************/
+
+void sha256_hash(FAR const void *data, size_t len, FAR uint8_t *digest)
+{
+  struct sha256_ctx_s ctx;
+
+  sha256_init(&ctx);
+  sha256_update(&ctx, data, len);
+  sha256_final(&ctx, digest);
+}
+
+#endif /* CONFIG_CRYPTO_SHA256 */
@@ -47,8 +47,11 @@
 #include <debug.h>
 
 #include <nuttx/fs/fs.h>
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/crypto/crypto.h>
+#include <nuttx/crypto/aes.h>
+#include <nuttx/crypto/sha256.h>
 
 #ifdef CONFIG_CRYPTO_ALGTEST
 
@@ -106,10 +109,269 @@ static int test_aes(void)
 }
 #endif
 
+#if defined(CONFIG_CRYPTO_SW_AES)
+static int do_test_aes_gcm(FAR struct aead_testvec *test)
+{
+  struct aes_ctx_s ctx;
+  uint8_t tag[AES_GCM_TAGSIZE];
+  FAR uint8_t *out;
+  int res;
+
+  out = kmm_zalloc(test->ilen > 0 ? test->ilen : 1);
+  if (out == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  res = aes_setkey(&ctx, test->key, test->klen);
+  if (res == OK)
+    {
+      res = aes_gcm_encrypt(&ctx, out, test->input, test->ilen, test->iv,
+                            test->ivlen, test->assoc, test->alen, tag,
+                            test->tlen);
+    }
+
+  if (res == OK && (memcmp(out, test->result, test->rlen) != 0 ||
+                    memcmp(tag, test->tag, test->tlen) != 0))
+    {
+      res = -EIO;
+    }
+
+  /* Decrypt and verify the tag, then check that a corrupted tag is
+   * rejected.
+   */
+
+  if (res == OK)
+    {
+      res = aes_gcm_decrypt(&ctx, out, test->result, test->rlen, test->iv,
+                            test->ivlen, test->assoc, test->alen,
+                            test->tag, test->tlen);
+    }
+
+  if (res == OK && memcmp(out, test->input, test->ilen) != 0)
+    {
+      res = -EIO;
+    }
+
+  if (res == OK)
+    {
+      memcpy(tag, test->tag, test->tlen);
+      tag[0] ^= 1;
+      if (aes_gcm_decrypt(&ctx, out, test->result, test->rlen, test->iv,
+                          test->ivlen, test->assoc, test->alen, tag,
+                          test->tlen) != -EBADMSG)
+        {
+          res = -EIO;
+        }
+    }
+
+  kmm_free(out);
+  return res;
+}
+
+static int test_aes_gcm(void)
+{
+  int i;
+
+  for (i = 0; i < AES_GCM_TEST_VECTORS; i++)
+    {
+      if (do_test_aes_gcm(aes_gcm_tv_template + i))
+        {
+          cryptlldbg("Failed GCM test #%i\n", i);
+          return -1;
+        }
+    }
+
+  return OK;
+}
+#endif
+
+#if defined(CONFIG_CRYPTO_SHA256)
+static int test_sha256(void)
+{
+  FAR struct hash_testvec *test;
+  struct sha256_ctx_s ctx;
+  uint8_t digest[SHA256_DIGEST_SIZE];
+  int i;
+  int j;
+
+  for (i = 0; i < SHA256_TEST_VECTORS; i++)
+    {
+      test = sha256_tv_template + i;
+
+      /* Hash in one call and one byte at a time */
+
+      sha256_hash(test->plaintext, test->psize, digest);
+      if (memcmp(digest, test->digest, SHA256_DIGEST_SIZE) != 0)
+        {
+          cryptlldbg("Failed SHA-256 test #%i\n", i);
+          return -1;
+        }
+
+      sha256_init(&ctx);
+      for (j = 0; j < test->psize; j++)
+        {
+          sha256_update(&ctx, test->plaintext + j, 1);
+        }
+
+      sha256_final(&ctx, digest);
+      if (memcmp(digest, test->digest, SHA256_DIGEST_SIZE) != 0)
+        {
+          cryptlldbg("Failed SHA-256 update test #%i\n", i);
+          return -1;
+        }
+    }
+
+  return OK;
+}
+#endif
+
+#if defined(CONFIG_CRYPTO_BENCHMARK)
+
+/* Process the benchmark buffer once with the algorithm under test */
+
+typedef int (*bench_func_t)(FAR uint8_t *buf, size_t len, FAR void *arg);
+
+static void bench_run(FAR const char *name, bench_func_t func,
+                      FAR uint8_t *buf, FAR void *arg)
+{
+  uint32_t start;
+  uint32_t msec;
+  int i;
+
+  start = clock_systimer();
+  for (i = 0; i < CONFIG_CRYPTO_BENCHMARK_LOOPS; i++)
+    {
+      if (func(buf, CONFIG_CRYPTO_BENCHMARK_SIZE, arg) < 0)
+        {
+          cryptlldbg("%s: failed\n", name);
+          return;
+        }
+    }
+
+  msec = TICK2MSEC(clock_systimer() - start);
+  if (msec == 0)
+    {
+      cryptlldbg("%s: less than one tick\n", name);
+      return;
+    }
+
+  cryptlldbg("%s: %lu KiB/s\n", name,
+             (unsigned long)(((uint64_t)CONFIG_CRYPTO_BENCHMARK_LOOPS *
+                              CONFIG_CRYPTO_BENCHMARK_SIZE * 1000) /
+                             (1024 * (uint64_t)msec)));
+}
+
+#if defined(CONFIG_CRYPTO_AES)
+static const uint8_t g_benchkey[32] =
+{
+  0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+  0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+  0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17,
+  0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f
+};
+
+static const uint8_t g_benchiv[16];
+
+static int bench_ecb(FAR uint8_t *buf, size_t len, FAR void *arg)
+{
+  return aes_cypher(buf, buf, len, NULL, g_benchkey, (uintptr_t)arg,
+                    AES_MODE_ECB, CYPHER_ENCRYPT);
+}
+
+static int bench_cbc_enc(FAR uint8_t *buf, size_t len, FAR void *arg)
+{
+  return aes_cypher(buf, buf, len, g_benchiv, g_benchkey, (uintptr_t)arg,
+                    AES_MODE_CBC, CYPHER_ENCRYPT);
+}
+
+static int bench_cbc_dec(FAR uint8_t *buf, size_t len, FAR void *arg)
+{
+  return aes_cypher(buf, buf, len, g_benchiv, g_benchkey, (uintptr_t)arg,
+                    AES_MODE_CBC, CYPHER_DECRYPT);
+}
+
+static int bench_ctr(FAR uint8_t *buf, size_t len, FAR void *arg)
+{
+  return aes_cypher(buf, buf, len, g_benchiv, g_benchkey, (uintptr_t)arg,
+                    AES_MODE_CTR, CYPHER_ENCRYPT);
+}
+#endif
+
+#if defined(CONFIG_CRYPTO_SW_AES)
+static int bench_gcm(FAR uint8_t *buf, size_t len, FAR void *arg)
+{
+  uint8_t tag[AES_GCM_TAGSIZE];
+
+  return aes_gcm_encrypt((FAR struct aes_ctx_s *)arg, buf, buf, len,
+                         g_benchiv, AES_GCM_IVSIZE, NULL, 0, tag,
+                         AES_GCM_TAGSIZE);
+}
+#endif
+
+#if defined(CONFIG_CRYPTO_SHA256)
+static int bench_sha256(FAR uint8_t *buf, size_t len, FAR void *arg)
+{
+  sha256_hash(buf, len, (FAR uint8_t *)arg);
+  return OK;
+}
+#endif
+
+static void crypto_benchmark(void)
+{
+  FAR uint8_t *buf;
+
+  buf = kmm_zalloc(CONFIG_CRYPTO_BENCHMARK_SIZE);
+  if (buf == NULL)
+    {
+      cryptlldbg("No memory for the benchmark\n");
+      return;
+    }
+
+#if defined(CONFIG_CRYPTO_AES)
+  bench_run("AES-128-ECB", bench_ecb, buf, (FAR void *)16);
+  bench_run("AES-256-ECB", bench_ecb, buf, (FAR void *)32);
+  bench_run("AES-128-CBC encrypt", bench_cbc_enc, buf, (FAR void *)16);
+  bench_run("AES-128-CBC decrypt", bench_cbc_dec, buf, (FAR void *)16);
+  bench_run("AES-128-CTR", bench_ctr, buf, (FAR void *)16);
+#endif
+
+#if defined(CONFIG_CRYPTO_SW_AES)
+  {
+    FAR struct aes_ctx_s *ctx = kmm_malloc(sizeof(struct aes_ctx_s));
+    if (ctx != NULL)
+      {
+        aes_setkey(ctx, g_benchkey, 16);
+        bench_run("AES-128-GCM", bench_gcm, buf, ctx);
+        kmm_free(ctx);
+      }
+  }
+#endif
+
+#if defined(CONFIG_CRYPTO_SHA256)
+  {
+    uint8_t digest[SHA256_DIGEST_SIZE];
+    bench_run("SHA-256", bench_sha256, buf, digest);
+  }
+#endif
+
+  kmm_free(buf);
+}
+#endif /* CONFIG_CRYPTO_BENCHMARK */
+
 int crypto_test(void)
 {
 #if defined(CONFIG_CRYPTO_AES)
   if (test_aes()) return -1;
+#endif
+#if defined(CONFIG_CRYPTO_SW_AES)
+  if (test_aes_gcm()) return -1;
+#endif
+#if defined(CONFIG_CRYPTO_SHA256)
+  if (test_sha256()) return -1;
+#endif
+#if defined(CONFIG_CRYPTO_BENCHMARK)
+  crypto_benchmark();
 #endif
   return OK;
 }
@@ -60,6 +60,29 @@ struct cipher_testvec
   unsigned short rlen;
 };
 
+struct aead_testvec
+{
+  FAR char *key;
+  FAR char *iv;
+  FAR char *assoc;
+  FAR char *input;
+  FAR char *result;
+  FAR char *tag;
+  unsigned char klen;
+  unsigned char ivlen;
+  unsigned short alen;
+  unsigned short ilen;
+  unsigned short rlen;
+  unsigned char tlen;
+};
+
+struct hash_testvec
+{
+  FAR char *plaintext;
+  FAR char *digest;
+  unsigned short psize;
+};
+
 #if defined(CONFIG_CRYPTO_AES)
 
 /* AES test vectors */
@@ -487,5 +510,174 @@ static struct cipher_testvec aes_ctr_dec_tv_template[] =
   }
 };
 
+#if defined(CONFIG_CRYPTO_SW_AES)
+
+#define AES_GCM_TEST_VECTORS 4
+
+static struct aead_testvec aes_gcm_tv_template[] =
+{
+  { /* From McGrew and Viega, The Galois/Counter Mode of Operation, test case 2 */
+    .key  = "\x00\x00\x00\x00\x00\x00\x00\x00"
+        "\x00\x00\x00\x00\x00\x00\x00\x00",
+    .klen = 16,
+    .iv = "\x00\x00\x00\x00\x00\x00\x00\x00"
+        "\x00\x00\x00\x00",
+    .ivlen = 12,
+    .assoc = "",
+    .alen = 0,
+    .input = "\x00\x00\x00\x00\x00\x00\x00\x00"
+        "\x00\x00\x00\x00\x00\x00\x00\x00",
+    .ilen = 16,
+    .result = "\x03\x88\xda\xce\x60\xb6\xa3\x92"
+        "\xf3\x28\xc2\xb9\x71\xb2\xfe\x78",
+    .rlen = 16,
+    .tag = "\xab\x6e\x47\xd4\x2c\xec\x13\xbd"
+        "\xf5\x3a\x67\xb2\x12\x57\xbd\xdf",
+    .tlen = 16,
+  },
+  { /* Test case 4 */
+    .key  = "\xfe\xff\xe9\x92\x86\x65\x73\x1c"
+        "\x6d\x6a\x8f\x94\x67\x30\x83\x08",
+    .klen = 16,
+    .iv = "\xca\xfe\xba\xbe\xfa\xce\xdb\xad"
+        "\xde\xca\xf8\x88",
+    .ivlen = 12,
+    .assoc = "\xfe\xed\xfa\xce\xde\xad\xbe\xef"
+        "\xfe\xed\xfa\xce\xde\xad\xbe\xef"
+        "\xab\xad\xda\xd2",
+    .alen = 20,
+    .input = "\xd9\x31\x32\x25\xf8\x84\x06\xe5"
+        "\xa5\x59\x09\xc5\xaf\xf5\x26\x9a"
+        "\x86\xa7\xa9\x53\x15\x34\xf7\xda"
+        "\x2e\x4c\x30\x3d\x8a\x31\x8a\x72"
+        "\x1c\x3c\x0c\x95\x95\x68\x09\x53"
+        "\x2f\xcf\x0e\x24\x49\xa6\xb5\x25"
+        "\xb1\x6a\xed\xf5\xaa\x0d\xe6\x57"
+        "\xba\x63\x7b\x39",
+    .ilen = 60,
+    .result = "\x42\x83\x1e\xc2\x21\x77\x74\x24"
+        "\x4b\x72\x21\xb7\x84\xd0\xd4\x9c"
+        "\xe3\xaa\x21\x2f\x2c\x02\xa4\xe0"
+        "\x35\xc1\x7e\x23\x29\xac\xa1\x2e"
+        "\x21\xd5\x14\xb2\x54\x66\x93\x1c"
+        "\x7d\x8f\x6a\x5a\xac\x84\xaa\x05"
+        "\x1b\xa3\x0b\x39\x6a\x0a\xac\x97"
+        "\x3d\x58\xe0\x91",
+    .rlen = 60,
+    .tag = "\x5b\xc9\x4f\xbc\x32\x21\xa5\xdb"
+        "\x94\xfa\xe9\x5a\xe7\x12\x1a\x47",
+    .tlen = 16,
+  },
+  { /* Test case 6: 60-byte IV */
+    .key  = "\xfe\xff\xe9\x92\x86\x65\x73\x1c"
+        "\x6d\x6a\x8f\x94\x67\x30\x83\x08",
+    .klen = 16,
+    .iv = "\x93\x13\x22\x5d\xf8\x84\x06\xe5"
+        "\x55\x90\x9c\x5a\xff\x52\x69\xaa"
+        "\x6a\x7a\x95\x38\x53\x4f\x7d\xa1"
+        "\xe4\xc3\x03\xd2\xa3\x18\xa7\x28"
+        "\xc3\xc0\xc9\x51\x56\x80\x95\x39"
+        "\xfc\xf0\xe2\x42\x9a\x6b\x52\x54"
+        "\x16\xae\xdb\xf5\xa0\xde\x6a\x57"
+        "\xa6\x37\xb3\x9b",
+    .ivlen = 60,
+    .assoc = "\xfe\xed\xfa\xce\xde\xad\xbe\xef"
+        "\xfe\xed\xfa\xce\xde\xad\xbe\xef"
+        "\xab\xad\xda\xd2",
+    .alen = 20,
+    .input = "\xd9\x31\x32\x25\xf8\x84\x06\xe5"
+        "\xa5\x59\x09\xc5\xaf\xf5\x26\x9a"
+        "\x86\xa7\xa9\x53\x15\x34\xf7\xda"
+        "\x2e\x4c\x30\x3d\x8a\x31\x8a\x72"
+        "\x1c\x3c\x0c\x95\x95\x68\x09\x53"
+        "\x2f\xcf\x0e\x24\x49\xa6\xb5\x25"
+        "\xb1\x6a\xed\xf5\xaa\x0d\xe6\x57"
+        "\xba\x63\x7b\x39",
+    .ilen = 60,
+    .result = "\x8c\xe2\x49\x98\x62\x56\x15\xb6"
+        "\x03\xa0\x33\xac\xa1\x3f\xb8\x94"
+        "\xbe\x91\x12\xa5\xc3\xa2\x11\xa8"
+        "\xba\x26\x2a\x3c\xca\x7e\x2c\xa7"
+        "\x01\xe4\xa9\xa4\xfb\xa4\x3c\x90"
+        "\xcc\xdc\xb2\x81\xd4\x8c\x7c\x6f"
+        "\xd6\x28\x75\xd2\xac\xa4\x17\x03"
+        "\x4c\x34\xae\xe5",
+    .rlen = 60,
+    .tag = "\x61\x9c\xc5\xae\xff\xfe\x0b\xfa"
+        "\x46\x2a\xf4\x3c\x16\x99\xd0\x50",
+    .tlen = 16,
+  },
+  { /* Test case 16: 256-bit key */
+    .key  = "\xfe\xff\xe9\x92\x86\x65\x73\x1c"
+        "\x6d\x6a\x8f\x94\x67\x30\x83\x08"
+        "\xfe\xff\xe9\x92\x86\x65\x73\x1c"
+        "\x6d\x6a\x8f\x94\x67\x30\x83\x08",
+    .klen = 32,
+    .iv = "\xca\xfe\xba\xbe\xfa\xce\xdb\xad"
+        "\xde\xca\xf8\x88",
+    .ivlen = 12,
+    .assoc = "\xfe\xed\xfa\xce\xde\xad\xbe\xef"
+        "\xfe\xed\xfa\xce\xde\xad\xbe\xef"
+        "\xab\xad\xda\xd2",
+    .alen = 20,
+    .input = "\xd9\x31\x32\x25\xf8\x84\x06\xe5"
+        "\xa5\x59\x09\xc5\xaf\xf5\x26\x9a"
+        "\x86\xa7\xa9\x53\x15\x34\xf7\xda"
+        "\x2e\x4c\x30\x3d\x8a\x31\x8a\x72"
+        "\x1c\x3c\x0c\x95\x95\x68\x09\x53"
+        "\x2f\xcf\x0e\x24\x49\xa6\xb5\x25"
+        "\xb1\x6a\xed\xf5\xaa\x0d\xe6\x57"
+        "\xba\x63\x7b\x39",
+    .ilen = 60,
+    .result = "\x52\x2d\xc1\xf0\x99\x56\x7d\x07"
+        "\xf4\x7f\x37\xa3\x2a\x84\x42\x7d"
+        "\x64\x3a\x8c\xdc\xbf\xe5\xc0\xc9"
+        "\x75\x98\xa2\xbd\x25\x55\xd1\xaa"
+        "\x8c\xb0\x8e\x48\x59\x0d\xbb\x3d"
+        "\xa7\xb0\x8b\x10\x56\x82\x88\x38"
+        "\xc5\xf6\x1e\x63\x93\xba\x7a\x0a"
+        "\xbc\xc9\xf6\x62",
+    .rlen = 60,
+    .tag = "\x76\xfc\x6e\xce\x0f\x4e\x17\x68"
+        "\xcd\xdf\x88\x53\xbb\x2d\x55\x1b",
+    .tlen = 16,
+  }
+};
+
+#endif /* CONFIG_CRYPTO_SW_AES */
 #endif /* CONFIG_CRYPTO_AES */
+
+#if defined(CONFIG_CRYPTO_SHA256)
+
+#define SHA256_TEST_VECTORS 3
+
+static struct hash_testvec sha256_tv_template[] =
+{
+  { /* From FIPS 180-2, appendix B.1 */
+    .plaintext = "abc",
+    .psize = 3,
+    .digest = "\xba\x78\x16\xbf\x8f\x01\xcf\xea"
+        "\x41\x41\x40\xde\x5d\xae\x22\x23"
+        "\xb0\x03\x61\xa3\x96\x17\x7a\x9c"
+        "\xb4\x10\xff\x61\xf2\x00\x15\xad",
+  },
+  { /* From FIPS 180-2, appendix B.2 */
+    .plaintext = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+    .psize = 56,
+    .digest = "\x24\x8d\x6a\x61\xd2\x06\x38\xb8"
+        "\xe5\xc0\x26\x93\x0c\x3e\x60\x39"
+        "\xa3\x3c\xe4\x59\x64\xff\x21\x67"
+        "\xf6\xec\xed\xd4\x19\xdb\x06\xc1",
+  },
+  { /* Empty message */
+    .plaintext = "",
+    .psize = 0,
+    .digest = "\xe3\xb0\xc4\x42\x98\xfc\x1c\x14"
+        "\x9a\xfb\xf4\xc8\x99\x6f\xb9\x24"
+        "\x27\xae\x41\xe4\x64\x9b\x93\x4c"
+        "\xa4\x95\x99\x1b\x78\x52\xb8\x55",
+  }
+};
+
+#endif /* CONFIG_CRYPTO_SHA256 */
 #endif /* __CRYPTO_TESTMNGR_H */
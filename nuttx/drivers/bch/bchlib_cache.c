@@ -50,9 +50,17 @@
 #include "bch_internal.h"
 
 #if defined(CONFIG_BCH_ENCRYPTION)
-#  include <crypto/crypto.h>
+#  include <nuttx/crypto/crypto.h>
 #endif
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Number of AES blocks passed to each aes_cypher() call */
+
+#define BCH_CYPHER_BLOCKS 4
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -92,22 +100,50 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
 {
   int blocks = bch->sectsize / 16;
   uint32_t *buffer = (uint32_t*)bch->buffer;
+  uint32_t X[BCH_CYPHER_BLOCKS][4];
+  uint32_t T[BCH_CYPHER_BLOCKS][4];
+  int nblocks;
   int i;
+  int j;
 
-  for (i = 0; i < blocks; i++, buffer += 16 / sizeof(uint32_t) )
+  /* The blocks are processed in groups so that each call to aes_cypher()
+   * handles several blocks.
+   */
+
+  for (i = 0; i < blocks; i += nblocks)
     {
-      uint32_t T[4];
-      uint32_t X[4] = {bch->sector, 0, 0, i};
+      nblocks = blocks - i;
+      if (nblocks > BCH_CYPHER_BLOCKS)
+        {
+          nblocks = BCH_CYPHER_BLOCKS;
+        }
 
-      aes_cypher(X, X, 16, NULL, bch->key, CONFIG_BCH_ENCRYPTION_KEY_SIZE,
-                 AES_MODE_ECB, CYPHER_ENCRYPT);
+      for (j = 0; j < nblocks; j++)
+        {
+          X[j][0] = bch->sector;
+          X[j][1] = 0;
+          X[j][2] = 0;
+          X[j][3] = i + j;
+        }
+
+      aes_cypher(X, X, 16 * nblocks, NULL, bch->key,
+                 CONFIG_BCH_ENCRYPTION_KEY_SIZE, AES_MODE_ECB,
+                 CYPHER_ENCRYPT);
 
       /* Xor-Encrypt-Xor */
 
-      bch_xor(T, X, buffer);
-      aes_cypher(T, T, 16, NULL, bch->key, CONFIG_BCH_ENCRYPTION_KEY_SIZE,
-                 AES_MODE_ECB, encrypt);
-      bch_xor(buffer, X, T);
+      for (j = 0; j < nblocks; j++)
+        {
+          bch_xor(T[j], X[j], buffer + 4 * j);
+        }
+
+      aes_cypher(T, T, 16 * nblocks, NULL, bch->key,
+                 CONFIG_BCH_ENCRYPTION_KEY_SIZE, AES_MODE_ECB, encrypt);
+
+      for (j = 0; j < nblocks; j++, buffer += 16 / sizeof(uint32_t))
+        {
+          bch_xor(buffer, X[j], T[j]);
+        }
     }
 
   return OK;
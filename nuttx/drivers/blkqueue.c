@@ -0,0 +1,724 @@
+/****************************************************************************
+ * drivers/blkqueue.c
+ *
+ *   Copyright (C) 2014 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <semaphore.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kthread.h>
+#include <nuttx/blkqueue.h>
+
+#ifdef CONFIG_DRVR_BLKQUEUE
+
+/****************************************************************************
+ * Preprocessor Definitions
+ ****************************************************************************/
+
+/* Configuration ************************************************************/
+
+#ifndef CONFIG_DRVR_BLKQUEUE_PRIORITY
+#  define CONFIG_DRVR_BLKQUEUE_PRIORITY 100
+#endif
+
+#ifndef CONFIG_DRVR_BLKQUEUE_STACKSIZE
+#  define CONFIG_DRVR_BLKQUEUE_STACKSIZE 1024
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure holds the state of the block I/O daemon that services
+ * all request queues.
+ */
+
+struct blkq_daemon_s
+{
+  sem_t exclsem;                   /* Protects the queues and ready list */
+  sem_t waitsem;                   /* Signals the daemon that work is ready */
+  FAR struct blkqueue_s *head;     /* Queues with pending requests */
+  FAR struct blkqueue_s *tail;
+  pid_t pid;                       /* Task ID of the daemon */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void blkq_semtake(FAR sem_t *sem);
+#define blkq_semgive(s) sem_post(s)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct blkq_daemon_s g_blkq =
+{
+  SEM_INITIALIZER(1),
+  SEM_INITIALIZER(0),
+  NULL,
+  NULL,
+  0
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: blkq_semtake
+ ****************************************************************************/
+
+static void blkq_semtake(FAR sem_t *sem)
+{
+  /* Take the semaphore (perhaps waiting) */
+
+  while (sem_wait(sem) != 0)
+    {
+      /* The only case that an error should occur here is if
+       * the wait was awakened by a signal.
+       */
+
+      ASSERT(errno == EINTR);
+    }
+}
+
+/****************************************************************************
+ * Name: blkq_overlap
+ ****************************************************************************/
+
+static inline bool blkq_overlap(FAR struct blkreq_s *req1,
+                                FAR struct blkreq_s *req2)
+{
+  return req1->startblock < req2->startblock + (off_t)req2->nblocks &&
+         req2->startblock < req1->startblock + (off_t)req1->nblocks;
+}
+
+/****************************************************************************
+ * Name: blkq_older
+ *
+ * Description:
+ *   Return true if request 'req1' was submitted before request 'req2'.
+ *
+ ****************************************************************************/
+
+static inline bool blkq_older(FAR struct blkreq_s *req1,
+                              FAR struct blkreq_s *req2)
+{
+  return (int32_t)(req1->seqno - req2->seqno) < 0;
+}
+
+/****************************************************************************
+ * Name: blkq_blocked
+ *
+ * Description:
+ *   Return a pending request that was submitted before 'req' and that
+ *   overlaps it, or NULL if there is none.  Such a request must be
+ *   performed first.  The caller holds g_blkq.exclsem.
+ *
+ ****************************************************************************/
+
+static FAR struct blkreq_s *blkq_blocked(FAR struct blkqueue_s *queue,
+                                         FAR struct blkreq_s *req)
+{
+  FAR struct blkreq_s *curr;
+
+  for (curr = queue->pending; curr; curr = curr->flink)
+    {
+      if (curr != req && blkq_older(curr, req) && blkq_overlap(curr, req))
+        {
+          return curr;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: blkq_remove
+ *
+ * Description:
+ *   Remove a request from the list of pending requests.  The caller holds
+ *   g_blkq.exclsem.
+ *
+ ****************************************************************************/
+
+static void blkq_remove(FAR struct blkqueue_s *queue,
+                        FAR struct blkreq_s *req)
+{
+  FAR struct blkreq_s *prev;
+  FAR struct blkreq_s *curr;
+
+  for (prev = NULL, curr = queue->pending;
+       curr && curr != req;
+       prev = curr, curr = curr->flink);
+
+  DEBUGASSERT(curr != NULL);
+
+  if (prev)
+    {
+      prev->flink = req->flink;
+    }
+  else
+    {
+      queue->pending = req->flink;
+    }
+
+  req->flink = NULL;
+}
+
+/****************************************************************************
+ * Name: blkq_unready
+ *
+ * Description:
+ *   Remove a queue from the ready list.  The caller holds g_blkq.exclsem.
+ *
+ ****************************************************************************/
+
+static void blkq_unready(FAR struct blkqueue_s *queue)
+{
+  FAR struct blkqueue_s *prev;
+  FAR struct blkqueue_s *curr;
+
+  for (prev = NULL, curr = g_blkq.head;
+       curr && curr != queue;
+       prev = curr, curr = curr->flink);
+
+  if (curr)
+    {
+      if (prev)
+        {
+          prev->flink = queue->flink;
+        }
+      else
+        {
+          g_blkq.head = queue->flink;
+        }
+
+      if (g_blkq.tail == queue)
+        {
+          g_blkq.tail = prev;
+        }
+    }
+
+  queue->flink = NULL;
+  queue->ready = false;
+}
+
+/****************************************************************************
+ * Name: blkq_waitdone
+ *
+ * Description:
+ *   Wait until the transfer that is in progress on the queue (if any) has
+ *   completed.  The caller holds g_blkq.exclsem; it is released while
+ *   waiting and held again on return.
+ *
+ ****************************************************************************/
+
+static void blkq_waitdone(FAR struct blkqueue_s *queue)
+{
+  uint32_t ntransfers = queue->ntransfers;
+
+  /* A new transfer may be started on the queue before this thread runs
+   * again.  That is also the sign that the awaited transfer is done.
+   */
+
+  while (queue->busy && queue->ntransfers == ntransfers)
+    {
+      queue->nwaiters++;
+      blkq_semgive(&g_blkq.exclsem);
+      blkq_semtake(&queue->donesem);
+      blkq_semtake(&g_blkq.exclsem);
+    }
+}
+
+/****************************************************************************
+ * Name: blkq_select
+ *
+ * Description:
+ *   Select the next request to perform and merge any adjacent requests
+ *   into it.  The selected requests are removed from the pending list and
+ *   linked through their mlink fields.  The caller holds g_blkq.exclsem.
+ *
+ ****************************************************************************/
+
+static FAR struct blkreq_s *blkq_select(FAR struct blkqueue_s *queue,
+                                        FAR size_t *nblocks)
+{
+  FAR struct blkreq_s *first;
+  FAR struct blkreq_s *last;
+  FAR struct blkreq_s *curr;
+  FAR struct blkreq_s *older;
+  off_t endblock;
+
+  /* The pending list is sorted by block number.  Continue upward from the
+   * current head position, wrapping to the lowest block at the end.
+   */
+
+  for (first = queue->pending;
+       first && first->startblock < queue->headpos;
+       first = first->flink);
+
+  if (!first)
+    {
+      first = queue->pending;
+    }
+
+  DEBUGASSERT(first != NULL);
+
+  /* Never move a request ahead of an older request that overlaps it */
+
+  while ((older = blkq_blocked(queue, first)) != NULL)
+    {
+      first = older;
+    }
+
+  blkq_remove(queue, first);
+  first->mlink = NULL;
+  *nblocks     = first->nblocks;
+
+  /* Merge following requests for the same operation that continue both
+   * the block range and the buffer.
+   */
+
+  last     = first;
+  endblock = first->startblock + first->nblocks;
+
+  for (curr = queue->pending; curr; )
+    {
+      if (curr->startblock > endblock)
+        {
+          break;
+        }
+
+      if (curr->startblock == endblock &&
+          curr->op == first->op &&
+          curr->buffer == last->buffer + last->nblocks * queue->blocksize &&
+          (queue->maxblocks == 0 ||
+           *nblocks + curr->nblocks <= queue->maxblocks) &&
+          blkq_blocked(queue, curr) == NULL)
+        {
+          FAR struct blkreq_s *next = curr->flink;
+
+          blkq_remove(queue, curr);
+          curr->mlink  = NULL;
+          last->mlink  = curr;
+          last         = curr;
+          *nblocks    += curr->nblocks;
+          endblock    += curr->nblocks;
+          curr         = next;
+        }
+      else
+        {
+          curr = curr->flink;
+        }
+    }
+
+  return first;
+}
+
+/****************************************************************************
+ * Name: blkq_dispatch
+ *
+ * Description:
+ *   Perform one transfer from the queue at the head of the ready list.
+ *   Returns false if there was nothing to do.
+ *
+ ****************************************************************************/
+
+static bool blkq_dispatch(void)
+{
+  FAR struct blkqueue_s *queue;
+  FAR struct blkreq_s *req;
+  FAR struct blkreq_s *next;
+  size_t nblocks;
+  ssize_t ret;
+
+  blkq_semtake(&g_blkq.exclsem);
+
+  /* Take the queue at the head of the ready list */
+
+  queue = g_blkq.head;
+  if (!queue)
+    {
+      blkq_semgive(&g_blkq.exclsem);
+      return false;
+    }
+
+  g_blkq.head = queue->flink;
+  if (!g_blkq.head)
+    {
+      g_blkq.tail = NULL;
+    }
+
+  queue->flink = NULL;
+
+  /* Select the next (merged) transfer */
+
+  req = blkq_select(queue, &nblocks);
+
+  /* If the queue has more work, put it at the end of the ready list so
+   * that all devices get service.
+   */
+
+  if (queue->pending)
+    {
+      if (g_blkq.tail)
+        {
+          g_blkq.tail->flink = queue;
+        }
+      else
+        {
+          g_blkq.head = queue;
+        }
+
+      g_blkq.tail = queue;
+    }
+  else
+    {
+      queue->ready = false;
+    }
+
+  queue->headpos = req->startblock + nblocks;
+  queue->busy    = true;
+  queue->ntransfers++;
+  blkq_semgive(&g_blkq.exclsem);
+
+  /* Perform the transfer */
+
+  fvdbg("op=%d startblock=%ld nblocks=%lu\n",
+        req->op, (long)req->startblock, (unsigned long)nblocks);
+
+  if (req->op == BLKREQ_WRITE)
+    {
+      ret = queue->write(queue->dev, req->buffer, req->startblock, nblocks);
+    }
+  else
+    {
+      ret = queue->read(queue->dev, req->buffer, req->startblock, nblocks);
+    }
+
+  if (ret != (ssize_t)nblocks)
+    {
+      fdbg("ERROR: Transfer failed: %ld\n", (long)ret);
+      if (ret >= 0)
+        {
+          ret = -EIO;
+        }
+    }
+
+  /* Report the result of each merged request.  The callback may re-submit
+   * the request so the link must be sampled first.
+   */
+
+  for (; req; req = next)
+    {
+      next        = req->mlink;
+      req->mlink  = NULL;
+      req->result = ret < 0 ? ret : (ssize_t)req->nblocks;
+      req->callback(req);
+    }
+
+  /* Wake up any threads waiting for the transfer to complete.  After
+   * g_blkq.exclsem is released, the queue may be uninitialized and must
+   * not be referenced again.
+   */
+
+  blkq_semtake(&g_blkq.exclsem);
+  queue->busy = false;
+
+  while (queue->nwaiters > 0)
+    {
+      queue->nwaiters--;
+      blkq_semgive(&queue->donesem);
+    }
+
+  blkq_semgive(&g_blkq.exclsem);
+  return true;
+}
+
+/****************************************************************************
+ * Name: blkq_daemon
+ *
+ * Description:
+ *   The block I/O daemon performs the transfers of all request queues.
+ *
+ ****************************************************************************/
+
+static int blkq_daemon(int argc, char *argv[])
+{
+  for (;;)
+    {
+      blkq_semtake(&g_blkq.waitsem);
+
+      /* Perform transfers until all queues are empty */
+
+      while (blkq_dispatch());
+    }
+
+  return EXIT_SUCCESS; /* Not reached */
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: blkq_initialize
+ *
+ * Description:
+ *   Initialize a request queue.  The block I/O daemon is started when the
+ *   first queue is initialized.
+ *
+ ****************************************************************************/
+
+int blkq_initialize(FAR struct blkqueue_s *queue)
+{
+  int ret = OK;
+
+  DEBUGASSERT(queue != NULL && queue->blocksize > 0);
+  DEBUGASSERT(queue->read != NULL || queue->write != NULL);
+
+  queue->flink      = NULL;
+  queue->pending    = NULL;
+  queue->headpos    = 0;
+  queue->seqno      = 0;
+  queue->ready      = false;
+  queue->busy       = false;
+  queue->nwaiters   = 0;
+  queue->nsubmitted = 0;
+  queue->ntransfers = 0;
+
+  sem_init(&queue->donesem, 0, 0);
+
+  /* Start the daemon if it is not already running */
+
+  blkq_semtake(&g_blkq.exclsem);
+  if (g_blkq.pid <= 0)
+    {
+      g_blkq.pid = kernel_thread("blkqd", CONFIG_DRVR_BLKQUEUE_PRIORITY,
+                                 CONFIG_DRVR_BLKQUEUE_STACKSIZE,
+                                 blkq_daemon, NULL);
+      if (g_blkq.pid <= 0)
+        {
+          ret = -errno;
+          fdbg("ERROR: Failed to start the block I/O daemon: %d\n", ret);
+        }
+    }
+
+  blkq_semgive(&g_blkq.exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: blkq_submit
+ *
+ * Description:
+ *   Queue an asynchronous transfer request.  The request callback will be
+ *   called on the block I/O daemon thread when the transfer completes.
+ *
+ ****************************************************************************/
+
+int blkq_submit(FAR struct blkqueue_s *queue, FAR struct blkreq_s *req)
+{
+  FAR struct blkreq_s *prev;
+  FAR struct blkreq_s *curr;
+  int sval;
+
+  DEBUGASSERT(queue != NULL && req != NULL && req->callback != NULL);
+
+  if (req->nblocks == 0 || req->buffer == NULL ||
+      (req->op == BLKREQ_READ && queue->read == NULL) ||
+      (req->op == BLKREQ_WRITE && queue->write == NULL) ||
+      req->op > BLKREQ_WRITE)
+    {
+      return -EINVAL;
+    }
+
+  req->mlink  = NULL;
+  req->result = 0;
+
+  blkq_semtake(&g_blkq.exclsem);
+
+  /* Insert the request into the list sorted by block number (after any
+   * requests that start at the same block).
+   */
+
+  req->seqno = queue->seqno++;
+
+  for (prev = NULL, curr = queue->pending;
+       curr && curr->startblock <= req->startblock;
+       prev = curr, curr = curr->flink);
+
+  req->flink = curr;
+  if (prev)
+    {
+      prev->flink = req;
+    }
+  else
+    {
+      queue->pending = req;
+    }
+
+  queue->nsubmitted++;
+
+  /* Make sure that the queue is in the ready list */
+
+  if (!queue->ready)
+    {
+      queue->ready = true;
+      queue->flink = NULL;
+
+      if (g_blkq.tail)
+        {
+          g_blkq.tail->flink = queue;
+        }
+      else
+        {
+          g_blkq.head = queue;
+        }
+
+      g_blkq.tail = queue;
+    }
+
+  blkq_semgive(&g_blkq.exclsem);
+
+  /* Wake up the daemon (if it is not already awake) */
+
+  if (sem_getvalue(&g_blkq.waitsem, &sval) < 0 || sval <= 0)
+    {
+      blkq_semgive(&g_blkq.waitsem);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: blkq_cancel
+ *
+ * Description:
+ *   Cancel a request.  If the transfer of the request has not yet started,
+ *   the request is removed from the queue and its callback will never be
+ *   called.  If the transfer is in progress, this function waits for it to
+ *   complete (and for its callback to return).  In either case, the
+ *   request structure is no longer used by the queue on return.
+ *
+ *   This function must not be called from a request callback.
+ *
+ ****************************************************************************/
+
+int blkq_cancel(FAR struct blkqueue_s *queue, FAR struct blkreq_s *req)
+{
+  FAR struct blkreq_s *curr;
+  int ret = -EALREADY;
+
+  DEBUGASSERT(queue != NULL && req != NULL);
+  DEBUGASSERT(getpid() != g_blkq.pid);
+
+  blkq_semtake(&g_blkq.exclsem);
+
+  /* Is the request still pending? */
+
+  for (curr = queue->pending; curr && curr != req; curr = curr->flink);
+
+  if (curr)
+    {
+      /* Yes.. just remove it */
+
+      blkq_remove(queue, req);
+      if (!queue->pending && queue->ready)
+        {
+          blkq_unready(queue);
+        }
+
+      ret = OK;
+    }
+  else
+    {
+      /* No.. it may be part of the transfer in progress.  Wait for that
+       * transfer to complete.
+       */
+
+      blkq_waitdone(queue);
+    }
+
+  blkq_semgive(&g_blkq.exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: blkq_uninitialize
+ *
+ * Description:
+ *   Discard all pending requests (their callbacks are not called) and wait
+ *   for any transfer in progress to complete.  On return, the queue no
+ *   longer references the device or any request and may be freed.
+ *
+ *   This function must not be called from a request callback.
+ *
+ ****************************************************************************/
+
+void blkq_uninitialize(FAR struct blkqueue_s *queue)
+{
+  DEBUGASSERT(queue != NULL);
+  DEBUGASSERT(getpid() != g_blkq.pid);
+
+  blkq_semtake(&g_blkq.exclsem);
+
+  queue->pending = NULL;
+  if (queue->ready)
+    {
+      blkq_unready(queue);
+    }
+
+  blkq_waitdone(queue);
+  blkq_semgive(&g_blkq.exclsem);
+
+  sem_destroy(&queue->donesem);
+}
+
+#endif /* CONFIG_DRVR_BLKQUEUE */
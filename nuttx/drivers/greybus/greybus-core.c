@@ -36,6 +36,7 @@
 #include <arch/atomic.h>
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <errno.h>
 
@@ -70,26 +71,16 @@ static struct gb_operation_handler *find_operation_handler(uint8_t type,
                                                            unsigned int cport)
 {
     struct gb_driver *driver = g_cport[cport].driver;
-    int l,r;
+    struct gb_operation_handler key;
 
     if (type == GB_INVALID_TYPE || !driver->op_handlers) {
         return NULL;
     }
 
-    /* binary search -- bsearch from libc is not implemented by nuttx */
-    l = 0;
-    r = driver->op_handlers_count - 1;
-    while (l <= r) {
-        int m = (l + r) / 2;
-        if (driver->op_handlers[m].type < type)
-            l = m + 1;
-        else if (driver->op_handlers[m].type > type)
-            r = m - 1;
-        else
-            return &driver->op_handlers[m];
-    }
-
-    return NULL;
+    /* The handlers were sorted by type at registration */
+    key.type = type;
+    return bsearch(&key, driver->op_handlers, driver->op_handlers_count,
+                   sizeof(*driver->op_handlers), gb_compare_handlers);
 }
 
 static void gb_process_request(struct gb_operation_hdr *hdr,
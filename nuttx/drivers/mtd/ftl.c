@@ -46,10 +46,13 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <semaphore.h>
 #include <debug.h>
 #include <errno.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/clock.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/mtd/mtd.h>
@@ -63,10 +66,69 @@
 #  define FTL_HAVE_RWBUFFER 1
 #endif
 
+/* Erase block write-back cache */
+
+#ifndef CONFIG_FS_WRITABLE
+#  undef CONFIG_FTL_EBCACHE
+#endif
+
+#ifdef CONFIG_FTL_EBCACHE
+#  ifndef CONFIG_FTL_EBCACHE_NBLOCKS
+#    define CONFIG_FTL_EBCACHE_NBLOCKS 2
+#  endif
+
+#  ifndef CONFIG_FTL_EBCACHE_ERASEDSTATE
+#    define CONFIG_FTL_EBCACHE_ERASEDSTATE 0xff
+#  endif
+
+#  ifndef CONFIG_FTL_EBCACHE_DELAY
+#    define CONFIG_FTL_EBCACHE_DELAY 1000
+#  endif
+
+#  if !defined(CONFIG_SCHED_WORKQUEUE) || CONFIG_FTL_EBCACHE_DELAY <= 0
+#    undef CONFIG_FTL_EBCACHE_DELAY
+#  endif
+
+#  define FTL_BITMAPSIZE(n)  (((n) + 7) >> 3)
+#  define FTL_ISSET(m,b)     (((m)[(b) >> 3] & (1 << ((b) & 7))) != 0)
+#  define FTL_SET(m,b)       ((m)[(b) >> 3] |= (1 << ((b) & 7)))
+#  define FTL_CLR(m,b)       ((m)[(b) >> 3] &= ~(1 << ((b) & 7)))
+#endif
+
+/* Write data may be held in RAM by the write buffer and/or by the erase
+ * block cache.
+ */
+
+#if defined(CONFIG_FS_WRITABLE) && defined(CONFIG_FTL_WRITEBUFFER)
+#  define FTL_HAVE_WRBUFFER 1
+#endif
+
+#if defined(FTL_HAVE_WRBUFFER) || defined(CONFIG_FTL_EBCACHE)
+#  define FTL_HAVE_WRCACHE 1
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+#ifdef CONFIG_FTL_EBCACHE
+/* One erase block held in the write-back cache.  The dirty map marks the
+ * R/W blocks that differ from the FLASH; the erased map marks the R/W
+ * blocks that are known to be in the erased state on the FLASH and so can
+ * be programmed without erasing the erase block first.
+ */
+
+struct ftl_ebcache_s
+{
+  off_t                 eblock;  /* Cached erase block number (-1: unused) */
+  uint32_t              lastuse; /* Stamp of the last access, for LRU */
+  bool                  dirty;   /* True: Some R/W blocks are dirty */
+  FAR uint8_t          *dirtymap;  /* R/W blocks modified in the cache */
+  FAR uint8_t          *erasedmap; /* R/W blocks erased on the FLASH */
+  FAR uint8_t          *buffer;  /* Erase block data */
+};
+#endif
+
 struct ftl_struct_s
 {
   FAR struct mtd_dev_s *mtd;     /* Contained MTD interface */
@@ -75,7 +137,18 @@ struct ftl_struct_s
   struct rwbuffer_s     rwb;     /* Read-ahead/write buffer support */
 #endif
   uint16_t              blkper;  /* R/W blocks per erase block */
-#ifdef CONFIG_FS_WRITABLE
+#ifdef CONFIG_FTL_EBCACHE
+  sem_t                 exclsem; /* Exclusive access to the cache */
+  uint32_t              clock;   /* Access stamp for the cache LRU */
+  uint32_t              nerases;   /* Number of erase block erasures */
+  uint32_t              navoided;  /* Number of write-backs without an erase */
+  uint32_t              ncoalesced; /* Writes merged into a dirty erase block */
+  uint32_t              nwritebacks; /* Number of erase block write-backs */
+#ifdef CONFIG_FTL_EBCACHE_DELAY
+  struct work_s         work;    /* Delayed write-back of dirty erase blocks */
+#endif
+  struct ftl_ebcache_s  ebcache[CONFIG_FTL_EBCACHE_NBLOCKS];
+#elif defined(CONFIG_FS_WRITABLE)
   FAR uint8_t          *eblock;  /* One, in-memory erase block */
 #endif
 };
@@ -96,6 +169,12 @@ static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer,
 static ssize_t ftl_write(FAR struct inode *inode, const unsigned char *buffer,
                  size_t start_sector, unsigned int nsectors);
 #endif
+#ifdef CONFIG_FTL_EBCACHE
+static int     ftl_ebflushall(FAR struct ftl_struct_s *dev);
+#endif
+#ifdef FTL_HAVE_WRCACHE
+static int     ftl_flushall(FAR struct ftl_struct_s *dev);
+#endif
 static int     ftl_geometry(FAR struct inode *inode, struct geometry *geometry);
 static int     ftl_ioctl(FAR struct inode *inode, int cmd, unsigned long arg);
 
@@ -143,9 +222,333 @@ static int ftl_open(FAR struct inode *inode)
 
 static int ftl_close(FAR struct inode *inode)
 {
+#ifdef FTL_HAVE_WRCACHE
+  FAR struct ftl_struct_s *dev;
+  int ret;
+
   fvdbg("Entry\n");
+  DEBUGASSERT(inode && inode->i_private);
+
+  /* Write any buffered sectors and dirty erase blocks back to the FLASH */
+
+  dev = (FAR struct ftl_struct_s *)inode->i_private;
+  ret = ftl_flushall(dev);
+
+#ifdef CONFIG_FTL_EBCACHE
+  fvdbg("erases: %u avoided: %u coalesced: %u write-backs: %u\n",
+        dev->nerases, dev->navoided, dev->ncoalesced, dev->nwritebacks);
+#endif
+  return ret;
+#else
+  fvdbg("Entry\n");
+  return OK;
+#endif
+}
+
+/****************************************************************************
+ * Name: ftl_semtake
+ *
+ * Description: Take the semaphore that protects the erase block cache
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_EBCACHE
+static void ftl_semtake(FAR struct ftl_struct_s *dev)
+{
+  /* Take the semaphore (perhaps waiting) */
+
+  while (sem_wait(&dev->exclsem) != 0)
+    {
+      /* The only case that an error should occur here is if the wait was
+       * awakened by a signal.
+       */
+
+      ASSERT(errno == EINTR);
+    }
+}
+
+#  define ftl_semgive(d) sem_post(&(d)->exclsem)
+
+/****************************************************************************
+ * Name: ftl_iserased
+ *
+ * Description: Return true if a buffer is entirely in the erased state
+ *
+ ****************************************************************************/
+
+static bool ftl_iserased(FAR const uint8_t *buffer, size_t nbytes)
+{
+  while (nbytes-- > 0)
+    {
+      if (*buffer++ != CONFIG_FTL_EBCACHE_ERASEDSTATE)
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: ftl_ebwriteback
+ *
+ * Description: Write one cached erase block back to the FLASH.  The erase
+ *   is skipped if every dirty R/W block is still erased on the FLASH, and
+ *   R/W blocks that hold only erased data are never programmed.  Runs of
+ *   consecutive R/W blocks are written with a single transfer.
+ *
+ ****************************************************************************/
+
+static int ftl_ebwriteback(FAR struct ftl_struct_s *dev,
+                           FAR struct ftl_ebcache_s *entry)
+{
+  FAR uint8_t *buffer;
+  off_t    rwblock;
+  bool     erase;
+  ssize_t  nxfrd;
+  int      first;
+  int      i;
+  int      ret;
+
+  if (!entry->dirty)
+    {
+      return OK;
+    }
+
+  /* Can the dirty data be programmed without an erase? */
+
+  erase = false;
+  for (i = 0; i < dev->blkper; i++)
+    {
+      if (FTL_ISSET(entry->dirtymap, i) && !FTL_ISSET(entry->erasedmap, i))
+        {
+          erase = true;
+          break;
+        }
+    }
+
+  rwblock = entry->eblock * dev->blkper;
+  if (erase)
+    {
+      ret = MTD_ERASE(dev->mtd, entry->eblock, 1);
+      if (ret < 0)
+        {
+          fdbg("Erase block=%d failed: %d\n", entry->eblock, ret);
+          return ret;
+        }
+
+      /* Now every R/W block is erased and every R/W block must be
+       * rewritten.
+       */
+
+      memset(entry->erasedmap, 0xff, FTL_BITMAPSIZE(dev->blkper));
+      memset(entry->dirtymap, 0xff, FTL_BITMAPSIZE(dev->blkper));
+      dev->nerases++;
+    }
+  else
+    {
+      dev->navoided++;
+    }
+
+  /* Program the dirty R/W blocks that do not hold erased data */
+
+  for (i = 0, first = -1; i <= dev->blkper; i++)
+    {
+      buffer = entry->buffer + i * dev->geo.blocksize;
+      if (i < dev->blkper && FTL_ISSET(entry->dirtymap, i) &&
+          !ftl_iserased(buffer, dev->geo.blocksize))
+        {
+          if (first < 0)
+            {
+              first = i;
+            }
+
+          FTL_CLR(entry->erasedmap, i);
+        }
+      else if (first >= 0)
+        {
+          fvdbg("Write %d blocks at block=%d\n", i - first, rwblock + first);
+
+          nxfrd = MTD_BWRITE(dev->mtd, rwblock + first, i - first,
+                             entry->buffer + first * dev->geo.blocksize);
+          if (nxfrd != i - first)
+            {
+              fdbg("Write block %d failed: %d\n", rwblock + first, nxfrd);
+              return -EIO;
+            }
+
+          first = -1;
+        }
+    }
+
+  memset(entry->dirtymap, 0, FTL_BITMAPSIZE(dev->blkper));
+  entry->dirty = false;
+  dev->nwritebacks++;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_ebflushall
+ *
+ * Description: Write all dirty erase blocks back to the FLASH
+ *
+ ****************************************************************************/
+
+static int ftl_ebflushall(FAR struct ftl_struct_s *dev)
+{
+  int ret = OK;
+  int tmp;
+  int i;
+
+  ftl_semtake(dev);
+  for (i = 0; i < CONFIG_FTL_EBCACHE_NBLOCKS; i++)
+    {
+      tmp = ftl_ebwriteback(dev, &dev->ebcache[i]);
+      if (tmp < 0)
+        {
+          ret = tmp;
+        }
+    }
+
+  ftl_semgive(dev);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: ftl_ebtimeout
+ *
+ * Description: Write the dirty erase blocks back after a period with no
+ *   write activity.  Runs on the worker thread.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_EBCACHE_DELAY
+static void ftl_ebtimeout(FAR void *arg)
+{
+  (void)ftl_ebflushall((FAR struct ftl_struct_s *)arg);
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_ebget
+ *
+ * Description: Return the cache entry holding an erase block, loading it
+ *   from the FLASH (and evicting the least recently used entry) if it is
+ *   not already cached.  If 'load' is false, the caller is about to
+ *   overwrite the whole erase block so the old content is not read.  The
+ *   caller holds the cache semaphore.
+ *
+ ****************************************************************************/
+
+static FAR struct ftl_ebcache_s *ftl_ebget(FAR struct ftl_struct_s *dev,
+                                           off_t eblock, bool load)
+{
+  FAR struct ftl_ebcache_s *entry;
+  FAR struct ftl_ebcache_s *victim;
+  ssize_t nxfrd;
+  int     ret;
+  int     i;
+
+  victim = &dev->ebcache[0];
+  for (i = 0; i < CONFIG_FTL_EBCACHE_NBLOCKS; i++)
+    {
+      entry = &dev->ebcache[i];
+      if (entry->eblock == eblock)
+        {
+          entry->lastuse = ++dev->clock;
+          return entry;
+        }
+
+      if (entry->eblock < 0)
+        {
+          victim = entry;
+        }
+      else if (victim->eblock >= 0 && entry->lastuse < victim->lastuse)
+        {
+          victim = entry;
+        }
+    }
+
+  /* Evict the victim */
+
+  ret = ftl_ebwriteback(dev, victim);
+  if (ret < 0)
+    {
+      return NULL;
+    }
+
+  victim->eblock = -1;
+
+  /* And load the requested erase block in its place */
+
+  if (!load)
+    {
+      /* Nothing is known about the FLASH content */
+
+      memset(victim->erasedmap, 0, FTL_BITMAPSIZE(dev->blkper));
+    }
+  else
+    {
+      nxfrd = MTD_BREAD(dev->mtd, eblock * dev->blkper, dev->blkper,
+                        victim->buffer);
+      if (nxfrd != dev->blkper)
+        {
+          fdbg("Read erase block %d failed: %d\n", eblock, nxfrd);
+          return NULL;
+        }
+
+      for (i = 0; i < dev->blkper; i++)
+        {
+          if (ftl_iserased(victim->buffer + i * dev->geo.blocksize,
+                           dev->geo.blocksize))
+            {
+              FTL_SET(victim->erasedmap, i);
+            }
+          else
+            {
+              FTL_CLR(victim->erasedmap, i);
+            }
+        }
+    }
+
+  memset(victim->dirtymap, 0, FTL_BITMAPSIZE(dev->blkper));
+  victim->dirty   = false;
+  victim->eblock  = eblock;
+  victim->lastuse = ++dev->clock;
+  return victim;
+}
+#endif /* CONFIG_FTL_EBCACHE */
+
+/****************************************************************************
+ * Name: ftl_flushall
+ *
+ * Description: Write all data held in RAM back to the FLASH:  First the
+ *   sectors in the write buffer, which may go into the erase block cache,
+ *   and then the dirty erase blocks.
+ *
+ ****************************************************************************/
+
+#ifdef FTL_HAVE_WRCACHE
+static int ftl_flushall(FAR struct ftl_struct_s *dev)
+{
+#ifdef FTL_HAVE_WRBUFFER
+  int ret;
+
+  ret = rwb_flush(&dev->rwb);
+  if (ret < 0)
+    {
+      fdbg("ERROR: Write buffer flush failed: %d\n", ret);
+      return ret;
+    }
+#endif
+
+#ifdef CONFIG_FTL_EBCACHE
+  return ftl_ebflushall(dev);
+#else
   return OK;
+#endif
 }
+#endif
 
 /****************************************************************************
  * Name: ftl_reload
@@ -159,6 +562,14 @@ static ssize_t ftl_reload(FAR void *priv, FAR uint8_t *buffer,
 {
   struct ftl_struct_s *dev = (struct ftl_struct_s *)priv;
   ssize_t nread;
+#ifdef CONFIG_FTL_EBCACHE
+  FAR struct ftl_ebcache_s *entry;
+  off_t   first;
+  off_t   last;
+  int     i;
+
+  ftl_semtake(dev);
+#endif
 
   /* Read the full erase block into the buffer */
 
@@ -169,6 +580,44 @@ static ssize_t ftl_reload(FAR void *priv, FAR uint8_t *buffer,
             nblocks, startblock, nread);
     }
 
+#ifdef CONFIG_FTL_EBCACHE
+  /* The cache may hold newer data than the FLASH */
+
+  else
+    {
+      for (i = 0; i < CONFIG_FTL_EBCACHE_NBLOCKS; i++)
+        {
+          entry = &dev->ebcache[i];
+          if (entry->eblock < 0 || !entry->dirty)
+            {
+              continue;
+            }
+
+          first = entry->eblock * dev->blkper;
+          last  = first + dev->blkper;
+          if (first < startblock)
+            {
+              first = startblock;
+            }
+
+          if (last > startblock + (off_t)nblocks)
+            {
+              last = startblock + nblocks;
+            }
+
+          if (first < last)
+            {
+              memcpy(buffer + (first - startblock) * dev->geo.blocksize,
+                     entry->buffer +
+                     (first - entry->eblock * dev->blkper) * dev->geo.blocksize,
+                     (last - first) * dev->geo.blocksize);
+            }
+        }
+    }
+
+  ftl_semgive(dev);
+#endif
+
   return nread;
 }
 
@@ -189,7 +638,7 @@ static ssize_t ftl_read(FAR struct inode *inode, unsigned char *buffer,
   DEBUGASSERT(inode && inode->i_private);
 
   dev = (FAR struct ftl_struct_s *)inode->i_private;
-#ifdef CONFIG_FTL_READAHEAD
+#ifdef FTL_HAVE_RWBUFFER
   return rwb_read(&dev->rwb, start_sector, nsectors, buffer);
 #else
   return ftl_reload(dev, buffer, start_sector, nsectors);
@@ -203,7 +652,79 @@ static ssize_t ftl_read(FAR struct inode *inode, unsigned char *buffer,
  *
  ****************************************************************************/
 
-#ifdef CONFIG_FS_WRITABLE
+#ifdef CONFIG_FTL_EBCACHE
+static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer,
+                         off_t startblock, size_t nblocks)
+{
+  struct ftl_struct_s *dev = (struct ftl_struct_s *)priv;
+  FAR struct ftl_ebcache_s *entry;
+  off_t  eblock;
+  off_t  offset;
+  size_t remaining;
+  size_t count;
+  size_t i;
+
+#ifdef CONFIG_FTL_EBCACHE_DELAY
+  (void)work_cancel(LPWORK, &dev->work);
+#endif
+
+  ftl_semtake(dev);
+
+  /* Merge the data into the cached erase blocks.  The FLASH is only
+   * updated when an erase block is evicted, flushed or times out.
+   */
+
+  remaining = nblocks;
+  while (remaining > 0)
+    {
+      eblock = startblock / dev->blkper;
+      offset = startblock - eblock * dev->blkper;
+      count  = dev->blkper - offset;
+      if (count > remaining)
+        {
+          count = remaining;
+        }
+
+      entry = ftl_ebget(dev, eblock, count < dev->blkper);
+      if (entry == NULL)
+        {
+          ftl_semgive(dev);
+          return -EIO;
+        }
+
+      if (entry->dirty)
+        {
+          dev->ncoalesced++;
+        }
+
+      fvdbg("Copy %d blocks into erase block=%d at offset=%d\n",
+            count, eblock, offset);
+
+      memcpy(entry->buffer + offset * dev->geo.blocksize, buffer,
+             count * dev->geo.blocksize);
+
+      for (i = 0; i < count; i++)
+        {
+          FTL_SET(entry->dirtymap, offset + i);
+        }
+
+      entry->dirty = true;
+      startblock  += count;
+      remaining   -= count;
+      buffer      += count * dev->geo.blocksize;
+    }
+
+  ftl_semgive(dev);
+
+#ifdef CONFIG_FTL_EBCACHE_DELAY
+  (void)work_queue(LPWORK, &dev->work, ftl_ebtimeout, (FAR void *)dev,
+                   MSEC2TICK(CONFIG_FTL_EBCACHE_DELAY));
+#endif
+
+  return nblocks;
+}
+
+#elif defined(CONFIG_FS_WRITABLE)
 static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer,
                          off_t startblock, size_t nblocks)
 {
@@ -451,6 +972,17 @@ static int ftl_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
   fvdbg("Entry\n");
   DEBUGASSERT(inode && inode->i_private);
 
+  dev = (struct ftl_struct_s *)inode->i_private;
+
+#ifdef FTL_HAVE_WRCACHE
+  /* Write back the write buffer and the erase block cache on request */
+
+  if (cmd == BIOC_FLUSH)
+    {
+      return ftl_flushall(dev);
+    }
+#endif
+
   /* Only one block driver ioctl command is supported by this driver (and
    * that command is just passed on to the MTD driver in a slightly
    * different form).
@@ -471,6 +1003,18 @@ static int ftl_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
         }
 #endif
 
+#ifdef FTL_HAVE_WRCACHE
+      /* The media will be accessed directly so any data still held in the
+       * write buffer or in the erase block cache must be written back first.
+       */
+
+      ret = ftl_flushall(dev);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+#endif
       /* Just change the BIOC_XIPBASE command to the MTDIOC_XIPBASE command. */
 
       cmd = MTDIOC_XIPBASE;
@@ -481,7 +1025,6 @@ static int ftl_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
    * to the MTD driver (unchanged).
    */
 
-  dev = (struct ftl_struct_s *)inode->i_private;
   ret = MTD_IOCTL(dev->mtd, cmd, arg);
   if (ret < 0)
     {
@@ -513,6 +1056,9 @@ int ftl_initialize(int minor, FAR struct mtd_dev_s *mtd)
   struct ftl_struct_s *dev;
   char devname[16];
   int ret = -ENOMEM;
+#ifdef CONFIG_FTL_EBCACHE
+  int i;
+#endif
 
   /* Sanity check */
 
@@ -545,9 +1091,49 @@ int ftl_initialize(int minor, FAR struct mtd_dev_s *mtd)
           return ret;
         }
 
-      /* Allocate one, in-memory erase block buffer */
+      /* Allocate the in-memory erase block buffers */
+
+#ifdef CONFIG_FTL_EBCACHE
+      sem_init(&dev->exclsem, 0, 1);
+      dev->clock       = 0;
+      dev->nerases     = 0;
+      dev->navoided    = 0;
+      dev->ncoalesced  = 0;
+      dev->nwritebacks = 0;
+#ifdef CONFIG_FTL_EBCACHE_DELAY
+      memset(&dev->work, 0, sizeof(struct work_s));
+#endif
 
-#ifdef CONFIG_FS_WRITABLE
+      for (i = 0; i < CONFIG_FTL_EBCACHE_NBLOCKS; i++)
+        {
+          FAR struct ftl_ebcache_s *entry = &dev->ebcache[i];
+          size_t mapsize = FTL_BITMAPSIZE(dev->geo.erasesize /
+                                          dev->geo.blocksize);
+
+          /* The buffer and the two bitmaps are allocated together */
+
+          entry->buffer = (FAR uint8_t *)
+            kmm_malloc(dev->geo.erasesize + 2 * mapsize);
+          if (!entry->buffer)
+            {
+              fdbg("Failed to allocate an erase block buffer\n");
+              while (--i >= 0)
+                {
+                  kmm_free(dev->ebcache[i].buffer);
+                }
+
+              kmm_free(dev);
+              return -ENOMEM;
+            }
+
+          entry->dirtymap  = entry->buffer + dev->geo.erasesize;
+          entry->erasedmap = entry->dirtymap + mapsize;
+          entry->eblock    = -1;
+          entry->lastuse   = 0;
+          entry->dirty     = false;
+        }
+
+#elif defined(CONFIG_FS_WRITABLE)
       dev->eblock  = (FAR uint8_t *)kmm_malloc(dev->geo.erasesize);
       if (!dev->eblock)
         {
@@ -572,12 +1158,32 @@ int ftl_initialize(int minor, FAR struct mtd_dev_s *mtd)
 #if defined(CONFIG_FS_WRITABLE) && defined(CONFIG_FTL_WRITEBUFFER)
       dev->rwb.wrmaxblocks = dev->blkper;
       dev->rwb.wrflush     = ftl_flush;
+#elif defined(CONFIG_DRVR_WRITEBUFFER)
+      dev->rwb.wrmaxblocks = 0;
+#endif
+
+#if defined(CONFIG_DRVR_WRITEBUFFER) && defined(CONFIG_DRVR_BLKQUEUE)
+#ifdef CONFIG_FTL_EBCACHE
+      /* The erase block cache serializes reloads with its write-back */
+
+      dev->rwb.wrgranule   = 0;
+#else
+      /* ftl_flush() reads, erases and rewrites whole erase blocks */
+
+      dev->rwb.wrgranule   = dev->blkper;
+#endif
 #endif
 
+      /* Reads always go through rwb_read() so that they are ordered with
+       * respect to any flush of the write buffer.
+       */
+
 #ifdef CONFIG_FTL_READAHEAD
       dev->rwb.rhmaxblocks = dev->blkper;
-      dev->rwb.rhreload    = ftl_reload;
+#elif defined(CONFIG_DRVR_READAHEAD)
+      dev->rwb.rhmaxblocks = 0;
 #endif
+      dev->rwb.rhreload    = ftl_reload;
 
       ret = rwb_initialize(&dev->rwb);
       if (ret < 0)
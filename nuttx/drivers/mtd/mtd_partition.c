@@ -426,11 +426,11 @@ static int part_ioctl(FAR struct mtd_dev_s *dev, int cmd, unsigned long arg)
       case MTDIOC_XIPBASE:
         {
           FAR void **ppv = (FAR void**)arg;
-          unsigned long base;
+          FAR uint8_t *base;
 
           if (ppv)
             {
-              /* Get hte XIP base of the entire FLASH */
+              /* Get the XIP base of the entire FLASH */
 
               ret = priv->parent->ioctl(priv->parent, MTDIOC_XIPBASE,
                                         (unsigned long)((uintptr_t)&base));
@@ -440,7 +440,8 @@ static int part_ioctl(FAR struct mtd_dev_s *dev, int cmd, unsigned long arg)
                    * return the sum to the caller.
                    */
 
-                  *ppv = (FAR void *)(base + priv->firstblock * priv->blocksize);
+                  *ppv = (FAR void *)(base +
+                                      (size_t)priv->firstblock * priv->blocksize);
                 }
             }
         }
@@ -304,6 +304,24 @@ static int mtd_ioctl(FAR struct mtd_dev_s *dev, int cmd, unsigned long arg)
         break;
 
       case MTDIOC_XIPBASE:
+        {
+          /* The buffered device is laid out exactly as the contained
+           * device.  Write any buffered data to the media and return the
+           * XIP base address of the contained device.
+           */
+
+#ifdef CONFIG_DRVR_WRITEBUFFER
+          ret = rwb_flush(&priv->rwb);
+          if (ret < 0)
+            {
+              fdbg("ERROR: rwb_flush failed: %d\n", ret);
+              break;
+            }
+#endif
+          ret = priv->dev->ioctl(priv->dev, MTDIOC_XIPBASE, arg);
+        }
+        break;
+
       default:
         ret = -ENOTTY; /* Bad command */
         break;
@@ -545,6 +545,19 @@ static int s512_ioctl(FAR struct mtd_dev_s *dev, int cmd, unsigned long arg)
         break;
 
       case MTDIOC_XIPBASE:
+        {
+          /* The 512 byte sectors are laid out exactly as the sectors of the
+           * contained device, so the XIP base address of that device is
+           * also valid here.  Write any cached erase block to FLASH first.
+           */
+
+#if !defined(CONFIG_MTD_SECT512_READONLY)
+          s512_cacheflush(priv);
+#endif
+          ret = priv->dev->ioctl(priv->dev, MTDIOC_XIPBASE, arg);
+        }
+        break;
+
       default:
         ret = -ENOTTY; /* Bad command */
         break;
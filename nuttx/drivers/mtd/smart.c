@@ -53,12 +53,17 @@
 #include <errno.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/clock.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/mtd/mtd.h>
 #include <nuttx/mtd/smart.h>
 #include <nuttx/fs/smart.h>
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+#  include <crc32.h>
+#endif
+
 /****************************************************************************
  * Private Definitions
  ****************************************************************************/
@@ -115,6 +120,45 @@
 #  define  CONFIG_MTD_SMART_SECTOR_SIZE 1024
 #endif
 
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+#  ifndef CONFIG_MTD_SMART_SECTOR_CACHE_SIZE
+#    define CONFIG_MTD_SMART_SECTOR_CACHE_SIZE 64
+#  endif
+
+/* The cached part of the map is held in pages of consecutive logical
+ * sectors.  A page miss costs one pass over the sector headers, which
+ * fills in every entry of the page at once.
+ */
+
+#  define SMART_MAP_PAGE_SHIFT    4
+#  define SMART_MAP_PAGE_SIZE     (1 << SMART_MAP_PAGE_SHIFT)
+#  define SMART_MAP_PAGE_MASK     (SMART_MAP_PAGE_SIZE - 1)
+#  define SMART_MAP_NPAGES \
+     ((CONFIG_MTD_SMART_SECTOR_CACHE_SIZE + SMART_MAP_PAGE_MASK) >> \
+      SMART_MAP_PAGE_SHIFT)
+#endif
+
+#if defined(CONFIG_MTD_SMART_WEAR_LEVEL) || \
+    defined(CONFIG_MTD_SMART_SECTOR_ERASE_DEBUG)
+#  define SMART_HAVE_ERASECOUNTS 1
+#endif
+
+/* The checkpoint cannot describe a cached map and does not know how to
+ * re-register the extra root directory devices.
+ */
+
+#if defined(CONFIG_MTD_SMART_MINIMIZE_RAM) || \
+    defined(CONFIG_SMARTFS_MULTI_ROOT_DIRS)
+#  undef CONFIG_MTD_SMART_CHECKPOINT
+#endif
+
+/* Checkpoint header definitions */
+
+#define SMART_CP_SIG1             'C'
+#define SMART_CP_SIG2             'P'
+#define SMART_CP_VERSION          1
+#define SMART_CP_MAXBLOCKS(n)     ((n) >> 3) /* At most 1/8 of the device */
+
 #ifndef offsetof
 #define offsetof(type, member) ( (size_t) &( ( (type *) 0)->member))
 #endif
@@ -123,6 +167,15 @@
  * Private Types
  ****************************************************************************/
 
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+struct smart_cache_s
+{
+  uint16_t              page;             /* Map page number (0xFFFF = unused) */
+  uint32_t              lastuse;          /* Stamp of the last lookup that hit */
+  uint16_t              physical[SMART_MAP_PAGE_SIZE]; /* Physical sectors */
+};
+#endif
+
 struct smart_struct_s
 {
   FAR struct mtd_dev_s *mtd;              /* Contained MTD interface */
@@ -133,18 +186,36 @@ struct smart_struct_s
   uint16_t              sectorsPerBlk;    /* Number of sectors per erase block */
   uint16_t              sectorsize;       /* Sector size on device */
   uint16_t              totalsectors;     /* Total number of sectors on device */
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+  FAR uint8_t          *sBitMap;          /* One bit per allocated logical sector */
+  FAR struct smart_cache_s *sCache;       /* Cached pages of the sector map */
+  uint32_t              cacheclock;       /* Last use stamp for the cache LRU */
+#else
   FAR uint16_t         *sMap;             /* Virtual to physical sector map */
+#endif
   FAR uint8_t          *releasecount;     /* Count of released sectors per erase block */
   FAR uint8_t          *freecount;        /* Count of free sectors per erase block */
+#ifdef SMART_HAVE_ERASECOUNTS
+  FAR uint8_t          *erasecounts;      /* Relative erase count per erase block */
+#endif
   FAR char             *rwbuffer;         /* Our sector read/write buffer */
   char                  partname[SMART_PARTNAME_SIZE]; /* Optional partition name */
   uint8_t               formatversion;    /* Format version on the device */
   uint8_t               formatstatus;     /* Indicates the status of the device format */
   uint8_t               namesize;         /* Length of filenames on this device */
+  uint8_t               mapsource;        /* Where the sector map came from */
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  uint8_t               cpblocks;         /* Erase blocks reserved for the checkpoint */
+  bool                  cpvalid;          /* Checkpoint on FLASH matches the RAM state */
+#endif
 #ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
   uint8_t               rootdirentries;   /* Number of root directory entries */
   uint8_t               minor;            /* Minor number of the block entry */
 #endif
+  uint32_t              blockerases;      /* Number of erase block erasures */
+  uint32_t              gccount;          /* Number of garbage collected blocks */
+  uint32_t              gcrelocs;         /* Number of sectors moved by garbage collection */
+  uint32_t              scantime;         /* Duration of the last mount scan (msec) */
 };
 
 #ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
@@ -171,6 +242,32 @@ struct smart_sect_header_s
                                            * Bit 1-0: Format version    */
 };
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+/* A checkpoint of the RAM state is kept at the start of the erase blocks
+ * reserved at the end of the device.  It is followed by the sector map,
+ * the release counts, the free counts and (if enabled) the erase counts.
+ * The status byte follows the same commit/release convention as a sector
+ * header:  the checkpoint is only used if it is committed and has not been
+ * released.
+ */
+
+struct smart_cp_header_s
+{
+  uint8_t               status;           /* Commit / release status */
+  uint8_t               version;          /* Checkpoint layout version */
+  uint8_t               sig[2];           /* Checkpoint signature */
+  uint8_t               formatversion;    /* Saved format version */
+  uint8_t               namesize;         /* Saved name size */
+  uint16_t              sectorsize;       /* Sector size of the saved map */
+  uint16_t              totalsectors;     /* Number of entries in the saved map */
+  uint16_t              neraseblocks;     /* Number of erase blocks described */
+  uint16_t              freesectors;      /* Saved free sector count */
+  uint16_t              reserved;
+  uint32_t              blockerases;      /* Saved erase statistics */
+  uint32_t              crc;              /* CRC32 of the data that follows */
+};
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -187,6 +284,9 @@ static ssize_t smart_write(FAR struct inode *inode, const unsigned char *buffer,
 #endif
 static int     smart_geometry(FAR struct inode *inode, struct geometry *geometry);
 static int     smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg);
+#if defined(CONFIG_MTD_SMART_CHECKPOINT) && defined(CONFIG_FS_WRITABLE)
+static int     smart_cpwrite(FAR struct smart_struct_s *dev);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -232,8 +332,21 @@ static int smart_open(FAR struct inode *inode)
 
 static int smart_close(FAR struct inode *inode)
 {
+#if defined(CONFIG_MTD_SMART_CHECKPOINT) && defined(CONFIG_FS_WRITABLE)
+  FAR struct smart_struct_s *dev;
+#endif
+
   fvdbg("Entry\n");
+
+#if defined(CONFIG_MTD_SMART_CHECKPOINT) && defined(CONFIG_FS_WRITABLE)
+  /* Save the sector map so that the next mount can skip the scan */
+
+  DEBUGASSERT(inode && inode->i_private);
+  dev = (FAR struct smart_struct_s *)inode->i_private;
+  return smart_cpwrite(dev);
+#else
   return OK;
+#endif
 }
 
 /****************************************************************************
@@ -448,7 +561,7 @@ static int smart_geometry(FAR struct inode *inode, struct geometry *geometry)
           erasesize = 65536;
         }
 
-      geometry->geo_nsectors      = dev->geo.neraseblocks * erasesize /
+      geometry->geo_nsectors      = dev->neraseblocks * erasesize /
                                      dev->sectorsize;
       geometry->geo_sectorsize    = dev->sectorsize;
 
@@ -463,6 +576,210 @@ static int smart_geometry(FAR struct inode *inode, struct geometry *geometry)
   return -EINVAL;
 }
 
+/****************************************************************************
+ * Name: smart_cache_lookup
+ *
+ * Description: Finds the physical sector mapped to a logical sector when
+ *              the full sector map is not kept in RAM.  The map is cached
+ *              in pages of SMART_MAP_PAGE_SIZE consecutive logical sectors.
+ *              On a page miss, the least recently used page is replaced by
+ *              searching the headers of the physical sectors below 'limit'
+ *              once for every allocated logical sector in the page.
+ *
+ *              The search skips erase blocks with nothing committed and
+ *              stops as soon as every allocated sector of the page has been
+ *              found, but the worst case is still one header read per
+ *              physical sector for each page miss.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+static uint16_t smart_cache_lookup(FAR struct smart_struct_s *dev,
+                                   uint16_t logical, uint16_t limit)
+{
+  FAR struct smart_cache_s *cache;
+  struct smart_sect_header_s header;
+  uint16_t  page;
+  uint16_t  first;
+  uint16_t  entry;
+  uint16_t  sector;
+  int       needed;
+  int       victim;
+  int       x;
+  int       ret;
+
+  /* Search the cached pages first */
+
+  page = logical >> SMART_MAP_PAGE_SHIFT;
+  victim = 0;
+  for (x = 0; x < SMART_MAP_NPAGES; x++)
+    {
+      if (dev->sCache[x].page == page)
+        {
+          dev->sCache[x].lastuse = ++dev->cacheclock;
+          return dev->sCache[x].physical[logical & SMART_MAP_PAGE_MASK];
+        }
+
+      if (dev->sCache[x].lastuse < dev->sCache[victim].lastuse)
+        {
+          victim = x;
+        }
+    }
+
+  /* Not cached.  Count the allocated logical sectors in the page so that
+   * the search can stop once all of them have been found.
+   */
+
+  cache = &dev->sCache[victim];
+  cache->page = 0xFFFF;
+  cache->lastuse = 0;
+
+  first = page << SMART_MAP_PAGE_SHIFT;
+  needed = 0;
+  for (x = 0; x < SMART_MAP_PAGE_SIZE; x++)
+    {
+      cache->physical[x] = 0xFFFF;
+      entry = first + x;
+      if (entry < dev->totalsectors &&
+          (dev->sBitMap[entry >> 3] & (1 << (entry & 7))) != 0)
+        {
+          needed++;
+        }
+    }
+
+  /* Search the FLASH for committed, unreleased sectors that claim a
+   * logical sector in this page.
+   */
+
+  for (sector = 0; sector < limit && needed > 0; sector++)
+    {
+      if ((sector % dev->sectorsPerBlk) == 0 &&
+          dev->freecount[sector / dev->sectorsPerBlk] == dev->sectorsPerBlk)
+        {
+          /* Nothing has been committed in this erase block */
+
+          sector += dev->sectorsPerBlk - 1;
+          continue;
+        }
+
+      ret = MTD_READ(dev->mtd, (size_t) sector * dev->mtdBlksPerSector *
+                     dev->geo.blocksize, sizeof(struct smart_sect_header_s),
+                     (uint8_t *) &header);
+      if (ret != sizeof(struct smart_sect_header_s))
+        {
+          fdbg("Error reading phys sector %d\n", sector);
+          return 0xFFFF;
+        }
+
+      entry = *((uint16_t *) header.logicalsector);
+      if ((entry >> SMART_MAP_PAGE_SHIFT) == page &&
+          entry < dev->totalsectors &&
+          (dev->sBitMap[entry >> 3] & (1 << (entry & 7))) != 0 &&
+          cache->physical[entry & SMART_MAP_PAGE_MASK] == 0xFFFF &&
+          (header.status & SMART_STATUS_COMMITTED) !=
+          (CONFIG_SMARTFS_ERASEDSTATE & SMART_STATUS_COMMITTED) &&
+          (header.status & SMART_STATUS_RELEASED) ==
+          (CONFIG_SMARTFS_ERASEDSTATE & SMART_STATUS_RELEASED))
+        {
+          cache->physical[entry & SMART_MAP_PAGE_MASK] = sector;
+          needed--;
+        }
+    }
+
+  cache->page    = page;
+  cache->lastuse = ++dev->cacheclock;
+  return cache->physical[logical & SMART_MAP_PAGE_MASK];
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_getmap
+ *
+ * Description: Returns the physical sector mapped to a logical sector or
+ *              0xFFFF if the logical sector is not allocated.
+ *
+ ****************************************************************************/
+
+static uint16_t smart_getmap(FAR struct smart_struct_s *dev, uint16_t logical)
+{
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+  if ((dev->sBitMap[logical >> 3] & (1 << (logical & 7))) == 0)
+    {
+      return 0xFFFF;
+    }
+
+  return smart_cache_lookup(dev, logical, dev->totalsectors);
+#else
+  return dev->sMap[logical];
+#endif
+}
+
+/****************************************************************************
+ * Name: smart_setmap
+ *
+ * Description: Maps a logical sector to a physical sector.  A physical
+ *              sector of 0xFFFF unmaps the logical sector.
+ *
+ ****************************************************************************/
+
+static void smart_setmap(FAR struct smart_struct_s *dev, uint16_t logical,
+                         uint16_t physical)
+{
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+  int x;
+
+  if (physical == 0xFFFF)
+    {
+      dev->sBitMap[logical >> 3] &= ~(1 << (logical & 7));
+    }
+  else
+    {
+      dev->sBitMap[logical >> 3] |= 1 << (logical & 7);
+    }
+
+  /* Update the cached page holding this logical sector, if any.  Pages
+   * that are not cached are rebuilt from the sector headers, which are
+   * already up to date when the map is changed.
+   */
+
+  for (x = 0; x < SMART_MAP_NPAGES; x++)
+    {
+      if (dev->sCache[x].page == (logical >> SMART_MAP_PAGE_SHIFT))
+        {
+          dev->sCache[x].physical[logical & SMART_MAP_PAGE_MASK] = physical;
+          break;
+        }
+    }
+#else
+  dev->sMap[logical] = physical;
+#endif
+}
+
+/****************************************************************************
+ * Name: smart_clearmap
+ *
+ * Description: Marks all logical sectors as unallocated.
+ *
+ ****************************************************************************/
+
+static void smart_clearmap(FAR struct smart_struct_s *dev)
+{
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+  int x;
+
+  memset(dev->sBitMap, 0, (dev->totalsectors + 7) >> 3);
+  for (x = 0; x < SMART_MAP_NPAGES; x++)
+    {
+      dev->sCache[x].page    = 0xFFFF;
+      dev->sCache[x].lastuse = 0;
+    }
+
+  dev->cacheclock = 0;
+#else
+  memset(dev->sMap, 0xFF, dev->totalsectors * sizeof(uint16_t));
+#endif
+}
+
 /****************************************************************************
  * Name: smart_setsectorsize
  *
@@ -473,8 +790,10 @@ static int smart_geometry(FAR struct inode *inode, struct geometry *geometry)
 
 static int smart_setsectorsize(struct smart_struct_s *dev, uint16_t size)
 {
+  FAR uint8_t *map;
   uint32_t  erasesize;
   uint32_t  totalsectors;
+  size_t    mapsize;
 
   /* Validate the size isn't zero so we don't divide by zero below */
 
@@ -499,12 +818,53 @@ static int smart_setsectorsize(struct smart_struct_s *dev, uint16_t size)
   dev->mtdBlksPerSector = dev->sectorsize / dev->geo.blocksize;
   dev->sectorsPerBlk = erasesize / dev->sectorsize;
 
-  /* Release any existing rwbuffer and sMap */
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  /* Reserve enough erase blocks at the end of the device to hold the
+   * checkpoint header, the sector map and the per erase block counts.
+   */
+
+  for (dev->cpblocks = 1; ; dev->cpblocks++)
+    {
+      uint32_t nblocks = dev->geo.neraseblocks - dev->cpblocks;
+      uint32_t needed  = sizeof(struct smart_cp_header_s) +
+                         nblocks * dev->sectorsPerBlk * sizeof(uint16_t) +
+                         nblocks * 2;
+#ifdef SMART_HAVE_ERASECOUNTS
+      needed += nblocks;
+#endif
+
+      if (dev->cpblocks > SMART_CP_MAXBLOCKS(dev->geo.neraseblocks))
+        {
+          /* The map is too big for this device.  Just scan at mount. */
+
+          fdbg("Device too small for a SMART checkpoint\n");
+          dev->cpblocks = 0;
+          break;
+        }
+
+      if (needed <= dev->cpblocks * erasesize)
+        {
+          break;
+        }
+    }
+
+  dev->neraseblocks -= dev->cpblocks;
+  dev->cpvalid       = false;
+#endif
 
+  /* Release any existing rwbuffer and sector map */
+
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+  if (dev->sBitMap != NULL)
+    {
+      kmm_free(dev->sBitMap);
+    }
+#else
   if (dev->sMap != NULL)
     {
       kmm_free(dev->sMap);
     }
+#endif
 
   if (dev->rwbuffer != NULL)
     {
@@ -512,31 +872,76 @@ static int smart_setsectorsize(struct smart_struct_s *dev, uint16_t size)
     }
 
   /* Allocate a virtual to physical sector map buffer.  Also allocate
-   * the storage space for releasecount and freecounts.
+   * the storage space for releasecount and freecounts (and erasecounts).
+   * When minimizing RAM usage, only a bitmap of allocated logical sectors
+   * is kept and the physical locations are looked up through a few
+   * cached pages of the map.
    */
 
   totalsectors = dev->neraseblocks * dev->sectorsPerBlk;
   dev->totalsectors = (uint16_t) totalsectors;
 
-  dev->sMap = (uint16_t *) kmm_malloc(totalsectors * sizeof(uint16_t) +
-              (dev->neraseblocks << 1));
-  if (!dev->sMap)
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+  mapsize = (totalsectors + 7) >> 3;
+#else
+  mapsize = totalsectors * sizeof(uint16_t);
+#endif
+
+#ifdef SMART_HAVE_ERASECOUNTS
+  mapsize += dev->neraseblocks;
+#endif
+
+  map = (FAR uint8_t *) kmm_malloc(mapsize + (dev->neraseblocks << 1));
+  if (!map)
     {
       fdbg("Error allocating SMART virtual map buffer\n");
       kmm_free(dev);
       return -EINVAL;
     }
 
-  dev->releasecount = (uint8_t *) dev->sMap + (totalsectors * sizeof(uint16_t));
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+  dev->sBitMap = map;
+  map += (totalsectors + 7) >> 3;
+
+  if (dev->sCache == NULL)
+    {
+      dev->sCache = (FAR struct smart_cache_s *)
+        kmm_malloc(SMART_MAP_NPAGES * sizeof(struct smart_cache_s));
+      if (!dev->sCache)
+        {
+          fdbg("Error allocating SMART sector cache\n");
+          kmm_free(dev->sBitMap);
+          kmm_free(dev);
+          return -EINVAL;
+        }
+    }
+#else
+  dev->sMap = (FAR uint16_t *) map;
+  map += totalsectors * sizeof(uint16_t);
+#endif
+
+  dev->releasecount = map;
   dev->freecount = dev->releasecount + dev->neraseblocks;
 
+#ifdef SMART_HAVE_ERASECOUNTS
+  dev->erasecounts = dev->freecount + dev->neraseblocks;
+  memset(dev->erasecounts, 0, dev->neraseblocks);
+#endif
+
+  smart_clearmap(dev);
+
   /* Allocate a read/write buffer */
 
   dev->rwbuffer = (char *) kmm_malloc(size);
   if (!dev->rwbuffer)
     {
       fdbg("Error allocating SMART read/write buffer\n");
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+      kmm_free(dev->sBitMap);
+      kmm_free(dev->sCache);
+#else
       kmm_free(dev->sMap);
+#endif
       kmm_free(dev);
       return -EINVAL;
     }
@@ -614,6 +1019,294 @@ errout:
   return ret;
 }
 
+/****************************************************************************
+ * Name: smart_cpinvalidate
+ *
+ * Description: Releases the checkpoint on the FLASH the first time the
+ *              RAM state is about to diverge from it.  Since the status
+ *              byte of the checkpoint header may be written through the
+ *              rwbuffer, this must be called before the rwbuffer is used.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_MTD_SMART_CHECKPOINT) && defined(CONFIG_FS_WRITABLE)
+static bool smart_cpinvalidate(FAR struct smart_struct_s *dev)
+{
+  size_t  offset;
+  uint8_t status;
+  int     ret;
+
+  if (!dev->cpvalid)
+    {
+      return false;
+    }
+
+  dev->cpvalid = false;
+
+#if CONFIG_SMARTFS_ERASEDSTATE == 0xFF
+  status = (uint8_t) ~(SMART_STATUS_COMMITTED | SMART_STATUS_RELEASED);
+#else
+  status = SMART_STATUS_COMMITTED | SMART_STATUS_RELEASED;
+#endif
+
+  offset = (size_t) dev->neraseblocks * dev->sectorsPerBlk *
+           dev->mtdBlksPerSector * dev->geo.blocksize +
+           offsetof(struct smart_cp_header_s, status);
+  ret = smart_bytewrite(dev, offset, 1, &status);
+  if (ret != 1)
+    {
+      fdbg("Error %d releasing checkpoint\n", -ret);
+    }
+
+  return true;
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_eraseblock
+ *
+ * Description: Erases one erase block and updates the erase statistics.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_WRITABLE
+static int smart_eraseblock(FAR struct smart_struct_s *dev, uint16_t block)
+{
+  int ret;
+#ifdef SMART_HAVE_ERASECOUNTS
+  uint8_t minerase;
+  int     x;
+#endif
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  smart_cpinvalidate(dev);
+#endif
+
+  ret = MTD_ERASE(dev->mtd, block, 1);
+  if (ret < 0)
+    {
+      fdbg("Error %d erasing block %d\n", -ret, block);
+      return ret;
+    }
+
+  dev->blockerases++;
+
+#ifdef SMART_HAVE_ERASECOUNTS
+  /* The erase counts are relative.  When one is about to overflow, age all
+   * of them by the smallest count so that only the differences remain.
+   */
+
+  if (dev->erasecounts[block] == 0xFF)
+    {
+      minerase = 0xFF;
+      for (x = 0; x < dev->neraseblocks; x++)
+        {
+          if (dev->erasecounts[x] < minerase)
+            {
+              minerase = dev->erasecounts[x];
+            }
+        }
+
+      for (x = 0; x < dev->neraseblocks; x++)
+        {
+          dev->erasecounts[x] -= minerase;
+        }
+    }
+
+  if (dev->erasecounts[block] < 0xFF)
+    {
+      dev->erasecounts[block]++;
+    }
+#endif
+
+  return OK;
+}
+#endif /* CONFIG_FS_WRITABLE */
+
+/****************************************************************************
+ * Name: smart_cpwrite
+ *
+ * Description: Saves the sector map and the per erase block counts to the
+ *              reserved erase blocks so that the next mount does not need
+ *              to scan the whole device.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_MTD_SMART_CHECKPOINT) && defined(CONFIG_FS_WRITABLE)
+static int smart_cpwrite(FAR struct smart_struct_s *dev)
+{
+  struct smart_cp_header_s header;
+  FAR const uint8_t *data;
+  size_t    datalen;
+  size_t    offset;
+  size_t    nbytes;
+  off_t     mtdblock;
+  uint8_t   status;
+  int       ret;
+
+  if (dev->cpblocks == 0 || dev->cpvalid ||
+      dev->formatstatus != SMART_FMT_STAT_FORMATTED)
+    {
+      return OK;
+    }
+
+  /* The map and the counts were allocated as one contiguous region */
+
+  data    = (FAR const uint8_t *) dev->sMap;
+  datalen = dev->totalsectors * sizeof(uint16_t) + (dev->neraseblocks << 1);
+#ifdef SMART_HAVE_ERASECOUNTS
+  datalen += dev->neraseblocks;
+#endif
+
+  ret = MTD_ERASE(dev->mtd, dev->neraseblocks, dev->cpblocks);
+  if (ret < 0)
+    {
+      fdbg("Error %d erasing checkpoint\n", -ret);
+      return ret;
+    }
+
+  /* Build the header.  It is written uncommitted and committed once all of
+   * the data is on the FLASH.
+   */
+
+  memset(&header, 0, sizeof(header));
+  header.status        = CONFIG_SMARTFS_ERASEDSTATE;
+  header.version       = SMART_CP_VERSION;
+  header.sig[0]        = SMART_CP_SIG1;
+  header.sig[1]        = SMART_CP_SIG2;
+  header.formatversion = dev->formatversion;
+  header.namesize      = dev->namesize;
+  header.sectorsize    = dev->sectorsize;
+  header.totalsectors  = dev->totalsectors;
+  header.neraseblocks  = dev->neraseblocks;
+  header.freesectors   = dev->freesectors;
+  header.blockerases   = dev->blockerases;
+  header.crc           = crc32(data, datalen);
+
+  /* Stream the header and the data out one sector at a time */
+
+  memcpy(dev->rwbuffer, &header, sizeof(header));
+  offset   = sizeof(header);
+  mtdblock = dev->neraseblocks * dev->sectorsPerBlk * dev->mtdBlksPerSector;
+
+  while (datalen > 0 || offset > 0)
+    {
+      nbytes = dev->sectorsize - offset;
+      if (nbytes > datalen)
+        {
+          nbytes = datalen;
+        }
+
+      memcpy(&dev->rwbuffer[offset], data, nbytes);
+      memset(&dev->rwbuffer[offset + nbytes], CONFIG_SMARTFS_ERASEDSTATE,
+             dev->sectorsize - offset - nbytes);
+
+      ret = MTD_BWRITE(dev->mtd, mtdblock, dev->mtdBlksPerSector,
+                       (uint8_t *) dev->rwbuffer);
+      if (ret != dev->mtdBlksPerSector)
+        {
+          fdbg("Error writing checkpoint block %d\n", mtdblock);
+          return -EIO;
+        }
+
+      data     += nbytes;
+      datalen  -= nbytes;
+      mtdblock += dev->mtdBlksPerSector;
+      offset    = 0;
+    }
+
+  /* Now commit the checkpoint */
+
+#if CONFIG_SMARTFS_ERASEDSTATE == 0xFF
+  status = (uint8_t) ~SMART_STATUS_COMMITTED;
+#else
+  status = SMART_STATUS_COMMITTED;
+#endif
+
+  offset = (size_t) dev->neraseblocks * dev->sectorsPerBlk *
+           dev->mtdBlksPerSector * dev->geo.blocksize +
+           offsetof(struct smart_cp_header_s, status);
+  ret = smart_bytewrite(dev, offset, 1, &status);
+  if (ret != 1)
+    {
+      fdbg("Error %d committing checkpoint\n", -ret);
+      return ret < 0 ? ret : -EIO;
+    }
+
+  dev->cpvalid = true;
+  return OK;
+}
+#endif /* CONFIG_MTD_SMART_CHECKPOINT && CONFIG_FS_WRITABLE */
+
+/****************************************************************************
+ * Name: smart_cpload
+ *
+ * Description: Restores the sector map and the per erase block counts from
+ *              a committed and unreleased checkpoint.  Returns OK if the
+ *              device scan can be skipped.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static int smart_cpload(FAR struct smart_struct_s *dev)
+{
+  struct smart_cp_header_s header;
+  size_t    address;
+  size_t    datalen;
+  int       ret;
+
+  if (dev->cpblocks == 0)
+    {
+      return -ENOENT;
+    }
+
+  address = (size_t) dev->neraseblocks * dev->sectorsPerBlk *
+            dev->mtdBlksPerSector * dev->geo.blocksize;
+  ret = MTD_READ(dev->mtd, address, sizeof(header), (uint8_t *) &header);
+  if (ret != sizeof(header))
+    {
+      return -EIO;
+    }
+
+  if ((header.status & SMART_STATUS_COMMITTED) ==
+      (CONFIG_SMARTFS_ERASEDSTATE & SMART_STATUS_COMMITTED) ||
+      (header.status & SMART_STATUS_RELEASED) !=
+      (CONFIG_SMARTFS_ERASEDSTATE & SMART_STATUS_RELEASED) ||
+      header.sig[0] != SMART_CP_SIG1 || header.sig[1] != SMART_CP_SIG2 ||
+      header.version != SMART_CP_VERSION ||
+      header.sectorsize != dev->sectorsize ||
+      header.totalsectors != dev->totalsectors ||
+      header.neraseblocks != dev->neraseblocks)
+    {
+      /* No usable checkpoint */
+
+      return -ENOENT;
+    }
+
+  datalen = dev->totalsectors * sizeof(uint16_t) + (dev->neraseblocks << 1);
+#ifdef SMART_HAVE_ERASECOUNTS
+  datalen += dev->neraseblocks;
+#endif
+
+  ret = MTD_READ(dev->mtd, address + sizeof(header), datalen,
+                 (uint8_t *) dev->sMap);
+  if (ret != datalen ||
+      crc32((FAR const uint8_t *) dev->sMap, datalen) != header.crc)
+    {
+      fdbg("Bad SMART checkpoint\n");
+      return -EIO;
+    }
+
+  dev->formatstatus  = SMART_FMT_STAT_FORMATTED;
+  dev->formatversion = header.formatversion;
+  dev->namesize      = header.namesize;
+  dev->freesectors   = header.freesectors;
+  dev->blockerases   = header.blockerases;
+  dev->cpvalid       = true;
+  return OK;
+}
+#endif /* CONFIG_MTD_SMART_CHECKPOINT */
+
 /****************************************************************************
  * Name: smart_scan
  *
@@ -633,7 +1326,9 @@ static int smart_scan(struct smart_struct_s *dev)
   uint16_t  logicalsector;
   uint16_t  seq1;
   uint16_t  seq2;
+  uint16_t  prevsector;
   size_t    readaddress;
+  uint32_t  start;
   struct    smart_sect_header_s header;
 #ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
   int       x;
@@ -642,6 +1337,7 @@ static int smart_scan(struct smart_struct_s *dev)
 #endif
 
   fvdbg("Entry\n");
+  start = clock_systimer();
 
   /* Read the 1st header from the device.  We always keep the
    * 1st sector's header's sectorsize field accurate, even
@@ -671,6 +1367,18 @@ static int smart_scan(struct smart_struct_s *dev)
       goto err_out;
     }
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  /* If the device was cleanly closed, restore the RAM state from the
+   * checkpoint instead of reading every sector header.
+   */
+
+  if (smart_cpload(dev) == OK)
+    {
+      dev->mapsource = SMART_MAPSRC_CHECKPOINT;
+      goto scan_done;
+    }
+#endif
+
   /* Initialize the device variables */
 
   totalsectors = dev->neraseblocks * dev->sectorsPerBlk;
@@ -687,10 +1395,7 @@ static int smart_scan(struct smart_struct_s *dev)
 
   /* Initialize the sector map */
 
-  for (sector = 0; sector < totalsectors; sector++)
-    {
-      dev->sMap[sector] = -1;
-    }
+  smart_clearmap(dev);
 
   /* Now scan the MTD device */
 
@@ -845,9 +1550,21 @@ static int smart_scan(struct smart_struct_s *dev)
 #endif
         }
 
-      /* Test for duplicate logical sectors on the device */
+      /* Test for duplicate logical sectors on the device.  When only a
+       * cache of the map is kept, search just the sectors scanned so far.
+       */
+
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+      prevsector = 0xFFFF;
+      if (dev->sBitMap[logicalsector >> 3] & (1 << (logicalsector & 7)))
+        {
+          prevsector = smart_cache_lookup(dev, logicalsector, sector);
+        }
+#else
+      prevsector = dev->sMap[logicalsector];
+#endif
 
-      if (dev->sMap[logicalsector] != 0xFFFF)
+      if (prevsector != 0xFFFF)
         {
           /* Uh-oh, we found more than 1 physical sector claiming to be
            * the * same logical sector.  Use the sequence number information
@@ -860,7 +1577,7 @@ static int smart_scan(struct smart_struct_s *dev)
 
           /* We must re-read the 1st physical sector to get it's seq number */
 
-          readaddress = dev->sMap[logicalsector]  * dev->mtdBlksPerSector * dev->geo.blocksize;
+          readaddress = prevsector * dev->mtdBlksPerSector * dev->geo.blocksize;
           ret = MTD_READ(dev->mtd, readaddress, sizeof(struct smart_sect_header_s),
                   (uint8_t *) &header);
           if (ret != sizeof(struct smart_sect_header_s))
@@ -876,15 +1593,13 @@ static int smart_scan(struct smart_struct_s *dev)
             {
               /* Seq 2 is the winner ... we assume it wrapped */
 
-              loser = dev->sMap[logicalsector];
-              dev->sMap[logicalsector] = sector;
+              loser = prevsector;
             }
           else if (seq2 > seq1)
             {
               /* Seq 2 is bigger, so it's the winner */
 
-              loser = dev->sMap[logicalsector];
-              dev->sMap[logicalsector] = sector;
+              loser = prevsector;
             }
           else
             {
@@ -915,18 +1630,36 @@ static int smart_scan(struct smart_struct_s *dev)
               fdbg("Error %d releasing duplicate sector\n", -ret);
               goto err_out;
             }
+
+          if (loser == sector)
+            {
+              /* The released sector now counts as released */
+
+              dev->releasecount[sector / dev->sectorsPerBlk]++;
+              continue;
+            }
+
+          dev->releasecount[prevsector / dev->sectorsPerBlk]++;
         }
 
       /* Update the logical to physical sector map */
 
-      dev->sMap[logicalsector] = sector;
+      smart_setmap(dev, logicalsector, sector);
     }
 
+  dev->mapsource = SMART_MAPSRC_SCAN;
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+scan_done:
+#endif
+  dev->scantime = TICK2MSEC(clock_systimer() - start);
+
   fdbg("SMART Scan\n");
   fdbg("   Erase size:   %10d\n", dev->sectorsPerBlk * dev->sectorsize);
   fdbg("   Erase count:  %10d\n", dev->neraseblocks);
   fdbg("   Sect/block:   %10d\n", dev->sectorsPerBlk);
   fdbg("   MTD Blk/Sect: %10d\n", dev->mtdBlksPerSector);
+  fdbg("   Scan time:    %10d ms\n", dev->scantime);
 
   ret = OK;
 
@@ -1026,7 +1759,6 @@ static inline int smart_llformat(struct smart_struct_s *dev, unsigned long arg)
 {
   struct    smart_sect_header_s  *sectorheader;
   size_t    wrcount;
-  size_t    totalsectors;
   int       x;
   int       ret;
   uint8_t   sectsize;
@@ -1115,17 +1847,11 @@ static inline int smart_llformat(struct smart_struct_s *dev, unsigned long arg)
 
   dev->freecount[0]--;
 
-  /* Now initialize the logical to physical sector map */
-
-  dev->sMap[0] = 0;     /* Logical sector zero = physical sector 0 */
+  /* Now initialize the logical to physical sector map.  All other logical
+   * sectors were marked as non-existant by smart_setsectorsize().
+   */
 
-  totalsectors = dev->neraseblocks * dev->sectorsPerBlk;
-  for (x = 1; x < totalsectors; x++)
-    {
-      /* Mark all other logical sectors as non-existant */
-
-      dev->sMap[x] = -1;
-    }
+  smart_setmap(dev, 0, 0);  /* Logical sector zero = physical sector 0 */
 
 #ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
 
@@ -1142,6 +1868,35 @@ static inline int smart_llformat(struct smart_struct_s *dev, unsigned long arg)
 }
 #endif /* CONFIG_FS_WRITABLE */
 
+/****************************************************************************
+ * Name: smart_sectorisfree
+ *
+ * Description:  Checks if a physical sector is still in the erased state.
+ *               Returns 1 if it is, 0 if it is not, or a negated errno.
+ *
+ ****************************************************************************/
+
+static int smart_sectorisfree(struct smart_struct_s *dev, uint16_t sector)
+{
+  struct    smart_sect_header_s header;
+  uint32_t  readaddr;
+  int       ret;
+
+  readaddr = sector * dev->mtdBlksPerSector * dev->geo.blocksize;
+  ret = MTD_READ(dev->mtd, readaddr, sizeof(struct smart_sect_header_s),
+          (uint8_t *) &header);
+  if (ret != sizeof(struct smart_sect_header_s))
+    {
+      fvdbg("Error reading phys sector %d\n", sector);
+      return -EIO;
+    }
+
+  return (*((uint16_t *) header.logicalsector) == 0xFFFF) &&
+         (*((uint16_t *) header.seq) == 0xFFFF) &&
+         ((header.status & SMART_STATUS_COMMITTED) ==
+          (CONFIG_SMARTFS_ERASEDSTATE & SMART_STATUS_COMMITTED));
+}
+
 /****************************************************************************
  * Name: smart_findfreephyssector
  *
@@ -1155,14 +1910,16 @@ static int smart_findfreephyssector(struct smart_struct_s *dev)
   uint16_t  allocfreecount;
   uint16_t  allocblock;
   uint16_t  physicalsector;
+  uint16_t  first;
+  uint16_t  hint;
   uint16_t  x;
-  uint32_t  readaddr;
-  struct    smart_sect_header_s header;
   int       ret;
 
   /* Determine which erase block we should allocate the new
    * sector from. This is based on the number of free sectors
-   * available in each erase block. */
+   * available in each erase block.  With wear leveling, the least
+   * worn erase block that has free sectors is used instead so that
+   * new data lands on the blocks that have been erased the least. */
 
   allocfreecount = 0;
   allocblock = 0xFFFF;
@@ -1172,7 +1929,19 @@ static int smart_findfreephyssector(struct smart_struct_s *dev)
       /* Test if this block has more free blocks than the
        * currently selected block */
 
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+      if (dev->freecount[x] == 0)
+        {
+          continue;
+        }
+
+      if (allocblock == 0xFFFF ||
+          dev->erasecounts[x] < dev->erasecounts[allocblock] ||
+          (dev->erasecounts[x] == dev->erasecounts[allocblock] &&
+           dev->freecount[x] > allocfreecount))
+#else
       if (dev->freecount[x] > allocfreecount)
+#endif
         {
           /* Assign this block to alloc from */
 
@@ -1189,30 +1958,32 @@ static int smart_findfreephyssector(struct smart_struct_s *dev)
       return -EIO;
     }
 
-  /* Now find a free physical sector within this selected
-   * erase block to allocate. */
+  /* Now find a free physical sector within this selected erase block to
+   * allocate.  Sectors are handed out in order within an erase block, so
+   * the free sectors are normally the last 'freecount' sectors of the
+   * block.  Check that sector first and only search the whole block if
+   * it is not really free (e.g. after an interrupted write).
+   */
 
-  for (x = allocblock * dev->sectorsPerBlk;
-          x < (allocblock+1) * dev->sectorsPerBlk; x++)
-    {
-      /* Check if this physical sector is available */
+  first = allocblock * dev->sectorsPerBlk;
+  hint  = first + dev->sectorsPerBlk - allocfreecount;
 
-      readaddr = x * dev->mtdBlksPerSector * dev->geo.blocksize;
-      ret = MTD_READ(dev->mtd, readaddr, sizeof(struct smart_sect_header_s),
-              (uint8_t *) &header);
-      if (ret != sizeof(struct smart_sect_header_s))
-        {
-          fvdbg("Error reading phys sector %d\n", physicalsector);
-          return -EIO;
-        }
+  ret = smart_sectorisfree(dev, hint);
+  if (ret > 0)
+    {
+      return hint;
+    }
 
-      if ((*((uint16_t *) header.logicalsector) == 0xFFFF) &&
-          (*((uint16_t *) header.seq) == 0xFFFF) &&
-          ((header.status & SMART_STATUS_COMMITTED) ==
-           (CONFIG_SMARTFS_ERASEDSTATE & SMART_STATUS_COMMITTED)))
+  for (x = first; ret >= 0 && x < first + dev->sectorsPerBlk; x++)
+    {
+      if (x != hint)
         {
-          physicalsector = x;
-          break;
+          ret = smart_sectorisfree(dev, x);
+          if (ret > 0)
+            {
+              physicalsector = x;
+              break;
+            }
         }
     }
 
@@ -1240,6 +2011,8 @@ static int smart_garbagecollect(struct smart_struct_s *dev)
   int       ret;
   size_t    offset;
   struct    smart_sect_header_s *header;
+  uint16_t  logicalsector;
+  uint8_t   status;
   uint8_t   newstatus;
 
   while (collect)
@@ -1259,6 +2032,17 @@ static int smart_garbagecollect(struct smart_struct_s *dev)
               releasemax = dev->releasecount[x];
               collectblock = x;
             }
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+
+          /* Of equally good candidates, collect the least worn block */
+
+          else if (dev->releasecount[x] != 0 &&
+                   dev->releasecount[x] == releasemax &&
+                   dev->erasecounts[x] < dev->erasecounts[collectblock])
+            {
+              collectblock = x;
+            }
+#endif
         }
 
       /* Test if the released sectors count is greater than the
@@ -1289,10 +2073,10 @@ static int smart_garbagecollect(struct smart_struct_s *dev)
               collectblock, dev->freecount[collectblock],
               dev->releasecount[collectblock]);
 
-          if (dev->freecount[collectblock] == 6)
-            {
-              fdbg("here!\n");
-            }
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+          smart_cpinvalidate(dev);
+#endif
+          dev->gccount++;
 
           /* Perform collection on block with the most released sectors.
            * First mark the block as having no free sectors so we don't
@@ -1344,8 +2128,12 @@ static int smart_garbagecollect(struct smart_struct_s *dev)
                   goto errout;
                 }
 
-              /* Increment the sequence number and clear the "commit" flag */
+              /* Increment the sequence number and clear the "commit" flag.
+               * Save the logical sector and status first:  the rwbuffer
+               * may be reused by smart_bytewrite() below.
+               */
 
+              logicalsector = *((uint16_t *) header->logicalsector);
               (*((uint16_t *) header->seq))++;
               if (*((uint16_t *) header->seq) == 0xFFFF)
                 {
@@ -1356,6 +2144,7 @@ static int smart_garbagecollect(struct smart_struct_s *dev)
 #else
               header->status &= ~SMART_STATUS_COMMITTED;
 #endif
+              status = header->status;
 
               /* Write the data to the new physical sector location */
 
@@ -1367,9 +2156,9 @@ static int smart_garbagecollect(struct smart_struct_s *dev)
               offset = newsector * dev->mtdBlksPerSector * dev->geo.blocksize +
                   offsetof(struct smart_sect_header_s, status);
 #if CONFIG_SMARTFS_ERASEDSTATE == 0xFF
-              newstatus = header->status & ~SMART_STATUS_COMMITTED;
+              newstatus = status & ~SMART_STATUS_COMMITTED;
 #else
-              newstatus = header->status | SMART_STATUS_COMMITTED;
+              newstatus = status | SMART_STATUS_COMMITTED;
 #endif
               ret = smart_bytewrite(dev, offset, 1, &newstatus);
               if (ret < 0)
@@ -1381,9 +2170,9 @@ static int smart_garbagecollect(struct smart_struct_s *dev)
               /* Release the old physical sector */
 
 #if CONFIG_SMARTFS_ERASEDSTATE == 0xFF
-              newstatus = header->status & ~SMART_STATUS_RELEASED;
+              newstatus = status & ~SMART_STATUS_RELEASED;
 #else
-              newstatus = header->status | SMART_STATUS_RELEASED;
+              newstatus = status | SMART_STATUS_RELEASED;
 #endif
               offset = x * dev->mtdBlksPerSector * dev->geo.blocksize +
                   offsetof(struct smart_sect_header_s, status);
@@ -1396,13 +2185,14 @@ static int smart_garbagecollect(struct smart_struct_s *dev)
 
               /* Update the variables */
 
-              dev->sMap[*((uint16_t *) header->logicalsector)] = newsector;
+              smart_setmap(dev, logicalsector, newsector);
               dev->freecount[newsector / dev->sectorsPerBlk]--;
+              dev->gcrelocs++;
             }
 
           /* Now erase the erase block */
 
-          MTD_ERASE(dev->mtd, collectblock, 1);
+          smart_eraseblock(dev, collectblock);
 
           dev->freesectors += dev->releasecount[collectblock];
           dev->freecount[collectblock] = dev->sectorsPerBlk;
@@ -1466,6 +2256,7 @@ static inline int smart_writesector(struct smart_struct_s *dev, unsigned long ar
   bool      needsrelocate = FALSE;
   uint32_t  mtdblock;
   uint16_t  physsector;
+  uint16_t  oldsector;
   struct    smart_read_write_s *req;
   struct    smart_sect_header_s *header;
   size_t    offset;
@@ -1486,7 +2277,7 @@ static inline int smart_writesector(struct smart_struct_s *dev, unsigned long ar
       goto errout;
     }
 
-  physsector = dev->sMap[req->logsector];
+  physsector = smart_getmap(dev, req->logsector);
   if (physsector == 0xFFFF)
     {
       fdbg("Logical sector %d not allocated\n", req->logsector);
@@ -1494,6 +2285,8 @@ static inline int smart_writesector(struct smart_struct_s *dev, unsigned long ar
       goto errout;
     }
 
+  oldsector = physsector;
+
   /* Read the sector data into our buffer */
 
   mtdblock = physsector * dev->mtdBlksPerSector;
@@ -1530,6 +2323,24 @@ static inline int smart_writesector(struct smart_struct_s *dev, unsigned long ar
 
   if (needsrelocate)
     {
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+      /* The sector map is about to change.  Releasing the checkpoint may
+       * have reused the rwbuffer, so read the sector again in that case.
+       */
+
+      if (smart_cpinvalidate(dev))
+        {
+          ret = MTD_BREAD(dev->mtd, mtdblock, dev->mtdBlksPerSector,
+                          (uint8_t *) dev->rwbuffer);
+          if (ret != dev->mtdBlksPerSector)
+            {
+              fdbg("Error reading phys sector %d\n", physsector);
+              ret = -EIO;
+              goto errout;
+            }
+        }
+#endif
+
       /* Find a new physical sector to save data to */
 
       physsector = smart_findfreephyssector(dev);
@@ -1602,13 +2413,13 @@ static inline int smart_writesector(struct smart_struct_s *dev, unsigned long ar
       /* Update releasecount for released sector and freecount for the
        * newly allocated physical sector. */
 
-      dev->releasecount[dev->sMap[req->logsector] / dev->sectorsPerBlk]++;
+      dev->releasecount[oldsector / dev->sectorsPerBlk]++;
       dev->freecount[physsector / dev->sectorsPerBlk]--;
       dev->freesectors--;
 
       /* Update the sector map */
 
-      dev->sMap[req->logsector] = physsector;
+      smart_setmap(dev, req->logsector, physsector);
 
       /* Since we performed a relocation, do garbage collection to
        * ensure we don't fill up our flash with released blocks.
@@ -1664,7 +2475,7 @@ static inline int smart_readsector(struct smart_struct_s *dev, unsigned long arg
       goto errout;
     }
 
-  physsector = dev->sMap[req->logsector];
+  physsector = smart_getmap(dev, req->logsector);
   if (physsector == 0xFFFF)
     {
       fdbg("Logical sector %d not allocated\n", req->logsector);
@@ -1764,7 +2575,7 @@ static inline int smart_allocsector(struct smart_struct_s *dev, unsigned long re
     {
       /* Validate the sector is not already allocated */
 
-      if (dev->sMap[requested] == (uint16_t) -1)
+      if (smart_getmap(dev, requested) == 0xFFFF)
         {
           logsector = requested;
         }
@@ -1778,7 +2589,11 @@ static inline int smart_allocsector(struct smart_struct_s *dev, unsigned long re
 
       for (x = SMART_FIRST_ALLOC_SECTOR; x < dev->totalsectors; x++)
         {
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+          if ((dev->sBitMap[x >> 3] & (1 << (x & 7))) == 0)
+#else
           if (dev->sMap[x] == (uint16_t) -1)
+#endif
             {
               /* Unused logical sector found.  Use this one */
 
@@ -1810,6 +2625,10 @@ static inline int smart_allocsector(struct smart_struct_s *dev, unsigned long re
    * released sectors into blocks with free sectors, then
    * erasing the vacated block. */
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  smart_cpinvalidate(dev);
+#endif
+
   smart_garbagecollect(dev);
 
   /* Find a free physical sector */
@@ -1853,7 +2672,7 @@ static inline int smart_allocsector(struct smart_struct_s *dev, unsigned long re
 
   /* Map the sector and update the free sector counts */
 
-  dev->sMap[logsector] = physicalsector;
+  smart_setmap(dev, logsector, physicalsector);
   dev->freecount[physicalsector / dev->sectorsPerBlk]--;
   dev->freesectors--;
 
@@ -1889,7 +2708,7 @@ static inline int smart_freesector(struct smart_struct_s *dev, unsigned long
     {
       /* Validate the sector is actually allocated */
 
-      if (dev->sMap[logicalsector] == (uint16_t) -1)
+      if (smart_getmap(dev, logicalsector) == 0xFFFF)
         {
           fdbg("Invalid release - sector %d not allocated\n", logicalsector);
           ret = -EINVAL;
@@ -1899,7 +2718,11 @@ static inline int smart_freesector(struct smart_struct_s *dev, unsigned long
 
   /* Okay to release the sector.  Read the sector header info */
 
-  physsector = dev->sMap[logicalsector];
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  smart_cpinvalidate(dev);
+#endif
+
+  physsector = smart_getmap(dev, logicalsector);
   readaddr = physsector * dev->mtdBlksPerSector * dev->geo.blocksize;
   ret = MTD_READ(dev->mtd, readaddr, sizeof(struct smart_sect_header_s),
                  (uint8_t *) &header);
@@ -1944,7 +2767,7 @@ static inline int smart_freesector(struct smart_struct_s *dev, unsigned long
 
   /* Unmap this logical sector */
 
-  dev->sMap[logicalsector] = (uint16_t) -1;
+  smart_setmap(dev, logicalsector, 0xFFFF);
 
   /* If this block has only released blocks, then erase it */
 
@@ -1952,7 +2775,7 @@ static inline int smart_freesector(struct smart_struct_s *dev, unsigned long
     {
       /* Erase the block */
 
-      MTD_ERASE(dev->mtd, block, 1);
+      smart_eraseblock(dev, block);
 
       dev->freesectors += dev->releasecount[block];
       dev->releasecount[block] = 0;
@@ -2080,8 +2903,12 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
       procfs_data->namelen = dev->namesize;
       procfs_data->formatversion = dev->formatversion;
       procfs_data->unusedsectors = 0;
-      procfs_data->blockerases = 0;
+      procfs_data->blockerases = dev->blockerases;
       procfs_data->sectorsperblk = dev->sectorsPerBlk;
+      procfs_data->gccount = dev->gccount;
+      procfs_data->gcrelocs = dev->gcrelocs;
+      procfs_data->scantime = dev->scantime;
+      procfs_data->mapsource = dev->mapsource;
 
 #ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
       procfs_data->formatsector = dev->sMap[0];
@@ -2089,7 +2916,7 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 #endif
 
 #ifdef CONFIG_MTD_SMART_SECTOR_ERASE_DEBUG
-      procfs_data->neraseblocks = dev->geo.neraseblocks;
+      procfs_data->neraseblocks = dev->neraseblocks;
       procfs_data->erasecounts = dev->erasecounts;
 #endif
 #ifdef CONFIG_MTD_SMART_ALLOC_DEBUG
@@ -2153,7 +2980,7 @@ int smart_initialize(int minor, FAR struct mtd_dev_s *mtd, const char *partname)
 
   /* Allocate a SMART device structure */
 
-  dev = (struct smart_struct_s *)kmm_malloc(sizeof(struct smart_struct_s));
+  dev = (struct smart_struct_s *)kmm_zalloc(sizeof(struct smart_struct_s));
   if (dev)
     {
       /* Initialize the SMART device structure */
@@ -2177,7 +3004,12 @@ int smart_initialize(int minor, FAR struct mtd_dev_s *mtd, const char *partname)
 
       /* Set the sector size to the default for now */
 
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+      dev->sBitMap = NULL;
+      dev->sCache = NULL;
+#else
       dev->sMap = NULL;
+#endif
       dev->rwbuffer = NULL;
       ret = smart_setsectorsize(dev, CONFIG_MTD_SMART_SECTOR_SIZE);
       if (ret != OK)
@@ -2236,7 +3068,12 @@ int smart_initialize(int minor, FAR struct mtd_dev_s *mtd, const char *partname)
       if (rootdirdev == NULL)
         {
           fdbg("register_blockdriver failed: %d\n", -ret);
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+          kmm_free(dev->sBitMap);
+          kmm_free(dev->sCache);
+#else
           kmm_free(dev->sMap);
+#endif
           kmm_free(dev->rwbuffer);
           kmm_free(dev);
           ret = -ENOMEM;
@@ -2267,7 +3104,12 @@ int smart_initialize(int minor, FAR struct mtd_dev_s *mtd, const char *partname)
       if (ret < 0)
         {
           fdbg("register_blockdriver failed: %d\n", -ret);
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+          kmm_free(dev->sBitMap);
+          kmm_free(dev->sCache);
+#else
           kmm_free(dev->sMap);
+#endif
           kmm_free(dev->rwbuffer);
           kmm_free(dev);
           goto errout;
@@ -54,6 +54,7 @@
 
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #if CONFIG_DEBUG
 #  include <nuttx/arch.h>
 #endif
@@ -76,6 +77,14 @@
 #  define pipe_dumpbuffer(m,a,n)
 #endif
 
+/* A waiting writer that needs more space than this is woken up when this
+ * much space is free in the pipe buffer.  This avoids a context switch for
+ * every read when the reader consumes data in small pieces.  A writer that
+ * needs less space is woken up as soon as its data fits.
+ */
+
+#define PIPE_WRWATERMARK(dev) ((dev)->d_bufsize >> 1)
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -137,6 +146,113 @@ static void pipecommon_pollnotify(FAR struct pipe_dev_s *dev, pollevent_t events
 #  define pipecommon_pollnotify(dev,event)
 #endif
 
+/****************************************************************************
+ * Name: pipecommon_nbytes
+ *
+ * Description:
+ *   Return the number of bytes in the pipe buffer
+ *
+ ****************************************************************************/
+
+static inline size_t pipecommon_nbytes(FAR struct pipe_dev_s *dev)
+{
+  if (dev->d_wrndx >= dev->d_rdndx)
+    {
+      return dev->d_wrndx - dev->d_rdndx;
+    }
+  else
+    {
+      return dev->d_bufsize + dev->d_wrndx - dev->d_rdndx;
+    }
+}
+
+/****************************************************************************
+ * Name: pipecommon_wakeup
+ *
+ * Description:
+ *   Wake up all threads waiting on a semaphore
+ *
+ ****************************************************************************/
+
+static void pipecommon_wakeup(FAR sem_t *sem)
+{
+  int sval;
+
+  while (sem_getvalue(sem, &sval) == 0 && sval < 0)
+    {
+      sem_post(sem);
+    }
+}
+
+/****************************************************************************
+ * Name: pipecommon_resize
+ *
+ * Description:
+ *   Change the size of the pipe buffer, preserving any buffered data.
+ *   Called with d_bfsem held.
+ *
+ ****************************************************************************/
+
+static int pipecommon_resize(FAR struct pipe_dev_s *dev, size_t size)
+{
+  FAR uint8_t *buffer;
+  size_t nbytes;
+  size_t first;
+
+  if (size < 2 || size > CONFIG_DEV_PIPE_MAXSIZE)
+    {
+      return -EINVAL;
+    }
+
+  /* If the buffer has not been allocated yet, just remember the size */
+
+  if (!dev->d_buffer)
+    {
+      dev->d_bufsize = size;
+      return OK;
+    }
+
+  /* The buffered data must fit into the new buffer */
+
+  nbytes = pipecommon_nbytes(dev);
+  if (nbytes >= size)
+    {
+      return -EBUSY;
+    }
+
+  buffer = (FAR uint8_t *)kmm_malloc(size);
+  if (!buffer)
+    {
+      return -ENOMEM;
+    }
+
+  /* Copy the buffered data to the beginning of the new buffer */
+
+  first = dev->d_bufsize - dev->d_rdndx;
+  if (first >= nbytes)
+    {
+      memcpy(buffer, &dev->d_buffer[dev->d_rdndx], nbytes);
+    }
+  else
+    {
+      memcpy(buffer, &dev->d_buffer[dev->d_rdndx], first);
+      memcpy(&buffer[first], dev->d_buffer, nbytes - first);
+    }
+
+  kmm_free(dev->d_buffer);
+  dev->d_buffer  = buffer;
+  dev->d_bufsize = size;
+  dev->d_rdndx   = 0;
+  dev->d_wrndx   = nbytes;
+
+  /* There may be more space for any waiting writers */
+
+  dev->d_wrneed  = 0;
+  pipecommon_wakeup(&dev->d_wrsem);
+  pipecommon_pollnotify(dev, POLLOUT);
+  return OK;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -157,6 +273,7 @@ FAR struct pipe_dev_s *pipecommon_allocdev(void)
       /* Initialize the private structure */
 
       memset(dev, 0, sizeof(struct pipe_dev_s));
+      dev->d_bufsize = CONFIG_DEV_PIPE_SIZE;
       sem_init(&dev->d_bfsem, 0, 1);
       sem_init(&dev->d_rdsem, 0, 0);
       sem_init(&dev->d_wrsem, 0, 0);
@@ -212,7 +329,7 @@ int pipecommon_open(FAR struct file *filep)
 
   if (dev->d_refs == 0)
     {
-      dev->d_buffer = (uint8_t*)kmm_malloc(CONFIG_DEV_PIPE_SIZE);
+      dev->d_buffer = (uint8_t*)kmm_malloc(dev->d_bufsize);
       if (!dev->d_buffer)
         {
           (void)sem_post(&dev->d_bfsem);
@@ -340,6 +457,8 @@ int pipecommon_close(FAR struct file *filep)
 
       dev->d_wrndx    = 0;
       dev->d_rdndx    = 0;
+      dev->d_bufsize  = CONFIG_DEV_PIPE_SIZE;
+      dev->d_wrneed   = 0;
       dev->d_refs     = 0;
       dev->d_nwriters = 0;
    }
@@ -360,7 +479,9 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
   FAR uint8_t       *start  = (uint8_t*)buffer;
 #endif
   ssize_t            nread  = 0;
-  int                sval;
+  size_t             nbytes;
+  pipe_ndx_t         rdndx;
+  bool               wasfull;
   int                ret;
 
   /* Some sanity checking */
@@ -411,29 +532,56 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
         }
     }
 
-  /* Then return whatever is available in the pipe (which is at least one byte) */
+  /* Then return whatever is available in the pipe (which is at least one
+   * byte).  The data is copied in at most two contiguous segments.
+   */
+
+  wasfull = (pipecommon_nbytes(dev) >= dev->d_bufsize - 1);
 
   nread = 0;
   while (nread < len && dev->d_wrndx != dev->d_rdndx)
     {
-      *buffer++ = dev->d_buffer[dev->d_rdndx];
-      if (++dev->d_rdndx >= CONFIG_DEV_PIPE_SIZE)
+      rdndx  = dev->d_rdndx;
+      nbytes = (dev->d_wrndx > rdndx ? dev->d_wrndx : dev->d_bufsize) - rdndx;
+      if (nbytes > len - nread)
+        {
+          nbytes = len - nread;
+        }
+
+      memcpy(buffer, &dev->d_buffer[rdndx], nbytes);
+      buffer += nbytes;
+      nread  += nbytes;
+
+      rdndx += nbytes;
+      if (rdndx >= dev->d_bufsize)
         {
-          dev->d_rdndx = 0;
+          rdndx = 0;
         }
-      nread++;
+
+      dev->d_rdndx = rdndx;
     }
 
-  /* Notify all waiting writers that bytes have been removed from the buffer */
+  /* Notify all waiting writers that bytes have been removed from the buffer
+   * if there is now enough space for at least one of them.  d_wrneed is the
+   * smallest of the remaining write sizes of the waiting writers, limited to
+   * the write watermark.
+   */
 
-  while (sem_getvalue(&dev->d_wrsem, &sval) == 0 && sval < 0)
+  if (dev->d_wrneed > 0 &&
+      dev->d_bufsize - 1 - pipecommon_nbytes(dev) >= dev->d_wrneed)
     {
-      sem_post(&dev->d_wrsem);
+      dev->d_wrneed = 0;
+      pipecommon_wakeup(&dev->d_wrsem);
     }
 
-  /* Notify all poll/select waiters that they can write to the FIFO */
+  /* Notify all poll/select waiters that they can write to the FIFO.  POLLOUT
+   * waiters are only waiting if the pipe was full.
+   */
 
-  pipecommon_pollnotify(dev, POLLOUT);
+  if (wasfull)
+    {
+      pipecommon_pollnotify(dev, POLLOUT);
+    }
 
   sem_post(&dev->d_bfsem);
   pipe_dumpbuffer("From PIPE:", start, nread);
@@ -449,9 +597,10 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer, size_t
   struct inode      *inode    = filep->f_inode;
   struct pipe_dev_s *dev      = inode->i_private;
   ssize_t            nwritten = 0;
-  ssize_t            last;
-  int                nxtwrndx;
-  int                sval;
+  size_t             nbytes;
+  pipe_ndx_t         wrndx;
+  pipe_ndx_t         rdndx;
+  bool               wasempty;
 
   /* Some sanity checking */
 
@@ -487,83 +636,167 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer, size_t
 
   /* Loop until all of the bytes have been written */
 
-  last = 0;
   for (;;)
     {
-      /* Calculate the write index AFTER the next byte is written */
+      /* Copy as much as will fit into the circular buffer.  The data is
+       * copied in at most two contiguous segments.  One byte of the buffer
+       * is always left unused to distinguish a full from an empty buffer.
+       */
 
-      nxtwrndx = dev->d_wrndx + 1;
-      if (nxtwrndx >= CONFIG_DEV_PIPE_SIZE)
+      wasempty = (dev->d_wrndx == dev->d_rdndx);
+      while (nwritten < len)
         {
-          nxtwrndx = 0;
-        }
+          wrndx = dev->d_wrndx;
+          rdndx = dev->d_rdndx;
 
-      /* Would the next write overflow the circular buffer? */
+          if (rdndx > wrndx)
+            {
+              nbytes = rdndx - wrndx - 1;
+            }
+          else
+            {
+              nbytes = dev->d_bufsize - wrndx;
+              if (rdndx == 0)
+                {
+                  nbytes--;
+                }
+            }
 
-      if (nxtwrndx != dev->d_rdndx)
-        {
-          /* No... copy the byte */
+          if (nbytes == 0)
+            {
+              break;
+            }
 
-          dev->d_buffer[dev->d_wrndx] = *buffer++;
-          dev->d_wrndx = nxtwrndx;
+          if (nbytes > len - nwritten)
+            {
+              nbytes = len - nwritten;
+            }
 
-          /* Is the write complete? */
+          memcpy(&dev->d_buffer[wrndx], buffer, nbytes);
+          buffer   += nbytes;
+          nwritten += nbytes;
 
-          if (++nwritten >= len)
+          wrndx += nbytes;
+          if (wrndx >= dev->d_bufsize)
             {
-              /* Yes.. Notify all of the waiting readers that more data is available */
+              wrndx = 0;
+            }
 
-              while (sem_getvalue(&dev->d_rdsem, &sval) == 0 && sval < 0)
-                {
-                  sem_post(&dev->d_rdsem);
-                }
+          dev->d_wrndx = wrndx;
+        }
+
+      /* Readers (and POLLIN waiters) only wait on an empty pipe.  Notify
+       * them only if this pass made the pipe non-empty.
+       */
+
+      if (wasempty && dev->d_wrndx != dev->d_rdndx)
+        {
+          pipecommon_wakeup(&dev->d_rdsem);
+          pipecommon_pollnotify(dev, POLLIN);
+        }
 
-              /* Notify all poll/select waiters that they can write to the FIFO */
+      /* Is the write complete? */
 
-              pipecommon_pollnotify(dev, POLLIN);
+      if (nwritten >= len)
+        {
+          /* Return the number of bytes written */
 
-              /* Return the number of bytes written */
+          sem_post(&dev->d_bfsem);
+          return len;
+        }
 
-              sem_post(&dev->d_bfsem);
-              return len;
+      /* If O_NONBLOCK was set, then return partial bytes written or EGAIN */
+
+      if (filep->f_oflags & O_NONBLOCK)
+        {
+          if (nwritten == 0)
+            {
+              nwritten = -EAGAIN;
             }
+
+          sem_post(&dev->d_bfsem);
+          return nwritten;
         }
-      else
+
+      /* There is more to be written.. wait for data to be removed from the
+       * pipe.  Ask to be woken up when the rest of the data fits or, if it
+       * is larger than the write watermark, when that much space is free.
+       */
+
+      nbytes = len - nwritten;
+      if (nbytes > PIPE_WRWATERMARK(dev))
         {
-          /* There is not enough room for the next byte.  Was anything written in this pass? */
+          nbytes = PIPE_WRWATERMARK(dev);
+        }
 
-          if (last < nwritten)
-            {
-              /* Yes.. Notify all of the waiting readers that more data is available */
+      if (dev->d_wrneed == 0 || nbytes < dev->d_wrneed)
+        {
+          dev->d_wrneed = nbytes;
+        }
 
-              while (sem_getvalue(&dev->d_rdsem, &sval) == 0 && sval < 0)
-                {
-                  sem_post(&dev->d_rdsem);
-                }
-            }
-          last = nwritten;
+      sched_lock();
+      sem_post(&dev->d_bfsem);
+      pipecommon_semtake(&dev->d_wrsem);
+      sched_unlock();
+      pipecommon_semtake(&dev->d_bfsem);
+    }
+}
+
+/****************************************************************************
+ * Name: pipecommon_ioctl
+ ****************************************************************************/
+
+int pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
+{
+  FAR struct inode      *inode = filep->f_inode;
+  FAR struct pipe_dev_s *dev   = inode->i_private;
+  int                    ret;
+
+  /* Some sanity checking */
 
-          /* If O_NONBLOCK was set, then return partial bytes written or EGAIN */
+#if CONFIG_DEBUG
+  if (!dev)
+    {
+      return -ENODEV;
+    }
+#endif
+
+  /* Make sure that we have exclusive access to the device structure */
+
+  if (sem_wait(&dev->d_bfsem) < 0)
+    {
+      DEBUGASSERT(get_errno() > 0);
+      return -get_errno();
+    }
 
-          if (filep->f_oflags & O_NONBLOCK)
+  switch (cmd)
+    {
+      case PIPEIOC_GETSIZE:
+        {
+          FAR int *size = (FAR int *)((uintptr_t)arg);
+          if (!size)
             {
-              if (nwritten == 0)
-                {
-                  nwritten = -EAGAIN;
-                }
-              sem_post(&dev->d_bfsem);
-              return nwritten;
+              ret = -EINVAL;
+            }
+          else
+            {
+              *size = dev->d_bufsize;
+              ret   = OK;
             }
+        }
+        break;
 
-          /* There is more to be written.. wait for data to be removed from the pipe */
+      case PIPEIOC_SETSIZE:
+        ret = pipecommon_resize(dev, (size_t)arg);
+        break;
 
-          sched_lock();
-          sem_post(&dev->d_bfsem);
-          pipecommon_semtake(&dev->d_wrsem);
-          sched_unlock();
-          pipecommon_semtake(&dev->d_bfsem);
-        }
+      default:
+        ret = -ENOTTY;
+        break;
     }
+
+  sem_post(&dev->d_bfsem);
+  return ret;
 }
 
 /****************************************************************************
@@ -577,7 +810,7 @@ int pipecommon_poll(FAR struct file *filep, FAR struct pollfd *fds,
   FAR struct inode      *inode    = filep->f_inode;
   FAR struct pipe_dev_s *dev      = inode->i_private;
   pollevent_t            eventset;
-  pipe_ndx_t             nbytes;
+  size_t                 nbytes;
   int                    ret      = OK;
   int                    i;
 
@@ -624,19 +857,12 @@ int pipecommon_poll(FAR struct file *filep, FAR struct pollfd *fds,
        * First, determine how many bytes are in the buffer
        */
 
-      if (dev->d_wrndx >= dev->d_rdndx)
-        {
-          nbytes = dev->d_wrndx - dev->d_rdndx;
-        }
-      else
-        {
-          nbytes = (CONFIG_DEV_PIPE_SIZE-1) + dev->d_wrndx - dev->d_rdndx;
-        }
+      nbytes = pipecommon_nbytes(dev);
 
       /* Notify the POLLOUT event if the pipe is not full */
 
       eventset = 0;
-      if (nbytes < (CONFIG_DEV_PIPE_SIZE-1))
+      if (nbytes < (dev->d_bufsize - 1))
         {
           eventset |= POLLOUT;
         }
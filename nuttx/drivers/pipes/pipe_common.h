@@ -51,6 +51,15 @@
 #  define CONFIG_DEV_PIPE_SIZE 1024
 #endif
 
+#ifndef CONFIG_DEV_PIPE_MAXSIZE
+#  define CONFIG_DEV_PIPE_MAXSIZE 65535
+#endif
+
+#if CONFIG_DEV_PIPE_MAXSIZE < CONFIG_DEV_PIPE_SIZE
+#  undef CONFIG_DEV_PIPE_MAXSIZE
+#  define CONFIG_DEV_PIPE_MAXSIZE CONFIG_DEV_PIPE_SIZE
+#endif
+
 #if CONFIG_DEV_PIPE_SIZE > 0
 
 /****************************************************************************
@@ -71,11 +80,11 @@
  * Public Types
  ****************************************************************************/
 
-/* Make the buffer index as small as possible for the configured pipe size */
+/* Make the buffer index as small as possible for the largest pipe size */
 
-#if CONFIG_DEV_PIPE_SIZE > 65535
+#if CONFIG_DEV_PIPE_MAXSIZE > 65535
 typedef uint32_t pipe_ndx_t;  /* 32-bit index */
-#elif CONFIG_DEV_PIPE_SIZE > 255
+#elif CONFIG_DEV_PIPE_MAXSIZE > 255
 typedef uint16_t pipe_ndx_t;  /* 16-bit index */
 #else
 typedef uint8_t pipe_ndx_t;   /*  8-bit index */
@@ -93,6 +102,8 @@ struct pipe_dev_s
   sem_t      d_wrsem;       /* Full buffer - Writer waits for data read */
   pipe_ndx_t d_wrndx;       /* Index in d_buffer to save next byte written */
   pipe_ndx_t d_rdndx;       /* Index in d_buffer to return the next byte read */
+  pipe_ndx_t d_bufsize;     /* Size of d_buffer in bytes */
+  pipe_ndx_t d_wrneed;      /* Free space that wakes waiting writers (0=none) */
   uint8_t    d_refs;        /* References counts on pipe (limited to 255) */
   uint8_t    d_nwriters;    /* Number of reference counts for write access */
   uint8_t    d_pipeno;      /* Pipe minor number */
@@ -125,6 +136,8 @@ EXTERN int     pipecommon_open(FAR struct file *filep);
 EXTERN int     pipecommon_close(FAR struct file *filep);
 EXTERN ssize_t pipecommon_read(FAR struct file *, FAR char *, size_t);
 EXTERN ssize_t pipecommon_write(FAR struct file *, FAR const char *, size_t);
+EXTERN int     pipecommon_ioctl(FAR struct file *filep, int cmd,
+                                unsigned long arg);
 #ifndef CONFIG_DISABLE_POLL
 EXTERN int     pipecommon_poll(FAR struct file *filep, FAR struct pollfd *fds,
                                bool setup);
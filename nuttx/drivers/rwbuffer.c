@@ -50,6 +50,8 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <arch/irq.h>
+
 #include <nuttx/kmalloc.h>
 #include <nuttx/wqueue.h>
 #include <nuttx/rwbuffer.h>
@@ -78,6 +80,14 @@
  * Private Variables
  ****************************************************************************/
 
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+#if defined(CONFIG_DRVR_WRITEBUFFER) && defined(CONFIG_DRVR_BLKQUEUE)
+static void rwb_wrcomplete(FAR struct blkreq_s *req);
+#endif
+
 /****************************************************************************
  * Public Variables
  ****************************************************************************/
@@ -133,6 +143,33 @@ static inline bool rwb_overlap(off_t blockstart1, size_t nblocks1,
     }
 }
 
+/****************************************************************************
+ * Name: rwb_flushoverlap
+ *
+ * Description:
+ *   Return true if the blocks overlap the asynchronous flush in progress.
+ *   The flush is extended to the units that the flush callout rewrites.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_DRVR_WRITEBUFFER) && defined(CONFIG_DRVR_BLKQUEUE)
+static inline bool rwb_flushoverlap(FAR struct rwbuffer_s *rwb,
+                                    off_t startblock, size_t nblocks)
+{
+  off_t flushstart = rwb->wrreq.startblock;
+  off_t flushend   = flushstart + rwb->wrreq.nblocks;
+
+  if (rwb->wrreq.nblocks > 0 && rwb->wrgranule > 1)
+    {
+      flushstart = (flushstart / rwb->wrgranule) * rwb->wrgranule;
+      flushend   = ((flushend + rwb->wrgranule - 1) / rwb->wrgranule) *
+                   rwb->wrgranule;
+    }
+
+  return rwb_overlap(flushstart, flushend - flushstart, startblock, nblocks);
+}
+#endif
+
 /****************************************************************************
  * Name: rwb_resetwrbuffer
  ****************************************************************************/
@@ -159,6 +196,9 @@ static inline void rwb_resetwrbuffer(struct rwbuffer_s *rwb)
 #ifdef CONFIG_DRVR_WRITEBUFFER
 static void rwb_wrflush(struct rwbuffer_s *rwb)
 {
+#ifdef CONFIG_DRVR_BLKQUEUE
+  FAR uint8_t *buffer;
+#endif
   int ret;
 
   fvdbg("Timeout!\n");
@@ -168,6 +208,37 @@ static void rwb_wrflush(struct rwbuffer_s *rwb)
       fvdbg("Flushing: blockstart=0x%08lx nblocks=%d from buffer=%p\n",
       (long)rwb->wrblockstart, rwb->wrnblocks, rwb->wrbuffer);
 
+#ifdef CONFIG_DRVR_BLKQUEUE
+      /* Wait for any previous flush to complete, then hand the buffer to
+       * the request queue and continue buffering in the other half.
+       */
+
+      rwb_semtake(&rwb->wrdonesem);
+
+      rwb->wrreq.op         = BLKREQ_WRITE;
+      rwb->wrreq.buffer     = rwb->wrbuffer;
+      rwb->wrreq.startblock = rwb->wrblockstart;
+      rwb->wrreq.nblocks    = rwb->wrnblocks;
+      rwb->wrreq.callback   = rwb_wrcomplete;
+      rwb->wrreq.priv       = rwb;
+
+      ret = blkq_submit(&rwb->wrqueue, &rwb->wrreq);
+      if (ret >= 0)
+        {
+          buffer             = rwb->wrbuffer;
+          rwb->wrbuffer      = rwb->wrflushbuffer;
+          rwb->wrflushbuffer = buffer;
+
+          rwb_resetwrbuffer(rwb);
+          return;
+        }
+
+      /* Could not queue the request.. flush synchronously */
+
+      fdbg("ERROR: blkq_submit failed: %d\n", ret);
+      rwb_semgive(&rwb->wrdonesem);
+#endif
+
       /* Flush cache.  On success, the flush method will return the number
        * of blocks written.  Anything other than the number requested is
        * an error.
@@ -177,11 +248,84 @@ static void rwb_wrflush(struct rwbuffer_s *rwb)
       if (ret != rwb->wrnblocks)
         {
           fdbg("ERROR: Error flushing write buffer: %d\n", ret);
+          rwb->wrerror = ret < 0 ? ret : -EIO;
         }
 
       rwb_resetwrbuffer(rwb);
     }
+}
+#endif
+
+/****************************************************************************
+ * Name: rwb_wrcomplete
+ *
+ * Description:
+ *   Called on the block I/O daemon thread when an asynchronous flush of the
+ *   write buffer completes.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_DRVR_WRITEBUFFER) && defined(CONFIG_DRVR_BLKQUEUE)
+static void rwb_wrcomplete(FAR struct blkreq_s *req)
+{
+  FAR struct rwbuffer_s *rwb = (FAR struct rwbuffer_s *)req->priv;
+
+  /* The write data is lost.  Remember the error so that it is reported to
+   * the next caller of rwb_write(), rwb_flush() or rwb_wrwait().
+   */
+
+  if (req->result != (ssize_t)req->nblocks)
+    {
+      fdbg("ERROR: Error flushing write buffer: %d\n", (int)req->result);
+      rwb->wrerror = req->result < 0 ? (int)req->result : -EIO;
+    }
 
+  rwb_semgive(&rwb->wrdonesem);
+}
+#endif
+
+/****************************************************************************
+ * Name: rwb_wrerror
+ *
+ * Description:
+ *   Return and clear the latched error of an earlier flush of the write
+ *   buffer.  Interrupts are disabled so that the block I/O daemon cannot
+ *   latch a new error between the two.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_WRITEBUFFER
+static int rwb_wrerror(FAR struct rwbuffer_s *rwb)
+{
+  irqstate_t flags;
+  int ret;
+
+  flags        = irqsave();
+  ret          = rwb->wrerror;
+  rwb->wrerror = OK;
+  irqrestore(flags);
+
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: rwb_wrwait
+ *
+ * Description:
+ *   Wait for any asynchronous flush of the write buffer to complete.
+ *   Returns the latched error of any failed flush.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_WRITEBUFFER
+static inline int rwb_wrwait(FAR struct rwbuffer_s *rwb)
+{
+#ifdef CONFIG_DRVR_BLKQUEUE
+  rwb_semtake(&rwb->wrdonesem);
+  rwb_semgive(&rwb->wrdonesem);
+#endif
+  return rwb_wrerror(rwb);
 }
 #endif
 
@@ -238,8 +382,6 @@ static ssize_t rwb_writebuffer(FAR struct rwbuffer_s *rwb,
                                off_t startblock, uint32_t nblocks,
                                FAR const uint8_t *wrbuffer)
 {
-  int ret;
-
   /* Write writebuffer Logic */
 
   rwb_wrcanceltimeout(rwb);
@@ -257,14 +399,7 @@ static ssize_t rwb_writebuffer(FAR struct rwbuffer_s *rwb,
 
       /* Flush the write buffer */
 
-      ret = rwb->wrflush(rwb, rwb->wrbuffer, rwb->wrblockstart, rwb->wrnblocks);
-      if (ret < 0)
-        {
-          fdbg("ERROR: Error writing multiple from cache: %d\n", -ret);
-          return ret;
-        }
-
-      rwb_resetwrbuffer(rwb);
+      rwb_wrflush(rwb);
     }
 
   /* writebuffer is empty? Then initialize it */
@@ -629,6 +764,9 @@ int rwb_invalidate_readahead(FAR struct rwbuffer_s *rwb,
 int rwb_initialize(FAR struct rwbuffer_s *rwb)
 {
   uint32_t allocsize;
+#if defined(CONFIG_DRVR_WRITEBUFFER) && defined(CONFIG_DRVR_BLKQUEUE)
+  int ret;
+#endif
 
   /* Sanity checking */
 
@@ -642,6 +780,7 @@ int rwb_initialize(FAR struct rwbuffer_s *rwb)
 #ifdef CONFIG_DRVR_WRITEBUFFER
   DEBUGASSERT(rwb->wrflush!= NULL);
   rwb->wrbuffer = NULL;
+  rwb->wrerror  = OK;
 #endif
 #ifdef CONFIG_DRVR_READAHEAD
   DEBUGASSERT(rwb->rhreload != NULL);
@@ -667,12 +806,39 @@ int rwb_initialize(FAR struct rwbuffer_s *rwb)
       if (rwb->wrmaxblocks > 0)
         {
           allocsize     = rwb->wrmaxblocks * rwb->blocksize;
+#ifdef CONFIG_DRVR_BLKQUEUE
+          /* Two buffers:  One being filled while the other is flushed */
+
+          rwb->wrbuffer = kmm_malloc(2 * allocsize);
+#else
           rwb->wrbuffer = kmm_malloc(allocsize);
+#endif
           if (!rwb->wrbuffer)
             {
               fdbg("Write buffer kmm_malloc(%d) failed\n", allocsize);
               return -ENOMEM;
             }
+
+#ifdef CONFIG_DRVR_BLKQUEUE
+          /* Initialize the queue that performs asynchronous flushes */
+
+          rwb->wrflushbuffer     = rwb->wrbuffer + allocsize;
+          sem_init(&rwb->wrdonesem, 0, 1);
+          rwb->wrreq.nblocks     = 0;
+
+          rwb->wrqueue.blocksize = rwb->blocksize;
+          rwb->wrqueue.maxblocks = rwb->wrmaxblocks;
+          rwb->wrqueue.dev       = rwb->dev;
+          rwb->wrqueue.read      = NULL;
+          rwb->wrqueue.write     = rwb->wrflush;
+
+          ret = blkq_initialize(&rwb->wrqueue);
+          if (ret < 0)
+            {
+              fdbg("blkq_initialize failed: %d\n", ret);
+              return ret;
+            }
+#endif
         }
 
       fvdbg("Write buffer size: %d bytes\n", allocsize);
@@ -724,10 +890,30 @@ void rwb_uninitialize(FAR struct rwbuffer_s *rwb)
     {
       rwb_wrcanceltimeout(rwb);
       sem_destroy(&rwb->wrsem);
+#ifdef CONFIG_DRVR_BLKQUEUE
       if (rwb->wrbuffer)
         {
+          /* Wait for any flush in progress and free the lower of the two
+           * buffers (they were allocated together).
+           */
+
+          (void)rwb_wrwait(rwb);
+          blkq_uninitialize(&rwb->wrqueue);
+          sem_destroy(&rwb->wrdonesem);
+
+          if (rwb->wrflushbuffer < rwb->wrbuffer)
+            {
+              rwb->wrbuffer = rwb->wrflushbuffer;
+            }
+
           kmm_free(rwb->wrbuffer);
         }
+#else
+      if (rwb->wrbuffer)
+        {
+          kmm_free(rwb->wrbuffer);
+        }
+#endif
     }
 #endif
 
@@ -751,6 +937,9 @@ int rwb_read(FAR struct rwbuffer_s *rwb, off_t startblock, uint32_t nblocks,
              FAR uint8_t *rdbuffer)
 {
   uint32_t remaining;
+#if defined(CONFIG_DRVR_WRITEBUFFER) && defined(CONFIG_DRVR_BLKQUEUE)
+  bool wrlocked = false;
+#endif
   int ret = OK;
 
   fvdbg("startblock=%ld nblocks=%ld rdbuffer=%p\n",
@@ -775,7 +964,36 @@ int rwb_read(FAR struct rwbuffer_s *rwb, off_t startblock, uint32_t nblocks,
           rwb_wrflush(rwb);
         }
 
-      rwb_semgive(&rwb->wrsem);
+#ifdef CONFIG_DRVR_BLKQUEUE
+      /* The data must also be on the media if it is being flushed.  The
+       * flush may also be rewriting neighboring blocks of the same unit.
+       */
+
+      if (rwb_flushoverlap(rwb, startblock, nblocks))
+        {
+          /* If that flush failed, the media does not hold the data that was
+           * written.  Report the error instead of reading the media.
+           */
+
+          ret = rwb_wrwait(rwb);
+          if (ret < 0)
+            {
+              rwb_semgive(&rwb->wrsem);
+              return ret;
+            }
+        }
+
+      /* If the flush callout rewrites whole units, then a flush started
+       * by another thread could erase the blocks while they are being read.
+       * Do not let any new flush start until the read is complete.
+       */
+
+      wrlocked = rwb->wrgranule > 1;
+      if (!wrlocked)
+#endif
+        {
+          rwb_semgive(&rwb->wrsem);
+        }
     }
 #endif
 
@@ -822,7 +1040,7 @@ int rwb_read(FAR struct rwbuffer_s *rwb, off_t startblock, uint32_t nblocks,
               if (ret < 0)
                 {
                   fdbg("ERROR: Failed to fill the read-ahead buffer: %d\n", ret);
-                  return ret;
+                  break;
                 }
             }
         }
@@ -833,16 +1051,25 @@ int rwb_read(FAR struct rwbuffer_s *rwb, off_t startblock, uint32_t nblocks,
        */
 
       rwb_semgive(&rwb->rhsem);
-      ret = nblocks;
+      if (ret >= 0)
+        {
+          ret = nblocks;
+        }
     }
   else
-#else
+#endif
     {
       /* No read-ahead buffering, (re)load the data directly into
        * the user buffer.
        */
 
-      ret = rwb->rhreload(rwb->dev, startblock, nblocks, rdbuffer);
+      ret = rwb->rhreload(rwb->dev, rdbuffer, startblock, nblocks);
+    }
+
+#if defined(CONFIG_DRVR_WRITEBUFFER) && defined(CONFIG_DRVR_BLKQUEUE)
+  if (wrlocked)
+    {
+      rwb_semgive(&rwb->wrsem);
     }
 #endif
 
@@ -890,17 +1117,30 @@ int rwb_write(FAR struct rwbuffer_s *rwb, off_t startblock,
 
           rwb_semtake(&rwb->wrsem);
           rwb_wrflush(rwb);
+          ret = rwb_wrwait(rwb);
           rwb_semgive(&rwb->wrsem);
 
           /* Then transfer the data directly to the media */
 
-          ret = rwb->wrflush(rwb->dev, wrbuffer, startblock, nblocks);
+          if (ret == OK)
+            {
+              ret = rwb->wrflush(rwb->dev, wrbuffer, startblock, nblocks);
+            }
         }
       else
         {
-          /* Buffer the data in the write buffer */
+          /* Buffer the data in the write buffer, unless an earlier flush
+           * failed.  That error is reported instead.
+           */
+
+          rwb_semtake(&rwb->wrsem);
+          ret = rwb_wrerror(rwb);
+          if (ret == OK)
+            {
+              ret = rwb_writebuffer(rwb, startblock, nblocks, wrbuffer);
+            }
 
-          ret = rwb_writebuffer(rwb, startblock, nblocks, wrbuffer);
+          rwb_semgive(&rwb->wrsem);
         }
 
       /* On success, return the number of blocks that we were requested to
@@ -909,7 +1149,7 @@ int rwb_write(FAR struct rwbuffer_s *rwb, off_t startblock,
        */
     }
   else
-#else
+#endif
     {
       /* No write buffer.. just pass the write operation through via the
        * flush callback.
@@ -918,10 +1158,36 @@ int rwb_write(FAR struct rwbuffer_s *rwb, off_t startblock,
       ret = rwb->wrflush(rwb->dev, wrbuffer, startblock, nblocks);
     }
 
-#endif
+  return ret;
+}
+
+/****************************************************************************
+ * Name: rwb_flush
+ *
+ * Description:
+ *   Write any buffered write data to the media now and wait for the write
+ *   to complete.  This is needed, for example, before the media is accessed
+ *   directly (XIP).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_WRITEBUFFER
+int rwb_flush(FAR struct rwbuffer_s *rwb)
+{
+  int ret = OK;
+
+  if (rwb->wrmaxblocks > 0)
+    {
+      rwb_semtake(&rwb->wrsem);
+      rwb_wrcanceltimeout(rwb);
+      rwb_wrflush(rwb);
+      ret = rwb_wrwait(rwb);
+      rwb_semgive(&rwb->wrsem);
+    }
 
   return ret;
 }
+#endif
 
 /****************************************************************************
  * Name: rwb_readbytes
@@ -970,7 +1236,7 @@ int rwb_mediaremoved(FAR struct rwbuffer_s *rwb)
 #endif
 
 #ifdef CONFIG_DRVR_READAHEAD
-  if (rhmaxblocks > 0)
+  if (rwb->rhmaxblocks > 0)
     {
       rwb_semtake(&rwb->rhsem);
       rwb_resetrhbuffer(rwb);
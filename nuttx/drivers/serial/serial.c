@@ -239,6 +239,9 @@ static int uart_putxmitchar(FAR uart_dev_t *dev, int ch, bool oktoblock)
                */
 
               dev->xmitwaiting = true;
+#ifdef CONFIG_SERIAL_DMA
+              uart_dmatxavail(dev);
+#endif
               uart_enabletxint(dev);
               ret = uart_takesem(&dev->xmitsem, true);
               uart_disabletxint(dev);
@@ -285,6 +288,104 @@ static int uart_putxmitchar(FAR uart_dev_t *dev, int ch, bool oktoblock)
   return OK;
 }
 
+/************************************************************************************
+ * Name: uart_xmitrun
+ *
+ * Description:
+ *   Return the number of characters at the beginning of 'buffer' that need no
+ *   output processing and can be copied into the TX buffer as they are.
+ *
+ ************************************************************************************/
+
+static size_t uart_xmitrun(FAR uart_dev_t *dev, FAR const char *buffer,
+                           size_t buflen)
+{
+  FAR const char *end = buffer + buflen;
+  FAR const char *ptr;
+
+#ifdef CONFIG_SERIAL_TERMIOS
+  if ((dev->tc_oflag & OPOST) == 0 ||
+      (dev->tc_oflag & (OCRNL | ONLCR | ONLRET)) == 0)
+    {
+      return buflen;
+    }
+
+  for (ptr = buffer; ptr < end && *ptr != '\n' && *ptr != '\r'; ptr++);
+#else
+  if (!dev->isconsole)
+    {
+      return buflen;
+    }
+
+  for (ptr = buffer; ptr < end && *ptr != '\n'; ptr++);
+#endif
+
+  return ptr - buffer;
+}
+
+/************************************************************************************
+ * Name: uart_putxmitbuf
+ *
+ * Description:
+ *   Copy as much of 'buffer' as will fit into the TX buffer without waiting.
+ *   The data is copied in at most two contiguous segments.  Returns the number
+ *   of characters copied.
+ *
+ ************************************************************************************/
+
+static size_t uart_putxmitbuf(FAR uart_dev_t *dev, FAR const char *buffer,
+                              size_t buflen)
+{
+  size_t ncopied = 0;
+  size_t nbytes;
+  int16_t head = dev->xmit.head;
+  int16_t tail;
+
+  while (ncopied < buflen)
+    {
+      /* Determine the size of the free, contiguous region following the head.
+       * One byte is always left unused to distinguish full from empty.
+       */
+
+      tail = dev->xmit.tail;
+      if (tail > head)
+        {
+          nbytes = tail - head - 1;
+        }
+      else
+        {
+          nbytes = dev->xmit.size - head;
+          if (tail == 0)
+            {
+              nbytes--;
+            }
+        }
+
+      if (nbytes == 0)
+        {
+          break;
+        }
+
+      if (nbytes > buflen - ncopied)
+        {
+          nbytes = buflen - ncopied;
+        }
+
+      memcpy(&dev->xmit.buffer[head], buffer + ncopied, nbytes);
+      ncopied += nbytes;
+
+      head += nbytes;
+      if (head >= dev->xmit.size)
+        {
+          head = 0;
+        }
+
+      dev->xmit.head = head;
+    }
+
+  return ncopied;
+}
+
 /************************************************************************************
  * Name: uart_irqwrite
  ************************************************************************************/
@@ -325,6 +426,7 @@ static ssize_t uart_write(FAR struct file *filep, FAR const char *buffer,
   FAR struct inode *inode    = filep->f_inode;
   FAR uart_dev_t   *dev      = inode->i_private;
   ssize_t           nwritten = buflen;
+  size_t            nrun;
   bool              oktoblock;
   int               ret;
   char              ch;
@@ -405,6 +507,24 @@ static ssize_t uart_write(FAR struct file *filep, FAR const char *buffer,
   uart_disabletxint(dev);
   for (; buflen; buflen--)
     {
+      /* Copy any run of characters that need no output processing directly
+       * into the TX buffer.  The character-at-a-time logic below handles
+       * the remainder, including any wait for space in the TX buffer.
+       */
+
+      nrun = uart_xmitrun(dev, buffer, buflen);
+      if (nrun > 0)
+        {
+          nrun    = uart_putxmitbuf(dev, buffer, nrun);
+          buffer += nrun;
+          buflen -= nrun;
+
+          if (buflen == 0)
+            {
+              break;
+            }
+        }
+
       ch  = *buffer++;
       ret = OK;
 
@@ -497,6 +617,9 @@ static ssize_t uart_write(FAR struct file *filep, FAR const char *buffer,
 
   if (dev->xmit.head != dev->xmit.tail)
     {
+#ifdef CONFIG_SERIAL_DMA
+      uart_dmatxavail(dev);
+#endif
       uart_enabletxint(dev);
     }
 
@@ -514,9 +637,13 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
   FAR uart_dev_t   *dev   = inode->i_private;
   irqstate_t        flags;
   ssize_t           recvd = 0;
+  size_t            nbytes;
+  int16_t           head;
   int16_t           tail;
   int               ret;
+#ifdef CONFIG_SERIAL_TERMIOS
   char              ch;
+#endif
 
   /* Only one user can access dev->recv.tail at a time */
 
@@ -566,29 +693,28 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
        */
 
       tail = dev->recv.tail;
-      if (dev->recv.head != tail)
+      head = dev->recv.head;
+      if (head != tail)
         {
-          /* Take the next character from the tail of the buffer */
-
-          ch = dev->recv.buffer[tail];
+#ifdef CONFIG_SERIAL_TERMIOS
+          if (dev->tc_iflag & (INLCR | IGNCR | ICRNL))
+            {
+              /* Take the next character from the tail of the buffer */
 
-          /* Increment the tail index.  Most operations are done using the
-           * local variable 'tail' so that the final dev->recv.tail update
-           * is atomic.
-           */
+              ch = dev->recv.buffer[tail];
 
-          if (++tail >= dev->recv.size)
-            {
-              tail = 0;
-            }
+              /* Increment the tail index.  Most operations are done using
+               * the local variable 'tail' so that the final dev->recv.tail
+               * update is atomic.
+               */
 
-          dev->recv.tail = tail;
+              if (++tail >= dev->recv.size)
+                {
+                  tail = 0;
+                }
 
-#ifdef CONFIG_SERIAL_TERMIOS
-          /* Do input processing if any is enabled */
+              dev->recv.tail = tail;
 
-          if (dev->tc_iflag & (INLCR | IGNCR | ICRNL))
-            {
               /* \n -> \r or \r -> \n translation? */
 
               if ((ch == '\n') && (dev->tc_iflag & INLCR))
@@ -606,22 +732,50 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
                 {
                   continue;
                 }
-            }
 
-          /* Specifically not handled:
-           *
-           * All of the local modes; echo, line editing, etc.
-           * Anything to do with break or parity errors.
-           * ISTRIP - we should be 8-bit clean.
-           * IUCLC - Not Posix
-           * IXON/OXOFF - no xon/xoff flow control.
-           */
+              /* Specifically not handled:
+               *
+               * All of the local modes; echo, line editing, etc.
+               * Anything to do with break or parity errors.
+               * ISTRIP - we should be 8-bit clean.
+               * IUCLC - Not Posix
+               * IXON/OXOFF - no xon/xoff flow control.
+               */
+
+              /* Store the received character */
+
+              *buffer++ = ch;
+              recvd++;
+            }
+          else
 #endif
+            {
+              /* No input processing is needed.  Copy the contiguous data
+               * following the tail of the buffer.  The data may wrap around
+               * the end of the buffer; the remainder will be taken on the
+               * next time through the loop.
+               */
+
+              nbytes = (head > tail ? head : dev->recv.size) - tail;
+              if (nbytes > buflen - recvd)
+                {
+                  nbytes = buflen - recvd;
+                }
+
+              memcpy(buffer, &dev->recv.buffer[tail], nbytes);
+              buffer += nbytes;
+              recvd  += nbytes;
 
-          /* Store the received character */
+              /* Update the tail index with a single, atomic store */
+
+              tail += nbytes;
+              if (tail >= dev->recv.size)
+                {
+                  tail = 0;
+                }
 
-          *buffer++ = ch;
-          recvd++;
+              dev->recv.tail = tail;
+            }
         }
 
 #ifdef CONFIG_DEV_SERIAL_FULLBLOCKS
@@ -674,6 +828,14 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
 
       else
         {
+#ifdef CONFIG_SERIAL_DMA
+          /* Let the lower half resume reception if it stalled because the
+           * RX buffer was full.
+           */
+
+          uart_dmarxfree(dev);
+#endif
+
           /* Disable Rx interrupts and test again... */
 
           uart_disablerxint(dev);
@@ -774,6 +936,15 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
     }
 #endif
 
+#ifdef CONFIG_SERIAL_DMA
+  /* Space was freed in the RX buffer.  Let the lower half know */
+
+  if (recvd > 0)
+    {
+      uart_dmarxfree(dev);
+    }
+#endif
+
   uart_givesem(&dev->recv.sem);
   return recvd;
 }
@@ -845,6 +1016,28 @@ static int uart_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
               ret = 0;
             }
             break;
+
+#ifdef CONFIG_SERIAL_TIOCGICOUNT
+          case TIOCGICOUNT:
+            {
+              FAR struct serial_icounter_struct *icount =
+                (FAR struct serial_icounter_struct *)((uintptr_t)arg);
+              irqstate_t state;
+
+              if (!icount)
+                {
+                  ret = -EINVAL;
+                  break;
+                }
+
+              state = irqsave();
+              memcpy(icount, &dev->icount,
+                     sizeof(struct serial_icounter_struct));
+              irqrestore(state);
+              ret = 0;
+            }
+            break;
+#endif
         }
     }
 
@@ -1206,6 +1399,13 @@ static int uart_open(FAR struct file *filep)
       dev->recv.head = 0;
       dev->recv.tail = 0;
 
+#ifdef CONFIG_SERIAL_DMA
+      /* No DMA transfers are in progress */
+
+      memset(&dev->dmatx, 0, sizeof(struct uart_dmaxfer_s));
+      memset(&dev->dmarx, 0, sizeof(struct uart_dmaxfer_s));
+#endif
+
       /* Initialise termios state */
 
 #ifdef CONFIG_SERIAL_TERMIOS
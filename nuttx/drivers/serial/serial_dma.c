@@ -0,0 +1,233 @@
+/************************************************************************************
+ * drivers/serial/serial_dma.c
+ *
+ *   Copyright (C) 2014 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ************************************************************************************/
+
+/************************************************************************************
+ * Included Files
+ ************************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <semaphore.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/serial/serial.h>
+
+#ifdef CONFIG_SERIAL_DMA
+
+/************************************************************************************
+ * Public Functions
+ ************************************************************************************/
+
+/************************************************************************************
+ * Name: uart_xmitchars_dma
+ *
+ * Description:
+ *   Set up dev->dmatx to describe all of the data in the transmit buffer and
+ *   start the lower half DMA transfer.  Does nothing if a transfer is already in
+ *   progress or if the buffer is empty.
+ *
+ ************************************************************************************/
+
+void uart_xmitchars_dma(FAR uart_dev_t *dev)
+{
+  FAR struct uart_dmaxfer_s *xfer = &dev->dmatx;
+  int16_t head = dev->xmit.head;
+  int16_t tail = dev->xmit.tail;
+
+  if (xfer->length > 0 || head == tail)
+    {
+      return;
+    }
+
+  /* The data runs from the tail to the head, possibly wrapping around the end
+   * of the buffer.
+   */
+
+  xfer->buffer = &dev->xmit.buffer[tail];
+  xfer->nbytes = 0;
+
+  if (tail < head)
+    {
+      xfer->length  = head - tail;
+      xfer->nbuffer = NULL;
+      xfer->nlength = 0;
+    }
+  else
+    {
+      xfer->length  = dev->xmit.size - tail;
+      xfer->nbuffer = dev->xmit.buffer;
+      xfer->nlength = head;
+    }
+
+  uart_dmasend(dev);
+}
+
+/************************************************************************************
+ * Name: uart_xmitchars_done
+ *
+ * Description:
+ *   Called by the lower half after dev->dmatx.nbytes have been sent.  Releases
+ *   the transmitted data from the buffer, wakes up any waiting writers and starts
+ *   the next transfer if more data has been buffered in the meantime.
+ *
+ ************************************************************************************/
+
+void uart_xmitchars_done(FAR uart_dev_t *dev)
+{
+  FAR struct uart_dmaxfer_s *xfer = &dev->dmatx;
+  size_t nbytes = xfer->nbytes;
+  int16_t tail;
+
+  /* Mark the transfer complete and remove the sent data from the buffer */
+
+  xfer->length  = 0;
+  xfer->nlength = 0;
+  xfer->nbytes  = 0;
+
+  if (nbytes > 0)
+    {
+      tail = dev->xmit.tail + nbytes;
+      if (tail >= dev->xmit.size)
+        {
+          tail -= dev->xmit.size;
+        }
+
+      dev->xmit.tail = tail;
+
+#ifdef CONFIG_SERIAL_TIOCGICOUNT
+      dev->icount.tx += nbytes;
+#endif
+      uart_datasent(dev);
+    }
+
+  /* Keep the transmitter busy if more data is waiting */
+
+  uart_xmitchars_dma(dev);
+}
+
+/************************************************************************************
+ * Name: uart_recvchars_dma
+ *
+ * Description:
+ *   Set up dev->dmarx to describe all of the free space in the receive buffer and
+ *   start the lower half DMA transfer.  If the buffer is full, no transfer is
+ *   started.
+ *
+ ************************************************************************************/
+
+void uart_recvchars_dma(FAR uart_dev_t *dev)
+{
+  FAR struct uart_dmaxfer_s *xfer = &dev->dmarx;
+  int16_t head = dev->recv.head;
+  int16_t tail = dev->recv.tail;
+  size_t nfree;
+
+  if (xfer->length > 0)
+    {
+      return;
+    }
+
+  /* Get the total free space.  One byte is always left unused to distinguish
+   * a full buffer from an empty one.
+   */
+
+  nfree = (tail > head ? tail : tail + dev->recv.size) - head - 1;
+  if (nfree == 0)
+    {
+      return;
+    }
+
+  xfer->buffer = &dev->recv.buffer[head];
+  xfer->nbytes = 0;
+
+  if (head + nfree <= dev->recv.size)
+    {
+      xfer->length  = nfree;
+      xfer->nbuffer = NULL;
+      xfer->nlength = 0;
+    }
+  else
+    {
+      xfer->length  = dev->recv.size - head;
+      xfer->nbuffer = dev->recv.buffer;
+      xfer->nlength = nfree - xfer->length;
+    }
+
+  uart_dmareceive(dev);
+}
+
+/************************************************************************************
+ * Name: uart_recvchars_done
+ *
+ * Description:
+ *   Called by the lower half when a receive DMA transfer completes or when the
+ *   receive line goes idle.  Adds dev->dmarx.nbytes to the receive buffer and
+ *   wakes up any waiting readers.
+ *
+ ************************************************************************************/
+
+void uart_recvchars_done(FAR uart_dev_t *dev)
+{
+  FAR struct uart_dmaxfer_s *xfer = &dev->dmarx;
+  size_t nbytes = xfer->nbytes;
+  int16_t head;
+
+  DEBUGASSERT(nbytes <= xfer->length + xfer->nlength);
+
+  xfer->length  = 0;
+  xfer->nlength = 0;
+  xfer->nbytes  = 0;
+
+  if (nbytes > 0)
+    {
+      head = dev->recv.head + nbytes;
+      if (head >= dev->recv.size)
+        {
+          head -= dev->recv.size;
+        }
+
+      dev->recv.head = head;
+
+#ifdef CONFIG_SERIAL_TIOCGICOUNT
+      dev->icount.rx += nbytes;
+#endif
+      uart_datareceived(dev);
+    }
+}
+
+#endif /* CONFIG_SERIAL_DMA */
@@ -121,6 +121,9 @@ void uart_xmitchars(FAR uart_dev_t *dev)
 
   if (nbytes)
     {
+#ifdef CONFIG_SERIAL_TIOCGICOUNT
+      dev->icount.tx += nbytes;
+#endif
       uart_datasent(dev);
     }
 }
@@ -197,6 +200,12 @@ void uart_recvchars(FAR uart_dev_t *dev)
                nexthead = 0;
             }
         }
+#ifdef CONFIG_SERIAL_TIOCGICOUNT
+      else
+        {
+          dev->icount.buf_overrun++;
+        }
+#endif
     }
 
   /* If any bytes were added to the buffer, inform any waiters there there is new
@@ -205,6 +214,9 @@ void uart_recvchars(FAR uart_dev_t *dev)
 
   if (nbytes)
     {
+#ifdef CONFIG_SERIAL_TIOCGICOUNT
+      dev->icount.rx += nbytes;
+#endif
       uart_datareceived(dev);
     }
 }
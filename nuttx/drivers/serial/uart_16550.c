@@ -63,6 +63,23 @@
  * Pre-processor definitions
  ****************************************************************************/
 
+/* With CONFIG_SERIAL_DMA, the 16550 FIFOs are used as a block transfer
+ * engine:  Each THRE interrupt refills the whole TX FIFO from the current
+ * transmit segment and each RX interrupt drains the whole RX FIFO into the
+ * current receive segment.  Received data is handed to the upper half when
+ * the receive segment fills, when half of the RX buffer has been filled, or
+ * when the UART reports a character time-out (CTI), i.e. when the receive
+ * line has been idle for four character times.
+ */
+
+#if defined(CONFIG_SERIAL_DMA) && !defined(CONFIG_SUPPRESS_SERIAL_INTS)
+#  define HAVE_16550_DMA 1
+#endif
+
+/* Depth of the 16550 TX FIFO */
+
+#define UART_TXFIFO_DEPTH 16
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -104,6 +121,11 @@ static void u16550_send(struct uart_dev_s *dev, int ch);
 static void u16550_txint(struct uart_dev_s *dev, bool enable);
 static bool u16550_txready(struct uart_dev_s *dev);
 static bool u16550_txempty(struct uart_dev_s *dev);
+#ifdef HAVE_16550_DMA
+static void u16550_dmasend(struct uart_dev_s *dev);
+static void u16550_dmarxfree(struct uart_dev_s *dev);
+static void u16550_dmatxavail(struct uart_dev_s *dev);
+#endif
 
 /****************************************************************************
  * Private Variables
@@ -126,6 +148,12 @@ static const struct uart_ops_s g_uart_ops =
   .txint          = u16550_txint,
   .txready        = u16550_txready,
   .txempty        = u16550_txempty,
+#ifdef HAVE_16550_DMA
+  .dmasend        = u16550_dmasend,
+  .dmareceive     = NULL,  /* Reception is driven by the RX FIFO interrupts */
+  .dmarxfree      = u16550_dmarxfree,
+  .dmatxavail     = u16550_dmatxavail,
+#endif
 };
 
 /* I/O buffers */
@@ -553,6 +581,161 @@ static inline uint32_t u16550_divisor(struct u16550_s *priv)
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: u16550_lsrcount
+ *
+ * Description:
+ *   Update the line status error counts from an LSR value
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SERIAL_TIOCGICOUNT
+static inline void u16550_lsrcount(struct uart_dev_s *dev, uint32_t lsr)
+{
+  if ((lsr & UART_LSR_OE) != 0)
+    {
+      dev->icount.overrun++;
+    }
+
+  if ((lsr & UART_LSR_PE) != 0)
+    {
+      dev->icount.parity++;
+    }
+
+  if ((lsr & UART_LSR_FE) != 0)
+    {
+      dev->icount.frame++;
+    }
+
+  if ((lsr & UART_LSR_BI) != 0)
+    {
+      dev->icount.brk++;
+    }
+}
+#else
+#  define u16550_lsrcount(dev,lsr)
+#endif
+
+/****************************************************************************
+ * Name: u16550_dmatxfill
+ *
+ * Description:
+ *   Refill the TX FIFO from the current transmit segments.  Called with
+ *   interrupts disabled.  When the whole transfer has been written to the
+ *   FIFO, the upper half is informed (which will start the next transfer if
+ *   there is more data).  The THRE interrupt is disabled when there is
+ *   nothing more to send.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_16550_DMA
+static void u16550_dmatxfill(struct uart_dev_s *dev)
+{
+  struct u16550_s *priv = (struct u16550_s*)dev->priv;
+  struct uart_dmaxfer_s *xfer = &dev->dmatx;
+  size_t total = xfer->length + xfer->nlength;
+  size_t ndx;
+  int n;
+
+  if (total > 0 &&
+      (u16550_serialin(priv, UART_LSR_OFFSET) & UART_LSR_THRE) != 0)
+    {
+      /* The FIFO is empty.  Fill it without polling the LSR */
+
+      for (n = 0; n < UART_TXFIFO_DEPTH && xfer->nbytes < total; n++)
+        {
+          ndx = xfer->nbytes++;
+          u16550_serialout(priv, UART_THR_OFFSET,
+                           (uart_datawidth_t)(ndx < xfer->length ?
+                             xfer->buffer[ndx] :
+                             xfer->nbuffer[ndx - xfer->length]));
+        }
+
+      if (xfer->nbytes >= total)
+        {
+          uart_xmitchars_done(dev);
+        }
+    }
+
+  if (xfer->length == 0)
+    {
+      priv->ier &= ~UART_IER_ETBEI;
+      u16550_serialout(priv, UART_IER_OFFSET, priv->ier);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: u16550_dmarxdrain
+ *
+ * Description:
+ *   Drain the RX FIFO into the current receive segments.  Called from the
+ *   interrupt handler.  'idle' is true if the UART reported a character
+ *   time-out.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_16550_DMA
+static void u16550_dmarxdrain(struct uart_dev_s *dev, bool idle)
+{
+  struct u16550_s *priv = (struct u16550_s*)dev->priv;
+  struct uart_dmaxfer_s *xfer = &dev->dmarx;
+  size_t total;
+  size_t ndx;
+  uint32_t lsr;
+  char ch;
+
+  /* Set up a new receive transfer if necessary */
+
+  if (xfer->length == 0)
+    {
+      uart_recvchars_dma(dev);
+    }
+
+  total = xfer->length + xfer->nlength;
+  while (((lsr = u16550_serialin(priv, UART_LSR_OFFSET)) & UART_LSR_DR) != 0)
+    {
+      ch = (char)u16550_serialin(priv, UART_RBR_OFFSET);
+      u16550_lsrcount(dev, lsr);
+
+      /* If the RX buffer is full, the data must still be read to clear the
+       * interrupt; it is discarded.
+       */
+
+      if (xfer->nbytes < total)
+        {
+          ndx = xfer->nbytes++;
+          if (ndx < xfer->length)
+            {
+              xfer->buffer[ndx] = ch;
+            }
+          else
+            {
+              xfer->nbuffer[ndx - xfer->length] = ch;
+            }
+        }
+#ifdef CONFIG_SERIAL_TIOCGICOUNT
+      else
+        {
+          dev->icount.buf_overrun++;
+        }
+#endif
+    }
+
+  /* Hand the data to the upper half on the idle-line timeout, when the
+   * transfer is complete, or when half of the RX buffer has been filled so
+   * that readers are not starved by a continuous stream.
+   */
+
+  if (xfer->nbytes > 0 &&
+      (idle || xfer->nbytes >= total || xfer->nbytes >= dev->recv.size / 2))
+    {
+      uart_recvchars_done(dev);
+      uart_recvchars_dma(dev);
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: u16550_setup
  *
@@ -803,7 +986,12 @@ static int u16550_interrupt(int irq, void *context)
           case UART_IIR_INTID_RDA:
           case UART_IIR_INTID_CTI:
             {
+#ifdef HAVE_16550_DMA
+              u16550_dmarxdrain(dev,
+                (status & UART_IIR_INTID_MASK) == UART_IIR_INTID_CTI);
+#else
               uart_recvchars(dev);
+#endif
               break;
             }
 
@@ -811,7 +999,11 @@ static int u16550_interrupt(int irq, void *context)
 
           case UART_IIR_INTID_THRE:
             {
+#ifdef HAVE_16550_DMA
+              u16550_dmatxfill(dev);
+#else
               uart_xmitchars(dev);
+#endif
               break;
             }
 
@@ -833,6 +1025,7 @@ static int u16550_interrupt(int irq, void *context)
               /* Read the line status register (LSR) to clear */
 
               status = u16550_serialin(priv, UART_LSR_OFFSET);
+              u16550_lsrcount(dev, status);
               vdbg("LSR: %02x\n", status);
               break;
             }
@@ -903,8 +1096,7 @@ static int u16550_ioctl(struct file *filep, int cmd, unsigned long arg)
       break;
 
     default:
-      set_errno(ENOTTY);
-      ret = ERROR;
+      ret = -ENOTTY;
       break;
     }
 
@@ -928,6 +1120,7 @@ static int u16550_receive(struct uart_dev_s *dev, uint32_t *status)
 
   *status = u16550_serialin(priv, UART_LSR_OFFSET);
   rbr     = u16550_serialin(priv, UART_RBR_OFFSET);
+  u16550_lsrcount(dev, *status);
   return rbr;
 }
 
@@ -1003,11 +1196,20 @@ static void u16550_txint(struct uart_dev_s *dev, bool enable)
       priv->ier |= UART_IER_ETBEI;
       u16550_serialout(priv, UART_IER_OFFSET, priv->ier);
 
+#ifdef HAVE_16550_DMA
+      /* Fake a TX interrupt by refilling the TX FIFO from the current
+       * transfer.  uart_xmitchars() must not be used:  It would remove data
+       * from the TX buffer that is owned by the transfer.
+       */
+
+      u16550_dmatxfill(dev);
+#else
       /* Fake a TX interrupt here by just calling uart_xmitchars() with
        * interrupts disabled (note this may recurse).
        */
 
       uart_xmitchars(dev);
+#endif
     }
   else
     {
@@ -1047,6 +1249,62 @@ static bool u16550_txempty(struct uart_dev_s *dev)
   return ((u16550_serialin(priv, UART_LSR_OFFSET) & UART_LSR_THRE) != 0);
 }
 
+/****************************************************************************
+ * Name: u16550_dmasend
+ *
+ * Description:
+ *   Start sending the transfer described by dev->dmatx.  The TX FIFO is
+ *   refilled from the THRE interrupt.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_16550_DMA
+static void u16550_dmasend(struct uart_dev_s *dev)
+{
+  struct u16550_s *priv = (struct u16550_s*)dev->priv;
+
+  priv->ier |= UART_IER_ETBEI;
+  u16550_serialout(priv, UART_IER_OFFSET, priv->ier);
+}
+#endif
+
+/****************************************************************************
+ * Name: u16550_dmarxfree
+ *
+ * Description:
+ *   Space has been freed in the RX buffer.  Set up a new receive transfer if
+ *   the last one stalled because the buffer was full.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_16550_DMA
+static void u16550_dmarxfree(struct uart_dev_s *dev)
+{
+  irqstate_t flags = irqsave();
+  uart_recvchars_dma(dev);
+  irqrestore(flags);
+}
+#endif
+
+/****************************************************************************
+ * Name: u16550_dmatxavail
+ *
+ * Description:
+ *   Data has been added to the TX buffer.  Start a transfer if none is in
+ *   progress.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_16550_DMA
+static void u16550_dmatxavail(struct uart_dev_s *dev)
+{
+  irqstate_t flags = irqsave();
+  uart_xmitchars_dma(dev);
+  u16550_dmatxfill(dev);
+  irqrestore(flags);
+}
+#endif
+
 /****************************************************************************
  * Name: u16550_putc
  *
@@ -64,13 +64,67 @@
 #ifdef CONFIG_RAMLOG
 
 /****************************************************************************
- * Private Types
+ * Pre-processor Definitions
  ****************************************************************************/
 
+#ifdef CONFIG_RAMLOG_BINARY
+/* In the binary mode, the circular buffer holds variable length records.
+ * Each record begins with a struct ramlog_rec_s header and all records are
+ * aligned to the size of a pointer.
+ */
+
+#  define RAMLOG_ALIGN       sizeof(uintptr_t)
+#  define RAMLOG_ALIGNUP(n)  (((n) + RAMLOG_ALIGN - 1) & ~(RAMLOG_ALIGN - 1))
+#  define RAMLOG_HDRSIZE     RAMLOG_ALIGNUP(sizeof(struct ramlog_rec_s))
+
+/* Records are formatted one at a time into a line buffer when the RAM log
+ * is read.  Text records are also limited to this size.
+ */
+
+#  define RAMLOG_LINESIZE    128
+
+/* Argument types captured from the format string */
+
+#  define RAMLOG_ARG_NONE    0  /* No argument (e.g., "%%") */
+#  define RAMLOG_ARG_INT     1  /* int, char */
+#  define RAMLOG_ARG_LONG    2  /* long */
+#  define RAMLOG_ARG_LLONG   3  /* long long */
+#  define RAMLOG_ARG_PTR     4  /* void * */
+#  define RAMLOG_ARG_DOUBLE  5  /* double */
+#  define RAMLOG_ARG_STRING  6  /* char *, copied into the record */
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+#ifdef CONFIG_RAMLOG_BINARY
+/* The header of one binary log record.  An rr_size of zero marks the end
+ * of the used part of the buffer:  The next record is at offset zero.
+ */
+
+struct ramlog_rec_s
+{
+  uint16_t          rr_size;         /* Size of the record, including header */
+  uint16_t          rr_nbytes;       /* Number of payload bytes */
+  volatile uint8_t  rr_committed;    /* The payload is complete */
+  FAR const char   *rr_fmt;          /* Format string, NULL for a text record */
+};
+
+/* One captured argument */
+
+union ramlog_arg_u
+{
+  int               ra_int;
+  long              ra_long;
+#ifdef CONFIG_HAVE_LONG_LONG
+  long long         ra_llong;
+#endif
+  FAR void         *ra_ptr;
+  double            ra_double;
+};
+#endif
+
 struct ramlog_dev_s
 {
 #ifndef CONFIG_RAMLOG_NONBLOCKING
@@ -93,6 +147,18 @@ struct ramlog_dev_s
 #ifndef CONFIG_DISABLE_POLL
   struct pollfd *rl_fds[CONFIG_RAMLOG_NPOLLWAITERS];
 #endif
+
+#ifdef CONFIG_RAMLOG_BINARY
+  /* The most recently formatted record, waiting to be read */
+
+  volatile uint16_t rl_ndropped;     /* Number of records lost on overflow */
+  volatile bool     rl_isopen;       /* rl_openrec is an open text record */
+  volatile uint16_t rl_openrec;      /* Offset of the open text record */
+  uint8_t           rl_linepos;      /* Read position in rl_line */
+  uint8_t           rl_linelen;      /* Number of characters in rl_line */
+  bool              rl_crdone;       /* CR already returned before LF */
+  char              rl_line[RAMLOG_LINESIZE];
+#endif
 };
 
 /****************************************************************************
@@ -104,7 +170,22 @@ struct ramlog_dev_s
 static void ramlog_pollnotify(FAR struct ramlog_dev_s *priv,
                               pollevent_t eventset);
 #endif
-static ssize_t ramlog_addchar(FAR struct ramlog_dev_s *priv, char ch);
+#ifdef CONFIG_RAMLOG_BINARY
+static FAR const char *ramlog_parsespec(FAR const char *fmt,
+                                        FAR uint8_t *nstar,
+                                        FAR uint8_t *type);
+static void    ramlog_closerec(FAR struct ramlog_dev_s *priv);
+static FAR struct ramlog_rec_s *ramlog_reserve(FAR struct ramlog_dev_s *priv,
+                                               FAR const char *fmt,
+                                               size_t size);
+static int     ramlog_addrec(FAR struct ramlog_dev_s *priv,
+                             FAR const char *fmt, FAR const void *payload,
+                             size_t nbytes);
+static int     ramlog_addtext(FAR struct ramlog_dev_s *priv, char ch);
+static bool    ramlog_nextline(FAR struct ramlog_dev_s *priv);
+#else
+static int     ramlog_addchar(FAR struct ramlog_dev_s *priv, char ch);
+#endif
 
 /* Character driver methods */
 
@@ -137,7 +218,11 @@ static const struct file_operations g_ramlogfops =
  */
 
 #if defined(CONFIG_RAMLOG_CONSOLE) || defined(CONFIG_RAMLOG_SYSLOG)
+#ifdef CONFIG_RAMLOG_BINARY
+static uintptr_t g_sysbuffer[CONFIG_RAMLOG_BUFSIZE / sizeof(uintptr_t)];
+#else
 static char g_sysbuffer[CONFIG_RAMLOG_BUFSIZE];
+#endif
 
 /* This is the device structure for the console or syslogging function.  It
  * must be statically initialized because the RAMLOG syslog_putc function
@@ -155,8 +240,8 @@ static struct ramlog_dev_s g_sysdev =
 #ifndef CONFIG_RAMLOG_NONBLOCKING
   SEM_INITIALIZER(0),            /* rl_waitsem */
 #endif
-  CONFIG_RAMLOG_BUFSIZE,         /* rl_bufsize */
-  g_sysbuffer                    /* rl_buffer */
+  sizeof(g_sysbuffer),           /* rl_bufsize */
+  (FAR char *)g_sysbuffer        /* rl_buffer */
 };
 #endif
 
@@ -197,10 +282,622 @@ static void ramlog_pollnotify(FAR struct ramlog_dev_s *priv,
 #  define ramlog_pollnotify(priv,event)
 #endif
 
+/****************************************************************************
+ * Name: ramlog_parsespec
+ *
+ * Description:
+ *   Parse one conversion specification of a format string, just as
+ *   lib_vsprintf() does.  fmt points to the character following the '%'.
+ *   Returns a pointer to the character following the specification, the
+ *   number of '*' int arguments and the type of the converted argument.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_RAMLOG_BINARY
+static FAR const char *ramlog_parsespec(FAR const char *fmt,
+                                        FAR uint8_t *nstar,
+                                        FAR uint8_t *type)
+{
+  /* Skip over the flags, field width and precision */
+
+  *nstar = 0;
+  while (*fmt && !strchr("diuxXpobeEfgGlLsc%", *fmt))
+    {
+      if (*fmt == '*')
+        {
+          (*nstar)++;
+        }
+
+      fmt++;
+    }
+
+  /* Then the size qualifier */
+
+  *type = RAMLOG_ARG_INT;
+  if (*fmt == 'L')
+    {
+      *type = RAMLOG_ARG_LLONG;
+      fmt++;
+    }
+  else if (*fmt == 'l')
+    {
+      *type = RAMLOG_ARG_LONG;
+      fmt++;
+      if (*fmt == 'l')
+        {
+          *type = RAMLOG_ARG_LLONG;
+          fmt++;
+        }
+    }
+
+#ifndef CONFIG_HAVE_LONG_LONG
+  if (*type == RAMLOG_ARG_LLONG)
+    {
+      *type = RAMLOG_ARG_LONG;
+    }
+#endif
+
+  /* And finally the conversion */
+
+  switch (*fmt)
+    {
+      case '\0':
+        *type = RAMLOG_ARG_NONE;
+        return fmt;
+
+      case '%':
+        *type = RAMLOG_ARG_NONE;
+        break;
+
+      case 's':
+        *type = RAMLOG_ARG_STRING;
+        break;
+
+      case 'p':
+        *type = RAMLOG_ARG_PTR;
+        break;
+
+      case 'c':
+        *type = RAMLOG_ARG_INT;
+        break;
+
+      case 'e':
+      case 'E':
+      case 'f':
+      case 'g':
+      case 'G':
+        *type = RAMLOG_ARG_DOUBLE;
+        break;
+
+      default:
+        break;
+    }
+
+  return fmt + 1;
+}
+
+/****************************************************************************
+ * Name: ramlog_closerec
+ *
+ * Description:
+ *   Commit the open text record, if there is one, so that no more
+ *   characters are added to it.  Called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+static void ramlog_closerec(FAR struct ramlog_dev_s *priv)
+{
+  if (priv->rl_isopen)
+    {
+      ((FAR struct ramlog_rec_s *)&priv->rl_buffer[priv->rl_openrec])->
+        rr_committed = 1;
+      priv->rl_isopen = false;
+    }
+}
+
+/****************************************************************************
+ * Name: ramlog_reserve
+ *
+ * Description:
+ *   Reserve space for a record of 'size' bytes and initialize its header.
+ *   Any open text record is committed first so that records remain in
+ *   order.  Returns the new, uncommitted record or NULL if the RAM log is
+ *   full.  Called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+static FAR struct ramlog_rec_s *ramlog_reserve(FAR struct ramlog_dev_s *priv,
+                                               FAR const char *fmt,
+                                               size_t size)
+{
+  FAR struct ramlog_rec_s *rec;
+  size_t head = priv->rl_head;
+  size_t tail = priv->rl_tail;
+
+  ramlog_closerec(priv);
+
+  /* At least RAMLOG_ALIGN bytes always remain unused so that a full buffer
+   * can be distinguished from an empty one.
+   */
+
+  if (head >= tail)
+    {
+      /* Does the record fit at the end of the buffer? */
+
+      if (head + size > priv->rl_bufsize ||
+          (tail == 0 && head + size == priv->rl_bufsize))
+        {
+          /* No.. wrap around to the beginning of the buffer */
+
+          if (size >= tail)
+            {
+              priv->rl_ndropped++;
+              return NULL;
+            }
+
+          ((FAR struct ramlog_rec_s *)&priv->rl_buffer[head])->rr_size = 0;
+          head = 0;
+        }
+    }
+  else if (head + size >= tail)
+    {
+      priv->rl_ndropped++;
+      return NULL;
+    }
+
+  rec               = (FAR struct ramlog_rec_s *)&priv->rl_buffer[head];
+  rec->rr_size      = size;
+  rec->rr_nbytes    = 0;
+  rec->rr_committed = 0;
+  rec->rr_fmt       = fmt;
+
+  head += size;
+  if (head >= priv->rl_bufsize)
+    {
+      head = 0;
+    }
+
+  priv->rl_head = head;
+  return rec;
+}
+
+/****************************************************************************
+ * Name: ramlog_addrec
+ *
+ * Description:
+ *   Add one record to the binary RAM log.  Interrupts are disabled only
+ *   while space for the record is reserved; the payload is copied with
+ *   interrupts enabled and the record is then marked as committed.  The
+ *   reader never passes a record that has not been committed.  This
+ *   function may be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+static int ramlog_addrec(FAR struct ramlog_dev_s *priv,
+                         FAR const char *fmt, FAR const void *payload,
+                         size_t nbytes)
+{
+  FAR struct ramlog_rec_s *rec;
+  irqstate_t flags;
+
+  flags = irqsave();
+  rec   = ramlog_reserve(priv, fmt, RAMLOG_HDRSIZE + RAMLOG_ALIGNUP(nbytes));
+  irqrestore(flags);
+
+  if (!rec)
+    {
+      return -EBUSY;
+    }
+
+  /* Copy the payload and commit the record */
+
+  memcpy((FAR char *)rec + RAMLOG_HDRSIZE, payload, nbytes);
+  rec->rr_nbytes    = nbytes;
+  rec->rr_committed = 1;
+
+  /* Notify all poll/select waiters that there is data to be read */
+
+  ramlog_pollnotify(priv, POLLIN);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ramlog_addtext
+ *
+ * Description:
+ *   Add one character to the open text record.  A new text record is
+ *   started if there is no open record or if the open record cannot grow
+ *   in place.  The record is closed at a newline or when it holds
+ *   RAMLOG_LINESIZE characters.  The open record is only extended while
+ *   interrupts are disabled, so this function may be called from an
+ *   interrupt handler.
+ *
+ ****************************************************************************/
+
+static int ramlog_addtext(FAR struct ramlog_dev_s *priv, char ch)
+{
+  FAR struct ramlog_rec_s *rec = NULL;
+  irqstate_t flags;
+  size_t head;
+  size_t tail;
+
+  flags = irqsave();
+
+  if (priv->rl_isopen)
+    {
+      rec = (FAR struct ramlog_rec_s *)&priv->rl_buffer[priv->rl_openrec];
+      if (RAMLOG_HDRSIZE + rec->rr_nbytes >= rec->rr_size)
+        {
+          /* The record is full up to its alignment.  It can only grow if
+           * it is still the last record and there is free space after it.
+           */
+
+          head = priv->rl_head;
+          tail = priv->rl_tail;
+
+          if (priv->rl_openrec + rec->rr_size == head &&
+              ((head >= tail &&
+                head + RAMLOG_ALIGN <= priv->rl_bufsize &&
+                (tail != 0 || head + RAMLOG_ALIGN < priv->rl_bufsize)) ||
+               (head < tail && head + RAMLOG_ALIGN < tail)))
+            {
+              rec->rr_size += RAMLOG_ALIGN;
+              head         += RAMLOG_ALIGN;
+              priv->rl_head = head < priv->rl_bufsize ? head : 0;
+            }
+          else
+            {
+              rec = NULL;
+            }
+        }
+    }
+
+  if (!rec)
+    {
+      /* Start a new text record */
+
+      rec = ramlog_reserve(priv, NULL, RAMLOG_HDRSIZE + RAMLOG_ALIGN);
+      if (!rec)
+        {
+          irqrestore(flags);
+          return -EBUSY;
+        }
+
+      priv->rl_openrec = (FAR char *)rec - priv->rl_buffer;
+      priv->rl_isopen  = true;
+    }
+
+  ((FAR char *)rec)[RAMLOG_HDRSIZE + rec->rr_nbytes] = ch;
+  rec->rr_nbytes++;
+
+  if (ch == '\n' || rec->rr_nbytes >= RAMLOG_LINESIZE)
+    {
+      ramlog_closerec(priv);
+    }
+
+  irqrestore(flags);
+
+  /* Notify all poll/select waiters that there is data to be read */
+
+  ramlog_pollnotify(priv, POLLIN);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ramlog_getarg
+ *
+ * Description:
+ *   Get the next argument of a binary record payload
+ *
+ ****************************************************************************/
+
+static bool ramlog_getarg(FAR const uint8_t *payload, size_t nbytes,
+                          FAR size_t *offset, FAR void *value, size_t size)
+{
+  if (*offset + size > nbytes)
+    {
+      return false;
+    }
+
+  memcpy(value, &payload[*offset], size);
+  *offset += size;
+  return true;
+}
+
+/****************************************************************************
+ * Name: ramlog_format
+ *
+ * Description:
+ *   Format one binary record into the line buffer.  Any part of the format
+ *   for which no arguments were captured is copied unmodified.  The last
+ *   byte of the line buffer is reserved so that a formatted record always
+ *   ends with a newline, even if it was truncated.  Otherwise, the reader
+ *   would see the next record joined onto this one.
+ *
+ ****************************************************************************/
+
+static void ramlog_format(FAR struct ramlog_dev_s *priv,
+                          FAR const struct ramlog_rec_s *rec)
+{
+  FAR const uint8_t *payload = (FAR const uint8_t *)rec + RAMLOG_HDRSIZE;
+  FAR const char *fmt = rec->rr_fmt;
+  FAR const char *end;
+  FAR char *line = priv->rl_line;
+  union ramlog_arg_u value;
+  char spec[24];
+  char str[CONFIG_RAMLOG_BINARY_STRLEN + 1];
+  size_t nbytes = rec->rr_nbytes;
+  size_t offset = 0;
+  size_t nspec;
+  size_t len = 0;
+  uint8_t nstar;
+  uint8_t type;
+  uint8_t slen;
+  int ret;
+
+  /* Text records are just copied */
+
+  if (!fmt)
+    {
+      len = nbytes < RAMLOG_LINESIZE ? nbytes : RAMLOG_LINESIZE;
+      memcpy(line, payload, len);
+      goto done;
+    }
+
+  while (*fmt && len < RAMLOG_LINESIZE - 1)
+    {
+      if (*fmt != '%')
+        {
+          line[len++] = *fmt++;
+          continue;
+        }
+
+      end = ramlog_parsespec(fmt + 1, &nstar, &type);
+
+      /* Build the conversion specification, replacing each '*' with the
+       * value of its captured argument.
+       */
+
+      for (nspec = 0; fmt < end && nspec < sizeof(spec) - 12; fmt++)
+        {
+          if (*fmt == '*')
+            {
+              int width;
+
+              if (!ramlog_getarg(payload, nbytes, &offset, &width,
+                                 sizeof(int)))
+                {
+                  goto verbatim;
+                }
+
+              nspec += sprintf(&spec[nspec], "%d", width);
+            }
+          else
+            {
+              spec[nspec++] = *fmt;
+            }
+        }
+
+      spec[nspec] = '\0';
+      if (fmt < end)
+        {
+          goto verbatim;
+        }
+
+      /* Then format the argument */
+
+      switch (type)
+        {
+          case RAMLOG_ARG_INT:
+            if (!ramlog_getarg(payload, nbytes, &offset, &value.ra_int,
+                               sizeof(int)))
+              {
+                goto verbatim;
+              }
+
+            ret = snprintf(&line[len], RAMLOG_LINESIZE - len, spec,
+                           value.ra_int);
+            break;
+
+          case RAMLOG_ARG_LONG:
+            if (!ramlog_getarg(payload, nbytes, &offset, &value.ra_long,
+                               sizeof(long)))
+              {
+                goto verbatim;
+              }
+
+            ret = snprintf(&line[len], RAMLOG_LINESIZE - len, spec,
+                           value.ra_long);
+            break;
+
+#ifdef CONFIG_HAVE_LONG_LONG
+          case RAMLOG_ARG_LLONG:
+            if (!ramlog_getarg(payload, nbytes, &offset, &value.ra_llong,
+                               sizeof(long long)))
+              {
+                goto verbatim;
+              }
+
+            ret = snprintf(&line[len], RAMLOG_LINESIZE - len, spec,
+                           value.ra_llong);
+            break;
+#endif
+
+          case RAMLOG_ARG_PTR:
+            if (!ramlog_getarg(payload, nbytes, &offset, &value.ra_ptr,
+                               sizeof(FAR void *)))
+              {
+                goto verbatim;
+              }
+
+            ret = snprintf(&line[len], RAMLOG_LINESIZE - len, spec,
+                           value.ra_ptr);
+            break;
+
+          case RAMLOG_ARG_DOUBLE:
+            if (!ramlog_getarg(payload, nbytes, &offset, &value.ra_double,
+                               sizeof(double)))
+              {
+                goto verbatim;
+              }
+
+            ret = snprintf(&line[len], RAMLOG_LINESIZE - len, spec,
+                           value.ra_double);
+            break;
+
+          case RAMLOG_ARG_STRING:
+            if (!ramlog_getarg(payload, nbytes, &offset, &slen, 1) ||
+                !ramlog_getarg(payload, nbytes, &offset, str, slen))
+              {
+                goto verbatim;
+              }
+
+            str[slen] = '\0';
+            ret = snprintf(&line[len], RAMLOG_LINESIZE - len, spec, str);
+            break;
+
+          default:
+
+            /* "%%" is a literal '%' */
+
+            if (end[-1] == '%')
+              {
+                line[len++] = '%';
+              }
+
+            continue;
+        }
+
+      /* snprintf() returns the untruncated length */
+
+      if (ret > 0)
+        {
+          len += ret;
+          if (len > RAMLOG_LINESIZE - 1)
+            {
+              len = RAMLOG_LINESIZE - 1;
+            }
+        }
+    }
+
+  goto newline;
+
+verbatim:
+
+  /* Out of arguments.  Copy the remainder of the format string */
+
+  while (*fmt && len < RAMLOG_LINESIZE - 1)
+    {
+      line[len++] = *fmt++;
+    }
+
+newline:
+
+  /* Terminate the line, using the reserved last byte if necessary */
+
+  if (len == 0 || line[len - 1] != '\n')
+    {
+      line[len++] = '\n';
+    }
+
+done:
+  priv->rl_linepos = 0;
+  priv->rl_linelen = len;
+}
+
+/****************************************************************************
+ * Name: ramlog_nextline
+ *
+ * Description:
+ *   Format the oldest committed record into the line buffer and remove it
+ *   from the RAM log.  Returns false if there is no committed record.
+ *   Called with rl_exclsem held.
+ *
+ ****************************************************************************/
+
+static bool ramlog_nextline(FAR struct ramlog_dev_s *priv)
+{
+  FAR struct ramlog_rec_s *rec;
+  irqstate_t flags;
+  uint16_t ndropped;
+  size_t tail;
+
+  for (;;)
+    {
+      tail = priv->rl_tail;
+      if (tail == priv->rl_head)
+        {
+          /* The RAM log is empty.  Report any records that were lost
+           * because the RAM log was full.
+           */
+
+          flags             = irqsave();
+          ndropped          = priv->rl_ndropped;
+          priv->rl_ndropped = 0;
+          irqrestore(flags);
+
+          if (ndropped == 0)
+            {
+              return false;
+            }
+
+          priv->rl_linepos = 0;
+          priv->rl_linelen = snprintf(priv->rl_line, RAMLOG_LINESIZE,
+                                      "[%u records dropped]\n", ndropped);
+          return true;
+        }
+
+      rec = (FAR struct ramlog_rec_s *)&priv->rl_buffer[tail];
+      if (rec->rr_size == 0)
+        {
+          /* Wrap around to the beginning of the buffer */
+
+          priv->rl_tail = 0;
+          continue;
+        }
+
+      if (!rec->rr_committed)
+        {
+          /* If this is the open text record, then close it so that the
+           * partial line can be read.  Further characters will go into a
+           * new record.
+           */
+
+          flags = irqsave();
+          if (priv->rl_isopen && priv->rl_openrec == tail)
+            {
+              ramlog_closerec(priv);
+            }
+
+          irqrestore(flags);
+
+          if (!rec->rr_committed)
+            {
+              /* The record is still being written */
+
+              return false;
+            }
+        }
+
+      ramlog_format(priv, rec);
+
+      tail += rec->rr_size;
+      if (tail >= priv->rl_bufsize)
+        {
+          tail = 0;
+        }
+
+      priv->rl_tail = tail;
+      return true;
+    }
+}
+#endif /* CONFIG_RAMLOG_BINARY */
+
 /****************************************************************************
  * Name: ramlog_addchar
  ****************************************************************************/
 
+#ifndef CONFIG_RAMLOG_BINARY
 static int ramlog_addchar(FAR struct ramlog_dev_s *priv, char ch)
 {
   irqstate_t flags;
@@ -235,6 +932,7 @@ static int ramlog_addchar(FAR struct ramlog_dev_s *priv, char ch)
   irqrestore(flags);
   return OK;
 }
+#endif
 
 /****************************************************************************
  * Name: ramlog_read
@@ -267,6 +965,51 @@ static ssize_t ramlog_read(FAR struct file *filep, FAR char *buffer, size_t len)
       return ret;
     }
 
+#ifdef CONFIG_RAMLOG_BINARY
+  /* Return formatted records until the user buffer is full or until there
+   * are no more committed records.
+   */
+
+  for (nread = 0; nread < len; )
+    {
+      if (priv->rl_linepos >= priv->rl_linelen)
+        {
+          if (!ramlog_nextline(priv))
+            {
+              break;
+            }
+
+          continue;
+        }
+
+      ch = priv->rl_line[priv->rl_linepos];
+
+#ifdef CONFIG_RAMLOG_CRLF
+      /* Drop carriage returns and pre-pend a carriage return before every
+       * linefeed.
+       */
+
+      if (ch == '\r')
+        {
+          priv->rl_linepos++;
+          continue;
+        }
+
+      if (ch == '\n' && !priv->rl_crdone)
+        {
+          buffer[nread++] = '\r';
+          priv->rl_crdone = true;
+          continue;
+        }
+
+      priv->rl_crdone = false;
+#endif
+
+      buffer[nread++] = ch;
+      priv->rl_linepos++;
+    }
+
+#else
   /* Loop until something is read */
 
   for (nread = 0; nread < len; )
@@ -386,6 +1129,7 @@ static ssize_t ramlog_read(FAR struct file *filep, FAR char *buffer, size_t len)
           nread++;
         }
     }
+#endif /* CONFIG_RAMLOG_BINARY */
 
   /* Relinquish the mutual exclusion semaphore */
 
@@ -418,7 +1162,11 @@ static ssize_t ramlog_write(FAR struct file *filep, FAR const char *buffer, size
   struct inode *inode = filep->f_inode;
   struct ramlog_dev_s *priv;
   ssize_t nwritten;
+#ifdef CONFIG_RAMLOG_BINARY
+  size_t nbytes;
+#else
   char ch;
+#endif
   int ret;
 
   /* Some sanity checking */
@@ -426,6 +1174,28 @@ static ssize_t ramlog_write(FAR struct file *filep, FAR const char *buffer, size
   DEBUGASSERT(inode && inode->i_private);
   priv = inode->i_private;
 
+#ifdef CONFIG_RAMLOG_BINARY
+  /* Add the data as text records.  Carriage returns are handled when the
+   * RAM log is read.  Data that does not fit is dropped on the floor.
+   */
+
+  for (nwritten = 0; nwritten < len; nwritten += nbytes)
+    {
+      nbytes = len - nwritten;
+      if (nbytes > RAMLOG_LINESIZE)
+        {
+          nbytes = RAMLOG_LINESIZE;
+        }
+
+      ret = ramlog_addrec(priv, NULL, &buffer[nwritten], nbytes);
+      if (ret < 0)
+        {
+          break;
+        }
+    }
+
+#else
+
  /* Loop until all of the bytes have been written.  This function may be
   * called from an interrupt handler!  Semaphores cannot be used!
   *
@@ -508,6 +1278,7 @@ static ssize_t ramlog_write(FAR struct file *filep, FAR const char *buffer, size
       irqrestore(flags);
     }
 #endif
+#endif /* CONFIG_RAMLOG_BINARY */
 
   /* We always have to return the number of bytes requested and NOT the
    * number of bytes that were actually written.  Otherwise, callers
@@ -593,7 +1364,12 @@ int ramlog_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup)
 
       /* Check if the receive buffer is empty */
 
+#ifdef CONFIG_RAMLOG_BINARY
+      if (priv->rl_head != priv->rl_tail ||
+          priv->rl_linepos < priv->rl_linelen)
+#else
       if (priv->rl_head != priv->rl_tail)
+#endif
        {
          eventset |= POLLIN;
        }
@@ -738,6 +1514,17 @@ int syslog_putc(int ch)
   FAR struct ramlog_dev_s *priv = &g_sysdev;
   int ret;
 
+#ifdef CONFIG_RAMLOG_BINARY
+  /* Add the character to the open text record.  Carriage returns are
+   * handled when the RAM log is read.
+   */
+
+  ret = ramlog_addtext(priv, ch);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+#else
 #ifdef CONFIG_RAMLOG_CRLF
   /* Ignore carriage returns.  But return success. */
 
@@ -763,12 +1550,15 @@ int syslog_putc(int ch)
   /* Add the character to the RAMLOG */
 
   ret = ramlog_addchar(priv, ch);
-  if (ret >= 0)
+  if (ret < 0)
     {
-      /* Return the character added on success */
-
-      return ch;
+      goto errout;
     }
+#endif
+
+  /* Return the character added on success */
+
+  return ch;
 
   /* On a failure, we need to return EOF and set the errno so that
    * work like all other putc-like functions.
@@ -780,4 +1570,134 @@ errout:
 }
 #endif
 
+/****************************************************************************
+ * Name: ramlog_vsyslog
+ *
+ * Description:
+ *   Add a message to the binary RAM log.  Only the format string pointer
+ *   and the raw argument values are saved; the message is formatted when
+ *   the RAM log is read.  Strings are copied (up to
+ *   CONFIG_RAMLOG_BINARY_STRLEN characters).  The format string itself must
+ *   remain valid until the RAM log is read.  This function may be called
+ *   from an interrupt handler.
+ *
+ *   Returns zero (OK) on success.  If the RAM log is full, the message is
+ *   dropped and ERROR is returned with the errno value set to EBUSY.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_RAMLOG_BINARY
+int ramlog_vsyslog(FAR const char *fmt, va_list ap)
+{
+  uint8_t args[CONFIG_RAMLOG_BINARY_ARGSIZE];
+  union ramlog_arg_u value;
+  FAR const char *ptr;
+  FAR const char *str;
+  size_t nbytes = 0;
+  size_t size;
+  size_t slen;
+  uint8_t nstar;
+  uint8_t type;
+  int ret;
+
+  /* Capture the arguments of each conversion, stopping if there is no more
+   * space for them.
+   */
+
+  for (ptr = fmt; *ptr; )
+    {
+      if (*ptr++ != '%')
+        {
+          continue;
+        }
+
+      ptr = ramlog_parsespec(ptr, &nstar, &type);
+
+      for (; nstar > 0; nstar--)
+        {
+          value.ra_int = va_arg(ap, int);
+          if (nbytes + sizeof(int) > CONFIG_RAMLOG_BINARY_ARGSIZE)
+            {
+              goto done;
+            }
+
+          memcpy(&args[nbytes], &value.ra_int, sizeof(int));
+          nbytes += sizeof(int);
+        }
+
+      switch (type)
+        {
+          case RAMLOG_ARG_INT:
+            value.ra_int = va_arg(ap, int);
+            size = sizeof(int);
+            break;
+
+          case RAMLOG_ARG_LONG:
+            value.ra_long = va_arg(ap, long);
+            size = sizeof(long);
+            break;
+
+#ifdef CONFIG_HAVE_LONG_LONG
+          case RAMLOG_ARG_LLONG:
+            value.ra_llong = va_arg(ap, long long);
+            size = sizeof(long long);
+            break;
+#endif
+
+          case RAMLOG_ARG_PTR:
+            value.ra_ptr = va_arg(ap, FAR void *);
+            size = sizeof(FAR void *);
+            break;
+
+          case RAMLOG_ARG_DOUBLE:
+            value.ra_double = va_arg(ap, double);
+            size = sizeof(double);
+            break;
+
+          case RAMLOG_ARG_STRING:
+            str = va_arg(ap, FAR const char *);
+            if (!str)
+              {
+                str = "(null)";
+              }
+
+            for (slen = 0;
+                 str[slen] && slen < CONFIG_RAMLOG_BINARY_STRLEN;
+                 slen++);
+
+            if (nbytes + 1 + slen > CONFIG_RAMLOG_BINARY_ARGSIZE)
+              {
+                goto done;
+              }
+
+            args[nbytes++] = (uint8_t)slen;
+            memcpy(&args[nbytes], str, slen);
+            nbytes += slen;
+            continue;
+
+          default:
+            continue;
+        }
+
+      if (nbytes + size > CONFIG_RAMLOG_BINARY_ARGSIZE)
+        {
+          goto done;
+        }
+
+      memcpy(&args[nbytes], &value, size);
+      nbytes += size;
+    }
+
+done:
+  ret = ramlog_addrec(&g_sysdev, fmt, args, nbytes);
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      return ERROR;
+    }
+
+  return OK;
+}
+#endif
+
 #endif /* CONFIG_RAMLOG */
@@ -140,6 +140,10 @@ static void   usbmsc_disconnect(FAR struct usbdevclass_driver_s *driver,
 /* Initialization/Uninitialization ******************************************/
 
 static void   usbmsc_lununinitialize(struct usbmsc_lun_s *lun);
+#ifdef CONFIG_DRVR_BLKQUEUE
+static ssize_t usbmsc_blkread(FAR void *dev, FAR uint8_t *buffer,
+                              off_t startblock, size_t nblocks);
+#endif
 #ifdef CONFIG_USBMSC_COMPOSITE
 static int    usbmsc_exportluns(FAR void *handle);
 #endif
@@ -899,6 +903,15 @@ static void usbmsc_lununinitialize(struct usbmsc_lun_s *lun)
 
   if (lun->inode)
     {
+#ifdef CONFIG_DRVR_BLKQUEUE
+      /* Discard any queued read-ahead and wait for one that is in
+       * progress.  After this, the block I/O daemon no longer references
+       * the LUN, the I/O buffer or the driver state.
+       */
+
+      blkq_uninitialize(&lun->blkq);
+#endif
+
       /* Close the block driver */
 
       (void)close_blockdriver(lun->inode);
@@ -907,6 +920,25 @@ static void usbmsc_lununinitialize(struct usbmsc_lun_s *lun)
   memset(lun, 0, sizeof(struct usbmsc_lun_s *));
 }
 
+/****************************************************************************
+ * Name: usbmsc_blkread
+ *
+ * Description:
+ *   Request queue read callout.  Called on the block I/O daemon thread to
+ *   read ahead of the host.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_BLKQUEUE
+static ssize_t usbmsc_blkread(FAR void *dev, FAR uint8_t *buffer,
+                              off_t startblock, size_t nblocks)
+{
+  FAR struct usbmsc_lun_s *lun = (FAR struct usbmsc_lun_s *)dev;
+
+  return USBMSC_DRVR_READ(lun, buffer, startblock, nblocks);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -1489,7 +1521,7 @@ int usbmsc_bindlun(FAR void *handle, FAR const char *drvrpath,
 
   if (!priv->iobuffer)
     {
-      priv->iobuffer = (uint8_t*)kmm_malloc(geo.geo_sectorsize);
+      priv->iobuffer = (uint8_t*)kmm_malloc(USBMSC_IOBUFFER_SIZE(geo.geo_sectorsize));
       if (!priv->iobuffer)
         {
           usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_ALLOCIOBUFFER), geo.geo_sectorsize);
@@ -1501,7 +1533,8 @@ int usbmsc_bindlun(FAR void *handle, FAR const char *drvrpath,
   else if (priv->iosize < geo.geo_sectorsize)
     {
       void *tmp;
-      tmp = (uint8_t*)kmm_realloc(priv->iobuffer, geo.geo_sectorsize);
+      tmp = (uint8_t*)kmm_realloc(priv->iobuffer,
+                                  USBMSC_IOBUFFER_SIZE(geo.geo_sectorsize));
       if (!tmp)
         {
           usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_REALLOCIOBUFFER), geo.geo_sectorsize);
@@ -1524,6 +1557,24 @@ int usbmsc_bindlun(FAR void *handle, FAR const char *drvrpath,
       lun->readonly = true;
     }
 
+#ifdef CONFIG_DRVR_BLKQUEUE
+  /* Initialize the queue used to read ahead of the host */
+
+  lun->blkq.blocksize = geo.geo_sectorsize;
+  lun->blkq.maxblocks = 0;
+  lun->blkq.dev       = lun;
+  lun->blkq.read      = usbmsc_blkread;
+  lun->blkq.write     = NULL;
+
+  ret = blkq_initialize(&lun->blkq);
+  if (ret < 0)
+    {
+      close_blockdriver(inode);
+      lun->inode = NULL;
+      return ret;
+    }
+#endif
+
   return OK;
 }
 
@@ -1585,6 +1636,19 @@ int usbmsc_unbindlun(FAR void *handle, unsigned int lunno)
   else
 #endif
    {
+#ifdef CONFIG_DRVR_BLKQUEUE
+      /* If a read-ahead is still queued on this LUN, remove it now.
+       * Otherwise it would be discarded without completing and
+       * blkpending would never be cleared.
+       */
+
+      if (blkq_cancel(&lun->blkq, &priv->blkreq) == OK)
+        {
+          priv->blkpending = false;
+          priv->blkvalid   = false;
+        }
+#endif
+
       /* Close the block driver */
 
      usbmsc_lununinitialize(lun);
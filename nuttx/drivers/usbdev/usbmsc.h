@@ -51,6 +51,7 @@
 #include <semaphore.h>
 
 #include <nuttx/fs/fs.h>
+#include <nuttx/blkqueue.h>
 #include <nuttx/usb/storage.h>
 #include <nuttx/usb/usbdev.h>
 
@@ -276,6 +277,7 @@
 #define USBMSC_EVENT_CFGCHANGE        (1 << 6) /* USB setup configuration change received */
 #define USBMSC_EVENT_IFCHANGE         (1 << 7) /* USB setup interface change received */
 #define USBMSC_EVENT_ABORTBULKOUT     (1 << 8) /* SCSI receive failure */
+#define USBMSC_EVENT_BLKCOMPLETE      (1 << 9) /* A block read-ahead has completed */
 
 /* SCSI command flags (passed to usbmsc_setupcmd()) */
 
@@ -404,6 +406,14 @@
 #define USBMSC_DRVR_WRITE(l,b,s,n) ((l)->inode->u.i_bops->write((l)->inode,b,s,n))
 #define USBMSC_DRVR_GEOMETRY(l,g) ((l)->inode->u.i_bops->geometry((l)->inode,g))
 
+/* Size of the I/O buffer for a given sector size */
+
+#ifdef CONFIG_DRVR_BLKQUEUE
+#  define USBMSC_IOBUFFER_SIZE(s) (2 * (s))
+#else
+#  define USBMSC_IOBUFFER_SIZE(s) (s)
+#endif
+
 /* Everpresent MIN/MAX macros ***********************************************/
 
 #ifndef MIN
@@ -451,6 +461,9 @@ struct usbmsc_lun_s
   uint32_t         uad;               /* Unit needs attention data */
   off_t            startsector;       /* Sector offset to start of partition */
   size_t           nsectors;          /* Number of sectors in the partition */
+#ifdef CONFIG_DRVR_BLKQUEUE
+  struct blkqueue_s blkq;             /* Asynchronous request queue */
+#endif
 };
 
 /* Describes the overall state of one instance of the driver */
@@ -505,6 +518,17 @@ struct usbmsc_dev_s
   uint32_t          residue;          /* Untransferred amount reported in the CSW */
   uint8_t          *iobuffer;         /* Buffer for data transfers */
 
+#ifdef CONFIG_DRVR_BLKQUEUE
+  /* Sector read-ahead.  iobuffer[] holds two sectors:  One being sent to
+   * the host while the following sector is read from the media.
+   */
+
+  uint8_t          *sectbuffer;       /* Sector being sent (within iobuffer[]) */
+  volatile bool     blkpending;       /* A read-ahead is in progress */
+  volatile bool     blkvalid;         /* The read-ahead has completed */
+  struct blkreq_s   blkreq;           /* The read-ahead request */
+#endif
+
   /* Write request list */
 
   struct sq_queue_s wrreqlist;        /* List of empty write request containers */
@@ -178,6 +178,14 @@ static int    usbmsc_cmdwritestate(FAR struct usbmsc_dev_s *priv);
 static int    usbmsc_cmdfinishstate(FAR struct usbmsc_dev_s *priv);
 static int    usbmsc_cmdstatusstate(FAR struct usbmsc_dev_s *priv);
 
+/* Sector read-ahead */
+
+#ifdef CONFIG_DRVR_BLKQUEUE
+static void   usbmsc_blkcomplete(FAR struct blkreq_s *req);
+static void   usbmsc_readahead(FAR struct usbmsc_dev_s *priv);
+static ssize_t usbmsc_nextsector(FAR struct usbmsc_dev_s *priv);
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -401,6 +409,95 @@ static void usbmsc_scsi_wait(FAR struct usbmsc_dev_s *priv)
   irqrestore(flags);
 }
 
+/****************************************************************************
+ * Name: usbmsc_blkcomplete
+ *
+ * Description:
+ *   Called on the block I/O daemon thread when a sector read-ahead
+ *   completes.  Wake up the SCSI worker thread.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_BLKQUEUE
+static void usbmsc_blkcomplete(FAR struct blkreq_s *req)
+{
+  FAR struct usbmsc_dev_s *priv = (FAR struct usbmsc_dev_s *)req->priv;
+  irqstate_t flags;
+
+  flags = irqsave();
+  priv->blkpending  = false;
+  priv->blkvalid    = true;
+  priv->theventset |= USBMSC_EVENT_BLKCOMPLETE;
+  irqrestore(flags);
+
+  usbmsc_scsi_signal(priv);
+}
+#endif
+
+/****************************************************************************
+ * Name: usbmsc_readahead
+ *
+ * Description:
+ *   Start reading priv->sector into the half of iobuffer[] that is not
+ *   being sent to the host.  If the request cannot be queued, the sector
+ *   will simply be read synchronously when it is needed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_BLKQUEUE
+static void usbmsc_readahead(FAR struct usbmsc_dev_s *priv)
+{
+  FAR struct blkreq_s *req = &priv->blkreq;
+
+  req->op         = BLKREQ_READ;
+  req->buffer     = priv->sectbuffer == priv->iobuffer ?
+                    priv->iobuffer + priv->iosize : priv->iobuffer;
+  req->startblock = priv->sector;
+  req->nblocks    = 1;
+  req->callback   = usbmsc_blkcomplete;
+  req->priv       = priv;
+
+  priv->blkvalid   = false;
+  priv->blkpending = true;
+
+  if (blkq_submit(&priv->lun->blkq, req) < 0)
+    {
+      priv->blkpending = false;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: usbmsc_nextsector
+ *
+ * Description:
+ *   Get the next sector to be sent to the host, priv->sector, into
+ *   priv->sectbuffer.  Use the read-ahead data if it is available.
+ *   Otherwise, read the sector now.  Must not be called while a read-ahead
+ *   is in progress.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_BLKQUEUE
+static ssize_t usbmsc_nextsector(FAR struct usbmsc_dev_s *priv)
+{
+  FAR struct blkreq_s *req = &priv->blkreq;
+
+  DEBUGASSERT(!priv->blkpending);
+
+  if (priv->blkvalid && req->startblock == priv->sector)
+    {
+      priv->blkvalid   = false;
+      priv->sectbuffer = req->buffer;
+      return req->result;
+    }
+
+  priv->blkvalid   = false;
+  priv->sectbuffer = priv->iobuffer;
+  return USBMSC_DRVR_READ(priv->lun, priv->sectbuffer, priv->sector, 1);
+}
+#endif
+
 /****************************************************************************
  * Name: usbmsc_cmdtestunitready
  *
@@ -1628,6 +1725,20 @@ static int usbmsc_idlestate(FAR struct usbmsc_dev_s *priv)
   irqstate_t flags;
   int ret = -EINVAL;
 
+#ifdef CONFIG_DRVR_BLKQUEUE
+  /* A read-ahead for the previous command may still be using iobuffer[].
+   * If so, remain in the IDLE state until it completes.  In any event,
+   * the read-ahead data must not be used by the next command.
+   */
+
+  if (priv->blkpending)
+    {
+      return -EBUSY;
+    }
+
+  priv->blkvalid = false;
+#endif
+
   /* Take a request from the rdreqlist */
 
   flags = irqsave();
@@ -2114,9 +2225,24 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
 
       if (priv->nsectbytes <= 0)
         {
+#ifdef CONFIG_DRVR_BLKQUEUE
+          /* Yes.. If the next sector is still being read ahead, then just
+           * return an error.  This will cause us to remain in the CMDREAD
+           * state.  When the read completes, the worker thread will be
+           * awakened in the USBMSC_STATE_CMDREAD and we will be called again.
+           */
+
+          if (priv->blkpending)
+            {
+              return -EBUSY;
+            }
+
+          nread = usbmsc_nextsector(priv);
+#else
           /* Yes.. read the next sector */
 
           nread = USBMSC_DRVR_READ(lun, priv->iobuffer, priv->sector, 1);
+#endif
           if (nread < 0)
             {
               usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDREADREADFAIL), -nread);
@@ -2128,6 +2254,15 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
           priv->nsectbytes = lun->sectorsize;
           priv->u.xfrlen--;
           priv->sector++;
+
+#ifdef CONFIG_DRVR_BLKQUEUE
+          /* Read the following sector while this one is sent to the host */
+
+          if (priv->u.xfrlen > 0)
+            {
+              usbmsc_readahead(priv);
+            }
+#endif
         }
 
       /* Check if there is a request in the wrreqlist that we will be able to
@@ -2155,7 +2290,11 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
        * all of the data available in the sector buffer.
        */
 
+#ifdef CONFIG_DRVR_BLKQUEUE
+      src    = &priv->sectbuffer[lun->sectorsize - priv->nsectbytes];
+#else
       src    = &priv->iobuffer[lun->sectorsize - priv->nsectbytes];
+#endif
       dest   = &req->buf[priv->nreqbytes];
 
       nbytes = MIN(CONFIG_USBMSC_BULKINREQLEN - priv->nreqbytes, priv->nsectbytes);
@@ -60,6 +60,7 @@
 
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/fs/fat.h>
 #include <nuttx/fs/dirent.h>
 
@@ -251,6 +252,7 @@ static int fat_open(FAR struct file *filep, const char *relpath,
         {
           /* Truncate the file to zero length */
 
+          fs->fs_generation++;
           ret = fat_dirtruncate(fs, &dirinfo);
           if (ret < 0)
             {
@@ -718,6 +720,10 @@ static ssize_t fat_write(FAR struct file *filep, const char *buffer,
       goto errout_with_semaphore;
     }
 
+  /* Any copy of the file held by rammap() is now stale */
+
+  fs->fs_generation++;
+
   /* Get the first sector to write to. */
 
   if (!ff->ff_currentsector)
@@ -1179,6 +1185,7 @@ static int fat_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 {
   struct inode         *inode;
   struct fat_mountpt_s *fs;
+  struct fat_file_s    *ff;
   int                   ret;
 
   /* Sanity checks */
@@ -1187,6 +1194,7 @@ static int fat_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
   /* Recover our private data from the struct file instance */
 
+  ff    = filep->f_priv;
   inode = filep->f_inode;
   fs    = inode->i_private;
 
@@ -1202,6 +1210,24 @@ static int fat_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
       return ret;
     }
 
+  /* The location of the directory entry identifies the file.  Directory
+   * entries are reused after a file is deleted, so the identity is only
+   * valid together with the volume generation count.
+   */
+
+  if (cmd == FIOC_FILEID && arg != 0)
+    {
+      FAR struct fs_fileid_s *fileid =
+        (FAR struct fs_fileid_s *)((uintptr_t)arg);
+
+      fileid->fi_id         = ff->ff_dirsector * DIRSEC_NDIRS(fs) +
+                              ff->ff_dirindex;
+      fileid->fi_generation = fs->fs_generation;
+
+      fat_semgive(fs);
+      return OK;
+    }
+
   /* ioctl calls are just passed through to the contained block driver */
 
   fat_semgive(fs);
@@ -1301,6 +1327,19 @@ static int fat_sync(FAR struct file *filep)
       ret          = fat_updatefsinfo(fs);
     }
 
+  /* Ask the block driver to write back anything it is still caching.
+   * Drivers without a cache just reject the command.
+   */
+
+  if (ret >= 0)
+    {
+      struct inode *blkdriver = fs->fs_blkdriver;
+      if (blkdriver && blkdriver->u.i_bops && blkdriver->u.i_bops->ioctl)
+        {
+          (void)blkdriver->u.i_bops->ioctl(blkdriver, BIOC_FLUSH, 0);
+        }
+    }
+
 errout_with_semaphore:
   fat_semgive(fs);
   return ret;
@@ -1944,9 +1983,12 @@ static int fat_unlink(struct inode *mountpt, const char *relpath)
        * open reference to the file is closed.
        */
 
-      /* Remove the file */
+      /* Remove the file.  The directory entry may then be reused by a
+       * different file.
+       */
       /* TODO: Need to defer deleting cluster chain if the file is open. */
 
+      fs->fs_generation++;
       ret = fat_remove(fs, relpath, false);
     }
 
@@ -2268,6 +2310,10 @@ int fat_rename(struct inode *mountpt, const char *oldrelpath,
       goto errout_with_semaphore;
     }
 
+  /* The old directory entry will be freed and may be reused */
+
+  fs->fs_generation++;
+
   /* Save the information that will need to recover the directory sector and
    * directory entry offset to the old directory.
    *
@@ -733,6 +733,7 @@ struct fat_mountpt_s
   uint32_t fs_fattotsec;           /* MBR: Total count of sectors on the volume */
   uint32_t fs_fsifreecount;        /* FSI: Last free cluster count on volume */
   uint32_t fs_fsinextfree;         /* FSI: Cluster number of 1st free cluster */
+  uint32_t fs_generation;          /* Incremented when any file is modified or removed */
   uint16_t fs_fatresvdseccount;    /* MBR: The total number of reserved sectors */
   uint16_t fs_rootentcnt;          /* MBR: Count of 32-bit root directory entries */
   bool     fs_mounted;             /* true: The file system is ready */
@@ -39,12 +39,14 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
 #include <stdarg.h>
 #include <fcntl.h>
 #include <errno.h>
 #include <assert.h>
 
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/net/net.h>
 #include <nuttx/sched.h>
 
@@ -200,6 +202,49 @@ static inline int file_vfcntl(int fd, int cmd, va_list ap)
         err = ENOSYS; /* Not implemented */
         break;
 
+      case F_GETPIPE_SZ:
+        /* Return the size of the buffer of the pipe or FIFO referred to by fd
+         * (linux).
+         */
+
+      case F_SETPIPE_SZ:
+        /* Change the size of the buffer of the pipe or FIFO referred to by fd
+         * to the third argument, arg, taken as type int, and return the new
+         * size (linux).
+         */
+
+        {
+          FAR struct inode *inode = filep->f_inode;
+          int size = 0;
+
+          if (!inode->u.i_ops || !inode->u.i_ops->ioctl)
+            {
+              err = EBADF; /* Only valid on pipe and FIFO descriptors */
+              break;
+            }
+
+          if (cmd == F_SETPIPE_SZ)
+            {
+              ret = inode->u.i_ops->ioctl(filep, PIPEIOC_SETSIZE,
+                                          (unsigned long)va_arg(ap, int));
+            }
+
+          if (ret >= 0)
+            {
+              ret = inode->u.i_ops->ioctl(filep, PIPEIOC_GETSIZE,
+                                          (unsigned long)((uintptr_t)&size));
+            }
+
+          if (ret < 0)
+            {
+              err = ret == -ENOTTY ? EBADF : -ret;
+              break;
+            }
+
+          ret = size;
+        }
+        break;
+
       default:
         err = EINVAL;
         break;
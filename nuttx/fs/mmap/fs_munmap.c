@@ -81,7 +81,8 @@
  *        only file system that meets this requirement.
  *     b. The underlying block driver supports the BIOC_XIPBASE ioctl
  *        command that maps the underlying media to a randomly accessible
- *        address. At  present, only the RAM/ROM disk driver does this.
+ *        address.  The RAM/ROM disk driver does this as does the FTL
+ *        driver on top of memory-mapped MTD devices and partitions.
  *
  *     munmap() is still not required in this first case.  In this first
  *     The mapped address is a static address in the MCUs address space
@@ -91,9 +92,10 @@
  *        #define munmap(start, length)
  *
  *   2. If CONFIG_FS_RAMMAP is defined in the configuration, then mmap() will
- *      support simulation of memory mapped files by copying files whole
- *      into RAM.  munmap() is required in this case to free the allocated
- *      memory holding the shared copy of the file.
+ *      support simulation of memory mapped files by copying files into RAM.
+ *      munmap() is required in this case to release the reference to the
+ *      shared copy of the file.  The memory is freed when the last
+ *      reference is released.
  *
  * Parameters:
  *   start   The start address of the mapping to delete.  For this
@@ -130,10 +132,10 @@ int munmap(FAR void *start, size_t length)
 
   for (prev = NULL, curr = g_rammaps.head; curr; prev = curr, curr = curr->flink)
     {
-      /* Does this region include any part of the specified range? */
+      /* Does this region include the start of the specified range? */
 
-      if ((uintptr_t)start < (uintptr_t)curr->addr + curr->length &&
-          (uintptr_t)start + length >= (uintptr_t)curr->addr)
+      if ((uintptr_t)start >= (uintptr_t)curr->addr &&
+          (uintptr_t)start < (uintptr_t)curr->addr + curr->length)
         {
           break;
         }
@@ -148,32 +150,37 @@ int munmap(FAR void *start, size_t length)
       goto errout_with_semaphore;
     }
 
-  /* Get the offset from the beginning of the region and the actual number
-   * of bytes to "unmap".  All mappings must extend to the end of the region.
-   * There is no support for free a block of memory but leaving a block of
-   * memory at the end.  This is a consequence of using kumm_realloc() to
-   * simulate the unmapping.
-   */
+  /* Is the region shared with other mappings? */
 
-  offset = start - curr->addr;
-  if (offset + length < curr->length)
+  if (curr->crefs > 1)
     {
-      fdbg("Cannot umap without unmapping to the end\n");
-      err = ENOSYS;
-      goto errout_with_semaphore;
+      /* Yes.. just drop this reference.  The region persists until the
+       * last user unmaps it.
+       */
+
+      curr->crefs--;
+      sem_post(&g_rammaps.exclsem);
+      return OK;
     }
 
-  /* Okay.. the region is beging umapped to the end.  Make sure the length
-   * indicates that.
+  /* Get the offset from the beginning of the region.  If a tail of the
+   * region is unmapped, the region is truncated.  This is a consequence of
+   * using kumm_realloc() to simulate the unmapping.  Unmapping any other
+   * range releases the whole region.
    */
 
-  length = curr->length - offset;
-
-  /* Are we unmapping the entire region (offset == 0)? */
+  offset = (uintptr_t)start - (uintptr_t)curr->addr;
+  if (offset > 0 && offset + length >= curr->length)
+    {
+      newaddr = kumm_realloc(curr, sizeof(struct fs_rammap_s) + offset);
+      DEBUGASSERT(newaddr == (FAR void *)curr);
+      UNUSED(newaddr);
 
-  if (length >= curr->length)
+      curr->length = offset;
+    }
+  else
     {
-      /* Yes.. remove the mapping from the list */
+      /* Remove the mapping from the list */
 
       if (prev)
         {
@@ -184,20 +191,16 @@ int munmap(FAR void *start, size_t length)
           g_rammaps.head = curr->flink;
         }
 
-      /* Then free the region */
+      /* Release the reference on the inode that provided the file */
 
-      kumm_free(curr);
-    }
+      if (curr->inode)
+        {
+          inode_release(curr->inode);
+        }
 
-  /* No.. We have been asked to "unmap' only a portion of the memory
-   * (offset > 0).
-   */
+      /* Then free the region */
 
-  else
-    {
-      newaddr = kumm_realloc(curr->addr, sizeof(struct fs_rammap_s) + length);
-      DEBUGASSERT(newaddr == (FAR void*)(curr->addr));
-      curr->length = length;
+      kumm_free(curr);
     }
 
   sem_post(&g_rammaps.exclsem);
@@ -42,12 +42,16 @@
 #include <sys/types.h>
 #include <sys/mman.h>
 
+#include <stdint.h>
 #include <string.h>
 #include <unistd.h>
 #include <errno.h>
+#include <assert.h>
 #include <debug.h>
 
+#include <nuttx/sched.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/fs/ioctl.h>
 
 #include "fs_internal.h"
 #include "fs_rammap.h"
@@ -62,6 +66,93 @@
 
 struct fs_allmaps_s g_rammaps;
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: rammap_fileid
+ *
+ * Description:
+ *   Determine the identity of the file open on 'filep'.  Only files in a
+ *   mounted volume whose file system provides the FIOC_FILEID ioctl command
+ *   can be identified.  Character and block drivers have no notion of file
+ *   contents that persist between opens, so their mappings are never
+ *   shared.
+ *
+ * Returned Value:
+ *   The mountpoint inode that provides the file or NULL if the file cannot
+ *   be identified (in which case the mapped region will not be shared).
+ *
+ ****************************************************************************/
+
+static FAR struct inode *rammap_fileid(FAR struct file *filep,
+                                       FAR struct fs_fileid_s *fileid)
+{
+#ifndef CONFIG_DISABLE_MOUNTPOINT
+  FAR struct inode *inode = filep->f_inode;
+  int ret;
+#endif
+
+  fileid->fi_id         = 0;
+  fileid->fi_generation = 0;
+
+#ifndef CONFIG_DISABLE_MOUNTPOINT
+  if (INODE_IS_MOUNTPT(inode) && inode->u.i_mops && inode->u.i_mops->ioctl)
+    {
+      /* Call the file system ioctl method directly so that an unsupported
+       * command does not disturb the errno value.
+       */
+
+      ret = inode->u.i_mops->ioctl(filep, FIOC_FILEID,
+                                   (unsigned long)((uintptr_t)fileid));
+      if (ret < 0)
+        {
+          fvdbg("FIOC_FILEID not supported: %d\n", ret);
+        }
+      else if (fileid->fi_id != 0)
+        {
+          return inode;
+        }
+    }
+#endif
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: rammap_find
+ *
+ * Description:
+ *   Search for an existing region that contains the requested range of the
+ *   file.  The caller must hold g_rammaps.exclsem.
+ *
+ ****************************************************************************/
+
+static FAR struct fs_rammap_s *
+rammap_find(FAR struct inode *inode, FAR const struct fs_fileid_s *fileid,
+            size_t length, off_t offset)
+{
+  FAR struct fs_rammap_s *curr;
+
+  /* A region whose generation differs was loaded before the file was
+   * modified or removed and must not be handed out again.
+   */
+
+  for (curr = g_rammaps.head; curr; curr = curr->flink)
+    {
+      if (curr->inode == inode && curr->fileid == fileid->fi_id &&
+          curr->generation == fileid->fi_generation &&
+          curr->offset <= offset &&
+          offset + length <= curr->offset + curr->length)
+        {
+          return curr;
+        }
+    }
+
+  return NULL;
+}
+
 /****************************************************************************
  * Global Functions
  ****************************************************************************/
@@ -94,6 +185,8 @@ void rammap_initialize(void)
  *
  * Description:
  *   Support simulation of memory mapped files by copying files into RAM.
+ *   If the requested range of the file is already held in an existing
+ *   region, that region is shared and its reference count is incremented.
  *
  * Parameters:
  *   fd      file descriptor of the backing file -- required.
@@ -111,32 +204,80 @@ void rammap_initialize(void)
  *       'length' or 'offset' are invalid
  *     ENOMEM
  *       Insufficient memory is available to map the file.
+ *     EINTR
+ *       The wait for the list of mapped regions was interrupted by a signal.
  *
  ****************************************************************************/
 
 FAR void *rammap(int fd, size_t length, off_t offset)
 {
+  FAR struct filelist *list;
+  FAR struct file *filep;
   FAR struct fs_rammap_s *map;
+  FAR struct inode *inode;
   FAR uint8_t *alloc;
   FAR uint8_t *rdbuffer;
   ssize_t nread;
+  struct fs_fileid_s fileid;
   off_t fpos;
   int err;
   int ret;
 
-  /* There is a major design flaw that I have not yet thought of fix for:
-   * The goal is to have a single region of memory that represents a single
-   * file and can be shared by many threads.  That is, given a filename a
-   * thread should be able to open the file, get a file descriptor, and
-   * call mmap() to get a memory region.  Different file descriptors opened
-   * with the same file path should get the same memory region when mapped.
-   *
-   * The design flaw is that I don't have sufficient knowledge to know that
-   * these different file descriptors map to the same file.  So, for the time
-   * being, a new memory region is created each time that rammap() is called.
-   * Not very useful!
+  /* Get the file structure corresponding to the file descriptor */
+
+  if ((unsigned int)fd >= CONFIG_NFILE_DESCRIPTORS)
+    {
+      err = EBADF;
+      goto errout;
+    }
+
+  list = sched_getfiles();
+  DEBUGASSERT(list);
+
+  filep = &list->fl_files[fd];
+  if (!filep->f_inode)
+    {
+      err = EBADF;
+      goto errout;
+    }
+
+  /* Different file descriptors opened on the same file must get the same
+   * memory region.  The file is identified by the mountpoint inode that
+   * provides it and by a file ID and generation provided by the file
+   * system.
    */
 
+  inode = rammap_fileid(filep, &fileid);
+
+  /* The list stays locked while the file is loaded so that concurrent
+   * mappings of the same file do not create duplicate copies.
+   */
+
+  rammap_initialize();
+  ret = sem_wait(&g_rammaps.exclsem);
+  if (ret < 0)
+    {
+      err = get_errno();
+      goto errout;
+    }
+
+  /* Is the requested range already held in memory? */
+
+  if (inode)
+    {
+      map = rammap_find(inode, &fileid, length, offset);
+      if (map)
+        {
+          /* Yes.. just share the existing region */
+
+          DEBUGASSERT(map->crefs < UINT16_MAX);
+          map->crefs++;
+
+          sem_post(&g_rammaps.exclsem);
+          return (FAR uint8_t *)map->addr + (offset - map->offset);
+        }
+    }
+
   /* Allocate a region of memory of the specified size */
 
   alloc = (FAR uint8_t *)kumm_malloc(sizeof(struct fs_rammap_s) + length);
@@ -144,16 +285,20 @@ FAR void *rammap(int fd, size_t length, off_t offset)
     {
       fdbg("Region allocation failed, length: %d\n", (int)length);
       err = ENOMEM;
-      goto errout;
+      goto errout_with_semaphore;
     }
 
   /* Initialize the region */
 
-  map         = (FAR struct fs_rammap_s *)alloc;
+  map             = (FAR struct fs_rammap_s *)alloc;
   memset(map, 0, sizeof(struct fs_rammap_s));
-  map->addr   = alloc + sizeof(struct fs_rammap_s);
-  map->length = length;
-  map->offset = offset;
+  map->addr       = alloc + sizeof(struct fs_rammap_s);
+  map->length     = length;
+  map->offset     = offset;
+  map->inode      = inode;
+  map->fileid     = fileid.fi_id;
+  map->generation = fileid.fi_generation;
+  map->crefs      = 1;
 
   /* Seek to the specified file offset */
 
@@ -169,7 +314,7 @@ FAR void *rammap(int fd, size_t length, off_t offset)
       goto errout_with_region;
     }
 
-  /* Read the file data into the memory region */
+  /* Read only the requested range of the file into the memory region */
 
   rdbuffer = map->addr;
   while (length > 0)
@@ -191,12 +336,10 @@ FAR void *rammap(int fd, size_t length, off_t offset)
                 */
 
                fdbg("Read failed: offset=%d errno=%d\n", (int)offset, err);
-#ifdef CONFIG_DEBUG_FS
                goto errout_with_region;
-#else
-               goto errout_with_errno;
-#endif
              }
+
+           continue;
         }
 
       /* Check for end of file. */
@@ -216,15 +359,17 @@ FAR void *rammap(int fd, size_t length, off_t offset)
 
   memset(rdbuffer, 0, length);
 
-  /* Add the buffer to the list of regions */
+  /* Hold a reference to the inode so that the identity of the region
+   * remains valid as long as the region exists.
+   */
 
-  rammap_initialize();
-  ret = sem_wait(&g_rammaps.exclsem);
-  if (ret < 0)
+  if (inode)
     {
-      goto errout_with_errno;
+      inode_addref(inode);
     }
 
+  /* Add the buffer to the list of regions */
+
   map->flink  = g_rammaps.head;
   g_rammaps.head = map;
 
@@ -233,13 +378,11 @@ FAR void *rammap(int fd, size_t length, off_t offset)
 
 errout_with_region:
   kumm_free(alloc);
+errout_with_semaphore:
+  sem_post(&g_rammaps.exclsem);
 errout:
   set_errno(err);
   return MAP_FAILED;
-
-errout_with_errno:
-  kumm_free(alloc);
-  return MAP_FAILED;
 }
 
 #endif /* CONFIG_FS_RAMMAP */
@@ -45,6 +45,8 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
 #include <semaphore.h>
 
 #ifdef CONFIG_FS_RAMMAP
@@ -57,18 +59,24 @@
  * Public Types
  ****************************************************************************/
 
-/* This structure describes one file that has been copied to memory and
- * managed as a share-able "memory mapped" file.  This functionality is
+/* This structure describes one file region that has been copied to memory
+ * and managed as a share-able "memory mapped" file.  This functionality is
  * intended to provide a substitute for memory mapped files for architectures
  * that do not have MMUs and, hence, cannot support on demand paging of
  * blocks of a file.
  *
+ * Regions are identified by the mountpoint inode that provides the file
+ * together with the file ID and generation returned by the FIOC_FILEID
+ * ioctl command.  A later mapping of the same, unmodified file that falls
+ * entirely within an existing region shares that region and just increments
+ * its reference count.  Only the requested range of the file is copied.
+ *
  * This copied file has many of the properties of a standard memory mapped
  * file except:
  *
- * - All of the file must be present in memory.  This limits the size of
- *   files that may be memory mapped (especially on MCUs with no significant
- *   RAM resources).
+ * - All of the mapped range must be present in memory.  This limits the size
+ *   of files that may be memory mapped (especially on MCUs with no
+ *   significant RAM resources).
  * - All mapped files are read-only.  You can write to the in-memory image,
  *   but the file contents will not change.
  * - There are not access privileges.
@@ -80,6 +88,10 @@ struct fs_rammap_s
   FAR void           *addr;        /* Start of allocated memory */
   size_t              length;      /* Length of region */
   off_t               offset;      /* File offset */
+  FAR struct inode   *inode;       /* Inode providing the file (NULL: not shared) */
+  off_t               fileid;      /* Identifies the file within 'inode' */
+  uint32_t            generation;  /* Generation of the file contents */
+  uint16_t            crefs;       /* Number of mmap() references to the region */
 };
 
 /* This structure defines all "mapped" files */
@@ -124,6 +136,8 @@ void rammap_initialize(void);
  *
  * Description:
  *   Support simulation of memory mapped files by copying files into RAM.
+ *   If the requested range of the file is already held in an existing
+ *   region, that region is shared and its reference count is incremented.
  *
  * Parameters:
  *   fd      file descriptor of the backing file -- required.
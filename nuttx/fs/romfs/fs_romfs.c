@@ -577,7 +577,7 @@ static int romfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
   DEBUGASSERT(rm != NULL);
 
-  /* Only one ioctl command is supported */
+  /* Only two ioctl commands are supported */
 
   if (cmd == FIOC_MMAP && rm->rm_xipbase && ppv)
     {
@@ -588,6 +588,19 @@ static int romfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
       *ppv = (void*)(rm->rm_xipbase + rf->rf_startoffset);
       return OK;
     }
+  else if (cmd == FIOC_FILEID && arg != 0)
+    {
+      FAR struct fs_fileid_s *fileid =
+        (FAR struct fs_fileid_s *)((uintptr_t)arg);
+
+      /* The offset to the file data uniquely identifies the file.  The
+       * volume is read-only so the contents never change.
+       */
+
+      fileid->fi_id         = (off_t)rf->rf_startoffset;
+      fileid->fi_generation = 0;
+      return OK;
+    }
 
   fdbg("Invalid cmd: %d \n", cmd);
   return -ENOTTY;
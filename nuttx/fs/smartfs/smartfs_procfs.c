@@ -748,14 +748,20 @@ static size_t smartfs_status_read(FAR struct file *filep, FAR char *buffer,
                                          "Total Sectors:     %d\nSector Size:       %d\n"
                                          "Format Sector:     %d\nDir Sector:        %d\n"
                                          "Free Sectors:      %d\nReleased Sectors:  %d\n"
-                                         "Sectors Per Block: %d\n",
+                                         "Sectors Per Block: %d\nBlock Erases:      %d\n"
+                                         "GC Collections:    %d\nGC Relocations:    %d\n"
+                                         "Map Source:        %s\nMap Build Time:    %d ms\n",
                                          //"Unused Sectors:    %d\nBlock Erases:      %d\n"
                                          //"Sectors Per Block: %d\nSector Utilization:%d%%\n",
                   procfs_data.formatversion, procfs_data.namelen,
                   procfs_data.totalsectors, procfs_data.sectorsize,
                   procfs_data.formatsector, procfs_data.dirsector,
                   procfs_data.freesectors, procfs_data.releasesectors,
-                  procfs_data.sectorsperblk);
+                  procfs_data.sectorsperblk, procfs_data.blockerases,
+                  procfs_data.gccount, procfs_data.gcrelocs,
+                  procfs_data.mapsource == SMART_MAPSRC_CHECKPOINT ?
+                    "checkpoint" : "scan",
+                  procfs_data.scantime);
                   //procfs_data.unusedsectors, procfs_data.blockerases,
                   //procfs_data.sectorsperblk, utilization);
         }
@@ -61,6 +61,25 @@
 #define NX_CLIPORDER_BRLT    (3)   /* Bottom-right-left-top */
 #define NX_CLIPORDER_DEFAULT NX_CLIPORDER_TLRB
 
+/* Off-screen rendering is only supported with framebuffer drivers */
+
+#ifdef CONFIG_NX_LCDDRIVER
+#  undef CONFIG_NX_FBBACKBUFFER
+#endif
+
+#ifndef CONFIG_NX_MULTIUSER
+#  undef CONFIG_NX_FBBACKBUFFER
+#endif
+
+#ifdef CONFIG_NX_FBBACKBUFFER
+#  ifndef CONFIG_NX_FBDAMAGE_NRECTS
+#    define CONFIG_NX_FBDAMAGE_NRECTS 8
+#  endif
+#  if CONFIG_NX_FBDAMAGE_NRECTS < 1
+#    error "CONFIG_NX_FBDAMAGE_NRECTS must be at least 1"
+#  endif
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -100,6 +119,20 @@ struct nxbe_plane_s
   /* Framebuffer plane info describing destination video plane */
 
   NX_PLANEINFOTYPE pinfo;
+
+#ifdef CONFIG_NX_FBBACKBUFFER
+  /* Off-screen rendering.  If fbfront is not NULL, then pinfo.fbmem refers
+   * to an off-screen back buffer and all raster operations draw there.  The
+   * damaged regions of the back buffer are made visible by nxbe_present().
+   */
+
+  FAR uint8_t *fbfront;          /* Visible framebuffer memory */
+  struct nxgl_rect_s damage[CONFIG_NX_FBDAMAGE_NRECTS];
+  uint8_t ndamage;               /* Number of damaged regions */
+#ifdef CONFIG_FB_PAGEFLIP
+  bool pageflip;                 /* True: The back buffer is a display page */
+#endif
+#endif
 };
 
 /* Clipping *****************************************************************/
@@ -148,6 +181,12 @@ struct nxbe_state_s
   /* Rasterizing functions selected to match the BPP reported in pinfo[] */
 
   struct nxbe_plane_s plane[CONFIG_NX_NPLANES];
+
+#ifdef CONFIG_NX_FBBACKBUFFER
+  /* The framebuffer driver (needed to flip display pages) */
+
+  FAR NX_DRIVERTYPE *dev;
+#endif
 };
 
 /****************************************************************************
@@ -189,6 +228,67 @@ int nxbe_colormap(FAR NX_DRIVERTYPE *dev);
 
 int nxbe_configure(FAR NX_DRIVERTYPE *dev, FAR struct nxbe_state_s *be);
 
+/****************************************************************************
+ * Name: nxbe_allocbackbuffer
+ *
+ * Description:
+ *   Set up off-screen rendering for each color plane.  If the driver
+ *   supports page flipping, its second display page is used as the back
+ *   buffer; otherwise a back buffer is allocated.  If neither is possible,
+ *   NX continues to draw directly into the visible framebuffer.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_FBBACKBUFFER
+void nxbe_allocbackbuffer(FAR NX_DRIVERTYPE *dev, FAR struct nxbe_state_s *be);
+#endif
+
+/****************************************************************************
+ * Name: nxbe_freebackbuffer
+ *
+ * Description:
+ *   Release the resources allocated by nxbe_allocbackbuffer().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_FBBACKBUFFER
+void nxbe_freebackbuffer(FAR struct nxbe_state_s *be);
+#endif
+
+/****************************************************************************
+ * Name: nxbe_damage
+ *
+ * Description:
+ *   Record that a region of the back buffer of a color plane has been
+ *   modified and must be presented.  Overlapping regions are merged.  When
+ *   the damage list is full, the region is merged with the entry that grows
+ *   the least.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_FBBACKBUFFER
+void nxbe_damage(FAR struct nxbe_plane_s *plane,
+                 FAR const struct nxgl_rect_s *rect);
+#else
+#  define nxbe_damage(plane, rect)
+#endif
+
+/****************************************************************************
+ * Name: nxbe_present
+ *
+ * Description:
+ *   Make the damaged regions of the back buffer visible, either by flipping
+ *   display pages or by copying each damaged region to the visible
+ *   framebuffer.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_FBBACKBUFFER
+void nxbe_present(FAR struct nxbe_state_s *be);
+#else
+#  define nxbe_present(be)
+#endif
+
 /****************************************************************************
  * Name: nxbe_closewindow
  *
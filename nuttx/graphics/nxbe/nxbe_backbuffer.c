@@ -0,0 +1,344 @@
+/****************************************************************************
+ * graphics/nxbe/nxbe_backbuffer.c
+ *
+ *   Copyright (C) 2014 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/nx/nxglib.h>
+
+#include "nxbe.h"
+
+#ifdef CONFIG_NX_FBBACKBUFFER
+
+/****************************************************************************
+ * Pre-Processor Definitions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxbe_area
+ *
+ * Description:
+ *   Return the number of pixels in a rectangle.
+ *
+ ****************************************************************************/
+
+static inline uint32_t nxbe_area(FAR const struct nxgl_rect_s *rect)
+{
+  return (uint32_t)(rect->pt2.x - rect->pt1.x + 1) *
+         (uint32_t)(rect->pt2.y - rect->pt1.y + 1);
+}
+
+/****************************************************************************
+ * Name: nxbe_copyregion
+ *
+ * Description:
+ *   Copy one region between two buffers with the same layout.  Pixels are
+ *   copied in whole bytes; for pixel depths of less than 8 bits, this may
+ *   also copy a few neighboring pixels which are the same in both buffers
+ *   anyway.  Regions that span the full width of the display are copied
+ *   with a single memcpy().
+ *
+ ****************************************************************************/
+
+static void nxbe_copyregion(FAR struct nxbe_plane_s *plane,
+                            FAR uint8_t *dest, FAR const uint8_t *src,
+                            FAR const struct nxgl_rect_s *rect)
+{
+  unsigned int stride = plane->pinfo.stride;
+  unsigned int bpp    = plane->pinfo.bpp;
+  unsigned int start  = ((unsigned int)rect->pt1.x * bpp) >> 3;
+  unsigned int end    = (((unsigned int)rect->pt2.x + 1) * bpp + 7) >> 3;
+  unsigned int rows   = rect->pt2.y - rect->pt1.y + 1;
+  size_t offset       = (size_t)rect->pt1.y * stride + start;
+
+  if (end > stride)
+    {
+      end = stride;
+    }
+
+  if (start == 0 && end == stride)
+    {
+      memcpy(dest + offset, src + offset, (size_t)rows * stride);
+    }
+  else
+    {
+      for (; rows > 0; rows--, offset += stride)
+        {
+          memcpy(dest + offset, src + offset, end - start);
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxbe_allocbackbuffer
+ *
+ * Description:
+ *   Set up off-screen rendering for each color plane.  If the driver
+ *   supports page flipping, its second display page is used as the back
+ *   buffer; otherwise a back buffer is allocated.  If neither is possible,
+ *   NX continues to draw directly into the visible framebuffer.
+ *
+ ****************************************************************************/
+
+void nxbe_allocbackbuffer(FAR NX_DRIVERTYPE *dev, FAR struct nxbe_state_s *be)
+{
+  FAR struct nxbe_plane_s *plane;
+  FAR void *fbback;
+  int i;
+
+  be->dev = dev;
+
+  for (i = 0; i < be->vinfo.nplanes; i++)
+    {
+      plane          = &be->plane[i];
+      plane->fbfront = NULL;
+      plane->ndamage = 0;
+      fbback         = NULL;
+
+#ifdef CONFIG_FB_PAGEFLIP
+      /* Prefer the second display page of the hardware */
+
+      plane->pageflip = false;
+      if (dev->getbackpage && dev->flip &&
+          dev->getbackpage(dev, i, &fbback) == OK && fbback)
+        {
+          plane->pageflip = true;
+        }
+      else
+#endif
+        {
+          fbback = kmm_malloc(plane->pinfo.fblen);
+          if (!fbback)
+            {
+              gdbg("Failed to allocate back buffer[%d]: %lu bytes\n",
+                   i, (unsigned long)plane->pinfo.fblen);
+              continue;
+            }
+        }
+
+      /* Start with the same content in both buffers */
+
+      memcpy(fbback, plane->pinfo.fbmem, plane->pinfo.fblen);
+
+      plane->fbfront     = (FAR uint8_t *)plane->pinfo.fbmem;
+      plane->pinfo.fbmem = fbback;
+    }
+}
+
+/****************************************************************************
+ * Name: nxbe_freebackbuffer
+ *
+ * Description:
+ *   Release the resources allocated by nxbe_allocbackbuffer().
+ *
+ ****************************************************************************/
+
+void nxbe_freebackbuffer(FAR struct nxbe_state_s *be)
+{
+  FAR struct nxbe_plane_s *plane;
+  int i;
+
+  nxbe_present(be);
+
+  for (i = 0; i < be->vinfo.nplanes; i++)
+    {
+      plane = &be->plane[i];
+      if (plane->fbfront)
+        {
+#ifdef CONFIG_FB_PAGEFLIP
+          if (!plane->pageflip)
+#endif
+            {
+              kmm_free(plane->pinfo.fbmem);
+            }
+
+          plane->pinfo.fbmem = plane->fbfront;
+          plane->fbfront     = NULL;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: nxbe_damage
+ *
+ * Description:
+ *   Record that a region of the back buffer of a color plane has been
+ *   modified and must be presented.  Overlapping regions are merged.  When
+ *   the damage list is full, the region is merged with the entry that grows
+ *   the least.
+ *
+ ****************************************************************************/
+
+void nxbe_damage(FAR struct nxbe_plane_s *plane,
+                 FAR const struct nxgl_rect_s *rect)
+{
+  struct nxgl_rect_s merged;
+  uint32_t growth;
+  uint32_t best;
+  int ndx;
+  int i;
+
+  if (!plane->fbfront || nxgl_nullrect(rect))
+    {
+      return;
+    }
+
+  /* Merge with an existing region that overlaps this one */
+
+  for (i = 0; i < plane->ndamage; i++)
+    {
+      if (nxgl_rectoverlap(&plane->damage[i], (FAR struct nxgl_rect_s *)rect))
+        {
+          nxgl_rectunion(&plane->damage[i], &plane->damage[i], rect);
+          return;
+        }
+    }
+
+  /* Add a new region if there is room */
+
+  if (plane->ndamage < CONFIG_NX_FBDAMAGE_NRECTS)
+    {
+      nxgl_rectcopy(&plane->damage[plane->ndamage], rect);
+      plane->ndamage++;
+      return;
+    }
+
+  /* Otherwise, merge with the region that grows the least */
+
+  ndx  = 0;
+  best = UINT32_MAX;
+
+  for (i = 0; i < plane->ndamage; i++)
+    {
+      nxgl_rectunion(&merged, &plane->damage[i], rect);
+      growth = nxbe_area(&merged) - nxbe_area(&plane->damage[i]);
+      if (growth < best)
+        {
+          best = growth;
+          ndx  = i;
+        }
+    }
+
+  nxgl_rectunion(&plane->damage[ndx], &plane->damage[ndx], rect);
+}
+
+/****************************************************************************
+ * Name: nxbe_present
+ *
+ * Description:
+ *   Make the damaged regions of the back buffer visible, either by flipping
+ *   display pages or by copying each damaged region to the visible
+ *   framebuffer.
+ *
+ ****************************************************************************/
+
+void nxbe_present(FAR struct nxbe_state_s *be)
+{
+  FAR struct nxbe_plane_s *plane;
+  FAR uint8_t *fbback;
+  int i;
+  int j;
+
+  for (i = 0; i < be->vinfo.nplanes; i++)
+    {
+      plane = &be->plane[i];
+      if (!plane->fbfront || plane->ndamage == 0)
+        {
+          continue;
+        }
+
+      fbback = (FAR uint8_t *)plane->pinfo.fbmem;
+
+#ifdef CONFIG_FB_PAGEFLIP
+      if (plane->pageflip && be->dev->flip(be->dev, i) == OK)
+        {
+          /* The back page is now displayed.  Bring the new back page (the
+           * page that was displayed) up to date and draw there from now on.
+           */
+
+          plane->pinfo.fbmem = plane->fbfront;
+          plane->fbfront     = fbback;
+
+          for (j = 0; j < plane->ndamage; j++)
+            {
+              nxbe_copyregion(plane, plane->pinfo.fbmem, fbback,
+                              &plane->damage[j]);
+            }
+        }
+      else
+#endif
+        {
+          /* Copy each damaged region to the visible framebuffer */
+
+          for (j = 0; j < plane->ndamage; j++)
+            {
+              nxbe_copyregion(plane, plane->fbfront, fbback,
+                              &plane->damage[j]);
+            }
+        }
+
+      plane->ndamage = 0;
+    }
+}
+
+#endif /* CONFIG_NX_FBBACKBUFFER */
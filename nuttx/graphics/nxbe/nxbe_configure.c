@@ -232,5 +232,12 @@ int nxbe_configure(FAR NX_DRIVERTYPE *dev, FAR struct nxbe_state_s *be)
           return -ENOSYS;
         }
     }
+
+#ifdef CONFIG_NX_FBBACKBUFFER
+  /* Render into an off-screen buffer */
+
+  nxbe_allocbackbuffer(dev, be);
+#endif
+
   return OK;
 }
@@ -84,6 +84,7 @@ static void nxbe_clipfill(FAR struct nxbe_clipops_s *cops,
 {
   struct nxbe_fill_s *fillinfo = (struct nxbe_fill_s *)cops;
   plane->fillrectangle(&plane->pinfo, rect, fillinfo->color);
+  nxbe_damage(plane, rect);
 }
 
 /****************************************************************************
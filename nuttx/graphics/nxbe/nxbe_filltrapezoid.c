@@ -85,7 +85,26 @@ static void nxbe_clipfilltrapezoid(FAR struct nxbe_clipops_s *cops,
                                    FAR const struct nxgl_rect_s *rect)
 {
   struct nxbe_filltrap_s *fillinfo = (struct nxbe_filltrap_s *)cops;
+#ifdef CONFIG_NX_FBBACKBUFFER
+  FAR const struct nxgl_trapezoid_s *trap = &fillinfo->trap;
+  struct nxgl_rect_s bounds;
+#endif
+
   plane->filltrapezoid(&plane->pinfo, &fillinfo->trap, rect, fillinfo->color);
+
+#ifdef CONFIG_NX_FBBACKBUFFER
+  /* The damaged region is the bounding box of the trapezoid within the
+   * clipping rectangle.
+   */
+
+  bounds.pt1.x = b16toi(ngl_min(trap->top.x1, trap->bot.x1));
+  bounds.pt1.y = trap->top.y;
+  bounds.pt2.x = b16toi(ngl_max(trap->top.x2, trap->bot.x2)) + 1;
+  bounds.pt2.y = trap->bot.y;
+
+  nxgl_rectintersect(&bounds, &bounds, rect);
+  nxbe_damage(plane, &bounds);
+#endif
 }
 
 /****************************************************************************
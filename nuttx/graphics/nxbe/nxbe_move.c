@@ -99,6 +99,16 @@ static void nxbe_clipmovesrc(FAR struct nxbe_clipops_s *cops,
       offset.y = rect->pt1.y + info->offset.y;
 
       plane->moverectangle(&plane->pinfo, rect, &offset);
+
+#ifdef CONFIG_NX_FBBACKBUFFER
+      /* The destination of the move has changed */
+
+      {
+        struct nxgl_rect_s dest;
+        nxgl_rectoffset(&dest, rect, info->offset.x, info->offset.y);
+        nxbe_damage(plane, &dest);
+      }
+#endif
     }
 }
 
@@ -206,7 +206,7 @@ void NXGL_FUNCNAME(nxgl_moverectangle,NXGLIB_SUFFIX)
 #if NXGLIB_BITSPERPIXEL < 8
           nxgl_lowresmemcpy(dline, sline, width, leadmask, tailmask);
 #else
-          NXGL_MEMCPY(dline, sline, width);
+          NXGL_MEMMOVE(dline, sline, width);
 #endif
           /* Point to the next source/dest row below the current one */
 
@@ -245,7 +245,7 @@ void NXGL_FUNCNAME(nxgl_moverectangle,NXGLIB_SUFFIX)
 #if NXGLIB_BITSPERPIXEL < 8
           nxgl_lowresmemcpy(dline, sline, width, leadmask, tailmask);
 #else
-          NXGL_MEMCPY(dline, sline, width);
+          NXGL_MEMMOVE(dline, sline, width);
 #endif
         }
     }
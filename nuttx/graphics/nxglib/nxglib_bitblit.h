@@ -42,7 +42,9 @@
 
 #include <nuttx/config.h>
 
+#include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 
 #include <nuttx/nx/nxglib.h>
 
@@ -108,7 +110,32 @@
 #  define NXGL_REMAINDERX(x)       ((x) & NXGL_PIXELMASK)
 #  define NXGL_ALIGNDOWN(x)        ((x) & ~NXGL_PIXELMASK)
 #  define NXGL_ALIGNUP(x)          (((x) + NXGL_PIXELMASK) & ~NXGL_PIXELMASK)
+#endif
+
+/* NXGL_MEMSET fills a run of pixels with one color and NXGL_MEMCPY copies
+ * a run of pixels.  With CONFIG_NX_WORDRASTER, runs are filled with
+ * unrolled, aligned 32-bit stores and copied with the C library memcpy();
+ * otherwise runs are processed one pixel at a time.
+ */
+
+#if defined(CONFIG_NX_WORDRASTER)
+#  if NXGLIB_BITSPERPIXEL <= 8
+#    define NXGL_MEMSET(dest,value,width) \
+       memset((dest), (value), NXGL_SCALEX(width))
+#  elif NXGLIB_BITSPERPIXEL == 16
+#    define NXGL_MEMSET(dest,value,width) \
+       nxgl_wordset16((FAR uint16_t*)(dest), (uint16_t)(value), (width))
+#  elif NXGLIB_BITSPERPIXEL == 24
+#    define NXGL_MEMSET(dest,value,width) \
+       nxgl_wordset24((FAR uint8_t*)(dest), (uint32_t)(value), (width))
+#  else
+#    define NXGL_MEMSET(dest,value,width) \
+       nxgl_wordset32((FAR uint32_t*)(dest), (uint32_t)(value), (width))
+#  endif
+#  define NXGL_MEMCPY(dest,src,width) \
+     memcpy((dest), (src), NXGL_SCALEX(width))
 
+#elif NXGLIB_BITSPERPIXEL < 8
 #  define NXGL_MEMSET(dest,value,width) \
    { \
      FAR uint8_t *_ptr = (FAR uint8_t*)(dest); \
@@ -175,6 +202,11 @@
    }
 #endif
 
+/* NXGL_MEMMOVE copies a run of pixels that may overlap the destination */
+
+#define NXGL_MEMMOVE(dest,src,width) \
+   memmove((dest), (src), NXGL_SCALEX(width))
+
 /* Form a function name by concatenating two strings */
 
 #define _NXGL_FUNCNAME(a,b) a ## b
@@ -184,6 +216,162 @@
  * Public Types
  ****************************************************************************/
 
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_WORDRASTER
+/****************************************************************************
+ * Name: nxgl_wordset16
+ *
+ * Description:
+ *   Fill a run of 16-bit pixels.  At most one pixel is written at the
+ *   beginning and at the end of the run; all others are written two at a
+ *   time with aligned 32-bit stores.
+ *
+ ****************************************************************************/
+
+#if NXGLIB_BITSPERPIXEL == 16
+static inline void nxgl_wordset16(FAR uint16_t *dest, uint16_t value,
+                                  size_t npixels)
+{
+  FAR uint32_t *wptr;
+  uint32_t wide;
+
+  /* Write one pixel if necessary to get to a 32-bit boundary */
+
+  if (npixels > 0 && ((uintptr_t)dest & 2) != 0)
+    {
+      *dest++ = value;
+      npixels--;
+    }
+
+  /* Then write pairs of pixels, eight pixels per pass */
+
+  wptr = (FAR uint32_t *)dest;
+  wide = (uint32_t)value << 16 | value;
+
+  for (; npixels >= 8; npixels -= 8)
+    {
+      wptr[0] = wide;
+      wptr[1] = wide;
+      wptr[2] = wide;
+      wptr[3] = wide;
+      wptr   += 4;
+    }
+
+  for (; npixels >= 2; npixels -= 2)
+    {
+      *wptr++ = wide;
+    }
+
+  /* And the final, odd pixel */
+
+  if (npixels > 0)
+    {
+      *(FAR uint16_t *)wptr = value;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: nxgl_wordset24
+ *
+ * Description:
+ *   Fill a run of packed 24-bit pixels.  Pixels are written one byte at a
+ *   time until the destination is aligned to a 32-bit boundary; then
+ *   groups of four pixels are written as three 32-bit words.
+ *
+ ****************************************************************************/
+
+#if NXGLIB_BITSPERPIXEL == 24
+static inline void nxgl_wordset24(FAR uint8_t *dest, uint32_t value,
+                                  size_t npixels)
+{
+  union
+  {
+    uint8_t  b[12];
+    uint32_t w[3];
+  } pattern;
+
+  FAR uint32_t *wptr;
+  int i;
+
+  /* Write single pixels until the destination is aligned.  This takes at
+   * most three pixels.
+   */
+
+  while (npixels > 0 && ((uintptr_t)dest & 3) != 0)
+    {
+      *dest++ = (uint8_t)value;
+      *dest++ = (uint8_t)(value >> 8);
+      *dest++ = (uint8_t)(value >> 16);
+      npixels--;
+    }
+
+  /* Build the byte pattern of four pixels.  Going through memory keeps
+   * the pattern independent of the byte order of the CPU.
+   */
+
+  for (i = 0; i < 12; i += 3)
+    {
+      pattern.b[i]     = (uint8_t)value;
+      pattern.b[i + 1] = (uint8_t)(value >> 8);
+      pattern.b[i + 2] = (uint8_t)(value >> 16);
+    }
+
+  /* Then write four pixels (three words) per pass */
+
+  wptr = (FAR uint32_t *)dest;
+  for (; npixels >= 4; npixels -= 4)
+    {
+      wptr[0] = pattern.w[0];
+      wptr[1] = pattern.w[1];
+      wptr[2] = pattern.w[2];
+      wptr   += 3;
+    }
+
+  /* And the remaining pixels */
+
+  dest = (FAR uint8_t *)wptr;
+  while (npixels-- > 0)
+    {
+      *dest++ = (uint8_t)value;
+      *dest++ = (uint8_t)(value >> 8);
+      *dest++ = (uint8_t)(value >> 16);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: nxgl_wordset32
+ *
+ * Description:
+ *   Fill a run of 32-bit pixels, four pixels per pass.
+ *
+ ****************************************************************************/
+
+#if NXGLIB_BITSPERPIXEL >= 24
+static inline void nxgl_wordset32(FAR uint32_t *dest, uint32_t value,
+                                  size_t npixels)
+{
+  for (; npixels >= 4; npixels -= 4)
+    {
+      dest[0] = value;
+      dest[1] = value;
+      dest[2] = value;
+      dest[3] = value;
+      dest   += 4;
+    }
+
+  while (npixels-- > 0)
+    {
+      *dest++ = value;
+    }
+}
+#endif
+#endif /* CONFIG_NX_WORDRASTER */
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
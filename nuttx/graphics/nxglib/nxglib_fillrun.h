@@ -161,10 +161,14 @@ static inline void nxgl_fillrun_16bpp(FAR uint16_t *run, nxgl_mxpixel_t color,
 {
   /* Fill the run with the color (it is okay to run a fractional byte overy the end */
 
+#ifdef CONFIG_NX_WORDRASTER
+  nxgl_wordset16(run, (uint16_t)color, npixels);
+#else
   while (npixels-- > 0)
     {
       *run++ = (uint16_t)color;
     }
+#endif
 }
 
 #elif NXGLIB_BITSPERPIXEL == 24
@@ -172,10 +176,14 @@ static inline void nxgl_fillrun_24bpp(FAR uint32_t *run, nxgl_mxpixel_t color, s
 {
   /* Fill the run with the color (it is okay to run a fractional byte overy the end */
 #warning "Assuming 24-bit color is not packed"
+#ifdef CONFIG_NX_WORDRASTER
+  nxgl_wordset32(run, (uint32_t)color, npixels);
+#else
   while (npixels-- > 0)
     {
       *run++ = (uint32_t)color;
     }
+#endif
 }
 
 #elif NXGLIB_BITSPERPIXEL == 32
@@ -183,10 +191,14 @@ static inline void nxgl_fillrun_32bpp(FAR uint32_t *run, nxgl_mxpixel_t color, s
 {
   /* Fill the run with the color (it is okay to run a fractional byte overy the end */
 
+#ifdef CONFIG_NX_WORDRASTER
+  nxgl_wordset32(run, (uint32_t)color, npixels);
+#else
   while (npixels-- > 0)
     {
       *run++ = (uint32_t)color;
     }
+#endif
 }
 #else
 #  error "Unsupported value of NXGLIB_BITSPERPIXEL"
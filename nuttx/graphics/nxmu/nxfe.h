@@ -271,6 +271,24 @@ int nxmu_mousein(FAR struct nxfe_state_s *fe,
 void nxmu_kbdin(FAR struct nxfe_state_s *fe, uint8_t nch, FAR uint8_t *ch);
 #endif
 
+/****************************************************************************
+ * Name: nxmu_batch
+ *
+ * Description:
+ *   Execute a batch of drawing commands received from a client.
+ *
+ * Input Parameters:
+ *   batch - The batch message
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_BATCH
+void nxmu_batch(FAR struct nxsvrmsg_batch_s *batch);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
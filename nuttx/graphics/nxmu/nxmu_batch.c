@@ -0,0 +1,167 @@
+/****************************************************************************
+ * graphics/nxmu/nxmu_batch.c
+ *
+ *   Copyright (C) 2014 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <semaphore.h>
+#include <debug.h>
+
+#include <nuttx/nx/nx.h>
+#include "nxfe.h"
+
+#ifdef CONFIG_NX_BATCH
+
+/****************************************************************************
+ * Pre-Processor Definitions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmu_batch
+ *
+ * Description:
+ *   Execute a batch of drawing commands received from a client.  The
+ *   commands are executed in the order that the client issued them.  The
+ *   client is notified when the whole batch has executed so that it can
+ *   re-use the batch memory.
+ *
+ * Input Parameters:
+ *   batch - The batch message
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxmu_batch(FAR struct nxsvrmsg_batch_s *batch)
+{
+  FAR const uint8_t *ptr = batch->buffer;
+  FAR const uint8_t *end = ptr + batch->buflen;
+  FAR struct nxsvrmsg_s *msg;
+  size_t msglen;
+
+  while (ptr < end)
+    {
+      msg = (FAR struct nxsvrmsg_s *)ptr;
+      switch (msg->msgid)
+        {
+        case NX_SVRMSG_SETPIXEL: /* Set a single pixel in the window with a color */
+          {
+            FAR struct nxsvrmsg_setpixel_s *setmsg = (FAR struct nxsvrmsg_setpixel_s *)msg;
+            nxbe_setpixel(setmsg->wnd, &setmsg->pos, setmsg->color);
+            msglen = sizeof(struct nxsvrmsg_setpixel_s);
+          }
+          break;
+
+        case NX_SVRMSG_FILL: /* Fill a rectangular region in the window with a color */
+          {
+            FAR struct nxsvrmsg_fill_s *fillmsg = (FAR struct nxsvrmsg_fill_s *)msg;
+            nxbe_fill(fillmsg->wnd, &fillmsg->rect, fillmsg->color);
+            msglen = sizeof(struct nxsvrmsg_fill_s);
+          }
+          break;
+
+        case NX_SVRMSG_FILLTRAP: /* Fill a trapezoidal region in the window with a color */
+          {
+            FAR struct nxsvrmsg_filltrapezoid_s *trapmsg = (FAR struct nxsvrmsg_filltrapezoid_s *)msg;
+            nxbe_filltrapezoid(trapmsg->wnd, &trapmsg->clip, &trapmsg->trap, trapmsg->color);
+            msglen = sizeof(struct nxsvrmsg_filltrapezoid_s);
+          }
+          break;
+
+        case NX_SVRMSG_MOVE: /* Move a rectangular region within the window */
+          {
+            FAR struct nxsvrmsg_move_s *movemsg = (FAR struct nxsvrmsg_move_s *)msg;
+            nxbe_move(movemsg->wnd, &movemsg->rect, &movemsg->offset);
+            msglen = sizeof(struct nxsvrmsg_move_s);
+          }
+          break;
+
+        case NX_SVRMSG_BITMAP: /* Copy a rectangular bitmap into the window */
+          {
+            FAR struct nxsvrmsg_bitmap_s *bmpmsg = (FAR struct nxsvrmsg_bitmap_s *)msg;
+            nxbe_bitmap(bmpmsg->wnd, &bmpmsg->dest, bmpmsg->src, &bmpmsg->origin, bmpmsg->stride);
+
+            /* The image of each color plane follows the message */
+
+            msglen = NXBATCH_ALIGN(sizeof(struct nxsvrmsg_bitmap_s)) +
+                     CONFIG_NX_NPLANES *
+                     NXBATCH_ALIGN(bmpmsg->stride *
+                                   (bmpmsg->dest.pt2.y - bmpmsg->dest.pt1.y + 1));
+          }
+          break;
+
+        default:
+          gdbg("Unexpected batched command: %d\n", msg->msgid);
+          ptr = end;
+          continue;
+        }
+
+      ptr += NXBATCH_ALIGN(msglen);
+    }
+
+  /* Let the client know that the batch memory is free */
+
+  if (batch->sem_done)
+    {
+      sem_post(batch->sem_done);
+    }
+}
+
+#endif /* CONFIG_NX_BATCH */
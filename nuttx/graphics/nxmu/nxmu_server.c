@@ -99,11 +99,13 @@ static inline void nxmu_disconnect(FAR struct nxfe_conn_s *conn)
  * Name: nxmu_connect
  ****************************************************************************/
 
-static inline void nxmu_connect(FAR struct nxfe_conn_s *conn)
+static inline void nxmu_connect(FAR struct nxfe_state_s *fe,
+                                FAR struct nxfe_conn_s *conn)
 {
   char mqname[NX_CLIENT_MXNAMELEN];
   struct nxclimsg_connected_s outmsg;
   int ret;
+  int i;
 
   /* Create the client MQ name */
 
@@ -118,7 +120,14 @@ static inline void nxmu_connect(FAR struct nxfe_conn_s *conn)
       outmsg.msgid = NX_CLIMSG_DISCONNECTED;
     }
 
-  /* Send the handshake message back to the client */
+  /* Send the handshake message back to the client.  The pixel depth lets
+   * the client format batched bitmaps.
+   */
+
+  for (i = 0; i < CONFIG_NX_NPLANES; i++)
+    {
+      outmsg.bpp[i] = fe->be.plane[i].pinfo.bpp;
+    }
 
   outmsg.msgid = NX_CLIMSG_CONNECTED;
   ret = nxmu_sendclient(conn, &outmsg, sizeof(struct nxclimsg_connected_s));
@@ -148,6 +157,12 @@ static inline void nxmu_shutdown(FAR struct nxfe_state_s *fe)
     {
        (void)nxmu_disconnect(wnd->conn);
     }
+
+#ifdef CONFIG_NX_FBBACKBUFFER
+  /* Restore direct rendering into the visible framebuffer */
+
+  nxbe_freebackbuffer(&fe->be);
+#endif
 }
 
 /****************************************************************************
@@ -294,6 +309,9 @@ int nx_runinstance(FAR const char *mqname, FAR NX_DRIVERTYPE *dev)
   struct nxfe_state_s     fe;
   FAR struct nxsvrmsg_s *msg;
   uint8_t                buffer[NX_MXSVRMSGLEN];
+#ifdef CONFIG_NX_FBBACKBUFFER
+  struct mq_attr         attr;
+#endif
   int                    nbytes;
   int                    ret;
 
@@ -353,7 +371,7 @@ int nx_runinstance(FAR const char *mqname, FAR NX_DRIVERTYPE *dev)
          case NX_SVRMSG_CONNECT: /* Establish connection with new NX server client */
            {
              FAR struct nxsvrmsg_s *connmsg = (FAR struct nxsvrmsg_s *)buffer;
-             nxmu_connect(connmsg->conn);
+             nxmu_connect(&fe, connmsg->conn);
            }
            break;
 
@@ -525,6 +543,15 @@ int nx_runinstance(FAR const char *mqname, FAR NX_DRIVERTYPE *dev)
            }
            break;
 
+#ifdef CONFIG_NX_BATCH
+         case NX_SVRMSG_BATCH: /* Execute a batch of drawing commands */
+           {
+             FAR struct nxsvrmsg_batch_s *batchmsg = (FAR struct nxsvrmsg_batch_s *)buffer;
+             nxmu_batch(batchmsg);
+           }
+           break;
+#endif
+
          /* Messages sent to the background window **************************/
 
          case NX_CLIMSG_REDRAW: /* Re-draw the background window */
@@ -548,6 +575,18 @@ int nx_runinstance(FAR const char *mqname, FAR NX_DRIVERTYPE *dev)
            gdbg("Unrecognized command: %d\n", msg->msgid);
            break;
          }
+
+#ifdef CONFIG_NX_FBBACKBUFFER
+       /* Make the results visible once all pending requests have been
+        * processed.  All of the damage from a burst of requests is then
+        * presented at once.
+        */
+
+       if (mq_getattr(fe.conn.crdmq, &attr) < 0 || attr.mq_curmsgs == 0)
+         {
+           nxbe_present(&fe.be);
+         }
+#endif
     }
 
 errout:
@@ -61,9 +61,24 @@
 #define BMFLAGS_NOGLYPH    (1 << 0) /* No glyph available, use space */
 #define BM_ISSPACE(bm)     (((bm)->flags & BMFLAGS_NOGLYPH) != 0)
 
-/* Sizes and maximums */
+/* Glyph cache.  Glyphs are linked by their index in the glyph[] array */
 
-#define MAX_USECNT         255  /* Limit to range of a uint8_t */
+#define NXTERM_NOGLYPH     0xff /* Terminates a list of glyphs */
+#define NXTERM_HASHSIZE    32   /* Number of hash buckets (power of two) */
+#define NXTERM_HASH(ch)    ((ch) & (NXTERM_HASHSIZE - 1))
+
+#if CONFIG_NXTERM_CACHESIZE >= NXTERM_NOGLYPH
+#  error "CONFIG_NXTERM_CACHESIZE is too large"
+#endif
+
+/* The bm[] array is a ring buffer.  Character i on the display (counting
+ * from the oldest) is held in bm[NXTERM_BMNDX(p,i)].
+ */
+
+#define NXTERM_BMNDX(p,i) \
+  ((p)->bmhead + (i) < (p)->maxchars ? \
+   (p)->bmhead + (i) : (p)->bmhead + (i) - (p)->maxchars)
+#define NXTERM_BM(p,i)     (&(p)->bm[NXTERM_BMNDX(p,i)])
 
 /* Device path formats */
 
@@ -119,7 +134,9 @@ struct nxterm_glyph_s
   uint8_t height;                      /* Height of this glyph (in rows) */
   uint8_t width;                       /* Width of this glyph (in pixels) */
   uint8_t stride;                      /* Width of the glyph row (in bytes) */
-  uint8_t usecnt;                      /* Use count */
+  uint8_t hlink;                       /* Next glyph in the hash bucket */
+  uint8_t flink;                       /* Next (less recently used) glyph */
+  uint8_t blink;                       /* Previous (more recently used) glyph */
   FAR uint8_t *bitmap;                 /* Allocated bitmap memory */
 };
 
@@ -155,6 +172,7 @@ struct nxterm_state_s
 
   uint16_t maxchars;                        /* Size of the bm[] array */
   uint16_t nchars;                          /* Number of chars in the bm[] array */
+  uint16_t bmhead;                          /* Index of the oldest char in bm[] */
 
   struct nxgl_point_s fpos;                 /* Next display position */
 
@@ -170,6 +188,10 @@ struct nxterm_state_s
 
   /* Glyph cache data storage */
 
+  uint8_t mru;                              /* Most recently used glyph */
+  uint8_t lru;                              /* Least recently used glyph */
+  uint8_t freeglyph;                        /* List of unused glyphs */
+  uint8_t hash[NXTERM_HASHSIZE];            /* Glyphs hashed by code */
   struct nxterm_glyph_s  glyph[CONFIG_NXTERM_CACHESIZE];
 
   /* Keyboard input support */
@@ -233,6 +255,7 @@ enum nxterm_vt100state_e nxterm_vt100(FAR struct nxterm_state_s *priv, char ch);
 
 /* Generic text display helpers */
 
+void nxterm_initglyphs(FAR struct nxterm_state_s *priv);
 void nxterm_home(FAR struct nxterm_state_s *priv);
 void nxterm_newline(FAR struct nxterm_state_s *priv);
 FAR const struct nxterm_bitmap_s *nxterm_addchar(NXHANDLE hfont,
@@ -94,88 +94,148 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: nxterm_linkglyph
+ *
+ * Description:
+ *   Add a glyph to its hash bucket and make it the most recently used
+ *   glyph.
+ *
+ ****************************************************************************/
+
+static void nxterm_linkglyph(FAR struct nxterm_state_s *priv, uint8_t ndx)
+{
+  FAR struct nxterm_glyph_s *glyph = &priv->glyph[ndx];
+  FAR uint8_t *bucket = &priv->hash[NXTERM_HASH(glyph->code)];
+
+  glyph->hlink = *bucket;
+  *bucket      = ndx;
+
+  glyph->blink = NXTERM_NOGLYPH;
+  glyph->flink = priv->mru;
+
+  if (priv->mru != NXTERM_NOGLYPH)
+    {
+      priv->glyph[priv->mru].blink = ndx;
+    }
+  else
+    {
+      priv->lru = ndx;
+    }
+
+  priv->mru = ndx;
+}
+
+/****************************************************************************
+ * Name: nxterm_unlinkglyph
+ *
+ * Description:
+ *   Remove a glyph from its hash bucket and from the LRU list.
+ *
+ ****************************************************************************/
+
+static void nxterm_unlinkglyph(FAR struct nxterm_state_s *priv, uint8_t ndx)
+{
+  FAR struct nxterm_glyph_s *glyph = &priv->glyph[ndx];
+  FAR uint8_t *prev;
+
+  /* Remove the glyph from its hash bucket */
+
+  prev = &priv->hash[NXTERM_HASH(glyph->code)];
+  while (*prev != ndx)
+    {
+      DEBUGASSERT(*prev != NXTERM_NOGLYPH);
+      prev = &priv->glyph[*prev].hlink;
+    }
+
+  *prev = glyph->hlink;
+
+  /* Remove the glyph from the LRU list */
+
+  if (glyph->blink != NXTERM_NOGLYPH)
+    {
+      priv->glyph[glyph->blink].flink = glyph->flink;
+    }
+  else
+    {
+      priv->mru = glyph->flink;
+    }
+
+  if (glyph->flink != NXTERM_NOGLYPH)
+    {
+      priv->glyph[glyph->flink].blink = glyph->blink;
+    }
+  else
+    {
+      priv->lru = glyph->blink;
+    }
+}
+
 /****************************************************************************
  * Name: nxterm_freeglyph
+ *
+ * Description:
+ *   Release the bitmap of an unlinked glyph and return the glyph to the
+ *   list of unused glyphs.
+ *
  ****************************************************************************/
 
-static void nxterm_freeglyph(FAR struct nxterm_glyph_s *glyph)
+static void nxterm_freeglyph(FAR struct nxterm_state_s *priv, uint8_t ndx)
 {
+  FAR struct nxterm_glyph_s *glyph = &priv->glyph[ndx];
+
   if (glyph->bitmap)
     {
       kmm_free(glyph->bitmap);
     }
+
   memset(glyph, 0, sizeof(struct nxterm_glyph_s));
+  glyph->hlink    = priv->freeglyph;
+  priv->freeglyph = ndx;
 }
 
 /****************************************************************************
  * Name: nxterm_allocglyph
+ *
+ * Description:
+ *   Get an unlinked glyph.  If the cache is full, the least recently used
+ *   glyph is replaced.
+ *
  ****************************************************************************/
 
-static inline FAR struct nxterm_glyph_s *
-nxterm_allocglyph(FAR struct nxterm_state_s *priv)
+static inline uint8_t nxterm_allocglyph(FAR struct nxterm_state_s *priv)
 {
-  FAR struct nxterm_glyph_s *glyph = NULL;
-  FAR struct nxterm_glyph_s *luglyph = NULL;
-  uint8_t luusecnt;
-  int i;
+  FAR struct nxterm_glyph_s *glyph;
+  uint8_t ndx;
 
-  /* Search through the glyph cache looking for an unused glyph.  Also, keep
-   * track of the least used glyph as well.  We need that if we have to replace
-   * a glyph in the cache.
-   */
+  /* Is there an unused glyph? */
 
-   for (i = 0; i < priv->maxglyphs; i++)
+  ndx = priv->freeglyph;
+  if (ndx != NXTERM_NOGLYPH)
     {
-      /* Is this glyph in use? */
+      /* Yes.. remove it from the list of unused glyphs */
 
-      glyph = &priv->glyph[i];
-      if (!glyph->usecnt)
-        {
-          /* No.. return this glyph with a use count of one */
-
-          glyph->usecnt = 1;
-          return glyph;
-        }
-
-      /* Yes.. check for the least recently used */
-
-      if (!luglyph || glyph->usecnt < luglyph->usecnt)
-        {
-          luglyph = glyph;
-        }
+      priv->freeglyph = priv->glyph[ndx].hlink;
+      return ndx;
     }
 
-  /* If we get here, the glyph cache is full.  We replace the least used
-   * glyph with the one we need now. (luglyph can't be NULL).
+  /* No.. the glyph cache is full.  Replace the least recently used glyph
+   * (the cache can't be empty here).
    */
 
-  luusecnt = luglyph->usecnt;
-  nxterm_freeglyph(luglyph);
+  ndx = priv->lru;
+  DEBUGASSERT(ndx != NXTERM_NOGLYPH);
 
-  /* But lets decrement all of the usecnts so that the new one one be so
-   * far behind in the counts as the older ones.
-   */
+  nxterm_unlinkglyph(priv, ndx);
 
-  if (luusecnt > 1)
+  glyph = &priv->glyph[ndx];
+  if (glyph->bitmap)
     {
-       uint8_t decr = luusecnt - 1;
-
-       for (i = 0; i < priv->maxglyphs; i++)
-        {
-          /* Is this glyph in use? */
-
-          glyph = &priv->glyph[i];
-          if (glyph->usecnt > decr)
-            {
-              glyph->usecnt -= decr;
-            }
-        }
+      kmm_free(glyph->bitmap);
     }
 
-  /* Then return the least used glyph */
-
-  luglyph->usecnt = 1;
-  return luglyph;
+  memset(glyph, 0, sizeof(struct nxterm_glyph_s));
+  return ndx;
 }
 
 /****************************************************************************
@@ -185,27 +245,32 @@ nxterm_allocglyph(FAR struct nxterm_state_s *priv)
 static FAR struct nxterm_glyph_s *
 nxterm_findglyph(FAR struct nxterm_state_s *priv, uint8_t ch)
 {
-  int i;
+  FAR struct nxterm_glyph_s *glyph;
+  uint8_t ndx;
 
-  /* First, try to find the glyph in the cache of pre-rendered glyphs */
+  /* Search the hash bucket for the glyph */
 
-   for (i = 0; i < priv->maxglyphs; i++)
+  for (ndx = priv->hash[NXTERM_HASH(ch)];
+       ndx != NXTERM_NOGLYPH;
+       ndx = glyph->hlink)
     {
-      FAR struct nxterm_glyph_s *glyph = &priv->glyph[i];
-      if (glyph->usecnt > 0 && glyph->code == ch)
+      glyph = &priv->glyph[ndx];
+      if (glyph->code == ch)
         {
-          /* Increment the use count (unless it is already at the max) */
+          /* Found it.  Make it the most recently used glyph (this also
+           * moves it to the front of its hash bucket).
+           */
 
-          if (glyph->usecnt < MAX_USECNT)
+          if (priv->mru != ndx)
             {
-               glyph->usecnt++;
+              nxterm_unlinkglyph(priv, ndx);
+              nxterm_linkglyph(priv, ndx);
             }
 
-          /* And return the glyph that we found */
-
           return glyph;
         }
     }
+
   return NULL;
 }
 
@@ -222,6 +287,7 @@ nxterm_renderglyph(FAR struct nxterm_state_s *priv,
 #if CONFIG_NXTERM_BPP < 8
   nxgl_mxpixel_t pixel;
 #endif
+  uint8_t ndx;
   int bmsize;
   int row;
   int col;
@@ -229,7 +295,8 @@ nxterm_renderglyph(FAR struct nxterm_state_s *priv,
 
   /* Allocate the glyph (always succeeds) */
 
-  glyph         = nxterm_allocglyph(priv);
+  ndx           = nxterm_allocglyph(priv);
+  glyph         = &priv->glyph[ndx];
   glyph->code   = ch;
 
   /* Get the dimensions of the glyph */
@@ -319,9 +386,21 @@ nxterm_renderglyph(FAR struct nxterm_state_s *priv,
           /* Actually, the RENDERER never returns a failure */
 
           gdbg("nxterm_renderglyph: RENDERER failed\n");
-          nxterm_freeglyph(glyph);
+          nxterm_freeglyph(priv, ndx);
           glyph = NULL;
         }
+      else
+        {
+          /* Add the new glyph to the cache */
+
+          nxterm_linkglyph(priv, ndx);
+        }
+    }
+  else
+    {
+      gdbg("nxterm_renderglyph: Failed to allocate %d bytes\n", bmsize);
+      nxterm_freeglyph(priv, ndx);
+      glyph = NULL;
     }
 
   return glyph;
@@ -387,6 +466,30 @@ nxterm_getglyph(NXHANDLE hfont, FAR struct nxterm_state_s *priv, uint8_t ch)
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: nxterm_initglyphs
+ *
+ * Description:
+ *   Initialize the glyph cache:  All glyphs are unused.
+ *
+ ****************************************************************************/
+
+void nxterm_initglyphs(FAR struct nxterm_state_s *priv)
+{
+  int i;
+
+  memset(priv->hash, NXTERM_NOGLYPH, NXTERM_HASHSIZE);
+  priv->mru       = NXTERM_NOGLYPH;
+  priv->lru       = NXTERM_NOGLYPH;
+  priv->freeglyph = NXTERM_NOGLYPH;
+
+  for (i = priv->maxglyphs - 1; i >= 0; i--)
+    {
+      priv->glyph[i].hlink = priv->freeglyph;
+      priv->freeglyph      = i;
+    }
+}
+
 /****************************************************************************
  * Name: nxterm_addchar
  *
@@ -408,7 +511,7 @@ nxterm_addchar(NXHANDLE hfont, FAR struct nxterm_state_s *priv, uint8_t ch)
     {
       /* Yes, setup the bitmap information */
 
-      bm        = &priv->bm[priv->nchars];
+      bm        = NXTERM_BM(priv, priv->nchars);
       bm->code  = ch;
       bm->flags = 0;
       bm->pos.x = priv->fpos.x;
@@ -505,7 +608,7 @@ int nxterm_backspace(FAR struct nxterm_state_s *priv)
       /* Yes.. Get the index to the last bitmap on the display */
 
       ndx = priv->nchars - 1;
-      bm  = &priv->bm[ndx];
+      bm  = NXTERM_BM(priv, ndx);
 
       /* Erase the character from the display */
 
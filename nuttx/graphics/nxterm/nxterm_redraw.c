@@ -146,7 +146,7 @@ void nxterm_redraw(NXTERM handle, FAR const struct nxgl_rect_s *rect, bool more)
 
   for (i = 0; i < priv->nchars; i++)
     {
-      nxterm_fillchar(priv, rect, &priv->bm[i]);
+      nxterm_fillchar(priv, rect, NXTERM_BM(priv, i));
     }
 
   (void)nxterm_sempost(priv);
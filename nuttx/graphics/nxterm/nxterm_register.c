@@ -134,6 +134,7 @@ FAR struct nxterm_state_s *
   /* Set up the font glyph bitmap cache */
 
   priv->maxglyphs = CONFIG_NXTERM_CACHESIZE;
+  nxterm_initglyphs(priv);
 
   /* Set the initial display position */
 
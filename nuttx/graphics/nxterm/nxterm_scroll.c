@@ -125,7 +125,7 @@ static inline void nxterm_movedisplay(FAR struct nxterm_state_s *priv,
 
       for (i = 0; i < priv->nchars; i++)
         {
-          bm = &priv->bm[i];
+          bm = NXTERM_BM(priv, i);
           if (bm->pos.y <= rect.pt2.y && bm->pos.y + priv->fheight >= rect.pt1.y)
             {
               nxterm_fillchar(priv, &rect, bm);
@@ -156,8 +156,9 @@ static inline void nxterm_movedisplay(FAR struct nxterm_state_s *priv,
 
   scrollheight += CONFIG_NXTERM_LINESEPARATION;
 
-  /* Move the display in the range of 0-height up one scrollheight.  The
-   * line at the bottom will be reset to the background color automatically.
+  /* Move the display up one scrollheight.  Only the rows that hold text
+   * need to be moved:  After scrolling, the last line of text starts at
+   * 'bottom'.  Everything below that line is already the background color.
    *
    * The source rectangle to be moved.
    */
@@ -165,7 +166,12 @@ static inline void nxterm_movedisplay(FAR struct nxterm_state_s *priv,
   rect.pt1.x = 0;
   rect.pt1.y = scrollheight;
   rect.pt2.x = priv->wndo.wsize.w - 1;
-  rect.pt2.y = priv->wndo.wsize.h - 1;
+  rect.pt2.y = bottom + scrollheight + priv->fheight - 1;
+
+  if (rect.pt2.y > priv->wndo.wsize.h - 1)
+    {
+      rect.pt2.y = priv->wndo.wsize.h - 1;
+    }
 
   /* The offset that determines how far to move the source rectangle */
 
@@ -174,15 +180,22 @@ static inline void nxterm_movedisplay(FAR struct nxterm_state_s *priv,
 
   /* Move the source rectangle upward by the scrollheight */
 
-  ret = priv->ops->move(priv, &rect, &offset);
-  if (ret < 0)
+  if (rect.pt2.y >= rect.pt1.y)
     {
-      gdbg("Move failed: %d\n", errno);
+      ret = priv->ops->move(priv, &rect, &offset);
+      if (ret < 0)
+        {
+          gdbg("Move failed: %d\n", errno);
+        }
     }
 
-  /* Finally, clear the vacated bottom part of the display */
+  /* Finally, clear the vacated rows at the bottom of the moved region */
 
-  rect.pt1.y = priv->wndo.wsize.h - scrollheight;
+  rect.pt1.y = rect.pt2.y - scrollheight + 1;
+  if (rect.pt1.y < 0)
+    {
+      rect.pt1.y = 0;
+    }
 
   ret = priv->ops->fill(priv, &rect, priv->wndo.wcolor);
   if (ret < 0)
@@ -202,45 +215,44 @@ static inline void nxterm_movedisplay(FAR struct nxterm_state_s *priv,
 
 void nxterm_scroll(FAR struct nxterm_state_s *priv, int scrollheight)
 {
+  FAR struct nxterm_bitmap_s *bm;
   int i;
-  int j;
 
-  /* Adjust the vertical position of each character */
+  /* Discard the characters that have scrolled off the top of the display.
+   * Characters are added in display order, so these are always the oldest
+   * characters at the head of the bm[] ring buffer.
+   */
 
-  for (i = 0; i < priv->nchars; )
+  while (priv->nchars > 0)
     {
-      FAR struct nxterm_bitmap_s *bm = &priv->bm[i];
+      /* Has any part of the oldest character scrolled off the screen? */
 
-      /* Has any part of this character scrolled off the screen? */
-
-      if (bm->pos.y < scrollheight + CONFIG_NXTERM_LINESEPARATION)
+      bm = &priv->bm[priv->bmhead];
+      if (bm->pos.y >= scrollheight + CONFIG_NXTERM_LINESEPARATION)
         {
-          /* Yes... Delete the character by moving all of the data */
-
-          for (j = i; j < priv->nchars-1; j++)
-            {
-              memcpy(&priv->bm[j], &priv->bm[j+1], sizeof(struct nxterm_bitmap_s));
-            }
-
-          /* Decrement the number of cached characters ('i' is not incremented
-           * in this case because it already points to the next character)
-           */
+          /* No.. then neither has any following character */
 
-          priv->nchars--;
+          break;
         }
 
-      /* No.. just decrement its vertical position (moving it "up" the
-       * display by one line).
-       */
+      /* Yes.. Delete the character by advancing the head of the ring */
 
-      else
+      if (++priv->bmhead >= priv->maxchars)
         {
-          bm->pos.y -= scrollheight;
+          priv->bmhead = 0;
+        }
 
-          /* We are keeping this one so increment to the next character */
+      priv->nchars--;
+    }
 
-          i++;
-        }
+  /* Decrement the vertical position of each remaining character (moving it
+   * "up" the display by one line).
+   */
+
+  for (i = 0; i < priv->nchars; i++)
+    {
+      bm = NXTERM_BM(priv, i);
+      bm->pos.y -= scrollheight;
     }
 
   /* And move the next display position up by one line as well */
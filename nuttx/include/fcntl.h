@@ -108,6 +108,8 @@
 #define F_SETLKW    12 /* Like F_SETLK, but wait for lock to become available */
 #define F_SETOWN    13 /* Set pid that will receive SIGIO and SIGURG signals for fd */
 #define F_SETSIG    14 /* Set the signal to be sent */
+#define F_GETPIPE_SZ 15 /* Get the buffer size of a pipe or FIFO (linux) */
+#define F_SETPIPE_SZ 16 /* Set the buffer size of a pipe or FIFO (linux) */
 
 /* For posix fcntl() and lockf() */
 
@@ -159,7 +159,9 @@ struct binfmt_s
 
   CODE int (*load)(FAR struct binary_s *bin);
 
-  /* Unload module callback */
+  /* Unload module callback.  Called by unload_module() after the
+   * module's destructors have run.
+   */
 
   CODE int (*unload)(FAR struct binary_s *bin);
 };
@@ -71,6 +71,21 @@
 #  define CONFIG_ELF_BUFFERINCR 32
 #endif
 
+#ifndef CONFIG_ELF_CACHESIZE
+#  define CONFIG_ELF_CACHESIZE 512
+#endif
+
+#ifndef CONFIG_ELF_RELOCBATCH
+#  define CONFIG_ELF_RELOCBATCH 32
+#endif
+
+/* The file read cache holds this many chunks of CONFIG_ELF_CACHESIZE bytes.
+ * Two are enough to keep the symbol table and the symbol string table
+ * cached while symbols are resolved.
+ */
+
+#define ELF_CACHE_NCHUNKS 2
+
 /* Allocation array size and indices */
 
 #define LIBELF_ELF_ALLOC     0
@@ -86,6 +101,31 @@
  * Public Types
  ****************************************************************************/
 
+/* One chunk of the file read cache */
+
+#if CONFIG_ELF_CACHESIZE > 0
+struct elf_cache_s
+{
+  FAR uint8_t       *buffer;     /* CONFIG_ELF_CACHESIZE bytes of file data */
+  off_t              offset;     /* File offset of buffer[0] */
+  size_t             nbytes;     /* Number of valid bytes in buffer[] */
+  uint32_t           lastuse;    /* Access sequence number for LRU replacement */
+};
+#endif
+
+/* Load-time statistics */
+
+#ifdef CONFIG_ELF_LOADSTATS
+struct elf_loadstats_s
+{
+  uint32_t           nreads;     /* Number of read() calls on the file */
+  uint32_t           nbytes;     /* Number of bytes read from the file */
+  uint32_t           ncached;    /* Number of reads satisfied from the cache */
+  uint32_t           nrelocs;    /* Number of relocations performed */
+  uint32_t           nsymcached; /* Number of symbols found in the symbol cache */
+};
+#endif
+
 /* This struct provides a desciption of the currently loaded instantiation
  * of an ELF binary.
  */
@@ -137,6 +177,39 @@ struct elf_loadinfo_s
   save_addrenv_t     oldenv;     /* Saved address environment */
 #endif
 
+  /* File access.
+   *
+   * filemap - If the file system supports execute-in-place (FIOC_MMAP),
+   *   this is the address of the file image in memory and all reads are
+   *   simple copies.
+   * filepos - The current file position.  A seek is necessary only if a
+   *   read starts somewhere else.
+   * cache   - Small reads (symbols, relocations, symbol names) are satisfied
+   *   from chunks of the file that are read in their entirety.
+   */
+
+  FAR const uint8_t *filemap;    /* Memory-mapped file image (or NULL) */
+  off_t              filepos;    /* Current file position */
+#if CONFIG_ELF_CACHESIZE > 0
+  struct elf_cache_s cache[ELF_CACHE_NCHUNKS];
+  uint32_t           cacheseq;   /* Cache access sequence number */
+#endif
+
+  /* Resolved symbols.  symcache[n] holds the resolved value of symbol n;
+   * symstate[n] tells if that entry is valid.  This avoids reading and
+   * resolving a symbol each time that a relocation refers to it.
+   */
+
+#ifdef CONFIG_ELF_SYMCACHE
+  FAR Elf32_Sym     *symcache;   /* Resolved symbol table entries */
+  FAR uint8_t       *symstate;   /* State of each symcache[] entry */
+  int                nsyms;      /* Number of symbols in the symbol table */
+#endif
+
+#ifdef CONFIG_ELF_LOADSTATS
+  struct elf_loadstats_s stats;  /* Load-time statistics */
+#endif
+
   uint16_t           symtabidx;  /* Symbol table section index */
   uint16_t           strtabidx;  /* String table section index */
   uint16_t           buflen;     /* size of iobuffer[] */
@@ -42,6 +42,8 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -152,6 +154,38 @@ FAR const struct symtab_s *
 symtab_findorderedbyname(FAR const struct symtab_s *symtab,
                          FAR const char *name, int nsyms);
 
+/****************************************************************************
+ * Name: symtab_hash
+ *
+ * Description:
+ *   Return the hash of a symbol name.  This is the System V ELF hash
+ *   function; tools/mksymtab.c uses the same function to lay out hashed
+ *   symbol tables.
+ *
+ ****************************************************************************/
+
+uint32_t symtab_hash(FAR const char *name);
+
+/****************************************************************************
+ * Name: symtab_findhashedbyname
+ *
+ * Description:
+ *   Find the symbol in the symbol table with the matching name.  This
+ *   version assumes that the table was generated by 'mksymtab -h' so that
+ *   each symbol lies at, or shortly after, the slot selected by its hash.
+ *   Unused slots have a NULL sym_name.  Any other table is still searched
+ *   correctly, but in linear time.
+ *
+ * Returned Value:
+ *   A reference to the symbol table entry if an entry with the matching
+ *   name is found; NULL is returned if the entry is not found.
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *
+symtab_findhashedbyname(FAR const struct symtab_s *symtab,
+                        FAR const char *name, int nsyms);
+
 /****************************************************************************
  * Name: symtab_findbyvalue
  *
@@ -0,0 +1,231 @@
+/****************************************************************************
+ * include/nuttx/blkqueue.h
+ *
+ *   Copyright (C) 2014 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_BLKQUEUE_H
+#define __INCLUDE_NUTTX_BLKQUEUE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <semaphore.h>
+
+#ifdef CONFIG_DRVR_BLKQUEUE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Request operations */
+
+#define BLKREQ_READ        0  /* Transfer from the media to the buffer */
+#define BLKREQ_WRITE       1  /* Transfer from the buffer to the media */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Data transfer callouts.  These are the synchronous transfer methods of
+ * the block device.  They are called on the thread of the block I/O
+ * daemon and must return the number of blocks transferred or a negated
+ * errno value on failure.
+ */
+
+typedef ssize_t (*blkqread_t)(FAR void *dev, FAR uint8_t *buffer,
+                              off_t startblock, size_t nblocks);
+typedef ssize_t (*blkqwrite_t)(FAR void *dev, FAR const uint8_t *buffer,
+                               off_t startblock, size_t nblocks);
+
+/* One asynchronous transfer request.  The request structure is owned by
+ * the submitter and must persist until the completion callback has been
+ * called.  The callback is invoked on the thread of the block I/O daemon;
+ * it must not block for long and must not wait for another request on the
+ * same queue.
+ */
+
+struct blkreq_s;
+typedef CODE void (*blkreq_callback_t)(FAR struct blkreq_s *req);
+
+struct blkreq_s
+{
+  /* These values must be provided by the submitter */
+
+  uint8_t       op;              /* BLKREQ_READ or BLKREQ_WRITE */
+  FAR uint8_t  *buffer;          /* Data buffer (nblocks * blocksize bytes) */
+  off_t         startblock;      /* First block to transfer */
+  size_t        nblocks;         /* Number of blocks to transfer */
+  blkreq_callback_t callback;    /* Called when the transfer completes */
+  FAR void     *priv;            /* For use by the submitter */
+
+  /* Result of the transfer:  nblocks on success or a negated errno value */
+
+  ssize_t       result;
+
+  /* The submitter should never modify any of the remaining fields */
+
+  FAR struct blkreq_s *flink;    /* Link in the queue of pending requests */
+  FAR struct blkreq_s *mlink;    /* Requests merged into one transfer */
+  uint32_t      seqno;           /* Submission order */
+};
+
+/* This structure holds the state of one request queue.  In typical usage,
+ * an instance of this structure is declared within each block driver
+ * status structure (or within the state of the client of the driver) and
+ * initialized like:
+ *
+ *  struct foo_dev_s *priv;
+ *  ...
+ *  ... [Setup blocksize, maxblocks, dev, read, write] ...
+ *  ret = blkq_initialize(&priv->blkqueue);
+ *
+ * Pending requests are serviced in ascending block order (a one-way
+ * elevator) starting at the block following the previous transfer.
+ * Requests that overlap an earlier request are never reordered before it.
+ * Adjacent requests for the same operation whose buffers are also
+ * adjacent in memory are merged into a single transfer.
+ */
+
+struct blkqueue_s
+{
+  /********************************************************************/
+  /* These values must be provided by the user prior to calling
+   * blkq_initialize()
+   */
+
+  uint16_t      blocksize;       /* The size of one block */
+  uint16_t      maxblocks;       /* Largest merged transfer (0: no limit) */
+  FAR void     *dev;             /* Device state passed to callout functions */
+  blkqread_t    read;            /* Callout to read blocks from the media */
+  blkqwrite_t   write;           /* Callout to write blocks to the media */
+
+  /********************************************************************/
+  /* The user should never modify any of the remaining fields */
+
+  FAR struct blkqueue_s *flink;  /* Link in the list of queues with work */
+  FAR struct blkreq_s *pending;  /* Pending requests sorted by block */
+  off_t         headpos;         /* Block following the last transfer */
+  uint32_t      seqno;           /* Next submission number */
+  bool          ready;           /* True: Queue is in the ready list */
+  bool          busy;            /* True: A transfer is in progress */
+  uint8_t       nwaiters;        /* Number of threads waiting on donesem */
+  sem_t         donesem;         /* Posted when a transfer completes */
+
+  /* Statistics */
+
+  uint32_t      nsubmitted;      /* Number of requests submitted */
+  uint32_t      ntransfers;      /* Number of transfers performed */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: blkq_initialize
+ *
+ * Description:
+ *   Initialize a request queue.  The block I/O daemon is started when the
+ *   first queue is initialized.
+ *
+ ****************************************************************************/
+
+int blkq_initialize(FAR struct blkqueue_s *queue);
+
+/****************************************************************************
+ * Name: blkq_submit
+ *
+ * Description:
+ *   Queue an asynchronous transfer request.  The request callback will be
+ *   called on the block I/O daemon thread when the transfer completes.
+ *
+ ****************************************************************************/
+
+int blkq_submit(FAR struct blkqueue_s *queue, FAR struct blkreq_s *req);
+
+/****************************************************************************
+ * Name: blkq_cancel
+ *
+ * Description:
+ *   Cancel a request.  If the transfer of the request has not yet started,
+ *   the request is removed from the queue and its callback will never be
+ *   called.  If the transfer is in progress, this function waits for it to
+ *   complete (and for its callback to return).  In either case, the
+ *   request structure is no longer used by the queue on return.
+ *
+ *   This function must not be called from a request callback.
+ *
+ * Returned Value:
+ *   OK if the request was removed before its transfer started; -EALREADY
+ *   if the transfer was already performed and its callback was called.
+ *
+ ****************************************************************************/
+
+int blkq_cancel(FAR struct blkqueue_s *queue, FAR struct blkreq_s *req);
+
+/****************************************************************************
+ * Name: blkq_uninitialize
+ *
+ * Description:
+ *   Discard all pending requests (their callbacks are not called) and wait
+ *   for any transfer in progress to complete.  On return, the queue no
+ *   longer references the device or any request and may be freed.
+ *
+ *   This function must not be called from a request callback.
+ *
+ ****************************************************************************/
+
+void blkq_uninitialize(FAR struct blkqueue_s *queue);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CONFIG_DRVR_BLKQUEUE */
+#endif /* __INCLUDE_NUTTX_BLKQUEUE_H */
@@ -0,0 +1,184 @@
+/****************************************************************************
+ * include/nuttx/crypto/aes.h
+ * Software AES block cipher and modes of operation
+ *
+ *   Copyright (C) 2014 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_CRYPTO_AES_H
+#define __INCLUDE_NUTTX_CRYPTO_AES_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef CONFIG_CRYPTO_SW_AES
+
+/****************************************************************************
+ * Pre-Processor Definitions
+ ****************************************************************************/
+
+#define AES_BLOCK_SIZE    16  /* Size of one AES block in bytes */
+#define AES_MAXROUNDS     14  /* Number of rounds with a 256-bit key */
+#define AES_GCM_IVSIZE    12  /* Recommended GCM IV size in bytes */
+#define AES_GCM_TAGSIZE   16  /* Full GCM authentication tag size */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* An expanded AES key.  The format of the round keys depends on the AES
+ * implementation that was selected when the key was set: the table-driven
+ * and accelerated implementations keep the encryption and decryption key
+ * schedules; the bitsliced implementation keeps one bitsliced schedule.
+ */
+
+struct aes_ctx_s
+{
+  uint32_t rk[8 * (AES_MAXROUNDS + 1)]; /* Round keys */
+  uint8_t  nr;                          /* Number of rounds: 10, 12 or 14 */
+  bool     accel;                       /* Round keys are for up_aes_*() */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: aes_setkey
+ *
+ * Description:
+ *   Expand an AES key.
+ *
+ * Input Parameters:
+ *   ctx     - The context to hold the expanded key
+ *   key     - The key
+ *   keysize - The size of the key in bytes: 16, 24 or 32
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EINVAL if the key size is not supported.
+ *
+ ****************************************************************************/
+
+int aes_setkey(FAR struct aes_ctx_s *ctx, FAR const void *key,
+               uint32_t keysize);
+
+/****************************************************************************
+ * Name: aes_crypt
+ *
+ * Description:
+ *   Encrypt or decrypt a whole number of blocks in ECB, CBC or CTR mode
+ *   (AES_MODE_* in nuttx/crypto/crypto.h).  For CBC and CTR, iv holds the
+ *   IV or the initial counter block and is updated so that a message can
+ *   be processed with several calls.  The CTR counter is a 128-bit big-
+ *   endian integer.  out may be the same buffer as in.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EINVAL if the mode or size is not supported.
+ *
+ ****************************************************************************/
+
+int aes_crypt(FAR const struct aes_ctx_s *ctx, FAR void *out,
+              FAR const void *in, uint32_t size, FAR uint8_t *iv, int mode,
+              int encrypt);
+
+/****************************************************************************
+ * Name: aes_gcm_encrypt and aes_gcm_decrypt
+ *
+ * Description:
+ *   AES-GCM authenticated encryption (NIST SP 800-38D).  size and aadlen
+ *   may be any number of bytes.  The tag is written by aes_gcm_encrypt()
+ *   and verified by aes_gcm_decrypt(); taglen may be 4 to 16 bytes.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EINVAL if an argument is invalid; -EBADMSG
+ *   from aes_gcm_decrypt() if the tag does not match.  The output of a
+ *   failed decryption must not be used.
+ *
+ ****************************************************************************/
+
+int aes_gcm_encrypt(FAR const struct aes_ctx_s *ctx, FAR void *out,
+                    FAR const void *in, size_t size, FAR const void *iv,
+                    size_t ivlen, FAR const void *aad, size_t aadlen,
+                    FAR void *tag, size_t taglen);
+int aes_gcm_decrypt(FAR const struct aes_ctx_s *ctx, FAR void *out,
+                    FAR const void *in, size_t size, FAR const void *iv,
+                    size_t ivlen, FAR const void *aad, size_t aadlen,
+                    FAR const void *tag, size_t taglen);
+
+/****************************************************************************
+ * Name: up_aes_setkey, up_aes_ecb, up_aes_cbc, up_aes_ctr
+ *
+ * Description:
+ *   Optional architecture-specific AES acceleration, used when
+ *   CONFIG_CRYPTO_AES_ARCHACCEL is selected.  up_aes_setkey() expands the
+ *   key into ctx->rk in the format needed by the accelerator and returns
+ *   false if the accelerator is not available at run time; the portable
+ *   implementation is used in that case.  The remaining functions process
+ *   nblocks whole blocks with a key expanded by up_aes_setkey().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_CRYPTO_AES_ARCHACCEL
+bool up_aes_setkey(FAR struct aes_ctx_s *ctx, FAR const uint8_t *key,
+                   uint32_t keysize);
+void up_aes_ecb(FAR const struct aes_ctx_s *ctx, FAR uint8_t *out,
+                FAR const uint8_t *in, size_t nblocks, int encrypt);
+void up_aes_cbc(FAR const struct aes_ctx_s *ctx, FAR uint8_t *out,
+                FAR const uint8_t *in, size_t nblocks, FAR uint8_t *iv,
+                int encrypt);
+void up_aes_ctr(FAR const struct aes_ctx_s *ctx, FAR uint8_t *out,
+                FAR const uint8_t *in, size_t nblocks, FAR uint8_t *ctr);
+#endif
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CONFIG_CRYPTO_SW_AES */
+#endif /* __INCLUDE_NUTTX_CRYPTO_AES_H */
@@ -41,6 +41,8 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+
+#include <stdint.h>
 #include <debug.h>
 
 /****************************************************************************
@@ -79,6 +81,9 @@ extern "C"
  * Public Function Prototypes
  ************************************************************************************/
 
+int up_cryptoinitialize(void);
+int crypto_test(void);
+
 #if defined(CONFIG_CRYPTO_AES)
 int up_aesinitialize(void);
 int aes_cypher(FAR void *out, FAR const void *in, uint32_t size, FAR const void *iv,
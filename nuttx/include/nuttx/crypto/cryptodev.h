@@ -53,7 +53,9 @@
 #define CRYPTO_AES_ECB          1
 #define CRYPTO_AES_CBC          2
 #define CRYPTO_AES_CTR          3
-#define CRYPTO_ALGORITHM_MAX    1
+#define CRYPTO_AES_GCM          4  /* 12-byte iv, 16-byte tag in mac */
+#define CRYPTO_SHA2_256         5  /* session_op mac, digest in mac */
+#define CRYPTO_ALGORITHM_MAX    5
 
 #define CRYPTO_FLAG_HARDWARE    0x01000000 /* hardware accelerated */
 #define CRYPTO_FLAG_SOFTWARE    0x02000000 /* software implementation */
@@ -0,0 +1,111 @@
+/****************************************************************************
+ * include/nuttx/crypto/sha256.h
+ *
+ *   Copyright (C) 2014 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_CRYPTO_SHA256_H
+#define __INCLUDE_NUTTX_CRYPTO_SHA256_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+
+#ifdef CONFIG_CRYPTO_SHA256
+
+/****************************************************************************
+ * Pre-Processor Definitions
+ ****************************************************************************/
+
+#define SHA256_BLOCK_SIZE   64  /* Size of one SHA-256 input block */
+#define SHA256_DIGEST_SIZE  32  /* Size of the SHA-256 digest */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+struct sha256_ctx_s
+{
+  uint32_t state[8];                  /* Intermediate hash value */
+  uint64_t count;                     /* Number of bytes hashed so far */
+  uint8_t  buffer[SHA256_BLOCK_SIZE]; /* Partial input block */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: sha256_init, sha256_update, sha256_final
+ *
+ * Description:
+ *   Incremental SHA-256 (FIPS 180-4).  sha256_final() writes the
+ *   SHA256_DIGEST_SIZE byte digest and clears the context.
+ *
+ ****************************************************************************/
+
+void sha256_init(FAR struct sha256_ctx_s *ctx);
+void sha256_update(FAR struct sha256_ctx_s *ctx, FAR const void *data,
+                   size_t len);
+void sha256_final(FAR struct sha256_ctx_s *ctx, FAR uint8_t *digest);
+
+/****************************************************************************
+ * Name: sha256_hash
+ *
+ * Description:
+ *   Compute the SHA-256 digest of a buffer in one call.
+ *
+ ****************************************************************************/
+
+void sha256_hash(FAR const void *data, size_t len, FAR uint8_t *digest);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CONFIG_CRYPTO_SHA256 */
+#endif /* __INCLUDE_NUTTX_CRYPTO_SHA256_H */
@@ -121,6 +121,20 @@ struct block_operations
   int     (*ioctl)(FAR struct inode *inode, int cmd, unsigned long arg);
 };
 
+/* This structure is returned by the FIOC_FILEID ioctl command.  A file
+ * system that supports FIOC_FILEID returns a non-zero value in fi_id that
+ * identifies the file within the volume.  fi_generation must change
+ * whenever the contents of the file may have changed or the identifier may
+ * have been reused for a different file (for example, on write, truncation
+ * or unlink).
+ */
+
+struct fs_fileid_s
+{
+  off_t    fi_id;          /* Identifies the file within the volume (0: none) */
+  uint32_t fi_generation;  /* Changes when the file contents or identity change */
+};
+
 /* This structure is provided by a filesystem to describe a mount point.
  * Note that this structure differs from file_operations ONLY in the form of
  * the open method.  Once the file is opened, it can be accessed either as a
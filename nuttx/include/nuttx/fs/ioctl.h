@@ -71,6 +71,7 @@
 #define _WLIOCBASE      (0x1200) /* Wireless modules ioctl commands */
 #define _CFGDIOCBASE    (0x1300) /* Config Data device (app config) ioctl commands */
 #define _TCIOCBASE      (0x1400) /* Timer ioctl commands */
+#define _PIPEIOCBASE    (0x1500) /* Pipe and FIFO ioctl commands */
 
 /* Macros used to manage ioctl commands */
 
@@ -127,6 +128,12 @@
 #define FIONWRITE       _FIOC(0x0006)     /* IN:  Location to return value (int *)
                                            * OUT: Bytes writable to this fd
                                            */
+#define FIOC_FILEID     _FIOC(0x0007)     /* IN:  Location to return value
+                                           *      (struct fs_fileid_s *)
+                                           * OUT: Values that identify the open
+                                           *      file and the generation of its
+                                           *      contents within its volume
+                                           */
 
 /* NuttX file system ioctl definitions **************************************/
 
@@ -203,6 +210,11 @@
                                            *      ProcFS data.
                                            * OUT: None (ioctl return value provides
                                            *      success/failure indication). */
+#define BIOC_FLUSH      _BIOC(0x000B)     /* Write any data held in a block driver
+                                           * cache back to the media.
+                                           * IN:  None
+                                           * OUT: None (ioctl return value provides
+                                           *      success/failure indication). */
 
 /* NuttX MTD driver ioctl definitions ***************************************/
 
@@ -293,6 +305,18 @@
 #define _CFGDIOCVALID(c)   (_IOC_TYPE(c)==_CFGDIOCBASE)
 #define _CFGDIOC(nr)         _IOC(_CFGDIOCBASE,nr)
 
+/* Pipe and FIFO driver ioctl definitions **********************************/
+
+#define _PIPEIOCVALID(c)   (_IOC_TYPE(c)==_PIPEIOCBASE)
+#define _PIPEIOC(nr)       _IOC(_PIPEIOCBASE,nr)
+
+#define PIPEIOC_GETSIZE    _PIPEIOC(0x0001)  /* IN:  Location to return value (int *)
+                                              * OUT: Size of the pipe buffer
+                                              */
+#define PIPEIOC_SETSIZE    _PIPEIOC(0x0002)  /* IN:  New size of the pipe buffer (int)
+                                              * OUT: None
+                                              */
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -50,6 +50,12 @@
  * Pre-Processor Definitions
  ****************************************************************************/
 
+/* Values of the mapsource field of struct mtd_smart_procfs_data_s */
+
+#define SMART_MAPSRC_NONE         0     /* Map not built yet */
+#define SMART_MAPSRC_SCAN         1     /* Map built by scanning the device */
+#define SMART_MAPSRC_CHECKPOINT   2     /* Map restored from a checkpoint */
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -82,6 +88,10 @@ struct mtd_smart_procfs_data_s
   uint8_t             formatversion;    /* Version of the volume format */
   uint32_t            unusedsectors;    /* Number of unused sectors (free when erased) */
   uint32_t            blockerases;      /* Number block erase operations */
+  uint32_t            gccount;          /* Number of garbage collected blocks */
+  uint32_t            gcrelocs;         /* Sectors relocated by garbage collection */
+  uint32_t            scantime;         /* Time to build the map at mount (msec) */
+  uint8_t             mapsource;        /* How the map was built (SMART_MAPSRC_*) */
 
 #ifdef CONFIG_MTD_SMART_SECTOR_ERASE_DEBUG
   FAR const uint8_t*  erasecounts;      /* Array of erase counts per erase block */
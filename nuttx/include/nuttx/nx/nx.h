@@ -223,6 +223,17 @@ struct nx_callback_s
 #endif
 };
 
+/* Statistics returned by nx_batchstats() */
+
+#if defined(CONFIG_NX_MULTIUSER) && defined(CONFIG_NX_BATCH)
+struct nx_batchstats_s
+{
+  uint32_t nmsgs;     /* Number of messages sent to the server */
+  uint32_t ncmds;     /* Number of drawing commands sent in batches */
+  uint32_t nbatches;  /* Number of batches sent */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -458,6 +469,96 @@ int nx_eventnotify(NXHANDLE handle, int signo);
 #  define nx_eventnotify(handle, signo) (OK)
 #endif
 
+/****************************************************************************
+ * Name: nx_batchbegin
+ *
+ * Description:
+ *   Start collecting drawing commands in a client-side batch.  Until the
+ *   matching call to nx_batchend(), nx_setpixel(), nx_fill(),
+ *   nx_filltrapezoid(), nx_move() and nx_bitmap() (and the NXTK
+ *   equivalents) are not sent to the server individually.  They are
+ *   packed into a batch that is sent in one message when it is full, when
+ *   any other request is sent to the server, or when the batch ends.
+ *   Batched bitmaps are copied into the batch, so the caller may re-use
+ *   the bitmap memory as soon as nx_bitmap() returns.  Calls may be nested.
+ *
+ * Input Parameters:
+ *   handle - the handle returned by nx_connect
+ *
+ * Return:
+ *   OK on success; ERROR on failure with errno set appropriately
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NX_MULTIUSER) && defined(CONFIG_NX_BATCH)
+int nx_batchbegin(NXHANDLE handle);
+#else
+#  define nx_batchbegin(handle) (OK)
+#endif
+
+/****************************************************************************
+ * Name: nx_batchend
+ *
+ * Description:
+ *   End a section started by nx_batchbegin().  When the outermost section
+ *   ends, the batch is sent to the server.  nx_batchend() does not wait
+ *   for the server to execute the batch; use nx_fence() for that.
+ *
+ * Input Parameters:
+ *   handle - the handle returned by nx_connect
+ *
+ * Return:
+ *   OK on success; ERROR on failure with errno set appropriately
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NX_MULTIUSER) && defined(CONFIG_NX_BATCH)
+int nx_batchend(NXHANDLE handle);
+#else
+#  define nx_batchend(handle) (OK)
+#endif
+
+/****************************************************************************
+ * Name: nx_fence
+ *
+ * Description:
+ *   Send any batched commands to the server and wait until the server has
+ *   executed every request that this client has sent.
+ *
+ * Input Parameters:
+ *   handle - the handle returned by nx_connect
+ *
+ * Return:
+ *   OK on success; ERROR on failure with errno set appropriately
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NX_MULTIUSER) && defined(CONFIG_NX_BATCH)
+int nx_fence(NXHANDLE handle);
+#else
+#  define nx_fence(handle) (OK)
+#endif
+
+/****************************************************************************
+ * Name: nx_batchstats
+ *
+ * Description:
+ *   Return the number of messages that this client has sent to the server
+ *   and how many drawing commands were sent in batches.
+ *
+ * Input Parameters:
+ *   handle - the handle returned by nx_connect
+ *   stats  - Location to return the statistics
+ *
+ * Return:
+ *   OK on success; ERROR on failure with errno set appropriately
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NX_MULTIUSER) && defined(CONFIG_NX_BATCH)
+int nx_batchstats(NXHANDLE handle, FAR struct nx_batchstats_s *stats);
+#endif
+
 /****************************************************************************
  * Name: nx_openwindow
  *
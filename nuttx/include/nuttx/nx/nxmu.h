@@ -72,6 +72,10 @@
 #define NX_CLIENT_MQNAMEFMT  "/dev/nxc%d"
 #define NX_CLIENT_MXNAMELEN  (16)
 
+#ifndef CONFIG_NX_BATCHSIZE
+#  define CONFIG_NX_BATCHSIZE 512   /* Size of each client command batch */
+#endif
+
 #define NX_MXSVRMSGLEN       (64) /* Maximum size of a client->server command */
 #define NX_MXEVENTLEN        (64) /* Maximum size of an event */
 #define NX_MXCLIMSGLEN       (64) /* Maximum size of a server->client message */
@@ -87,6 +91,12 @@
 
 #define nxmu_semgive(sem)    sem_post(sem) /* To match nxmu_semtake() */
 
+/* Commands in a batch are aligned so that the message structures can be
+ * accessed in place.
+ */
+
+#define NXBATCH_ALIGN(n)     (((n) + sizeof(uintptr_t) - 1) & ~(sizeof(uintptr_t) - 1))
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -116,6 +126,26 @@ struct nxfe_conn_s
   mqd_t crdmq;            /* MQ to read from the server (may be non-blocking) */
   mqd_t cwrmq;            /* MQ to write to the server (blocking) */
 
+#ifdef CONFIG_NX_BATCH
+  /* Batched drawing commands.  There are two batch buffers:  The client
+   * fills one while the server executes the other.
+   */
+
+  FAR uint8_t *batchbuf[2]; /* Batch buffers (allocated by nx_batchbegin) */
+  sem_t batchsem[2];      /* Posted by the server when a batch has executed */
+  uint16_t batchlen;      /* Number of bytes in the batch being filled */
+  uint8_t batchndx;       /* Index of the batch being filled */
+  uint8_t batchbusy;      /* Bit n set:  Batch n is owned by the server */
+  uint8_t batchnest;      /* Nesting level of nx_batchbegin() */
+  uint8_t bpp[CONFIG_NX_NPLANES]; /* Bits per pixel (from the server) */
+
+  /* Statistics */
+
+  uint32_t nmsgs;         /* Number of messages sent to the server */
+  uint32_t ncmds;         /* Number of commands sent in batches */
+  uint32_t nbatches;      /* Number of batches sent */
+#endif
+
   /* These are only usable on the server side of the connection */
 
   mqd_t swrmq;            /* MQ to write to the client */
@@ -158,7 +188,8 @@ enum nxmsg_e
   NX_SVRMSG_SETBGCOLOR,       /* Set the color of the background */
   NX_SVRMSG_MOUSEIN,          /* New mouse report from mouse client */
   NX_SVRMSG_KBDIN,            /* New keyboard report from keyboard client */
-  NX_SVRMSG_REDRAWREQ         /* Request re-drawing of rectangular region */
+  NX_SVRMSG_REDRAWREQ,        /* Request re-drawing of rectangular region */
+  NX_SVRMSG_BATCH             /* Execute a batch of drawing commands */
 };
 
 /* Server-to-Client Message Structures **************************************/
@@ -175,6 +206,7 @@ struct nxclimsg_s
 struct nxclimsg_connected_s
 {
   uint32_t msgid;                  /* NX_CLIMSG_REDRAW_CONNECTED */
+  uint8_t bpp[CONFIG_NX_NPLANES];  /* Bits per pixel of each color plane */
 };
 
 /* The server is now disconnected */
@@ -455,6 +487,20 @@ struct nxsvrmsg_redrawreq_s
   struct nxgl_rect_s rect;         /* Describes the rectangular region to be redrawn */
 };
 
+/* Execute a batch of drawing commands.  The batch holds NX_SVRMSG_SETPIXEL,
+ * NX_SVRMSG_FILL, NX_SVRMSG_FILLTRAP, NX_SVRMSG_MOVE and NX_SVRMSG_BITMAP
+ * messages, each aligned with NXBATCH_ALIGN().  The image of a batched
+ * bitmap immediately follows the bitmap message.
+ */
+
+struct nxsvrmsg_batch_s
+{
+  uint32_t msgid;                  /* NX_SVRMSG_BATCH */
+  FAR const uint8_t *buffer;       /* The batched commands */
+  size_t buflen;                   /* The size of the batch in bytes */
+  sem_t *sem_done;                 /* Semaphore to report when batch is done. */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -560,6 +606,48 @@ int nxmu_sendserver(FAR struct nxfe_conn_s *conn,
 int nxmu_sendwindow(FAR struct nxbe_window_s *wnd, FAR const void *msg,
                     size_t msglen);
 
+/****************************************************************************
+ * Name: nxmu_batchreserve
+ *
+ * Description:
+ *  Reserve space for one drawing command in the batch that the client is
+ *  filling.  If there is not enough space, the batch is sent to the server
+ *  first.
+ *
+ * Input Parameters:
+ *   conn   - A pointer to the server connection structure
+ *   size   - The size of the command in bytes.
+ *
+ * Return:
+ *   A pointer to the reserved space on success; NULL if the command cannot
+ *   be batched.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_BATCH
+FAR void *nxmu_batchreserve(FAR struct nxfe_conn_s *conn, size_t size);
+#endif
+
+/****************************************************************************
+ * Name: nxmu_batchflush
+ *
+ * Description:
+ *  Send the batch that the client is filling (if it is not empty) to the
+ *  server.  Then wait until the other batch buffer is free so that the
+ *  client may continue to fill it.
+ *
+ * Input Parameters:
+ *   conn   - A pointer to the server connection structure
+ *
+ * Return:
+ *   OK on success; ERROR on failure with errno set appropriately
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_BATCH
+int nxmu_batchflush(FAR struct nxfe_conn_s *conn);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
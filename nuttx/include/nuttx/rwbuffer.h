@@ -46,6 +46,7 @@
 #include <stdint.h>
 #include <semaphore.h>
 #include <nuttx/wqueue.h>
+#include <nuttx/blkqueue.h>
 
 #if defined(CONFIG_DRVR_WRITEBUFFER) || defined(CONFIG_DRVR_READAHEAD)
 
@@ -88,7 +89,7 @@ typedef ssize_t (*rwbflush_t)(FAR void *dev, FAR const uint8_t *buffer,
  *  struct foo_dev_s *priv;
  *  ...
  *  ... [Setup blocksize, nblocks, dev, wrmaxblocks, wrflush,
- *       rhmaxblocks, rhreload] ...
+ *       rhmaxblocks, rhreload, wrgranule] ...
  *  ret = rwb_initialize(&priv->rwbuffer);
  */
 
@@ -116,6 +117,17 @@ struct rwbuffer_s
   uint16_t      rhmaxblocks;     /* The number of blocks to buffer in memory */
 #endif
 
+  /* Some flush callouts rewrite more than the blocks that they are given.
+   * For example, a FLASH translation layer may read, erase and rewrite the
+   * whole erase block that holds them.  wrgranule is the number of blocks
+   * in such an aligned unit (0 or 1 if only the given blocks are written).
+   * Reads of any block in a unit being flushed wait for the flush.
+   */
+
+#if defined(CONFIG_DRVR_WRITEBUFFER) && defined(CONFIG_DRVR_BLKQUEUE)
+  uint16_t      wrgranule;       /* Blocks rewritten together by wrflush */
+#endif
+
   /* Callback functions.
    *
    * wrflush.  This callback is normally used to flush the contents of
@@ -142,6 +154,13 @@ struct rwbuffer_s
   uint16_t      wrnblocks;       /* Number of blocks in write buffer */
   off_t         wrblockstart;    /* First block in write buffer */
   off_t         wrexpectedblock; /* Next block expected */
+  int           wrerror;         /* Latched error of an earlier flush */
+#ifdef CONFIG_DRVR_BLKQUEUE
+  uint8_t      *wrflushbuffer;   /* Buffer being flushed asynchronously */
+  sem_t         wrdonesem;       /* Available when no flush is in progress */
+  struct blkreq_s wrreq;         /* Asynchronous flush request */
+  struct blkqueue_s wrqueue;     /* Queue that performs the flushes */
+#endif
 #endif
 
   /* This is the state of the read-ahead buffering */
@@ -184,6 +203,12 @@ ssize_t rwb_write(FAR struct rwbuffer_s *rwb,
                   off_t startblock, size_t blockcount,
                   FAR const uint8_t *wrbuffer);
 
+/* Buffer flushing */
+
+#ifdef CONFIG_DRVR_WRITEBUFFER
+int rwb_flush(FAR struct rwbuffer_s *rwb);
+#endif
+
 /* Character oriented transfers */
 
 #ifdef CONFIG_DRVR_READBYTES
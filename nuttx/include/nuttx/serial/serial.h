@@ -49,6 +49,9 @@
 #ifdef CONFIG_SERIAL_TERMIOS
 #  include <termios.h>
 #endif
+#ifdef CONFIG_SERIAL_TIOCGICOUNT
+#  include <nuttx/fs/ioctl.h>
+#endif
 
 #include <nuttx/fs/fs.h>
 
@@ -83,6 +86,17 @@
   (dev->ops->rxflowcontrol && dev->ops->rxflowcontrol(dev))
 #endif
 
+#ifdef CONFIG_SERIAL_DMA
+#define uart_dmasend(dev) \
+  do { if (dev->ops->dmasend) dev->ops->dmasend(dev); } while (0)
+#define uart_dmareceive(dev) \
+  do { if (dev->ops->dmareceive) dev->ops->dmareceive(dev); } while (0)
+#define uart_dmarxfree(dev) \
+  do { if (dev->ops->dmarxfree) dev->ops->dmarxfree(dev); } while (0)
+#define uart_dmatxavail(dev) \
+  do { if (dev->ops->dmatxavail) dev->ops->dmatxavail(dev); } while (0)
+#endif
+
 /************************************************************************************
  * Public Types
  ************************************************************************************/
@@ -101,6 +115,25 @@ struct uart_buffer_s
   FAR char        *buffer; /* Pointer to the allocated buffer memory */
 };
 
+/* This structure describes one DMA transfer to or from a serial I/O buffer.
+ * Because the I/O buffers are circular, the region to be transferred may
+ * wrap around the end of the buffer and so is described by up to two
+ * contiguous segments.  The upper half sets up the segments; the lower half
+ * sets 'nbytes' to the number of bytes actually transferred before it
+ * reports completion.
+ */
+
+#ifdef CONFIG_SERIAL_DMA
+struct uart_dmaxfer_s
+{
+  FAR char        *buffer;  /* First segment of the transfer */
+  FAR char        *nbuffer; /* Second segment (after wrap-around) */
+  size_t           length;  /* Length of the first segment */
+  size_t           nlength; /* Length of the second segment (may be zero) */
+  volatile size_t  nbytes;  /* Number of bytes actually transferred */
+};
+#endif
+
 /* This structure defines all of the operations providd by the architecture specific
  * logic.  All fields must be provided with non-NULL function pointers by the
  * caller of uart_register().
@@ -191,6 +224,33 @@ struct uart_ops_s
    */
 
   CODE bool (*txempty)(FAR struct uart_dev_s *dev);
+
+#ifdef CONFIG_SERIAL_DMA
+  /* The following methods are optional and may be NULL.  They allow the
+   * lower half to move whole segments of the I/O buffers with DMA (or with
+   * any other block transfer mechanism such as a deep hardware FIFO) rather
+   * than one byte per call.
+   *
+   * dmasend: Start transmitting the segments described by dev->dmatx.  When
+   *   the transfer completes, the lower half sets dev->dmatx.nbytes and
+   *   calls uart_xmitchars_done().
+   * dmareceive: Start receiving into the free segments described by
+   *   dev->dmarx.  When the transfer completes or when the receive line has
+   *   been idle for a character time (the idle-line timeout), the lower half
+   *   sets dev->dmarx.nbytes and calls uart_recvchars_done().
+   * dmarxfree: Called by the upper half when read() has freed space in the
+   *   receive buffer.  A lower half that stalled because the buffer was full
+   *   should restart reception with uart_recvchars_dma().
+   * dmatxavail: Called by the upper half when write() has added data to the
+   *   transmit buffer.  If no transfer is in progress, the lower half should
+   *   start one with uart_xmitchars_dma().
+   */
+
+  CODE void (*dmasend)(FAR struct uart_dev_s *dev);
+  CODE void (*dmareceive)(FAR struct uart_dev_s *dev);
+  CODE void (*dmarxfree)(FAR struct uart_dev_s *dev);
+  CODE void (*dmatxavail)(FAR struct uart_dev_s *dev);
+#endif
 };
 
 /* This is the device structure used by the driver.  The caller of
@@ -237,6 +297,22 @@ struct uart_dev_s
   struct uart_buffer_s xmit;         /* Describes transmit buffer */
   struct uart_buffer_s recv;         /* Describes receive buffer */
 
+#ifdef CONFIG_SERIAL_DMA
+  /* DMA transfers */
+
+  struct uart_dmaxfer_s dmatx;       /* Describes transmit DMA transfer */
+  struct uart_dmaxfer_s dmarx;       /* Describes receive DMA transfer */
+#endif
+
+#ifdef CONFIG_SERIAL_TIOCGICOUNT
+  /* Throughput and error counters.  The upper half maintains 'rx', 'tx'
+   * and 'buf_overrun'; the lower half may update the line status counts
+   * ('overrun', 'frame', 'parity', 'brk').
+   */
+
+  struct serial_icounter_struct icount;
+#endif
+
   /* Driver interface */
 
   FAR const struct uart_ops_s *ops;  /* Arch-specific operations */
@@ -332,6 +408,66 @@ void uart_datareceived(FAR uart_dev_t *dev);
 
 void uart_datasent(FAR uart_dev_t *dev);
 
+/************************************************************************************
+ * Name: uart_xmitchars_dma
+ *
+ * Description:
+ *   Set up dev->dmatx to describe all of the data in the transmit buffer and
+ *   start the lower half DMA transfer.  Does nothing if a transfer is already in
+ *   progress or if the buffer is empty.  Called by the lower half, usually from
+ *   its dmatxavail() method or from its TX interrupt handler.
+ *
+ ************************************************************************************/
+
+#ifdef CONFIG_SERIAL_DMA
+void uart_xmitchars_dma(FAR uart_dev_t *dev);
+#endif
+
+/************************************************************************************
+ * Name: uart_xmitchars_done
+ *
+ * Description:
+ *   Called by the lower half (usually from the DMA completion interrupt) after
+ *   dev->dmatx.nbytes have been sent.  Releases the transmitted data from the
+ *   buffer, wakes up any waiting writers and starts the next transfer if more
+ *   data has been buffered in the meantime.
+ *
+ ************************************************************************************/
+
+#ifdef CONFIG_SERIAL_DMA
+void uart_xmitchars_done(FAR uart_dev_t *dev);
+#endif
+
+/************************************************************************************
+ * Name: uart_recvchars_dma
+ *
+ * Description:
+ *   Set up dev->dmarx to describe all of the free space in the receive buffer and
+ *   start the lower half DMA transfer.  If the buffer is full, no transfer is
+ *   started; the lower half will be notified through its dmarxfree() method when
+ *   read() frees up space.
+ *
+ ************************************************************************************/
+
+#ifdef CONFIG_SERIAL_DMA
+void uart_recvchars_dma(FAR uart_dev_t *dev);
+#endif
+
+/************************************************************************************
+ * Name: uart_recvchars_done
+ *
+ * Description:
+ *   Called by the lower half when a receive DMA transfer completes or when the
+ *   receive line goes idle.  Adds dev->dmarx.nbytes to the receive buffer and
+ *   wakes up any waiting readers.  The lower half should then call
+ *   uart_recvchars_dma() to continue reception.
+ *
+ ************************************************************************************/
+
+#ifdef CONFIG_SERIAL_DMA
+void uart_recvchars_done(FAR uart_dev_t *dev);
+#endif
+
 /************************************************************************************
  * Name: uart_connected
  *
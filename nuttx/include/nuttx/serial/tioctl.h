@@ -206,6 +206,26 @@ struct serial_rs485
   uint32_t delay_rts_after_send;   /* Delay after send (milliseconds) */
 };
 
+/* Structure used with TIOCGICOUNT (Linux compatible).  'rx' and 'tx' count bytes
+ * received and sent; the remaining fields count error events.
+ */
+
+struct serial_icounter_struct
+{
+  int cts;                         /* Modem status line changes (unused) */
+  int dsr;
+  int rng;
+  int dcd;
+  int rx;                          /* Number of bytes received */
+  int tx;                          /* Number of bytes sent */
+  int frame;                       /* Number of framing errors */
+  int overrun;                     /* Number of hardware (FIFO) overruns */
+  int parity;                      /* Number of parity errors */
+  int brk;                         /* Number of breaks received */
+  int buf_overrun;                 /* Number of bytes lost because the RX buffer was full */
+  int reserved[9];
+};
+
 /********************************************************************************************
  * Public Function Prototypes
  ********************************************************************************************/
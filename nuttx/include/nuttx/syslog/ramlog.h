@@ -56,6 +56,8 @@
 #include <nuttx/config.h>
 #include <nuttx/syslog/syslog.h>
 
+#include <stdarg.h>
+
 #ifdef CONFIG_RAMLOG
 
 /****************************************************************************
@@ -78,6 +80,10 @@
  *   level handlers.
  * CONFIG_RAMLOG_NPOLLWAITERS - The number of threads than can be waiting
  *   for this driver on poll().  Default: 4
+ * CONFIG_RAMLOG_BINARY - Save syslog() and lowsyslog() messages in the
+ *   RAM log as the format string pointer plus the raw argument values.
+ *   The messages are formatted when the RAM log is read.  Requires
+ *   CONFIG_RAMLOG_SYSLOG.
  *
  * If CONFIG_RAMLOG_CONSOLE or CONFIG_RAMLOG_SYSLOG is selected, then the
  * following may also be provided:
@@ -93,6 +99,10 @@
 #  undef CONFIG_RAMLOG_SYSLOG
 #endif
 
+#ifndef CONFIG_RAMLOG_SYSLOG
+#  undef CONFIG_RAMLOG_BINARY
+#endif
+
 #if defined(CONFIG_RAMLOG_SYSLOG) && !defined(CONFIG_SYSLOG_DEVPATH)
 #  define CONFIG_SYSLOG_DEVPATH "/dev/ramlog"
 #endif
@@ -109,6 +119,14 @@
 #  define CONFIG_RAMLOG_BUFSIZE 1024
 #endif
 
+#ifndef CONFIG_RAMLOG_BINARY_ARGSIZE
+#  define CONFIG_RAMLOG_BINARY_ARGSIZE 64
+#endif
+
+#ifndef CONFIG_RAMLOG_BINARY_STRLEN
+#  define CONFIG_RAMLOG_BINARY_STRLEN 32
+#endif
+
 /* The normal behavior of the RAM log when used as a SYSLOG is to return
  * end-of-file if there is no data in the RAM log (rather than blocking until
  * data is available).  That allows you to 'cat' the SYSLOG with no ill
@@ -198,6 +216,22 @@ EXTERN int ramlog_consoleinit(void);
 EXTERN int ramlog_sysloginit(void);
 #endif
 
+/****************************************************************************
+ * Name: ramlog_vsyslog
+ *
+ * Description:
+ *   Add a message to the binary RAM log.  The format string pointer and
+ *   the raw argument values are saved and the message is formatted when
+ *   the RAM log is read.  The format string must remain valid until then.
+ *   This is the implementation of vsyslog() and lowvsyslog() when
+ *   CONFIG_RAMLOG_BINARY is selected.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_RAMLOG_BINARY
+EXTERN int ramlog_vsyslog(FAR const char *fmt, va_list ap);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
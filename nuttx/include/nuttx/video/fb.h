@@ -314,6 +314,19 @@ struct fb_vtable_s
   int (*getcursor)(FAR struct fb_vtable_s *vtable, FAR struct fb_cursorattrib_s *attrib);
   int (*setcursor)(FAR struct fb_vtable_s *vtable, FAR struct fb_setcursor_s *settings);
 #endif
+
+  /* The following are provided only if the video hardware has two display pages
+   * per color plane.  getplaneinfo() describes the page that is displayed when the
+   * driver is initialized.  getbackpage() returns the address of the page that is
+   * not being displayed.  flip() displays that page (after the next vertical
+   * blanking interval, if the hardware supports that); the page that was displayed
+   * becomes the back page.  Either method may be NULL.
+   */
+
+#ifdef CONFIG_FB_PAGEFLIP
+  int (*getbackpage)(FAR struct fb_vtable_s *vtable, int planeno, FAR void **fbmem);
+  int (*flip)(FAR struct fb_vtable_s *vtable, int planeno);
+#endif
 };
 
 /****************************************************************************
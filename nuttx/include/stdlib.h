@@ -183,10 +183,17 @@ long int labs(long int j);
 long long int llabs(long long int j);
 #endif
 
-/* Sorting */
+/* Sorting and searching */
 
 void     qsort(void *base, size_t nmemb, size_t size,
                int(*compar)(const void *, const void *));
+FAR void *bsearch(FAR const void *key, FAR const void *base, size_t nmemb,
+                  size_t size, CODE int (*compar)(FAR const void *,
+                  FAR const void *));
+FAR void *bsearch_lower(FAR const void *key, FAR const void *base,
+                        size_t nmemb, size_t size,
+                        CODE int (*compar)(FAR const void *,
+                        FAR const void *));
 
 #ifdef CONFIG_CAN_PASS_STRUCTS
 struct mallinfo mallinfo(void);
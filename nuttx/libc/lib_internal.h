@@ -43,6 +43,7 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdint.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <limits.h>
@@ -120,10 +121,68 @@
 
 #define LIB_BUFLEN_UNKNOWN INT_MAX
 
+/* The shortest representation of a double never needs more than 17
+ * significant digits.
+ */
+
+#define DTOA_MAXDIGITS     17
+
+/* Support for the word-at-a-time string functions.  LIB_HASZERO() is
+ * non-zero if any byte of the word 'w' is zero;  it may report a false
+ * positive only in bytes above a true zero byte, so it is exact for the
+ * purpose of deciding if a word contains a terminator.  LIB_SPLAT()
+ * replicates a byte value into every byte of a word so that a search for
+ * that byte reduces to a search for a zero byte in (w ^ LIB_SPLAT(c)).
+ *
+ * LIB_LOADW() loads a word from a source address.  The source must be
+ * word-aligned unless the architecture supports unaligned loads, in which
+ * case the load may be at any address.
+ */
+
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+#  define LIB_WORDSIZE      sizeof(lib_word_t)
+#  define LIB_WORDMASK      (LIB_WORDSIZE - 1)
+#  define LIB_ALIGNED(p)    (((uintptr_t)(p) & LIB_WORDMASK) == 0)
+#  define LIB_ONES          ((lib_word_t)-1 / 0xff)
+#  define LIB_HIGHS         (LIB_ONES * 0x80)
+#  define LIB_HASZERO(w)    (((w) - LIB_ONES) & ~(w) & LIB_HIGHS)
+#  define LIB_SPLAT(c)      (LIB_ONES * (unsigned char)(c))
+
+#  ifdef CONFIG_ARCH_HAVE_UNALIGNED
+#    define LIB_SRCALIGNED(p) true
+#    define LIB_LOADW(p)    (((FAR const struct lib_uword_s *)(p))->w)
+#  else
+#    define LIB_SRCALIGNED(p) LIB_ALIGNED(p)
+#    define LIB_LOADW(p)    (*(FAR const lib_word_t *)(p))
+#  endif
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+/* The unit of access of the word-at-a-time string functions */
+
+#ifdef CONFIG_LIBC_STRING_64BIT
+typedef uint64_t lib_word_t;
+#else
+typedef uint32_t lib_word_t;
+#endif
+
+/* A packed wrapper used to load a word from an unaligned address.  The
+ * compiler generates a single load instruction where the architecture
+ * supports it.
+ */
+
+#ifdef CONFIG_ARCH_HAVE_UNALIGNED
+struct lib_uword_s
+{
+  lib_word_t w;
+} packed_struct;
+#endif
+#endif
+
 /****************************************************************************
  * Public Variables
  ****************************************************************************/
@@ -183,6 +242,12 @@ char *__dtoa(double d, int mode, int ndigits, int *decpt, int *sign,
              char **rve);
 #endif
 
+/* Defined in lib_fastdtoa.c */
+
+#ifdef CONFIG_LIBC_FLOATINGPOINT
+int __fastdtoa(double value, FAR char *digits, FAR int *decpt);
+#endif
+
 /* Defined in lib_libwrite.c */
 
 ssize_t lib_fwrite(FAR const void *ptr, size_t count, FAR FILE *stream);
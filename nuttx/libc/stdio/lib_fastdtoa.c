@@ -0,0 +1,538 @@
+/****************************************************************************
+ * libc/stdio/lib_fastdtoa.c
+ *
+ *   Copyright (C) 2014 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/compiler.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "lib_internal.h"
+
+#ifdef CONFIG_LIBC_FLOATINGPOINT
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* IEEE 754 double precision layout */
+
+#define DBL_FRACTION_MASK   0x000fffffffffffffull
+#define DBL_HIDDEN_BIT      0x0010000000000000ull
+#define DBL_EXPONENT_SHIFT  52
+#define DBL_EXPONENT_MASK   0x7ff
+#define DBL_EXPONENT_BIAS   1075
+#define DBL_DENORM_EXPONENT (1 - DBL_EXPONENT_BIAS)
+
+/* Grisu digit generation requires the scaled value to have a binary
+ * exponent in this range.
+ */
+
+#define GRISU_MIN_EXPONENT  (-60)
+#define GRISU_MAX_EXPONENT  (-32)
+
+/* The cached powers of ten are 10^k for k = -348, -340, ..., 340 */
+
+#define GRISU_FIRST_POWER   (-348)
+#define GRISU_POWER_STEP    8
+#define GRISU_NPOWERS       87
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A "do-it-yourself floating point" value: f * 2^e */
+
+struct diyfp_s
+{
+  uint64_t f;
+  int      e;
+};
+
+/* A normalized 64-bit approximation of a power of ten, rounded to nearest */
+
+struct cached_power_s
+{
+  uint64_t f;
+  int16_t  e;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct cached_power_s g_cached_powers[GRISU_NPOWERS] =
+{
+  { 0xfa8fd5a0081c0288ull, -1220 },  /* 1e-348 */
+  { 0xbaaee17fa23ebf76ull, -1193 },  /* 1e-340 */
+  { 0x8b16fb203055ac76ull, -1166 },  /* 1e-332 */
+  { 0xcf42894a5dce35eaull, -1140 },  /* 1e-324 */
+  { 0x9a6bb0aa55653b2dull, -1113 },  /* 1e-316 */
+  { 0xe61acf033d1a45dfull, -1087 },  /* 1e-308 */
+  { 0xab70fe17c79ac6caull, -1060 },  /* 1e-300 */
+  { 0xff77b1fcbebcdc4full, -1034 },  /* 1e-292 */
+  { 0xbe5691ef416bd60cull, -1007 },  /* 1e-284 */
+  { 0x8dd01fad907ffc3cull,  -980 },  /* 1e-276 */
+  { 0xd3515c2831559a83ull,  -954 },  /* 1e-268 */
+  { 0x9d71ac8fada6c9b5ull,  -927 },  /* 1e-260 */
+  { 0xea9c227723ee8bcbull,  -901 },  /* 1e-252 */
+  { 0xaecc49914078536dull,  -874 },  /* 1e-244 */
+  { 0x823c12795db6ce57ull,  -847 },  /* 1e-236 */
+  { 0xc21094364dfb5637ull,  -821 },  /* 1e-228 */
+  { 0x9096ea6f3848984full,  -794 },  /* 1e-220 */
+  { 0xd77485cb25823ac7ull,  -768 },  /* 1e-212 */
+  { 0xa086cfcd97bf97f4ull,  -741 },  /* 1e-204 */
+  { 0xef340a98172aace5ull,  -715 },  /* 1e-196 */
+  { 0xb23867fb2a35b28eull,  -688 },  /* 1e-188 */
+  { 0x84c8d4dfd2c63f3bull,  -661 },  /* 1e-180 */
+  { 0xc5dd44271ad3cdbaull,  -635 },  /* 1e-172 */
+  { 0x936b9fcebb25c996ull,  -608 },  /* 1e-164 */
+  { 0xdbac6c247d62a584ull,  -582 },  /* 1e-156 */
+  { 0xa3ab66580d5fdaf6ull,  -555 },  /* 1e-148 */
+  { 0xf3e2f893dec3f126ull,  -529 },  /* 1e-140 */
+  { 0xb5b5ada8aaff80b8ull,  -502 },  /* 1e-132 */
+  { 0x87625f056c7c4a8bull,  -475 },  /* 1e-124 */
+  { 0xc9bcff6034c13053ull,  -449 },  /* 1e-116 */
+  { 0x964e858c91ba2655ull,  -422 },  /* 1e-108 */
+  { 0xdff9772470297ebdull,  -396 },  /* 1e-100 */
+  { 0xa6dfbd9fb8e5b88full,  -369 },  /* 1e-92 */
+  { 0xf8a95fcf88747d94ull,  -343 },  /* 1e-84 */
+  { 0xb94470938fa89bcfull,  -316 },  /* 1e-76 */
+  { 0x8a08f0f8bf0f156bull,  -289 },  /* 1e-68 */
+  { 0xcdb02555653131b6ull,  -263 },  /* 1e-60 */
+  { 0x993fe2c6d07b7facull,  -236 },  /* 1e-52 */
+  { 0xe45c10c42a2b3b06ull,  -210 },  /* 1e-44 */
+  { 0xaa242499697392d3ull,  -183 },  /* 1e-36 */
+  { 0xfd87b5f28300ca0eull,  -157 },  /* 1e-28 */
+  { 0xbce5086492111aebull,  -130 },  /* 1e-20 */
+  { 0x8cbccc096f5088ccull,  -103 },  /* 1e-12 */
+  { 0xd1b71758e219652cull,   -77 },  /* 1e-4 */
+  { 0x9c40000000000000ull,   -50 },  /* 1e4 */
+  { 0xe8d4a51000000000ull,   -24 },  /* 1e12 */
+  { 0xad78ebc5ac620000ull,     3 },  /* 1e20 */
+  { 0x813f3978f8940984ull,    30 },  /* 1e28 */
+  { 0xc097ce7bc90715b3ull,    56 },  /* 1e36 */
+  { 0x8f7e32ce7bea5c70ull,    83 },  /* 1e44 */
+  { 0xd5d238a4abe98068ull,   109 },  /* 1e52 */
+  { 0x9f4f2726179a2245ull,   136 },  /* 1e60 */
+  { 0xed63a231d4c4fb27ull,   162 },  /* 1e68 */
+  { 0xb0de65388cc8ada8ull,   189 },  /* 1e76 */
+  { 0x83c7088e1aab65dbull,   216 },  /* 1e84 */
+  { 0xc45d1df942711d9aull,   242 },  /* 1e92 */
+  { 0x924d692ca61be758ull,   269 },  /* 1e100 */
+  { 0xda01ee641a708deaull,   295 },  /* 1e108 */
+  { 0xa26da3999aef774aull,   322 },  /* 1e116 */
+  { 0xf209787bb47d6b85ull,   348 },  /* 1e124 */
+  { 0xb454e4a179dd1877ull,   375 },  /* 1e132 */
+  { 0x865b86925b9bc5c2ull,   402 },  /* 1e140 */
+  { 0xc83553c5c8965d3dull,   428 },  /* 1e148 */
+  { 0x952ab45cfa97a0b3ull,   455 },  /* 1e156 */
+  { 0xde469fbd99a05fe3ull,   481 },  /* 1e164 */
+  { 0xa59bc234db398c25ull,   508 },  /* 1e172 */
+  { 0xf6c69a72a3989f5cull,   534 },  /* 1e180 */
+  { 0xb7dcbf5354e9beceull,   561 },  /* 1e188 */
+  { 0x88fcf317f22241e2ull,   588 },  /* 1e196 */
+  { 0xcc20ce9bd35c78a5ull,   614 },  /* 1e204 */
+  { 0x98165af37b2153dfull,   641 },  /* 1e212 */
+  { 0xe2a0b5dc971f303aull,   667 },  /* 1e220 */
+  { 0xa8d9d1535ce3b396ull,   694 },  /* 1e228 */
+  { 0xfb9b7cd9a4a7443cull,   720 },  /* 1e236 */
+  { 0xbb764c4ca7a44410ull,   747 },  /* 1e244 */
+  { 0x8bab8eefb6409c1aull,   774 },  /* 1e252 */
+  { 0xd01fef10a657842cull,   800 },  /* 1e260 */
+  { 0x9b10a4e5e9913129ull,   827 },  /* 1e268 */
+  { 0xe7109bfba19c0c9dull,   853 },  /* 1e276 */
+  { 0xac2820d9623bf429ull,   880 },  /* 1e284 */
+  { 0x80444b5e7aa7cf85ull,   907 },  /* 1e292 */
+  { 0xbf21e44003acdd2dull,   933 },  /* 1e300 */
+  { 0x8e679c2f5e44ff8full,   960 },  /* 1e308 */
+  { 0xd433179d9c8cb841ull,   986 },  /* 1e316 */
+  { 0x9e19db92b4e31ba9ull,  1013 },  /* 1e324 */
+  { 0xeb96bf6ebadf77d9ull,  1039 },  /* 1e332 */
+  { 0xaf87023b9bf0ee6bull,  1066 },  /* 1e340 */
+};
+
+static const uint32_t g_small_powers[10] =
+{
+  1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000,
+  1000000000
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: diyfp_multiply
+ *
+ * Description:
+ *   Return the upper 64 bits of the 128-bit product, rounded.
+ *
+ ****************************************************************************/
+
+static struct diyfp_s diyfp_multiply(struct diyfp_s x, struct diyfp_s y)
+{
+  struct diyfp_s ret;
+  uint64_t a = x.f >> 32;
+  uint64_t b = x.f & 0xffffffff;
+  uint64_t c = y.f >> 32;
+  uint64_t d = y.f & 0xffffffff;
+  uint64_t ac = a * c;
+  uint64_t bc = b * c;
+  uint64_t ad = a * d;
+  uint64_t bd = b * d;
+  uint64_t tmp;
+
+  tmp  = (bd >> 32) + (ad & 0xffffffff) + (bc & 0xffffffff);
+  tmp += 1u << 31;
+
+  ret.f = ac + (ad >> 32) + (bc >> 32) + (tmp >> 32);
+  ret.e = x.e + y.e + 64;
+  return ret;
+}
+
+/****************************************************************************
+ * Name: diyfp_normalize
+ ****************************************************************************/
+
+static struct diyfp_s diyfp_normalize(struct diyfp_s x)
+{
+  while ((x.f & 0xffc0000000000000ull) == 0)
+    {
+      x.f <<= 10;
+      x.e  -= 10;
+    }
+
+  while ((x.f & 0x8000000000000000ull) == 0)
+    {
+      x.f <<= 1;
+      x.e--;
+    }
+
+  return x;
+}
+
+/****************************************************************************
+ * Name: grisu_cached_power
+ *
+ * Description:
+ *   Select a cached power of ten c = 10^-mk such that the binary exponent
+ *   of w * c lies in [GRISU_MIN_EXPONENT, GRISU_MAX_EXPONENT].  w has
+ *   binary exponent 'e' and a normalized 64-bit significand.
+ *
+ ****************************************************************************/
+
+static struct diyfp_s grisu_cached_power(int e, FAR int *mk)
+{
+  struct diyfp_s ret;
+  int target = GRISU_MIN_EXPONENT - (e + 64);
+  int k;
+  int i;
+
+  /* Estimate the decimal exponent k of the power using 78913 / 2^18 ~=
+   * log10(2), then step to the first cached power with a large enough
+   * binary exponent.
+   */
+
+  k = ((target + 63) * 78913) / (1 << 18);
+  i = (k - GRISU_FIRST_POWER) / GRISU_POWER_STEP;
+
+  if (i < 0)
+    {
+      i = 0;
+    }
+
+  while (i > 0 && g_cached_powers[i - 1].e >= target)
+    {
+      i--;
+    }
+
+  while (g_cached_powers[i].e < target)
+    {
+      i++;
+    }
+
+  ret.f = g_cached_powers[i].f;
+  ret.e = g_cached_powers[i].e;
+  *mk   = GRISU_FIRST_POWER + i * GRISU_POWER_STEP;
+  return ret;
+}
+
+/****************************************************************************
+ * Name: grisu_round_weed
+ *
+ * Description:
+ *   Adjust the last generated digit so that the result is as close as
+ *   possible to the value, and verify that the result is provably the
+ *   shortest and closest representation despite the imprecision of the
+ *   scaled boundaries.
+ *
+ ****************************************************************************/
+
+static bool grisu_round_weed(FAR char *buffer, int length,
+                             uint64_t distance_too_high_w,
+                             uint64_t unsafe_interval, uint64_t rest,
+                             uint64_t ten_kappa, uint64_t unit)
+{
+  uint64_t small_distance = distance_too_high_w - unit;
+  uint64_t big_distance   = distance_too_high_w + unit;
+
+  while (rest < small_distance &&
+         unsafe_interval - rest >= ten_kappa &&
+         (rest + ten_kappa < small_distance ||
+          small_distance - rest >= rest + ten_kappa - small_distance))
+    {
+      buffer[length - 1]--;
+      rest += ten_kappa;
+    }
+
+  if (rest < big_distance &&
+      unsafe_interval - rest >= ten_kappa &&
+      (rest + ten_kappa < big_distance ||
+       big_distance - rest > rest + ten_kappa - big_distance))
+    {
+      return false;
+    }
+
+  return 2 * unit <= rest && rest <= unsafe_interval - 4 * unit;
+}
+
+/****************************************************************************
+ * Name: grisu_digit_gen
+ *
+ * Description:
+ *   Generate the shortest digit string within the scaled boundaries 'low'
+ *   and 'high' of the scaled value 'w'.  Returns false if the result could
+ *   not be proven correct.
+ *
+ ****************************************************************************/
+
+static bool grisu_digit_gen(struct diyfp_s low, struct diyfp_s w,
+                            struct diyfp_s high, FAR char *buffer,
+                            FAR int *length, FAR int *kappa)
+{
+  uint64_t unit = 1;
+  uint64_t too_low = low.f - unit;
+  uint64_t too_high = high.f + unit;
+  uint64_t unsafe_interval = too_high - too_low;
+  uint64_t one = (uint64_t)1 << -w.e;
+  uint64_t fractionals = too_high & (one - 1);
+  uint64_t rest;
+  uint32_t integrals = (uint32_t)(too_high >> -w.e);
+  uint32_t divisor;
+  int digit;
+
+  /* The integral part has at most 10 digits since w.e >= -60 */
+
+  *kappa = 1;
+  while (*kappa < 10 && integrals >= g_small_powers[*kappa])
+    {
+      (*kappa)++;
+    }
+
+  divisor = g_small_powers[*kappa - 1];
+  *length = 0;
+
+  while (*kappa > 0)
+    {
+      digit      = integrals / divisor;
+      buffer[(*length)++] = '0' + digit;
+      integrals %= divisor;
+      (*kappa)--;
+
+      rest = ((uint64_t)integrals << -w.e) + fractionals;
+      if (rest < unsafe_interval)
+        {
+          return grisu_round_weed(buffer, *length, too_high - w.f,
+                                  unsafe_interval, rest,
+                                  (uint64_t)divisor << -w.e, unit);
+        }
+
+      divisor /= 10;
+    }
+
+  for (; ; )
+    {
+      fractionals     *= 10;
+      unit            *= 10;
+      unsafe_interval *= 10;
+
+      digit        = (int)(fractionals >> -w.e);
+      buffer[(*length)++] = '0' + digit;
+      fractionals &= one - 1;
+      (*kappa)--;
+
+      if (fractionals < unsafe_interval)
+        {
+          return grisu_round_weed(buffer, *length,
+                                  (too_high - w.f) * unit,
+                                  unsafe_interval, fractionals, one, unit);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: grisu3
+ *
+ * Description:
+ *   Florian Loitsch's Grisu3 ("Printing Floating-Point Numbers Quickly and
+ *   Accurately with Integers", PLDI 2010).  Produces the shortest digit
+ *   string that reads back as 'value', using only 64-bit integer
+ *   arithmetic.  Fails for about 0.5% of values, which must then be
+ *   handled by an exact (bignum) algorithm.
+ *
+ ****************************************************************************/
+
+static bool grisu3(uint64_t bits, FAR char *buffer, FAR int *length,
+                   FAR int *decpt)
+{
+  struct diyfp_s w;
+  struct diyfp_s plus;
+  struct diyfp_s minus;
+  struct diyfp_s ten_mk;
+  int biased = (int)(bits >> DBL_EXPONENT_SHIFT) & DBL_EXPONENT_MASK;
+  int kappa;
+  int mk;
+  bool ret;
+
+  /* Decompose the value as w = f * 2^e */
+
+  if (biased == 0)
+    {
+      w.f = bits & DBL_FRACTION_MASK;
+      w.e = DBL_DENORM_EXPONENT;
+    }
+  else
+    {
+      w.f = (bits & DBL_FRACTION_MASK) | DBL_HIDDEN_BIT;
+      w.e = biased - DBL_EXPONENT_BIAS;
+    }
+
+  /* The rounding boundaries are half-way to the neighboring values.  The
+   * lower boundary is closer for powers of two.
+   */
+
+  plus.f = (w.f << 1) + 1;
+  plus.e = w.e - 1;
+  plus   = diyfp_normalize(plus);
+
+  if ((bits & DBL_FRACTION_MASK) == 0 && biased > 1)
+    {
+      minus.f = (w.f << 2) - 1;
+      minus.e = w.e - 2;
+    }
+  else
+    {
+      minus.f = (w.f << 1) - 1;
+      minus.e = w.e - 1;
+    }
+
+  minus.f <<= minus.e - plus.e;
+  minus.e   = plus.e;
+
+  w = diyfp_normalize(w);
+
+  /* Scale everything into the range where the digits can be generated
+   * from the integral and fractional parts of a 64-bit fixed point value.
+   */
+
+  ten_mk = grisu_cached_power(w.e, &mk);
+  w      = diyfp_multiply(w, ten_mk);
+  minus  = diyfp_multiply(minus, ten_mk);
+  plus   = diyfp_multiply(plus, ten_mk);
+
+  ret    = grisu_digit_gen(minus, w, plus, buffer, length, &kappa);
+  *decpt = *length - mk + kappa;
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: __fastdtoa
+ *
+ * Description:
+ *   Convert a finite, non-zero, positive double to the shortest string of
+ *   decimal digits that reads back as the same value, choosing the closest
+ *   such string if there is more than one.  Grisu3 handles nearly all
+ *   values; __dtoa() handles the rest.
+ *
+ * Input Parameters:
+ *   value  - The value to convert
+ *   digits - Receives the digits, NUL terminated.  Must hold at least
+ *            DTOA_MAXDIGITS + 1 characters.
+ *   decpt  - Receives the position of the decimal point relative to the
+ *            start of the digits:  value = 0.digits * 10^decpt
+ *
+ * Returned Value:
+ *   The number of digits.
+ *
+ ****************************************************************************/
+
+int __fastdtoa(double value, FAR char *digits, FAR int *decpt)
+{
+  union
+  {
+    double   d;
+    uint64_t u;
+  } bits;
+
+  FAR char *rve;
+  FAR char *str;
+  int length;
+  int sign;
+
+  bits.d = value;
+  if (grisu3(bits.u, digits, &length, decpt))
+    {
+      digits[length] = '\0';
+      return length;
+    }
+
+  str    = __dtoa(value, 0, 0, decpt, &sign, &rve);
+  length = rve - str;
+  memcpy(digits, str, length);
+  digits[length] = '\0';
+  return length;
+}
+
+#endif /* CONFIG_LIBC_FLOATINGPOINT */
@@ -1,5 +1,5 @@
 /****************************************************************************
- * libc/unistd/lib_libdtoa.c
+ * libc/stdio/lib_libdtoa.c
  *
  * This file was ported to NuttX by Yolande Cates.
  *
@@ -54,6 +54,10 @@
 
 #define MAX_PREC 16
 
+/* Size of the digit buffer used by lib_dtoa_fixed() */
+
+#define DTOA_FIXEDDIGITS 32
+
 #ifndef MIN
 #  define MIN(a,b) (a < b ? a : b)
 #endif
@@ -91,37 +95,264 @@
  ****************************************************************************/
 
 /****************************************************************************
- * Name: zeroes
+ * Name: lib_dtoa_string
+ *
+ * Description:
+ *   Print the specified string
+ *
+ ****************************************************************************/
+
+static void lib_dtoa_string(FAR struct lib_outstream_s *obj, const char *str)
+{
+  while (*str)
+    {
+      obj->put(obj, *str++);
+    }
+}
+
+/****************************************************************************
+ * Name: lib_dtoa_exact
  *
  * Description:
- *   Print the specified number of zeres
+ *   Get the digits of v = m * 2^e rounded to 'prec' fractional digits
+ *   exactly, using only integer arithmetic.  This handles values in the
+ *   range [2^-8, 2^64), i.e. -60 <= e <= 11, where the integer part fits
+ *   in 64 bits and the fractional part can be multiplied by ten without
+ *   overflow.  Exact ties round to even, as does __dtoa().
+ *
+ * Returned Value:
+ *   The number of digits, or -1 if they do not fit in the buffer.
  *
  ****************************************************************************/
 
-static void zeroes(FAR struct lib_outstream_s *obj, int nzeroes)
+static int lib_dtoa_exact(uint64_t m, int e, int prec, FAR char *buffer,
+                          FAR int *decpt)
 {
+  uint64_t integral;
+  uint64_t fraction;
+  uint64_t half;
+  uint64_t mask;
+  char tmp[20];
+  bool roundup;
+  int n = 0;
   int i;
 
-  for (i = nzeroes; i > 0; i--)
+  if (e >= 0)
     {
-      obj->put(obj, '0');
+      integral = m << e;
+      fraction = 0;
+      mask     = 0;
+      e        = 0;
+    }
+  else
+    {
+      integral = m >> -e;
+      mask     = ((uint64_t)1 << -e) - 1;
+      fraction = m & mask;
+    }
+
+  /* Convert the integer part */
+
+  for (i = 0; integral > 0; integral /= 10)
+    {
+      tmp[i++] = '0' + (int)(integral % 10);
+    }
+
+  if (i + prec > DTOA_FIXEDDIGITS)
+    {
+      return -1;
+    }
+
+  *decpt = i;
+  while (i > 0)
+    {
+      buffer[n++] = tmp[--i];
+    }
+
+  /* Generate the fractional digits, omitting leading zeroes */
+
+  for (i = 0; i < prec; i++)
+    {
+      fraction *= 10;
+      if (n > 0 || (fraction >> -e) != 0)
+        {
+          buffer[n++] = '0' + (int)(fraction >> -e);
+        }
+      else
+        {
+          (*decpt)--;
+        }
+
+      fraction &= mask;
     }
+
+  /* Round the remainder to nearest, ties to even */
+
+  half = (mask >> 1) + 1;
+  if (mask == 0 || fraction < half)
+    {
+      roundup = false;
+    }
+  else if (fraction > half)
+    {
+      roundup = true;
+    }
+  else
+    {
+      roundup = n > 0 && ((buffer[n - 1] - '0') & 1) != 0;
+    }
+
+  if (roundup)
+    {
+      while (n > 0 && buffer[n - 1] == '9')
+        {
+          n--;
+        }
+
+      if (n == 0)
+        {
+          buffer[n++] = '1';
+          (*decpt)++;
+        }
+      else
+        {
+          buffer[n - 1]++;
+        }
+    }
+
+  return n;
 }
 
 /****************************************************************************
- * Name: lib_dtoa_string
+ * Name: lib_dtoa_fixed
  *
  * Description:
- *   Print the specified string
+ *   Get the digits of a finite, positive value rounded to 'prec' digits to
+ *   the right of the decimal point, or the shortest digits that read back
+ *   as the value if prec < 0.
+ *
+ *   Outside of the range of lib_dtoa_exact(), the shortest digits d from
+ *   __fastdtoa() are usually enough:  d is the shortest and closest string
+ *   within the rounding interval of the value v, so no shorter string
+ *   (such as a rounding midpoint with prec + 1 fractional digits) lies
+ *   between v and d.  Rounding d therefore gives the same result as
+ *   rounding v unless d has exactly prec + 1 fractional digits ending in 5.
+ *   If d has prec fractional digits or fewer, it is the correctly rounded
+ *   result provided that the spacing of doubles at v is no more than
+ *   10^-prec.  Only the remaining cases need the exact bignum conversion
+ *   of __dtoa().
+ *
+ * Input Parameters:
+ *   value   - The value to convert, finite and greater than zero
+ *   prec    - Number of digits to the right of the decimal point, or -1
+ *   buffer  - Work buffer of DTOA_FIXEDDIGITS + 1 characters
+ *   decpt   - Receives the position of the decimal point in the digits
+ *   ndigits - Receives the number of digits.  Trailing zeros are not
+ *             included and may be omitted.
+ *
+ * Returned Value:
+ *   A pointer to the digits, either in buffer or owned by __dtoa().
  *
  ****************************************************************************/
 
-static void lib_dtoa_string(FAR struct lib_outstream_s *obj, const char *str)
+static FAR const char *lib_dtoa_fixed(double value, int prec,
+                                      FAR char *buffer, FAR int *decpt,
+                                      FAR int *ndigits)
 {
-  while (*str)
+  union
+  {
+    double   d;
+    uint64_t u;
+  } bits;
+
+  FAR char *rve;
+  FAR char *str;
+  int biased;
+  int sign;
+  int cut;
+  int e2;
+  int n;
+
+  bits.d = value;
+  biased = (int)(bits.u >> 52) & 0x7ff;
+  e2     = biased == 0 ? -1074 : biased - 1075;
+
+  /* Values of moderate magnitude are handled exactly with integers */
+
+  if (prec >= 0 && e2 >= -60 && e2 <= 11)
     {
-      obj->put(obj, *str++);
+      n = lib_dtoa_exact((bits.u & 0x000fffffffffffffull) |
+                         0x0010000000000000ull, e2, prec, buffer, decpt);
+      if (n >= 0)
+        {
+          *ndigits = n;
+          return buffer;
+        }
+    }
+
+  n = __fastdtoa(value, buffer, decpt);
+  if (prec < 0)
+    {
+      *ndigits = n;
+      return buffer;
+    }
+
+  /* 'cut' is the number of digits that are kept */
+
+  cut = *decpt + prec;
+
+  if (n <= cut)
+    {
+      /* The spacing of doubles at v is 2^e2.  Is it no more than 10^-prec?
+       * 3.322 is a little more than log2(10).
+       */
+
+      if (e2 <= -((prec * 3322 + 999) / 1000))
+        {
+          *ndigits = n;
+          return buffer;
+        }
+    }
+  else if (n > cut + 1 || buffer[cut] != '5')
+    {
+      /* Round the digits.  If the cut is left of the first digit, then
+       * the value rounds to zero.
+       */
+
+      if (cut < 0)
+        {
+          *ndigits = 0;
+          return buffer;
+        }
+
+      n = cut;
+      if (buffer[cut] >= '5')
+        {
+          while (n > 0 && buffer[n - 1] == '9')
+            {
+              n--;
+            }
+
+          if (n == 0)
+            {
+              buffer[n++] = '1';
+              (*decpt)++;
+            }
+          else
+            {
+              buffer[n - 1]++;
+            }
+        }
+
+      *ndigits = n;
+      return buffer;
     }
+
+  /* The result cannot be decided from the shortest digits */
+
+  str      = __dtoa(value, 3, prec, decpt, &sign, &rve);
+  *ndigits = rve - str;
+  return str;
 }
 
 /****************************************************************************
@@ -129,19 +360,16 @@ static void lib_dtoa_string(FAR struct lib_outstream_s *obj, const char *str)
  *
  * Description:
  *   This is part of lib_vsprintf().  It handles the floating point formats.
- *   This version supports only the %f (with precision).  If no precision
- *   was provided in the format, this will use precision == 0 which is
- *   probably not what you want.
+ *   This version supports only the %f format.
  *
  * Input Parameters:
  *   obj   - The output stream object
  *   fmt   - The format character.  Not used 'f' is always assumed
- *   prec  - The number of digits to the right of the decimal point. If no
- *           precision is provided in the format, this will be zero.  And,
- *           unfortunately in this case, it will be treated literally as
- *           a precision of zero.
- *   flags - Only ALTFORM and SHOWPLUS flags are supported.  ALTFORM only
- *           applies if prec == 0 which is not supported anyway.
+ *   prec  - The number of digits to the right of the decimal point.  If
+ *           negative (no precision was provided in the format), the
+ *           shortest representation that reads back as the same value is
+ *           printed.
+ *   flags - Only ALTFORM and SHOWPLUS flags are supported.
  *   value - The floating point value to convert.
  *
  ****************************************************************************/
@@ -149,12 +377,10 @@ static void lib_dtoa_string(FAR struct lib_outstream_s *obj, const char *str)
 static void lib_dtoa(FAR struct lib_outstream_s *obj, int fmt, int prec,
                      uint8_t flags, double value)
 {
-  FAR char *digits;     /* String returned by __dtoa */
-  FAR char *rve;        /* Points to the end of the return value */
-  int  expt;            /* Integer value of exponent */
-  int  numlen;          /* Actual number of digits returned by cvt */
-  int  nchars;          /* Number of characters to print */
-  int  dsgn;            /* Unused sign indicator */
+  FAR const char *digits;            /* The significant digits */
+  char buffer[DTOA_FIXEDDIGITS + 1]; /* Work buffer for the digits */
+  int  decpt;                        /* Position of the decimal point */
+  int  ndigits;                      /* Number of significant digits */
   int  i;
 
   /* Special handling for NaN and Infinity */
@@ -186,12 +412,27 @@ static void lib_dtoa(FAR struct lib_outstream_s *obj, int fmt, int prec,
 
   /* Perform the conversion */
 
-  digits   = __dtoa(value, 3, prec, &expt, &dsgn, &rve);
-  numlen   = rve - digits;
+  if (value == 0)
+    {
+      digits  = buffer;
+      ndigits = 0;
+    }
+  else
+    {
+      digits = lib_dtoa_fixed(value, prec, buffer, &decpt, &ndigits);
+    }
 
-  /* Avoid precision error from missing trailing zeroes */
+  if (ndigits == 0)
+    {
+      decpt = 0;
+    }
 
-  numlen = MAX(expt, numlen);
+  /* With no precision, print all of the significant fractional digits */
+
+  if (prec < 0)
+    {
+      prec = MAX(ndigits - decpt, 0);
+    }
 
   if (IS_NEGATE(flags))
     {
@@ -202,132 +443,35 @@ static void lib_dtoa(FAR struct lib_outstream_s *obj, int fmt, int prec,
       obj->put(obj, '+');
     }
 
-  /* Special case exact zero or the case where the number is smaller than
-   * the print precision.
-   */
+  /* Print the integer part to the left of the decimal point */
 
-  if (value == 0 || expt < -prec)
+  if (decpt <= 0)
     {
-      /* kludge for __dtoa irregularity */
-
       obj->put(obj, '0');
-
-      /* A decimal point is printed only in the alternate form or if a
-       * particular precision is requested.
-       */
-
-      if (prec > 0 || IS_ALTFORM(flags))
-        {
-          obj->put(obj, '.');
-
-          /* Always print at least one digit to the right of the decimal point. */
-
-          prec = MAX(1, prec);
-        }
     }
-
-  /* A non-zero value will be printed */
-
   else
     {
-
-      /* Handle the case where the value is less than 1.0 (in magnitude) and
-       * will need a leading zero.
-       */
-
-      if (expt <= 0)
+      for (i = 0; i < decpt; i++)
         {
-          /* Print a single zero to the left of the decimal point */
-
-          obj->put(obj, '0');
-
-          /* Print the decimal point */
-
-          obj->put(obj, '.');
-
-          /* Print any leading zeros to the right of the decimal point */
-
-          if (expt < 0)
-            {
-              nchars = MIN(-expt, prec);
-              zeroes(obj, nchars);
-              prec -= nchars;
-            }
-        }
-
-      /* Handle the general case where the value is greater than 1.0 (in
-       * magnitude).
-       */
-
-      else
-        {
-          /* Print the integer part to the left of the decimal point */
-
-          for (i = expt; i > 0; i--)
-            {
-              if (*digits != '\0')
-                {
-                  obj->put(obj, *digits);
-                  digits++;
-                }
-              else
-                {
-                  obj->put(obj, '0');
-                }
-            }
-
-          /* Get the length of the fractional part */
-
-          numlen -= expt;
-
-          /* If there is no fractional part, then a decimal point is printed
-           * only in the alternate form or if a particular precision is
-           * requested.
-           */
-
-          if (numlen > 0 || prec > 0 || IS_ALTFORM(flags))
-            {
-              /* Print the decimal point */
-
-              obj->put(obj, '.');
-
-              /* Always print at least one digit to the right of the decimal
-               * point.
-               */
-
-              prec = MAX(1, prec);
-            }
-        }
-
-      /* If a precision was specified, then limit the number digits to the
-       * right of the decimal point.
-       */
-
-      if (prec > 0)
-        {
-          nchars = MIN(numlen, prec);
-        }
-      else
-        {
-          nchars = numlen;
-        }
-
-      /* Print the fractional part to the right of the decimal point */
-
-      for (i = nchars; i > 0; i--)
-        {
-          obj->put(obj, *digits);
-          digits++;
+          obj->put(obj, i < ndigits ? digits[i] : '0');
         }
+    }
 
-      /* Decrement to get the number of trailing zeroes to print */
+  /* A decimal point is printed only in the alternate form or if there is
+   * a fractional part.
+   */
 
-      prec -= nchars;
+  if (prec > 0 || IS_ALTFORM(flags))
+    {
+      obj->put(obj, '.');
     }
 
-  /* Finally, print any trailing zeroes */
+  /* Print the fractional part, including any leading and trailing zeroes */
 
-  zeroes(obj, prec);
+  for (i = decpt; i < decpt + prec; i++)
+    {
+      obj->put(obj, i >= 0 && i < ndigits ? digits[i] : '0');
+    }
 }
 
 /****************************************************************************
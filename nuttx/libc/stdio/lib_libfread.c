@@ -143,12 +143,20 @@ ssize_t lib_fread(FAR void *ptr, size_t count, FAR FILE *stream)
         {
           /* Is there readable data in the buffer? */
 
-          while ((count > 0) && (stream->fs_bufpos < stream->fs_bufread))
+          size_t gulp_size = stream->fs_bufread - stream->fs_bufpos;
+          if (gulp_size > 0)
             {
-              /* Yes, copy a byte into the user buffer */
+              /* Yes, copy as much as is needed into the user buffer */
 
-              *dest++ = *stream->fs_bufpos++;
-              count--;
+              if (gulp_size > count)
+                {
+                  gulp_size = count;
+                }
+
+              memcpy(dest, stream->fs_bufpos, gulp_size);
+              stream->fs_bufpos += gulp_size;
+              dest              += gulp_size;
+              count             -= gulp_size;
             }
 
           /* The buffer is empty OR we have already supplied the number of
@@ -42,6 +42,7 @@
 #include <sys/types.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <string.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <errno.h>
@@ -90,7 +91,7 @@ ssize_t lib_fwrite(FAR const void *ptr, size_t count, FAR FILE *stream)
   FAR const unsigned char *start = ptr;
   FAR const unsigned char *src   = ptr;
   ssize_t ret = ERROR;
-  unsigned char *dest;
+  ssize_t nwritten;
 
   /* Make sure that writing to this stream is allowed */
 
@@ -118,9 +119,34 @@ ssize_t lib_fwrite(FAR const void *ptr, size_t count, FAR FILE *stream)
 
   while (count > 0)
     {
+      size_t gulp_size;
+
+      /* If the buffer is empty and at least a full buffer of user data
+       * remains, then write the user data directly.  Nothing would be
+       * gained by copying it through the buffer.
+       */
+
+      if (stream->fs_bufpos == stream->fs_bufstart &&
+          count >= (size_t)(stream->fs_bufend - stream->fs_bufstart))
+        {
+          nwritten = write(stream->fs_fd, src, count);
+          if (nwritten < 0)
+            {
+              goto errout_with_semaphore;
+            }
+          else if (nwritten == 0)
+            {
+              break;
+            }
+
+          src   += nwritten;
+          count -= nwritten;
+          continue;
+        }
+
       /* Determine the number of bytes left in the buffer */
 
-      size_t gulp_size = stream->fs_bufend - stream->fs_bufpos;
+      gulp_size = stream->fs_bufend - stream->fs_bufpos;
 
       /* Will the user data fit into the amount of buffer space
        * that we have left?
@@ -141,16 +167,13 @@ ssize_t lib_fwrite(FAR const void *ptr, size_t count, FAR FILE *stream)
 
       /* Transfer the data into the buffer */
 
-      for (dest = stream->fs_bufpos; gulp_size > 0; gulp_size--)
-        {
-          *dest++ = *src++;
-        }
-
-      stream->fs_bufpos = dest;
+      memcpy(stream->fs_bufpos, src, gulp_size);
+      stream->fs_bufpos += gulp_size;
+      src               += gulp_size;
 
       /* Is the buffer full? */
 
-      if (dest >= stream->fs_bufend)
+      if (stream->fs_bufpos >= stream->fs_bufend)
         {
           /* Flush the buffered data to the IO stream */
 
@@ -142,6 +142,11 @@ enum
  * Private Function Prototypes
  ****************************************************************************/
 
+/* Output a run of characters */
+
+static void putrun(FAR struct lib_outstream_s *obj, FAR const char *buffer,
+                   int len);
+
 /* Pointer to ASCII conversion */
 
 #ifdef CONFIG_PTR_IS_NOT_INT
@@ -230,6 +235,31 @@ static const char g_nullstring[] = "(null)";
 #  include "stdio/lib_libdtoa.c"
 #endif
 
+/****************************************************************************
+ * Name: putrun
+ *
+ * Description:
+ *   Output a run of characters with a single call to the stream's puts
+ *   method, if it has one.
+ *
+ ****************************************************************************/
+
+static void putrun(FAR struct lib_outstream_s *obj, FAR const char *buffer,
+                   int len)
+{
+  if (obj->puts)
+    {
+      obj->puts(obj, buffer, len);
+    }
+  else
+    {
+      for (; len > 0; len--)
+        {
+          obj->put(obj, *buffer++);
+        }
+    }
+}
+
 /****************************************************************************
  * Name: ptohex
  ****************************************************************************/
@@ -294,15 +324,19 @@ static int getpsize(uint8_t flags, FAR void *p)
 
 static void utodec(FAR struct lib_outstream_s *obj, unsigned int n)
 {
-  unsigned int remainder = n % 10;
-  unsigned int dividend  = n / 10;
+  char buffer[3 * sizeof(unsigned int)];
+  int ndx = sizeof(buffer);
 
-  if (dividend)
+  /* Generate the digits from right to left, then output them all at once */
+
+  do
     {
-      utodec(obj, dividend);
+      buffer[--ndx] = (n % 10) + '0';
+      n /= 10;
     }
+  while (n);
 
-  obj->put(obj, (remainder + (unsigned int)'0'));
+  putrun(obj, &buffer[ndx], sizeof(buffer) - ndx);
 }
 
 /****************************************************************************
@@ -562,15 +596,17 @@ static int getdblsize(uint8_t fmt, int trunc, uint8_t flags, double n)
 
 static void lutodec(FAR struct lib_outstream_s *obj, unsigned long n)
 {
-  unsigned int  remainder = n % 10;
-  unsigned long dividend  = n / 10;
+  char buffer[3 * sizeof(unsigned long)];
+  int ndx = sizeof(buffer);
 
-  if (dividend)
+  do
     {
-      lutodec(obj, dividend);
+      buffer[--ndx] = (n % 10) + '0';
+      n /= 10;
     }
+  while (n);
 
-  obj->put(obj, (remainder + (unsigned int)'0'));
+  putrun(obj, &buffer[ndx], sizeof(buffer) - ndx);
 }
 
 /****************************************************************************
@@ -812,15 +848,17 @@ static int getlusize(uint8_t fmt, uint8_t flags, unsigned long ln)
 
 static void llutodec(FAR struct lib_outstream_s *obj, unsigned long long n)
 {
-  unsigned int remainder = n % 10;
-  unsigned long long dividend = n / 10;
+  char buffer[3 * sizeof(unsigned long long)];
+  int ndx = sizeof(buffer);
 
-  if (dividend)
+  do
     {
-      llutodec(obj, dividend);
+      buffer[--ndx] = (n % 10) + '0';
+      n /= 10;
     }
+  while (n);
 
-  obj->put(obj, (remainder + (unsigned int)'0'));
+  putrun(obj, &buffer[ndx], sizeof(buffer) - ndx);
 }
 
 /****************************************************************************
@@ -1185,6 +1223,32 @@ int lib_vsprintf(FAR struct lib_outstream_s *obj, FAR const char *src, va_list a
 
       if (FMT_CHAR != '%')
         {
+#ifndef CONFIG_ARCH_ROMGETC
+           /* Output the whole run of regular characters up to the next
+            * format specifier at once.  src is left at the last character
+            * of the run.
+            */
+
+           FAR const char *run = src;
+
+           while (src[1] != '\0' && src[1] != '%')
+             {
+               src++;
+             }
+
+           putrun(obj, run, src - run + 1);
+
+#ifdef CONFIG_STDIO_LINEBUFFER
+           /* Flush the buffer if the run contains a newline */
+
+           if (memchr(run, '\n', src - run + 1) != NULL)
+             {
+               /* Should return an error on a failure to flush */
+
+               (void)obj->flush(obj);
+             }
+#endif
+#else
            /* Output the character */
 
            obj->put(obj, FMT_CHAR);
@@ -1199,6 +1263,8 @@ int lib_vsprintf(FAR struct lib_outstream_s *obj, FAR const char *src, va_list a
                (void)obj->flush(obj);
              }
 #endif
+#endif /* CONFIG_ARCH_ROMGETC */
+
            /* Process the next character in the format */
 
            continue;
@@ -1358,9 +1424,8 @@ int lib_vsprintf(FAR struct lib_outstream_s *obj, FAR const char *src, va_list a
 
       if (FMT_CHAR == 's')
         {
-#ifndef CONFIG_NOPRINTF_FIELDWIDTH
           int swidth;
-#endif
+
           /* Get the string to output */
 
           ptmp = va_arg(ap, char *);
@@ -1373,17 +1438,13 @@ int lib_vsprintf(FAR struct lib_outstream_s *obj, FAR const char *src, va_list a
            * operations.
            */
 
-#ifndef CONFIG_NOPRINTF_FIELDWIDTH
           swidth = strlen(ptmp);
+#ifndef CONFIG_NOPRINTF_FIELDWIDTH
           prejustify(obj, fmt, 0, width, swidth);
 #endif
           /* Concatenate the string into the output */
 
-          while (*ptmp)
-            {
-              obj->put(obj, *ptmp);
-              ptmp++;
-            }
+          putrun(obj, ptmp, swidth);
 
           /* Perform left-justification operations. */
 
@@ -1587,11 +1648,23 @@ int lib_vsprintf(FAR struct lib_outstream_s *obj, FAR const char *src, va_list a
         {
 #ifndef CONFIG_NOPRINTF_FIELDWIDTH
           double dblval = va_arg(ap, double);
-          int dblsize;
+          int dblsize = 0;
 
-          /* Get the width of the output */
+          /* Without a precision, print the shortest representation */
 
-          dblsize = getdblsize(FMT_CHAR, trunc, flags, dblval);
+          if (!IS_HASDOT(flags))
+            {
+              trunc = -1;
+            }
+
+          /* Get the width of the output.  This requires a second
+           * conversion so it is done only if there is a field width.
+           */
+
+          if (width > 0)
+            {
+              dblsize = getdblsize(FMT_CHAR, trunc, flags, dblval);
+            }
 
           /* Perform left field justification actions */
 
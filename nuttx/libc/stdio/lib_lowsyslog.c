@@ -42,6 +42,8 @@
 #include <stdio.h>
 #include <debug.h>
 
+#include <nuttx/syslog/ramlog.h>
+
 #include "lib_internal.h"
 
 /* This interface can only be used from within the kernel */
@@ -92,6 +94,14 @@
 
 int lowvsyslog(FAR const char *fmt, va_list ap)
 {
+#ifdef CONFIG_RAMLOG_BINARY
+  /* Save the raw message in the RAM log.  It is formatted when read, so
+   * the number of characters in the message is not known here.  OK is
+   * returned if the message was saved.
+   */
+
+  return ramlog_vsyslog(fmt, ap);
+#else
   struct lib_outstream_s stream;
 
   /* Wrap the stdout in a stream object and let lib_vsprintf do the work. */
@@ -102,6 +112,7 @@ int lowvsyslog(FAR const char *fmt, va_list ap)
   lib_lowoutstream((FAR struct lib_outstream_s *)&stream);
 #endif
   return lib_vsprintf((FAR struct lib_outstream_s *)&stream, fmt, ap);
+#endif
 }
 
 /****************************************************************************
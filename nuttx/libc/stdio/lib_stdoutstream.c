@@ -78,6 +78,39 @@ static void stdoutstream_putc(FAR struct lib_outstream_s *this, int ch)
   while (get_errno() == EINTR);
 }
 
+/****************************************************************************
+ * Name: stdoutstream_puts
+ ****************************************************************************/
+
+static void stdoutstream_puts(FAR struct lib_outstream_s *this,
+                              FAR const char *buffer, int len)
+{
+  FAR struct lib_stdoutstream_s *sthis = (FAR struct lib_stdoutstream_s *)this;
+  ssize_t result;
+
+  DEBUGASSERT(this && sthis->stream);
+
+  /* Loop until the run is transferred or an irrecoverable error occurs.
+   * EINTR (meaning that the write was interrupted by a signal) is the only
+   * recoverable error.
+   */
+
+  while (len > 0)
+    {
+      result = lib_fwrite(buffer, len, sthis->stream);
+      if (result > 0)
+        {
+          this->nput += result;
+          buffer     += result;
+          len        -= result;
+        }
+      else if (result == 0 || get_errno() != EINTR)
+        {
+          break;
+        }
+    }
+}
+
 /****************************************************************************
  * Name: stdoutstream_flush
  ****************************************************************************/
@@ -116,7 +149,8 @@ void lib_stdoutstream(FAR struct lib_stdoutstream_s *outstream,
 {
   /* Select the put operation */
 
-  outstream->public.put = stdoutstream_putc;
+  outstream->public.put  = stdoutstream_putc;
+  outstream->public.puts = stdoutstream_puts;
 
   /* Select the correct flush operation.  This flush is only called when
    * a newline is encountered in the output stream.  However, we do not
@@ -42,6 +42,8 @@
 #include <stdio.h>
 #include <syslog.h>
 
+#include <nuttx/syslog/ramlog.h>
+
 #include "lib_internal.h"
 
 /****************************************************************************
@@ -53,6 +55,7 @@
 #if defined(CONFIG_BUILD_PROTECTED) && !defined(__KERNEL__)
 #  undef CONFIG_SYSLOG
 #  undef CONFIG_ARCH_LOWPUTC
+#  undef CONFIG_RAMLOG_BINARY
 #endif
 
 /****************************************************************************
@@ -93,7 +96,16 @@
 
 int vsyslog(FAR const char *fmt, va_list ap)
 {
-#if defined(CONFIG_SYSLOG)
+#if defined(CONFIG_RAMLOG_BINARY)
+
+  /* Save the raw message in the RAM log.  It is formatted when read, so
+   * the number of characters in the message is not known here.  OK is
+   * returned if the message was saved.
+   */
+
+  return ramlog_vsyslog(fmt, ap);
+
+#elif defined(CONFIG_SYSLOG)
 
   struct lib_outstream_s stream;
 
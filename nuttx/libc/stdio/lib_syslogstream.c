@@ -112,6 +112,7 @@ static void syslogstream_putc(FAR struct lib_outstream_s *this, int ch)
 void lib_syslogstream(FAR struct lib_outstream_s *stream)
 {
   stream->put   = syslogstream_putc;
+  stream->puts  = NULL;
 #ifdef CONFIG_STDIO_LINEBUFFER
   stream->flush = lib_noflush;
 #endif
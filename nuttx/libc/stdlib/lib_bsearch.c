@@ -0,0 +1,110 @@
+/****************************************************************************
+ * libc/stdlib/lib_bsearch.c
+ *
+ *   Copyright (C) 2014 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdlib.h>
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bsearch
+ *
+ * Description:
+ *   The bsearch() function searches an array of 'nmemb' objects, the
+ *   initial member of which is pointed to by 'base', for a member that
+ *   matches the object pointed to by 'key'.  The size of each member of the
+ *   array is specified by 'size'.
+ *
+ *   The contents of the array must be in ascending sorted order according
+ *   to the comparison function 'compar'.  That function is called with two
+ *   arguments that point to the key object and to an array member, in that
+ *   order.  It returns an integer less than, equal to, or greater than zero
+ *   if the key object is considered, respectively, to be less than, to
+ *   match, or to be greater than the array member.
+ *
+ * Returned Value:
+ *   A pointer to a matching member of the array, or NULL if no match is
+ *   found.  If two or more members compare equal, which member is matched
+ *   is unspecified.
+ *
+ ****************************************************************************/
+
+FAR void *bsearch(FAR const void *key, FAR const void *base, size_t nmemb,
+                  size_t size, CODE int (*compar)(FAR const void *,
+                  FAR const void *))
+{
+  FAR const char *lower = (FAR const char *)base;
+  FAR const char *member;
+  int cmp;
+
+  /* Each pass examines the member in the middle of the remaining range
+   * [lower, lower + nmemb) and then discards the half that cannot hold the
+   * key.
+   */
+
+  while (nmemb > 0)
+    {
+      member = lower + (nmemb >> 1) * size;
+      cmp    = compar(key, member);
+
+      if (cmp == 0)
+        {
+          return (FAR void *)member;
+        }
+      else if (cmp > 0)
+        {
+          /* The key lies above this member */
+
+          lower  = member + size;
+          nmemb  = (nmemb - 1) >> 1;
+        }
+      else
+        {
+          /* The key lies below this member */
+
+          nmemb >>= 1;
+        }
+    }
+
+  return NULL;
+}
@@ -0,0 +1,100 @@
+/****************************************************************************
+ * libc/stdlib/lib_bsearchlower.c
+ *
+ *   Copyright (C) 2014 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdlib.h>
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bsearch_lower
+ *
+ * Description:
+ *   Find the position of 'key' in an array of 'nmemb' members of 'size'
+ *   bytes, sorted in ascending order according to 'compar'.  'compar' is
+ *   called as in bsearch(), with the key as the first argument.
+ *
+ *   Unlike bsearch(), the search always succeeds: it returns the first
+ *   member that is not less than the key.  That is the first of several
+ *   equal members, or the place where the key would be inserted to keep
+ *   the array sorted.
+ *
+ * Returned Value:
+ *   A pointer to the first member that does not compare less than the
+ *   key; base + nmemb * size if all members are less than the key.
+ *
+ ****************************************************************************/
+
+FAR void *bsearch_lower(FAR const void *key, FAR const void *base,
+                        size_t nmemb, size_t size,
+                        CODE int (*compar)(FAR const void *,
+                        FAR const void *))
+{
+  FAR const char *lower = (FAR const char *)base;
+  FAR const char *member;
+  size_t half;
+
+  /* The answer always lies in [lower, lower + nmemb].  Each pass compares
+   * the key with the member in the middle and keeps one half.
+   */
+
+  while (nmemb > 0)
+    {
+      half   = nmemb >> 1;
+      member = lower + half * size;
+
+      if (compar(key, member) > 0)
+        {
+          /* The member is less than the key */
+
+          lower  = member + size;
+          nmemb -= half + 1;
+        }
+      else
+        {
+          nmemb = half;
+        }
+    }
+
+  return (FAR void *)lower;
+}
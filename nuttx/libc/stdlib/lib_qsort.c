@@ -1,7 +1,7 @@
 /****************************************************************************
  * libc/stdlib/lib_qsort.c
  *
- *   Copyright (C) 2007, 2009, 2011 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2007, 2009, 2011, 2014 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Leveraged from:
@@ -47,192 +47,451 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdint.h>
 #include <stdlib.h>
 
 /****************************************************************************
- * Preprocessor Definitions
+ * Pre-processor Definitions
  ****************************************************************************/
 
-#define min(a, b)  (a) < (b) ? a : b
-
-#define swapcode(TYPE, parmi, parmj, n) \
-  { \
-    long i = (n) / sizeof (TYPE); \
-    register TYPE *pi = (TYPE *) (parmi); \
-    register TYPE *pj = (TYPE *) (parmj); \
-    do { \
-      register TYPE  t = *pi; \
-      *pi++ = *pj; \
-      *pj++ = t; \
-    } while (--i > 0); \
-  }
-
-#define SWAPINIT(a, size) \
-  swaptype = ((char *)a - (char *)0) % sizeof(long) || \
-  size % sizeof(long) ? 2 : size == sizeof(long)? 0 : 1;
-
-#define swap(a, b) \
-  if (swaptype == 0) \
-    { \
-      long t = *(long *)(a); \
-      *(long *)(a) = *(long *)(b); \
-      *(long *)(b) = t; \
-    } \
-  else \
-    { \
-      swapfunc(a, b, size, swaptype); \
-    }
+/* Partitions of up to QSORT_INSERTION members are finished with insertion
+ * sort.  The pivot is the median of three members up to QSORT_NINTHER
+ * members and Tukey's ninther (the median of three medians) above that.
+ */
+
+#define QSORT_INSERTION  12
+#define QSORT_NINTHER    40
+
+/* Swap strategies, selected once per call from the element size and the
+ * alignment of the array.
+ */
 
-#define vecswap(a, b, n) if ((n) > 0) swapfunc(a, b, n, swaptype)
+#define QSORT_SWAP4      0  /* One 32-bit word */
+#define QSORT_SWAP8      1  /* Two 32-bit words */
+#define QSORT_SWAP16     2  /* Four 32-bit words */
+#define QSORT_SWAPWORDS  3  /* Any multiple of 32-bit words */
+#define QSORT_SWAPBYTES  4  /* Unaligned or odd sizes */
 
 /****************************************************************************
- * Private Function Prototypes
+ * Private Types
  ****************************************************************************/
 
-static inline void swapfunc(char *a, char *b, int n, int swaptype);
-static inline char *med3(char *a, char *b, char *c,
-                         int (*compar)(const void *, const void *));
+typedef CODE int (*qsort_compar_t)(FAR const void *, FAR const void *);
+
+struct qsort_s
+{
+  qsort_compar_t compar;  /* User comparison function */
+  size_t size;            /* Size of one member */
+  int swaptype;           /* QSORT_SWAP* */
+};
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
-static inline void swapfunc(char *a, char *b, int n, int swaptype)
+/****************************************************************************
+ * Name: qsort_swaptype
+ ****************************************************************************/
+
+static int qsort_swaptype(FAR const void *base, size_t size)
 {
-  if (swaptype <= 1)
+  if ((((uintptr_t)base | size) & (sizeof(uint32_t) - 1)) != 0)
     {
-      swapcode(long, a, b, n)
+      return QSORT_SWAPBYTES;
     }
-  else
+
+  switch (size)
     {
-      swapcode(char, a, b, n)
+      case 4:
+        return QSORT_SWAP4;
+
+      case 8:
+        return QSORT_SWAP8;
+
+      case 16:
+        return QSORT_SWAP16;
+
+      default:
+        return QSORT_SWAPWORDS;
     }
 }
 
-static inline char *med3(char *a, char *b, char *c,
-                         int (*compar)(const void *, const void *))
+/****************************************************************************
+ * Name: qsort_swapwords and qsort_swapbytes
+ *
+ * Description:
+ *   Exchange two ranges of n bytes.
+ *
+ ****************************************************************************/
+
+static void qsort_swapwords(FAR char *a, FAR char *b, size_t n)
 {
-  return compar(a, b) < 0 ?
-         (compar(b, c) < 0 ? b : (compar(a, c) < 0 ? c : a ))
-              :(compar(b, c) > 0 ? b : (compar(a, c) < 0 ? a : c ));
+  FAR uint32_t *pa = (FAR uint32_t *)a;
+  FAR uint32_t *pb = (FAR uint32_t *)b;
+  uint32_t t;
+
+  for (n /= sizeof(uint32_t); n > 0; n--)
+    {
+      t     = *pa;
+      *pa++ = *pb;
+      *pb++ = t;
+    }
+}
+
+static void qsort_swapbytes(FAR char *a, FAR char *b, size_t n)
+{
+  char t;
+
+  for (; n > 0; n--)
+    {
+      t    = *a;
+      *a++ = *b;
+      *b++ = t;
+    }
 }
 
 /****************************************************************************
- * Public Function
+ * Name: qsort_swap
+ *
+ * Description:
+ *   Exchange two members.  The common sizes are unrolled so that no loop
+ *   is needed.
+ *
  ****************************************************************************/
 
+static inline void qsort_swap(FAR const struct qsort_s *qs, FAR char *a,
+                              FAR char *b)
+{
+  FAR uint32_t *pa = (FAR uint32_t *)a;
+  FAR uint32_t *pb = (FAR uint32_t *)b;
+  uint32_t t0;
+  uint32_t t1;
+
+  switch (qs->swaptype)
+    {
+      case QSORT_SWAP16:
+        t0    = pa[2];
+        t1    = pa[3];
+        pa[2] = pb[2];
+        pa[3] = pb[3];
+        pb[2] = t0;
+        pb[3] = t1;
+
+        /* Fall through */
+
+      case QSORT_SWAP8:
+        t1    = pa[1];
+        pa[1] = pb[1];
+        pb[1] = t1;
+
+        /* Fall through */
+
+      case QSORT_SWAP4:
+        t0    = pa[0];
+        pa[0] = pb[0];
+        pb[0] = t0;
+        break;
+
+      case QSORT_SWAPWORDS:
+        qsort_swapwords(a, b, qs->size);
+        break;
+
+      default:
+        qsort_swapbytes(a, b, qs->size);
+        break;
+    }
+}
+
 /****************************************************************************
- * Name: qsort
+ * Name: qsort_vecswap
  *
  * Description:
- *   Qsort routine from Bentley & McIlroy's "Engineering a Sort Function".
+ *   Exchange two ranges of n bytes, n being a multiple of the member size.
  *
  ****************************************************************************/
 
-void qsort(void *base, size_t nmemb, size_t size,
-           int(*compar)(const void *, const void *))
+static inline void qsort_vecswap(FAR const struct qsort_s *qs, FAR char *a,
+                                 FAR char *b, size_t n)
 {
-  char *pa, *pb, *pc, *pd, *pl, *pm, *pn;
-  int d, r, swaptype, swap_cnt;
-
-loop:
-  SWAPINIT(base, size);
-  swap_cnt = 0;
-  if (nmemb < 7)
+  if (n > 0)
     {
-      for (pm = (char *) base + size; pm < (char *) base + nmemb * size; pm += size)
+      if (qs->swaptype == QSORT_SWAPBYTES)
         {
-          for (pl = pm; pl > (char *) base && compar(pl - size, pl) > 0; pl -= size)
-            {
-              swap(pl, pl - size);
-            }
+          qsort_swapbytes(a, b, n);
         }
-      return;
-  }
+      else
+        {
+          qsort_swapwords(a, b, n);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: qsort_med3
+ ****************************************************************************/
+
+static inline FAR char *qsort_med3(FAR const struct qsort_s *qs, FAR char *a,
+                                   FAR char *b, FAR char *c)
+{
+  return qs->compar(a, b) < 0 ?
+         (qs->compar(b, c) < 0 ? b : (qs->compar(a, c) < 0 ? c : a)) :
+         (qs->compar(b, c) > 0 ? b : (qs->compar(a, c) < 0 ? a : c));
+}
+
+/****************************************************************************
+ * Name: qsort_insertion
+ ****************************************************************************/
 
-  pm = (char *) base + (nmemb / 2) * size;
-  if (nmemb > 7)
+static void qsort_insertion(FAR const struct qsort_s *qs, FAR char *base,
+                            size_t nmemb)
+{
+  FAR char *end = base + nmemb * qs->size;
+  FAR char *pm;
+  FAR char *pl;
+
+  for (pm = base + qs->size; pm < end; pm += qs->size)
     {
-      pl = base;
-      pn = (char *) base + (nmemb - 1) * size;
-      if (nmemb > 40)
+      for (pl = pm; pl > base && qs->compar(pl - qs->size, pl) > 0;
+           pl -= qs->size)
         {
-          d = (nmemb / 8) * size;
-          pl = med3(pl, pl + d, pl + 2 * d, compar);
-          pm = med3(pm - d, pm, pm + d, compar);
-          pn = med3(pn - 2 * d, pn - d, pn, compar);
+          qsort_swap(qs, pl, pl - qs->size);
         }
-      pm = med3(pl, pm, pn, compar);
     }
-  swap(base, pm);
-  pa = pb = (char *) base + size;
+}
+
+/****************************************************************************
+ * Name: qsort_heapsort
+ *
+ * Description:
+ *   Heapsort, used when quicksort has partitioned badly too many times.
+ *   O(n log n) in the worst case and needs no stack.
+ *
+ ****************************************************************************/
 
-  pc = pd = (char *) base + (nmemb - 1) * size;
-  for (;;)
+static void qsort_siftdown(FAR const struct qsort_s *qs, FAR char *base,
+                           size_t root, size_t nmemb)
+{
+  size_t child;
+
+  for (; ; )
     {
-      while (pb <= pc && (r = compar(pb, base)) <= 0)
+      child = 2 * root + 1;
+      if (child >= nmemb)
         {
-          if (r == 0)
-            {
-              swap_cnt = 1;
-              swap(pa, pb);
-              pa += size;
-            }
-          pb += size;
+          break;
         }
-      while (pb <= pc && (r = compar(pc, base)) >= 0)
+
+      if (child + 1 < nmemb &&
+          qs->compar(base + child * qs->size,
+                     base + (child + 1) * qs->size) < 0)
         {
-          if (r == 0)
-            {
-              swap_cnt = 1;
-              swap(pc, pd);
-              pd -= size;
-            }
-          pc -= size;
+          child++;
         }
 
-      if (pb > pc)
+      if (qs->compar(base + root * qs->size, base + child * qs->size) >= 0)
         {
           break;
         }
 
-      swap(pb, pc);
-      swap_cnt = 1;
-      pb += size;
-      pc -= size;
+      qsort_swap(qs, base + root * qs->size, base + child * qs->size);
+      root = child;
+    }
+}
+
+static void qsort_heapsort(FAR const struct qsort_s *qs, FAR char *base,
+                           size_t nmemb)
+{
+  size_t i;
+
+  for (i = nmemb / 2; i > 0; i--)
+    {
+      qsort_siftdown(qs, base, i - 1, nmemb);
     }
 
-  if (swap_cnt == 0)
+  for (i = nmemb - 1; i > 0; i--)
     {
-      /* Switch to insertion sort */
+      qsort_swap(qs, base, base + i * qs->size);
+      qsort_siftdown(qs, base, 0, i);
+    }
+}
+
+/****************************************************************************
+ * Name: qsort_intro
+ *
+ * Description:
+ *   Introsort: quicksort with Bentley & McIlroy's three-way partitioning
+ *   ("Engineering a Sort Function") that switches to heapsort when the
+ *   recursion depth exceeds 'depth'.  Only the smaller partition is sorted
+ *   recursively, so the stack depth is O(log n) too.
+ *
+ ****************************************************************************/
+
+static void qsort_intro(FAR const struct qsort_s *qs, FAR char *base,
+                        size_t nmemb, int depth)
+{
+  size_t size = qs->size;
+  FAR char *pa;
+  FAR char *pb;
+  FAR char *pc;
+  FAR char *pd;
+  FAR char *pl;
+  FAR char *pm;
+  FAR char *pn;
+  size_t nleft;
+  size_t nright;
+  size_t d;
+  size_t r;
+  int cmp;
+
+  for (; ; )
+    {
+      if (nmemb <= QSORT_INSERTION)
+        {
+          qsort_insertion(qs, base, nmemb);
+          return;
+        }
+
+      if (depth-- <= 0)
+        {
+          qsort_heapsort(qs, base, nmemb);
+          return;
+        }
+
+      /* Select the pivot and move it to the first position */
+
+      pl = base;
+      pm = base + (nmemb / 2) * size;
+      pn = base + (nmemb - 1) * size;
+
+      if (nmemb > QSORT_NINTHER)
+        {
+          d  = (nmemb / 8) * size;
+          pl = qsort_med3(qs, pl, pl + d, pl + 2 * d);
+          pm = qsort_med3(qs, pm - d, pm, pm + d);
+          pn = qsort_med3(qs, pn - 2 * d, pn - d, pn);
+        }
+
+      pm = qsort_med3(qs, pl, pm, pn);
+      qsort_swap(qs, base, pm);
+
+      /* Partition into [= pivot][< pivot][> pivot][= pivot] */
+
+      pa = pb = base + size;
+      pc = pd = base + (nmemb - 1) * size;
+
+      for (; ; )
+        {
+          while (pb <= pc && (cmp = qs->compar(pb, base)) <= 0)
+            {
+              if (cmp == 0)
+                {
+                  qsort_swap(qs, pa, pb);
+                  pa += size;
+                }
+
+              pb += size;
+            }
+
+          while (pb <= pc && (cmp = qs->compar(pc, base)) >= 0)
+            {
+              if (cmp == 0)
+                {
+                  qsort_swap(qs, pc, pd);
+                  pd -= size;
+                }
+
+              pc -= size;
+            }
 
-      for (pm = (char *) base + size; pm < (char *) base + nmemb * size; pm += size)
+          if (pb > pc)
+            {
+              break;
+            }
+
+          qsort_swap(qs, pb, pc);
+          pb += size;
+          pc -= size;
+        }
+
+      /* Move the members equal to the pivot to the middle */
+
+      pn = base + nmemb * size;
+      r  = pa - base < pb - pa ? pa - base : pb - pa;
+      qsort_vecswap(qs, base, pb - r, r);
+
+      r  = pd - pc < pn - pd - size ? pd - pc : pn - pd - size;
+      qsort_vecswap(qs, pb, pn - r, r);
+
+      /* Recurse on the smaller side and iterate on the larger one */
+
+      nleft  = (pb - pa) / size;
+      nright = (pd - pc) / size;
+
+      if (nleft < nright)
         {
-          for (pl = pm; pl > (char *) base && compar(pl - size, pl) > 0; pl -= size)
+          if (nleft > 1)
             {
-              swap(pl, pl - size);
+              qsort_intro(qs, base, nleft, depth);
             }
+
+          base  = pn - nright * size;
+          nmemb = nright;
+        }
+      else
+        {
+          if (nright > 1)
+            {
+              qsort_intro(qs, pn - nright * size, nright, depth);
+            }
+
+          nmemb = nleft;
+        }
+
+      if (nmemb <= 1)
+        {
+          return;
         }
-      return;
     }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: qsort
+ *
+ * Description:
+ *   Sort an array of 'nmemb' members of 'size' bytes in ascending order
+ *   according to 'compar'.  The sort is not stable.  It needs
+ *   O(n log n) comparisons and O(log n) stack in the worst case.
+ *
+ ****************************************************************************/
 
-  pn = (char *) base + nmemb * size;
-  r = min(pa - (char *)base, pb - pa);
-  vecswap(base, pb - r, r);
-  r = min(pd - pc, pn - pd - size);
-  vecswap(pb, pn - r, r);
+void qsort(void *base, size_t nmemb, size_t size,
+           int(*compar)(const void *, const void *))
+{
+  struct qsort_s qs;
+  size_t n;
+  int depth;
 
-  if ((r = pb - pa) > size)
+  if (nmemb < 2 || size == 0)
     {
-      qsort(base, r / size, size, compar);
+      return;
     }
 
-  if ((r = pd - pc) > size)
+  qs.compar   = compar;
+  qs.size     = size;
+  qs.swaptype = qsort_swaptype(base, size);
+
+  /* Allow 2 * log2(nmemb) levels of partitioning before falling back to
+   * heapsort.
+   */
+
+  for (depth = 0, n = nmemb; n > 1; n >>= 1)
     {
-      /* Iterate rather than recurse to save stack space */
-      base = pn - r;
-      nmemb = r / size;
-      goto loop;
+      depth += 2;
     }
-}
 
+  qsort_intro(&qs, (FAR char *)base, nmemb, depth);
+}
@@ -41,6 +41,8 @@
 
 #include <string.h>
 
+#include "lib_internal.h"
+
 /****************************************************************************
  * Global Functions
  ****************************************************************************/
@@ -59,12 +61,40 @@
  *
  ****************************************************************************/
 
+#ifndef CONFIG_ARCH_MEMCHR
 FAR void *memchr(FAR const void *s, int c, size_t n)
 {
   FAR const unsigned char *p = (FAR const unsigned char *)s;
 
   if (s)
     {
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+      /* Skip over whole words that do not contain the byte */
+
+      if (n >= 2 * LIB_WORDSIZE)
+        {
+          lib_word_t mask = LIB_SPLAT(c);
+
+          while (!LIB_ALIGNED(p))
+            {
+              if (*p == (unsigned char)c)
+                {
+                  return (FAR void *)p;
+                }
+
+              p++;
+              n--;
+            }
+
+          while (n >= LIB_WORDSIZE &&
+                 !LIB_HASZERO(*(FAR const lib_word_t *)p ^ mask))
+            {
+              p += LIB_WORDSIZE;
+              n -= LIB_WORDSIZE;
+            }
+        }
+#endif
+
       while (n--)
         {
           if (*p == (unsigned char)c)
@@ -78,3 +108,4 @@ FAR void *memchr(FAR const void *s, int c, size_t n)
 
   return NULL;
 }
+#endif
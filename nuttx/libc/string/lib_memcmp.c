@@ -45,6 +45,8 @@
 #include <sys/types.h>
 #include <string.h>
 
+#include "lib_internal.h"
+
 /************************************************************
  * Global Functions
  ************************************************************/
@@ -55,6 +57,38 @@ int memcmp(FAR const void *s1, FAR const void *s2, size_t n)
   unsigned char *p1 = (unsigned char *)s1;
   unsigned char *p2 = (unsigned char *)s2;
 
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+  /* Skip over the leading words that are identical.  The byte loop below
+   * then locates the first difference, if any.
+   */
+
+  if (n >= 2 * LIB_WORDSIZE)
+    {
+      while (!LIB_ALIGNED(p1))
+        {
+          if (*p1 != *p2)
+            {
+              return *p1 < *p2 ? -1 : 1;
+            }
+
+          p1++;
+          p2++;
+          n--;
+        }
+
+      if (LIB_SRCALIGNED(p2))
+        {
+          while (n >= LIB_WORDSIZE &&
+                 *(FAR const lib_word_t *)p1 == LIB_LOADW(p2))
+            {
+              p1 += LIB_WORDSIZE;
+              p2 += LIB_WORDSIZE;
+              n  -= LIB_WORDSIZE;
+            }
+        }
+    }
+#endif
+
   while (n-- > 0)
     {
       if (*p1 < *p2)
@@ -45,6 +45,8 @@
 #include <sys/types.h>
 #include <string.h>
 
+#include "lib_internal.h"
+
 /****************************************************************************
  * Global Functions
  ****************************************************************************/
@@ -58,6 +60,46 @@ FAR void *memcpy(FAR void *dest, FAR const void *src, size_t n)
 {
   FAR unsigned char *pout = (FAR unsigned char*)dest;
   FAR unsigned char *pin  = (FAR unsigned char*)src;
+
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+  /* Copy bytes until the destination is word-aligned.  Then, if the source
+   * can be loaded a word at a time, copy four words per pass and then any
+   * remaining whole words.
+   */
+
+  if (n >= 4 * LIB_WORDSIZE)
+    {
+      while (!LIB_ALIGNED(pout))
+        {
+          *pout++ = *pin++;
+          n--;
+        }
+
+      if (LIB_SRCALIGNED(pin))
+        {
+          FAR lib_word_t *wout = (FAR lib_word_t *)pout;
+
+          for (; n >= 4 * LIB_WORDSIZE; n -= 4 * LIB_WORDSIZE)
+            {
+              wout[0] = LIB_LOADW(pin);
+              wout[1] = LIB_LOADW(pin + LIB_WORDSIZE);
+              wout[2] = LIB_LOADW(pin + 2 * LIB_WORDSIZE);
+              wout[3] = LIB_LOADW(pin + 3 * LIB_WORDSIZE);
+              wout   += 4;
+              pin    += 4 * LIB_WORDSIZE;
+            }
+
+          for (; n >= LIB_WORDSIZE; n -= LIB_WORDSIZE)
+            {
+              *wout++ = LIB_LOADW(pin);
+              pin    += LIB_WORDSIZE;
+            }
+
+          pout = (FAR unsigned char *)wout;
+        }
+    }
+#endif
+
   while (n-- > 0) *pout++ = *pin++;
   return dest;
 }
@@ -45,6 +45,8 @@
 #include <sys/types.h>
 #include <string.h>
 
+#include "lib_internal.h"
+
 /************************************************************
  * Global Functions
  ************************************************************/
@@ -57,6 +59,32 @@ FAR void *memmove(FAR void *dest, FAR const void *src, size_t count)
     {
       tmp = (char*) dest;
       s   = (char*) src;
+
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+      /* Copying upward is safe a word at a time:  Each word is loaded
+       * before the store that could overlap it.
+       */
+
+      if (count >= 2 * LIB_WORDSIZE)
+        {
+          while (!LIB_ALIGNED(tmp))
+            {
+              *tmp++ = *s++;
+              count--;
+            }
+
+          if (LIB_SRCALIGNED(s))
+            {
+              for (; count >= LIB_WORDSIZE; count -= LIB_WORDSIZE)
+                {
+                  *(FAR lib_word_t *)tmp = LIB_LOADW(s);
+                  tmp += LIB_WORDSIZE;
+                  s   += LIB_WORDSIZE;
+                }
+            }
+        }
+#endif
+
       while (count--)
         {
 	  *tmp++ = *s++;
@@ -66,6 +94,30 @@ FAR void *memmove(FAR void *dest, FAR const void *src, size_t count)
     {
       tmp = (char*) dest + count;
       s   = (char*) src + count;
+
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+      /* Copy downward from the word-aligned end of the destination */
+
+      if (count >= 2 * LIB_WORDSIZE)
+        {
+          while (!LIB_ALIGNED(tmp))
+            {
+              *--tmp = *--s;
+              count--;
+            }
+
+          if (LIB_SRCALIGNED(s))
+            {
+              for (; count >= LIB_WORDSIZE; count -= LIB_WORDSIZE)
+                {
+                  tmp -= LIB_WORDSIZE;
+                  s   -= LIB_WORDSIZE;
+                  *(FAR lib_word_t *)tmp = LIB_LOADW(s);
+                }
+            }
+        }
+#endif
+
       while (count--)
         {
 	  *--tmp = *--s;
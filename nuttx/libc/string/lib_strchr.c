@@ -41,6 +41,8 @@
 
 #include <string.h>
 
+#include "lib_internal.h"
+
 /****************************************************************************
  * Global Functions
  ****************************************************************************/
@@ -64,9 +66,40 @@ FAR char *strchr(FAR const char *s, int c)
 {
   if (s)
     {
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+      lib_word_t mask = LIB_SPLAT(c);
+
+      /* Skip over whole words that contain neither the terminator nor the
+       * character.
+       */
+
+      for (; !LIB_ALIGNED(s); s++)
+        {
+          if (*s == (char)c)
+            {
+              return (FAR char *)s;
+            }
+
+          if (!*s)
+            {
+              return NULL;
+            }
+        }
+
+      for (; ; s += LIB_WORDSIZE)
+        {
+          lib_word_t w = *(FAR const lib_word_t *)s;
+
+          if (LIB_HASZERO(w) || LIB_HASZERO(w ^ mask))
+            {
+              break;
+            }
+        }
+#endif
+
       for (; ; s++)
         {
-          if (*s == c)
+          if (*s == (char)c)
             {
               return (FAR char *)s;
             }
@@ -41,6 +41,8 @@
 
 #include <string.h>
 
+#include "lib_internal.h"
+
 /****************************************************************************
  * Public Functions
  *****************************************************************************/
@@ -48,10 +50,44 @@
 #ifndef CONFIG_ARCH_STRCMP
 int strcmp(const char *cs, const char *ct)
 {
-  register signed char result;
+  register int result;
+
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+  /* If both strings share the same alignment, skip over the leading words
+   * that are identical and contain no terminator.  The byte loop below
+   * then finishes the comparison.
+   */
+
+  if ((((uintptr_t)cs ^ (uintptr_t)ct) & LIB_WORDMASK) == 0)
+    {
+      for (; !LIB_ALIGNED(cs); cs++, ct++)
+        {
+          if ((result = (unsigned char)*cs - (unsigned char)*ct) != 0 ||
+              !*cs)
+            {
+              return result;
+            }
+        }
+
+      for (; ; )
+        {
+          lib_word_t w = *(FAR const lib_word_t *)cs;
+
+          if (w != *(FAR const lib_word_t *)ct || LIB_HASZERO(w))
+            {
+              break;
+            }
+
+          cs += LIB_WORDSIZE;
+          ct += LIB_WORDSIZE;
+        }
+    }
+#endif
+
   for (;;)
     {
-      if ((result = *cs - *ct++) != 0 || !*cs++)
+      if ((result = (unsigned char)*cs - (unsigned char)*ct++) != 0 ||
+          !*cs++)
 	break;
     }
   return result;
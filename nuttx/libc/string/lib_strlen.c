@@ -41,6 +41,8 @@
 #include <sys/types.h>
 #include <string.h>
 
+#include "lib_internal.h"
+
 /****************************************************************************
  * Global Functions
  ****************************************************************************/
@@ -49,7 +51,30 @@
 size_t strlen(const char *s)
 {
   const char *sc;
-  for (sc = s; *sc != '\0'; ++sc);
+
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+  /* Check bytes up to the first word boundary, then whole words until one
+   * contains the terminator.  An aligned word load never crosses into a
+   * page that does not also hold the terminator.
+   */
+
+  for (sc = s; !LIB_ALIGNED(sc); ++sc)
+    {
+      if (*sc == '\0')
+        {
+          return sc - s;
+        }
+    }
+
+  while (!LIB_HASZERO(*(FAR const lib_word_t *)sc))
+    {
+      sc += LIB_WORDSIZE;
+    }
+#else
+  sc = s;
+#endif
+
+  for (; *sc != '\0'; ++sc);
   return sc - s;
 }
 #endif
@@ -41,6 +41,8 @@
 #include <sys/types.h>
 #include <string.h>
 
+#include "lib_internal.h"
+
 /************************************************************
  * Public Functions
  ************************************************************/
@@ -55,6 +57,47 @@ char *strncpy(FAR char *dest, FAR const char *src, size_t n)
   char *ret = dest;     /* Value to be returned */
   char *end = dest + n; /* End of dest buffer + 1 byte */
 
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+  /* Copy bytes up to the first source word boundary, then whole words as
+   * long as the source word holds no terminator.  An aligned word load
+   * never crosses into a page that does not also hold the terminator.
+   */
+
+  if (n >= 2 * LIB_WORDSIZE)
+    {
+      while (!LIB_ALIGNED(src))
+        {
+          if ((*dest++ = *src++) == '\0')
+            {
+              return ret;
+            }
+        }
+
+#ifndef CONFIG_ARCH_HAVE_UNALIGNED
+      if (LIB_ALIGNED(dest))
+#endif
+        {
+          while ((size_t)(end - dest) >= LIB_WORDSIZE)
+            {
+              lib_word_t w = *(FAR const lib_word_t *)src;
+
+              if (LIB_HASZERO(w))
+                {
+                  break;
+                }
+
+#ifdef CONFIG_ARCH_HAVE_UNALIGNED
+              ((FAR struct lib_uword_s *)dest)->w = w;
+#else
+              *(FAR lib_word_t *)dest = w;
+#endif
+              dest += LIB_WORDSIZE;
+              src  += LIB_WORDSIZE;
+            }
+        }
+    }
+#endif
+
   while (dest != end && (*dest++ = *src++) != '\0');
   return ret;
 }
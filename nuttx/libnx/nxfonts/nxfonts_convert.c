@@ -260,6 +260,36 @@ int NXF_FUNCNAME(nxf_convert,NXFONTS_SUFFIX)
         {
           bmbyte = *sptr++;
 
+#ifdef CONFIG_NX_WORDRASTER
+          /* Most bytes of a glyph bitmap are either all background or all
+           * foreground.  Handle those eight pixels at a time.
+           */
+
+          if (col + 8 <= width)
+            {
+              if (bmbyte == 0x00)
+                {
+                  dptr += 8;
+                  col  += 8;
+                  continue;
+                }
+              else if (bmbyte == 0xff)
+                {
+                  dptr[0] = color;
+                  dptr[1] = color;
+                  dptr[2] = color;
+                  dptr[3] = color;
+                  dptr[4] = color;
+                  dptr[5] = color;
+                  dptr[6] = color;
+                  dptr[7] = color;
+                  dptr   += 8;
+                  col    += 8;
+                  continue;
+                }
+            }
+
+#endif
           /* Process each bit in the byte */
 
           for (bmbit = 7; bmbit >= 0 && col < width; bmbit--, col++)
@@ -39,6 +39,7 @@
 
 #include <nuttx/config.h>
 
+#include <string.h>
 #include <errno.h>
 #include <debug.h>
 
@@ -66,6 +67,110 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: nx_batchbitmap
+ *
+ * Description:
+ *   Add the bitmap to the current batch.  The part of the image that falls
+ *   within the destination rectangle is copied into the batch (just after
+ *   the bitmap message) so that the caller may re-use the image memory
+ *   without waiting for the server.
+ *
+ * Return:
+ *   true if the bitmap was batched; false if it must be sent to the server
+ *   in the normal way.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_BATCH
+static bool nx_batchbitmap(FAR struct nxbe_window_s *wnd,
+                           FAR const struct nxgl_rect_s *dest,
+                           FAR const void *src[CONFIG_NX_NPLANES],
+                           FAR const struct nxgl_point_s *origin,
+                           unsigned int stride)
+{
+  FAR struct nxfe_conn_s *conn = wnd->conn;
+  FAR struct nxsvrmsg_bitmap_s *outmsg;
+  FAR const uint8_t *sline;
+  FAR uint8_t *image;
+  nxgl_coord_t width;
+  nxgl_coord_t height;
+  unsigned int rowbytes;
+  size_t planesize;
+  int bpp;
+  int i;
+  int y;
+
+  if (conn->batchnest == 0 || NXBE_ISBLOCKED(wnd))
+    {
+      return false;
+    }
+
+  /* Only byte-aligned pixel formats are batched */
+
+  for (i = 0; i < CONFIG_NX_NPLANES; i++)
+    {
+      if (conn->bpp[i] < 8 || conn->bpp[i] != conn->bpp[0])
+        {
+          return false;
+        }
+    }
+
+  width  = dest->pt2.x - dest->pt1.x + 1;
+  height = dest->pt2.y - dest->pt1.y + 1;
+  if (width <= 0 || height <= 0 ||
+      dest->pt1.x < origin->x || dest->pt1.y < origin->y)
+    {
+      return false;
+    }
+
+  /* Reserve space for the message and the image of each color plane */
+
+  rowbytes  = (unsigned int)width * (conn->bpp[0] >> 3);
+  planesize = NXBATCH_ALIGN((size_t)rowbytes * height);
+
+  outmsg = (FAR struct nxsvrmsg_bitmap_s *)
+    nxmu_batchreserve(conn, NXBATCH_ALIGN(sizeof(struct nxsvrmsg_bitmap_s)) +
+                            CONFIG_NX_NPLANES * planesize);
+  if (!outmsg)
+    {
+      return false;
+    }
+
+  /* Format the bitmap command.  The copied image starts at the upper
+   * left corner of the destination rectangle.
+   */
+
+  outmsg->msgid    = NX_SVRMSG_BITMAP;
+  outmsg->wnd      = wnd;
+  outmsg->stride   = rowbytes;
+  outmsg->origin.x = dest->pt1.x;
+  outmsg->origin.y = dest->pt1.y;
+  outmsg->sem_done = NULL;
+  nxgl_rectcopy(&outmsg->dest, dest);
+
+  image = (FAR uint8_t *)outmsg +
+          NXBATCH_ALIGN(sizeof(struct nxsvrmsg_bitmap_s));
+
+  for (i = 0; i < CONFIG_NX_NPLANES; i++, image += planesize)
+    {
+      bpp   = conn->bpp[i] >> 3;
+      sline = (FAR const uint8_t *)src[i] +
+              (dest->pt1.y - origin->y) * stride +
+              (dest->pt1.x - origin->x) * bpp;
+
+      outmsg->src[i] = image;
+      for (y = 0; y < height; y++)
+        {
+          memcpy(image + y * rowbytes, sline, rowbytes);
+          sline += stride;
+        }
+    }
+
+  return true;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -110,6 +215,17 @@ int nx_bitmap(NXWINDOW hwnd, FAR const struct nxgl_rect_s *dest,
     }
 #endif
 
+#ifdef CONFIG_NX_BATCH
+  /* Inside of a batch, copy the image into the batch rather than waiting
+   * for the server to finish with the caller's image memory.
+   */
+
+  if (nx_batchbitmap(wnd, dest, src, origin, stride))
+    {
+      return OK;
+    }
+#endif
+
   /* Format the bitmap command */
 
   outmsg.msgid      = NX_SVRMSG_BITMAP;
@@ -80,10 +80,26 @@
  *
  ****************************************************************************/
 
-static inline void nx_connected(FAR struct nxfe_conn_s *conn)
+static inline void nx_connected(FAR struct nxfe_conn_s *conn,
+                                FAR struct nxclimsg_connected_s *msg)
 {
+#ifdef CONFIG_NX_BATCH
+  int i;
+#endif
+
   DEBUGASSERT(conn->state == NX_CLISTATE_NOTCONNECTED);
   conn->state = NX_CLISTATE_CONNECTED;
+
+#ifdef CONFIG_NX_BATCH
+  /* Remember the pixel depth of each color plane (needed to copy bitmaps
+   * into a batch).
+   */
+
+  for (i = 0; i < CONFIG_NX_NPLANES; i++)
+    {
+      conn->bpp[i] = msg->bpp[i];
+    }
+#endif
 }
 
 /****************************************************************************
@@ -97,6 +113,17 @@ static inline void nx_disconnected(FAR struct nxfe_conn_s *conn)
   (void)mq_close(conn->cwrmq);
   (void)mq_close(conn->crdmq);
 
+#ifdef CONFIG_NX_BATCH
+  /* Free the batch buffers (both are in one allocation) */
+
+  if (conn->batchbuf[0])
+    {
+      lib_ufree(conn->batchbuf[0]);
+      sem_destroy(&conn->batchsem[0]);
+      sem_destroy(&conn->batchsem[1]);
+    }
+#endif
+
   /* And free the client structure */
 
   lib_ufree(conn);
@@ -181,7 +208,7 @@ int nx_eventhandler(NXHANDLE handle)
   switch (msg->msgid)
     {
     case NX_CLIMSG_CONNECTED:
-      nx_connected(conn);
+      nx_connected(conn, (FAR struct nxclimsg_connected_s *)buffer);
       break;
 
     case NX_CLIMSG_DISCONNECTED:
@@ -0,0 +1,162 @@
+/****************************************************************************
+ * libnx/nxmu/nx_fence.c
+ *
+ *   Copyright (C) 2014 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <semaphore.h>
+#include <mqueue.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/nx/nx.h>
+#include <nuttx/nx/nxmu.h>
+
+#ifdef CONFIG_NX_BATCH
+
+/****************************************************************************
+ * Pre-Processor Definitions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nx_fence
+ *
+ * Description:
+ *   Send any batched commands to the server and wait until the server has
+ *   executed every request that this client has sent.
+ *
+ * Input Parameters:
+ *   handle - the handle returned by nx_connect
+ *
+ * Return:
+ *   OK on success; ERROR on failure with errno set appropriately
+ *
+ ****************************************************************************/
+
+int nx_fence(NXHANDLE handle)
+{
+  FAR struct nxfe_conn_s *conn = (FAR struct nxfe_conn_s *)handle;
+  struct nxsvrmsg_batch_s outmsg;
+  sem_t sem_done;
+  int ret;
+  int i;
+
+#ifdef CONFIG_DEBUG
+  if (!conn)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+#endif
+
+  /* Send the batch that is being filled */
+
+  ret = nxmu_batchflush(conn);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Then send an empty batch.  The server handles the requests from a
+   * client in order so, when the empty batch completes, all preceding
+   * requests have completed too.
+   */
+
+  ret = sem_init(&sem_done, 0, 0);
+  if (ret < 0)
+    {
+      gdbg("sem_init failed: %d\n", errno);
+      return ret;
+    }
+
+  outmsg.msgid    = NX_SVRMSG_BATCH;
+  outmsg.buffer   = NULL;
+  outmsg.buflen   = 0;
+  outmsg.sem_done = &sem_done;
+
+  ret = mq_send(conn->cwrmq, &outmsg, sizeof(struct nxsvrmsg_batch_s),
+                NX_SVRMSG_PRIO);
+  if (ret < 0)
+    {
+      gdbg("mq_send failed: %d\n", errno);
+    }
+  else
+    {
+      conn->nmsgs++;
+      nxmu_semtake(&sem_done);
+
+      /* Collect the completion of any batches that were still owned by
+       * the server.
+       */
+
+      for (i = 0; i < 2; i++)
+        {
+          if ((conn->batchbusy & (1 << i)) != 0)
+            {
+              nxmu_semtake(&conn->batchsem[i]);
+            }
+        }
+
+      conn->batchbusy = 0;
+    }
+
+  sem_destroy(&sem_done);
+  return ret;
+}
+
+#endif /* CONFIG_NX_BATCH */
@@ -0,0 +1,189 @@
+/****************************************************************************
+ * libnx/nxmu/nxmu_batch.c
+ *
+ *   Copyright (C) 2014 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <mqueue.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/nx/nx.h>
+#include <nuttx/nx/nxmu.h>
+
+#ifdef CONFIG_NX_BATCH
+
+/****************************************************************************
+ * Pre-Processor Definitions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmu_batchflush
+ *
+ * Description:
+ *  Send the batch that the client is filling (if it is not empty) to the
+ *  server.  Then wait until the other batch buffer is free so that the
+ *  client may continue to fill it.
+ *
+ * Input Parameters:
+ *   conn   - A pointer to the server connection structure
+ *
+ * Return:
+ *   OK on success; ERROR on failure with errno set appropriately
+ *
+ ****************************************************************************/
+
+int nxmu_batchflush(FAR struct nxfe_conn_s *conn)
+{
+  struct nxsvrmsg_batch_s outmsg;
+  uint8_t ndx = conn->batchndx;
+  int ret;
+
+  if (conn->batchlen == 0)
+    {
+      return OK;
+    }
+
+  /* Format the batch command */
+
+  outmsg.msgid    = NX_SVRMSG_BATCH;
+  outmsg.buffer   = conn->batchbuf[ndx];
+  outmsg.buflen   = conn->batchlen;
+  outmsg.sem_done = &conn->batchsem[ndx];
+
+  /* The batch is consumed whether or not it could be sent */
+
+  conn->batchlen  = 0;
+
+  /* Send the batch directly to the server (not through nxmu_sendserver()
+   * which would try to flush the batch again).
+   */
+
+  ret = mq_send(conn->cwrmq, &outmsg, sizeof(struct nxsvrmsg_batch_s),
+                NX_SVRMSG_PRIO);
+  if (ret < 0)
+    {
+      gdbg("mq_send failed: %d\n", errno);
+      return ret;
+    }
+
+  /* The server now owns the batch.  Switch to the other buffer. */
+
+  conn->batchbusy |= (1 << ndx);
+  conn->nmsgs++;
+  conn->nbatches++;
+
+  ndx ^= 1;
+  conn->batchndx = ndx;
+
+  /* Wait until the server has finished with the other buffer */
+
+  if ((conn->batchbusy & (1 << ndx)) != 0)
+    {
+      nxmu_semtake(&conn->batchsem[ndx]);
+      conn->batchbusy &= ~(1 << ndx);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxmu_batchreserve
+ *
+ * Description:
+ *  Reserve space for one drawing command in the batch that the client is
+ *  filling.  If there is not enough space, the batch is sent to the server
+ *  first.
+ *
+ * Input Parameters:
+ *   conn   - A pointer to the server connection structure
+ *   size   - The size of the command in bytes.
+ *
+ * Return:
+ *   A pointer to the reserved space on success; NULL if the command cannot
+ *   be batched.
+ *
+ ****************************************************************************/
+
+FAR void *nxmu_batchreserve(FAR struct nxfe_conn_s *conn, size_t size)
+{
+  FAR void *cmd;
+
+  size = NXBATCH_ALIGN(size);
+  if (conn->batchnest == 0 || size > CONFIG_NX_BATCHSIZE)
+    {
+      return NULL;
+    }
+
+  /* Send the current batch if the command will not fit */
+
+  if (conn->batchlen + size > CONFIG_NX_BATCHSIZE)
+    {
+      if (nxmu_batchflush(conn) < 0)
+        {
+          return NULL;
+        }
+    }
+
+  cmd             = conn->batchbuf[conn->batchndx] + conn->batchlen;
+  conn->batchlen += size;
+  conn->ncmds++;
+  return cmd;
+}
+
+#endif /* CONFIG_NX_BATCH */
@@ -100,6 +100,18 @@ int nxmu_sendserver(FAR struct nxfe_conn_s *conn, FAR const void *msg,
     }
 #endif
 
+#ifdef CONFIG_NX_BATCH
+  /* Any batched drawing commands must reach the server before this
+   * message so that the server sees the requests in the order that the
+   * client made them.
+   */
+
+  if (conn->batchlen > 0)
+    {
+      (void)nxmu_batchflush(conn);
+    }
+#endif
+
   /* Send the message to the server */
 
   ret = mq_send(conn->cwrmq, msg, msglen, NX_SVRMSG_PRIO);
@@ -107,6 +119,12 @@ int nxmu_sendserver(FAR struct nxfe_conn_s *conn, FAR const void *msg,
     {
       gdbg("mq_send failed: %d\n", errno);
     }
+#ifdef CONFIG_NX_BATCH
+  else
+    {
+      conn->nmsgs++;
+    }
+#endif
 
   return ret;
 }
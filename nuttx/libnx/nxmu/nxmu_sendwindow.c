@@ -39,6 +39,7 @@
 
 #include <nuttx/config.h>
 
+#include <string.h>
 #include <mqueue.h>
 #include <errno.h>
 #include <debug.h>
@@ -106,6 +107,38 @@ int nxmu_sendwindow(FAR struct nxbe_window_s *wnd, FAR const void *msg,
 
   if (!NXBE_ISBLOCKED(wnd))
     {
+#ifdef CONFIG_NX_BATCH
+      /* Drawing commands that do not return anything to the client may be
+       * added to the current batch instead of being sent individually.
+       */
+
+      if (wnd->conn->batchnest > 0)
+        {
+          FAR const struct nxsvrmsg_s *base =
+            (FAR const struct nxsvrmsg_s *)msg;
+
+          switch (base->msgid)
+            {
+              case NX_SVRMSG_SETPIXEL:
+              case NX_SVRMSG_FILL:
+              case NX_SVRMSG_FILLTRAP:
+              case NX_SVRMSG_MOVE:
+                {
+                  FAR void *cmd = nxmu_batchreserve(wnd->conn, msglen);
+                  if (cmd)
+                    {
+                      memcpy(cmd, msg, msglen);
+                      return OK;
+                    }
+                }
+                break;
+
+              default:
+                break;
+            }
+        }
+#endif
+
       /* Send the message to the server */
 
       ret = nxmu_sendserver(wnd->conn, msg, msglen);
@@ -38,6 +38,7 @@
  ****************************************************************************/
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -57,6 +58,14 @@
  * Private Types
  ****************************************************************************/
 
+/* One symbol of a hashed symbol table */
+
+struct symbol_s
+{
+  char *name;   /* The symbol name */
+  char *cond;   /* Conditional compilation expression (or NULL) */
+};
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -64,20 +73,142 @@
 static const char *g_hdrfiles[MAX_HEADER_FILES];
 static int nhdrfiles;
 
+static struct symbol_s *g_symbols;
+static int nsymbols;
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
 static void show_usage(const char *progname)
 {
-  fprintf(stderr, "USAGE: %s <cvs-file> <symtab-file>\n\n", progname);
+  fprintf(stderr, "USAGE: %s [-d] [-h] <cvs-file> <symtab-file>\n\n", progname);
   fprintf(stderr, "Where:\n\n");
   fprintf(stderr, "  <cvs-file>   : The path to the input CSV file\n");
   fprintf(stderr, "  <symtab-file>: The path to the output symbol table file\n");
   fprintf(stderr, "  -d           : Enable debug output\n");
+  fprintf(stderr, "  -h           : Generate a hashed symbol table\n");
   exit(EXIT_FAILURE);
 }
 
+/* The System V ELF hash function.  This must match symtab_hash() in
+ * binfmt/symtab_findhashedbyname.c.
+ */
+
+static uint32_t symtab_hash(const char *name)
+{
+  uint32_t hash = 0;
+  uint32_t high;
+
+  while (*name)
+    {
+      hash = (hash << 4) + (uint8_t)*name++;
+      high = hash & 0xf0000000;
+      if (high)
+        {
+          hash ^= high >> 24;
+        }
+
+      hash &= ~high;
+    }
+
+  return hash;
+}
+
+static void add_symbol(const char *name, const char *cond)
+{
+  g_symbols = realloc(g_symbols, (nsymbols + 1) * sizeof(struct symbol_s));
+  if (!g_symbols)
+    {
+      fprintf(stderr, "ERROR: Failed to allocate symbol list\n");
+      exit(EXIT_FAILURE);
+    }
+
+  g_symbols[nsymbols].name = strdup(name);
+  g_symbols[nsymbols].cond = (cond && strlen(cond) > 0) ? strdup(cond) : NULL;
+  nsymbols++;
+}
+
+/* Output a hashed symbol table.  The table has about 3/2 as many slots as
+ * symbols.  Each symbol is placed in the slot selected by its hash or, if
+ * that slot is taken, in the next free slot (wrapping around at the end of
+ * the table).  Unused slots have a NULL name;  this ends the search in
+ * symtab_findhashedbyname().  A symbol that is conditionally compiled out
+ * leaves a slot with an empty name so that the search for any symbol that
+ * was displaced past it continues.
+ */
+
+static void output_hashed(FILE *outstream)
+{
+  int *slots;
+  int nslots;
+  int maxprobe = 0;
+  int probe;
+  int ndx;
+  int i;
+
+  nslots = nsymbols + nsymbols / 2 + 1;
+  slots  = malloc(nslots * sizeof(int));
+  if (!slots)
+    {
+      fprintf(stderr, "ERROR: Failed to allocate hash slots\n");
+      exit(EXIT_FAILURE);
+    }
+
+  for (i = 0; i < nslots; i++)
+    {
+      slots[i] = -1;
+    }
+
+  for (i = 0; i < nsymbols; i++)
+    {
+      ndx = symtab_hash(g_symbols[i].name) % nslots;
+      for (probe = 0; slots[ndx] >= 0; probe++)
+        {
+          ndx = (ndx + 1) % nslots;
+        }
+
+      slots[ndx] = i;
+      if (probe > maxprobe)
+        {
+          maxprobe = probe;
+        }
+    }
+
+  if (g_debug)
+    {
+      fprintf(stderr, "%d symbols in %d slots, longest probe %d\n",
+              nsymbols, nslots, maxprobe + 1);
+    }
+
+  for (ndx = 0; ndx < nslots; ndx++)
+    {
+      struct symbol_s *symbol;
+
+      if (slots[ndx] < 0)
+        {
+          fprintf(outstream, "  { NULL, NULL },\n");
+          continue;
+        }
+
+      symbol = &g_symbols[slots[ndx]];
+      if (symbol->cond)
+        {
+          fprintf(outstream, "#if %s\n", symbol->cond);
+        }
+
+      fprintf(outstream, "  { \"%s\", (FAR const void *)%s },\n",
+              symbol->name, symbol->name);
+
+      if (symbol->cond)
+        {
+          fprintf(outstream, "#else\n  { \"\", NULL },\n#endif\n");
+        }
+    }
+
+  free(slots);
+}
+
 static bool check_hdrfile(const char *hdrfile)
 {
   int i;
@@ -122,6 +253,7 @@ int main(int argc, char **argv, char **envp)
   char *nextterm;
   char *finalterm;
   char *ptr;
+  bool hashed;
   bool cond;
   FILE *instream;
   FILE *outstream;
@@ -131,8 +263,9 @@ int main(int argc, char **argv, char **envp)
   /* Parse command line options */
 
   g_debug = false;
+  hashed  = false;
 
-  while ((ch = getopt(argc, argv, ":d")) > 0)
+  while ((ch = getopt(argc, argv, ":dh")) > 0)
     {
       switch (ch)
         {
@@ -140,6 +273,10 @@ int main(int argc, char **argv, char **envp)
             g_debug = true;
             break;
 
+          case 'h' :
+            hashed = true;
+            break;
+
           case '?' :
             fprintf(stderr, "Unrecognized option: %c\n", optopt);
             show_usage(argv[0]);
@@ -222,6 +359,11 @@ int main(int argc, char **argv, char **envp)
 
   fprintf(outstream, "/* %s: Auto-generated symbol table.  Do not edit */\n\n", symtab);
   fprintf(outstream, "#include <nuttx/config.h>\n");
+  if (hashed)
+    {
+      fprintf(outstream, "#include <stddef.h>\n");
+    }
+
   fprintf(outstream, "#include <nuttx/compiler.h>\n");
   fprintf(outstream, "#include <nuttx/binfmt/symtab.h>\n\n");
 
@@ -253,6 +395,14 @@ int main(int argc, char **argv, char **envp)
           exit(EXIT_FAILURE);
         }
 
+      /* A hashed table cannot be output until all symbols are known */
+
+      if (hashed)
+        {
+          add_symbol(g_parm[NAME_INDEX], g_parm[COND_INDEX]);
+          continue;
+        }
+
       /* Output any conditional compilation */
 
       cond = (g_parm[COND_INDEX] && strlen(g_parm[COND_INDEX]) > 0);
@@ -279,6 +429,11 @@ int main(int argc, char **argv, char **envp)
         }
     }
 
+  if (hashed)
+    {
+      output_hashed(outstream);
+    }
+
   fprintf(outstream, "%s};\n\n", finalterm);
   fprintf(outstream, "#define NSYMBOLS (sizeof(%s) / sizeof (struct symtab_s))\n", SYMTAB_NAME);
 